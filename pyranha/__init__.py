@@ -348,6 +348,349 @@ class settings(object):
         return _s._get_thread_binding()
 
 
+class tuning(object):
+    """Tuning class.
+
+    This class exposes the performance tuning parameters of piranha, and it allows to select them
+    automatically for the current machine. The tuned parameters can be saved to a profile file, which will be loaded
+    automatically at startup if the ``PIRANHA_TUNING_PROFILE`` environment variable is set to its path.
+    The methods are thread-safe.
+
+    """
+
+    @staticmethod
+    def get_parallel_memory_set():
+        """Get the parallel memory set flag.
+
+        :returns: ``True`` if multiple threads are used to initialise large memory areas, ``False`` otherwise
+        :rtype: ``bool``
+
+        >>> tuning.get_parallel_memory_set() # doctest: +SKIP
+        True
+
+        """
+        from ._core import _tuning as _t
+        return _t._get_parallel_memory_set()
+
+    @staticmethod
+    def get_multiplication_block_size():
+        """Get the multiplication block size.
+
+        :returns: the block size used in series multiplication
+        :rtype: ``int``
+
+        >>> tuning.get_multiplication_block_size() # doctest: +SKIP
+        256
+
+        """
+        from ._core import _tuning as _t
+        return _t._get_multiplication_block_size()
+
+    @staticmethod
+    def get_estimate_threshold():
+        """Get the series estimation threshold.
+
+        :returns: the threshold below which the size of the result of a series multiplication is not estimated
+        :rtype: ``int``
+
+        >>> tuning.get_estimate_threshold() # doctest: +SKIP
+        200
+
+        """
+        from ._core import _tuning as _t
+        return _t._get_estimate_threshold()
+
+    @staticmethod
+    def auto_tune(n_trials=3):
+        """Select the tuning parameters for the current machine.
+
+        This method will time a set of representative polynomial multiplications, and it will set the multiplication
+        block size, the parallel memory set flag and the estimation threshold accordingly. The tuning takes a few
+        seconds.
+
+        :param n_trials: number of timed repetitions of each multiplication
+        :type n_trials: ``int``
+        :raises: any exception raised by the invoked low-level function
+
+        >>> tuning.auto_tune() # doctest: +SKIP
+        >>> tuning.auto_tune(0) # doctest: +IGNORE_EXCEPTION_DETAIL
+        Traceback (most recent call last):
+          ...
+        ValueError: the number of trials must be strictly positive
+
+        """
+        from ._core import _tuning as _t
+        return _cpp_type_catcher(_t._auto_tune, n_trials)
+
+    @staticmethod
+    def save_profile(name):
+        """Save the tuning parameters to file.
+
+        :param name: file name
+        :type name: ``str``
+        :raises: any exception raised by the invoked low-level function
+
+        >>> tuning.save_profile('piranha_profile.txt') # doctest: +SKIP
+
+        """
+        from ._core import _tuning as _t
+        return _cpp_type_catcher(_t._save_profile, name)
+
+    @staticmethod
+    def load_profile(name):
+        """Load the tuning parameters from file.
+
+        :param name: file name
+        :type name: ``str``
+        :raises: any exception raised by the invoked low-level function
+
+        >>> tuning.load_profile('piranha_profile.txt') # doctest: +SKIP
+
+        """
+        from ._core import _tuning as _t
+        return _cpp_type_catcher(_t._load_profile, name)
+
+
+class multiplication_instrumentation(object):
+    """Multiplication instrumentation class.
+
+    This class allows to collect statistics about series multiplications (e.g., the estimated and actual
+    sizes of the result, the number of rehash operations, the busy time of each thread, etc.). The collection
+    is disabled by default, and it has no cost when disabled. The methods are thread-safe.
+
+    """
+
+    @staticmethod
+    def set_enabled(flag):
+        """Enable or disable the collection of statistics.
+
+        :param flag: ``True`` to enable the collection of statistics, ``False`` to disable it
+        :type flag: ``bool``
+        :raises: any exception raised by the invoked low-level function
+
+        >>> multiplication_instrumentation.set_enabled(True)
+        >>> multiplication_instrumentation.get_enabled()
+        True
+        >>> multiplication_instrumentation.reset_enabled()
+        >>> multiplication_instrumentation.get_enabled()
+        False
+
+        """
+        from ._core import _multiplication_instrumentation as _m
+        return _cpp_type_catcher(_m._set_enabled, flag)
+
+    @staticmethod
+    def get_enabled():
+        """Check if the collection of statistics is enabled.
+
+        :returns: ``True`` if the collection of statistics is enabled, ``False`` otherwise
+        :rtype: ``bool``
+
+        >>> multiplication_instrumentation.get_enabled()
+        False
+
+        """
+        from ._core import _multiplication_instrumentation as _m
+        return _m._get_enabled()
+
+    @staticmethod
+    def reset_enabled():
+        """Disable the collection of statistics.
+
+        """
+        from ._core import _multiplication_instrumentation as _m
+        return _m._reset_enabled()
+
+    @staticmethod
+    def set_perf_counters_enabled(flag):
+        """Enable or disable the collection of hardware performance counters.
+
+        If enabled, the ``'perf_counters'`` entry in the dictionary returned by :py:meth:`get_last_statistics`
+        will contain the hardware performance counters (cycles, instructions, last-level cache misses, data TLB
+        misses and branch misses) collected during the multiplication. Only the counters available on the
+        current platform are included. The collection of the counters has a considerable overhead on small
+        multiplications.
+
+        :param flag: ``True`` to enable the collection of the counters, ``False`` to disable it
+        :type flag: ``bool``
+        :raises: any exception raised by the invoked low-level function
+
+        >>> multiplication_instrumentation.set_perf_counters_enabled(True)
+        >>> multiplication_instrumentation.get_perf_counters_enabled()
+        True
+        >>> multiplication_instrumentation.reset_perf_counters_enabled()
+        >>> multiplication_instrumentation.get_perf_counters_enabled()
+        False
+
+        """
+        from ._core import _multiplication_instrumentation as _m
+        return _cpp_type_catcher(_m._set_perf_counters_enabled, flag)
+
+    @staticmethod
+    def get_perf_counters_enabled():
+        """Check if the collection of hardware performance counters is enabled.
+
+        :returns: ``True`` if the collection of the counters is enabled, ``False`` otherwise
+        :rtype: ``bool``
+
+        """
+        from ._core import _multiplication_instrumentation as _m
+        return _m._get_perf_counters_enabled()
+
+    @staticmethod
+    def reset_perf_counters_enabled():
+        """Disable the collection of hardware performance counters.
+
+        """
+        from ._core import _multiplication_instrumentation as _m
+        return _m._reset_perf_counters_enabled()
+
+    @staticmethod
+    def clear_last_statistics():
+        """Clear the statistics of the last multiplication.
+
+        """
+        from ._core import _multiplication_instrumentation as _m
+        return _m._clear_last_statistics()
+
+    @staticmethod
+    def get_last_statistics():
+        """Get the statistics of the last multiplication.
+
+        The statistics refer to the last multiplication completed while the collection of statistics was enabled.
+        If no such multiplication took place, all the values in the returned dictionary are zero (or empty).
+
+        :returns: the statistics of the last multiplication
+        :rtype: ``dict``
+
+        >>> from .types import polynomial, integer, k_monomial
+        >>> pt = polynomial[integer,k_monomial]()
+        >>> x, y = pt('x'), pt('y')
+        >>> multiplication_instrumentation.set_enabled(True)
+        >>> p = (x + y + 1) * (x + y + 2)
+        >>> st = multiplication_instrumentation.get_last_statistics()
+        >>> st['n_term_products']
+        9
+        >>> st['actual_size']
+        6
+        >>> multiplication_instrumentation.reset_enabled()
+
+        """
+        from ._core import _multiplication_instrumentation as _m
+        return _m._get_last_statistics()
+
+
+class tracer(object):
+    """Timeline tracer class.
+
+    This class allows to record a timeline of the activity of the threads (e.g., the tasks run by the thread pool
+    and the phases of series multiplications), and to save it in the Chrome trace event format. The saved file can be
+    visualised via the ``chrome://tracing`` page of the Chrome browser or via the Perfetto UI. Tracing is disabled
+    by default, and it has a negligible cost when disabled. The methods are thread-safe.
+
+    """
+
+    @staticmethod
+    def set_enabled(flag):
+        """Enable or disable tracing.
+
+        :param flag: ``True`` to enable tracing, ``False`` to disable it
+        :type flag: ``bool``
+        :raises: any exception raised by the invoked low-level function
+
+        >>> tracer.set_enabled(True)
+        >>> tracer.get_enabled()
+        True
+        >>> tracer.reset_enabled()
+        >>> tracer.get_enabled()
+        False
+
+        """
+        from ._core import _tracer as _t
+        return _cpp_type_catcher(_t._set_enabled, flag)
+
+    @staticmethod
+    def get_enabled():
+        """Check if tracing is enabled.
+
+        :returns: ``True`` if tracing is enabled, ``False`` otherwise
+        :rtype: ``bool``
+
+        >>> tracer.get_enabled()
+        False
+
+        """
+        from ._core import _tracer as _t
+        return _t._get_enabled()
+
+    @staticmethod
+    def reset_enabled():
+        """Disable tracing.
+
+        """
+        from ._core import _tracer as _t
+        return _t._reset_enabled()
+
+    @staticmethod
+    def get_n_events():
+        """Get the number of recorded events.
+
+        :returns: the number of recorded events
+        :rtype: ``int``
+
+        >>> from .types import polynomial, integer, k_monomial
+        >>> pt = polynomial[integer,k_monomial]()
+        >>> x, y = pt('x'), pt('y')
+        >>> tracer.clear()
+        >>> tracer.set_enabled(True)
+        >>> p = (x + y + 1) * (x + y + 2)
+        >>> tracer.reset_enabled()
+        >>> tracer.get_n_events() > 0
+        True
+        >>> tracer.clear()
+        >>> tracer.get_n_events()
+        0
+
+        """
+        from ._core import _tracer as _t
+        return _t._get_n_events()
+
+    @staticmethod
+    def get_n_dropped_events():
+        """Get the number of dropped events.
+
+        Each thread can store a limited number of events: the events exceeding the limit are dropped.
+
+        :returns: the number of dropped events
+        :rtype: ``int``
+
+        """
+        from ._core import _tracer as _t
+        return _t._get_n_dropped_events()
+
+    @staticmethod
+    def clear():
+        """Clear the recorded events.
+
+        """
+        from ._core import _tracer as _t
+        return _t._clear()
+
+    @staticmethod
+    def save(name):
+        """Save the recorded events to file in the Chrome trace event format.
+
+        :param name: file name
+        :type name: ``str``
+        :raises: any exception raised by the invoked low-level function
+
+        >>> tracer.save('piranha_trace.json') # doctest: +SKIP
+
+        """
+        from ._core import _tracer as _t
+        return _cpp_type_catcher(_t._save, name)
+
+
 class data_format(object):
     """Data format.
 
@@ -31,24 +31,30 @@ see https://www.gnu.org/licenses/. */
 #include <boost/numeric/conversion/cast.hpp>
 #include <boost/python/class.hpp>
 #include <boost/python/def.hpp>
+#include <boost/python/dict.hpp>
 #include <boost/python/docstring_options.hpp>
 #include <boost/python/enum.hpp>
 #include <boost/python/errors.hpp>
 #include <boost/python/extract.hpp>
 #include <boost/python/handle.hpp>
 #include <boost/python/init.hpp>
+#include <boost/python/list.hpp>
 #include <boost/python/module.hpp>
 #include <boost/python/object.hpp>
 #include <boost/python/scope.hpp>
 #include <boost/python/stl_iterator.hpp>
+#include <cstddef>
 #include <cstdint>
 #include <mutex>
 #include <stdexcept>
 #include <string>
 #include <type_traits>
+#include <vector>
 
+#include "../src/auto_tuner.hpp"
 #include "../src/binomial.hpp"
 #include "../src/config.hpp"
+#include "../src/dd_real.hpp"
 #include "../src/divisor.hpp"
 #include "../src/divisor_series.hpp"
 #include "../src/exceptions.hpp"
@@ -59,12 +65,17 @@ see https://www.gnu.org/licenses/. */
 #include "../src/monomial.hpp"
 #include "../src/mp_integer.hpp"
 #include "../src/mp_rational.hpp"
+#include "../src/multiplication_statistics.hpp"
+#include "../src/perf_counters.hpp"
 #include "../src/poisson_series.hpp"
 #include "../src/polynomial.hpp"
 #include "../src/real.hpp"
 #include "../src/s11n.hpp"
 #include "../src/safe_cast.hpp"
+#include "../src/static_monomial.hpp"
 #include "../src/thread_pool.hpp"
+#include "../src/tracer.hpp"
+#include "../src/tuning.hpp"
 #include "../src/type_traits.hpp"
 #include "exceptions.hpp"
 #include "expose_divisor_series.hpp"
@@ -105,6 +116,52 @@ static inline void generate_argument_error(int)
 {
 }
 
+// Convert a vector into a python list.
+template <typename T>
+static inline bp::list vector_to_list(const std::vector<T> &v)
+{
+    bp::list retval;
+    for (const auto &x : v) {
+        retval.append(x);
+    }
+    return retval;
+}
+
+// Statistics of the last series multiplication, as a python dictionary.
+static inline bp::dict get_last_multiplication_statistics()
+{
+    const auto st = piranha::multiplication_instrumentation::get_last_statistics();
+    bp::dict retval;
+    retval["n_threads"] = st.n_threads;
+    retval["size1"] = st.size1;
+    retval["size2"] = st.size2;
+    retval["n_term_products"] = st.n_term_products;
+    retval["estimated"] = st.estimated;
+    retval["estimated_size"] = st.estimated_size;
+    retval["actual_size"] = st.actual_size;
+    retval["n_cancellations"] = st.n_cancellations;
+    retval["initial_bucket_count"] = st.initial_bucket_count;
+    retval["bucket_count"] = st.bucket_count;
+    retval["n_rehashes"] = st.n_rehashes;
+    retval["load_factor"] = st.load_factor;
+    retval["n_dynamic_cfs_operands"] = st.n_dynamic_cfs_operands;
+    retval["n_dynamic_cfs"] = st.n_dynamic_cfs;
+    retval["thread_busy_times"] = vector_to_list(st.thread_busy_times);
+    retval["thread_task_counts"] = vector_to_list(st.thread_task_counts);
+    retval["zone_sizes"] = vector_to_list(st.zone_sizes);
+    retval["total_time"] = st.total_time;
+    // Only the available hardware performance counters are included.
+    static const char *counter_names[] = {"cycles", "instructions", "llc_misses", "dtlb_misses", "branch_misses"};
+    bp::dict counters;
+    for (std::size_t i = 0u; i < piranha::perf_counter_values::n_counters; ++i) {
+        if (st.perf_counters.available[i]) {
+            counters[counter_names[i]] = st.perf_counters.values[i];
+        }
+    }
+    retval["perf_counters"] = counters;
+    return retval;
+}
+
 BOOST_PYTHON_MODULE(_core)
 {
     // NOTE: this is a single big lock to avoid registering types/conversions multiple times and prevent contention
@@ -151,11 +208,18 @@ BOOST_PYTHON_MODULE(_core)
     pyranha::instantiate_type_generator<piranha::integer>("integer", types_module);
     pyranha::instantiate_type_generator<piranha::rational>("rational", types_module);
     pyranha::instantiate_type_generator<piranha::real>("real", types_module);
+    pyranha::instantiate_type_generator<piranha::dd_real>("dd_real", types_module);
     pyranha::instantiate_type_generator<piranha::k_monomial>("k_monomial", types_module);
     // Register template instances of monomial, and instantiate the type generator template.
     pyranha::instantiate_type_generator_template<piranha::monomial>("monomial", types_module);
     pyranha::register_template_instance<piranha::monomial, piranha::rational>();
     pyranha::register_template_instance<piranha::monomial, std::int_least16_t>();
+    // Static monomials are parametrised over a non-type template parameter, hence we expose
+    // concrete instances only.
+    pyranha::instantiate_type_generator<piranha::static_monomial<std::int_least16_t, 6>>("static_monomial6",
+                                                                                           types_module);
+    pyranha::instantiate_type_generator<piranha::static_monomial<std::int_least16_t, 12>>("static_monomial12",
+                                                                                            types_module);
     // Same for divisor.
     pyranha::instantiate_type_generator_template<piranha::divisor>("divisor", types_module);
     pyranha::register_template_instance<piranha::divisor, std::int_least16_t>();
@@ -163,6 +227,7 @@ BOOST_PYTHON_MODULE(_core)
     pyranha::integer_converter i_c;
     pyranha::rational_converter ra_c;
     pyranha::real_converter re_c;
+    pyranha::dd_real_converter dd_c;
     // Exceptions translation.
     pyranha::generic_translate<&PyExc_ZeroDivisionError, piranha::zero_division_error>();
     pyranha::generic_translate<&PyExc_NotImplementedError, piranha::not_implemented_error>();
@@ -204,6 +269,11 @@ BOOST_PYTHON_MODULE(_core)
     pyranha::expose_polynomials_11();
     pyranha::expose_polynomials_12();
     pyranha::expose_polynomials_13();
+    pyranha::expose_polynomials_14();
+    pyranha::expose_polynomials_15();
+    pyranha::expose_polynomials_16();
+    pyranha::expose_polynomials_17();
+    pyranha::expose_polynomials_18();
     // Expose Poisson series.
     pyranha::instantiate_type_generator_template<piranha::poisson_series>("poisson_series", types_module);
     pyranha::expose_poisson_series_0();
@@ -221,6 +291,7 @@ BOOST_PYTHON_MODULE(_core)
     pyranha::expose_poisson_series_12();
     pyranha::expose_poisson_series_13();
     pyranha::expose_poisson_series_14();
+    pyranha::expose_poisson_series_15();
     // Expose divisor series.
     pyranha::instantiate_type_generator_template<piranha::divisor_series>("divisor_series", types_module);
     pyranha::expose_divisor_series_0();
@@ -253,6 +324,42 @@ BOOST_PYTHON_MODULE(_core)
         .staticmethod("_set_thread_binding");
     settings_class.def("_get_thread_binding", piranha::settings::get_thread_binding)
         .staticmethod("_get_thread_binding");
+    // Expose the tuning class.
+    bp::class_<piranha::tuning> tuning_class("_tuning", bp::init<>());
+    tuning_class.def("_get_parallel_memory_set", piranha::tuning::get_parallel_memory_set)
+        .staticmethod("_get_parallel_memory_set");
+    tuning_class.def("_get_multiplication_block_size", piranha::tuning::get_multiplication_block_size)
+        .staticmethod("_get_multiplication_block_size");
+    tuning_class.def("_get_estimate_threshold", piranha::tuning::get_estimate_threshold)
+        .staticmethod("_get_estimate_threshold");
+    tuning_class.def("_save_profile", piranha::tuning::save_profile).staticmethod("_save_profile");
+    tuning_class.def("_load_profile", piranha::tuning::load_profile).staticmethod("_load_profile");
+    tuning_class.def("_auto_tune", piranha::auto_tuner::tune).staticmethod("_auto_tune");
+    // Expose the multiplication instrumentation.
+    bp::class_<piranha::multiplication_instrumentation> mi_class("_multiplication_instrumentation", bp::init<>());
+    mi_class.def("_set_enabled", piranha::multiplication_instrumentation::set_enabled).staticmethod("_set_enabled");
+    mi_class.def("_get_enabled", piranha::multiplication_instrumentation::get_enabled).staticmethod("_get_enabled");
+    mi_class.def("_reset_enabled", piranha::multiplication_instrumentation::reset_enabled)
+        .staticmethod("_reset_enabled");
+    mi_class.def("_clear_last_statistics", piranha::multiplication_instrumentation::clear_last_statistics)
+        .staticmethod("_clear_last_statistics");
+    mi_class.def("_get_last_statistics", get_last_multiplication_statistics).staticmethod("_get_last_statistics");
+    mi_class.def("_set_perf_counters_enabled", piranha::multiplication_instrumentation::set_perf_counters_enabled)
+        .staticmethod("_set_perf_counters_enabled");
+    mi_class.def("_get_perf_counters_enabled", piranha::multiplication_instrumentation::get_perf_counters_enabled)
+        .staticmethod("_get_perf_counters_enabled");
+    mi_class.def("_reset_perf_counters_enabled", piranha::multiplication_instrumentation::reset_perf_counters_enabled)
+        .staticmethod("_reset_perf_counters_enabled");
+    // Expose the tracer.
+    bp::class_<piranha::tracer> tracer_class("_tracer", bp::init<>());
+    tracer_class.def("_set_enabled", piranha::tracer::set_enabled).staticmethod("_set_enabled");
+    tracer_class.def("_get_enabled", piranha::tracer::get_enabled).staticmethod("_get_enabled");
+    tracer_class.def("_reset_enabled", piranha::tracer::reset_enabled).staticmethod("_reset_enabled");
+    tracer_class.def("_get_n_events", piranha::tracer::get_n_events).staticmethod("_get_n_events");
+    tracer_class.def("_get_n_dropped_events", piranha::tracer::get_n_dropped_events)
+        .staticmethod("_get_n_dropped_events");
+    tracer_class.def("_clear", piranha::tracer::clear).staticmethod("_clear");
+    tracer_class.def("_save", piranha::tracer::save).staticmethod("_save");
     // Factorial.
     bp::def("_factorial", &piranha::math::factorial<0>);
 // Binomial coefficient.
@@ -352,6 +352,11 @@ void expose_polynomials_10();
 void expose_polynomials_11();
 void expose_polynomials_12();
 void expose_polynomials_13();
+void expose_polynomials_14();
+void expose_polynomials_15();
+void expose_polynomials_16();
+void expose_polynomials_17();
+void expose_polynomials_18();
 }
 
 #endif
@@ -34,6 +34,7 @@ see https://www.gnu.org/licenses/. */
 #include <cstdint>
 #include <tuple>
 
+#include "../src/dd_real.hpp"
 #include "../src/divisor.hpp"
 #include "../src/divisor_series.hpp"
 #include "../src/kronecker_monomial.hpp"
@@ -75,7 +76,10 @@ struct poisson_series_descriptor {
         std::tuple<piranha::divisor_series<piranha::polynomial<double, piranha::monomial<std::int_least16_t>>,
                                            piranha::divisor<std::int_least16_t>>>,
         std::tuple<piranha::divisor_series<piranha::polynomial<double, piranha::kronecker_monomial<>>,
-                                           piranha::divisor<std::int_least16_t>>>>;
+                                           piranha::divisor<std::int_least16_t>>>,
+        // Polynomials with double-double coefficients.
+        // NOTE: appended at the end in order not to change the indices of the other types.
+        std::tuple<piranha::polynomial<piranha::dd_real, piranha::kronecker_monomial<>>>>;
     using interop_types = std::tuple<double, piranha::integer, piranha::real, piranha::rational>;
     using pow_types = interop_types;
     using eval_types = interop_types;
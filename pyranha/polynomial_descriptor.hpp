@@ -34,12 +34,14 @@ see https://www.gnu.org/licenses/. */
 #include <cstdint>
 #include <tuple>
 
+#include "../src/dd_real.hpp"
 #include "../src/kronecker_monomial.hpp"
 #include "../src/monomial.hpp"
 #include "../src/mp_integer.hpp"
 #include "../src/mp_rational.hpp"
 #include "../src/polynomial.hpp"
 #include "../src/real.hpp"
+#include "../src/static_monomial.hpp"
 
 namespace pyranha
 {
@@ -67,7 +69,16 @@ struct polynomial_descriptor {
         // Real.
         std::tuple<piranha::real, piranha::monomial<piranha::rational>>,
         std::tuple<piranha::real, piranha::monomial<std::int_least16_t>>,
-        std::tuple<piranha::real, piranha::kronecker_monomial<>>>;
+        std::tuple<piranha::real, piranha::kronecker_monomial<>>,
+        // Static monomials with fixed number of variables.
+        // NOTE: these are appended at the end in order not to change the indices of the other types.
+        std::tuple<double, piranha::static_monomial<std::int_least16_t, 6>>,
+        std::tuple<piranha::integer, piranha::static_monomial<std::int_least16_t, 6>>,
+        std::tuple<piranha::rational, piranha::static_monomial<std::int_least16_t, 6>>,
+        std::tuple<piranha::integer, piranha::static_monomial<std::int_least16_t, 12>>,
+        // Double-double.
+        // NOTE: appended at the end in order not to change the indices of the other types.
+        std::tuple<piranha::dd_real, piranha::kronecker_monomial<>>>;
     using interop_types = std::tuple<double, piranha::integer, piranha::real, piranha::rational>;
     using pow_types = interop_types;
     using eval_types = interop_types;
@@ -42,6 +42,7 @@ see https://www.gnu.org/licenses/. */
 #include <string>
 
 #include "../src/config.hpp"
+#include "../src/dd_real.hpp"
 #include "../src/detail/mpfr.hpp"
 #include "../src/mp_integer.hpp"
 #include "../src/mp_rational.hpp"
@@ -219,17 +220,9 @@ struct real_converter {
         }
         return obj_ptr;
     }
-    static void construct(::PyObject *obj_ptr, bp::converter::rvalue_from_python_stage1_data *data)
+    // Extract the decimal digits of the mpf object obj from its repr.
+    static std::string mpf_digits(const bp::object &obj)
     {
-        // NOTE: here we cannot construct directly from string, as we need to query the precision.
-        piranha_assert(obj_ptr);
-        // NOTE: here the handle is from borrowed because we are not responsible for the generation of obj_ptr:
-        // borrowed will increase the refcount of obj_ptr, so that, when obj is destroyed, the refcount
-        // for obj_ptr goes back to the original value instead of decreasing by 1.
-        bp::handle<> obj_handle(bp::borrowed(obj_ptr));
-        bp::object obj(obj_handle);
-        const ::mpfr_prec_t prec
-            = piranha::safe_cast<::mpfr_prec_t>(static_cast<long>(bp::extract<long>(obj.attr("context").attr("prec"))));
         // NOTE: here we use repr instead of str because the repr seems to give the most accurate representation
         // in base 10 for the object.
         ::PyObject *str_obj = ::PyObject_Repr(obj.ptr());
@@ -270,9 +263,67 @@ struct real_converter {
             ::PyErr_SetString(PyExc_RuntimeError, "invalid string input converting to real");
             bp::throw_error_already_set();
         }
+        return std::string(start, s);
+    }
+    static void construct(::PyObject *obj_ptr, bp::converter::rvalue_from_python_stage1_data *data)
+    {
+        // NOTE: here we cannot construct directly from string, as we need to query the precision.
+        piranha_assert(obj_ptr);
+        // NOTE: here the handle is from borrowed because we are not responsible for the generation of obj_ptr:
+        // borrowed will increase the refcount of obj_ptr, so that, when obj is destroyed, the refcount
+        // for obj_ptr goes back to the original value instead of decreasing by 1.
+        bp::handle<> obj_handle(bp::borrowed(obj_ptr));
+        bp::object obj(obj_handle);
+        const ::mpfr_prec_t prec
+            = piranha::safe_cast<::mpfr_prec_t>(static_cast<long>(bp::extract<long>(obj.attr("context").attr("prec"))));
+        const auto digits = mpf_digits(obj);
         void *storage
             = reinterpret_cast<bp::converter::rvalue_from_python_storage<piranha::real> *>(data)->storage.bytes;
-        ::new (storage) piranha::real(std::string(start, s), prec);
+        ::new (storage) piranha::real(digits, prec);
+        data->convertible = storage;
+    }
+};
+struct dd_real_converter {
+    dd_real_converter()
+    {
+        bp::to_python_converter<piranha::dd_real, to_python>();
+        bp::converter::registry::push_back(&convertible, &construct, bp::type_id<piranha::dd_real>());
+    }
+    struct to_python {
+        static ::PyObject *convert(const piranha::dd_real &r)
+        {
+            bp::object str(boost::lexical_cast<std::string>(r));
+            try {
+                bp::object mpmath = bp::import("mpmath");
+                bp::object mpf = mpmath.attr("mpf");
+                return bp::incref(mpf(str).ptr());
+            } catch (...) {
+                ::PyErr_SetString(
+                    PyExc_RuntimeError,
+                    "could not convert double-double number to mpf object - please check the installation of mpmath");
+                bp::throw_error_already_set();
+                return nullptr;
+            }
+        }
+    };
+    static void *convertible(::PyObject *obj_ptr)
+    {
+        if (!obj_ptr || !real_converter::is_instance_of(obj_ptr, "mpmath", "mpf")) {
+            return nullptr;
+        }
+        return obj_ptr;
+    }
+    static void construct(::PyObject *obj_ptr, bp::converter::rvalue_from_python_stage1_data *data)
+    {
+        // NOTE: the precision of the mpf object is irrelevant here, the digits are parsed
+        // at a precision higher than that of dd_real.
+        piranha_assert(obj_ptr);
+        bp::handle<> obj_handle(bp::borrowed(obj_ptr));
+        bp::object obj(obj_handle);
+        const auto digits = real_converter::mpf_digits(obj);
+        void *storage
+            = reinterpret_cast<bp::converter::rvalue_from_python_storage<piranha::dd_real> *>(data)->storage.bytes;
+        ::new (storage) piranha::dd_real(digits);
         data->convertible = storage;
     }
 };
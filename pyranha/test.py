@@ -350,6 +350,11 @@ class mpmath_test_case(_ut.TestCase):
                 self.assertEqual(pt(mpf("4.5667")) ** mpf("1.234567"),
                                  mpf("4.5667") ** mpf("1.234567"))
                 self.assertEqual(pt(mpf(pi)), mpf(pi))
+        from .types import dd_real, k_monomial
+        pt = polynomial[dd_real, k_monomial]()
+        self.assertEqual(pt(4.5), 4.5)
+        self.assertEqual(pt(4.5).list[0][0], mpf("4.5"))
+        self.assertEqual((pt(1.5) * 2).list[0][0], mpf(3))
 
 
 class math_test_case(_ut.TestCase):
@@ -47,10 +47,19 @@ rational = _t.rational
 #: This type generator represents the multiprecision floating-point type provided by the piranha C++ library.
 real = _t.real
 
+#: This type generator represents the double-double floating-point type provided by the piranha C++ library
+#: (roughly 106 bits of significand, backed by a pair of ``double``).
+dd_real = _t.dd_real
+
 #: This type generator represents the Kronecker monomial type (that is, a monomial "compressed" into a single
 #: signed integral value).
 k_monomial = _t.k_monomial
 
+#: These type generators represent monomials with 16-bit exponents and a fixed maximum number of variables
+#: (6 and 12 respectively), stored in a static array.
+static_monomial6 = _t.static_monomial6
+static_monomial12 = _t.static_monomial12
+
 #: Type generator template for polynomials.
 polynomial = _t.polynomial
 
@@ -0,0 +1,224 @@
+/* Copyright 2009-2016 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#ifndef PIRANHA_AUTO_TUNER_HPP
+#define PIRANHA_AUTO_TUNER_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "config.hpp"
+#include "exceptions.hpp"
+#include "kronecker_monomial.hpp"
+#include "math.hpp"
+#include "mp_integer.hpp"
+#include "polynomial.hpp"
+#include "thread_pool.hpp"
+#include "tuning.hpp"
+
+namespace piranha
+{
+
+/// Automatic tuning of the performance parameters.
+/**
+ * This class provides a static method to select, via a set of timed multiplications, the values of the
+ * tuning parameters in piranha::tuning that are best suited for the current machine. The results
+ * can be saved via piranha::tuning::save_profile() and loaded at startup by piranha::init().
+ *
+ * The workloads used by the tuner are scaled-down versions of the polynomial multiplications in the
+ * performance test suite:
+ * - a sparse multiplication with the shape of Pearce's first test,
+ * - a dense multiplication with the shape of Fateman's first test,
+ * - a larger dense multiplication with the shape of Gastineau's first test.
+ */
+class auto_tuner
+{
+    using p_type = polynomial<integer, k_monomial>;
+    using workloads_type = std::vector<std::pair<p_type, p_type>>;
+    static workloads_type make_workloads()
+    {
+        workloads_type retval;
+        p_type x{"x"}, y{"y"}, z{"z"}, t{"t"}, u{"u"};
+        // Pearce.
+        retval.emplace_back(math::pow(x + y + z * z * 2 + t * t * t * 3 + u * u * u * u * u * 5 + 1, 6),
+                            math::pow(u + t + z * z * 2 + y * y * y * 3 + x * x * x * x * x * 5 + 1, 6));
+        // Fateman.
+        auto f = math::pow(x + y + z + t + 1, 10);
+        retval.emplace_back(f, f + 1);
+        // Gastineau.
+        f = math::pow(x + y + z + t + 1, 14);
+        retval.emplace_back(f, f + 1);
+        return retval;
+    }
+    // Best time, in nanoseconds, of n_trials executions of the workloads in [begin, end).
+    template <typename It>
+    static double time_workloads(It begin, It end, unsigned n_trials)
+    {
+        double retval = std::numeric_limits<double>::max();
+        for (unsigned i = 0u; i < n_trials; ++i) {
+            const auto start = std::chrono::steady_clock::now();
+            for (auto it = begin; it != end; ++it) {
+                (void)(it->first * it->second);
+            }
+            retval = std::min(retval, static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                                              std::chrono::steady_clock::now() - start)
+                                                              .count()));
+        }
+        return retval;
+    }
+    // Average time, in nanoseconds, of the multiplication f * f, repeated for at least 10 ms.
+    static double time_small_mult(const p_type &f)
+    {
+        using clock = std::chrono::steady_clock;
+        const auto start = clock::now();
+        unsigned long n = 0u;
+        clock::duration elapsed;
+        do {
+            (void)(f * f);
+            ++n;
+            elapsed = clock::now() - start;
+        } while (elapsed < std::chrono::milliseconds(10));
+        return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) / n;
+    }
+    // Smallest operand size for which estimating the size of the result is faster than not estimating it.
+    // NOTE: the estimate threshold matters only in single-threaded multiplications, this is meant to be
+    // run from a thread in the pool so that the multiplications are serial.
+    static unsigned long find_estimate_threshold()
+    {
+        p_type x{"x"}, y{"y"}, z{"z"}, t{"t"};
+        const auto base = x + y + z + t + 1;
+        std::vector<p_type> ops;
+        for (unsigned i = 1u; i <= 12u; ++i) {
+            ops.push_back(math::pow(base, i));
+        }
+        std::vector<bool> wins;
+        for (const auto &f : ops) {
+            tuning::set_estimate_threshold(0u);
+            const double t_est = time_small_mult(f);
+            tuning::set_estimate_threshold(std::numeric_limits<unsigned long>::max());
+            const double t_no_est = time_small_mult(f);
+            wins.push_back(t_est < t_no_est);
+        }
+        // Require two consecutive wins, in order to reduce the effect of noise in the measurements.
+        for (decltype(ops.size()) i = 0u; i + 1u < ops.size(); ++i) {
+            if (wins[i] && wins[i + 1u]) {
+                return static_cast<unsigned long>(ops[i].size());
+            }
+        }
+        return static_cast<unsigned long>(ops.back().size());
+    }
+    // Restore the initial values of the parameters in case of errors.
+    struct restorer {
+        restorer()
+            : m_pms(tuning::get_parallel_memory_set()), m_bsize(tuning::get_multiplication_block_size()),
+              m_e_thr(tuning::get_estimate_threshold()), m_active(true)
+        {
+        }
+        ~restorer()
+        {
+            if (m_active) {
+                tuning::set_parallel_memory_set(m_pms);
+                tuning::set_multiplication_block_size(m_bsize);
+                tuning::set_estimate_threshold(m_e_thr);
+            }
+        }
+        const bool m_pms;
+        const unsigned long m_bsize;
+        const unsigned long m_e_thr;
+        bool m_active;
+    };
+
+public:
+    /// Run the auto-tuner.
+    /**
+     * This method will set, in this order:
+     * - the multiplication block size (see piranha::tuning::get_multiplication_block_size()), choosing the value
+     *   which minimises the total time of the workloads among the powers of two from a quarter to eight times the
+     *   default value derived from the size of the L1 cache;
+     * - the \p parallel_memory_set flag (see piranha::tuning::get_parallel_memory_set()), by comparing the time of
+     *   the largest workload with and without the flag. The flag is not modified if the thread pool has a single
+     *   thread;
+     * - the estimate threshold (see piranha::tuning::get_estimate_threshold()), as the smallest size of the operands
+     *   of a dense multiplication for which the estimation of the size of the result pays off in single-threaded
+     *   mode.
+     *
+     * The other tuning parameters are not modified. The tuning is performed with the current settings of the thread
+     * pool, and it takes a few seconds on a modern machine. In case of errors, the tuning parameters are restored to
+     * their original values.
+     *
+     * @param n_trials number of timed repetitions of each workload.
+     *
+     * @throws std::invalid_argument if \p n_trials is zero.
+     * @throws unspecified any exception thrown by:
+     * - the arithmetic operations on piranha::polynomial,
+     * - piranha::thread_pool::enqueue(),
+     * - memory allocation errors in standard containers.
+     */
+    static void tune(unsigned n_trials = 3u)
+    {
+        if (unlikely(n_trials == 0u)) {
+            piranha_throw(std::invalid_argument, "the number of trials must be strictly positive");
+        }
+        restorer r;
+        const auto workloads = make_workloads();
+        // Block size: try the powers of two from a quarter to eight times the default value, which is derived
+        // from the size of the L1 cache.
+        const auto def_bsize = detail::default_mult_block_size();
+        unsigned long best_bsize = r.m_bsize;
+        double best_time = std::numeric_limits<double>::max();
+        for (auto bsize = std::max(def_bsize / 4u, 16ul); bsize <= std::min(def_bsize * 8u, 4096ul); bsize *= 2u) {
+            tuning::set_multiplication_block_size(bsize);
+            const double t = time_workloads(workloads.begin(), workloads.end(), n_trials);
+            if (t < best_time) {
+                best_time = t;
+                best_bsize = bsize;
+            }
+        }
+        tuning::set_multiplication_block_size(best_bsize);
+        // Parallel memory set.
+        if (thread_pool::size() > 1u) {
+            tuning::set_parallel_memory_set(true);
+            const double t_par = time_workloads(workloads.end() - 1, workloads.end(), n_trials);
+            tuning::set_parallel_memory_set(false);
+            const double t_ser = time_workloads(workloads.end() - 1, workloads.end(), n_trials);
+            tuning::set_parallel_memory_set(t_par <= t_ser);
+        } else {
+            tuning::set_parallel_memory_set(r.m_pms);
+        }
+        // Estimate threshold.
+        tuning::set_estimate_threshold(thread_pool::enqueue(0u, find_estimate_threshold).get());
+        r.m_active = false;
+    }
+};
+}
+
+#endif
@@ -32,10 +32,12 @@ see https://www.gnu.org/licenses/. */
 #include <algorithm>
 #include <array>
 #include <boost/numeric/conversion/cast.hpp>
+#include <chrono>
 #include <cmath>
 #include <cstddef>
 #include <iterator>
 #include <limits>
+#include <memory>
 #include <mutex>
 #include <random>
 #include <stdexcept>
@@ -44,18 +46,23 @@ see https://www.gnu.org/licenses/. */
 #include <vector>
 
 #include "config.hpp"
+#include "convert_to.hpp"
+#include "cost_model.hpp"
 #include "detail/atomic_flag_array.hpp"
 #include "detail/atomic_lock_guard.hpp"
 #include "exceptions.hpp"
+#include "hash_set.hpp"
 #include "key_is_multipliable.hpp"
 #include "math.hpp"
 #include "mp_integer.hpp"
 #include "mp_rational.hpp"
+#include "multiplication_statistics.hpp"
+#include "perf_counters.hpp"
 #include "safe_cast.hpp"
 #include "series.hpp"
-#include "settings.hpp"
 #include "symbol_set.hpp"
 #include "thread_pool.hpp"
+#include "tracer.hpp"
 #include "tuning.hpp"
 #include "type_traits.hpp"
 
@@ -65,6 +72,17 @@ namespace piranha
 namespace detail
 {
 
+// Enabler for the mixed-type constructor of base_series_multiplier: T must be a series type different from Series,
+// with the same recursion index and key type, and with a coefficient type convertible to the coefficient type of
+// Series.
+template <typename Series, typename T>
+using base_series_multiplier_mixed_enabler = typename std::enable_if<
+    is_series<T>::value && !std::is_same<Series, T>::value
+        && series_recursion_index<T>::value == series_recursion_index<Series>::value
+        && std::is_same<typename Series::term_type::key_type, typename T::term_type::key_type>::value
+        && has_convert_to<typename Series::term_type::cf_type, typename T::term_type::cf_type>::value,
+    int>::type;
+
 template <typename Series, typename Derived, typename = void>
 struct base_series_multiplier_impl {
     using term_type = typename Series::term_type;
@@ -125,19 +143,11 @@ struct base_series_multiplier_impl {
             using vv_size_t = typename vv_t::size_type;
             vv_t vv(safe_cast<vv_size_t>(n_threads));
             // Go with the threads.
-            future_list<void> ff_list;
-            try {
-                for (unsigned i = 0u; i < n_threads; ++i) {
-                    ff_list.push_back(thread_pool::enqueue(i, thread_func, i, c, &(vv[static_cast<vv_size_t>(i)])));
+            thread_pool::parallel_for(0u, n_threads, 1u, [&](std::size_t i_start, std::size_t i_end) {
+                for (auto i = i_start; i != i_end; ++i) {
+                    thread_func(static_cast<unsigned>(i), c, &(vv[static_cast<vv_size_t>(i)]));
                 }
-                // First let's wait for everything to finish.
-                ff_list.wait_all();
-                // Then, let's handle the exceptions.
-                ff_list.get_all();
-            } catch (...) {
-                ff_list.wait_all();
-                throw;
-            }
+            });
             // Last, we need to merge everything into v.
             for (const auto &vi : vv) {
                 v->insert(v->end(), vi.begin(), vi.end());
@@ -146,6 +156,17 @@ struct base_series_multiplier_impl {
         thread_wrapper(&c1, &v1);
         thread_wrapper(&c2, &v2);
     }
+    // Mixed-type multiplication: the terms of the second operand have already been converted into t2.
+    // NOTE: the converted terms follow the iteration (i.e., bucket) order of the original operand, they are just
+    // not sorted within the buckets.
+    void fill_term_pointers(const container_type &c1, std::vector<term_type> &t2, std::vector<term_type const *> &v1,
+                            std::vector<term_type const *> &v2)
+    {
+        std::vector<term_type const *> v_empty;
+        container_type c_empty;
+        fill_term_pointers(c1, c_empty, v1, v_empty);
+        std::transform(t2.begin(), t2.end(), std::back_inserter(v2), [](const term_type &t) { return &t; });
+    }
 };
 
 template <typename Series, typename Derived>
@@ -193,6 +214,34 @@ struct base_series_multiplier_impl<Series, Derived, typename std::enable_if<is_m
         piranha_assert(v1.size() == c1.size());
         piranha_assert(v2.size() == c2.size());
     }
+    // Mixed-type multiplication: the terms of the second operand have already been converted into t2,
+    // and they are renormalised in place instead of being copied into m_terms2.
+    void fill_term_pointers(const container_type &c1, std::vector<term_type> &t2, std::vector<term_type const *> &v1,
+                            std::vector<term_type const *> &v2)
+    {
+        m_lcm = 1;
+        int_type g;
+        auto update_lcm = [this, &g](const int_type &den) {
+            math::gcd3(g, m_lcm, den);
+            math::mul3(m_lcm, m_lcm, den);
+            int_type::_divexact(m_lcm, m_lcm, g);
+        };
+        for (const auto &t : c1) {
+            update_lcm(t.m_cf.den());
+        }
+        for (const auto &t : t2) {
+            update_lcm(t.m_cf.den());
+        }
+        piranha_assert(m_lcm.sign() == 1);
+        for (const auto &t : c1) {
+            m_terms1.push_back(term_type(rat_type(m_lcm / t.m_cf.den() * t.m_cf.num(), int_type(1)), t.m_key));
+        }
+        for (auto &t : t2) {
+            t.m_cf = rat_type(m_lcm / t.m_cf.den() * t.m_cf.num(), int_type(1));
+        }
+        std::transform(m_terms1.begin(), m_terms1.end(), std::back_inserter(v1), [](const term_type &t) { return &t; });
+        std::transform(t2.begin(), t2.end(), std::back_inserter(v2), [](const term_type &t) { return &t; });
+    }
     std::vector<term_type> m_terms1;
     std::vector<term_type> m_terms2;
     int_type m_lcm;
@@ -305,25 +354,63 @@ private:
             }
         };
         // Go with the threads.
-        future_list<decltype(thread_func(0u))> ff_list;
-        try {
-            for (unsigned i = 0u; i < m_n_threads; ++i) {
-                ff_list.push_back(thread_pool::enqueue(i, thread_func, i));
+        thread_pool::parallel_for(0u, m_n_threads, 1u, [&thread_func](std::size_t i_start, std::size_t i_end) {
+            for (auto i = i_start; i != i_end; ++i) {
+                thread_func(static_cast<unsigned>(i));
             }
-            // First let's wait for everything to finish.
-            ff_list.wait_all();
-            // Then, let's handle the exceptions.
-            ff_list.get_all();
-        } catch (...) {
-            ff_list.wait_all();
-            throw;
-        }
+        });
     }
     template <typename T,
               typename std::enable_if<!detail::is_mp_rational<typename T::term_type::cf_type>::value, int>::type = 0>
     void finalise_impl(T &) const
     {
     }
+    // Setup of the statistics of the multiplication.
+    template <typename C1, typename C2>
+    void init_statistics(const C1 &c1, const C2 &c2)
+    {
+        m_stats.reset(new multiplication_statistics());
+        m_stats_start = std::chrono::steady_clock::now();
+        m_stats->n_threads = m_n_threads;
+        m_stats->size1 = static_cast<unsigned long long>(m_v1.size());
+        m_stats->size2 = static_cast<unsigned long long>(m_v2.size());
+        m_stats->n_term_products = m_stats->size1 * m_stats->size2;
+        m_stats->thread_busy_times.resize(m_n_threads);
+        m_stats->thread_task_counts.resize(m_n_threads);
+        for (const auto &t : c1) {
+            if (detail::is_dynamic_cf(t.m_cf)) {
+                ++m_stats->n_dynamic_cfs_operands;
+            }
+        }
+        for (const auto &t : c2) {
+            if (detail::is_dynamic_cf(t.m_cf)) {
+                ++m_stats->n_dynamic_cfs_operands;
+            }
+        }
+        if (multiplication_instrumentation::get_perf_counters_enabled()) {
+            m_perf_counters.reset(new perf_counters());
+            m_perf_counters->start();
+        }
+    }
+    // Finalisation and publication of the statistics of the multiplication.
+    void publish_statistics(const Series &s) const
+    {
+        if (m_perf_counters) {
+            m_stats->perf_counters = m_perf_counters->stop();
+        }
+        const auto &container = s._container();
+        m_stats->actual_size = static_cast<unsigned long long>(s.size());
+        m_stats->bucket_count = static_cast<unsigned long long>(container.bucket_count());
+        m_stats->load_factor = container.load_factor();
+        m_stats->n_dynamic_cfs = 0u;
+        for (const auto &t : container) {
+            if (detail::is_dynamic_cf(t.m_cf)) {
+                ++m_stats->n_dynamic_cfs;
+            }
+        }
+        m_stats->total_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_stats_start).count();
+        multiplication_instrumentation::_publish(*m_stats);
+    }
 
 public:
     /// Constructor.
@@ -348,9 +435,12 @@ public:
      * @param[in] s1 first series.
      * @param[in] s2 second series.
      *
+     * If the collection of statistics is enabled (see piranha::multiplication_instrumentation), the constructor
+     * will also set up base_series_multiplier::m_stats.
+     *
      * @throws std::invalid_argument if the symbol sets of \p s1 and \p s2 differ.
      * @throws unspecified any exception thrown by:
-     * - thread_pool::use_threads(),
+     * - cost_model::use_threads(),
      * - memory allocation errors in standard containers,
      * - the construction of the term, coefficient and key types of \p Series,
      * - the public interface of piranha::hash_set.
@@ -389,10 +479,74 @@ public:
         }
         // Set the number of threads.
         m_n_threads = (ctr1->size() && ctr2->size())
-                          ? thread_pool::use_threads(integer(ctr1->size()) * ctr2->size(),
-                                                     integer(settings::get_min_work_per_thread()))
+                          ? cost_model::use_threads<Series>(cost_operation::multiplication,
+                                                            integer(ctr1->size()) * ctr2->size())
                           : 1u;
         this->fill_term_pointers(*ctr1, *ctr2, m_v1, m_v2);
+        if (multiplication_instrumentation::get_enabled()) {
+            init_statistics(*ctr1, *ctr2);
+        }
+    }
+    /// Mixed-type constructor.
+    /**
+     * \note
+     * This constructor is enabled only if \p T is a series type different from \p Series, with the same recursion
+     * index and key type, and whose coefficient type is convertible to the coefficient type of \p Series via
+     * piranha::convert_to().
+     *
+     * This constructor is equivalent to the other constructor called with \p s2 converted to \p Series. The terms of
+     * \p s2 are still converted (and thus copied), but into a flat private vector rather than into a series: the
+     * pointers in base_series_multiplier::m_v1 or base_series_multiplier::m_v2 will refer to this vector, and no hash
+     * table is built for the converted terms. If the coefficient type of \p Series is an instance of
+     * piranha::mp_rational, the converted terms are renormalised in place, rather than copied a second time.
+     *
+     * @param[in] s1 first series.
+     * @param[in] s2 second series.
+     *
+     * @throws std::invalid_argument if the symbol sets of \p s1 and \p s2 differ.
+     * @throws unspecified any exception thrown by:
+     * - piranha::convert_to(),
+     * - the other constructor.
+     */
+    template <typename T, detail::base_series_multiplier_mixed_enabler<Series, T> = 0>
+    explicit base_series_multiplier(const Series &s1, const T &s2) : m_ss(s1.get_symbol_set())
+    {
+        if (unlikely(s1.get_symbol_set() != s2.get_symbol_set())) {
+            piranha_throw(std::invalid_argument, "incompatible arguments sets");
+        }
+        using term_type = typename Series::term_type;
+        using cf_type = typename term_type::cf_type;
+        using key_type = typename term_type::key_type;
+        container_type const *ctr1 = &s1._container();
+        m_conv_terms.reserve(static_cast<typename std::vector<term_type>::size_type>(s2.size()));
+        for (const auto &t : s2._container()) {
+            m_conv_terms.emplace_back(convert_to<cf_type>(t.m_cf), t.m_key);
+        }
+        // See the other constructor.
+        if (!zero_is_absorbing<Series>::value) {
+            if (s1.empty()) {
+                m_zero_f1.insert(term_type{cf_type(0), key_type(s1.get_symbol_set())});
+                ctr1 = &m_zero_f1;
+            }
+            if (m_conv_terms.empty()) {
+                m_conv_terms.emplace_back(cf_type(0), key_type(s1.get_symbol_set()));
+            }
+        }
+        m_v1.reserve(static_cast<size_type>(std::max<decltype(s1.size())>(ctr1->size(), m_conv_terms.size())));
+        m_v2.reserve(static_cast<size_type>(std::min<decltype(s1.size())>(ctr1->size(), m_conv_terms.size())));
+        m_n_threads = (ctr1->size() && m_conv_terms.size())
+                          ? cost_model::use_threads<Series>(cost_operation::multiplication,
+                                                            integer(ctr1->size()) * m_conv_terms.size())
+                          : 1u;
+        // The largest operand goes first.
+        if (ctr1->size() < m_conv_terms.size()) {
+            this->fill_term_pointers(*ctr1, m_conv_terms, m_v2, m_v1);
+        } else {
+            this->fill_term_pointers(*ctr1, m_conv_terms, m_v1, m_v2);
+        }
+        if (multiplication_instrumentation::get_enabled()) {
+            init_statistics(*ctr1, m_conv_terms);
+        }
     }
     /// Deleted default constructor.
     base_series_multiplier() = delete;
@@ -560,8 +714,7 @@ protected:
      * - memory errors in standard containers,
      * - the conversion operator of piranha::integer,
      * - standard threading primitives,
-     * - thread_pool::enqueue(),
-     * - future_list::push_back().
+     * - thread_pool::parallel_for().
      */
     template <std::size_t MultArity, typename MultFunctor, typename LimitFunctor>
     bucket_size_type estimate_final_series_size(const LimitFunctor &lf) const
@@ -569,6 +722,7 @@ protected:
         PIRANHA_TT_CHECK(is_function_object, MultFunctor, void, const size_type &, const size_type &);
         PIRANHA_TT_CHECK(std::is_constructible, MultFunctor, const base_series_multiplier &, Series &);
         PIRANHA_TT_CHECK(is_function_object, LimitFunctor, size_type, const size_type &);
+        trace_scope ts("estimate", "multiplication");
         // Cache these.
         const size_type size1 = m_v1.size(), size2 = m_v2.size();
         constexpr std::size_t result_size = MultArity;
@@ -702,19 +856,11 @@ protected:
         if (n_threads == 1u) {
             estimator(0u);
         } else {
-            future_list<void> f_list;
-            try {
-                for (unsigned i = 0u; i < n_threads; ++i) {
-                    f_list.push_back(thread_pool::enqueue(i, estimator, i));
+            thread_pool::parallel_for(0u, n_threads, 1u, [&estimator](std::size_t i_start, std::size_t i_end) {
+                for (auto i = i_start; i != i_end; ++i) {
+                    estimator(static_cast<unsigned>(i));
                 }
-                // First let's wait for everything to finish.
-                f_list.wait_all();
-                // Then, let's handle the exceptions.
-                f_list.get_all();
-            } catch (...) {
-                f_list.wait_all();
-                throw;
-            }
+            });
         }
         piranha_assert(c_estimate >= n_trials);
         // Return the mean.
@@ -751,6 +897,10 @@ protected:
      * using the low-level interface of piranha::hash_set, otherwise the call operator will use
      * piranha::series::insert() for
      * term insertion.
+     *
+     * If the lazy canonicalisation mode of piranha::mp_rational is active in the thread constructing the functor (see
+     * piranha::mp_rational_lazy_scope), the rational coefficients of the coefficients of the return value will
+     * not be canonicalised when terms are merged.
      */
     template <bool FastMode>
     class plain_multiplier
@@ -771,7 +921,8 @@ protected:
          * @param[in] retval the \p Series instance into which terms resulting from multiplications will be inserted.
          */
         explicit plain_multiplier(const base_series_multiplier &bsm, Series &retval)
-            : m_v1(bsm.m_v1), m_v2(bsm.m_v2), m_retval(retval), m_c_end(retval._container().end())
+            : m_v1(bsm.m_v1), m_v2(bsm.m_v2), m_retval(retval), m_c_end(retval._container().end()),
+              m_lazy(mp_rational_lazy_scope::is_active())
         {
         }
         /// Deleted copy constructor.
@@ -800,6 +951,7 @@ protected:
         {
             // First perform the multiplication.
             key_type::multiply(m_tmp_t, *m_v1[i], *m_v2[j], m_retval.get_symbol_set());
+            detail::mp_rational_lazy_merge_guard lmg(m_lazy);
             for (std::size_t n = 0u; n < m_arity; ++n) {
                 auto &tmp_term = m_tmp_t[n];
                 if (FastMode) {
@@ -824,6 +976,7 @@ protected:
         const std::vector<term_type const *> &m_v2;
         Series &m_retval;
         const it_type m_c_end;
+        const bool m_lazy;
     };
     /// Sanitise series.
     /**
@@ -846,6 +999,8 @@ protected:
      *
      * @param[in] retval the series to be sanitised.
      * @param[in] n_threads the number of threads to be used.
+     * @param[out] n_removed if not null, the number of terms removed from \p retval will be added to the value
+     * pointed to by \p n_removed.
      *
      * @throws std::invalid_argument if \p n_threads is zero, or if one of the terms in \p retval is not compatible
      * with the symbol set of \p retval.
@@ -854,21 +1009,22 @@ protected:
      * @throws unspecified any exception thrown by:
      * - the cast operator of piranha::integer,
      * - standard threading primitives,
-     * - thread_pool::enqueue(),
-     * - future_list::push_back().
+     * - thread_pool::parallel_for().
      */
-    static void sanitise_series(Series &retval, unsigned n_threads)
+    static void sanitise_series(Series &retval, unsigned n_threads, unsigned long long *n_removed = nullptr)
     {
         using term_type = typename Series::term_type;
         if (unlikely(n_threads == 0u)) {
             piranha_throw(std::invalid_argument, "invalid number of threads");
         }
+        trace_scope ts("sanitise", "multiplication");
         auto &container = retval._container();
         const auto &args = retval.get_symbol_set();
         // Reset the size to zero before doing anything.
         container._update_size(static_cast<bucket_size_type>(0u));
         // Single-thread implementation.
         if (n_threads == 1u) {
+            unsigned long long removed = 0u;
             const auto it_end = container.end();
             for (auto it = container.begin(); it != it_end;) {
                 if (unlikely(!it->is_compatible(args))) {
@@ -881,21 +1037,27 @@ protected:
                 container._update_size(static_cast<bucket_size_type>(container.size() + 1u));
                 if (unlikely(it->is_ignorable(args))) {
                     it = container.erase(it);
+                    ++removed;
                 } else {
                     ++it;
                 }
             }
+            if (n_removed) {
+                *n_removed += removed;
+            }
             return;
         }
         // Multi-thread implementation.
         const auto b_count = container.bucket_count();
         std::mutex m;
         integer global_count(0);
-        auto eraser = [b_count, &container, &m, &args, &global_count](const bucket_size_type &start,
-                                                                      const bucket_size_type &end) {
+        unsigned long long global_removed = 0u;
+        auto eraser = [b_count, &container, &m, &args, &global_count, &global_removed](const bucket_size_type &start,
+                                                                                       const bucket_size_type &end) {
             piranha_assert(start <= end && end <= b_count);
             (void)b_count;
             bucket_size_type count = 0u;
+            unsigned long long removed = 0u;
             std::vector<term_type> term_list;
             // Examine and count the terms bucket-by-bucket.
             for (bucket_size_type i = start; i != end; ++i) {
@@ -924,33 +1086,31 @@ protected:
                     // Account for the erased term.
                     piranha_assert(count > 0u);
                     count = static_cast<bucket_size_type>(count - 1u);
+                    ++removed;
                 }
             }
             // Update the global count.
             std::lock_guard<std::mutex> lock(m);
             global_count += count;
+            global_removed += removed;
         };
-        future_list<decltype(eraser(bucket_size_type(), bucket_size_type()))> f_list;
-        try {
-            for (unsigned i = 0u; i < n_threads; ++i) {
+        // NOTE: there's not need to clear retval in case of errors - it was already in an inconsistent
+        // state coming into this method. We rather need to make sure sanitise_series() is always
+        // called in a try/catch block that clears retval in case of errors.
+        thread_pool::parallel_for(0u, n_threads, 1u, [&](std::size_t i_start, std::size_t i_end) {
+            for (auto j = i_start; j != i_end; ++j) {
+                const auto i = static_cast<unsigned>(j);
                 const auto start = static_cast<bucket_size_type>((b_count / n_threads) * i),
                            end = static_cast<bucket_size_type>(
                                (i == n_threads - 1u) ? b_count : (b_count / n_threads) * (i + 1u));
-                f_list.push_back(thread_pool::enqueue(i, eraser, start, end));
+                eraser(start, end);
             }
-            // First let's wait for everything to finish.
-            f_list.wait_all();
-            // Then, let's handle the exceptions.
-            f_list.get_all();
-        } catch (...) {
-            f_list.wait_all();
-            // NOTE: there's not need to clear retval here - it was already in an inconsistent
-            // state coming into this method. We rather need to make sure sanitise_series() is always
-            // called in a try/catch block that clears retval in case of errors.
-            throw;
-        }
+        });
         // Final update of the total count.
         container._update_size(static_cast<bucket_size_type>(global_count));
+        if (n_removed) {
+            *n_removed += global_removed;
+        }
     }
     /// A plain series multiplication routine.
     /**
@@ -984,8 +1144,7 @@ protected:
      * - base_series_multiplier::blocked_multiplication(),
      * - base_series_multiplier::sanitise_series(),
      * - the <tt>multiply()</tt> method of the key type of \p Series,
-     * - thread_pool::enqueue(),
-     * - future_list::push_back(),
+     * - thread_pool::parallel_for(),
      * - the construction of terms,
      * - in-place addition of coefficients.
      */
@@ -1001,6 +1160,7 @@ protected:
         // Setup the return value with the merged symbol set.
         Series retval;
         retval.set_symbol_set(m_ss);
+        const auto rt = track_rehashes(retval);
         // Do not do anything if one of the two series is empty.
         if (unlikely(m_v1.empty() || m_v2.empty())) {
             return retval;
@@ -1011,6 +1171,9 @@ protected:
         // Convert n_threads to size_type for convenience.
         const size_type n_threads = safe_cast<size_type>(m_n_threads);
         piranha_assert(n_threads);
+        // In lazy mode, the rationals in the coefficients of retval are merged without canonicalisation
+        // (see plain_multiplier), and they are canonicalised once after the multiplication.
+        const bool lazy = mp_rational_lazy_scope::is_active();
         // Determine if we should estimate the size. We check the threshold, but we always
         // need to estimate in multithreaded mode.
         bool estimate = true;
@@ -1018,6 +1181,14 @@ protected:
         if (integer(m_v1.size()) * m_v2.size() < integer(e_thr) * e_thr && n_threads == 1u) {
             estimate = false;
         }
+        if (m_stats) {
+            // Count the term-by-term multiplications allowed by the limit functor.
+            unsigned long long n_products = 0u;
+            for (size_type i = 0u; i < size1; ++i) {
+                n_products += std::min<size_type>(lf(i), m_v2.size());
+            }
+            m_stats->n_term_products = n_products;
+        }
         if (estimate) {
             // Estimate and rehash.
             const auto est = estimate_final_series_size<m_arity, plain_multiplier<false>>(lf);
@@ -1031,16 +1202,27 @@ protected:
             // we tie together pinned threads with potentially different NUMA regions.
             const unsigned n_threads_rehash = tuning::get_parallel_memory_set() ? static_cast<unsigned>(n_threads) : 1u;
             retval._container().rehash(n_buckets, n_threads_rehash);
+            record_estimate(est, retval);
         }
         if (n_threads == 1u) {
             try {
                 // Single-thread case.
+                {
+                    detail::thread_work_recorder rec(m_stats.get(), 0u);
+                    trace_scope ts("table_fill", "multiplication");
+                    rec.add_tasks(1u);
+                    if (estimate) {
+                        blocked_multiplication(plain_multiplier<true>(*this, retval), 0u, size1, lf);
+                    } else {
+                        blocked_multiplication(plain_multiplier<false>(*this, retval), 0u, size1, lf);
+                    }
+                }
+                if (lazy) {
+                    detail::lazy_canonicaliser<Series>{}(retval);
+                }
+                // If we estimated beforehand, we need to sanitise the series.
                 if (estimate) {
-                    blocked_multiplication(plain_multiplier<true>(*this, retval), 0u, size1, lf);
-                    // If we estimated beforehand, we need to sanitise the series.
-                    sanitise_series(retval, static_cast<unsigned>(n_threads));
-                } else {
-                    blocked_multiplication(plain_multiplier<false>(*this, retval), 0u, size1, lf);
+                    sanitise_series(retval, static_cast<unsigned>(n_threads), stats_n_cancellations());
                 }
                 finalise_series(retval);
                 return retval;
@@ -1053,52 +1235,57 @@ protected:
         piranha_assert(estimate);
         // Init the vector of spinlocks.
         detail::atomic_flag_array sl_array(safe_cast<std::size_t>(retval._container().bucket_count()));
-        // Init the future list.
-        future_list<void> f_list;
         // Thread block size.
         const auto block_size = size1 / n_threads;
         try {
-            for (size_type idx = 0u; idx < n_threads; ++idx) {
-                // Thread functor.
-                auto tf = [idx, this, block_size, n_threads, &sl_array, &retval, &lf]() {
-                    // Used to store the result of term multiplication.
-                    std::array<term_type, key_type::multiply_arity> tmp_t;
-                    // End of retval container (thread-safe).
-                    const auto c_end = retval._container().end();
-                    // Block functor.
-                    // NOTE: this is very similar to the plain functor, but it does the bucket locking
-                    // additionally.
-                    auto f = [&c_end, &tmp_t, this, &retval, &sl_array](const size_type &i, const size_type &j) {
-                        // Run the term multiplication.
-                        key_type::multiply(tmp_t, *(this->m_v1[i]), *(this->m_v2[j]), retval.get_symbol_set());
-                        for (std::size_t n = 0u; n < key_type::multiply_arity; ++n) {
-                            auto &container = retval._container();
-                            auto &tmp_term = tmp_t[n];
-                            // Try to locate the term into retval.
-                            auto bucket_idx = container._bucket(tmp_term);
-                            // Lock the bucket.
-                            detail::atomic_lock_guard alg(sl_array[static_cast<std::size_t>(bucket_idx)]);
-                            const auto it = container._find(tmp_term, bucket_idx);
-                            if (it == c_end) {
-                                container._unique_insert(term_insertion(tmp_term), bucket_idx);
-                            } else {
-                                it->m_cf += tmp_term.m_cf;
-                            }
+            // Thread functor.
+            auto tf = [this, block_size, n_threads, &sl_array, &retval, &lf, lazy](const size_type &idx) {
+                detail::thread_work_recorder rec(this->m_stats.get(), static_cast<std::size_t>(idx));
+                trace_scope ts("table_fill", "multiplication");
+                rec.add_tasks(1u);
+                // Used to store the result of term multiplication.
+                std::array<term_type, key_type::multiply_arity> tmp_t;
+                // End of retval container (thread-safe).
+                const auto c_end = retval._container().end();
+                // Block functor.
+                // NOTE: this is very similar to the plain functor, but it does the bucket locking
+                // additionally.
+                auto f = [&c_end, &tmp_t, this, &retval, &sl_array, lazy](const size_type &i, const size_type &j) {
+                    // Run the term multiplication.
+                    key_type::multiply(tmp_t, *(this->m_v1[i]), *(this->m_v2[j]), retval.get_symbol_set());
+                    detail::mp_rational_lazy_merge_guard lmg(lazy);
+                    for (std::size_t n = 0u; n < key_type::multiply_arity; ++n) {
+                        auto &container = retval._container();
+                        auto &tmp_term = tmp_t[n];
+                        // Try to locate the term into retval.
+                        auto bucket_idx = container._bucket(tmp_term);
+                        // Lock the bucket.
+                        detail::atomic_lock_guard alg(sl_array[static_cast<std::size_t>(bucket_idx)]);
+                        const auto it = container._find(tmp_term, bucket_idx);
+                        if (it == c_end) {
+                            container._unique_insert(term_insertion(tmp_term), bucket_idx);
+                        } else {
+                            it->m_cf += tmp_term.m_cf;
                         }
-                    };
-                    // Thread block limit.
-                    const auto e1
-                        = (idx == n_threads - 1u) ? this->m_v1.size() : static_cast<size_type>((idx + 1u) * block_size);
-                    this->blocked_multiplication(f, static_cast<size_type>(idx * block_size), e1, lf);
+                    }
                 };
-                f_list.push_back(thread_pool::enqueue(static_cast<unsigned>(idx), tf));
+                // Thread block limit.
+                const auto e1
+                    = (idx == n_threads - 1u) ? this->m_v1.size() : static_cast<size_type>((idx + 1u) * block_size);
+                this->blocked_multiplication(f, static_cast<size_type>(idx * block_size), e1, lf);
+            };
+            thread_pool::parallel_for(0u, static_cast<std::size_t>(n_threads), 1u,
+                                      [&tf](std::size_t i_start, std::size_t i_end) {
+                                          for (auto idx = i_start; idx != i_end; ++idx) {
+                                              tf(static_cast<size_type>(idx));
+                                          }
+                                      });
+            if (lazy) {
+                detail::lazy_canonicaliser<Series>{}(retval);
             }
-            f_list.wait_all();
-            f_list.get_all();
-            sanitise_series(retval, static_cast<unsigned>(n_threads));
+            sanitise_series(retval, static_cast<unsigned>(n_threads), stats_n_cancellations());
             finalise_series(retval);
         } catch (...) {
-            f_list.wait_all();
             // Clean up retval as it might be in an inconsistent state.
             retval._container().clear();
             throw;
@@ -1120,24 +1307,79 @@ protected:
     /**
      * This method will finalise the output \p s of a series multiplication undertaken via
      * piranha::base_series_multiplier.
-     * Currently, this method will not do anything unless the coefficient type of \p Series is an instance of
-     * piranha::mp_rational.
-     * In this case, the coefficients of \p s will be normalised with respect to the least common multiplier computed in
+     * If the coefficient type of \p Series is an instance of piranha::mp_rational,
+     * the coefficients of \p s will be normalised with respect to the least common multiplier computed in
      * the
      * constructor of piranha::base_series_multiplier.
      *
+     * If the collection of statistics is enabled, this method will also complete base_series_multiplier::m_stats
+     * with the properties of \p s and publish it via piranha::multiplication_instrumentation.
+     *
      * @param[in,out] s the \p Series to be finalised.
      *
      * @throws unspecified any exception thrown by:
-     * - thread_pool::enqueue(),
-     * - future_list::push_back().
+     * - thread_pool::parallel_for(),
+     * - memory allocation errors in standard containers.
      */
     void finalise_series(Series &s) const
     {
+        trace_scope ts("finalise", "multiplication");
         finalise_impl(s);
+        if (m_stats) {
+            publish_statistics(s);
+        }
     }
 
 protected:
+    /// Record the estimation of the size of the result in the statistics.
+    /**
+     * This method should be called by the multiplication routines after the result has been rehashed
+     * according to the estimate of its final size. It will not do anything if the collection of statistics is
+     * disabled.
+     *
+     * @param est the estimated size of the result.
+     * @param retval the result, after the rehash.
+     */
+    void record_estimate(const bucket_size_type &est, const Series &retval) const
+    {
+        if (m_stats) {
+            m_stats->estimated = true;
+            m_stats->estimated_size = static_cast<unsigned long long>(est);
+            m_stats->initial_bucket_count = static_cast<unsigned long long>(retval._container().bucket_count());
+        }
+    }
+    /// Track the rehashes of the result.
+    /**
+     * The multiplication routines should call this method right after the creation of the result \p retval, and
+     * keep the returned object alive until the result has been finalised. While the returned object is alive, the
+     * rehashes of the container of \p retval performed in the current thread (both explicit and due to the growth of
+     * the table) will be counted in multiplication_statistics::n_rehashes. Rehashes are counted only if the
+     * collection of statistics is enabled and thread-local storage is available.
+     *
+     * @param retval the result of the multiplication.
+     *
+     * @return a tracker of the rehashes of \p retval, or null if the collection of statistics is disabled.
+     *
+     * @throws std::bad_alloc in case of memory allocation errors.
+     */
+    std::unique_ptr<detail::hash_set_rehash_tracker> track_rehashes(const Series &retval) const
+    {
+        if (!m_stats) {
+            return nullptr;
+        }
+        return std::unique_ptr<detail::hash_set_rehash_tracker>(
+            new detail::hash_set_rehash_tracker(&retval._container(), &m_stats->n_rehashes));
+    }
+    /// Pointer to the counter of cancellations in the statistics.
+    /**
+     * @return a pointer to multiplication_statistics::n_cancellations in base_series_multiplier::m_stats, or null if
+     * the collection of statistics is disabled. The return value is suitable for use as last argument of
+     * sanitise_series().
+     */
+    unsigned long long *stats_n_cancellations() const
+    {
+        return m_stats ? &m_stats->n_cancellations : nullptr;
+    }
     /// Vector of const pointers to the terms in the larger series.
     mutable v_ptr m_v1;
     /// Vector of const pointers to the terms in the smaller series.
@@ -1151,11 +1393,23 @@ protected:
      * via thread_pool::use_threads().
      */
     unsigned m_n_threads;
+    /// Statistics of the multiplication.
+    /**
+     * This member is set up by the constructor if the collection of statistics is enabled (see
+     * piranha::multiplication_instrumentation), and it is null otherwise.
+     */
+    std::unique_ptr<multiplication_statistics> m_stats;
 
 private:
     // See the constructor for an explanation.
     container_type m_zero_f1;
     container_type m_zero_f2;
+    // Copies of the terms of the second operand converted to term_type, in the mixed-type constructor.
+    std::vector<typename Series::term_type> m_conv_terms;
+    // Start time of the multiplication, used only if m_stats is not null.
+    std::chrono::steady_clock::time_point m_stats_start;
+    // Hardware performance counters, used only if their collection is enabled.
+    std::unique_ptr<perf_counters> m_perf_counters;
 };
 }
 
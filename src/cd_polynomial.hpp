@@ -0,0 +1,606 @@
+/* Copyright 2009-2016 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#ifndef PIRANHA_CD_POLYNOMIAL_HPP
+#define PIRANHA_CD_POLYNOMIAL_HPP
+
+#include <iostream>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "config.hpp"
+#include "exceptions.hpp"
+#include "math.hpp"
+#include "mp_integer.hpp"
+#include "mp_rational.hpp"
+#include "polynomial.hpp"
+#include "type_traits.hpp"
+
+namespace piranha
+{
+
+/// Common-denominator polynomial.
+/**
+ * This class represents a polynomial with rational coefficients as a polynomial with integer coefficients (the
+ * numerator) divided by a single positive integer (the denominator). The monomial representation is determined by
+ * the \p Key template parameter.
+ *
+ * Arithmetic operations on piranha::polynomial with piranha::rational coefficients have to canonicalise the
+ * coefficients after each elementary operation. With the common-denominator representation, the arithmetic is
+ * instead performed on the integral numerators, which can use the fast algorithms available for piranha::integer
+ * coefficients (e.g., the Kronecker multiplication). The denominator of the result is computed once from the
+ * denominators of the operands, and the result is normalised only at the end of the operation.
+ *
+ * Instances of this class are always kept in a canonical form defined by the following properties:
+ * - the denominator is positive,
+ * - the denominator and the content of the numerator are coprime,
+ * - zero is always represented as <tt>0 / 1</tt>.
+ *
+ * Conversion to and from piranha::polynomial with piranha::rational coefficients is provided via the
+ * constructor from cd_polynomial::q_type and via cd_polynomial::to_q().
+ *
+ * ## Interoperability with other types ##
+ *
+ * Instances of piranha::cd_polynomial can interoperate with:
+ * - C++ integral types, piranha::integer and piranha::rational,
+ * - cd_polynomial::p_type and cd_polynomial::q_type.
+ *
+ * Division is supported only by C++ integral types, piranha::integer and piranha::rational.
+ *
+ * ## Type requirements ##
+ *
+ * \p Key must be usable as second template parameter for piranha::polynomial.
+ *
+ * ## Exception safety guarantee ##
+ *
+ * Unless noted otherwise, this class provides the strong exception safety guarantee.
+ *
+ * ## Move semantics ##
+ *
+ * Move operations will leave objects of this class in a state which is destructible and assignable.
+ */
+template <typename Key>
+class cd_polynomial
+{
+    // Shortcut from C++14.
+    template <typename T>
+    using decay_t = typename std::decay<T>::type;
+
+public:
+    /// The polynomial type of the numerator.
+    using p_type = polynomial<integer, Key>;
+    /// The counterpart of cd_polynomial::p_type with rational coefficients.
+    using q_type = polynomial<rational, Key>;
+
+private:
+    // Ctor from p_type, integrals and strings.
+    template <typename T>
+    using pzs_enabler = std::integral_constant<bool, std::is_same<decay_t<T>, p_type>::value
+                                                         || std::is_integral<decay_t<T>>::value
+                                                         || std::is_same<decay_t<T>, integer>::value
+                                                         || std::is_same<decay_t<T>, std::string>::value
+                                                         || std::is_same<decay_t<T>, char *>::value
+                                                         || std::is_same<decay_t<T>, const char *>::value>;
+    template <typename T, typename std::enable_if<pzs_enabler<T>::value, int>::type = 0>
+    void dispatch_unary_ctor(T &&x)
+    {
+        m_num = p_type{std::forward<T>(x)};
+        m_den = 1;
+    }
+    void dispatch_unary_ctor(const rational &q)
+    {
+        m_num = p_type{q.num()};
+        m_den = q.den();
+    }
+    void dispatch_unary_ctor(const q_type &q)
+    {
+        p_type num;
+        num._container().rehash(q._container().bucket_count());
+        num.set_symbol_set(q.get_symbol_set());
+        // The denominator is the LCM of the denominators of the coefficients.
+        integer lcm{1}, g;
+        for (const auto &t : q._container()) {
+            math::gcd3(g, lcm, t.m_cf.den());
+            math::mul3(lcm, lcm, t.m_cf.den());
+            integer::_divexact(lcm, lcm, g);
+        }
+        // NOTE: the result is already canonical: for every prime p dividing the LCM, there is a term
+        // whose numerator is not divisible by p after the multiplication by lcm / den.
+        for (const auto &t : q._container()) {
+            integer tmp;
+            integer::_divexact(tmp, lcm, t.m_cf.den());
+            math::mul3(tmp, tmp, t.m_cf.num());
+            num._container().insert(typename p_type::term_type{std::move(tmp), t.m_key});
+        }
+        m_num = std::move(num);
+        m_den = std::move(lcm);
+    }
+    template <typename T, typename U>
+    using unary_ctor_enabler = typename std::enable_if<
+        detail::true_tt<decltype(std::declval<U &>().dispatch_unary_ctor(std::declval<const decay_t<T> &>()))>::value,
+        int>::type;
+    // Enabler for the binary operators.
+    template <typename T, typename U>
+    using binary_op_enabler = typename std::enable_if<
+        (std::is_same<T, cd_polynomial>::value
+         && (std::is_same<U, cd_polynomial>::value || std::is_constructible<cd_polynomial, const U &>::value))
+            || (std::is_same<U, cd_polynomial>::value && std::is_constructible<cd_polynomial, const T &>::value),
+        int>::type;
+    template <typename T>
+    using in_place_op_enabler =
+        typename std::enable_if<std::is_constructible<cd_polynomial, const T &>::value, int>::type;
+    // Enabler for the division operator.
+    template <typename T>
+    using div_enabler = typename std::enable_if<std::is_integral<T>::value || std::is_same<T, integer>::value
+                                                    || std::is_same<T, rational>::value,
+                                                int>::type;
+    static const cd_polynomial &to_cd(const cd_polynomial &x)
+    {
+        return x;
+    }
+    template <typename T, typename std::enable_if<!std::is_same<T, cd_polynomial>::value, int>::type = 0>
+    static cd_polynomial to_cd(const T &x)
+    {
+        return cd_polynomial(x);
+    }
+    // Implementation of addition and subtraction. The numerators are scaled to the LCM of the denominators.
+    template <bool Sub>
+    static cd_polynomial add_sub_impl(const cd_polynomial &a, const cd_polynomial &b)
+    {
+        cd_polynomial retval;
+        if (a.m_den == b.m_den) {
+            retval.m_num = Sub ? a.m_num - b.m_num : a.m_num + b.m_num;
+            retval.m_den = a.m_den;
+        } else {
+            const integer g = math::gcd(a.m_den, b.m_den);
+            // NOTE: skip the multiplication of the numerators by unitary factors.
+            auto scaled = [&g](const p_type &p, const integer &d) { return d == g ? p : p * (d / g); };
+            const p_type a_num = scaled(a.m_num, b.m_den), b_num = scaled(b.m_num, a.m_den);
+            retval.m_num = Sub ? a_num - b_num : a_num + b_num;
+            retval.m_den = a.m_den / g * b.m_den;
+        }
+        retval.canonicalise();
+        return retval;
+    }
+    static cd_polynomial mul_impl(const cd_polynomial &a, const cd_polynomial &b)
+    {
+        cd_polynomial retval;
+        // NOTE: this will run the multiplication of polynomials with integer coefficients.
+        retval.m_num = a.m_num * b.m_num;
+        retval.m_den = a.m_den * b.m_den;
+        retval.canonicalise();
+        return retval;
+    }
+
+public:
+    /// Default constructor.
+    /**
+     * The numerator will be set to zero, the denominator to 1.
+     */
+    cd_polynomial() : m_num(), m_den(1)
+    {
+    }
+    /// Defaulted copy constructor.
+    cd_polynomial(const cd_polynomial &) = default;
+    /// Defaulted move constructor.
+    cd_polynomial(cd_polynomial &&) = default;
+    /// Constructor from cd_polynomial::q_type.
+    /**
+     * After construction, \p this will be mathematically equivalent to \p q: the denominator is the least common
+     * multiple of the denominators of the coefficients of \p q, and the numerator is \p q multiplied by the
+     * denominator.
+     *
+     * @param[in] q construction argument.
+     *
+     * @throws unspecified any exception thrown by arithmetic operations on piranha::integer, or by
+     * the public interface of piranha::hash_set.
+     */
+    cd_polynomial(const q_type &q)
+    {
+        dispatch_unary_ctor(q);
+    }
+    /// Generic unary constructor.
+    /**
+     * \note
+     * This constructor is enabled if the decay type of \p T is a C++ integral type, piranha::integer,
+     * piranha::rational, cd_polynomial::p_type or a string type.
+     *
+     * If \p T is piranha::rational, the numerator is constructed from the numerator of \p x, and the denominator from
+     * the denominator of \p x. Otherwise, the numerator is constructed from \p x and the denominator is set to 1.
+     *
+     * @param[in] x construction argument.
+     *
+     * @throws unspecified any exception thrown by the constructors of cd_polynomial::p_type.
+     */
+    template <typename T, typename U = cd_polynomial, unary_ctor_enabler<T, U> = 0,
+              typename std::enable_if<!std::is_same<decay_t<T>, q_type>::value, int>::type = 0>
+    explicit cd_polynomial(T &&x)
+    {
+        dispatch_unary_ctor(std::forward<T>(x));
+    }
+    /// Constructor from numerator and denominator.
+    /**
+     * The object will be constructed from \p num and \p den and then canonicalised.
+     *
+     * @param[in] num the numerator.
+     * @param[in] den the denominator.
+     *
+     * @throws piranha::zero_division_error if \p den is zero.
+     * @throws unspecified any exception thrown by canonicalise().
+     */
+    explicit cd_polynomial(p_type num, integer den) : m_num(std::move(num)), m_den(std::move(den))
+    {
+        if (unlikely(math::is_zero(m_den))) {
+            piranha_throw(zero_division_error, "null denominator in common-denominator polynomial");
+        }
+        canonicalise();
+    }
+    /// Copy-assignment operator.
+    /**
+     * @param[in] other assignment argument.
+     *
+     * @return a reference to \p this.
+     *
+     * @throws unspecified any exception thrown by the copy constructor.
+     */
+    cd_polynomial &operator=(const cd_polynomial &other)
+    {
+        if (likely(&other != this)) {
+            *this = cd_polynomial(other);
+        }
+        return *this;
+    }
+    /// Defaulted move-assignment operator.
+    cd_polynomial &operator=(cd_polynomial &&) = default;
+    /// Numerator.
+    /**
+     * @return a const reference to the numerator.
+     */
+    const p_type &num() const
+    {
+        return m_num;
+    }
+    /// Denominator.
+    /**
+     * @return a const reference to the denominator.
+     */
+    const integer &den() const
+    {
+        return m_den;
+    }
+    /// Conversion to cd_polynomial::q_type.
+    /**
+     * @return a polynomial with rational coefficients mathematically equivalent to \p this.
+     *
+     * @throws unspecified any exception thrown by the constructor of piranha::rational from numerator and
+     * denominator, or by the public interface of piranha::hash_set.
+     */
+    q_type to_q() const
+    {
+        q_type retval;
+        retval._container().rehash(m_num._container().bucket_count());
+        retval.set_symbol_set(m_num.get_symbol_set());
+        for (const auto &t : m_num._container()) {
+            retval._container().insert(typename q_type::term_type{rational{t.m_cf, m_den}, t.m_key});
+        }
+        return retval;
+    }
+    /// Canonicalisation.
+    /**
+     * This method will put \p this in canonical form. Normally, it is never necessary to call this method,
+     * unless low-level methods that do not keep \p this in canonical form have been invoked.
+     *
+     * The GCD of the denominator and of the coefficients of the numerator is computed incrementally, stopping
+     * as soon as it becomes unitary, so that the cost is typically negligible with respect to the arithmetic
+     * operation that produced the numerator.
+     *
+     * @throws unspecified any exception thrown by the arithmetic operations on piranha::integer.
+     */
+    void canonicalise()
+    {
+        piranha_assert(!math::is_zero(m_den));
+        if (math::is_zero(m_num)) {
+            m_den = 1;
+            return;
+        }
+        if (m_den.sign() < 0) {
+            math::negate(m_num);
+            math::negate(m_den);
+        }
+        if (math::is_unitary(m_den)) {
+            return;
+        }
+        integer g(m_den);
+        for (const auto &t : m_num._container()) {
+            math::gcd3(g, g, t.m_cf);
+            if (math::is_unitary(g) || g == -1) {
+                return;
+            }
+        }
+        if (g.sign() < 0) {
+            math::negate(g);
+        }
+        for (const auto &t : m_num._container()) {
+            integer::_divexact(t.m_cf, t.m_cf, g);
+        }
+        integer::_divexact(m_den, m_den, g);
+    }
+    /// Canonicality check.
+    /**
+     * @return \p true if \p this is in canonical form, \p false otherwise.
+     *
+     * @throws unspecified any exception thrown by the arithmetic operations on piranha::integer.
+     */
+    bool is_canonical() const
+    {
+        if (m_den.sign() <= 0) {
+            return false;
+        }
+        if (math::is_zero(m_num)) {
+            return math::is_unitary(m_den);
+        }
+        auto g = math::gcd(m_num.content(), m_den);
+        return g == 1 || g == -1;
+    }
+    /// Stream operator.
+    /**
+     * Will stream to \p os a human-readable representation of \p p.
+     *
+     * @param[in,out] os target stream.
+     * @param[in] p the piranha::cd_polynomial to be streamed.
+     *
+     * @return a reference to \p os.
+     *
+     * @throws unspecified any exception thrown by the stream operators of cd_polynomial::p_type and
+     * piranha::integer.
+     */
+    friend std::ostream &operator<<(std::ostream &os, const cd_polynomial &p)
+    {
+        if (math::is_unitary(p.m_den)) {
+            return os << p.m_num;
+        }
+        if (p.m_num.size() == 1u) {
+            os << p.m_num;
+        } else {
+            os << '(' << p.m_num << ')';
+        }
+        return os << '/' << p.m_den;
+    }
+    /// Identity operator.
+    /**
+     * @return a copy of \p this.
+     *
+     * @throws unspecified any exception thrown by the copy constructor.
+     */
+    cd_polynomial operator+() const
+    {
+        return *this;
+    }
+    /// Negated copy.
+    /**
+     * @return a copy of \p -this.
+     *
+     * @throws unspecified any exception thrown by the copy constructor.
+     */
+    cd_polynomial operator-() const
+    {
+        cd_polynomial retval(*this);
+        math::negate(retval.m_num);
+        return retval;
+    }
+    /// Binary addition.
+    /**
+     * \note
+     * This operator is enabled only if one of the arguments is piranha::cd_polynomial and the other argument is
+     * either piranha::cd_polynomial or a type from which piranha::cd_polynomial can be constructed.
+     *
+     * The numerators of the operands are scaled to the least common multiple of the denominators and added.
+     *
+     * @param[in] a first argument.
+     * @param[in] b second argument.
+     *
+     * @return <tt>a + b</tt>.
+     *
+     * @throws unspecified any exception thrown by the constructors of piranha::cd_polynomial, by the arithmetic
+     * operations of cd_polynomial::p_type and piranha::integer, or by canonicalise().
+     */
+    template <typename T, typename U, binary_op_enabler<T, U> = 0>
+    friend cd_polynomial operator+(const T &a, const U &b)
+    {
+        return add_sub_impl<false>(to_cd(a), to_cd(b));
+    }
+    /// In-place addition.
+    /**
+     * \note
+     * This operator is enabled only if the binary addition operator is enabled.
+     *
+     * @param[in] other argument.
+     *
+     * @return a reference to \p this.
+     *
+     * @throws unspecified any exception thrown by the binary addition operator.
+     */
+    template <typename T, in_place_op_enabler<T> = 0>
+    cd_polynomial &operator+=(const T &other)
+    {
+        return *this = *this + other;
+    }
+    /// Binary subtraction.
+    /**
+     * \note
+     * This operator is enabled only if the binary addition operator is enabled.
+     *
+     * @param[in] a first argument.
+     * @param[in] b second argument.
+     *
+     * @return <tt>a - b</tt>.
+     *
+     * @throws unspecified any exception thrown by the binary addition operator.
+     */
+    template <typename T, typename U, binary_op_enabler<T, U> = 0>
+    friend cd_polynomial operator-(const T &a, const U &b)
+    {
+        return add_sub_impl<true>(to_cd(a), to_cd(b));
+    }
+    /// In-place subtraction.
+    /**
+     * \note
+     * This operator is enabled only if the binary addition operator is enabled.
+     *
+     * @param[in] other argument.
+     *
+     * @return a reference to \p this.
+     *
+     * @throws unspecified any exception thrown by the binary subtraction operator.
+     */
+    template <typename T, in_place_op_enabler<T> = 0>
+    cd_polynomial &operator-=(const T &other)
+    {
+        return *this = *this - other;
+    }
+    /// Binary multiplication.
+    /**
+     * \note
+     * This operator is enabled only if the binary addition operator is enabled.
+     *
+     * The numerator of the result is the product of the numerators of the operands, computed with the
+     * multiplication algorithms of cd_polynomial::p_type, and the denominator is the product of the denominators.
+     * The result is then canonicalised.
+     *
+     * @param[in] a first argument.
+     * @param[in] b second argument.
+     *
+     * @return <tt>a * b</tt>.
+     *
+     * @throws unspecified any exception thrown by the constructors of piranha::cd_polynomial, by the arithmetic
+     * operations of cd_polynomial::p_type and piranha::integer, or by canonicalise().
+     */
+    template <typename T, typename U, binary_op_enabler<T, U> = 0>
+    friend cd_polynomial operator*(const T &a, const U &b)
+    {
+        return mul_impl(to_cd(a), to_cd(b));
+    }
+    /// In-place multiplication.
+    /**
+     * \note
+     * This operator is enabled only if the binary addition operator is enabled.
+     *
+     * @param[in] other argument.
+     *
+     * @return a reference to \p this.
+     *
+     * @throws unspecified any exception thrown by the binary multiplication operator.
+     */
+    template <typename T, in_place_op_enabler<T> = 0>
+    cd_polynomial &operator*=(const T &other)
+    {
+        return *this = *this * other;
+    }
+    /// Division by a scalar.
+    /**
+     * \note
+     * This operator is enabled only if \p T is a C++ integral type, piranha::integer or piranha::rational.
+     *
+     * @param[in] a the dividend.
+     * @param[in] x the divisor.
+     *
+     * @return <tt>a / x</tt>.
+     *
+     * @throws piranha::zero_division_error if \p x is zero.
+     * @throws unspecified any exception thrown by the constructor of piranha::rational or by the binary
+     * multiplication operator.
+     */
+    template <typename T, div_enabler<T> = 0>
+    friend cd_polynomial operator/(const cd_polynomial &a, const T &x)
+    {
+        return a * (rational{1} / rational{x});
+    }
+    /// In-place division by a scalar.
+    /**
+     * \note
+     * This operator is enabled only if \p T is a C++ integral type, piranha::integer or piranha::rational.
+     *
+     * @param[in] x the divisor.
+     *
+     * @return a reference to \p this.
+     *
+     * @throws unspecified any exception thrown by the division operator.
+     */
+    template <typename T, div_enabler<T> = 0>
+    cd_polynomial &operator/=(const T &x)
+    {
+        return *this = *this / x;
+    }
+    /// Equality operator.
+    /**
+     * \note
+     * This operator is enabled only if the binary addition operator is enabled.
+     *
+     * Thanks to the canonical form, two instances are equal if and only if their numerators and denominators
+     * are equal.
+     *
+     * @param[in] a first argument.
+     * @param[in] b second argument.
+     *
+     * @return \p true if \p a is equal to \p b, \p false otherwise.
+     *
+     * @throws unspecified any exception thrown by the constructors of piranha::cd_polynomial or by the
+     * comparison operator of cd_polynomial::p_type.
+     */
+    template <typename T, typename U, binary_op_enabler<T, U> = 0>
+    friend bool operator==(const T &a, const U &b)
+    {
+        const cd_polynomial &a_cd = to_cd(a), &b_cd = to_cd(b);
+        return a_cd.m_den == b_cd.m_den && a_cd.m_num == b_cd.m_num;
+    }
+    /// Inequality operator.
+    /**
+     * \note
+     * This operator is enabled only if the binary addition operator is enabled.
+     *
+     * @param[in] a first argument.
+     * @param[in] b second argument.
+     *
+     * @return the opposite of operator==().
+     *
+     * @throws unspecified any exception thrown by operator==().
+     */
+    template <typename T, typename U, binary_op_enabler<T, U> = 0>
+    friend bool operator!=(const T &a, const U &b)
+    {
+        return !(a == b);
+    }
+
+private:
+    p_type m_num;
+    integer m_den;
+};
+}
+
+#endif
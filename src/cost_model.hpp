@@ -0,0 +1,530 @@
+/* Copyright 2009-2016 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#ifndef PIRANHA_COST_MODEL_HPP
+#define PIRANHA_COST_MODEL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <locale>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "config.hpp"
+#include "detail/demangle.hpp"
+#include "exceptions.hpp"
+#include "mp_integer.hpp"
+#include "settings.hpp"
+#include "thread_pool.hpp"
+
+namespace piranha
+{
+
+/// Operations described by piranha::cost_model.
+enum class cost_operation {
+    /// Series multiplication. The units of work are the term-by-term multiplications.
+    multiplication,
+    /// Parallel traversal of the terms of a series (e.g., in the computation of the content of a polynomial).
+    /// The units of work are the terms of the series.
+    traversal
+};
+
+namespace detail
+{
+
+template <typename = void>
+struct base_cost_model {
+    static std::mutex s_mutex;
+    // Costs in nanoseconds per unit of work, indexed by operation and type name.
+    static std::unordered_map<std::string, double> s_costs;
+    static double s_thread_overhead;
+    // NOTE: this is used to skip the locking in the common case in which the model is empty.
+    static std::atomic<bool> s_empty;
+    // Incremented at every modification of the model, in order to invalidate the per-type caches below.
+    static std::atomic<unsigned long long> s_generation;
+    // Number of values in the cost_operation enum.
+    static constexpr std::size_t s_n_ops = 2u;
+    // Rough estimate of the fixed cost of a parallel operation on a common desktop machine, in nanoseconds.
+    static constexpr double s_default_thread_overhead = 20000.;
+    // Fraction of the total time of a parallel operation we are willing to spend in thread management.
+    // NOTE: this is the same figure used to choose the default value of settings::get_min_work_per_thread().
+    static constexpr double s_max_overhead_fraction = .02;
+};
+
+template <typename T>
+std::mutex base_cost_model<T>::s_mutex;
+
+template <typename T>
+std::unordered_map<std::string, double> base_cost_model<T>::s_costs;
+
+template <typename T>
+double base_cost_model<T>::s_thread_overhead = base_cost_model<T>::s_default_thread_overhead;
+
+template <typename T>
+std::atomic<bool> base_cost_model<T>::s_empty(true);
+
+template <typename T>
+std::atomic<unsigned long long> base_cost_model<T>::s_generation(1u);
+
+template <typename T>
+constexpr std::size_t base_cost_model<T>::s_n_ops;
+
+template <typename T>
+constexpr double base_cost_model<T>::s_default_thread_overhead;
+
+template <typename T>
+constexpr double base_cost_model<T>::s_max_overhead_fraction;
+
+#if defined(PIRANHA_HAVE_THREAD_LOCAL)
+
+// Per-thread cache of the minimum work per thread of the operations on the type T, indexed by operation. An entry is
+// valid if its generation matches the generation of the model. A zero value means that the cost is not available.
+// NOTE: this avoids building the key of the type, locking the mutex and looking up the map at every operation.
+template <typename T>
+struct cost_model_cache {
+    static thread_local unsigned long long s_generation[base_cost_model<>::s_n_ops];
+    static thread_local unsigned long long s_mwpt[base_cost_model<>::s_n_ops];
+};
+
+template <typename T>
+thread_local unsigned long long cost_model_cache<T>::s_generation[base_cost_model<>::s_n_ops] = {};
+
+template <typename T>
+thread_local unsigned long long cost_model_cache<T>::s_mwpt[base_cost_model<>::s_n_ops] = {};
+
+#endif
+}
+
+/// Cost model for parallel operations.
+/**
+ * \note
+ * The template parameter in this class is unused: its only purpose is to prevent the instantiation
+ * of the class' methods if they are not explicitly used. Client code should always employ the
+ * piranha::cost_model alias.
+ *
+ * This class stores the cost, in nanoseconds per unit of work, of the operations listed in piranha::cost_operation
+ * for specific types (e.g., the cost of a term-by-term multiplication in the multiplication of two
+ * polynomials with rational coefficients), together with an estimate of the fixed overhead of a parallel operation.
+ * The number of threads used by an operation is chosen so that each thread is assigned enough work to make the
+ * overhead negligible (i.e., about 2% of the total time). If the cost of an operation is not available,
+ * the number of threads is chosen according to the global settings::get_min_work_per_thread() value.
+ *
+ * The costs can be set explicitly, measured via the calibration methods, and saved to and loaded from a file,
+ * so that the calibration can be run once (e.g., by an offline benchmark) and reused at startup (see piranha::init()).
+ *
+ * All the methods in this class are thread-safe.
+ */
+template <typename = void>
+class cost_model_ : private detail::base_cost_model<>
+{
+    using base = detail::base_cost_model<>;
+    static const char *op_name(cost_operation op)
+    {
+        switch (op) {
+            case cost_operation::multiplication:
+                return "multiplication";
+            case cost_operation::traversal:
+                return "traversal";
+        }
+        piranha_assert(false);
+        return "";
+    }
+    // Cached (demangled) name of the type T.
+    template <typename T>
+    static const std::string &type_name()
+    {
+        static const std::string name = detail::demangle<T>();
+        return name;
+    }
+    static std::string make_key(const std::string &op, const std::string &tn)
+    {
+        return op + " " + tn;
+    }
+    static void check_positive(double x, const char *what)
+    {
+        if (unlikely(!std::isfinite(x) || x <= 0.)) {
+            piranha_throw(std::invalid_argument, std::string("invalid ") + what + " value: the value must be finite "
+                                                                                  "and strictly positive");
+        }
+    }
+    // Minimum work per thread given a cost per unit of work and the overhead.
+    static unsigned long long mwpt_from_cost(double cost, double overhead)
+    {
+        const double r = std::ceil(overhead / (cost * s_max_overhead_fraction));
+        if (!(r < static_cast<double>(std::numeric_limits<unsigned long long>::max()))) {
+            return std::numeric_limits<unsigned long long>::max();
+        }
+        return std::max(1ull, static_cast<unsigned long long>(r));
+    }
+    // Time in nanoseconds between start and now.
+    template <typename TimePoint>
+    static double elapsed_ns(const TimePoint &start)
+    {
+        return static_cast<double>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+    }
+    // Minimum work per thread from the model, or zero if the cost is not available.
+    template <typename T>
+    static unsigned long long model_mwpt(cost_operation op)
+    {
+        const auto key = make_key(op_name(op), type_name<T>());
+        std::lock_guard<std::mutex> lock(s_mutex);
+        const auto it = s_costs.find(key);
+        return it == s_costs.end() ? 0u : mwpt_from_cost(it->second, s_thread_overhead);
+    }
+
+public:
+    /// Set the cost of an operation.
+    /**
+     * @param op the operation.
+     * @param cost the cost of a unit of work of \p op on the type \p T, in nanoseconds.
+     *
+     * @throws std::invalid_argument if \p cost is not finite and strictly positive.
+     * @throws unspecified any exception thrown by memory allocation errors in standard containers.
+     */
+    template <typename T>
+    static void set_cost(cost_operation op, double cost)
+    {
+        check_positive(cost, "cost");
+        const auto key = make_key(op_name(op), type_name<T>());
+        std::lock_guard<std::mutex> lock(s_mutex);
+        s_costs[key] = cost;
+        s_empty.store(false);
+        ++s_generation;
+    }
+    /// Get the cost of an operation.
+    /**
+     * @param op the operation.
+     *
+     * @return the cost of a unit of work of \p op on the type \p T, in nanoseconds, or zero if the
+     * cost is not available.
+     *
+     * @throws unspecified any exception thrown by memory allocation errors in standard containers.
+     */
+    template <typename T>
+    static double get_cost(cost_operation op)
+    {
+        if (s_empty.load()) {
+            return 0.;
+        }
+        const auto key = make_key(op_name(op), type_name<T>());
+        std::lock_guard<std::mutex> lock(s_mutex);
+        const auto it = s_costs.find(key);
+        return it == s_costs.end() ? 0. : it->second;
+    }
+    /// Set the overhead of parallel operations.
+    /**
+     * @param overhead the fixed cost of a parallel operation, in nanoseconds.
+     *
+     * @throws std::invalid_argument if \p overhead is not finite and strictly positive.
+     */
+    static void set_thread_overhead(double overhead)
+    {
+        check_positive(overhead, "overhead");
+        std::lock_guard<std::mutex> lock(s_mutex);
+        s_thread_overhead = overhead;
+        ++s_generation;
+    }
+    /// Get the overhead of parallel operations.
+    /**
+     * The default value is a rough estimate valid for common desktop machines, which can be refined
+     * via calibrate_thread_overhead().
+     *
+     * @return the fixed cost of a parallel operation, in nanoseconds.
+     */
+    static double get_thread_overhead()
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        return s_thread_overhead;
+    }
+    /// Reset the model.
+    /**
+     * All the costs will be erased, and the overhead will be reset to its default value.
+     */
+    static void reset()
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        s_costs.clear();
+        s_thread_overhead = s_default_thread_overhead;
+        s_empty.store(true);
+        ++s_generation;
+    }
+    /// Minimum work per thread.
+    /**
+     * @param op the operation.
+     *
+     * @return the minimum number of units of work each thread should be assigned when performing the operation
+     * \p op on the type \p T. If the cost of the operation is not available, the output of
+     * settings::get_min_work_per_thread() will be returned.
+     *
+     * If thread-local storage is available, the result is cached per thread and per type until the next
+     * modification of the model, so that in the common case no locking is performed.
+     *
+     * @throws unspecified any exception thrown by memory allocation errors in standard containers.
+     */
+    template <typename T>
+    static unsigned long long get_min_work_per_thread(cost_operation op)
+    {
+        if (s_empty.load()) {
+            return settings::get_min_work_per_thread();
+        }
+#if defined(PIRANHA_HAVE_THREAD_LOCAL)
+        using cache = detail::cost_model_cache<T>;
+        const auto idx = static_cast<std::size_t>(op);
+        piranha_assert(idx < s_n_ops);
+        // NOTE: the generation is read before the model. If the model is modified in the meantime, the cached value
+        // will be newer than its generation, and it will just be refreshed at the next call.
+        const auto gen = s_generation.load();
+        if (cache::s_generation[idx] != gen) {
+            cache::s_mwpt[idx] = model_mwpt<T>(op);
+            cache::s_generation[idx] = gen;
+        }
+        const auto retval = cache::s_mwpt[idx];
+#else
+        const auto retval = model_mwpt<T>(op);
+#endif
+        return retval == 0u ? settings::get_min_work_per_thread() : retval;
+    }
+    /// Compute the number of threads to use.
+    /**
+     * @param op the operation.
+     * @param work_size the total number of units of work.
+     *
+     * @return the output of piranha::thread_pool::use_threads() called with \p work_size and the
+     * output of get_min_work_per_thread().
+     *
+     * @throws unspecified any exception thrown by get_min_work_per_thread() or piranha::thread_pool::use_threads().
+     */
+    template <typename T>
+    static unsigned use_threads(cost_operation op, const integer &work_size)
+    {
+        return thread_pool::use_threads(work_size, integer(get_min_work_per_thread<T>(op)));
+    }
+    /// Calibrate the overhead of parallel operations.
+    /**
+     * This method will measure the average time of a parallel loop with empty bodies, split among all the
+     * threads in the pool, and it will set the result as the overhead of parallel operations.
+     *
+     * @param n_trials the number of loops to be timed.
+     *
+     * @return the measured overhead, in nanoseconds.
+     *
+     * @throws std::invalid_argument if \p n_trials is zero.
+     * @throws unspecified any exception thrown by piranha::thread_pool::parallel_for().
+     */
+    static double calibrate_thread_overhead(unsigned n_trials = 1000u)
+    {
+        if (unlikely(n_trials == 0u)) {
+            piranha_throw(std::invalid_argument, "the number of trials must be strictly positive");
+        }
+        const auto size = thread_pool::size();
+        const auto start = std::chrono::steady_clock::now();
+        for (unsigned i = 0u; i < n_trials; ++i) {
+            thread_pool::parallel_for(0u, size, 1u, [](std::size_t, std::size_t) {});
+        }
+        // NOTE: clamp to 1 ns, in order to always have a valid value.
+        const double retval = std::max(1., elapsed_ns(start) / n_trials);
+        set_thread_overhead(retval);
+        return retval;
+    }
+    /// Calibrate the cost of an operation.
+    /**
+     * This method will time \p n_trials invocations of <tt>f()</tt>, which is assumed to perform \p work_size
+     * units of work of the operation \p op on the type \p T, and it will set the cost of the operation to the
+     * shortest time measured divided by \p work_size.
+     *
+     * <tt>f()</tt> is invoked from a thread in the pool so that, with the default nested parallelism policy
+     * (see piranha::thread_pool::set_nested_parallelism()), the parallel operations in <tt>f()</tt> run serially.
+     *
+     * @param op the operation.
+     * @param f the callable performing the operation.
+     * @param work_size the number of units of work performed by <tt>f()</tt>.
+     * @param n_trials the number of invocations of <tt>f()</tt>.
+     *
+     * @return the measured cost, in nanoseconds per unit of work.
+     *
+     * @throws std::invalid_argument if \p work_size or \p n_trials are not strictly positive.
+     * @throws unspecified any exception thrown by <tt>f()</tt>, piranha::thread_pool::enqueue() or set_cost().
+     */
+    template <typename T, typename F>
+    static double calibrate(cost_operation op, F &&f, const integer &work_size, unsigned n_trials = 3u)
+    {
+        if (unlikely(work_size.sign() <= 0)) {
+            piranha_throw(std::invalid_argument, "the work size must be strictly positive");
+        }
+        if (unlikely(n_trials == 0u)) {
+            piranha_throw(std::invalid_argument, "the number of trials must be strictly positive");
+        }
+        auto timer = [&f, n_trials]() -> double {
+            double best = std::numeric_limits<double>::max();
+            for (unsigned i = 0u; i < n_trials; ++i) {
+                const auto start = std::chrono::steady_clock::now();
+                f();
+                best = std::min(best, elapsed_ns(start));
+            }
+            return best;
+        };
+        const double cost = std::max(thread_pool::enqueue(0u, timer).get(), 1.) / static_cast<double>(work_size);
+        set_cost<T>(op, cost);
+        return cost;
+    }
+    /// Calibrate the cost of a series multiplication.
+    /**
+     * This method is a shortcut for calibrate() with piranha::cost_operation::multiplication, timing
+     * the multiplication <tt>s1 * s2</tt>.
+     *
+     * @param s1 the first operand.
+     * @param s2 the second operand.
+     * @param n_trials the number of multiplications to be timed.
+     *
+     * @return the measured cost, in nanoseconds per term-by-term multiplication.
+     *
+     * @throws unspecified any exception thrown by calibrate() or by the multiplication of the operands.
+     */
+    template <typename Series>
+    static double calibrate_multiplication(const Series &s1, const Series &s2, unsigned n_trials = 3u)
+    {
+        return calibrate<Series>(cost_operation::multiplication, [&s1, &s2]() { (void)(s1 * s2); },
+                                 integer(s1.size()) * s2.size(), n_trials);
+    }
+    /// Save the model to file.
+    /**
+     * The model is saved in a line-oriented text format. The first line contains the overhead of parallel
+     * operations, each subsequent line contains the name of an operation, its cost and the name of the type it refers
+     * to.
+     *
+     * @param filename the name of the output file.
+     *
+     * @throws std::runtime_error if the file cannot be opened or written.
+     * @throws unspecified any exception thrown by memory allocation errors in standard containers.
+     */
+    static void save(const std::string &filename)
+    {
+        std::ostringstream oss;
+        oss.imbue(std::locale::classic());
+        oss << std::setprecision(std::numeric_limits<double>::max_digits10);
+        {
+            std::lock_guard<std::mutex> lock(s_mutex);
+            oss << "thread_overhead " << s_thread_overhead << '\n';
+            // NOTE: sort the entries, so that the output is deterministic.
+            for (const auto &p : std::map<std::string, double>(s_costs.begin(), s_costs.end())) {
+                const auto pos = p.first.find(' ');
+                piranha_assert(pos != std::string::npos);
+                oss << p.first.substr(0u, pos) << ' ' << p.second << ' ' << p.first.substr(pos + 1u) << '\n';
+            }
+        }
+        std::ofstream ofile(filename, std::ios::out | std::ios::trunc);
+        if (unlikely(!ofile.good())) {
+            piranha_throw(std::runtime_error, "file '" + filename + "' could not be opened for saving");
+        }
+        ofile << oss.str();
+        if (unlikely(!ofile.good())) {
+            piranha_throw(std::runtime_error, "error while writing to file '" + filename + "'");
+        }
+    }
+    /// Load the model from file.
+    /**
+     * The current model will be replaced by the one stored in the file \p filename, which must have been
+     * produced by save(). In case of errors, the current model is not modified.
+     *
+     * @param filename the name of the input file.
+     *
+     * @throws std::runtime_error if the file cannot be opened.
+     * @throws std::invalid_argument if the content of the file is not valid.
+     * @throws unspecified any exception thrown by memory allocation errors in standard containers.
+     */
+    static void load(const std::string &filename)
+    {
+        std::ifstream ifile(filename);
+        if (unlikely(!ifile.good())) {
+            piranha_throw(std::runtime_error, "file '" + filename + "' could not be opened for loading");
+        }
+        auto error = [&filename](unsigned long n) {
+            piranha_throw(std::invalid_argument, "invalid content at line " + std::to_string(n)
+                                                     + " of the cost model file '" + filename + "'");
+        };
+        std::unordered_map<std::string, double> costs;
+        double overhead = 0.;
+        std::string line;
+        unsigned long n = 0u;
+        while (std::getline(ifile, line)) {
+            ++n;
+            std::istringstream iss(line);
+            iss.imbue(std::locale::classic());
+            std::string op;
+            double value;
+            if (!(iss >> op >> value) || !std::isfinite(value) || value <= 0.) {
+                error(n);
+            }
+            if (n == 1u) {
+                if (op != "thread_overhead" || !(iss >> std::ws).eof()) {
+                    error(n);
+                }
+                overhead = value;
+                continue;
+            }
+            if (op != op_name(cost_operation::multiplication) && op != op_name(cost_operation::traversal)) {
+                error(n);
+            }
+            std::string tn;
+            std::getline(iss >> std::ws, tn);
+            if (tn.empty()) {
+                error(n);
+            }
+            costs[make_key(op, tn)] = value;
+        }
+        if (n == 0u) {
+            error(1u);
+        }
+        std::lock_guard<std::mutex> lock(s_mutex);
+        s_costs.swap(costs);
+        s_thread_overhead = overhead;
+        s_empty.store(s_costs.empty());
+        ++s_generation;
+    }
+};
+
+/// Alias for piranha::cost_model_.
+/**
+ * This is the alias through which the methods in piranha::cost_model_ should be called.
+ */
+using cost_model = cost_model_<>;
+}
+
+#endif
@@ -0,0 +1,1664 @@
+/* Copyright 2009-2016 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#ifndef PIRANHA_DD_REAL_HPP
+#define PIRANHA_DD_REAL_HPP
+
+#include <array>
+#include <boost/lexical_cast.hpp>
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include "config.hpp"
+#include "detail/demangle.hpp"
+#include "exceptions.hpp"
+#include "is_cf.hpp"
+#include "math.hpp"
+#include "mp_integer.hpp"
+#include "mp_rational.hpp"
+#include "pow.hpp"
+#include "real.hpp"
+#include "s11n.hpp"
+#include "safe_cast.hpp"
+#include "type_traits.hpp"
+
+namespace piranha
+{
+
+namespace detail
+{
+
+// Types interoperable with dd_real.
+template <typename T>
+using is_dd_real_interoperable_type = is_real_interoperable_type<T>;
+
+// Error-free transformations. See:
+// Hida, Li, Bailey - Library for double-double and quad-double arithmetic (2008).
+// Compute a + b as s + e exactly.
+inline void dd_two_sum(double a, double b, double &s, double &e)
+{
+    s = a + b;
+    const double bb = s - a;
+    e = (a - (s - bb)) + (b - bb);
+}
+
+// Same as above, but requires |a| >= |b| (or a == 0).
+inline void dd_quick_two_sum(double a, double b, double &s, double &e)
+{
+    s = a + b;
+    e = b - (s - a);
+}
+
+// Compute a * b as p + e exactly.
+inline void dd_two_prod(double a, double b, double &p, double &e)
+{
+    p = a * b;
+#if defined(FP_FAST_FMA)
+    e = std::fma(a, b, -p);
+#else
+    // Dekker's product, via splitting of the operands in 26-bit halves.
+    const double split = 134217729.; // 2**27 + 1.
+    double t = split * a;
+    const double a_hi = t - (t - a), a_lo = a - a_hi;
+    t = split * b;
+    const double b_hi = t - (t - b), b_lo = b - b_hi;
+    e = ((a_hi * b_hi - p) + a_hi * b_lo + a_lo * b_hi) + a_lo * b_lo;
+#endif
+}
+
+// Magnitude and sign of an integral value.
+template <typename T, enable_if_t<std::is_signed<T>::value, int> = 0>
+inline unsigned long long dd_abs_integral(const T &n, bool &neg)
+{
+    neg = n < T(0);
+    const auto u = static_cast<unsigned long long>(n);
+    return neg ? 0ull - u : u;
+}
+
+template <typename T, enable_if_t<!std::is_signed<T>::value, int> = 0>
+inline unsigned long long dd_abs_integral(const T &n, bool &neg)
+{
+    neg = false;
+    return static_cast<unsigned long long>(n);
+}
+}
+
+/// Double-double floating-point class.
+/**
+ * This class represents a floating-point number as the unevaluated sum of two \p double values, the high and the low
+ * component. The two components are kept normalised, that is, the high component is the sum of the two components
+ * rounded to the nearest \p double. The resulting format has a significand of (at least) 106 bits, corresponding to
+ * about 32 decimal digits, and the same exponent range as \p double.
+ *
+ * Arithmetic is implemented with error-free transformations on the two components, following the algorithms of the
+ * QD library by Hida, Li and Bailey. Operations are not correctly rounded, but the relative error of the basic
+ * arithmetic operations is a small multiple of \f$ 2^{-106} \f$. Since no dynamic memory allocation is involved,
+ * this class is typically an order of magnitude faster than piranha::real with a comparable precision, at the price of
+ * a fixed precision and of the limited exponent range of \p double.
+ *
+ * Non-finite values are propagated as in \p double arithmetic: whenever an operation produces a non-finite high
+ * component, the low component is set to zero.
+ *
+ * ## Interoperability with other types ##
+ *
+ * This class interoperates with the same types as piranha::real. Values of interoperable types are converted to
+ * piranha::dd_real before being used in arithmetic operations and comparisons. The conversion is exact for all
+ * floating-point types up to \p double and for integral types up to 64 bits, and it is accurate to about 106 bits
+ * for the other types.
+ *
+ * ## Exception safety guarantee ##
+ *
+ * Unless noted otherwise, this class provides the strong exception safety guarantee for all operations.
+ *
+ * ## Move semantics ##
+ *
+ * Move semantics is equivalent to copy semantics.
+ *
+ * @see http://crd-legacy.lbl.gov/~dhbailey/mpdist/
+ */
+class dd_real
+{
+    // Shortcut for interop type detector.
+    template <typename T>
+    using is_interoperable_type = detail::is_dd_real_interoperable_type<T>;
+    // Enabler for generic ctor.
+    template <typename T>
+    using generic_ctor_enabler = enable_if_t<is_interoperable_type<T>::value, int>;
+    // Enabler for conversion operator.
+    template <typename T>
+    using cast_enabler = generic_ctor_enabler<T>;
+    // Enabler for in-place arithmetic operations with interop on the left.
+    template <typename T>
+    using generic_in_place_enabler = enable_if_t<is_interoperable_type<T>::value && !std::is_const<T>::value, int>;
+    // Enabler for the in-place operations with interoperable types other than double, which
+    // are converted to dd_real.
+    template <typename T>
+    using in_place_conv_enabler
+        = enable_if_t<is_interoperable_type<T>::value && !std::is_same<T, double>::value, int>;
+    // Enabler for exponentiation.
+    template <typename T>
+    using pow_enabler = enable_if_t<
+        disjunction<std::is_integral<T>, detail::is_mp_integer<T>>::value && !std::is_same<T, bool>::value, int>;
+    // Build from components, without normalisation.
+    struct raw_tag {
+    };
+    dd_real(raw_tag, double hi, double lo) : m_hi(hi), m_lo(lo)
+    {
+    }
+    // Build from a value whose high component is not finite.
+    static dd_real non_finite(double hi)
+    {
+        return dd_real{raw_tag{}, hi, 0.};
+    }
+    // Construction.
+    template <typename T, enable_if_t<std::is_floating_point<T>::value, int> = 0>
+    void construct_from_generic(const T &x)
+    {
+        m_hi = static_cast<double>(x);
+        m_lo = std::isfinite(m_hi) ? static_cast<double>(x - static_cast<T>(m_hi)) : 0.;
+    }
+    template <typename T, enable_if_t<std::is_integral<T>::value, int> = 0>
+    void construct_from_generic(const T &n)
+    {
+        bool neg;
+        const auto u = detail::dd_abs_integral(n, neg);
+        // Accumulate the magnitude in 32-bit chunks, starting from the most significant one. The scaling
+        // by 2**32 is exact, and so are the additions as long as the value fits in 106 bits.
+        constexpr unsigned nchunks
+            = static_cast<unsigned>((std::numeric_limits<unsigned long long>::digits + 31) / 32);
+        m_hi = 0.;
+        m_lo = 0.;
+        for (unsigned i = nchunks; i > 0u; --i) {
+            m_hi *= 4294967296.;
+            m_lo *= 4294967296.;
+            *this = add_impl(*this, static_cast<double>((u >> (32u * (i - 1u))) & 0xFFFFFFFFull));
+        }
+        if (neg) {
+            negate();
+        }
+    }
+    template <typename T, enable_if_t<detail::is_mp_integer<T>::value, int> = 0>
+    void construct_from_generic(const T &n)
+    {
+        // NOTE: the conversion to double truncates, thus the remainder is smaller than the ulp of the high
+        // component and it has the same sign as n.
+        const double hi = static_cast<double>(n);
+        if (!std::isfinite(hi)) {
+            *this = non_finite(hi);
+            return;
+        }
+        detail::dd_quick_two_sum(hi, static_cast<double>(n - T{hi}), m_hi, m_lo);
+    }
+    template <typename T, enable_if_t<detail::is_mp_rational<T>::value, int> = 0>
+    void construct_from_generic(const T &q)
+    {
+        *this = div_impl(dd_real{q.num()}, dd_real{q.den()});
+    }
+    void construct_from_string(const char *str)
+    {
+        // Parse with enough precision to determine both components, then extract them.
+        const ::mpfr_prec_t prec = 256;
+        const real r{str, prec};
+        const double hi = static_cast<double>(r);
+        if (!std::isfinite(hi)) {
+            *this = non_finite(hi);
+            return;
+        }
+        detail::dd_quick_two_sum(hi, static_cast<double>(r - real{hi, prec}), m_hi, m_lo);
+    }
+    // Conversion.
+    template <typename T>
+    enable_if_t<std::is_same<T, bool>::value, T> convert_to_impl() const
+    {
+        return m_hi != 0.;
+    }
+    template <typename T>
+    enable_if_t<std::is_floating_point<T>::value, T> convert_to_impl() const
+    {
+        return static_cast<T>(m_hi) + static_cast<T>(m_lo);
+    }
+    template <typename T>
+    enable_if_t<detail::is_mp_integer<T>::value, T> convert_to_impl() const
+    {
+        if (unlikely(!std::isfinite(m_hi))) {
+            piranha_throw(std::overflow_error, "cannot convert a non-finite dd_real to an integral value");
+        }
+        // Truncate, then sum the two integral components.
+        const dd_real t = truncate();
+        return T{t.m_hi} + T{t.m_lo};
+    }
+    template <typename T>
+    enable_if_t<std::is_integral<T>::value && !std::is_same<T, bool>::value, T> convert_to_impl() const
+    {
+        return static_cast<T>(convert_to_impl<integer>());
+    }
+    template <typename T>
+    enable_if_t<detail::is_mp_rational<T>::value, T> convert_to_impl() const
+    {
+        if (unlikely(!std::isfinite(m_hi))) {
+            piranha_throw(std::overflow_error, "cannot convert a non-finite dd_real to a rational");
+        }
+        // Both components are exactly representable as rationals.
+        return T{m_hi} + T{m_lo};
+    }
+    // Arithmetic kernels.
+    static dd_real add_impl(const dd_real &a, const dd_real &b)
+    {
+        double s1, s2, t1, t2;
+        detail::dd_two_sum(a.m_hi, b.m_hi, s1, s2);
+        if (unlikely(!std::isfinite(s1))) {
+            return non_finite(s1);
+        }
+        detail::dd_two_sum(a.m_lo, b.m_lo, t1, t2);
+        s2 += t1;
+        detail::dd_quick_two_sum(s1, s2, s1, s2);
+        s2 += t2;
+        detail::dd_quick_two_sum(s1, s2, s1, s2);
+        return dd_real{raw_tag{}, s1, s2};
+    }
+    static dd_real add_impl(const dd_real &a, double b)
+    {
+        double s1, s2;
+        detail::dd_two_sum(a.m_hi, b, s1, s2);
+        if (unlikely(!std::isfinite(s1))) {
+            return non_finite(s1);
+        }
+        s2 += a.m_lo;
+        detail::dd_quick_two_sum(s1, s2, s1, s2);
+        return dd_real{raw_tag{}, s1, s2};
+    }
+    static dd_real mul_impl(const dd_real &a, const dd_real &b)
+    {
+        double p1, p2;
+        detail::dd_two_prod(a.m_hi, b.m_hi, p1, p2);
+        if (unlikely(!std::isfinite(p1))) {
+            return non_finite(p1);
+        }
+        p2 += a.m_hi * b.m_lo + a.m_lo * b.m_hi;
+        detail::dd_quick_two_sum(p1, p2, p1, p2);
+        return dd_real{raw_tag{}, p1, p2};
+    }
+    static dd_real mul_impl(const dd_real &a, double b)
+    {
+        double p1, p2;
+        detail::dd_two_prod(a.m_hi, b, p1, p2);
+        if (unlikely(!std::isfinite(p1))) {
+            return non_finite(p1);
+        }
+        p2 += a.m_lo * b;
+        detail::dd_quick_two_sum(p1, p2, p1, p2);
+        return dd_real{raw_tag{}, p1, p2};
+    }
+    static dd_real div_impl(const dd_real &a, const dd_real &b)
+    {
+        // Long division: three successive quotient digits, each one correcting the remainder of the previous ones.
+        double q1 = a.m_hi / b.m_hi;
+        if (unlikely(!std::isfinite(q1))) {
+            return non_finite(q1);
+        }
+        dd_real r = add_impl(a, -mul_impl(b, q1));
+        double q2 = r.m_hi / b.m_hi;
+        r = add_impl(r, -mul_impl(b, q2));
+        const double q3 = r.m_hi / b.m_hi;
+        detail::dd_quick_two_sum(q1, q2, q1, q2);
+        return add_impl(dd_real{raw_tag{}, q1, q2}, q3);
+    }
+    // In-place operations.
+    dd_real &in_place_add(const dd_real &x)
+    {
+        return *this = add_impl(*this, x);
+    }
+    dd_real &in_place_add(const double &x)
+    {
+        return *this = add_impl(*this, x);
+    }
+    template <typename T, in_place_conv_enabler<T> = 0>
+    dd_real &in_place_add(const T &x)
+    {
+        return in_place_add(dd_real{x});
+    }
+    dd_real &in_place_sub(const dd_real &x)
+    {
+        return *this = add_impl(*this, -x);
+    }
+    dd_real &in_place_sub(const double &x)
+    {
+        return *this = add_impl(*this, -x);
+    }
+    template <typename T, in_place_conv_enabler<T> = 0>
+    dd_real &in_place_sub(const T &x)
+    {
+        return in_place_sub(dd_real{x});
+    }
+    dd_real &in_place_mul(const dd_real &x)
+    {
+        return *this = mul_impl(*this, x);
+    }
+    dd_real &in_place_mul(const double &x)
+    {
+        return *this = mul_impl(*this, x);
+    }
+    template <typename T, in_place_conv_enabler<T> = 0>
+    dd_real &in_place_mul(const T &x)
+    {
+        return in_place_mul(dd_real{x});
+    }
+    dd_real &in_place_div(const dd_real &x)
+    {
+        return *this = div_impl(*this, x);
+    }
+    template <typename T, generic_ctor_enabler<T> = 0>
+    dd_real &in_place_div(const T &x)
+    {
+        return in_place_div(dd_real{x});
+    }
+    // Binary operations.
+    static dd_real binary_add(const dd_real &a, const dd_real &b)
+    {
+        return add_impl(a, b);
+    }
+    template <typename T, generic_ctor_enabler<T> = 0>
+    static dd_real binary_add(const dd_real &a, const T &b)
+    {
+        dd_real retval{a};
+        retval.in_place_add(b);
+        return retval;
+    }
+    template <typename T, generic_ctor_enabler<T> = 0>
+    static dd_real binary_add(const T &a, const dd_real &b)
+    {
+        return binary_add(b, a);
+    }
+    static dd_real binary_sub(const dd_real &a, const dd_real &b)
+    {
+        return add_impl(a, -b);
+    }
+    template <typename T, generic_ctor_enabler<T> = 0>
+    static dd_real binary_sub(const dd_real &a, const T &b)
+    {
+        dd_real retval{a};
+        retval.in_place_sub(b);
+        return retval;
+    }
+    template <typename T, generic_ctor_enabler<T> = 0>
+    static dd_real binary_sub(const T &a, const dd_real &b)
+    {
+        dd_real retval{b};
+        retval.in_place_sub(a);
+        retval.negate();
+        return retval;
+    }
+    static dd_real binary_mul(const dd_real &a, const dd_real &b)
+    {
+        return mul_impl(a, b);
+    }
+    template <typename T, generic_ctor_enabler<T> = 0>
+    static dd_real binary_mul(const dd_real &a, const T &b)
+    {
+        dd_real retval{a};
+        retval.in_place_mul(b);
+        return retval;
+    }
+    template <typename T, generic_ctor_enabler<T> = 0>
+    static dd_real binary_mul(const T &a, const dd_real &b)
+    {
+        return binary_mul(b, a);
+    }
+    static dd_real binary_div(const dd_real &a, const dd_real &b)
+    {
+        return div_impl(a, b);
+    }
+    template <typename T, generic_ctor_enabler<T> = 0>
+    static dd_real binary_div(const dd_real &a, const T &b)
+    {
+        return div_impl(a, dd_real{b});
+    }
+    template <typename T, generic_ctor_enabler<T> = 0>
+    static dd_real binary_div(const T &a, const dd_real &b)
+    {
+        return div_impl(dd_real{a}, b);
+    }
+    // Comparisons.
+    static bool binary_equality(const dd_real &a, const dd_real &b)
+    {
+        return a.m_hi == b.m_hi && a.m_lo == b.m_lo;
+    }
+    template <typename T, generic_ctor_enabler<T> = 0>
+    static bool binary_equality(const dd_real &a, const T &b)
+    {
+        return binary_equality(a, dd_real{b});
+    }
+    template <typename T, generic_ctor_enabler<T> = 0>
+    static bool binary_equality(const T &a, const dd_real &b)
+    {
+        return binary_equality(b, a);
+    }
+    static bool binary_less_than(const dd_real &a, const dd_real &b)
+    {
+        return a.m_hi < b.m_hi || (a.m_hi == b.m_hi && a.m_lo < b.m_lo);
+    }
+    template <typename T, generic_ctor_enabler<T> = 0>
+    static bool binary_less_than(const dd_real &a, const T &b)
+    {
+        return binary_less_than(a, dd_real{b});
+    }
+    template <typename T, generic_ctor_enabler<T> = 0>
+    static bool binary_less_than(const T &a, const dd_real &b)
+    {
+        return binary_less_than(dd_real{a}, b);
+    }
+    static bool binary_leq(const dd_real &a, const dd_real &b)
+    {
+        return a.m_hi < b.m_hi || (a.m_hi == b.m_hi && a.m_lo <= b.m_lo);
+    }
+    template <typename T, generic_ctor_enabler<T> = 0>
+    static bool binary_leq(const dd_real &a, const T &b)
+    {
+        return binary_leq(a, dd_real{b});
+    }
+    template <typename T, generic_ctor_enabler<T> = 0>
+    static bool binary_leq(const T &a, const dd_real &b)
+    {
+        return binary_leq(dd_real{a}, b);
+    }
+    // Integral exponentiation by repeated squaring.
+    template <typename T>
+    dd_real pow_impl(T n) const
+    {
+        dd_real retval{1}, base{*this};
+        while (true) {
+            if (n % 2u != 0u) {
+                retval.in_place_mul(base);
+            }
+            n /= 2u;
+            if (n == 0u) {
+                break;
+            }
+            base.in_place_mul(base);
+        }
+        return retval;
+    }
+    // Sine and cosine of a value reduced to [-pi/4, pi/4], via Taylor series.
+    static void sin_cos_taylor(const dd_real &x, dd_real &s, dd_real &c)
+    {
+        const double eps = std::ldexp(1., -106);
+        const dd_real x2 = -mul_impl(x, x);
+        // Sine.
+        s = x;
+        dd_real term{x};
+        for (unsigned i = 2u; std::abs(term.m_hi) > eps * std::abs(s.m_hi); i += 2u) {
+            term = mul_impl(term, x2);
+            term.in_place_div(static_cast<double>(i) * static_cast<double>(i + 1u));
+            s.in_place_add(term);
+        }
+        // Cosine.
+        c = dd_real{1};
+        term = c;
+        for (unsigned i = 1u; std::abs(term.m_hi) > eps; i += 2u) {
+            term = mul_impl(term, x2);
+            term.in_place_div(static_cast<double>(i) * static_cast<double>(i + 1u));
+            c.in_place_add(term);
+        }
+    }
+    // Reduce x modulo pi/2, returning the quadrant in q.
+    static dd_real reduce_pio2(const dd_real &x, int &q)
+    {
+        // pi/2 in double-double format.
+        const dd_real pio2{raw_tag{}, 1.570796326794896558e+00, 6.123233995736766036e-17};
+        const double k = std::nearbyint(x.m_hi / pio2.m_hi);
+        // NOTE: the quadrant only depends on k modulo 4.
+        q = static_cast<int>(std::fmod(k, 4.));
+        if (q < 0) {
+            q += 4;
+        }
+        return add_impl(x, -mul_impl(pio2, k));
+    }
+    // Serialization support.
+    friend class boost::serialization::access;
+    template <class Archive>
+    void save(Archive &ar, unsigned) const
+    {
+        piranha::boost_save(ar, m_hi);
+        piranha::boost_save(ar, m_lo);
+    }
+    template <class Archive>
+    void load(Archive &ar, unsigned)
+    {
+        double hi, lo;
+        piranha::boost_load(ar, hi);
+        piranha::boost_load(ar, lo);
+        *this = dd_real{hi, lo};
+    }
+    BOOST_SERIALIZATION_SPLIT_MEMBER()
+public:
+    /// Default constructor.
+    /**
+     * Will initialise the number to zero.
+     */
+    dd_real() : m_hi(0.), m_lo(0.)
+    {
+    }
+    /// Defaulted copy constructor.
+    dd_real(const dd_real &) = default;
+    /// Defaulted move constructor.
+    dd_real(dd_real &&) = default;
+    /// Constructor from components.
+    /**
+     * The value of \p this will be set to the sum of \p hi and \p lo, normalised. If the normalised
+     * high component is not finite, the low component will be set to zero.
+     *
+     * @param[in] hi high component.
+     * @param[in] lo low component.
+     */
+    explicit dd_real(const double &hi, const double &lo)
+    {
+        detail::dd_two_sum(hi, lo, m_hi, m_lo);
+        if (!std::isfinite(m_hi)) {
+            m_lo = 0.;
+        }
+    }
+    /// Constructor from C string.
+    /**
+     * The expected string format is the same as in the constructor of piranha::real from string. The
+     * decimal value represented by \p str is rounded to the double-double format.
+     *
+     * @param[in] str string representation of the number.
+     *
+     * @throws unspecified any exception thrown by the constructor of piranha::real from string.
+     */
+    explicit dd_real(const char *str)
+    {
+        construct_from_string(str);
+    }
+    /// Constructor from C++ string.
+    /**
+     * Equivalent to the constructor from C string.
+     *
+     * @param[in] str string representation of the number.
+     *
+     * @throws unspecified any exception thrown by the constructor from C string.
+     */
+    explicit dd_real(const std::string &str)
+    {
+        construct_from_string(str.c_str());
+    }
+    /// Generic constructor.
+    /**
+     * \note
+     * This constructor is enabled only if \p T is an interoperable type.
+     *
+     * @param[in] x object used to construct \p this.
+     *
+     * @throws unspecified any exception thrown by the arithmetic of piranha::mp_integer.
+     */
+    template <typename T, generic_ctor_enabler<T> = 0>
+    explicit dd_real(const T &x)
+    {
+        construct_from_generic(x);
+    }
+    /// Destructor.
+    ~dd_real();
+    /// Defaulted copy assignment operator.
+    /**
+     * @return reference to \p this.
+     */
+    dd_real &operator=(const dd_real &) = default;
+    /// Defaulted move assignment operator.
+    /**
+     * @return reference to \p this.
+     */
+    dd_real &operator=(dd_real &&) = default;
+    /// Generic assignment operator.
+    /**
+     * \note
+     * This assignment operator is enabled only if \p T is an interoperable type.
+     *
+     * @param[in] x object that will be assigned to \p this.
+     *
+     * @return reference to \p this.
+     *
+     * @throws unspecified any exception thrown by the generic constructor.
+     */
+    template <typename T, generic_ctor_enabler<T> = 0>
+    dd_real &operator=(const T &x)
+    {
+        return *this = dd_real{x};
+    }
+    /// Conversion operator.
+    /**
+     * \note
+     * This operator is enabled only if \p T is an interoperable type.
+     *
+     * Conversion to \p bool returns \p true if \p this is not zero. Conversion to floating-point types
+     * rounds the sum of the two components to \p T. Conversion to integral types truncates (i.e., rounds towards zero).
+     * Conversion of finite values to piranha::mp_rational is exact.
+     *
+     * @return result of the conversion to target type T.
+     *
+     * @throws std::overflow_error if \p this is not finite and \p T is an integral or rational type, or if the
+     * truncated value does not fit in \p T.
+     */
+    template <typename T, cast_enabler<T> = 0>
+    explicit operator T() const
+    {
+        return convert_to_impl<T>();
+    }
+    /// High component.
+    /**
+     * @return the high component of \p this.
+     */
+    double hi() const
+    {
+        return m_hi;
+    }
+    /// Low component.
+    /**
+     * @return the low component of \p this.
+     */
+    double lo() const
+    {
+        return m_lo;
+    }
+    /// Test for zero.
+    /**
+     * @return \p true if \p this is zero, \p false otherwise.
+     */
+    bool is_zero() const
+    {
+        return m_hi == 0.;
+    }
+    /// Test for NaN.
+    /**
+     * @return \p true if \p this is NaN, \p false otherwise.
+     */
+    bool is_nan() const
+    {
+        return std::isnan(m_hi);
+    }
+    /// Test for infinity.
+    /**
+     * @return \p true if \p this is an infinity, \p false otherwise.
+     */
+    bool is_inf() const
+    {
+        return std::isinf(m_hi);
+    }
+    /// Sign.
+    /**
+     * @return 1 if <tt>this > 0</tt>, 0 if <tt>this == 0</tt> or NaN, and -1 if <tt>this < 0</tt>.
+     */
+    int sign() const
+    {
+        return (m_hi > 0.) - (m_hi < 0.);
+    }
+    /// Negate in-place.
+    void negate()
+    {
+        m_hi = -m_hi;
+        m_lo = -m_lo;
+    }
+    /// Absolute value.
+    /**
+     * @return absolute value of \p this.
+     */
+    dd_real abs() const
+    {
+        return m_hi < 0. ? -*this : *this;
+    }
+    /// Truncation.
+    /**
+     * @return \p this rounded towards zero.
+     */
+    dd_real truncate() const
+    {
+        const double t_hi = std::trunc(m_hi);
+        if (t_hi != m_hi) {
+            return dd_real{raw_tag{}, t_hi, 0.};
+        }
+        // The high component is integral: the low component must be rounded in the direction of zero
+        // with respect to the total value, whose sign is that of the high component.
+        return dd_real{t_hi, m_hi > 0. ? std::floor(m_lo) : std::ceil(m_lo)};
+    }
+    /// Exponentiation.
+    /**
+     * \note
+     * This method is enabled only if \p T is a C++ integral type (except \p bool) or piranha::mp_integer.
+     *
+     * The power is computed via repeated squaring. Negative exponents are handled by computing the reciprocal
+     * of the power with the absolute value of the exponent. Zero raised to zero is one.
+     *
+     * @param[in] n exponent.
+     *
+     * @return \p this raised to the power of \p n.
+     *
+     * @throws unspecified any exception thrown by the arithmetic of piranha::mp_integer.
+     */
+    template <typename T, pow_enabler<T> = 0>
+    dd_real pow(const T &n) const
+    {
+        return pow_dispatch(n);
+    }
+    /// Sine.
+    /**
+     * The argument is reduced modulo \f$ \pi/2 \f$ using a double-double value of \f$ \pi \f$, and the sine is then
+     * computed via Taylor series. The accuracy thus degrades for arguments of large magnitude.
+     *
+     * @return sine of \p this.
+     */
+    dd_real sin() const
+    {
+        if (unlikely(!std::isfinite(m_hi))) {
+            return non_finite(std::numeric_limits<double>::quiet_NaN());
+        }
+        int q;
+        dd_real s, c;
+        sin_cos_taylor(reduce_pio2(*this, q), s, c);
+        switch (q) {
+            case 0:
+                return s;
+            case 1:
+                return c;
+            case 2:
+                return -s;
+        }
+        return -c;
+    }
+    /// Cosine.
+    /**
+     * The same considerations about accuracy of dd_real::sin() apply.
+     *
+     * @return cosine of \p this.
+     */
+    dd_real cos() const
+    {
+        if (unlikely(!std::isfinite(m_hi))) {
+            return non_finite(std::numeric_limits<double>::quiet_NaN());
+        }
+        int q;
+        dd_real s, c;
+        sin_cos_taylor(reduce_pio2(*this, q), s, c);
+        switch (q) {
+            case 0:
+                return c;
+            case 1:
+                return -s;
+            case 2:
+                return -c;
+        }
+        return s;
+    }
+    /// Pi constant.
+    /**
+     * @return \f$ \pi \f$ rounded to the double-double format.
+     */
+    static dd_real pi()
+    {
+        return dd_real{raw_tag{}, 3.141592653589793116e+00, 1.224646799147353207e-16};
+    }
+    /// Combined multiply-add.
+    /**
+     * Sets \p this to <tt>this + (a * b)</tt>.
+     *
+     * @param[in] a first argument.
+     * @param[in] b second argument.
+     *
+     * @return reference to \p this.
+     */
+    dd_real &multiply_accumulate(const dd_real &a, const dd_real &b)
+    {
+        return *this = add_impl(*this, mul_impl(a, b));
+    }
+    /// In-place addition.
+    /**
+     * \note
+     * This operator is enabled only if \p T is piranha::dd_real or an interoperable type.
+     *
+     * @param[in] x argument for the addition.
+     *
+     * @return reference to \p this.
+     *
+     * @throws unspecified any exception thrown by the generic constructor.
+     */
+    template <typename T>
+    auto operator+=(const T &x) -> decltype(this->in_place_add(x))
+    {
+        return in_place_add(x);
+    }
+    /// Generic in-place addition with piranha::dd_real.
+    /**
+     * \note
+     * This operator is enabled only if \p T is a non-const interoperable type.
+     *
+     * The result of <tt>r + x</tt> is cast back to \p T and assigned to \p x.
+     *
+     * @param[in,out] x first argument.
+     * @param[in] r second argument.
+     *
+     * @return reference to \p x.
+     *
+     * @throws unspecified any exception thrown by the conversion operator.
+     */
+    template <typename T, generic_in_place_enabler<T> = 0>
+    friend T &operator+=(T &x, const dd_real &r)
+    {
+        return x = static_cast<T>(r + x);
+    }
+    /// Generic binary addition involving piranha::dd_real.
+    /**
+     * \note
+     * This template operator is enabled only if either:
+     * - \p T is piranha::dd_real and \p U is an interoperable type,
+     * - \p U is piranha::dd_real and \p T is an interoperable type,
+     * - both \p T and \p U are piranha::dd_real.
+     *
+     * The return type is always piranha::dd_real.
+     *
+     * @param[in] x first argument
+     * @param[in] y second argument.
+     *
+     * @return <tt>x + y</tt>.
+     *
+     * @throws unspecified any exception thrown by the generic constructor.
+     */
+    template <typename T, typename U>
+    friend auto operator+(const T &x, const U &y) -> decltype(dd_real::binary_add(x, y))
+    {
+        return binary_add(x, y);
+    }
+    /// Identity operator.
+    /**
+     * @return copy of \p this.
+     */
+    dd_real operator+() const
+    {
+        return *this;
+    }
+    /// In-place subtraction.
+    /**
+     * \note
+     * This operator is enabled only if \p T is piranha::dd_real or an interoperable type.
+     *
+     * @param[in] x argument for the subtraction.
+     *
+     * @return reference to \p this.
+     *
+     * @throws unspecified any exception thrown by the generic constructor.
+     */
+    template <typename T>
+    auto operator-=(const T &x) -> decltype(this->in_place_sub(x))
+    {
+        return in_place_sub(x);
+    }
+    /// Generic in-place subtraction with piranha::dd_real.
+    /**
+     * \note
+     * This operator is enabled only if \p T is a non-const interoperable type.
+     *
+     * The result of <tt>x - r</tt> is cast back to \p T and assigned to \p x.
+     *
+     * @param[in,out] x first argument.
+     * @param[in] r second argument.
+     *
+     * @return reference to \p x.
+     *
+     * @throws unspecified any exception thrown by the conversion operator.
+     */
+    template <typename T, generic_in_place_enabler<T> = 0>
+    friend T &operator-=(T &x, const dd_real &r)
+    {
+        return x = static_cast<T>(x - r);
+    }
+    /// Generic binary subtraction involving piranha::dd_real.
+    /**
+     * \note
+     * This template operator is enabled only if either:
+     * - \p T is piranha::dd_real and \p U is an interoperable type,
+     * - \p U is piranha::dd_real and \p T is an interoperable type,
+     * - both \p T and \p U are piranha::dd_real.
+     *
+     * The return type is always piranha::dd_real.
+     *
+     * @param[in] x first argument
+     * @param[in] y second argument.
+     *
+     * @return <tt>x - y</tt>.
+     *
+     * @throws unspecified any exception thrown by the generic constructor.
+     */
+    template <typename T, typename U>
+    friend auto operator-(const T &x, const U &y) -> decltype(dd_real::binary_sub(x, y))
+    {
+        return binary_sub(x, y);
+    }
+    /// Negated copy.
+    /**
+     * @return copy of \p -this.
+     */
+    dd_real operator-() const
+    {
+        return dd_real{raw_tag{}, -m_hi, -m_lo};
+    }
+    /// In-place multiplication.
+    /**
+     * \note
+     * This operator is enabled only if \p T is piranha::dd_real or an interoperable type.
+     *
+     * @param[in] x argument for the multiplication.
+     *
+     * @return reference to \p this.
+     *
+     * @throws unspecified any exception thrown by the generic constructor.
+     */
+    template <typename T>
+    auto operator*=(const T &x) -> decltype(this->in_place_mul(x))
+    {
+        return in_place_mul(x);
+    }
+    /// Generic in-place multiplication with piranha::dd_real.
+    /**
+     * \note
+     * This operator is enabled only if \p T is a non-const interoperable type.
+     *
+     * The result of <tt>r * x</tt> is cast back to \p T and assigned to \p x.
+     *
+     * @param[in,out] x first argument.
+     * @param[in] r second argument.
+     *
+     * @return reference to \p x.
+     *
+     * @throws unspecified any exception thrown by the conversion operator.
+     */
+    template <typename T, generic_in_place_enabler<T> = 0>
+    friend T &operator*=(T &x, const dd_real &r)
+    {
+        return x = static_cast<T>(r * x);
+    }
+    /// Generic binary multiplication involving piranha::dd_real.
+    /**
+     * \note
+     * This template operator is enabled only if either:
+     * - \p T is piranha::dd_real and \p U is an interoperable type,
+     * - \p U is piranha::dd_real and \p T is an interoperable type,
+     * - both \p T and \p U are piranha::dd_real.
+     *
+     * The return type is always piranha::dd_real.
+     *
+     * @param[in] x first argument
+     * @param[in] y second argument.
+     *
+     * @return <tt>x * y</tt>.
+     *
+     * @throws unspecified any exception thrown by the generic constructor.
+     */
+    template <typename T, typename U>
+    friend auto operator*(const T &x, const U &y) -> decltype(dd_real::binary_mul(x, y))
+    {
+        return binary_mul(x, y);
+    }
+    /// In-place division.
+    /**
+     * \note
+     * This operator is enabled only if \p T is piranha::dd_real or an interoperable type.
+     *
+     * Division by zero follows the rules of \p double arithmetic.
+     *
+     * @param[in] x argument for the division.
+     *
+     * @return reference to \p this.
+     *
+     * @throws unspecified any exception thrown by the generic constructor.
+     */
+    template <typename T>
+    auto operator/=(const T &x) -> decltype(this->in_place_div(x))
+    {
+        return in_place_div(x);
+    }
+    /// Generic in-place division with piranha::dd_real.
+    /**
+     * \note
+     * This operator is enabled only if \p T is a non-const interoperable type.
+     *
+     * The result of <tt>x / r</tt> is cast back to \p T and assigned to \p x.
+     *
+     * @param[in,out] x first argument.
+     * @param[in] r second argument.
+     *
+     * @return reference to \p x.
+     *
+     * @throws unspecified any exception thrown by the conversion operator.
+     */
+    template <typename T, generic_in_place_enabler<T> = 0>
+    friend T &operator/=(T &x, const dd_real &r)
+    {
+        return x = static_cast<T>(x / r);
+    }
+    /// Generic binary division involving piranha::dd_real.
+    /**
+     * \note
+     * This template operator is enabled only if either:
+     * - \p T is piranha::dd_real and \p U is an interoperable type,
+     * - \p U is piranha::dd_real and \p T is an interoperable type,
+     * - both \p T and \p U are piranha::dd_real.
+     *
+     * The return type is always piranha::dd_real.
+     *
+     * @param[in] x first argument
+     * @param[in] y second argument.
+     *
+     * @return <tt>x / y</tt>.
+     *
+     * @throws unspecified any exception thrown by the generic constructor.
+     */
+    template <typename T, typename U>
+    friend auto operator/(const T &x, const U &y) -> decltype(dd_real::binary_div(x, y))
+    {
+        return binary_div(x, y);
+    }
+    /// Generic equality operator involving piranha::dd_real.
+    /**
+     * \note
+     * This template operator is enabled only if either:
+     * - \p T is piranha::dd_real and \p U is an interoperable type,
+     * - \p U is piranha::dd_real and \p T is an interoperable type,
+     * - both \p T and \p U are piranha::dd_real.
+     *
+     * As in all comparison operators apart from the inequality operator, \p false is returned if any operand is NaN.
+     *
+     * @param[in] x first argument
+     * @param[in] y second argument.
+     *
+     * @return \p true if <tt>x == y</tt>, \p false otherwise.
+     *
+     * @throws unspecified any exception thrown by the generic constructor.
+     */
+    template <typename T, typename U>
+    friend auto operator==(const T &x, const U &y) -> decltype(dd_real::binary_equality(x, y))
+    {
+        return binary_equality(x, y);
+    }
+    /// Generic inequality operator involving piranha::dd_real.
+    /**
+     * \note
+     * This template operator is enabled only if either:
+     * - \p T is piranha::dd_real and \p U is an interoperable type,
+     * - \p U is piranha::dd_real and \p T is an interoperable type,
+     * - both \p T and \p U are piranha::dd_real.
+     *
+     * @param[in] x first argument
+     * @param[in] y second argument.
+     *
+     * @return \p true if <tt>x != y</tt>, \p false otherwise.
+     *
+     * @throws unspecified any exception thrown by the generic constructor.
+     */
+    template <typename T, typename U>
+    friend auto operator!=(const T &x, const U &y) -> decltype(!dd_real::binary_equality(x, y))
+    {
+        return !binary_equality(x, y);
+    }
+    /// Generic less-than operator involving piranha::dd_real.
+    /**
+     * \note
+     * This template operator is enabled only if either:
+     * - \p T is piranha::dd_real and \p U is an interoperable type,
+     * - \p U is piranha::dd_real and \p T is an interoperable type,
+     * - both \p T and \p U are piranha::dd_real.
+     *
+     * @param[in] x first argument
+     * @param[in] y second argument.
+     *
+     * @return \p true if <tt>x < y</tt>, \p false otherwise.
+     *
+     * @throws unspecified any exception thrown by the generic constructor.
+     */
+    template <typename T, typename U>
+    friend auto operator<(const T &x, const U &y) -> decltype(dd_real::binary_less_than(x, y))
+    {
+        return binary_less_than(x, y);
+    }
+    /// Generic less-than or equal operator involving piranha::dd_real.
+    /**
+     * \note
+     * This template operator is enabled only if either:
+     * - \p T is piranha::dd_real and \p U is an interoperable type,
+     * - \p U is piranha::dd_real and \p T is an interoperable type,
+     * - both \p T and \p U are piranha::dd_real.
+     *
+     * @param[in] x first argument
+     * @param[in] y second argument.
+     *
+     * @return \p true if <tt>x <= y</tt>, \p false otherwise.
+     *
+     * @throws unspecified any exception thrown by the generic constructor.
+     */
+    template <typename T, typename U>
+    friend auto operator<=(const T &x, const U &y) -> decltype(dd_real::binary_leq(x, y))
+    {
+        return binary_leq(x, y);
+    }
+    /// Generic greater-than operator involving piranha::dd_real.
+    /**
+     * \note
+     * This template operator is enabled only if either:
+     * - \p T is piranha::dd_real and \p U is an interoperable type,
+     * - \p U is piranha::dd_real and \p T is an interoperable type,
+     * - both \p T and \p U are piranha::dd_real.
+     *
+     * @param[in] x first argument
+     * @param[in] y second argument.
+     *
+     * @return \p true if <tt>x > y</tt>, \p false otherwise.
+     *
+     * @throws unspecified any exception thrown by the generic constructor.
+     */
+    template <typename T, typename U>
+    friend auto operator>(const T &x, const U &y) -> decltype(dd_real::binary_less_than(y, x))
+    {
+        return binary_less_than(y, x);
+    }
+    /// Generic greater-than or equal operator involving piranha::dd_real.
+    /**
+     * \note
+     * This template operator is enabled only if either:
+     * - \p T is piranha::dd_real and \p U is an interoperable type,
+     * - \p U is piranha::dd_real and \p T is an interoperable type,
+     * - both \p T and \p U are piranha::dd_real.
+     *
+     * @param[in] x first argument
+     * @param[in] y second argument.
+     *
+     * @return \p true if <tt>x >= y</tt>, \p false otherwise.
+     *
+     * @throws unspecified any exception thrown by the generic constructor.
+     */
+    template <typename T, typename U>
+    friend auto operator>=(const T &x, const U &y) -> decltype(dd_real::binary_leq(y, x))
+    {
+        return binary_leq(y, x);
+    }
+    /// Overload output stream operator for piranha::dd_real.
+    /**
+     * The value of \p d is rounded to a piranha::real with 107 bits of precision, which is then printed
+     * in the format used by piranha::real. Note that the output does not always allow to recover the exact
+     * value of \p d via the constructor from string, as the low component might extend beyond 107 bits.
+     *
+     * @param[in] os output stream.
+     * @param[in] d piranha::dd_real to be directed to stream.
+     *
+     * @return reference to \p os.
+     *
+     * @throws unspecified any exception thrown by the stream operator of piranha::real.
+     */
+    friend std::ostream &operator<<(std::ostream &os, const dd_real &d)
+    {
+        real r{d.m_hi, 107};
+        r += real{d.m_lo, 107};
+        return os << r;
+    }
+
+#if defined(PIRANHA_WITH_MSGPACK)
+private:
+    template <typename Stream>
+    using msgpack_pack_enabler
+        = enable_if_t<conjunction<is_msgpack_stream<Stream>, has_msgpack_pack<Stream, double>>::value, int>;
+    template <typename U>
+    using msgpack_convert_enabler
+        = enable_if_t<conjunction<std::is_same<U, U>, // For SFINAE.
+                                  has_msgpack_convert<double>>::value,
+                      int>;
+
+public:
+    /// Pack in msgpack format.
+    /**
+     * \note
+     * This method is enabled only if \p Stream satisfies piranha::is_msgpack_stream and \p double
+     * satisfies piranha::has_msgpack_pack.
+     *
+     * This method will pack \p this into \p p as an array containing the two components.
+     *
+     * @param[in] p target <tt>msgpack::packer</tt>.
+     * @param[in] f the desired piranha::msgpack_format.
+     *
+     * @throws unspecified any exception thrown by:
+     * - the public interface of <tt>msgpack::packer</tt>,
+     * - piranha::msgpack_pack().
+     */
+    template <typename Stream, msgpack_pack_enabler<Stream> = 0>
+    void msgpack_pack(msgpack::packer<Stream> &p, msgpack_format f) const
+    {
+        p.pack_array(2u);
+        piranha::msgpack_pack(p, m_hi, f);
+        piranha::msgpack_pack(p, m_lo, f);
+    }
+    /// Convert from msgpack object.
+    /**
+     * \note
+     * This method is enabled only if \p double satisfies piranha::has_msgpack_convert.
+     *
+     * This method will convert \p o into \p this. If \p f is piranha::msgpack_format::portable, the deserialized
+     * components will be normalised, otherwise they will be assigned as-is.
+     *
+     * @param[in] o source <tt>msgpack::object</tt>.
+     * @param[in] f the desired piranha::msgpack_format.
+     *
+     * @throws unspecified any exception thrown by:
+     * - the public interface of <tt>msgpack::object</tt>,
+     * - piranha::msgpack_convert().
+     */
+    template <typename U = dd_real, msgpack_convert_enabler<U> = 0>
+    void msgpack_convert(const msgpack::object &o, msgpack_format f)
+    {
+        std::array<msgpack::object, 2u> v;
+        o.convert(v);
+        double hi, lo;
+        piranha::msgpack_convert(hi, v[0], f);
+        piranha::msgpack_convert(lo, v[1], f);
+        if (f == msgpack_format::binary) {
+            m_hi = hi;
+            m_lo = lo;
+        } else {
+            *this = dd_real{hi, lo};
+        }
+    }
+#endif
+
+private:
+    template <typename T, enable_if_t<std::is_integral<T>::value, int> = 0>
+    dd_real pow_dispatch(const T &n) const
+    {
+        bool neg;
+        const auto u = detail::dd_abs_integral(n, neg);
+        const dd_real retval = pow_impl(u);
+        return neg ? div_impl(dd_real{1}, retval) : retval;
+    }
+    template <typename T, enable_if_t<detail::is_mp_integer<T>::value, int> = 0>
+    dd_real pow_dispatch(const T &n) const
+    {
+        const bool neg = n.sign() < 0;
+        T u{n};
+        if (neg) {
+            u.negate();
+        }
+        const dd_real retval = pow_impl(std::move(u));
+        return neg ? div_impl(dd_real{1}, retval) : retval;
+    }
+
+private:
+    double m_hi;
+    double m_lo;
+};
+
+namespace math
+{
+
+/// Specialisation of the piranha::math::negate() functor for piranha::dd_real.
+template <typename T>
+struct negate_impl<T, typename std::enable_if<std::is_same<T, dd_real>::value>::type> {
+    /// Call operator.
+    /**
+     * @param[in,out] x piranha::dd_real to be negated.
+     */
+    void operator()(dd_real &x) const
+    {
+        x.negate();
+    }
+};
+
+/// Specialisation of the piranha::math::is_zero() functor for piranha::dd_real.
+template <typename T>
+struct is_zero_impl<T, typename std::enable_if<std::is_same<T, dd_real>::value>::type> {
+    /// Call operator.
+    /**
+     * @param[in] d piranha::dd_real to be tested.
+     *
+     * @return \p true if \p d is zero, \p false otherwise.
+     */
+    bool operator()(const T &d) const
+    {
+        return d.is_zero();
+    }
+};
+
+/// Specialisation of the piranha::math::pow() functor for piranha::dd_real.
+/**
+ * This specialisation is activated when the base is piranha::dd_real and the exponent is
+ * a C++ integral type (except \p bool) or piranha::mp_integer.
+ */
+template <typename T, typename U>
+struct pow_impl<T, U, typename std::enable_if<std::is_same<T, dd_real>::value
+                                              && (std::is_integral<U>::value || detail::is_mp_integer<U>::value)
+                                              && !std::is_same<U, bool>::value>::type> {
+    /// Call operator.
+    /**
+     * @param[in] d base.
+     * @param[in] n exponent.
+     *
+     * @return \p d to the power of \p n.
+     *
+     * @throws unspecified any exception thrown by piranha::dd_real::pow().
+     */
+    dd_real operator()(const dd_real &d, const U &n) const
+    {
+        return d.pow(n);
+    }
+};
+
+/// Specialisation of the piranha::math::sin() functor for piranha::dd_real.
+template <typename T>
+struct sin_impl<T, typename std::enable_if<std::is_same<T, dd_real>::value>::type> {
+    /// Call operator.
+    /**
+     * @param[in] d argument.
+     *
+     * @return sine of \p d.
+     */
+    dd_real operator()(const T &d) const
+    {
+        return d.sin();
+    }
+};
+
+/// Specialisation of the piranha::math::cos() functor for piranha::dd_real.
+template <typename T>
+struct cos_impl<T, typename std::enable_if<std::is_same<T, dd_real>::value>::type> {
+    /// Call operator.
+    /**
+     * @param[in] d argument.
+     *
+     * @return cosine of \p d.
+     */
+    dd_real operator()(const T &d) const
+    {
+        return d.cos();
+    }
+};
+
+/// Specialisation of the piranha::math::abs() functor for piranha::dd_real.
+template <typename T>
+struct abs_impl<T, typename std::enable_if<std::is_same<T, dd_real>::value>::type> {
+    /// Call operator.
+    /**
+     * @param[in] d input parameter.
+     *
+     * @return absolute value of \p d.
+     */
+    T operator()(const T &d) const
+    {
+        return d.abs();
+    }
+};
+
+/// Specialisation of the piranha::math::partial() functor for piranha::dd_real.
+template <typename T>
+struct partial_impl<T, typename std::enable_if<std::is_same<T, dd_real>::value>::type> {
+    /// Call operator.
+    /**
+     * @return an instance of piranha::dd_real constructed from zero.
+     */
+    dd_real operator()(const dd_real &, const std::string &) const
+    {
+        return dd_real{};
+    }
+};
+
+/// Specialisation of the implementation of piranha::math::multiply_accumulate() for piranha::dd_real.
+template <typename T>
+struct multiply_accumulate_impl<T, T, T, typename std::enable_if<std::is_same<T, dd_real>::value>::type> {
+    /// Call operator.
+    /**
+     * This implementation will use piranha::dd_real::multiply_accumulate().
+     *
+     * @param[in,out] x target value for accumulation.
+     * @param[in] y first argument.
+     * @param[in] z second argument.
+     */
+    void operator()(T &x, const T &y, const T &z) const
+    {
+        x.multiply_accumulate(y, z);
+    }
+};
+}
+
+inline dd_real::~dd_real()
+{
+    PIRANHA_TT_CHECK(is_cf, dd_real);
+}
+
+inline namespace impl
+{
+
+template <typename To, typename From>
+using sc_dd_real_enabler
+    = enable_if_t<conjunction<disjunction<std::is_integral<To>, detail::is_mp_integer<To>, detail::is_mp_rational<To>>,
+                              std::is_same<From, dd_real>>::value>;
+}
+
+/// Specialisation of piranha::safe_cast() for conversions involving piranha::dd_real.
+/**
+ * \note
+ * This specialisation is enabled if \p To is an integral type, piranha::mp_integer or piranha::mp_rational, and \p From
+ * is piranha::dd_real.
+ */
+template <typename To, typename From>
+struct safe_cast_impl<To, From, sc_dd_real_enabler<To, From>> {
+private:
+    template <typename T>
+    using integral_enabler = enable_if_t<disjunction<std::is_integral<T>, detail::is_mp_integer<T>>::value, int>;
+    template <typename T>
+    using rational_enabler = enable_if_t<detail::is_mp_rational<T>::value, int>;
+
+public:
+    /// Call operator, dd_real to integral overload.
+    /**
+     * \note
+     * This operator is enabled if \p To is an integral type or an instance of piranha::mp_integer.
+     *
+     * The conversion will succeed if \p d is a finite integral value representable by
+     * the target type.
+     *
+     * @param[in] d conversion argument.
+     *
+     * @return \p d converted to \p To.
+     *
+     * @throws piranha::safe_cast_failure if the conversion fails.
+     * @throws unspecified any exception thrown by \p boost::lexical_cast().
+     */
+    template <typename T = To, integral_enabler<T> = 0>
+    T operator()(const dd_real &d) const
+    {
+        if (unlikely(d.is_inf() || d.is_nan() || d.truncate() != d)) {
+            piranha_throw(safe_cast_failure,
+                          "cannot convert the input dd_real " + boost::lexical_cast<std::string>(d)
+                              + " to the integral type '" + detail::demangle<To>()
+                              + "', as the input dd_real does not represent a finite integral value");
+        }
+        try {
+            return static_cast<T>(d);
+        } catch (const std::overflow_error &) {
+            piranha_throw(safe_cast_failure, "cannot convert the input dd_real " + boost::lexical_cast<std::string>(d)
+                                                 + " to the integral type '" + detail::demangle<To>()
+                                                 + "', as the conversion would not preserve the value");
+        }
+    }
+    /// Call operator, dd_real to rational overload.
+    /**
+     * \note
+     * This operator is enabled if \p To is an instance of piranha::mp_rational.
+     *
+     * @param[in] d conversion argument.
+     *
+     * @return \p d converted to piranha::mp_rational.
+     *
+     * @throws piranha::safe_cast_failure if the conversion fails.
+     * @throws unspecified any exception thrown by \p boost::lexical_cast().
+     */
+    template <typename T = To, rational_enabler<T> = 0>
+    T operator()(const dd_real &d) const
+    {
+        try {
+            return static_cast<T>(d);
+        } catch (const std::overflow_error &) {
+            piranha_throw(safe_cast_failure, "cannot convert the input dd_real " + boost::lexical_cast<std::string>(d)
+                                                 + " to the rational type '" + detail::demangle<To>()
+                                                 + "', as the conversion would not preserve the value");
+        }
+    }
+};
+
+inline namespace impl
+{
+
+template <typename Archive>
+using dd_real_boost_save_enabler = enable_if_t<has_boost_save<Archive, double>::value>;
+
+template <typename Archive>
+using dd_real_boost_load_enabler = enable_if_t<has_boost_load<Archive, double>::value>;
+}
+
+/// Specialisation of piranha::boost_save() for piranha::dd_real.
+/**
+ * \note
+ * This specialisation is enabled only if \p double satisfies piranha::has_boost_save.
+ *
+ * The two components of the piranha::dd_real are saved in sequence.
+ *
+ * @throws unspecified any exception thrown by piranha::boost_save().
+ */
+template <typename Archive>
+struct boost_save_impl<Archive, dd_real, dd_real_boost_save_enabler<Archive>>
+    : boost_save_via_boost_api<Archive, dd_real> {
+};
+
+/// Specialisation of piranha::boost_load() for piranha::dd_real.
+/**
+ * \note
+ * This specialisation is enabled only if \p double satisfies piranha::has_boost_load.
+ *
+ * The loaded components are normalised before being assigned.
+ *
+ * @throws unspecified any exception thrown by piranha::boost_load().
+ */
+template <typename Archive>
+struct boost_load_impl<Archive, dd_real, dd_real_boost_load_enabler<Archive>>
+    : boost_load_via_boost_api<Archive, dd_real> {
+};
+
+#if defined(PIRANHA_WITH_MSGPACK)
+
+inline namespace impl
+{
+
+// Enablers for msgpack serialization.
+template <typename Stream>
+using dd_real_msgpack_pack_enabler = enable_if_t<is_detected<msgpack_pack_member_t, Stream, dd_real>::value>;
+
+template <typename T>
+using dd_real_msgpack_convert_enabler
+    = enable_if_t<conjunction<std::is_same<dd_real, T>, is_detected<msgpack_convert_member_t, T>>::value>;
+}
+
+/// Specialisation of piranha::msgpack_pack() for piranha::dd_real.
+/**
+ * \note
+ * This specialisation is enabled if the piranha::dd_real::msgpack_pack() method is supported with a stream of type
+ * \p Stream.
+ */
+template <typename Stream>
+struct msgpack_pack_impl<Stream, dd_real, dd_real_msgpack_pack_enabler<Stream>> {
+    /// Call operator.
+    /**
+     * The call operator will use piranha::dd_real::msgpack_pack() internally.
+     *
+     * @param[in] p target <tt>msgpack::packer</tt>.
+     * @param[in] x piranha::dd_real to be serialized.
+     * @param[in] f the desired piranha::msgpack_format.
+     *
+     * @throws unspecified any exception thrown by piranha::dd_real::msgpack_pack().
+     */
+    void operator()(msgpack::packer<Stream> &p, const dd_real &x, msgpack_format f) const
+    {
+        x.msgpack_pack(p, f);
+    }
+};
+
+/// Specialisation of piranha::msgpack_convert() for piranha::dd_real.
+/**
+ * \note
+ * This specialisation is enabled if \p T is piranha::dd_real and
+ * the piranha::dd_real::msgpack_convert() method is supported.
+ */
+template <typename T>
+struct msgpack_convert_impl<T, dd_real_msgpack_convert_enabler<T>> {
+    /// Call operator.
+    /**
+     * The call operator will use piranha::dd_real::msgpack_convert() internally.
+     *
+     * @param[in] x target piranha::dd_real.
+     * @param[in] o the <tt>msgpack::object</tt> to be converted into \p x.
+     * @param[in] f the desired piranha::msgpack_format.
+     *
+     * @throws unspecified any exception thrown by piranha::dd_real::msgpack_convert().
+     */
+    void operator()(T &x, const msgpack::object &o, msgpack_format f) const
+    {
+        x.msgpack_convert(o, f);
+    }
+};
+
+#endif
+
+inline namespace impl
+{
+
+template <typename T>
+using dd_real_zero_is_absorbing_enabler = enable_if_t<std::is_same<uncvref_t<T>, dd_real>::value>;
+}
+
+/// Specialisation of piranha::zero_is_absorbing for piranha::dd_real.
+/**
+ * \note
+ * This specialisation is enabled if \p T, after the removal of cv/reference qualifiers, is piranha::dd_real.
+ *
+ * As for \p double, due to the presence of NaN the zero element is not absorbing for piranha::dd_real.
+ */
+template <typename T>
+struct zero_is_absorbing<T, dd_real_zero_is_absorbing_enabler<T>> {
+    /// Value of the type trait.
+    static const bool value = false;
+};
+
+template <typename T>
+const bool zero_is_absorbing<T, dd_real_zero_is_absorbing_enabler<T>>::value;
+}
+
+#endif
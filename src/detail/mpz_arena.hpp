@@ -0,0 +1,506 @@
+/* Copyright 2009-2016 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#ifndef PIRANHA_DETAIL_MPZ_ARENA_HPP
+#define PIRANHA_DETAIL_MPZ_ARENA_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <gmp.h>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "../config.hpp"
+
+namespace piranha
+{
+
+namespace detail
+{
+
+// Arena storage for GMP limbs.
+//
+// When the first arena is created, the GMP memory functions are replaced by functions which serve the allocations of
+// the current thread from the arena activated via mpz_arena_scope (if any), and which defer to the original GMP
+// functions otherwise. Arena memory is handed out by bumping a pointer within per-thread chunks. Small blocks freed
+// while their arena is active are recycled through per-thread free lists (which makes short-lived temporaries cheap),
+// other deallocations are no-ops. The chunks are released in bulk when the arena is destroyed. Each thread keeps the
+// state (current chunk and free lists) of the last few arenas it used, so that the chunk of an arena is carried over
+// from one scope to the next instead of being abandoned.
+//
+// The chunks are aligned to their size, so that the chunk owning a pointer can be computed by masking. The chunks of
+// all the arenas are registered in a global fixed-size open-addressing table, which is read without locking by the
+// deallocation/reallocation functions in order to tell arena blocks from ordinary GMP blocks. Blocks allocated by the
+// original GMP functions are thus always given back to them.
+//
+// The replacement functions are installed by piranha::init() (see mpz_arena_install()). Swapping the GMP memory
+// functions is not thread-safe: GMP and MPFR (including the MPFR caches) read the memory function pointers without
+// synchronisation, and the original functions saved here are read by all the threads. The installation must thus
+// happen once, before any other thread uses GMP or MPFR.
+class mpz_arena_impl;
+
+template <typename = void>
+struct mpz_arena_statics {
+    // Size and alignment of the chunks (1 MiB).
+    static const unsigned log2_chunk_size = 20u;
+    static const std::size_t chunk_size = std::size_t(1) << log2_chunk_size;
+    // Allocations larger than this are never served by the arenas.
+    static const std::size_t max_block_size = chunk_size / 16u;
+    // Size of the chunk registry (i.e., max number of chunks alive at the same time).
+    static const unsigned log2_table_size = 14u;
+    static const std::size_t table_size = std::size_t(1) << log2_table_size;
+    // Blocks up to this size are recycled via the free lists.
+    static const std::size_t max_recycled_size = 1024u;
+    // Special value marking an erased slot in the registry.
+    static const std::uintptr_t tombstone = std::uintptr_t(-1);
+    static std::atomic<std::uintptr_t> s_table[table_size];
+    // The arenas owning the chunks in the registry.
+    static std::atomic<mpz_arena_impl *> s_owners[table_size];
+    // Max probe length ever used in the registry: lookups never need to go further than this.
+    static std::atomic<std::size_t> s_max_probe;
+    static std::atomic<std::size_t> s_n_chunks;
+    // Protects the writes to the registry.
+    static std::mutex s_mutex;
+    // Source of the arena ids.
+    static std::atomic<std::uint_least64_t> s_next_id;
+    // The GMP memory functions in place before the installation of the arena functions.
+    static void *(*s_alloc)(std::size_t);
+    static void *(*s_realloc)(void *, std::size_t, std::size_t);
+    static void (*s_free)(void *, std::size_t);
+};
+
+template <typename T>
+const unsigned mpz_arena_statics<T>::log2_chunk_size;
+
+template <typename T>
+const std::size_t mpz_arena_statics<T>::chunk_size;
+
+template <typename T>
+const std::size_t mpz_arena_statics<T>::max_block_size;
+
+template <typename T>
+const unsigned mpz_arena_statics<T>::log2_table_size;
+
+template <typename T>
+const std::size_t mpz_arena_statics<T>::table_size;
+
+template <typename T>
+const std::size_t mpz_arena_statics<T>::max_recycled_size;
+
+template <typename T>
+const std::uintptr_t mpz_arena_statics<T>::tombstone;
+
+template <typename T>
+std::atomic<std::uintptr_t> mpz_arena_statics<T>::s_table[mpz_arena_statics<T>::table_size];
+
+template <typename T>
+std::atomic<mpz_arena_impl *> mpz_arena_statics<T>::s_owners[mpz_arena_statics<T>::table_size];
+
+template <typename T>
+std::atomic<std::size_t> mpz_arena_statics<T>::s_max_probe(0u);
+
+template <typename T>
+std::atomic<std::size_t> mpz_arena_statics<T>::s_n_chunks(0u);
+
+template <typename T>
+std::mutex mpz_arena_statics<T>::s_mutex;
+
+template <typename T>
+std::atomic<std::uint_least64_t> mpz_arena_statics<T>::s_next_id(1u);
+
+template <typename T>
+void *(*mpz_arena_statics<T>::s_alloc)(std::size_t) = nullptr;
+
+template <typename T>
+void *(*mpz_arena_statics<T>::s_realloc)(void *, std::size_t, std::size_t) = nullptr;
+
+template <typename T>
+void (*mpz_arena_statics<T>::s_free)(void *, std::size_t) = nullptr;
+
+using mpz_arena_st = mpz_arena_statics<>;
+
+// Registry of the arena chunks. The keys are the chunk addresses divided by the chunk size.
+inline std::size_t mpz_arena_slot(std::uintptr_t key)
+{
+    // Fibonacci hashing.
+    return static_cast<std::size_t>((static_cast<std::uint_least64_t>(key) * 11400714819323198485ull)
+                                     >> (64u - mpz_arena_st::log2_table_size));
+}
+
+inline bool mpz_arena_register(std::uintptr_t key, mpz_arena_impl *owner)
+{
+    std::lock_guard<std::mutex> lock(mpz_arena_st::s_mutex);
+    const auto mask = mpz_arena_st::table_size - 1u;
+    for (std::size_t i = 0u, h = mpz_arena_slot(key); i < mpz_arena_st::table_size; ++i) {
+        auto &slot = mpz_arena_st::s_table[(h + i) & mask];
+        const auto v = slot.load(std::memory_order_relaxed);
+        if (v == 0u || v == mpz_arena_st::tombstone) {
+            mpz_arena_st::s_owners[(h + i) & mask].store(owner, std::memory_order_relaxed);
+            if (i + 1u > mpz_arena_st::s_max_probe.load(std::memory_order_relaxed)) {
+                mpz_arena_st::s_max_probe.store(i + 1u, std::memory_order_release);
+            }
+            mpz_arena_st::s_n_chunks.fetch_add(1u, std::memory_order_release);
+            slot.store(key, std::memory_order_release);
+            return true;
+        }
+    }
+    return false;
+}
+
+inline void mpz_arena_unregister(std::uintptr_t key)
+{
+    std::lock_guard<std::mutex> lock(mpz_arena_st::s_mutex);
+    const auto mask = mpz_arena_st::table_size - 1u, mp = mpz_arena_st::s_max_probe.load(std::memory_order_relaxed);
+    for (std::size_t i = 0u, h = mpz_arena_slot(key); i < mp; ++i) {
+        auto &slot = mpz_arena_st::s_table[(h + i) & mask];
+        if (slot.load(std::memory_order_relaxed) == key) {
+            slot.store(mpz_arena_st::tombstone, std::memory_order_release);
+            mpz_arena_st::s_n_chunks.fetch_sub(1u, std::memory_order_release);
+            return;
+        }
+    }
+    piranha_assert(false);
+}
+
+// The arena owning ptr, or null if ptr does not belong to an arena chunk.
+inline mpz_arena_impl *mpz_arena_owner(const void *ptr)
+{
+    if (likely(mpz_arena_st::s_n_chunks.load(std::memory_order_acquire) == 0u)) {
+        return nullptr;
+    }
+    const auto key = reinterpret_cast<std::uintptr_t>(ptr) >> mpz_arena_st::log2_chunk_size;
+    const auto mask = mpz_arena_st::table_size - 1u, mp = mpz_arena_st::s_max_probe.load(std::memory_order_acquire);
+    for (std::size_t i = 0u, h = mpz_arena_slot(key); i < mp; ++i) {
+        const auto v = mpz_arena_st::s_table[(h + i) & mask].load(std::memory_order_acquire);
+        if (v == key) {
+            return mpz_arena_st::s_owners[(h + i) & mask].load(std::memory_order_relaxed);
+        }
+        if (v == 0u) {
+            break;
+        }
+    }
+    return nullptr;
+}
+
+// The arena proper: it owns the chunks, which are then carved up by the threads using the arena. Each arena has a
+// unique id, which identifies the per-thread state of the arena (the address of the arena cannot be used for this
+// purpose, as it might be reused by another arena after the destruction of the first one).
+class mpz_arena_impl
+{
+public:
+    mpz_arena_impl() : m_id(mpz_arena_st::s_next_id.fetch_add(1u, std::memory_order_relaxed))
+    {
+    }
+    mpz_arena_impl(const mpz_arena_impl &) = delete;
+    mpz_arena_impl(mpz_arena_impl &&) = delete;
+    mpz_arena_impl &operator=(const mpz_arena_impl &) = delete;
+    mpz_arena_impl &operator=(mpz_arena_impl &&) = delete;
+    ~mpz_arena_impl()
+    {
+        for (const auto &p : m_chunks) {
+            mpz_arena_unregister(reinterpret_cast<std::uintptr_t>(p.second) >> mpz_arena_st::log2_chunk_size);
+            std::free(p.first);
+        }
+    }
+    // Allocate and register a new chunk. Returns null on failure.
+    char *new_chunk()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        try {
+            m_chunks.reserve(m_chunks.size() + 1u);
+        } catch (const std::bad_alloc &) {
+            return nullptr;
+        }
+        const auto cs = mpz_arena_st::chunk_size;
+#if defined(PIRANHA_HAVE_POSIX_MEMALIGN)
+        void *orig;
+        if (unlikely(::posix_memalign(&orig, cs, cs) != 0)) {
+            return nullptr;
+        }
+        char *aligned = static_cast<char *>(orig);
+#else
+        // Over-allocate and align manually. The extra pages are never touched.
+        void *orig = std::malloc(2u * cs);
+        if (unlikely(orig == nullptr)) {
+            return nullptr;
+        }
+        char *aligned = static_cast<char *>(orig)
+                        + ((cs - (reinterpret_cast<std::uintptr_t>(orig) & (cs - 1u))) & (cs - 1u));
+#endif
+        if (unlikely(!mpz_arena_register(reinterpret_cast<std::uintptr_t>(aligned) >> mpz_arena_st::log2_chunk_size,
+                                         this))) {
+            // The registry is full.
+            std::free(orig);
+            return nullptr;
+        }
+        m_chunks.emplace_back(orig, aligned);
+        return aligned;
+    }
+    std::size_t size() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_chunks.size() * mpz_arena_st::chunk_size;
+    }
+    std::uint_least64_t id() const
+    {
+        return m_id;
+    }
+
+private:
+    const std::uint_least64_t m_id;
+    mutable std::mutex m_mutex;
+    // Pairs of (allocated pointer, aligned chunk start).
+    std::vector<std::pair<void *, char *>> m_chunks;
+};
+
+#if defined(PIRANHA_HAVE_THREAD_LOCAL)
+
+// Number of size classes for the free lists.
+inline constexpr std::size_t mpz_arena_n_classes()
+{
+    return mpz_arena_statics<>::max_recycled_size / alignof(std::max_align_t) + 1u;
+}
+
+// Number of arenas whose state is kept by each thread.
+inline constexpr std::size_t mpz_arena_n_caches()
+{
+    return 4u;
+}
+
+// The state of an arena in a thread: the id of the arena (zero for an unused entry), the free region of the current
+// chunk and the heads of the free lists of recycled blocks (linked through their first bytes), indexed by size class.
+struct mpz_arena_cache {
+    std::uint_least64_t m_id;
+    char *m_cur;
+    char *m_end;
+    std::array<void *, mpz_arena_n_classes()> m_free;
+};
+
+// The arena state of a thread: the active arena, its state and the states of the arenas used most recently by
+// the thread (the oldest one is evicted, in round-robin order, when a new arena is used).
+struct mpz_arena_tls_state {
+    mpz_arena_impl *m_arena;
+    mpz_arena_cache *m_cache;
+    std::array<mpz_arena_cache, mpz_arena_n_caches()> m_caches;
+    std::size_t m_next;
+};
+
+template <typename = void>
+struct mpz_arena_tls {
+    static thread_local mpz_arena_tls_state s_state;
+};
+
+template <typename T>
+thread_local mpz_arena_tls_state mpz_arena_tls<T>::s_state = {nullptr, nullptr, {{}}, 0u};
+
+// Activate an arena (or no arena, if a is null) in the current thread.
+inline void mpz_arena_activate(mpz_arena_impl *a)
+{
+    auto &st = mpz_arena_tls<>::s_state;
+    st.m_arena = a;
+    if (a == nullptr) {
+        st.m_cache = nullptr;
+        return;
+    }
+    const auto id = a->id();
+    for (auto &c : st.m_caches) {
+        if (c.m_id == id) {
+            st.m_cache = &c;
+            return;
+        }
+    }
+    // NOTE: the remainder of the current chunk of the evicted arena (if any) is abandoned.
+    auto &c = st.m_caches[st.m_next];
+    st.m_next = (st.m_next + 1u) % mpz_arena_n_caches();
+    c = mpz_arena_cache{id, nullptr, nullptr, {{}}};
+    st.m_cache = &c;
+}
+
+inline std::size_t mpz_arena_round(std::size_t size)
+{
+    const std::size_t a = alignof(std::max_align_t);
+    return (size + (a - 1u)) & ~(a - 1u);
+}
+
+// Check if ptr is the last block handed out from the current chunk of the thread.
+inline bool mpz_arena_is_last(const mpz_arena_cache &c, const char *ptr, std::size_t size)
+{
+    return c.m_cur != nullptr && ptr >= c.m_end - mpz_arena_st::chunk_size && ptr + mpz_arena_round(size) == c.m_cur;
+}
+
+// The replacement GMP memory functions.
+inline void *mpz_arena_allocate(std::size_t size)
+{
+    auto &st = mpz_arena_tls<>::s_state;
+    if (st.m_arena != nullptr && size <= mpz_arena_st::max_block_size) {
+        auto &c = *st.m_cache;
+        const auto rsize = mpz_arena_round(size);
+        if (rsize <= mpz_arena_st::max_recycled_size) {
+            auto &head = c.m_free[rsize / alignof(std::max_align_t)];
+            if (head != nullptr) {
+                void *retval = head;
+                std::memcpy(&head, retval, sizeof(void *));
+                return retval;
+            }
+        }
+        if (unlikely(static_cast<std::size_t>(c.m_end - c.m_cur) < rsize)) {
+            char *chunk = st.m_arena->new_chunk();
+            if (unlikely(chunk == nullptr)) {
+                return mpz_arena_st::s_alloc(size);
+            }
+            c.m_cur = chunk;
+            c.m_end = chunk + mpz_arena_st::chunk_size;
+        }
+        char *retval = c.m_cur;
+        c.m_cur += rsize;
+        return retval;
+    }
+    return mpz_arena_st::s_alloc(size);
+}
+
+inline void mpz_arena_free(void *ptr, std::size_t size)
+{
+    auto owner = mpz_arena_owner(ptr);
+    if (owner == nullptr) {
+        mpz_arena_st::s_free(ptr, size);
+        return;
+    }
+    auto &st = mpz_arena_tls<>::s_state;
+    if (owner != st.m_arena) {
+        // The block will be released together with its arena.
+        return;
+    }
+    auto &c = *st.m_cache;
+    const auto rsize = mpz_arena_round(size);
+    if (mpz_arena_is_last(c, static_cast<char *>(ptr), size)) {
+        c.m_cur = static_cast<char *>(ptr);
+    } else if (rsize <= mpz_arena_st::max_recycled_size) {
+        auto &head = c.m_free[rsize / alignof(std::max_align_t)];
+        std::memcpy(ptr, &head, sizeof(void *));
+        head = ptr;
+    }
+}
+
+inline void *mpz_arena_reallocate(void *ptr, std::size_t old_size, std::size_t new_size)
+{
+    if (mpz_arena_owner(ptr) == nullptr) {
+        return mpz_arena_st::s_realloc(ptr, old_size, new_size);
+    }
+    auto &st = mpz_arena_tls<>::s_state;
+    char *p = static_cast<char *>(ptr);
+    if (st.m_arena != nullptr && new_size <= mpz_arena_st::max_block_size && mpz_arena_is_last(*st.m_cache, p, old_size)
+        && mpz_arena_round(new_size) <= static_cast<std::size_t>(st.m_cache->m_end - p)) {
+        // Grow or shrink in place.
+        st.m_cache->m_cur = p + mpz_arena_round(new_size);
+        return ptr;
+    }
+    // NOTE: outside an arena scope, this moves the block out of the arena.
+    void *retval = mpz_arena_allocate(new_size);
+    std::memcpy(retval, ptr, std::min(old_size, new_size));
+    mpz_arena_free(ptr, old_size);
+    return retval;
+}
+
+// Install the arena functions. This is called once by piranha::init(), which must be invoked before any other
+// thread uses GMP or MPFR (see the notes at the top of the file).
+inline void mpz_arena_install()
+{
+    ::mp_get_memory_functions(&mpz_arena_st::s_alloc, &mpz_arena_st::s_realloc, &mpz_arena_st::s_free);
+    ::mp_set_memory_functions(mpz_arena_allocate, mpz_arena_reallocate, mpz_arena_free);
+}
+
+// The arena active in the current thread.
+inline mpz_arena_impl *mpz_arena_current()
+{
+    return mpz_arena_tls<>::s_state.m_arena;
+}
+
+// Activate an arena (or no arena, if a is null) in the current thread for the lifetime of the object. Nothing is done
+// if a is already active (e.g., for the tasks without arena run by a thread without arena).
+class mpz_arena_scope
+{
+public:
+    explicit mpz_arena_scope(mpz_arena_impl *a) : m_old(mpz_arena_tls<>::s_state.m_arena)
+    {
+        if (a != m_old) {
+            mpz_arena_activate(a);
+        }
+    }
+    mpz_arena_scope(const mpz_arena_scope &) = delete;
+    mpz_arena_scope(mpz_arena_scope &&) = delete;
+    mpz_arena_scope &operator=(const mpz_arena_scope &) = delete;
+    mpz_arena_scope &operator=(mpz_arena_scope &&) = delete;
+    ~mpz_arena_scope()
+    {
+        // NOTE: the state of the previous arena might have been evicted in the meantime, so look it up again.
+        if (mpz_arena_tls<>::s_state.m_arena != m_old) {
+            mpz_arena_activate(m_old);
+        }
+    }
+
+private:
+    mpz_arena_impl *const m_old;
+};
+
+#else
+
+// NOTE: the arenas need thread-local storage. Without it, arenas can be created but they are never used, and the
+// GMP memory functions are left untouched.
+inline void mpz_arena_install()
+{
+}
+
+inline mpz_arena_impl *mpz_arena_current()
+{
+    return nullptr;
+}
+
+class mpz_arena_scope
+{
+public:
+    explicit mpz_arena_scope(mpz_arena_impl *)
+    {
+    }
+    mpz_arena_scope(const mpz_arena_scope &) = delete;
+    mpz_arena_scope(mpz_arena_scope &&) = delete;
+    mpz_arena_scope &operator=(const mpz_arena_scope &) = delete;
+    mpz_arena_scope &operator=(mpz_arena_scope &&) = delete;
+};
+
+#endif
+}
+}
+
+#endif
@@ -0,0 +1,74 @@
+/* Copyright 2009-2016 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#ifndef PIRANHA_DETAIL_PARALLEL_BUCKET_RANGES_HPP
+#define PIRANHA_DETAIL_PARALLEL_BUCKET_RANGES_HPP
+
+#include <cstddef>
+#include <stdexcept>
+
+#include "../config.hpp"
+#include "../exceptions.hpp"
+#include "../thread_pool.hpp"
+
+namespace piranha
+{
+namespace detail
+{
+
+// Split the buckets of the hash set hs into n_threads contiguous ranges, and call op(i, start, end) on the i-th
+// range. The ranges are processed concurrently via thread_pool::parallel_for(). If n_threads is 1, op will be
+// called from the current thread.
+template <typename HashSet, typename Op>
+inline void parallel_bucket_ranges(unsigned n_threads, const HashSet &hs, Op op)
+{
+    using bucket_size_type = typename HashSet::size_type;
+    if (unlikely(n_threads == 0u)) {
+        piranha_throw(std::invalid_argument, "invalid number of threads");
+    }
+    if (n_threads == 1u) {
+        op(0u, bucket_size_type(0u), hs.bucket_count());
+        return;
+    }
+    // Buckets per thread.
+    const auto bpt = static_cast<bucket_size_type>(hs.bucket_count() / n_threads);
+    thread_pool::parallel_for(0u, n_threads, 1u, [&](std::size_t i_start, std::size_t i_end) {
+        for (auto j = i_start; j != i_end; ++j) {
+            const auto i = static_cast<unsigned>(j);
+            const auto start_idx = static_cast<bucket_size_type>(bpt * i);
+            // Special casing for the last thread.
+            const auto end_idx
+                = (i == n_threads - 1u) ? hs.bucket_count() : static_cast<bucket_size_type>(bpt * (i + 1u));
+            op(i, start_idx, end_idx);
+        }
+    });
+}
+}
+}
+
+#endif
@@ -30,6 +30,7 @@ see https://www.gnu.org/licenses/. */
 #define PIRANHA_DETAIL_PARALLEL_VECTOR_TRANSFORM_HPP
 
 #include <algorithm>
+#include <cstddef>
 #include <stdexcept>
 #include <vector>
 
@@ -57,23 +58,15 @@ inline void parallel_vector_transform(unsigned n_threads, const std::vector<T> &
         return;
     }
     const auto block_size = ic.size() / n_threads;
-    auto local_transform = [&op](T const *b, T const *e, U *o) { std::transform(b, e, o, op); };
-    future_list<decltype(local_transform(ic.data(), ic.data(), oc.data()))> ff_list;
-    try {
-        for (unsigned i = 0u; i < n_threads; ++i) {
+    // NOTE: each thread index is a lightweight task in the pool.
+    thread_pool::parallel_for(0u, n_threads, 1u, [&](std::size_t i_start, std::size_t i_end) {
+        for (auto i = i_start; i != i_end; ++i) {
             auto b = ic.data() + i * block_size;
             auto e = (i == n_threads - 1u) ? (ic.data() + ic.size()) : (ic.data() + (i + 1u) * block_size);
             auto o = oc.data() + i * block_size;
-            ff_list.push_back(thread_pool::enqueue(i, local_transform, b, e, o));
+            std::transform(b, e, o, op);
         }
-        // First let's wait for everything to finish.
-        ff_list.wait_all();
-        // Then, let's handle the exceptions.
-        ff_list.get_all();
-    } catch (...) {
-        ff_list.wait_all();
-        throw;
-    }
+    });
 }
 }
 }
@@ -0,0 +1,703 @@
+/* Copyright 2009-2016 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#ifndef PIRANHA_DETAIL_VECTOR_KERNELS_HPP
+#define PIRANHA_DETAIL_VECTOR_KERNELS_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+#include "../config.hpp"
+#include "../exceptions.hpp"
+
+// NOTE: the x86 kernels rely on the target function attribute, which allows to compile AVX2/AVX-512 code
+// without passing -mavx2 & co. to the compiler, and on __builtin_cpu_supports() for the runtime selection
+// of the instruction set. Both are available in GCC >= 4.9 and in clang >= 3.8.
+#if defined(__x86_64__)                                                                                                \
+    && ((defined(PIRANHA_COMPILER_IS_GCC) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)))                 \
+        || (defined(__clang__) && (__clang_major__ > 3 || (__clang_major__ == 3 && __clang_minor__ >= 8))))
+
+#define PIRANHA_HAVE_X86_VECTOR_KERNELS
+
+#include <immintrin.h>
+
+#define PIRANHA_VK_AVX2 __attribute__((target("avx2")))
+#define PIRANHA_VK_AVX512 __attribute__((target("avx2,avx512f,avx512bw")))
+
+#endif
+
+// NOTE: the floating-point multiply-accumulate kernel must give the same results as
+// math::multiply_accumulate(), which uses a fused operation only under these conditions.
+#if defined(FP_FAST_FMA) && defined(FP_FAST_FMAF) && defined(FP_FAST_FMAL)
+
+#define PIRANHA_VK_FUSED_FMA
+
+#endif
+
+namespace piranha
+{
+
+namespace detail
+{
+
+// Instruction sets that can be used by the vector kernels, in increasing order of capability.
+enum class vk_isa { scalar = 0, avx2 = 1, avx512 = 2 };
+
+inline vk_isa vk_detect_isa()
+{
+#if defined(PIRANHA_HAVE_X86_VECTOR_KERNELS)
+    // NOTE: this might be called during static initialisation, before the constructor in libgcc
+    // which sets up the CPU model has had the chance to run.
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) {
+        return vk_isa::avx512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return vk_isa::avx2;
+    }
+#endif
+    return vk_isa::scalar;
+}
+
+// The instruction set detected at startup.
+template <typename = void>
+struct vk_base {
+    static const vk_isa s_isa;
+};
+
+template <typename T>
+const vk_isa vk_base<T>::s_isa = vk_detect_isa();
+
+// The vectorised kernels are available for non-bool integral types up to 32 bits, which covers the exponent
+// types used in practice for unpacked monomials. Addition, subtraction and equality do not depend on the signedness,
+// the degree kernel is available only for signed types.
+template <typename T>
+using vk_enabled = std::integral_constant<bool, std::is_integral<T>::value && !std::is_same<T, bool>::value
+                                                    && (sizeof(T) == 1u || sizeof(T) == 2u || sizeof(T) == 4u)>;
+
+template <typename T>
+using vk_degree_enabled = std::integral_constant<bool, vk_enabled<T>::value && std::is_signed<T>::value>;
+
+// Scalar implementations. These are the fallbacks when no SIMD instruction set is available, and they are used
+// for the remainders of the AVX2 loops.
+template <typename T>
+inline void vk_add_scalar(T *out, const T *a, const T *b, std::size_t n)
+{
+    for (std::size_t i = 0u; i < n; ++i) {
+        out[i] = static_cast<T>(a[i] + b[i]);
+    }
+}
+
+template <typename T>
+inline void vk_sub_scalar(T *out, const T *a, const T *b, std::size_t n)
+{
+    for (std::size_t i = 0u; i < n; ++i) {
+        out[i] = static_cast<T>(a[i] - b[i]);
+    }
+}
+
+template <typename T>
+inline bool vk_equal_scalar(const T *a, const T *b, std::size_t n)
+{
+    return std::equal(a, a + n, b);
+}
+
+template <typename T>
+inline bool vk_is_zero_scalar(const T *a, std::size_t n)
+{
+    return std::all_of(a, a + n, [](const T &x) { return x == T(0); });
+}
+
+template <typename T>
+inline std::int_least64_t vk_sum_scalar(const T *a, std::size_t n)
+{
+    std::int_least64_t retval = 0;
+    for (std::size_t i = 0u; i < n; ++i) {
+        retval += a[i];
+    }
+    return retval;
+}
+
+template <typename T>
+inline void vk_minmax_scalar(T *mins, T *maxs, const T *a, std::size_t n)
+{
+    for (std::size_t i = 0u; i < n; ++i) {
+        mins[i] = a[i] < mins[i] ? a[i] : mins[i];
+        maxs[i] = a[i] > maxs[i] ? a[i] : maxs[i];
+    }
+}
+
+inline void vk_fma_scalar(double *acc, double a, const double *b, std::size_t n)
+{
+    for (std::size_t i = 0u; i < n; ++i) {
+#if defined(PIRANHA_VK_FUSED_FMA)
+        acc[i] = std::fma(a, b[i], acc[i]);
+#else
+        acc[i] += a * b[i];
+#endif
+    }
+}
+
+#if defined(PIRANHA_HAVE_X86_VECTOR_KERNELS)
+
+// Per-width AVX2 lane operations.
+template <std::size_t>
+struct vk_avx2_ops;
+
+template <>
+struct vk_avx2_ops<1u> {
+    PIRANHA_VK_AVX2 static __m256i add(__m256i a, __m256i b)
+    {
+        return _mm256_add_epi8(a, b);
+    }
+    PIRANHA_VK_AVX2 static __m256i sub(__m256i a, __m256i b)
+    {
+        return _mm256_sub_epi8(a, b);
+    }
+    template <bool Signed>
+    PIRANHA_VK_AVX2 static __m256i min(__m256i a, __m256i b)
+    {
+        return Signed ? _mm256_min_epi8(a, b) : _mm256_min_epu8(a, b);
+    }
+    template <bool Signed>
+    PIRANHA_VK_AVX2 static __m256i max(__m256i a, __m256i b)
+    {
+        return Signed ? _mm256_max_epi8(a, b) : _mm256_max_epu8(a, b);
+    }
+    // Sum of 16 signed bytes, widened to 4 64-bit lanes.
+    PIRANHA_VK_AVX2 static __m256i widen_sum(const void *p)
+    {
+        const __m256i w = _mm256_cvtepi8_epi16(_mm_loadu_si128(static_cast<const __m128i *>(p)));
+        const __m256i s32 = _mm256_madd_epi16(w, _mm256_set1_epi16(1));
+        return _mm256_add_epi64(_mm256_cvtepi32_epi64(_mm256_castsi256_si128(s32)),
+                                _mm256_cvtepi32_epi64(_mm256_extracti128_si256(s32, 1)));
+    }
+    static const std::size_t widen_step = 16u;
+};
+
+template <>
+struct vk_avx2_ops<2u> {
+    PIRANHA_VK_AVX2 static __m256i add(__m256i a, __m256i b)
+    {
+        return _mm256_add_epi16(a, b);
+    }
+    PIRANHA_VK_AVX2 static __m256i sub(__m256i a, __m256i b)
+    {
+        return _mm256_sub_epi16(a, b);
+    }
+    template <bool Signed>
+    PIRANHA_VK_AVX2 static __m256i min(__m256i a, __m256i b)
+    {
+        return Signed ? _mm256_min_epi16(a, b) : _mm256_min_epu16(a, b);
+    }
+    template <bool Signed>
+    PIRANHA_VK_AVX2 static __m256i max(__m256i a, __m256i b)
+    {
+        return Signed ? _mm256_max_epi16(a, b) : _mm256_max_epu16(a, b);
+    }
+    // Sum of 16 signed shorts, widened to 4 64-bit lanes.
+    PIRANHA_VK_AVX2 static __m256i widen_sum(const void *p)
+    {
+        const __m256i s32
+            = _mm256_madd_epi16(_mm256_loadu_si256(static_cast<const __m256i *>(p)), _mm256_set1_epi16(1));
+        return _mm256_add_epi64(_mm256_cvtepi32_epi64(_mm256_castsi256_si128(s32)),
+                                _mm256_cvtepi32_epi64(_mm256_extracti128_si256(s32, 1)));
+    }
+    static const std::size_t widen_step = 16u;
+};
+
+template <>
+struct vk_avx2_ops<4u> {
+    PIRANHA_VK_AVX2 static __m256i add(__m256i a, __m256i b)
+    {
+        return _mm256_add_epi32(a, b);
+    }
+    PIRANHA_VK_AVX2 static __m256i sub(__m256i a, __m256i b)
+    {
+        return _mm256_sub_epi32(a, b);
+    }
+    template <bool Signed>
+    PIRANHA_VK_AVX2 static __m256i min(__m256i a, __m256i b)
+    {
+        return Signed ? _mm256_min_epi32(a, b) : _mm256_min_epu32(a, b);
+    }
+    template <bool Signed>
+    PIRANHA_VK_AVX2 static __m256i max(__m256i a, __m256i b)
+    {
+        return Signed ? _mm256_max_epi32(a, b) : _mm256_max_epu32(a, b);
+    }
+    // Sum of 4 signed ints, widened to 4 64-bit lanes.
+    PIRANHA_VK_AVX2 static __m256i widen_sum(const void *p)
+    {
+        return _mm256_cvtepi32_epi64(_mm_loadu_si128(static_cast<const __m128i *>(p)));
+    }
+    static const std::size_t widen_step = 4u;
+};
+
+template <typename T>
+PIRANHA_VK_AVX2 inline void vk_add_avx2(T *out, const T *a, const T *b, std::size_t n)
+{
+    constexpr std::size_t lanes = 32u / sizeof(T);
+    std::size_t i = 0u;
+    for (; i + lanes <= n; i += lanes) {
+        const __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i));
+        const __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), vk_avx2_ops<sizeof(T)>::add(va, vb));
+    }
+    vk_add_scalar(out + i, a + i, b + i, n - i);
+}
+
+template <typename T>
+PIRANHA_VK_AVX2 inline void vk_sub_avx2(T *out, const T *a, const T *b, std::size_t n)
+{
+    constexpr std::size_t lanes = 32u / sizeof(T);
+    std::size_t i = 0u;
+    for (; i + lanes <= n; i += lanes) {
+        const __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i));
+        const __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), vk_avx2_ops<sizeof(T)>::sub(va, vb));
+    }
+    vk_sub_scalar(out + i, a + i, b + i, n - i);
+}
+
+// NOTE: equality and zero testing are bitwise, so they do not depend on the width of the elements.
+template <typename T>
+PIRANHA_VK_AVX2 inline bool vk_equal_avx2(const T *a, const T *b, std::size_t n)
+{
+    constexpr std::size_t lanes = 32u / sizeof(T);
+    std::size_t i = 0u;
+    for (; i + lanes <= n; i += lanes) {
+        const __m256i x = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i)),
+                                           _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + i)));
+        if (!_mm256_testz_si256(x, x)) {
+            return false;
+        }
+    }
+    return vk_equal_scalar(a + i, b + i, n - i);
+}
+
+template <typename T>
+PIRANHA_VK_AVX2 inline bool vk_is_zero_avx2(const T *a, std::size_t n)
+{
+    constexpr std::size_t lanes = 32u / sizeof(T);
+    std::size_t i = 0u;
+    for (; i + lanes <= n; i += lanes) {
+        const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i));
+        if (!_mm256_testz_si256(x, x)) {
+            return false;
+        }
+    }
+    return vk_is_zero_scalar(a + i, n - i);
+}
+
+template <typename T>
+PIRANHA_VK_AVX2 inline std::int_least64_t vk_sum_avx2(const T *a, std::size_t n)
+{
+    constexpr std::size_t step = vk_avx2_ops<sizeof(T)>::widen_step;
+    __m256i acc = _mm256_setzero_si256();
+    std::size_t i = 0u;
+    for (; i + step <= n; i += step) {
+        acc = _mm256_add_epi64(acc, vk_avx2_ops<sizeof(T)>::widen_sum(a + i));
+    }
+    std::int64_t tmp[4];
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(tmp), acc);
+    return static_cast<std::int_least64_t>(tmp[0] + tmp[1] + tmp[2] + tmp[3]) + vk_sum_scalar(a + i, n - i);
+}
+
+template <typename T>
+PIRANHA_VK_AVX2 inline void vk_minmax_avx2(T *mins, T *maxs, const T *a, std::size_t n)
+{
+    using ops = vk_avx2_ops<sizeof(T)>;
+    constexpr bool s = std::is_signed<T>::value;
+    constexpr std::size_t lanes = 32u / sizeof(T);
+    std::size_t i = 0u;
+    for (; i + lanes <= n; i += lanes) {
+        const __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i));
+        auto pmin = reinterpret_cast<__m256i *>(mins + i), pmax = reinterpret_cast<__m256i *>(maxs + i);
+        _mm256_storeu_si256(pmin, ops::template min<s>(_mm256_loadu_si256(pmin), va));
+        _mm256_storeu_si256(pmax, ops::template max<s>(_mm256_loadu_si256(pmax), va));
+    }
+    vk_minmax_scalar(mins + i, maxs + i, a + i, n - i);
+}
+
+// NOTE: if PIRANHA_VK_FUSED_FMA is defined, the FMA instruction set is enabled for the whole translation unit.
+PIRANHA_VK_AVX2 inline void vk_fma_avx2(double *acc, double a, const double *b, std::size_t n)
+{
+    const __m256d va = _mm256_set1_pd(a);
+    std::size_t i = 0u;
+    for (; i + 4u <= n; i += 4u) {
+        const __m256d vb = _mm256_loadu_pd(b + i), vacc = _mm256_loadu_pd(acc + i);
+#if defined(PIRANHA_VK_FUSED_FMA)
+        _mm256_storeu_pd(acc + i, _mm256_fmadd_pd(va, vb, vacc));
+#else
+        _mm256_storeu_pd(acc + i, _mm256_add_pd(vacc, _mm256_mul_pd(va, vb)));
+#endif
+    }
+    vk_fma_scalar(acc + i, a, b + i, n - i);
+}
+
+// Per-width AVX-512 masked lane operations. With masked loads and stores the remainders are handled
+// without falling back to scalar code.
+template <std::size_t>
+struct vk_avx512_ops;
+
+template <>
+struct vk_avx512_ops<1u> {
+    using mask_type = __mmask64;
+    PIRANHA_VK_AVX512 static __m512i load(mask_type m, const void *p)
+    {
+        return _mm512_maskz_loadu_epi8(m, p);
+    }
+    PIRANHA_VK_AVX512 static void store(void *p, mask_type m, __m512i x)
+    {
+        _mm512_mask_storeu_epi8(p, m, x);
+    }
+    PIRANHA_VK_AVX512 static __m512i add(__m512i a, __m512i b)
+    {
+        return _mm512_add_epi8(a, b);
+    }
+    PIRANHA_VK_AVX512 static __m512i sub(__m512i a, __m512i b)
+    {
+        return _mm512_sub_epi8(a, b);
+    }
+    PIRANHA_VK_AVX512 static mask_type neq(mask_type m, __m512i a, __m512i b)
+    {
+        return _mm512_mask_cmpneq_epi8_mask(m, a, b);
+    }
+};
+
+template <>
+struct vk_avx512_ops<2u> {
+    using mask_type = __mmask32;
+    PIRANHA_VK_AVX512 static __m512i load(mask_type m, const void *p)
+    {
+        return _mm512_maskz_loadu_epi16(m, p);
+    }
+    PIRANHA_VK_AVX512 static void store(void *p, mask_type m, __m512i x)
+    {
+        _mm512_mask_storeu_epi16(p, m, x);
+    }
+    PIRANHA_VK_AVX512 static __m512i add(__m512i a, __m512i b)
+    {
+        return _mm512_add_epi16(a, b);
+    }
+    PIRANHA_VK_AVX512 static __m512i sub(__m512i a, __m512i b)
+    {
+        return _mm512_sub_epi16(a, b);
+    }
+    PIRANHA_VK_AVX512 static mask_type neq(mask_type m, __m512i a, __m512i b)
+    {
+        return _mm512_mask_cmpneq_epi16_mask(m, a, b);
+    }
+};
+
+template <>
+struct vk_avx512_ops<4u> {
+    using mask_type = __mmask16;
+    PIRANHA_VK_AVX512 static __m512i load(mask_type m, const void *p)
+    {
+        return _mm512_maskz_loadu_epi32(m, p);
+    }
+    PIRANHA_VK_AVX512 static void store(void *p, mask_type m, __m512i x)
+    {
+        _mm512_mask_storeu_epi32(p, m, x);
+    }
+    PIRANHA_VK_AVX512 static __m512i add(__m512i a, __m512i b)
+    {
+        return _mm512_add_epi32(a, b);
+    }
+    PIRANHA_VK_AVX512 static __m512i sub(__m512i a, __m512i b)
+    {
+        return _mm512_sub_epi32(a, b);
+    }
+    PIRANHA_VK_AVX512 static mask_type neq(mask_type m, __m512i a, __m512i b)
+    {
+        return _mm512_mask_cmpneq_epi32_mask(m, a, b);
+    }
+};
+
+// Mask selecting the first n lanes (n can be larger than the number of lanes).
+template <std::size_t Size>
+inline typename vk_avx512_ops<Size>::mask_type vk_avx512_mask(std::size_t n)
+{
+    using mask_type = typename vk_avx512_ops<Size>::mask_type;
+    constexpr std::size_t lanes = 64u / Size;
+    return n >= lanes ? static_cast<mask_type>(~std::uint64_t(0))
+                      : static_cast<mask_type>((std::uint64_t(1) << n) - std::uint64_t(1));
+}
+
+template <typename T>
+PIRANHA_VK_AVX512 inline void vk_add_avx512(T *out, const T *a, const T *b, std::size_t n)
+{
+    using ops = vk_avx512_ops<sizeof(T)>;
+    constexpr std::size_t lanes = 64u / sizeof(T);
+    for (std::size_t i = 0u; i < n; i += lanes) {
+        const auto m = vk_avx512_mask<sizeof(T)>(n - i);
+        ops::store(out + i, m, ops::add(ops::load(m, a + i), ops::load(m, b + i)));
+    }
+}
+
+template <typename T>
+PIRANHA_VK_AVX512 inline void vk_sub_avx512(T *out, const T *a, const T *b, std::size_t n)
+{
+    using ops = vk_avx512_ops<sizeof(T)>;
+    constexpr std::size_t lanes = 64u / sizeof(T);
+    for (std::size_t i = 0u; i < n; i += lanes) {
+        const auto m = vk_avx512_mask<sizeof(T)>(n - i);
+        ops::store(out + i, m, ops::sub(ops::load(m, a + i), ops::load(m, b + i)));
+    }
+}
+
+template <typename T>
+PIRANHA_VK_AVX512 inline bool vk_equal_avx512(const T *a, const T *b, std::size_t n)
+{
+    using ops = vk_avx512_ops<sizeof(T)>;
+    constexpr std::size_t lanes = 64u / sizeof(T);
+    for (std::size_t i = 0u; i < n; i += lanes) {
+        const auto m = vk_avx512_mask<sizeof(T)>(n - i);
+        if (ops::neq(m, ops::load(m, a + i), ops::load(m, b + i))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename T>
+PIRANHA_VK_AVX512 inline bool vk_is_zero_avx512(const T *a, std::size_t n)
+{
+    using ops = vk_avx512_ops<sizeof(T)>;
+    constexpr std::size_t lanes = 64u / sizeof(T);
+    for (std::size_t i = 0u; i < n; i += lanes) {
+        const auto m = vk_avx512_mask<sizeof(T)>(n - i);
+        if (ops::neq(m, ops::load(m, a + i), _mm512_setzero_si512())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+PIRANHA_VK_AVX512 inline void vk_fma_avx512(double *acc, double a, const double *b, std::size_t n)
+{
+    const __m512d va = _mm512_set1_pd(a);
+    for (std::size_t i = 0u; i < n; i += 8u) {
+        const auto m = static_cast<__mmask8>(n - i >= 8u ? 0xffu : (1u << (n - i)) - 1u);
+        const __m512d vb = _mm512_maskz_loadu_pd(m, b + i), vacc = _mm512_maskz_loadu_pd(m, acc + i);
+#if defined(PIRANHA_VK_FUSED_FMA)
+        _mm512_mask_storeu_pd(acc + i, m, _mm512_fmadd_pd(va, vb, vacc));
+#else
+        _mm512_mask_storeu_pd(acc + i, m, _mm512_add_pd(vacc, _mm512_mul_pd(va, vb)));
+#endif
+    }
+}
+
+#endif
+
+// Dispatching functions. The isa argument defaults to the instruction set detected at startup, and it is
+// capped to it: passing an explicit value is useful to exercise the lesser implementations.
+inline vk_isa vk_cap_isa(vk_isa isa)
+{
+    return static_cast<int>(isa) > static_cast<int>(vk_base<>::s_isa) ? vk_base<>::s_isa : isa;
+}
+
+// Ranges shorter than an AVX2 register would go through the scalar remainder loops of the SIMD kernels anyway,
+// after paying for the dispatch and for a call that cannot be inlined. They are very common (e.g., the exponents
+// of a monomial in a few variables), so the dispatching functions hand them to the scalar implementations directly.
+template <typename T>
+inline bool vk_is_short(std::size_t n)
+{
+    return n < 32u / sizeof(T);
+}
+
+// out = a + b, element-wise, wrapping around on overflow. out may coincide with a and/or b.
+template <typename T, typename std::enable_if<vk_enabled<T>::value, int>::type = 0>
+inline void vk_add(T *out, const T *a, const T *b, std::size_t n, vk_isa isa = vk_base<>::s_isa)
+{
+#if defined(PIRANHA_HAVE_X86_VECTOR_KERNELS)
+    if (!vk_is_short<T>(n)) {
+        switch (vk_cap_isa(isa)) {
+            case vk_isa::avx512:
+                vk_add_avx512(out, a, b, n);
+                return;
+            case vk_isa::avx2:
+                vk_add_avx2(out, a, b, n);
+                return;
+            case vk_isa::scalar:
+                break;
+        }
+    }
+#else
+    (void)isa;
+#endif
+    vk_add_scalar(out, a, b, n);
+}
+
+// out = a - b, element-wise, wrapping around on overflow. out may coincide with a and/or b.
+template <typename T, typename std::enable_if<vk_enabled<T>::value, int>::type = 0>
+inline void vk_sub(T *out, const T *a, const T *b, std::size_t n, vk_isa isa = vk_base<>::s_isa)
+{
+#if defined(PIRANHA_HAVE_X86_VECTOR_KERNELS)
+    if (!vk_is_short<T>(n)) {
+        switch (vk_cap_isa(isa)) {
+            case vk_isa::avx512:
+                vk_sub_avx512(out, a, b, n);
+                return;
+            case vk_isa::avx2:
+                vk_sub_avx2(out, a, b, n);
+                return;
+            case vk_isa::scalar:
+                break;
+        }
+    }
+#else
+    (void)isa;
+#endif
+    vk_sub_scalar(out, a, b, n);
+}
+
+// Element-wise equality of the ranges [a, a + n) and [b, b + n).
+template <typename T, typename std::enable_if<vk_enabled<T>::value, int>::type = 0>
+inline bool vk_equal(const T *a, const T *b, std::size_t n, vk_isa isa = vk_base<>::s_isa)
+{
+#if defined(PIRANHA_HAVE_X86_VECTOR_KERNELS)
+    if (!vk_is_short<T>(n)) {
+        switch (vk_cap_isa(isa)) {
+            case vk_isa::avx512:
+                return vk_equal_avx512(a, b, n);
+            case vk_isa::avx2:
+                return vk_equal_avx2(a, b, n);
+            case vk_isa::scalar:
+                break;
+        }
+    }
+#else
+    (void)isa;
+#endif
+    return vk_equal_scalar(a, b, n);
+}
+
+// Overload for all the other types, so that containers can call vk_equal() unconditionally.
+template <typename T, typename std::enable_if<!vk_enabled<T>::value, int>::type = 0>
+inline bool vk_equal(const T *a, const T *b, std::size_t n, vk_isa = vk_base<>::s_isa)
+{
+    return std::equal(a, a + n, b);
+}
+
+// Check if all the elements in [a, a + n) are zero.
+template <typename T, typename std::enable_if<vk_enabled<T>::value, int>::type = 0>
+inline bool vk_is_zero(const T *a, std::size_t n, vk_isa isa = vk_base<>::s_isa)
+{
+#if defined(PIRANHA_HAVE_X86_VECTOR_KERNELS)
+    if (!vk_is_short<T>(n)) {
+        switch (vk_cap_isa(isa)) {
+            case vk_isa::avx512:
+                return vk_is_zero_avx512(a, n);
+            case vk_isa::avx2:
+                return vk_is_zero_avx2(a, n);
+            case vk_isa::scalar:
+                break;
+        }
+    }
+#else
+    (void)isa;
+#endif
+    return vk_is_zero_scalar(a, n);
+}
+
+// Sum of the elements in [a, a + n), computed exactly in 64-bit arithmetic and then checked against the range
+// of the return type U. This is used for the computation of the degree of monomials: the sum of up to
+// 2**32 values of at most 32 bits cannot overflow a 64-bit integer.
+// NOTE: the AVX-512 implementation would not be any faster than the AVX2 one for the typical sizes,
+// as the widening is the bottleneck.
+template <typename U, typename T, typename std::enable_if<vk_degree_enabled<T>::value, int>::type = 0>
+inline U vk_checked_sum(const T *a, std::size_t n, vk_isa isa = vk_base<>::s_isa)
+{
+    static_assert(std::is_integral<U>::value && std::is_signed<U>::value && sizeof(U) <= 8u, "Invalid return type.");
+    std::int_least64_t retval;
+#if defined(PIRANHA_HAVE_X86_VECTOR_KERNELS)
+    if (!vk_is_short<T>(n) && vk_cap_isa(isa) != vk_isa::scalar && n < (std::size_t(1) << 32u)) {
+        retval = vk_sum_avx2(a, n);
+    } else {
+        retval = vk_sum_scalar(a, n);
+    }
+#else
+    (void)isa;
+    retval = vk_sum_scalar(a, n);
+#endif
+    if (unlikely(retval > std::numeric_limits<U>::max() || retval < std::numeric_limits<U>::min())) {
+        piranha_throw(std::overflow_error, "overflow in the summation of signed integrals");
+    }
+    return static_cast<U>(retval);
+}
+
+// acc[i] += a * b[i], with the same rounding as math::multiply_accumulate() on doubles (that is, fused
+// if and only if PIRANHA_VK_FUSED_FMA is defined). acc and b must not overlap.
+inline void vk_fma(double *acc, double a, const double *b, std::size_t n, vk_isa isa = vk_base<>::s_isa)
+{
+#if defined(PIRANHA_HAVE_X86_VECTOR_KERNELS)
+    if (!vk_is_short<double>(n)) {
+        switch (vk_cap_isa(isa)) {
+            case vk_isa::avx512:
+                vk_fma_avx512(acc, a, b, n);
+                return;
+            case vk_isa::avx2:
+                vk_fma_avx2(acc, a, b, n);
+                return;
+            case vk_isa::scalar:
+                break;
+        }
+    }
+#else
+    (void)isa;
+#endif
+    vk_fma_scalar(acc, a, b, n);
+}
+
+// Update the element-wise minimum and maximum vectors mins and maxs with the values in [a, a + n).
+template <typename T, typename std::enable_if<vk_enabled<T>::value, int>::type = 0>
+inline void vk_minmax(T *mins, T *maxs, const T *a, std::size_t n, vk_isa isa = vk_base<>::s_isa)
+{
+#if defined(PIRANHA_HAVE_X86_VECTOR_KERNELS)
+    if (!vk_is_short<T>(n) && vk_cap_isa(isa) != vk_isa::scalar) {
+        vk_minmax_avx2(mins, maxs, a, n);
+        return;
+    }
+#else
+    (void)isa;
+#endif
+    vk_minmax_scalar(mins, maxs, a, n);
+}
+}
+}
+
+#endif
@@ -372,6 +372,15 @@ private:
         // For integer exponents, just do normal addition.
         a += b;
     }
+    // Remove the first term, returning its aij and exponent. Used in divisor_series.
+    std::pair<v_type, value_type> pop_first()
+    {
+        piranha_assert(m_container.size() != 0u);
+        const auto it = m_container.begin();
+        std::pair<v_type, value_type> retval(it->v, it->e);
+        m_container.erase(it);
+        return retval;
+    }
     // Enabler for insertion.
     template <typename It, typename Exponent>
     using insert_enabler =
@@ -47,6 +47,7 @@ see https://www.gnu.org/licenses/. */
 #include "ipow_substitutable_series.hpp"
 #include "is_cf.hpp"
 #include "key_is_multipliable.hpp"
+#include "kronecker_divisor.hpp"
 #include "math.hpp"
 #include "mp_integer.hpp"
 #include "power_series.hpp"
@@ -77,6 +78,11 @@ struct is_divisor_series_key<divisor<T>> {
     static const bool value = true;
 };
 
+template <typename T>
+struct is_divisor_series_key<kronecker_divisor<T>> {
+    static const bool value = true;
+};
+
 // See the workaround description below.
 template <typename T>
 struct base_getter {
@@ -86,13 +92,13 @@ struct base_getter {
 
 /// Divisor series.
 /**
- * This class represents series in which the keys are divisor (see piranha::divisor) and the coefficient type
- * is generic. This class satisfies the piranha::is_series and piranha::is_cf type traits.
+ * This class represents series in which the keys are divisors (see piranha::divisor and piranha::kronecker_divisor)
+ * and the coefficient type is generic. This class satisfies the piranha::is_series and piranha::is_cf type traits.
  *
  * ## Type requirements ##
  *
  * \p Cf must be suitable for use in piranha::series as first template argument, \p Key must be an instance
- * of piranha::divisor.
+ * of piranha::divisor or piranha::kronecker_divisor.
  *
  * ## Exception safety guarantee ##
  *
@@ -173,27 +179,20 @@ class divisor_series
         using cf_type = typename term_type::cf_type;
         using key_type = typename term_type::key_type;
         piranha_assert(key.size() != 0u);
-        // Construct the first part of the derivative.
-        key_type tmp_div;
-        // Insert all the terms that depend on the variable, apart from the
-        // first one.
-        const auto it_f = key.m_container.end();
-        auto it = key.m_container.begin(), it_b(it);
-        auto first(*it), first_copy(*it);
+        // Remove the first term from the original key, extracting its aij and exponent.
+        const auto first = key.pop_first();
+        const auto &first_v = first.first;
+        const auto &first_e = first.second;
         // Size type of the multipliers' vector.
-        using vs_type = decltype(first.v.size());
-        ++it;
-        for (; it != it_f; ++it) {
-            tmp_div.m_container.insert(*it);
-        }
-        // Remove the first term from the original key.
-        key.m_container.erase(it_b);
-        // Extract from the first dependent term the aij and the exponent, and multiply+negate them.
-        const auto mult = safe_mult(first.e, first.v[static_cast<vs_type>(pos.back())]);
-        // Increase by one the exponent of the first dep. term.
-        expo_increase(first.e);
-        // Insert the modified first term. Don't move, as we need first below.
-        tmp_div.m_container.insert(first);
+        using vs_type = typename std::decay<decltype(first_v)>::type::size_type;
+        // Multiply+negate the aij and the exponent.
+        const auto mult = safe_mult(first_e, first_v[static_cast<vs_type>(pos.back())]);
+        // Construct the first part of the derivative: all the remaining terms, plus the first
+        // term with the exponent increased by one.
+        key_type tmp_div(key);
+        auto first_e_inc(first_e);
+        expo_increase(first_e_inc);
+        tmp_div.insert(first_v.begin(), first_v.end(), first_e_inc);
         // Now build the first part of the derivative.
         divisor_series tmp_ds;
         tmp_ds.set_symbol_set(this->m_symbol_set);
@@ -201,10 +200,10 @@ class divisor_series
         // Init the retval.
         d_partial_type<T> retval(mult * tmp_ds);
         // Now the second part of the derivative, if appropriate.
-        if (!key.m_container.empty()) {
+        if (key.size() != 0u) {
             // Build a series with only the first dependent term and unitary coefficient.
             key_type tmp_div_01;
-            tmp_div_01.m_container.insert(std::move(first_copy));
+            tmp_div_01.insert(first_v.begin(), first_v.end(), first_e);
             divisor_series tmp_ds_01;
             tmp_ds_01.set_symbol_set(this->m_symbol_set);
             tmp_ds_01.insert(term_type(cf_type(1), std::move(tmp_div_01)));
@@ -519,18 +518,11 @@ public:
         // Turn name into symbol position.
         const symbol_set::positions pos(this->m_symbol_set, symbol_set{symbol(name)});
         for (auto it = this->m_container.begin(); it != it_f; ++it) {
-            if (pos.size() == 1u) {
-                // If the variable is in the symbol set, then we need to make sure
-                // that each multiplier associated to it is zero. Otherwise, the divisor
-                // depends on the variable and we cannot perform the integration.
-                const auto it2_f = it->m_key.m_container.end();
-                for (auto it2 = it->m_key.m_container.begin(); it2 != it2_f; ++it2) {
-                    using size_type = decltype(it2->v.size());
-                    piranha_assert(pos.back() < it2->v.size());
-                    if (unlikely(it2->v[static_cast<size_type>(pos.back())] != 0)) {
-                        piranha_throw(std::invalid_argument, "unable to integrate with respect to divisor variables");
-                    }
-                }
+            // If the variable is in the symbol set, then we need to make sure
+            // that each multiplier associated to it is zero. Otherwise, the divisor
+            // depends on the variable and we cannot perform the integration.
+            if (pos.size() == 1u && unlikely(it->m_key.split(pos, this->m_symbol_set).first.size() != 0u)) {
+                piranha_throw(std::invalid_argument, "unable to integrate with respect to divisor variables");
             }
             divisor_series tmp;
             tmp.set_symbol_set(this->m_symbol_set);
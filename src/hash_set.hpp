@@ -54,11 +54,70 @@ see https://www.gnu.org/licenses/. */
 #include "s11n.hpp"
 #include "safe_cast.hpp"
 #include "thread_pool.hpp"
+#include "tracer.hpp"
 #include "type_traits.hpp"
 
 namespace piranha
 {
 
+namespace detail
+{
+
+#if defined(PIRANHA_HAVE_THREAD_LOCAL)
+
+// Rehash counting, used by the multiplication statistics: the rehashes of the hash set at address s_target performed
+// in the current thread increase *s_counter. The target is only compared, never dereferenced.
+template <typename = void>
+struct hash_set_rehash_tracking {
+    static thread_local const void *s_target;
+    static thread_local unsigned long long *s_counter;
+};
+
+template <typename T>
+thread_local const void *hash_set_rehash_tracking<T>::s_target = nullptr;
+
+template <typename T>
+thread_local unsigned long long *hash_set_rehash_tracking<T>::s_counter = nullptr;
+
+#endif
+
+// RAII class to count the rehashes of a hash set in the current thread (see above). The previous target is restored
+// on destruction, so that trackers can be nested. Without thread-local storage, nothing is counted.
+class hash_set_rehash_tracker
+{
+public:
+    explicit hash_set_rehash_tracker(const void *target, unsigned long long *counter)
+    {
+#if defined(PIRANHA_HAVE_THREAD_LOCAL)
+        m_old_target = hash_set_rehash_tracking<>::s_target;
+        m_old_counter = hash_set_rehash_tracking<>::s_counter;
+        hash_set_rehash_tracking<>::s_target = target;
+        hash_set_rehash_tracking<>::s_counter = counter;
+#else
+        (void)target;
+        (void)counter;
+#endif
+    }
+    hash_set_rehash_tracker(const hash_set_rehash_tracker &) = delete;
+    hash_set_rehash_tracker(hash_set_rehash_tracker &&) = delete;
+    hash_set_rehash_tracker &operator=(const hash_set_rehash_tracker &) = delete;
+    hash_set_rehash_tracker &operator=(hash_set_rehash_tracker &&) = delete;
+    ~hash_set_rehash_tracker()
+    {
+#if defined(PIRANHA_HAVE_THREAD_LOCAL)
+        hash_set_rehash_tracking<>::s_target = m_old_target;
+        hash_set_rehash_tracking<>::s_counter = m_old_counter;
+#endif
+    }
+
+private:
+#if defined(PIRANHA_HAVE_THREAD_LOCAL)
+    const void *m_old_target;
+    unsigned long long *m_old_counter;
+#endif
+};
+}
+
 /// Hash set.
 /**
  * Hash set class with interface similar to \p std::unordered_set. The main points of difference with respect to
@@ -515,20 +574,18 @@ private:
             };
             // Work per thread.
             const auto wpt = size / n_threads;
-            future_list<decltype(thread_function(0u, 0u, 0u))> f_list;
             try {
-                for (unsigned i = 0u; i < n_threads; ++i) {
-                    const auto start = static_cast<size_type>(wpt * i),
-                               end = static_cast<size_type>((i == n_threads - 1u) ? size : wpt * (i + 1u));
-                    f_list.push_back(thread_pool::enqueue(i, thread_function, start, end, i));
-                }
-                f_list.wait_all();
-                // NOTE: no need to get_all() here, as we know no exceptions will be generated inside thread_func.
+                thread_pool::parallel_for(0u, n_threads, 1u, [&](std::size_t i_start, std::size_t i_end) {
+                    for (auto j = i_start; j != i_end; ++j) {
+                        const auto i = static_cast<unsigned>(j);
+                        const auto start = static_cast<size_type>(wpt * i),
+                                   end = static_cast<size_type>((i == n_threads - 1u) ? size : wpt * (i + 1u));
+                        thread_function(start, end, i);
+                    }
+                });
             } catch (...) {
-                // NOTE: everything in thread_func is noexcept, if we are here the exception was thrown by enqueue or
-                // push_back.
-                // Wait for everything to wind down.
-                f_list.wait_all();
+                // NOTE: everything in thread_func is noexcept, if we are here the exception was thrown by
+                // parallel_for(), which waits for the submitted tasks before re-throwing.
                 // Destroy what was constructed.
                 for (const auto &r : constructed_ranges) {
                     for (size_type i = r.first; i != r.second; ++i) {
@@ -697,7 +754,7 @@ public:
      * @throws std::invalid_argument if \p n_threads is zero.
      * @throws unspecified any exception thrown by:
      * - the copy constructors of <tt>Hash</tt> or <tt>Pred</tt>,
-     * - piranha::thread_pool::enqueue() or piranha::future_list::push_back(), if \p n_threads is not 1.
+     * - piranha::thread_pool::parallel_for(), if \p n_threads is not 1.
      */
     explicit hash_set(const size_type &n_buckets, const hasher &h = hasher{}, const key_equal &k = key_equal{},
                       unsigned n_threads = 1u)
@@ -1144,6 +1201,7 @@ public:
         if (unlikely(!n_threads)) {
             piranha_throw(std::invalid_argument, "the number of threads must be strictly positive");
         }
+        trace_scope ts("rehash", "hash_set");
         // If rehash is requested to zero, do something only if there are no items stored in the set.
         if (!new_size) {
             if (!size()) {
@@ -1175,6 +1233,11 @@ public:
         clear();
         // Assign the new set.
         *this = std::move(new_set);
+#if defined(PIRANHA_HAVE_THREAD_LOCAL)
+        if (unlikely(detail::hash_set_rehash_tracking<>::s_target == this)) {
+            ++*detail::hash_set_rehash_tracking<>::s_counter;
+        }
+#endif
     }
     /// Get information on the sparsity of the set.
     /**
@@ -1197,6 +1260,46 @@ public:
         }
         return retval;
     }
+    /// Get information on the distribution of the elements in zones of buckets.
+    /**
+     * The buckets of the set are divided into \p n_zones contiguous zones of <tt>bucket_count() / n_zones</tt>
+     * buckets each, with the last zone also including the remaining buckets. This is the same partitioning used
+     * by the multithreaded sparse Kronecker multiplication of piranha::polynomial.
+     *
+     * @param[in] n_zones number of zones.
+     *
+     * @return an <tt>std::vector<size_type></tt> of size \p n_zones containing the number of elements stored in each
+     * zone.
+     *
+     * @throws std::invalid_argument if \p n_zones is zero.
+     * @throws unspecified any exception thrown by memory errors in standard containers.
+     */
+    std::vector<size_type> evaluate_zone_occupancy(const size_type &n_zones) const
+    {
+        if (unlikely(!n_zones)) {
+            piranha_throw(std::invalid_argument, "the number of zones must be strictly positive");
+        }
+        std::vector<size_type> retval(safe_cast<typename std::vector<size_type>::size_type>(n_zones), 0u);
+        const auto b_count = bucket_count();
+        const size_type bpz = b_count / n_zones;
+        for (size_type i = 0u; i < b_count; ++i) {
+            const size_type z = (bpz && i / bpz < n_zones) ? (i / bpz) : (n_zones - 1u);
+            for (auto l_it = ptr()[i].begin(); l_it != ptr()[i].end(); ++l_it) {
+                ++retval[static_cast<typename std::vector<size_type>::size_type>(z)];
+            }
+        }
+        return retval;
+    }
+    /// Get the hasher.
+    /**
+     * @return a copy of the hasher used by the set.
+     *
+     * @throws unspecified any exception thrown by the copy constructor of the hasher.
+     */
+    hasher hash_function() const
+    {
+        return hash();
+    }
     /** @name Low-level interface
      * Low-level methods and types.
      */
@@ -1275,6 +1378,23 @@ public:
         auto p = ptr()[bucket_idx].insert(std::forward<U>(k));
         return iterator(this, bucket_idx, local_iterator(p));
     }
+    /// Prefetch bucket (low-level).
+    /**
+     * Hint to the processor that the bucket at index \p bucket_idx is about to be accessed (e.g., via _find()
+     * or _unique_insert()). This method has no effect on compilers which do not provide prefetching intrinsics.
+     * This method will not check if the value of \p bucket_idx is correct.
+     *
+     * @param[in] bucket_idx index of the bucket.
+     */
+    void _prefetch(const size_type &bucket_idx) const
+    {
+        piranha_assert(bucket_idx < bucket_count());
+#if defined(__GNUC__)
+        __builtin_prefetch(static_cast<const void *>(&ptr()[bucket_idx]));
+#else
+        (void)bucket_idx;
+#endif
+    }
     /// Find element (low-level).
     /**
      * Locate element in the set. The parameter \p bucket_idx is the index of the destination bucket for \p k and, for
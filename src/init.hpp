@@ -30,10 +30,14 @@ see https://www.gnu.org/licenses/. */
 #define PIRANHA_INIT_HPP
 
 #include <cstdlib>
+#include <exception>
 #include <iostream>
 
+#include "cost_model.hpp"
 #include "detail/init_data.hpp"
 #include "detail/mpfr.hpp"
+#include "detail/mpz_arena.hpp"
+#include "tuning.hpp"
 
 namespace piranha
 {
@@ -55,7 +59,14 @@ inline void cleanup_function()
 /**
  * This function should be called before accessing any Piranha functionality.
  * It will register cleanup functions that will be run on program exit (e.g.,
- * the MPFR <tt>mpfr_free_cache()</tt> function).
+ * the MPFR <tt>mpfr_free_cache()</tt> function), and it will install the GMP memory functions
+ * used by piranha::mp_integer_arena. Since the GMP memory functions are global and not protected
+ * by any synchronisation, this function must be called before any other thread uses Piranha, GMP or MPFR.
+ *
+ * If the environment variable \p PIRANHA_TUNING_PROFILE is set, the tuning profile it refers to
+ * will be loaded via piranha::tuning::load_profile(). Errors in the loading of the profile are reported
+ * on the standard error stream and they do not interrupt the initialisation. Similarly, if the environment variable
+ * \p PIRANHA_COST_MODEL is set, the cost model it refers to will be loaded via piranha::cost_model_::load().
  *
  * It is allowed to call this function concurrently from multiple threads: after the first
  * invocation, additional invocations will not perform any action.
@@ -92,12 +103,31 @@ inline void init()
         std::cerr.flush();
         std::abort();
     }
+    detail::mpz_arena_install();
     if (!::mpfr_buildopt_tls_p()) {
         // NOTE: logging candidate, we probably want to push
         // this to a warning channel.
         std::cerr << "The MPFR library was not built thread-safe.\n";
         std::cerr.flush();
     }
+    if (const char *profile = std::getenv("PIRANHA_TUNING_PROFILE")) {
+        try {
+            tuning::load_profile(profile);
+            std::cout << "Loaded tuning profile '" << profile << "'.\n";
+        } catch (const std::exception &e) {
+            std::cerr << "Unable to load the tuning profile: " << e.what() << '\n';
+            std::cerr.flush();
+        }
+    }
+    if (const char *model = std::getenv("PIRANHA_COST_MODEL")) {
+        try {
+            cost_model::load(model);
+            std::cout << "Loaded cost model '" << model << "'.\n";
+        } catch (const std::exception &e) {
+            std::cerr << "Unable to load the cost model: " << e.what() << '\n';
+            std::cerr.flush();
+        }
+    }
 }
 }
 
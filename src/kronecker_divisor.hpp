@@ -0,0 +1,1026 @@
+/* Copyright 2009-2016 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#ifndef PIRANHA_KRONECKER_DIVISOR_HPP
+#define PIRANHA_KRONECKER_DIVISOR_HPP
+
+#include <algorithm>
+#include <array>
+#include <boost/functional/hash.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "config.hpp"
+#include "detail/cf_mult_impl.hpp"
+#include "detail/divisor_series_fwd.hpp"
+#include "detail/km_commons.hpp"
+#include "detail/prepare_for_print.hpp"
+#include "exceptions.hpp"
+#include "is_cf.hpp"
+#include "is_key.hpp"
+#include "kronecker_array.hpp"
+#include "math.hpp"
+#include "pow.hpp"
+#include "s11n.hpp"
+#include "safe_cast.hpp"
+#include "small_vector.hpp"
+#include "static_vector.hpp"
+#include "symbol_set.hpp"
+#include "term.hpp"
+#include "type_traits.hpp"
+
+namespace piranha
+{
+
+// Fwd declaration.
+template <typename>
+class kronecker_divisor;
+}
+
+// Implementation of the Boost s11n api.
+namespace boost
+{
+namespace serialization
+{
+
+template <typename Archive, typename T>
+inline void save(Archive &ar, const piranha::boost_s11n_key_wrapper<piranha::kronecker_divisor<T>> &k, unsigned)
+{
+    if (unlikely(!k.key().is_compatible(k.ss()))) {
+        piranha_throw(std::invalid_argument, "an invalid symbol_set was passed as an argument during the "
+                                             "Boost serialization of a Kronecker divisor");
+    }
+    const auto &c = k.key().m_container;
+    piranha::boost_save(ar, static_cast<std::size_t>(c.size()));
+    for (const auto &p : c) {
+        // NOTE: as in kronecker_monomial, the codes are stored directly only in binary archives.
+        if (std::is_same<Archive, boost::archive::binary_oarchive>::value) {
+            piranha::boost_save(ar, p.code);
+        } else {
+            auto tmp = piranha::detail::km_unpack<typename piranha::kronecker_divisor<T>::v_type,
+                                                  piranha::kronecker_array<T>>(k.ss(), p.code);
+            piranha::boost_save(ar, tmp);
+        }
+        piranha::boost_save(ar, p.e);
+    }
+}
+
+template <typename Archive, typename T>
+inline void load(Archive &ar, piranha::boost_s11n_key_wrapper<piranha::kronecker_divisor<T>> &k, unsigned)
+{
+    using v_type = typename piranha::kronecker_divisor<T>::v_type;
+    try {
+        // NOTE: reset the key first, and go through insert() so that the canonical form is checked term by term.
+        k.key().clear();
+        std::size_t size;
+        piranha::boost_load(ar, size);
+        for (std::size_t i = 0u; i < size; ++i) {
+            v_type tmp;
+            if (std::is_same<Archive, boost::archive::binary_iarchive>::value) {
+                T code;
+                piranha::boost_load(ar, code);
+                tmp = piranha::detail::km_unpack<v_type, piranha::kronecker_array<T>>(k.ss(), code);
+            } else {
+                piranha::boost_load(ar, tmp);
+            }
+            T e;
+            piranha::boost_load(ar, e);
+            k.key().insert(tmp.begin(), tmp.end(), e);
+        }
+        if (unlikely(!k.key().is_compatible(k.ss()))) {
+            piranha_throw(std::invalid_argument, "the Kronecker divisor loaded from a Boost archive is not "
+                                                 "compatible with the supplied symbol set");
+        }
+    } catch (...) {
+        k.key().clear();
+        throw;
+    }
+}
+
+template <typename Archive, typename T>
+inline void serialize(Archive &ar, piranha::boost_s11n_key_wrapper<piranha::kronecker_divisor<T>> &k, unsigned version)
+{
+    split_free(ar, k, version);
+}
+}
+}
+
+namespace piranha
+{
+
+/// Kronecker divisor class.
+/**
+ * This class represents the same mathematical objects as piranha::divisor, that is, keys of the form
+ * \f[
+ * \prod_j\frac{1}{\left(a_{0,j}x_0+a_{1,j}x_1+\ldots+a_{n,j}x_n\right)^{e_j}},
+ * \f]
+ * where \f$ a_{i,j} \f$ are integers, \f$ x_i \f$ are symbols, and \f$ e_j \f$ are positive integers.
+ * The difference with respect to piranha::divisor is in the internal representation: the vector of
+ * \f$ a_{i,j} \f$ of each term is packed into a single instance of \p T via piranha::kronecker_array, and the
+ * terms are stored as (code, exponent) pairs in a flat piranha::small_vector sorted by code. Hashing, comparison and
+ * multiplication thus become linear scans over contiguous memory, rather than operations on a node-based hash table
+ * of vectors.
+ *
+ * The canonical form of the terms is the same as in piranha::divisor:
+ * - the values of \f$ a_{i,j} \f$ are within the limits established by piranha::kronecker_array,
+ * - \f$ e_j \f$ is always strictly positive,
+ * - the first nonzero \f$ a_{i,j} \f$ in each term is positive,
+ * - the \f$ a_{i,j} \f$ in each term have no non-unitary common divisor.
+ *
+ * Since the number of variables cannot be recovered from a Kronecker code alone, the divisor also records the number
+ * of \f$ a_{i,j} \f$ in its terms.
+ *
+ * This class satisfies the piranha::is_key type trait, and it can be used as key type in piranha::divisor_series.
+ *
+ * ## Type requirements ##
+ *
+ * \p T must be suitable for use in piranha::kronecker_array. The default type for \p T is the signed counterpart of
+ * \p std::size_t.
+ *
+ * ## Exception safety guarantee ##
+ *
+ * Unless otherwise specified, this class provides the strong exception safety guarantee for all operations.
+ *
+ * ## Move semantics ##
+ *
+ * Move semantics is equivalent to the move semantics of piranha::small_vector.
+ */
+template <typename T = std::make_signed<std::size_t>::type>
+class kronecker_divisor
+{
+    // Make friend with the divisor series.
+    template <typename, typename>
+    friend class divisor_series;
+
+public:
+    /// Alias for \p T.
+    using value_type = T;
+
+private:
+    using ka = kronecker_array<value_type>;
+
+public:
+    /// Vector type used for temporary packing/unpacking.
+    using v_type = static_vector<value_type, 255u>;
+
+private:
+    // Pair code-exponent.
+    struct p_type {
+        bool operator==(const p_type &other) const
+        {
+            return code == other.code && e == other.e;
+        }
+        bool operator!=(const p_type &other) const
+        {
+            return !(*this == other);
+        }
+        value_type code;
+        value_type e;
+    };
+    using container_type = small_vector<p_type>;
+    // Canonical term: the first nonzero element is positive and all the gcd of all elements is 1 or -1.
+    // NOTE: this also includes the check for all zero elements, as gcd(0,0,...,0) = 0.
+    static bool term_is_canonical(const v_type &v)
+    {
+        bool first_nonzero_found = false;
+        value_type cd(0);
+        for (const auto &n : v) {
+            if (!first_nonzero_found && !math::is_zero(n)) {
+                if (n < 0) {
+                    return false;
+                }
+                first_nonzero_found = true;
+            }
+            math::gcd3(cd, cd, n);
+        }
+        return cd == 1 || cd == -1;
+    }
+    // Range check on a term, needed to make the gcd computations safe.
+    static bool term_range_check(const v_type &v)
+    {
+        return std::all_of(v.begin(), v.end(), [](const value_type &x) {
+            return x >= -detail::safe_abs_sint<value_type>::value && x <= detail::safe_abs_sint<value_type>::value;
+        });
+    }
+    bool destruction_checks() const
+    {
+        for (decltype(m_container.size()) i = 0u; i < m_container.size(); ++i) {
+            // Check: the exponent must be greater than zero.
+            if (m_container[i].e <= 0) {
+                return false;
+            }
+            // Check: the codes are strictly increasing.
+            if (i && m_container[i - 1u].code >= m_container[i].code) {
+                return false;
+            }
+        }
+        return true;
+    }
+    static void update_exponent(value_type &a, const value_type &b)
+    {
+        piranha_assert(a > 0);
+        piranha_assert(b > 0);
+        // NOTE: this is safe as we require b to be a positive value.
+        if (unlikely(a > std::numeric_limits<value_type>::max() - b)) {
+            piranha_throw(std::invalid_argument, "overflow in the computation of the exponent of a divisor term");
+        }
+        a = static_cast<value_type>(a + b);
+    }
+    // Insert a (code, exponent) pair, keeping the container sorted.
+    void insertion_impl(const value_type &code, const value_type &e)
+    {
+        auto it = std::lower_bound(m_container.begin(), m_container.end(), code,
+                                   [](const p_type &p, const value_type &c) { return p.code < c; });
+        if (it != m_container.end() && it->code == code) {
+            update_exponent(it->e, e);
+            return;
+        }
+        // New term: append and rotate into place.
+        const auto idx = it - m_container.begin();
+        m_container.push_back(p_type{code, e});
+        std::rotate(m_container.begin() + idx, m_container.end() - 1, m_container.end());
+    }
+    // Unpack the code of a term.
+    v_type unpack_term(const p_type &p) const
+    {
+        v_type retval(static_cast<typename v_type::size_type>(m_nvars), value_type(0));
+        ka::decode(retval, p.code);
+        return retval;
+    }
+    // Remove the first term, returning its aij and exponent. Used in divisor_series.
+    std::pair<v_type, value_type> pop_first()
+    {
+        piranha_assert(m_container.size() != 0u);
+        std::pair<v_type, value_type> retval(unpack_term(*m_container.begin()), m_container.begin()->e);
+        m_container.erase(m_container.begin());
+        return retval;
+    }
+    // Enabler for insertion.
+    template <typename It, typename Exponent>
+    using insert_enabler =
+        typename std::enable_if<is_input_iterator<It>::value
+                                    && has_safe_cast<value_type, typename std::iterator_traits<It>::value_type>::value
+                                    && has_safe_cast<value_type, Exponent>::value,
+                                int>::type;
+    // Evaluation utilities.
+    template <typename U>
+    using eval_sum_type = decltype(std::declval<const value_type &>() * std::declval<const U &>());
+    template <typename U>
+    using eval_type_
+        = decltype(math::pow(std::declval<const eval_sum_type<U> &>(), std::declval<const value_type &>()));
+    template <typename U>
+    using eval_type =
+        typename std::enable_if<std::is_constructible<eval_type_<U>, int>::value
+                                    && is_divisible_in_place<eval_type_<U>>::value
+                                    && std::is_constructible<eval_sum_type<U>, int>::value
+                                    && is_addable_in_place<eval_sum_type<U>>::value && detail::is_pmappable<U>::value,
+                                eval_type_<U>>::type;
+    // Multiplication utilities.
+    template <typename Cf>
+    using multiply_enabler = typename std::enable_if<detail::true_tt<detail::cf_mult_enabler<Cf>>::value, int>::type;
+
+public:
+    /// Arity of the multiply() method.
+    static const std::size_t multiply_arity = 1u;
+    /// Size type.
+    /**
+     * It corresponds to the size type of the internal piranha::small_vector.
+     */
+    using size_type = typename container_type::size_type;
+    /// Defaulted default constructor.
+    /**
+     * This constructor will initialise an empty divisor.
+     */
+    kronecker_divisor() = default;
+    /// Defaulted copy constructor.
+    kronecker_divisor(const kronecker_divisor &) = default;
+    /// Defaulted move constructor.
+    kronecker_divisor(kronecker_divisor &&) = default;
+    /// Converting constructor.
+    /**
+     * This constructor is used in the generic constructor of piranha::series. It is equivalent
+     * to a copy constructor with extra checking.
+     *
+     * @param[in] other construction argument.
+     * @param[in] args reference symbol set.
+     *
+     * @throws std::invalid_argument if \p other is not compatible with \p args.
+     * @throws unspecified any exception thrown by the copy constructor.
+     */
+    explicit kronecker_divisor(const kronecker_divisor &other, const symbol_set &args)
+        : m_container(other.m_container), m_nvars(other.m_nvars)
+    {
+        if (unlikely(!is_compatible(args))) {
+            piranha_throw(std::invalid_argument, "the constructed divisor is incompatible with the "
+                                                 "input symbol set");
+        }
+    }
+    /// Constructor from piranha::symbol_set.
+    /**
+     * Equivalent to the default constructor.
+     */
+    explicit kronecker_divisor(const symbol_set &)
+    {
+    }
+    /// Trivial destructor.
+    ~kronecker_divisor()
+    {
+        piranha_assert(destruction_checks());
+        PIRANHA_TT_CHECK(is_key, kronecker_divisor);
+    }
+    /// Defaulted copy assignment operator.
+    kronecker_divisor &operator=(const kronecker_divisor &) = default;
+    /// Defaulted move assignment operator.
+    kronecker_divisor &operator=(kronecker_divisor &&) = default;
+    /// Create and insert a term from range and exponent.
+    /**
+     * \note
+     * This method is enabled only if:
+     * - \p It is an input iterator,
+     * - the value type of \p It can be safely cast to piranha::kronecker_divisor::value_type,
+     * - \p Exponent can be safely cast to piranha::kronecker_divisor::value_type.
+     *
+     * This method has the same semantics as piranha::divisor::insert(): the elements in the range <tt>[begin,end)</tt>
+     * will be used to construct the \f$ a_{i,j} \f$ of the term, while \p e will be used to construct the exponent.
+     * If no term with the same set of \f$ a_{i,j} \f$ exists, then a new term will be inserted; otherwise, \p e will
+     * be added to the exponent of the existing term.
+     *
+     * @param[in] begin start of the range of \f$ a_{i,j} \f$.
+     * @param[in] end end of the range of \f$ a_{i,j} \f$.
+     * @param[in] e exponent.
+     *
+     * @throws std::invalid_argument if the term to be inserted is not in canonical form, if its size differs from
+     * the size of the terms already in the divisor, or if the insertion leads to an overflow in the value of an
+     * exponent.
+     * @throws std::bad_alloc if the range contains more than 255 elements.
+     * @throws unspecified any exception thrown by:
+     * - piranha::safe_cast(),
+     * - piranha::kronecker_array::encode(),
+     * - piranha::small_vector::push_back().
+     */
+    template <typename It, typename Exponent, insert_enabler<It, Exponent> = 0>
+    void insert(It begin, It end, const Exponent &e)
+    {
+        const auto e_ = safe_cast<value_type>(e);
+        if (unlikely(e_ <= 0)) {
+            piranha_throw(std::invalid_argument, "a term of a divisor must have a positive exponent");
+        }
+        v_type tmp;
+        for (; begin != end; ++begin) {
+            tmp.push_back(safe_cast<value_type>(*begin));
+        }
+        if (unlikely(!term_range_check(tmp))) {
+            piranha_throw(std::invalid_argument, "an element in a term of a divisor is outside the allowed range");
+        }
+        if (unlikely(!term_is_canonical(tmp))) {
+            piranha_throw(std::invalid_argument, "term not in canonical form");
+        }
+        if (unlikely(m_container.size() != 0u && tmp.size() != m_nvars)) {
+            piranha_throw(std::invalid_argument, "the size of the term to be inserted differs from the size of the "
+                                                 "terms already in the divisor");
+        }
+        const auto code = ka::encode(tmp);
+        insertion_impl(code, e_);
+        m_nvars = tmp.size();
+    }
+    /// Size.
+    /**
+     * @return the number of terms in the product.
+     */
+    size_type size() const
+    {
+        return m_container.size();
+    }
+    /// Clear.
+    /**
+     * This method will remove all terms from the divisor.
+     */
+    void clear()
+    {
+        m_container = container_type{};
+        m_nvars = 0u;
+    }
+    /// Equality operator.
+    /**
+     * Two divisors are considered equal if they contain the same terms with the same exponents.
+     *
+     * @param[in] other comparison argument.
+     *
+     * @return \p true if \p this is equal to \p other, \p false otherwise.
+     */
+    bool operator==(const kronecker_divisor &other) const
+    {
+        return m_container == other.m_container;
+    }
+    /// Inequality operator.
+    /**
+     * @param[in] other comparison argument.
+     *
+     * @return the opposite of operator==().
+     */
+    bool operator!=(const kronecker_divisor &other) const
+    {
+        return !((*this) == other);
+    }
+    /// Hash value.
+    /**
+     * The hash value is computed by combining the codes and the exponents of the terms via
+     * \p boost::hash_combine. An empty divisor has a hash value of 0.
+     *
+     * @return a hash value for the divisor.
+     */
+    std::size_t hash() const
+    {
+        // NOTE: the terms are kept sorted, so here we can use an order-dependent combination.
+        std::size_t retval = 0u;
+        for (const auto &p : m_container) {
+            boost::hash_combine(retval, p.code);
+            boost::hash_combine(retval, p.e);
+        }
+        return retval;
+    }
+    /// Compatibility check.
+    /**
+     * An empty divisor is considered compatible with any set of symbols. Otherwise, a non-empty
+     * divisor is compatible if the number of variables in the terms is the same as the number
+     * of symbols in \p args.
+     *
+     * @param[in] args reference symbol set.
+     *
+     * @return \p true if \p this is compatible with \p args, \p false otherwise.
+     */
+    bool is_compatible(const symbol_set &args) const noexcept
+    {
+        return m_container.size() == 0u || m_nvars == args.size();
+    }
+    /// Ignorability check.
+    /**
+     * A divisor is never considered ignorable (an empty divisor is equal to 1).
+     *
+     * @return \p false.
+     */
+    bool is_ignorable(const symbol_set &) const noexcept
+    {
+        return false;
+    }
+    /// Check if divisor is unitary.
+    /**
+     * Only an empty divisor is considered unitary.
+     *
+     * @param[in] args reference symbol set.
+     *
+     * @return \p true if \p this is empty, \p false otherwise.
+     *
+     * @throws std::invalid_argument if \p this is not compatible with \p args.
+     */
+    bool is_unitary(const symbol_set &args) const
+    {
+        if (unlikely(!is_compatible(args))) {
+            piranha_throw(std::invalid_argument, "invalid arguments set");
+        }
+        return m_container.size() == 0u;
+    }
+    /// Merge arguments.
+    /**
+     * This method will merge the new arguments set \p new_args into \p this, given the current reference arguments set
+     * \p orig_args. Arguments in \p new_args not appearing in \p orig_args will be inserted in the terms,
+     * with the corresponding \f$ a_{i,j} \f$ values set to zero.
+     *
+     * @param[in] orig_args current reference arguments set for \p this.
+     * @param[in] new_args new arguments set.
+     *
+     * @return a divisor resulting from merging \p new_args into \p this.
+     *
+     * @throws std::invalid_argument in the following cases:
+     * - \p this is not compatible with \p orig_args,
+     * - the size of \p new_args is not greater than the size of \p orig_args,
+     * - not all elements of \p orig_args are included in \p new_args.
+     * @throws unspecified any exception thrown by piranha::kronecker_array::encode() or
+     * piranha::small_vector::push_back().
+     */
+    kronecker_divisor merge_args(const symbol_set &orig_args, const symbol_set &new_args) const
+    {
+        if (unlikely(!is_compatible(orig_args))) {
+            piranha_throw(std::invalid_argument, "invalid argument(s) for symbol set merging");
+        }
+        kronecker_divisor retval;
+        for (const auto &p : m_container) {
+            // NOTE: inserting zeroes does not alter the canonical form of the terms.
+            retval.m_container.push_back(p_type{detail::km_merge_args<v_type, ka>(orig_args, new_args, p.code), p.e});
+        }
+        // The codes change with the number of variables: restore the ordering.
+        std::sort(retval.m_container.begin(), retval.m_container.end(),
+                  [](const p_type &a, const p_type &b) { return a.code < b.code; });
+        retval.m_nvars = new_args.size();
+        return retval;
+    }
+    /// Print to stream.
+    /**
+     * This method will print to the stream \p os a text representation of \p this, in the same format
+     * used by piranha::divisor::print().
+     *
+     * @param[in] os target stream.
+     * @param[in] args reference symbol set.
+     *
+     * @throws std::invalid_argument if \p this is not compatible with \p args.
+     * @throws unspecified any exception thrown by printing to \p os piranha::kronecker_divisor::value_type, strings or
+     * characters.
+     */
+    void print(std::ostream &os, const symbol_set &args) const
+    {
+        if (m_container.size() == 0u) {
+            return;
+        }
+        if (unlikely(!is_compatible(args))) {
+            piranha_throw(std::invalid_argument, "invalid size of arguments set");
+        }
+        bool first_term = true;
+        os << "1/[";
+        for (const auto &p : m_container) {
+            if (first_term) {
+                first_term = false;
+            } else {
+                os << '*';
+            }
+            const auto v = unpack_term(p);
+            bool printed_something = false;
+            os << '(';
+            for (typename v_type::size_type i = 0u; i < v.size(); ++i) {
+                if (math::is_zero(v[i])) {
+                    continue;
+                }
+                if (v[i] > 0 && printed_something) {
+                    os << '+';
+                }
+                if (v[i] == -1) {
+                    os << '-';
+                } else if (v[i] != 1) {
+                    os << detail::prepare_for_print(v[i]) << '*';
+                }
+                os << args[i].get_name();
+                printed_something = true;
+            }
+            os << ')';
+            if (p.e != 1) {
+                os << "**" << detail::prepare_for_print(p.e);
+            }
+        }
+        os << ']';
+    }
+    /// Print to stream in TeX mode.
+    /**
+     * This method will print to the stream \p os a TeX representation of \p this, in the same format
+     * used by piranha::divisor::print_tex().
+     *
+     * @param[in] os target stream.
+     * @param[in] args reference symbol set.
+     *
+     * @throws std::invalid_argument if \p this is not compatible with \p args.
+     * @throws unspecified any exception thrown by printing to \p os piranha::kronecker_divisor::value_type, strings or
+     * characters.
+     */
+    void print_tex(std::ostream &os, const symbol_set &args) const
+    {
+        if (m_container.size() == 0u) {
+            return;
+        }
+        if (unlikely(!is_compatible(args))) {
+            piranha_throw(std::invalid_argument, "invalid size of arguments set");
+        }
+        os << "\\frac{1}{";
+        for (const auto &p : m_container) {
+            const auto v = unpack_term(p);
+            bool printed_something = false;
+            os << "\\left(";
+            for (typename v_type::size_type i = 0u; i < v.size(); ++i) {
+                if (math::is_zero(v[i])) {
+                    continue;
+                }
+                if (v[i] > 0 && printed_something) {
+                    os << '+';
+                }
+                if (v[i] == -1) {
+                    os << '-';
+                } else if (v[i] != 1) {
+                    os << detail::prepare_for_print(v[i]);
+                }
+                os << args[i].get_name();
+                printed_something = true;
+            }
+            os << "\\right)";
+            if (p.e != 1) {
+                os << "^{" << detail::prepare_for_print(p.e) << "}";
+            }
+        }
+        os << '}';
+    }
+    /// Evaluation.
+    /**
+     * \note
+     * This method is available only if \p U satisfies the following requirements:
+     * - it can be used in piranha::symbol_set::positions_map,
+     * - it supports the arithmetic operations necessary to construct the return type.
+     *
+     * The semantics of this method are the same as piranha::divisor::evaluate().
+     *
+     * @param[in] pmap piranha::symbol_set::positions_map that will be used for substitution.
+     * @param[in] args reference set of piranha::symbol.
+     *
+     * @return the result of evaluating \p this with the values provided in \p pmap.
+     *
+     * @throws std::invalid_argument if there exist an incompatibility between \p this,
+     * \p args or \p pmap.
+     * @throws unspecified any exception thrown by the construction of the return type.
+     */
+    template <typename U>
+    eval_type<U> evaluate(const symbol_set::positions_map<U> &pmap, const symbol_set &args) const
+    {
+        eval_type<U> retval(1);
+        if (m_container.size() == 0u) {
+            return retval;
+        }
+        if (unlikely(pmap.size() != m_nvars || (pmap.size() && pmap.back().first != pmap.size() - 1u))) {
+            piranha_throw(std::invalid_argument, "invalid positions map for evaluation");
+        }
+        if (unlikely(!is_compatible(args))) {
+            piranha_throw(std::invalid_argument, "invalid size of arguments set");
+        }
+        for (const auto &p : m_container) {
+            const auto v = unpack_term(p);
+            eval_sum_type<U> tmp(0);
+            auto map_it = pmap.begin();
+            for (typename v_type::size_type i = 0u; i < v.size(); ++i, ++map_it) {
+                piranha_assert(map_it != pmap.end() && map_it->first == i);
+                tmp += v[i] * map_it->second;
+            }
+            piranha_assert(map_it == pmap.end());
+            retval /= math::pow(tmp, p.e);
+        }
+        return retval;
+    }
+    /// Multiply terms with a Kronecker divisor key.
+    /**
+     * \note
+     * This method is enabled only if \p Cf satisfies piranha::is_cf and piranha::has_mul3.
+     *
+     * Multiply \p t1 by \p t2, storing the result in the only element of \p res. If \p Cf is an instance of
+     * piranha::mp_rational, then only the numerators of the coefficients will be multiplied. The keys are multiplied
+     * by merging their sorted terms in a single linear pass, adding up the exponents of the terms appearing in both.
+     *
+     * This method offers the basic exception safety guarantee.
+     *
+     * @param[out] res return value.
+     * @param[in] t1 first argument.
+     * @param[in] t2 second argument.
+     * @param[in] args reference set of arguments.
+     *
+     * @throws std::invalid_argument if the key of \p t1 and/or the key of \p t2 are incompatible with \p args, or if
+     * the multiplication of the keys results in an exponent exceeding the allowed range.
+     * @throws unspecified any exception thrown by:
+     * - piranha::math::mul3(),
+     * - piranha::small_vector::push_back().
+     */
+    template <typename Cf, multiply_enabler<Cf> = 0>
+    static void multiply(std::array<term<Cf, kronecker_divisor>, multiply_arity> &res,
+                         const term<Cf, kronecker_divisor> &t1, const term<Cf, kronecker_divisor> &t2,
+                         const symbol_set &args)
+    {
+        term<Cf, kronecker_divisor> &t = res[0u];
+        if (unlikely(!t1.m_key.is_compatible(args) || !t2.m_key.is_compatible(args))) {
+            piranha_throw(std::invalid_argument, "invalid size of arguments set");
+        }
+        // Coefficient.
+        detail::cf_mult_impl(t.m_cf, t1.m_cf, t2.m_cf);
+        // Key: merge the two sorted ranges.
+        const auto &c1 = t1.m_key.m_container, &c2 = t2.m_key.m_container;
+        container_type out;
+        auto it1 = c1.begin(), it2 = c2.begin();
+        const auto it_f1 = c1.end(), it_f2 = c2.end();
+        while (it1 != it_f1 && it2 != it_f2) {
+            if (it1->code < it2->code) {
+                out.push_back(*it1);
+                ++it1;
+            } else if (it2->code < it1->code) {
+                out.push_back(*it2);
+                ++it2;
+            } else {
+                p_type tmp(*it1);
+                update_exponent(tmp.e, it2->e);
+                out.push_back(tmp);
+                ++it1;
+                ++it2;
+            }
+        }
+        for (; it1 != it_f1; ++it1) {
+            out.push_back(*it1);
+        }
+        for (; it2 != it_f2; ++it2) {
+            out.push_back(*it2);
+        }
+        t.m_key.m_container = std::move(out);
+        t.m_key.m_nvars = (t.m_key.m_container.size() == 0u) ? 0u : args.size();
+    }
+    /// Identify symbols that can be trimmed.
+    /**
+     * This method is used in piranha::series::trim(). The input parameter \p candidates
+     * contains a set of symbols that are candidates for elimination. The method will remove
+     * from \p candidates those symbols whose \f$ a_{i,j} \f$ in \p this are not all zeroes.
+     *
+     * @param[in] candidates set of candidates for elimination.
+     * @param[in] args reference arguments set.
+     *
+     * @throws std::invalid_argument if \p this is not compatible with \p args.
+     * @throws unspecified any exception thrown by piranha::kronecker_array::decode() or
+     * piranha::symbol_set::remove().
+     */
+    void trim_identify(symbol_set &candidates, const symbol_set &args) const
+    {
+        if (unlikely(!is_compatible(args))) {
+            piranha_throw(std::invalid_argument, "invalid arguments set for trim_identify()");
+        }
+        for (const auto &p : m_container) {
+            detail::km_trim_identify<v_type, ka>(candidates, args, p.code);
+        }
+    }
+    /// Trim.
+    /**
+     * This method will return a copy of \p this with the \f$ a_{i,j} \f$ associated to the symbols
+     * in \p trim_args removed.
+     *
+     * @param[in] trim_args arguments whose \f$ a_{i,j} \f$ will be removed.
+     * @param[in] orig_args original arguments set.
+     *
+     * @return trimmed copy of \p this.
+     *
+     * @throws std::invalid_argument if \p this is not compatible with \p orig_args.
+     * @throws unspecified any exception thrown by insert().
+     */
+    kronecker_divisor trim(const symbol_set &trim_args, const symbol_set &orig_args) const
+    {
+        if (unlikely(!is_compatible(orig_args))) {
+            piranha_throw(std::invalid_argument, "invalid arguments set for trim()");
+        }
+        kronecker_divisor retval;
+        for (const auto &p : m_container) {
+            const auto v = unpack_term(p);
+            v_type tmp;
+            for (typename v_type::size_type i = 0u; i < v.size(); ++i) {
+                if (!std::binary_search(trim_args.begin(), trim_args.end(), orig_args[i])) {
+                    tmp.push_back(v[i]);
+                }
+            }
+            retval.insert(tmp.begin(), tmp.end(), p.e);
+        }
+        return retval;
+    }
+    /// Split divisor.
+    /**
+     * This method will split \p this into two parts: the first one will contain the terms of the divisor
+     * whose \f$ a_{i,j} \f$ values for the only symbol in \p p are not zero, the second one the terms whose
+     * \f$ a_{i,j} \f$  values for the only symbol in \p p are zero.
+     *
+     * @param[in] p a piranha::symbol_set::positions containing exactly one element.
+     * @param[in] args reference set of piranha::symbol.
+     *
+     * @return the original divisor split into two parts.
+     *
+     * @throws std::invalid_argument if \p args is not compatible with \p this or \p p, or \p p
+     * does not contain exactly one element.
+     * @throws unspecified any exception thrown by piranha::small_vector::push_back().
+     */
+    std::pair<kronecker_divisor, kronecker_divisor> split(const symbol_set::positions &p,
+                                                          const symbol_set &args) const
+    {
+        if (unlikely(!is_compatible(args))) {
+            piranha_throw(std::invalid_argument, "invalid size of arguments set");
+        }
+        if (unlikely(p.size() != 1u || p.back() >= args.size())) {
+            piranha_throw(std::invalid_argument, "invalid size of symbol_set::positions");
+        }
+        std::pair<kronecker_divisor, kronecker_divisor> retval;
+        // NOTE: the terms are visited in order, so the output containers stay sorted.
+        for (const auto &t : m_container) {
+            const auto v = unpack_term(t);
+            // NOTE: static cast is safe here, as we checked for compatibility.
+            auto &out = math::is_zero(v[static_cast<typename v_type::size_type>(p.back())]) ? retval.second
+                                                                                            : retval.first;
+            out.m_container.push_back(t);
+            out.m_nvars = m_nvars;
+        }
+        return retval;
+    }
+
+private:
+    // Make friend with the s11n functions.
+    template <typename Archive, typename T1>
+    friend void boost::serialization::save(Archive &,
+                                           const piranha::boost_s11n_key_wrapper<piranha::kronecker_divisor<T1>> &,
+                                           unsigned);
+#if defined(PIRANHA_WITH_MSGPACK)
+    template <typename Stream>
+    using msgpack_pack_enabler = enable_if_t<conjunction<is_msgpack_stream<Stream>, has_msgpack_pack<Stream, T>,
+                                                         has_msgpack_pack<Stream, v_type>>::value,
+                                             int>;
+    template <typename U>
+    using msgpack_convert_enabler = enable_if_t<conjunction<has_msgpack_convert<typename U::value_type>,
+                                                            has_msgpack_convert<typename U::v_type>>::value,
+                                                int>;
+
+public:
+    /// Pack in msgpack format.
+    /**
+     * \note
+     * This method is enabled only if \p Stream satisfies piranha::is_msgpack_stream and both \p T and
+     * piranha::kronecker_divisor::v_type satisfy piranha::has_msgpack_pack.
+     *
+     * This method will pack \p this into \p p as an array of (multipliers, exponent) pairs. In binary format,
+     * the multipliers are represented by their Kronecker code, in portable format by an array of integers.
+     *
+     * @param p the target <tt>msgpack::packer</tt>.
+     * @param f the desired piranha::msgpack_format.
+     * @param args reference symbol set.
+     *
+     * @throws std::invalid_argument if \p args is not compatible with \p this.
+     * @throws unspecified any exception thrown by piranha::msgpack_pack().
+     */
+    template <typename Stream, msgpack_pack_enabler<Stream> = 0>
+    void msgpack_pack(msgpack::packer<Stream> &p, msgpack_format f, const symbol_set &args) const
+    {
+        if (unlikely(!is_compatible(args))) {
+            piranha_throw(std::invalid_argument, "an invalid symbol_set was passed as an argument for the "
+                                                 "msgpack_pack() method of a Kronecker divisor");
+        }
+        p.pack_array(safe_cast<std::uint32_t>(m_container.size()));
+        for (const auto &t : m_container) {
+            p.pack_array(2);
+            if (f == msgpack_format::binary) {
+                piranha::msgpack_pack(p, t.code, f);
+            } else {
+                piranha::msgpack_pack(p, unpack_term(t), f);
+            }
+            piranha::msgpack_pack(p, t.e, f);
+        }
+    }
+    /// Convert from msgpack object.
+    /**
+     * \note
+     * This method is enabled only if both \p T and piranha::kronecker_divisor::v_type satisfy
+     * piranha::has_msgpack_convert.
+     *
+     * This method will convert the input msgpack object \p o into \p this, using the format \p f. The terms
+     * are re-inserted via insert(), so that their canonical form is verified. The method
+     * provides the basic exception safety guarantee.
+     *
+     * @param o the input <tt>msgpack::object</tt>.
+     * @param f the desired piranha::msgpack_format.
+     * @param args reference symbol set.
+     *
+     * @throws std::invalid_argument if the deserialized divisor is not compatible with \p args.
+     * @throws unspecified any exception thrown by insert() or piranha::msgpack_convert().
+     */
+    template <typename U = kronecker_divisor, msgpack_convert_enabler<U> = 0>
+    void msgpack_convert(const msgpack::object &o, msgpack_format f, const symbol_set &args)
+    {
+        try {
+            clear();
+            std::vector<msgpack::object> terms;
+            o.convert(terms);
+            for (const auto &obj : terms) {
+                std::array<msgpack::object, 2> tmp;
+                obj.convert(tmp);
+                v_type v;
+                if (f == msgpack_format::binary) {
+                    value_type code;
+                    piranha::msgpack_convert(code, tmp[0], f);
+                    v = detail::km_unpack<v_type, ka>(args, code);
+                } else {
+                    piranha::msgpack_convert(v, tmp[0], f);
+                }
+                value_type e;
+                piranha::msgpack_convert(e, tmp[1], f);
+                insert(v.begin(), v.end(), e);
+            }
+            if (unlikely(!is_compatible(args))) {
+                piranha_throw(std::invalid_argument, "the Kronecker divisor loaded from a msgpack object is not "
+                                                     "compatible with the supplied symbol set");
+            }
+        } catch (...) {
+            clear();
+            throw;
+        }
+    }
+#endif
+
+private:
+    container_type m_container;
+    typename v_type::size_type m_nvars = 0u;
+};
+
+template <typename T>
+const std::size_t kronecker_divisor<T>::multiply_arity;
+
+inline namespace impl
+{
+
+template <typename Archive, typename T>
+using kd_boost_save_enabler
+    = enable_if_t<conjunction<has_boost_save<Archive, T>,
+                              has_boost_save<Archive, typename kronecker_divisor<T>::v_type>>::value>;
+
+template <typename Archive, typename T>
+using kd_boost_load_enabler
+    = enable_if_t<conjunction<has_boost_load<Archive, T>,
+                              has_boost_load<Archive, typename kronecker_divisor<T>::v_type>>::value>;
+}
+
+/// Specialisation of piranha::boost_save() for piranha::kronecker_divisor.
+/**
+ * \note
+ * This specialisation is enabled only if \p T and piranha::kronecker_divisor::v_type satisfy
+ * piranha::has_boost_save.
+ *
+ * If \p Archive is \p boost::archive::binary_oarchive, the Kronecker codes are saved directly. Otherwise,
+ * the multipliers of each term are saved as vectors.
+ *
+ * @throws std::invalid_argument if the symbol set is incompatible with the divisor.
+ * @throws unspecified any exception thrown by piranha::boost_save() or piranha::kronecker_array::decode().
+ */
+template <typename Archive, typename T>
+struct boost_save_impl<Archive, boost_s11n_key_wrapper<kronecker_divisor<T>>, kd_boost_save_enabler<Archive, T>>
+    : boost_save_via_boost_api<Archive, boost_s11n_key_wrapper<kronecker_divisor<T>>> {
+};
+
+/// Specialisation of piranha::boost_load() for piranha::kronecker_divisor.
+/**
+ * \note
+ * This specialisation is enabled only if \p T and piranha::kronecker_divisor::v_type satisfy
+ * piranha::has_boost_load.
+ *
+ * The terms are re-inserted via piranha::kronecker_divisor::insert(), so that their canonical form is verified.
+ * The basic exception safety guarantee is provided.
+ *
+ * @throws std::invalid_argument if the symbol set is not compatible with the loaded divisor.
+ * @throws unspecified any exception thrown by piranha::boost_load() or piranha::kronecker_divisor::insert().
+ */
+template <typename Archive, typename T>
+struct boost_load_impl<Archive, boost_s11n_key_wrapper<kronecker_divisor<T>>, kd_boost_load_enabler<Archive, T>>
+    : boost_load_via_boost_api<Archive, boost_s11n_key_wrapper<kronecker_divisor<T>>> {
+};
+}
+
+namespace std
+{
+
+template <typename T>
+struct hash<piranha::kronecker_divisor<T>> {
+    /// Result type.
+    typedef size_t result_type;
+    /// Argument type.
+    typedef piranha::kronecker_divisor<T> argument_type;
+    /// Hash operator.
+    /**
+     * @param[in] a piranha::kronecker_divisor whose hash value will be returned.
+     *
+     * @return piranha::kronecker_divisor::hash().
+     */
+    result_type operator()(const argument_type &a) const
+    {
+        return a.hash();
+    }
+};
+}
+
+#endif
@@ -251,8 +251,8 @@ inline bool alignment_check(const std::size_t &alignment)
  * This function is enabled only if \p T satisfies the piranha::is_container_element type trait.
  *
  * This function will value-initialise in parallel the array \p ptr
- * of size \p size. The routine will use the first \p n_threads from piranha::thread_pool to perform
- * the operation concurrently. If \p n_threads is 1 or 0, the operation will be performed in the
+ * of size \p size. The routine will split the array into \p n_threads ranges, which will be processed
+ * concurrently via piranha::thread_pool::parallel_for(). If \p n_threads is 1 or 0, the operation will be performed in the
  * calling thread. If \p ptr is null, this function will be a no-op.
  *
  * This function provides the strong exception safety guarantee: in case of errors, any constructed
@@ -265,7 +265,7 @@ inline bool alignment_check(const std::size_t &alignment)
  * @throws std::bad_alloc in case of memory allocation errors in multithreaded mode.
  * @throws unspecified any exception thrown by:
  * - the value initialisation of instances of type \p T,
- * - piranha::thread_pool::enqueue() and piranha::future_list::push_back(), only in multithreaded mode.
+ * - piranha::thread_pool::parallel_for(), only in multithreaded mode.
  */
 template <typename T, typename = typename std::enable_if<is_container_element<T>::value>::type>
 inline void parallel_value_init(T *ptr, const std::size_t &size, const unsigned &n_threads)
@@ -308,16 +308,15 @@ inline void parallel_value_init(T *ptr, const std::size_t &size, const unsigned
         }
         // Work per thread.
         const auto wpt = static_cast<std::size_t>(size / n_threads);
-        future_list<decltype(init_function(ptr, ptr, 0u, &inited_ranges))> f_list;
         try {
-            for (auto i = 0u; i < n_threads; ++i) {
-                auto start = ptr + i * wpt, end = (i == n_threads - 1u) ? ptr + size : ptr + (i + 1u) * wpt;
-                f_list.push_back(thread_pool::enqueue(i, init_function, start, end, i, &inited_ranges));
-            }
-            f_list.wait_all();
-            f_list.get_all();
+            thread_pool::parallel_for(0u, n_threads, 1u, [&](std::size_t i_start, std::size_t i_end) {
+                for (auto j = i_start; j != i_end; ++j) {
+                    const auto i = static_cast<unsigned>(j);
+                    auto start = ptr + i * wpt, end = (i == n_threads - 1u) ? ptr + size : ptr + (i + 1u) * wpt;
+                    init_function(start, end, i, &inited_ranges);
+                }
+            });
         } catch (...) {
-            f_list.wait_all();
             // Rollback the ranges that were inited.
             for (const auto &p : inited_ranges) {
                 for (auto start = p.first; start != p.second; ++start) {
@@ -335,9 +334,8 @@ inline void parallel_value_init(T *ptr, const std::size_t &size, const unsigned
  * This function is enabled only if \p T satisfies the piranha::is_container_element type trait.
  *
  * This function will destroy in parallel the element of an array \p ptr of size \p size. If \p n_threads
- * is 0 or 1, the operation will be performed in the calling thread, otherwise the first \p n_threads in
- * piranha::thread_pool
- * will be used to perform the operation concurrently.
+ * is 0 or 1, the operation will be performed in the calling thread, otherwise the array will be split into
+ * \p n_threads ranges, which will be processed concurrently via piranha::thread_pool::parallel_for().
  *
  * The function is a no-op if \p ptr is null or if \p T has a trivial destructor.
  *
@@ -372,7 +370,6 @@ inline void parallel_destroy(T *ptr, const std::size_t &size, const unsigned &n_
         // A vector of ranges representing elements yet to be destroyed in case something goes wrong
         // in the multithreaded part.
         ranges_vector d_ranges;
-        future_list<decltype(destroy_function(ptr, ptr))> f_list;
         try {
             d_ranges.resize(static_cast<rv_size_type>(n_threads), std::make_pair(ptr, ptr));
             if (unlikely(d_ranges.size() != n_threads)) {
@@ -392,21 +389,20 @@ inline void parallel_destroy(T *ptr, const std::size_t &size, const unsigned &n_
                 d_ranges[static_cast<rv_size_type>(i)] = std::make_pair(start, end);
             }
             // Perform the actual destruction and update the d_ranges vector.
-            for (auto i = 0u; i < n_threads; ++i) {
-                auto start = d_ranges[static_cast<rv_size_type>(i)].first,
-                     end = d_ranges[static_cast<rv_size_type>(i)].second;
-                f_list.push_back(thread_pool::enqueue(i, destroy_function, start, end));
-                // The range needs not to be destroyed anymore, as the enqueue/push_back was successful. Replace
-                // with an empty range.
-                d_ranges[static_cast<rv_size_type>(i)].first = ptr;
-                d_ranges[static_cast<rv_size_type>(i)].second = ptr;
-            }
-            f_list.wait_all();
+            thread_pool::parallel_for(0u, n_threads, 1u, [&](std::size_t i_start, std::size_t i_end) {
+                for (auto i = i_start; i != i_end; ++i) {
+                    auto &r = d_ranges[static_cast<rv_size_type>(i)];
+                    destroy_function(r.first, r.second);
+                    // The range needs not to be destroyed anymore. Replace with an empty range.
+                    r.first = ptr;
+                    r.second = ptr;
+                }
+            });
             // NOTE: T is a container_element, no need to get exceptions here.
         } catch (...) {
-            f_list.wait_all();
             // If anything failed in the multithreaded part, just destroy in single-thread the ranges
-            // that were not destroyed.
+            // that were not destroyed. NOTE: parallel_for() waits for the submitted tasks before
+            // re-throwing, and the tasks which were not submitted leave their ranges untouched.
             for (const auto &p : d_ranges) {
                 destroy_function(p.first, p.second);
             }
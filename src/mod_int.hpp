@@ -0,0 +1,529 @@
+/* Copyright 2009-2016 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#ifndef PIRANHA_MOD_INT_HPP
+#define PIRANHA_MOD_INT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <type_traits>
+
+#include "config.hpp"
+#include "exceptions.hpp"
+#include "math.hpp"
+#include "mp_integer.hpp"
+
+namespace piranha
+{
+
+namespace detail
+{
+
+// Full 64x64 -> 128 bit unsigned multiplication. The result is returned as a (hi, lo) pair of 64-bit values.
+inline void mod_int_mul_wide(std::uint_least64_t a, std::uint_least64_t b, std::uint_least64_t &hi,
+                             std::uint_least64_t &lo)
+{
+#if defined(PIRANHA_UINT128_T)
+    const auto prod = static_cast<PIRANHA_UINT128_T>(a) * b;
+    lo = static_cast<std::uint_least64_t>(prod);
+    hi = static_cast<std::uint_least64_t>(prod >> 64);
+#else
+    // Schoolbook multiplication on 32-bit halves.
+    const std::uint_least64_t mask = 0xFFFFFFFFull;
+    const std::uint_least64_t a_lo = a & mask, a_hi = a >> 32, b_lo = b & mask, b_hi = b >> 32;
+    const std::uint_least64_t p0 = a_lo * b_lo, p1 = a_lo * b_hi, p2 = a_hi * b_lo, p3 = a_hi * b_hi;
+    const std::uint_least64_t mid = (p0 >> 32) + (p1 & mask) + (p2 & mask);
+    lo = (p0 & mask) | ((mid & mask) << 32);
+    hi = p3 + (p1 >> 32) + (p2 >> 32) + (mid >> 32);
+#endif
+}
+
+// Newton iteration for the inverse of an odd n modulo 2**64. Each step doubles the number of correct
+// bits, and x = n is correct to 3 bits to begin with.
+constexpr std::uint_least64_t mod_int_inv64(std::uint_least64_t n, std::uint_least64_t x, unsigned n_iter)
+{
+    return n_iter ? mod_int_inv64(n, static_cast<std::uint_least64_t>(x * (2u - n * x)), n_iter - 1u) : x;
+}
+
+// x * 2**n mod p, computed by repeated doubling. Requires x < p < 2**63.
+constexpr std::uint_least64_t mod_int_shl(std::uint_least64_t x, std::uint_least64_t p, unsigned n)
+{
+    return n ? mod_int_shl((2u * x >= p) ? (2u * x - p) : (2u * x), p, n - 1u) : x;
+}
+
+// C++ integral types that can interoperate with mod_int.
+template <typename T>
+using is_mod_int_integral = std::integral_constant<bool, std::is_integral<T>::value && !std::is_same<T, bool>::value
+                                                             && std::numeric_limits<T>::digits <= 64>;
+
+// A list of the largest primes smaller than 2**63, used as moduli in multi-modular algorithms.
+template <typename = void>
+struct mod_int_primes {
+    static const std::size_t size = 8u;
+    static constexpr std::uint_least64_t value[size]
+        = {9223372036854775783ull, 9223372036854775643ull, 9223372036854775549ull, 9223372036854775507ull,
+           9223372036854775433ull, 9223372036854775421ull, 9223372036854775417ull, 9223372036854775399ull};
+};
+
+template <typename T>
+const std::size_t mod_int_primes<T>::size;
+
+template <typename T>
+constexpr std::uint_least64_t mod_int_primes<T>::value[mod_int_primes<T>::size];
+}
+
+/// Word-size modular integer.
+/**
+ * This class represents an element of the ring of integers modulo \p P. The value is stored in a single 64-bit
+ * word in Montgomery form, so that multiplication requires only a couple of full-width machine multiplications
+ * and no division. Addition and subtraction are performed with a single conditional correction.
+ *
+ * Construction from C++ integral types and from piranha::mp_integer reduces the input modulo \p P. Negative values
+ * are mapped to their non-negative representative. Arithmetic and comparison operators are available between
+ * piranha::mod_int instances with the same modulus, and between piranha::mod_int and C++ integral types.
+ * The class satisfies piranha::is_cf, and it is meant to be used as a coefficient type in multi-modular algorithms
+ * (see, e.g., piranha::tuning::get_crt_multiplication()).
+ *
+ * ## Type requirements ##
+ *
+ * \p P must be an odd number greater than 1 and less than \f$2^{63}\f$.
+ *
+ * ## Exception safety guarantee ##
+ *
+ * This class provides the strong exception safety guarantee for all operations.
+ *
+ * ## Move semantics ##
+ *
+ * Move semantics is equivalent to copy semantics.
+ */
+template <std::uint_least64_t P>
+class mod_int
+{
+    static_assert(P > 1u && P % 2u == 1u, "The modulus must be an odd number greater than 1.");
+    static_assert(P < (std::uint_least64_t(1) << 63), "The modulus must be less than 2**63.");
+
+public:
+    /// The type used to represent the value.
+    using value_type = std::uint_least64_t;
+
+private:
+    // -P**-1 mod 2**64.
+    static constexpr value_type s_p_inv = static_cast<value_type>(-detail::mod_int_inv64(P, P, 5u));
+    // 2**128 mod P, used to convert to Montgomery form.
+    static constexpr value_type s_r2 = detail::mod_int_shl(detail::mod_int_shl(1u, P, 64u), P, 64u);
+    static_assert(static_cast<value_type>(P * s_p_inv) == static_cast<value_type>(-1), "Invalid modular inverse.");
+    // Montgomery reduction of hi * 2**64 + lo, which must be less than P * 2**64.
+    static value_type redc(const value_type &hi, const value_type &lo)
+    {
+        const value_type m = static_cast<value_type>(lo * s_p_inv);
+        value_type m_hi, m_lo;
+        detail::mod_int_mul_wide(m, P, m_hi, m_lo);
+        // NOTE: the low word of the sum is zero by construction, we only need the carry.
+        const value_type carry = static_cast<value_type>(static_cast<value_type>(lo + m_lo) < lo);
+        // NOTE: this cannot overflow as the full sum is less than 2 * P * 2**64 < 2**128.
+        const value_type t = hi + m_hi + carry;
+        return t >= P ? t - P : t;
+    }
+    static value_type mont_mul(const value_type &a, const value_type &b)
+    {
+        value_type hi, lo;
+        detail::mod_int_mul_wide(a, b, hi, lo);
+        return redc(hi, lo);
+    }
+    static value_type to_mont(const value_type &n)
+    {
+        piranha_assert(n < P);
+        return mont_mul(n, s_r2);
+    }
+    // Reduction of integral values.
+    template <typename T, typename std::enable_if<std::is_unsigned<T>::value, int>::type = 0>
+    static value_type reduce(const T &n)
+    {
+        return static_cast<value_type>(n % P);
+    }
+    template <typename T, typename std::enable_if<std::is_signed<T>::value, int>::type = 0>
+    static value_type reduce(const T &n)
+    {
+        using uint_type = typename std::make_unsigned<T>::type;
+        if (n >= T(0)) {
+            return reduce(static_cast<uint_type>(n));
+        }
+        // NOTE: compute the absolute value in the unsigned type, in order to deal with the minimum value.
+        const value_type r = reduce(static_cast<uint_type>(static_cast<uint_type>(-(n + T(1))) + 1u));
+        return r ? P - r : 0u;
+    }
+    template <int NBits>
+    static value_type reduce(const mp_integer<NBits> &n)
+    {
+        auto r = n % mp_integer<NBits>(P);
+        if (r.sign() < 0) {
+            r += P;
+        }
+        return static_cast<value_type>(r);
+    }
+    // Enabler for generic construction and interoperability.
+    template <typename T>
+    using integral_enabler = typename std::enable_if<detail::is_mod_int_integral<T>::value, int>::type;
+    template <typename T>
+    using generic_ctor_enabler =
+        typename std::enable_if<detail::is_mod_int_integral<T>::value || detail::is_mp_integer<T>::value, int>::type;
+    // Enabler for the binary operators.
+    template <typename T, typename U>
+    using binary_op_enabler = typename std::enable_if<
+        (std::is_same<T, mod_int>::value && (std::is_same<U, mod_int>::value || detail::is_mod_int_integral<U>::value))
+            || (std::is_same<U, mod_int>::value && detail::is_mod_int_integral<T>::value),
+        int>::type;
+    static const mod_int &to_mod(const mod_int &n)
+    {
+        return n;
+    }
+    template <typename T, integral_enabler<T> = 0>
+    static mod_int to_mod(const T &n)
+    {
+        return mod_int(n);
+    }
+    struct mont_tag {
+    };
+    explicit mod_int(const value_type &m, const mont_tag &) : m_value(m)
+    {
+    }
+
+public:
+    /// Default constructor.
+    /**
+     * The value will be initialised to zero.
+     */
+    mod_int() : m_value(0u)
+    {
+    }
+    /// Defaulted copy constructor.
+    mod_int(const mod_int &) = default;
+    /// Defaulted move constructor.
+    mod_int(mod_int &&) = default;
+    /// Generic constructor.
+    /**
+     * \note
+     * This constructor is enabled only if \p T is either a C++ integral type (excluding \p bool) with at most 64
+     * value bits, or an instance of piranha::mp_integer.
+     *
+     * The value will be initialised to the non-negative representative of \p n modulo \p P.
+     *
+     * @param[in] n construction argument.
+     *
+     * @throws unspecified any exception thrown by the modular reduction of piranha::mp_integer.
+     */
+    template <typename T, generic_ctor_enabler<T> = 0>
+    explicit mod_int(const T &n) : m_value(to_mont(reduce(n)))
+    {
+    }
+    /// Defaulted copy assignment operator.
+    /**
+     * @return a reference to \p this.
+     */
+    mod_int &operator=(const mod_int &) = default;
+    /// Defaulted move assignment operator.
+    /**
+     * @return a reference to \p this.
+     */
+    mod_int &operator=(mod_int &&) = default;
+    /// Modulus.
+    /**
+     * @return the modulus \p P.
+     */
+    static constexpr value_type modulus()
+    {
+        return P;
+    }
+    /// Get value.
+    /**
+     * @return the representative of \p this in the \f$\left[0,P\right)\f$ range.
+     */
+    value_type get_value() const
+    {
+        return redc(0u, m_value);
+    }
+    /// Test for zero.
+    /**
+     * @return \p true if \p this is zero, \p false otherwise.
+     */
+    bool is_zero() const
+    {
+        // NOTE: zero is the only value whose Montgomery representation is zero.
+        return m_value == 0u;
+    }
+    /// Identity operator.
+    /**
+     * @return a copy of \p this.
+     */
+    mod_int operator+() const
+    {
+        return *this;
+    }
+    /// Negated copy.
+    /**
+     * @return the additive inverse of \p this.
+     */
+    mod_int operator-() const
+    {
+        return mod_int(m_value ? P - m_value : 0u, mont_tag{});
+    }
+    /// In-place addition.
+    /**
+     * @param[in] other the addend.
+     *
+     * @return a reference to \p this.
+     */
+    mod_int &operator+=(const mod_int &other)
+    {
+        // NOTE: this cannot overflow, as both values are less than 2**63.
+        const value_type s = m_value + other.m_value;
+        m_value = s >= P ? s - P : s;
+        return *this;
+    }
+    /// In-place subtraction.
+    /**
+     * @param[in] other the subtrahend.
+     *
+     * @return a reference to \p this.
+     */
+    mod_int &operator-=(const mod_int &other)
+    {
+        m_value = m_value >= other.m_value ? m_value - other.m_value : m_value + (P - other.m_value);
+        return *this;
+    }
+    /// In-place multiplication.
+    /**
+     * @param[in] other the multiplicand.
+     *
+     * @return a reference to \p this.
+     */
+    mod_int &operator*=(const mod_int &other)
+    {
+        m_value = mont_mul(m_value, other.m_value);
+        return *this;
+    }
+    /// Multiply-accumulate.
+    /**
+     * This method will set \p this to <tt>this + a * b</tt>.
+     *
+     * @param[in] a first argument.
+     * @param[in] b second argument.
+     */
+    void multiply_accumulate(const mod_int &a, const mod_int &b)
+    {
+        *this += mod_int(mont_mul(a.m_value, b.m_value), mont_tag{});
+    }
+    /// Binary addition.
+    /**
+     * \note
+     * This operator is enabled only if both \p T and \p U are piranha::mod_int with the same modulus, or if one
+     * of them is piranha::mod_int and the other one is a C++ integral type from which piranha::mod_int can be
+     * constructed. In the latter case, the integral operand is converted to piranha::mod_int before the operation.
+     *
+     * @param[in] a first operand.
+     * @param[in] b second operand.
+     *
+     * @return <tt>a + b</tt>.
+     */
+    template <typename T, typename U, binary_op_enabler<T, U> = 0>
+    friend mod_int operator+(const T &a, const U &b)
+    {
+        auto retval = to_mod(a);
+        return retval += to_mod(b);
+    }
+    /// Binary subtraction.
+    /**
+     * \note
+     * This operator is enabled only if the binary addition operator is enabled.
+     *
+     * @param[in] a first operand.
+     * @param[in] b second operand.
+     *
+     * @return <tt>a - b</tt>.
+     */
+    template <typename T, typename U, binary_op_enabler<T, U> = 0>
+    friend mod_int operator-(const T &a, const U &b)
+    {
+        auto retval = to_mod(a);
+        return retval -= to_mod(b);
+    }
+    /// Binary multiplication.
+    /**
+     * \note
+     * This operator is enabled only if the binary addition operator is enabled.
+     *
+     * @param[in] a first operand.
+     * @param[in] b second operand.
+     *
+     * @return <tt>a * b</tt>.
+     */
+    template <typename T, typename U, binary_op_enabler<T, U> = 0>
+    friend mod_int operator*(const T &a, const U &b)
+    {
+        auto retval = to_mod(a);
+        return retval *= to_mod(b);
+    }
+    /// Equality operator.
+    /**
+     * \note
+     * This operator is enabled only if the binary addition operator is enabled.
+     *
+     * @param[in] a first operand.
+     * @param[in] b second operand.
+     *
+     * @return \p true if \p a is equal to \p b modulo \p P, \p false otherwise.
+     */
+    template <typename T, typename U, binary_op_enabler<T, U> = 0>
+    friend bool operator==(const T &a, const U &b)
+    {
+        return to_mod(a).m_value == to_mod(b).m_value;
+    }
+    /// Inequality operator.
+    /**
+     * \note
+     * This operator is enabled only if the binary addition operator is enabled.
+     *
+     * @param[in] a first operand.
+     * @param[in] b second operand.
+     *
+     * @return \p true if \p a is different from \p b modulo \p P, \p false otherwise.
+     */
+    template <typename T, typename U, binary_op_enabler<T, U> = 0>
+    friend bool operator!=(const T &a, const U &b)
+    {
+        return !(a == b);
+    }
+    /// Exponentiation.
+    /**
+     * @param[in] n the exponent.
+     *
+     * @return \p this raised to the power of \p n.
+     */
+    mod_int pow(std::uint_least64_t n) const
+    {
+        mod_int retval(1), base(*this);
+        while (n) {
+            if (n & 1u) {
+                retval *= base;
+            }
+            base *= base;
+            n >>= 1u;
+        }
+        return retval;
+    }
+    /// Multiplicative inverse.
+    /**
+     * The inverse is computed via Fermat's little theorem, hence \p P must be a prime for the result to be meaningful.
+     *
+     * @return the multiplicative inverse of \p this.
+     *
+     * @throws piranha::zero_division_error if \p this is zero.
+     */
+    mod_int inverse() const
+    {
+        if (unlikely(is_zero())) {
+            piranha_throw(zero_division_error, "cannot invert zero");
+        }
+        return pow(P - 2u);
+    }
+    /// Stream operator.
+    /**
+     * The representative of \p n in the \f$\left[0,P\right)\f$ range will be printed to \p os.
+     *
+     * @param[in] os target stream.
+     * @param[in] n piranha::mod_int to be printed.
+     *
+     * @return a reference to \p os.
+     */
+    friend std::ostream &operator<<(std::ostream &os, const mod_int &n)
+    {
+        return os << n.get_value();
+    }
+
+private:
+    value_type m_value;
+};
+
+template <std::uint_least64_t P>
+constexpr typename mod_int<P>::value_type mod_int<P>::s_p_inv;
+
+template <std::uint_least64_t P>
+constexpr typename mod_int<P>::value_type mod_int<P>::s_r2;
+
+namespace detail
+{
+
+template <typename T>
+struct is_mod_int : std::false_type {
+};
+
+template <std::uint_least64_t P>
+struct is_mod_int<mod_int<P>> : std::true_type {
+};
+}
+
+namespace math
+{
+
+/// Specialisation of the implementation of piranha::math::is_zero() for piranha::mod_int.
+template <typename T>
+struct is_zero_impl<T, typename std::enable_if<detail::is_mod_int<T>::value>::type> {
+    /// Call operator.
+    /**
+     * @param[in] n piranha::mod_int to be tested.
+     *
+     * @return piranha::mod_int::is_zero().
+     */
+    bool operator()(const T &n) const
+    {
+        return n.is_zero();
+    }
+};
+
+/// Specialisation of the implementation of piranha::math::multiply_accumulate() for piranha::mod_int.
+template <typename T>
+struct multiply_accumulate_impl<T, T, T, typename std::enable_if<detail::is_mod_int<T>::value>::type> {
+    /// Call operator.
+    /**
+     * This implementation will use piranha::mod_int::multiply_accumulate().
+     *
+     * @param[in,out] x target value for accumulation.
+     * @param[in] y first argument.
+     * @param[in] z second argument.
+     */
+    void operator()(T &x, const T &y, const T &z) const
+    {
+        x.multiply_accumulate(y, z);
+    }
+};
+}
+}
+
+#endif
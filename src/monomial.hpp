@@ -51,6 +51,7 @@ see https://www.gnu.org/licenses/. */
 #include "detail/cf_mult_impl.hpp"
 #include "detail/prepare_for_print.hpp"
 #include "detail/safe_integral_adder.hpp"
+#include "detail/vector_kernels.hpp"
 #include "exceptions.hpp"
 #include "forwarding.hpp"
 #include "is_cf.hpp"
@@ -227,6 +228,32 @@ class monomial : public array_key<T, monomial<T, S>, S>
     {
         retval += x;
     }
+    // Total degree and unitarity check. The exponent types supported by the vector kernels are
+    // dispatched to the SIMD implementations.
+    template <typename U, typename std::enable_if<detail::vk_degree_enabled<U>::value, int>::type = 0>
+    static degree_type<U> degree_impl(const U *ptr, typename base::size_type size)
+    {
+        return detail::vk_checked_sum<degree_type<U>>(ptr, size);
+    }
+    template <typename U, typename std::enable_if<!detail::vk_degree_enabled<U>::value, int>::type = 0>
+    static degree_type<U> degree_impl(const U *ptr, typename base::size_type size)
+    {
+        degree_type<U> retval(0);
+        for (typename base::size_type i = 0u; i < size; ++i) {
+            expo_add(retval, ptr[i]);
+        }
+        return retval;
+    }
+    template <typename U, typename std::enable_if<detail::vk_enabled<U>::value, int>::type = 0>
+    static bool is_unitary_impl(const U *ptr, typename base::size_type size)
+    {
+        return detail::vk_is_zero(ptr, size);
+    }
+    template <typename U, typename std::enable_if<!detail::vk_enabled<U>::value, int>::type = 0>
+    static bool is_unitary_impl(const U *ptr, typename base::size_type size)
+    {
+        return std::all_of(ptr, ptr + size, [](const U &element) { return math::is_zero(element); });
+    }
     // Integrate utils.
     // In-place increment by one, checked for integral types.
     template <typename U, typename std::enable_if<std::is_integral<U>::value, int>::type = 0>
@@ -438,7 +465,7 @@ public:
         if (unlikely(args.size() != this->size())) {
             piranha_throw(std::invalid_argument, "invalid size of arguments set");
         }
-        return std::all_of(this->begin(), this->end(), [](const T &element) { return math::is_zero(element); });
+        return is_unitary_impl(this->begin(), this->size());
     }
     /// Degree.
     /**
@@ -466,11 +493,7 @@ public:
         if (unlikely(args.size() != this->size())) {
             piranha_throw(std::invalid_argument, "invalid arguments set");
         }
-        degree_type<U> retval(0);
-        for (const auto &x : *this) {
-            expo_add(retval, x);
-        }
-        return retval;
+        return degree_impl<U>(this->begin(), this->size());
     }
     /// Partial degree.
     /**
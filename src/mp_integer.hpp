@@ -55,6 +55,7 @@ see https://www.gnu.org/licenses/. */
 #include "detail/is_digit.hpp"
 #include "detail/mp_rational_fwd.hpp"
 #include "detail/mpfr.hpp"
+#include "detail/mpz_arena.hpp"
 #include "detail/real_fwd.hpp"
 #include "detail/sfinae_types.hpp"
 #include "detail/ulshift.hpp"
@@ -851,6 +852,84 @@ struct static_integer {
         }
         return 0;
     }
+    // Multiply-accumulate kernel for the array form of multiply-accumulate. The first multiplicand is passed
+    // as its magnitude a_mag (which must fit in a single limb) and sign a_neg, so that they can be computed once
+    // for the whole array. The algorithm works on the magnitudes as dlimb_t, and it is available only if the two
+    // limbs fit exactly in dlimb_t. Returns nonzero on failure (i.e., if b has more than one limb or the result
+    // does not fit in two limbs), in which case this is not modified.
+    static const bool has_mac_kernel = static_cast<unsigned>(std::numeric_limits<dlimb_t>::digits) == 2u * limb_bits
+                                       && limb_bits == total_bits;
+    template <typename T = static_integer, typename std::enable_if<T::has_mac_kernel, int>::type = 0>
+    int mac_kernel(const dlimb_t &a_mag, bool a_neg, const static_integer &b)
+    {
+        const mpz_size_t sizeb = b._mp_size;
+        if (sizeb == 0) {
+            return 0;
+        }
+        if (unlikely(sizeb > 1 || sizeb < -1)) {
+            return 1;
+        }
+        const dlimb_t p = static_cast<dlimb_t>(a_mag * b.m_limbs[0u]);
+        const bool p_neg = (a_neg != (sizeb < 0));
+        const bool acc_neg = _mp_size < 0;
+        const dlimb_t m = static_cast<dlimb_t>((static_cast<dlimb_t>(m_limbs[1u]) << limb_bits) + m_limbs[0u]);
+        dlimb_t r;
+        bool r_neg;
+        if (acc_neg == p_neg || _mp_size == 0) {
+            r = static_cast<dlimb_t>(m + p);
+            // NOTE: wrap-around in the addition of the magnitudes means the result needs more than 2 limbs.
+            if (unlikely(r < p)) {
+                return 1;
+            }
+            r_neg = p_neg;
+        } else if (m >= p) {
+            r = static_cast<dlimb_t>(m - p);
+            r_neg = acc_neg;
+        } else {
+            r = static_cast<dlimb_t>(p - m);
+            r_neg = p_neg;
+        }
+        m_limbs[0u] = static_cast<limb_t>(r);
+        m_limbs[1u] = static_cast<limb_t>(r >> limb_bits);
+        const auto size = static_cast<mpz_size_t>(m_limbs[1u] != 0u ? 2 : (m_limbs[0u] != 0u ? 1 : 0));
+        _mp_size = r_neg ? static_cast<mpz_size_t>(-size) : size;
+        return 0;
+    }
+    // Binary GCD kernel for the array form of GCD. Sets this to the GCD of the magnitudes of this and b, which is
+    // always non-negative. Like mac_kernel(), it works on the magnitudes as dlimb_t.
+    template <typename T = static_integer, typename std::enable_if<T::has_mac_kernel, int>::type = 0>
+    void gcd_kernel(const static_integer &b)
+    {
+        auto u = static_cast<dlimb_t>((static_cast<dlimb_t>(m_limbs[1u]) << limb_bits) + m_limbs[0u]);
+        auto v = static_cast<dlimb_t>((static_cast<dlimb_t>(b.m_limbs[1u]) << limb_bits) + b.m_limbs[0u]);
+        if (u == 0u) {
+            u = v;
+        } else if (v != 0u) {
+            // Remove the common powers of two, then work on odd values only.
+            unsigned shift = 0u;
+            while (((u | v) & 1u) == 0u) {
+                u = static_cast<dlimb_t>(u >> 1u);
+                v = static_cast<dlimb_t>(v >> 1u);
+                ++shift;
+            }
+            while ((u & 1u) == 0u) {
+                u = static_cast<dlimb_t>(u >> 1u);
+            }
+            do {
+                while ((v & 1u) == 0u) {
+                    v = static_cast<dlimb_t>(v >> 1u);
+                }
+                if (u > v) {
+                    std::swap(u, v);
+                }
+                v = static_cast<dlimb_t>(v - u);
+            } while (v != 0u);
+            u = static_cast<dlimb_t>(u << shift);
+        }
+        m_limbs[0u] = static_cast<limb_t>(u);
+        m_limbs[1u] = static_cast<limb_t>(u >> limb_bits);
+        _mp_size = static_cast<mpz_size_t>(m_limbs[1u] != 0u ? 2 : (m_limbs[0u] != 0u ? 1 : 0));
+    }
     // lshift by n bits.
     int lshift(::mp_bitcnt_t n)
     {
@@ -1068,6 +1147,9 @@ struct static_integer {
 template <int NBits>
 const typename static_integer<NBits>::limb_t static_integer<NBits>::limb_bits;
 
+template <int NBits>
+const bool static_integer<NBits>::has_mac_kernel;
+
 // Integer union.
 template <int NBits>
 union integer_union {
@@ -3027,6 +3109,62 @@ public:
         }
         return *this;
     }
+    /// Array form of multiply-accumulate.
+    /**
+     * Sets <tt>*acc[i]</tt> to <tt>*acc[i] + a * (*b[i])</tt>, for \p i in the <tt>[0, n)</tt> range. The result
+     * is the same as calling multiply_accumulate() on each element, but if \p a fits in a single limb of static
+     * storage the multiplicand is decoded only once, and the elements whose accumulator and second multiplicand
+     * are static are processed by a dedicated kernel working directly on the limbs (with 128-bit arithmetic, if
+     * available). The elements for which the static computation would overflow fall back to multiply_accumulate().
+     *
+     * The objects pointed to by \p acc must be distinct from each other, from \p a and from the objects pointed to
+     * by \p b.
+     *
+     * @param[in] acc array of pointers to the accumulators.
+     * @param[in] a first multiplicand.
+     * @param[in] b array of pointers to the second multiplicands.
+     * @param[in] n size of the arrays.
+     */
+    static void mac_n(mp_integer *const *acc, const mp_integer &a, const mp_integer *const *b, std::size_t n)
+    {
+        mac_n_impl(acc, a, b, n);
+    }
+
+private:
+    template <typename T = detail::static_integer<NBits>, typename std::enable_if<T::has_mac_kernel, int>::type = 0>
+    static void mac_n_impl(mp_integer *const *acc, const mp_integer &a, const mp_integer *const *b, std::size_t n)
+    {
+        using dlimb_t = typename T::dlimb_t;
+        if (a.is_static() && a.m_int.g_st()._mp_size <= 1 && a.m_int.g_st()._mp_size >= -1) {
+            const auto &st_a = a.m_int.g_st();
+            if (st_a._mp_size == 0) {
+                return;
+            }
+            const dlimb_t a_mag = st_a.m_limbs[0u];
+            const bool a_neg = st_a._mp_size < 0;
+            for (std::size_t i = 0u; i < n; ++i) {
+                piranha_assert(acc[i] != &a && acc[i] != b[i]);
+                if (likely(acc[i]->is_static() && b[i]->is_static())
+                    && likely(!acc[i]->m_int.g_st().mac_kernel(a_mag, a_neg, b[i]->m_int.g_st()))) {
+                    continue;
+                }
+                acc[i]->multiply_accumulate(a, *b[i]);
+            }
+            return;
+        }
+        for (std::size_t i = 0u; i < n; ++i) {
+            acc[i]->multiply_accumulate(a, *b[i]);
+        }
+    }
+    template <typename T = detail::static_integer<NBits>, typename std::enable_if<!T::has_mac_kernel, int>::type = 0>
+    static void mac_n_impl(mp_integer *const *acc, const mp_integer &a, const mp_integer *const *b, std::size_t n)
+    {
+        for (std::size_t i = 0u; i < n; ++i) {
+            acc[i]->multiply_accumulate(a, *b[i]);
+        }
+    }
+
+public:
     /// Multiplication in ternary form.
     /**
      * Sets \p this to <tt>n1 * n2</tt>. This form can be more efficient than the corresponding binary operator.
@@ -3730,6 +3868,54 @@ public:
                 ::mpz_gcd(&out.m_int.g_dy(), &n1.m_int.g_dy(), &n2.m_int.g_dy());
         }
     }
+    /// Array form of GCD.
+    /**
+     * Sets \p out to the GCD of \p out and of <tt>*v[i]</tt>, for \p i in the <tt>[0, n)</tt> range. If \p n is not
+     * zero, the result is always non-negative (contrary to gcd(), whose sign can depend on the signs and on the
+     * storage types of its arguments), otherwise \p out is left unchanged. The elements for which both \p out and
+     * <tt>*v[i]</tt> are static are processed by a binary GCD kernel working directly on the limbs (if 128-bit
+     * arithmetic is available), and the computation stops as soon as \p out becomes 1.
+     *
+     * \p out must be distinct from the objects pointed to by \p v.
+     *
+     * @param[in,out] out the output value.
+     * @param[in] v array of pointers to the arguments.
+     * @param[in] n size of the array.
+     */
+    static void gcd_n(mp_integer &out, const mp_integer *const *v, std::size_t n)
+    {
+        if (n == 0u) {
+            return;
+        }
+        gcd_n_impl(out, v, n);
+        if (out.sign() < 0) {
+            out.negate();
+        }
+    }
+
+private:
+    template <typename T = detail::static_integer<NBits>, typename std::enable_if<T::has_mac_kernel, int>::type = 0>
+    static void gcd_n_impl(mp_integer &out, const mp_integer *const *v, std::size_t n)
+    {
+        for (std::size_t i = 0u; i < n; ++i) {
+            piranha_assert(&out != v[i]);
+            if (likely(out.is_static() && v[i]->is_static())) {
+                out.m_int.g_st().gcd_kernel(v[i]->m_int.g_st());
+            } else {
+                gcd(out, out, *v[i]);
+            }
+            if (out.is_unitary()) {
+                return;
+            }
+        }
+    }
+    template <typename T = detail::static_integer<NBits>, typename std::enable_if<!T::has_mac_kernel, int>::type = 0>
+    static void gcd_n_impl(mp_integer &out, const mp_integer *const *v, std::size_t n)
+    {
+        for (std::size_t i = 0u; i < n && !out.is_unitary(); ++i) {
+            gcd(out, out, *v[i]);
+        }
+    }
 
 private:
     struct hash_checks {
@@ -4418,6 +4604,124 @@ private:
 /// Alias for piranha::mp_integer with default bit size.
 using integer = mp_integer<>;
 
+/// Arena for the limbs of multiprecision integers.
+/**
+ * The dynamic storage of piranha::mp_integer (as well as any other GMP object) is allocated and freed through the
+ * memory functions of GMP. When a series with a large number of multiprecision coefficients is computed in parallel,
+ * each promotion to dynamic storage and each temporary goes through the global allocator, and the destruction of the
+ * series results in one deallocation per coefficient.
+ *
+ * While an instance of piranha::mp_integer_arena_scope referring to an arena is alive in the current thread, the GMP
+ * allocations of the thread (up to 64 KiB each) are served from per-thread chunks of memory owned by the arena. The
+ * tasks enqueued in piranha::thread_pool from the thread use the same arena, so that, e.g., the coefficients of the
+ * result of a series multiplication performed within the scope are all allocated in the arena. The chunks are
+ * released in bulk upon the destruction of the arena.
+ *
+ * The lifetime of the arena is managed by the user, and it is not tied to the lifetime of the series whose
+ * coefficients it stores. Destroying such a series still visits each coefficient: the deallocation of a block goes
+ * through a lookup of its owning arena in a global lock-free table (a few loads), after which it is a no-op (or,
+ * within a scope of the owning arena, the recycling of the block), rather than a call to the system allocator.
+ *
+ * The arena must be destroyed after all the objects whose storage was allocated within its scopes. Objects that
+ * need to outlive the arena should be copied outside a scope: copy construction outside a scope allocates through
+ * the ordinary GMP functions, and so does a reallocation triggered outside a scope by a growing value. Objects
+ * caching GMP memory beyond the scope (e.g., thread-local instances of piranha::real) should not be first created
+ * within a scope.
+ *
+ * The GMP memory functions are replaced by piranha::init(), which must thus be called before creating an arena
+ * (and, as usual, before any other thread uses Piranha, GMP or MPFR). The replacement functions hand the blocks which
+ * do not belong to an arena back to the original functions. Arenas need thread-local storage: if it is not available,
+ * arenas are never used.
+ *
+ * Example:
+ * @code
+ * mp_integer_arena arena;
+ * {
+ *     polynomial<integer, k_monomial> res;
+ *     {
+ *         mp_integer_arena_scope scope(arena);
+ *         res = p1 * p2;
+ *     }
+ *     // Use res...
+ * }
+ * // res is destroyed before the arena.
+ * @endcode
+ */
+class mp_integer_arena
+{
+    friend class mp_integer_arena_scope;
+
+public:
+    /// Default constructor.
+    /**
+     * @throws unspecified any exception thrown by the constructor of \p std::mutex.
+     */
+    mp_integer_arena() = default;
+    /// Deleted copy constructor.
+    mp_integer_arena(const mp_integer_arena &) = delete;
+    /// Deleted move constructor.
+    mp_integer_arena(mp_integer_arena &&) = delete;
+    /// Deleted copy assignment operator.
+    mp_integer_arena &operator=(const mp_integer_arena &) = delete;
+    /// Deleted move assignment operator.
+    mp_integer_arena &operator=(mp_integer_arena &&) = delete;
+    /// Destructor.
+    /**
+     * All the memory owned by the arena will be released.
+     */
+    ~mp_integer_arena()
+    {
+        piranha_assert(detail::mpz_arena_current() != &m_impl);
+    }
+    /// Size.
+    /**
+     * @return the total size in bytes of the memory chunks owned by the arena.
+     */
+    std::size_t size() const
+    {
+        return m_impl.size();
+    }
+
+private:
+    detail::mpz_arena_impl m_impl;
+};
+
+/// Scope guard for piranha::mp_integer_arena.
+/**
+ * This class activates an arena in the current thread for the lifetime of the object. Scopes can be nested, the
+ * innermost one taking precedence. See the documentation of piranha::mp_integer_arena for details.
+ */
+class mp_integer_arena_scope
+{
+public:
+    /// Constructor.
+    /**
+     * @param[in] a the arena that will be used by the GMP allocations of the current thread.
+     */
+    explicit mp_integer_arena_scope(mp_integer_arena &a) : m_scope(&a.m_impl)
+    {
+    }
+    /// Deleted copy constructor.
+    mp_integer_arena_scope(const mp_integer_arena_scope &) = delete;
+    /// Deleted move constructor.
+    mp_integer_arena_scope(mp_integer_arena_scope &&) = delete;
+    /// Deleted copy assignment operator.
+    mp_integer_arena_scope &operator=(const mp_integer_arena_scope &) = delete;
+    /// Deleted move assignment operator.
+    mp_integer_arena_scope &operator=(mp_integer_arena_scope &&) = delete;
+    /// Check if an arena is active.
+    /**
+     * @return \p true if an arena is active in the current thread, \p false otherwise.
+     */
+    static bool is_active()
+    {
+        return detail::mpz_arena_current() != nullptr;
+    }
+
+private:
+    detail::mpz_arena_scope m_scope;
+};
+
 namespace detail
 {
 
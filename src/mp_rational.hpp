@@ -84,6 +84,76 @@ struct is_mp_rational_interoperable_type<T, Rational, typename std::enable_if<!i
 };
 }
 
+namespace detail
+{
+
+#if defined(PIRANHA_HAVE_THREAD_LOCAL)
+
+// Nesting depth of the lazy canonicalisation scopes in the current thread.
+template <typename = void>
+struct mp_rational_lazy_depth {
+    static thread_local unsigned value;
+};
+
+template <typename T>
+thread_local unsigned mp_rational_lazy_depth<T>::value = 0u;
+
+// Flag signalling that the current thread is merging coefficients into the result of a series multiplication
+// in lazy mode (see mp_rational_lazy_merge_guard).
+template <typename = void>
+struct mp_rational_lazy_merge {
+    static thread_local bool value;
+};
+
+template <typename T>
+thread_local bool mp_rational_lazy_merge<T>::value = false;
+
+#endif
+
+inline bool mp_rational_lazy_active()
+{
+#if defined(PIRANHA_HAVE_THREAD_LOCAL)
+    return mp_rational_lazy_depth<>::value != 0u;
+#else
+    // NOTE: the lazy mode needs thread-local storage, without it the mode is never active.
+    return false;
+#endif
+}
+
+inline bool mp_rational_lazy_merge_active()
+{
+#if defined(PIRANHA_HAVE_THREAD_LOCAL)
+    return mp_rational_lazy_merge<>::value;
+#else
+    return false;
+#endif
+}
+
+// Functor to canonicalise the rationals contained in an object of type T. The default
+// implementation does nothing.
+template <typename T, typename = void>
+struct lazy_canonicaliser {
+    void operator()(T &) const
+    {
+    }
+};
+
+// Coefficient arithmetics in the merging of series terms: x += y if Sign is true, x -= y otherwise. The
+// specialisation for rationals skips the canonicalisation while a mp_rational_lazy_merge_guard is alive.
+template <typename T, typename = void>
+struct merge_accumulator {
+    template <bool Sign, typename U>
+    static void apply(T &x, U &&y)
+    {
+        if (Sign) {
+            x += std::forward<U>(y);
+        } else {
+            x -= std::forward<U>(y);
+        }
+    }
+};
+}
+
 /// Multiple precision rational class.
 /**
  * This class encapsulates two instances of piranha::mp_integer to represent an arbitrary-precision rational number
@@ -92,7 +162,8 @@ struct is_mp_rational_interoperable_type<T, Rational, typename std::enable_if<!i
  * in the denominator.
  *
  * Unless otherwise specified, rational numbers are always kept in the usual canonical form in which numerator and
- * denominator are coprime, and the denominator is always positive. Zero is uniquely represented by 0/1.
+ * denominator are coprime, and the denominator is always positive. Zero is uniquely represented by 0/1. The only
+ * exceptions are the low-level methods _lazy_add() and _lazy_sub().
  *
  * ## Interoperability with other types ##
  *
@@ -232,6 +303,41 @@ private:
     {
         return m_num / m_den;
     }
+    // Addition or subtraction without canonicalisation (see _lazy_add()).
+    template <bool Sub>
+    void lazy_add_impl(const mp_rational &other)
+    {
+        if (m_den == other.m_den) {
+            // NOTE: safe if this and other coincide.
+            if (Sub) {
+                m_num -= other.m_num;
+            } else {
+                m_num += other.m_num;
+            }
+            return;
+        }
+        // NOTE: here dens are different, and thus this and other must be separate objects.
+        int_type q, r;
+        int_type::divrem(q, r, m_den, other.m_den);
+        if (r.sign() == 0) {
+            // The den of other divides the den of this: scale the num of other and accumulate.
+            if (Sub) {
+                q.negate();
+            }
+            math::multiply_accumulate(m_num, q, other.m_num);
+        } else {
+            // The general case, as in in_place_add() but without canonicalisation.
+            m_num *= other.m_den;
+            if (Sub) {
+                m_den.negate();
+            }
+            math::multiply_accumulate(m_num, m_den, other.m_num);
+            if (Sub) {
+                m_den.negate();
+            }
+            m_den *= other.m_den;
+        }
+    }
     // In-place add.
     mp_rational &in_place_add(const mp_rational &other)
     {
@@ -1065,6 +1171,34 @@ public:
         }
         m_den = den;
     }
+    /// Lazy in-place addition.
+    /**
+     * This method will add \p other to \p this without canonicalising the result. If the denominator of \p other
+     * divides the denominator of \p this, only the numerator of \p this is updated, otherwise the denominators
+     * are multiplied. The result is mathematically correct, but it might not be in canonical form: before being used
+     * in any operation other than _lazy_add(), _lazy_sub() and piranha::math::is_zero(), it must be canonicalised via
+     * canonicalise().
+     *
+     * @param[in] other the addend.
+     *
+     * @throws unspecified any exception thrown by the arithmetic operations of piranha::mp_integer.
+     */
+    void _lazy_add(const mp_rational &other)
+    {
+        lazy_add_impl<false>(other);
+    }
+    /// Lazy in-place subtraction.
+    /**
+     * This method is the subtraction counterpart of _lazy_add().
+     *
+     * @param[in] other the subtrahend.
+     *
+     * @throws unspecified any exception thrown by the arithmetic operations of piranha::mp_integer.
+     */
+    void _lazy_sub(const mp_rational &other)
+    {
+        lazy_add_impl<true>(other);
+    }
     //@}
     /// Identity operator.
     /**
@@ -1814,8 +1948,141 @@ using rational_pow_enabler =
 // Binomial follows the same rules as pow.
 template <typename T, typename U>
 using rational_binomial_enabler = rational_pow_enabler<T, U>;
+
+template <typename T>
+struct lazy_canonicaliser<T, typename std::enable_if<is_mp_rational<T>::value>::type> {
+    void operator()(T &q) const
+    {
+        // NOTE: the lazy operations never make the den non-positive, hence a unitary den means canonical.
+        if (!q.den().is_unitary()) {
+            q.canonicalise();
+        }
+    }
+};
+
+template <typename T>
+struct merge_accumulator<T, typename std::enable_if<is_mp_rational<T>::value>::type> {
+    template <bool Sign>
+    static void apply(T &x, const T &y)
+    {
+        if (mp_rational_lazy_merge_active()) {
+            if (Sign) {
+                x._lazy_add(y);
+            } else {
+                x._lazy_sub(y);
+            }
+        } else if (Sign) {
+            x += y;
+        } else {
+            x -= y;
+        }
+    }
+};
+
+// RAII class to merge the rational coefficients of series without canonicalisation in the current thread (see
+// merge_accumulator), if flag is true. This is used by the series multipliers when merging terms into the result, which
+// must then be canonicalised via lazy_canonicaliser before being returned.
+class mp_rational_lazy_merge_guard
+{
+public:
+    explicit mp_rational_lazy_merge_guard(bool flag) : m_flag(flag)
+    {
+#if defined(PIRANHA_HAVE_THREAD_LOCAL)
+        if (m_flag) {
+            m_old = mp_rational_lazy_merge<>::value;
+            mp_rational_lazy_merge<>::value = true;
+        }
+#endif
+    }
+    ~mp_rational_lazy_merge_guard()
+    {
+#if defined(PIRANHA_HAVE_THREAD_LOCAL)
+        if (m_flag) {
+            mp_rational_lazy_merge<>::value = m_old;
+        }
+#endif
+    }
+    mp_rational_lazy_merge_guard(const mp_rational_lazy_merge_guard &) = delete;
+    mp_rational_lazy_merge_guard(mp_rational_lazy_merge_guard &&) = delete;
+    mp_rational_lazy_merge_guard &operator=(const mp_rational_lazy_merge_guard &) = delete;
+    mp_rational_lazy_merge_guard &operator=(mp_rational_lazy_merge_guard &&) = delete;
+
+private:
+    const bool m_flag;
+    bool m_old = false;
+};
 }
 
+/// Scoped lazy canonicalisation mode for piranha::mp_rational.
+/**
+ * The merging of terms in the multiplication of series normally canonicalises the rational coefficients after
+ * each accumulation, which involves the computation of a GCD. When the coefficients of the result are themselves
+ * series with rational coefficients (e.g., Poisson series with polynomial coefficients), the same rational is
+ * typically updated many times before being used, and most of these GCDs are wasted.
+ *
+ * While at least one instance of this class is alive in the current thread, the series multiplications started
+ * from the current thread will merge the rational coefficients of the result lazily (see
+ * piranha::mp_rational::_lazy_add()), and they will canonicalise them once, before the result is returned. The
+ * laziness is confined to the merging of the terms of the result: the arithmetic operators, the comparisons and the
+ * arithmetics of the keys (e.g., monomials with rational exponents) always operate on canonical values, and no
+ * non-canonical rational is ever visible outside the multiplication.
+ *
+ * The lazy mode relies on thread-local storage. If thread-local storage is not available, the mode will never be
+ * active and instances of this class will have no effect.
+ *
+ * Example:
+ * @code
+ * poisson_series<polynomial<rational, k_monomial>> a, b;
+ * // ...
+ * {
+ *     mp_rational_lazy_scope scope;
+ *     auto c = a * b;
+ * }
+ * @endcode
+ */
+class mp_rational_lazy_scope
+{
+public:
+    /// Default constructor.
+    /**
+     * The constructor will activate the lazy canonicalisation mode in the current thread.
+     */
+    mp_rational_lazy_scope()
+    {
+#if defined(PIRANHA_HAVE_THREAD_LOCAL)
+        ++detail::mp_rational_lazy_depth<>::value;
+#endif
+    }
+    /// Deleted copy constructor.
+    mp_rational_lazy_scope(const mp_rational_lazy_scope &) = delete;
+    /// Deleted move constructor.
+    mp_rational_lazy_scope(mp_rational_lazy_scope &&) = delete;
+    /// Deleted copy assignment operator.
+    mp_rational_lazy_scope &operator=(const mp_rational_lazy_scope &) = delete;
+    /// Deleted move assignment operator.
+    mp_rational_lazy_scope &operator=(mp_rational_lazy_scope &&) = delete;
+    /// Destructor.
+    /**
+     * The destructor will end the lazy canonicalisation mode for this scope. The lazy mode stays active in the
+     * current thread while other instances of this class are alive.
+     */
+    ~mp_rational_lazy_scope()
+    {
+#if defined(PIRANHA_HAVE_THREAD_LOCAL)
+        piranha_assert(detail::mp_rational_lazy_depth<>::value != 0u);
+        --detail::mp_rational_lazy_depth<>::value;
+#endif
+    }
+    /// Check if the lazy canonicalisation mode is active.
+    /**
+     * @return \p true if the lazy canonicalisation mode is active in the current thread, \p false otherwise.
+     */
+    static bool is_active()
+    {
+        return detail::mp_rational_lazy_active();
+    }
+};
+
 /// Specialisation of the piranha::print_tex_coefficient() functor for piranha::mp_rational.
 template <typename T>
 struct print_tex_coefficient_impl<T, typename std::enable_if<detail::is_mp_rational<T>::value>::type> {
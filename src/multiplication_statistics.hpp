@@ -0,0 +1,305 @@
+/* Copyright 2009-2016 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#ifndef PIRANHA_MULTIPLICATION_STATISTICS_HPP
+#define PIRANHA_MULTIPLICATION_STATISTICS_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "config.hpp"
+#include "mp_integer.hpp"
+#include "mp_rational.hpp"
+#include "perf_counters.hpp"
+
+namespace piranha
+{
+
+/// Statistics of a series multiplication.
+/**
+ * This structure is filled by piranha::base_series_multiplier (and by the multipliers derived from it)
+ * when the collection of statistics is enabled via piranha::multiplication_instrumentation::set_enabled().
+ * A value-initialised instance has all its members set to zero (or empty).
+ */
+struct multiplication_statistics {
+    /// Number of threads used in the multiplication.
+    unsigned n_threads;
+    /// Number of terms in the larger operand.
+    unsigned long long size1;
+    /// Number of terms in the smaller operand.
+    unsigned long long size2;
+    /// Number of term-by-term multiplications.
+    unsigned long long n_term_products;
+    /// \p true if the size of the result was estimated before the multiplication.
+    bool estimated;
+    /// Estimated size of the result (zero if the size was not estimated).
+    unsigned long long estimated_size;
+    /// Number of terms in the result.
+    unsigned long long actual_size;
+    /// Number of terms removed by piranha::base_series_multiplier::sanitise_series() (e.g., because of cancellations).
+    unsigned long long n_cancellations;
+    /// Number of buckets in the result after the initial setup (i.e., after the rehash following the estimation).
+    unsigned long long initial_bucket_count;
+    /// Number of buckets in the result.
+    unsigned long long bucket_count;
+    /// Number of rehash operations performed on the result.
+    /**
+     * This counts both the rehash following the estimation of the size of the result and the rehashes due to the
+     * growth of the table during the multiplication. The value is always zero if thread-local storage is not
+     * available.
+     */
+    unsigned long long n_rehashes;
+    /// Load factor of the result.
+    double load_factor;
+    /// Number of coefficients of the operands stored in dynamic (heap-allocated) storage.
+    /**
+     * This value is nonzero only for piranha::mp_integer and piranha::mp_rational coefficients.
+     */
+    unsigned long long n_dynamic_cfs_operands;
+    /// Number of coefficients of the result stored in dynamic (heap-allocated) storage.
+    /**
+     * This value is nonzero only for piranha::mp_integer and piranha::mp_rational coefficients. The difference
+     * with respect to multiplication_statistics::n_dynamic_cfs_operands gives an indication of the promotions
+     * from static to dynamic storage that took place during the multiplication.
+     */
+    unsigned long long n_dynamic_cfs;
+    /// Busy time of each thread, in seconds.
+    std::vector<double> thread_busy_times;
+    /// Number of tasks run by each thread.
+    /**
+     * A task is a block of rows of the first operand in the plain multiplication, and a zone of the result
+     * (or a block of term-by-term multiplications in the single-threaded case) in the Kronecker multiplication.
+     */
+    std::vector<unsigned long long> thread_task_counts;
+    /// Number of term-by-term multiplications writing into each zone of the result.
+    /**
+     * This vector is not empty only for the multithreaded Kronecker multiplication of polynomials.
+     */
+    std::vector<unsigned long long> zone_sizes;
+    /// Total time of the multiplication, in seconds.
+    double total_time;
+    /// Hardware performance counters collected during the multiplication.
+    /**
+     * The counters are collected only if enabled via
+     * piranha::multiplication_instrumentation_::set_perf_counters_enabled(), otherwise they are all flagged
+     * as unavailable.
+     */
+    perf_counter_values perf_counters;
+};
+
+namespace detail
+{
+
+template <typename = void>
+struct base_multiplication_instrumentation {
+    static std::atomic<bool> s_enabled;
+    static std::atomic<bool> s_perf_counters_enabled;
+    static std::mutex s_mutex;
+    static multiplication_statistics s_last;
+};
+
+template <typename T>
+std::atomic<bool> base_multiplication_instrumentation<T>::s_enabled(false);
+
+template <typename T>
+std::atomic<bool> base_multiplication_instrumentation<T>::s_perf_counters_enabled(false);
+
+template <typename T>
+std::mutex base_multiplication_instrumentation<T>::s_mutex;
+
+template <typename T>
+multiplication_statistics base_multiplication_instrumentation<T>::s_last = multiplication_statistics();
+
+// Detect coefficients stored in dynamic storage.
+template <typename T>
+inline bool is_dynamic_cf(const T &)
+{
+    return false;
+}
+
+template <int NBits>
+inline bool is_dynamic_cf(const mp_integer<NBits> &n)
+{
+    return !n.is_static();
+}
+
+template <int NBits>
+inline bool is_dynamic_cf(const mp_rational<NBits> &q)
+{
+    return !q.num().is_static() || !q.den().is_static();
+}
+
+// Record the busy time and the number of tasks of a thread in a multiplication. Does nothing if
+// the statistics pointer is null.
+class thread_work_recorder
+{
+public:
+    explicit thread_work_recorder(multiplication_statistics *s, std::size_t idx) : m_s(s), m_idx(idx), m_n_tasks(0u)
+    {
+        if (m_s) {
+            m_start = std::chrono::steady_clock::now();
+        }
+    }
+    thread_work_recorder(const thread_work_recorder &) = delete;
+    thread_work_recorder &operator=(const thread_work_recorder &) = delete;
+    ~thread_work_recorder()
+    {
+        if (m_s) {
+            piranha_assert(m_idx < m_s->thread_busy_times.size() && m_idx < m_s->thread_task_counts.size());
+            m_s->thread_busy_times[m_idx]
+                += std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count();
+            m_s->thread_task_counts[m_idx] += m_n_tasks;
+        }
+    }
+    void add_tasks(unsigned long long n)
+    {
+        m_n_tasks += n;
+    }
+
+private:
+    multiplication_statistics *m_s;
+    const std::size_t m_idx;
+    unsigned long long m_n_tasks;
+    std::chrono::steady_clock::time_point m_start;
+};
+}
+
+/// Instrumentation of series multiplication.
+/**
+ * \note
+ * The template parameter in this class is unused: its only purpose is to prevent the instantiation
+ * of the class' methods if they are not explicitly used. Client code should always employ the
+ * piranha::multiplication_instrumentation alias.
+ *
+ * This class allows to enable the collection of piranha::multiplication_statistics in series multiplications.
+ * The collection is disabled by default: when disabled, the only overhead in a multiplication is the check of the
+ * flag in the constructor of piranha::base_series_multiplier. When enabled, the statistics of the last completed
+ * multiplication (in any thread) can be retrieved via get_last_statistics(). Note that, for series with series
+ * coefficients, the multiplications of the coefficients are multiplications as well: the statistics of the outer
+ * multiplication are published after those of the coefficients.
+ *
+ * All the methods in this class are thread-safe.
+ */
+template <typename = void>
+class multiplication_instrumentation_ : private detail::base_multiplication_instrumentation<>
+{
+public:
+    /// Enable or disable the collection of statistics.
+    /**
+     * @param flag \p true to enable the collection of statistics, \p false to disable it.
+     */
+    static void set_enabled(bool flag)
+    {
+        s_enabled.store(flag);
+    }
+    /// Check if the collection of statistics is enabled.
+    /**
+     * @return \p true if the collection of statistics is enabled, \p false otherwise. The default value is \p false.
+     */
+    static bool get_enabled()
+    {
+        return s_enabled.load();
+    }
+    /// Disable the collection of statistics.
+    static void reset_enabled()
+    {
+        s_enabled.store(false);
+    }
+    /// Enable or disable the collection of hardware performance counters.
+    /**
+     * If enabled, multiplication_statistics::perf_counters will contain the hardware performance counters
+     * collected via piranha::perf_counters during the multiplication. The collection of the counters has
+     * effect only if the collection of statistics is enabled as well. Note that setting up the counters
+     * requires a few system calls for each thread in the process, and thus it adds a considerable overhead to
+     * small multiplications.
+     *
+     * @param flag \p true to enable the collection of the counters, \p false to disable it.
+     */
+    static void set_perf_counters_enabled(bool flag)
+    {
+        s_perf_counters_enabled.store(flag);
+    }
+    /// Check if the collection of hardware performance counters is enabled.
+    /**
+     * @return \p true if the collection of the counters is enabled, \p false otherwise. The default value
+     * is \p false.
+     */
+    static bool get_perf_counters_enabled()
+    {
+        return s_perf_counters_enabled.load();
+    }
+    /// Disable the collection of hardware performance counters.
+    static void reset_perf_counters_enabled()
+    {
+        s_perf_counters_enabled.store(false);
+    }
+    /// Get the statistics of the last multiplication.
+    /**
+     * @return the statistics of the last multiplication completed while the collection of statistics was enabled,
+     * or a value-initialised piranha::multiplication_statistics if no such multiplication took place
+     * (or after a call to clear_last_statistics()).
+     *
+     * @throws unspecified any exception thrown by memory allocation errors in standard containers.
+     */
+    static multiplication_statistics get_last_statistics()
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        return s_last;
+    }
+    /// Clear the statistics of the last multiplication.
+    static void clear_last_statistics()
+    {
+        multiplication_statistics tmp = multiplication_statistics();
+        std::lock_guard<std::mutex> lock(s_mutex);
+        std::swap(s_last, tmp);
+    }
+    /// Publish the statistics of a multiplication.
+    /**
+     * This method is used by piranha::base_series_multiplier to store the statistics of a completed multiplication.
+     *
+     * @param s the statistics to be published.
+     */
+    static void _publish(multiplication_statistics s)
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        std::swap(s_last, s);
+    }
+};
+
+/// Alias for piranha::multiplication_instrumentation_.
+/**
+ * This is the alias through which the methods in piranha::multiplication_instrumentation_ should be called.
+ */
+using multiplication_instrumentation = multiplication_instrumentation_<>;
+}
+
+#endif
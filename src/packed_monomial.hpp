@@ -0,0 +1,1412 @@
+/* Copyright 2009-2016 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#ifndef PIRANHA_PACKED_MONOMIAL_HPP
+#define PIRANHA_PACKED_MONOMIAL_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "config.hpp"
+#include "detail/cf_mult_impl.hpp"
+#include "detail/km_commons.hpp"
+#include "detail/prepare_for_print.hpp"
+#include "detail/safe_integral_adder.hpp"
+#include "exceptions.hpp"
+#include "is_cf.hpp"
+#include "is_key.hpp"
+#include "math.hpp"
+#include "mp_integer.hpp"
+#include "mp_rational.hpp"
+#include "pow.hpp"
+#include "s11n.hpp"
+#include "safe_cast.hpp"
+#include "static_vector.hpp"
+#include "symbol.hpp"
+#include "symbol_set.hpp"
+#include "term.hpp"
+#include "type_traits.hpp"
+
+namespace piranha
+{
+
+// Fwd declaration.
+template <typename, unsigned>
+class packed_monomial;
+}
+
+// Implementation of the Boost s11n api.
+namespace boost
+{
+namespace serialization
+{
+
+template <typename Archive, typename T, unsigned W>
+inline void save(Archive &ar, const piranha::boost_s11n_key_wrapper<piranha::packed_monomial<T, W>> &k, unsigned)
+{
+    if (std::is_same<Archive, boost::archive::binary_oarchive>::value) {
+        piranha::boost_save(ar, k.key().get_int());
+    } else {
+        auto tmp = k.key().unpack(k.ss());
+        piranha::boost_save(ar, tmp);
+    }
+}
+
+template <typename Archive, typename T, unsigned W>
+inline void load(Archive &ar, piranha::boost_s11n_key_wrapper<piranha::packed_monomial<T, W>> &k, unsigned)
+{
+    if (std::is_same<Archive, boost::archive::binary_iarchive>::value) {
+        T value;
+        piranha::boost_load(ar, value);
+        k.key().set_int(value);
+    } else {
+        typename piranha::packed_monomial<T, W>::v_type tmp;
+        piranha::boost_load(ar, tmp);
+        if (unlikely(tmp.size() != k.ss().size())) {
+            piranha_throw(std::invalid_argument, "invalid size detected in the deserialization of a packed "
+                                                 "monomial: the deserialized size is "
+                                                     + std::to_string(tmp.size())
+                                                     + " but the reference symbol set has a size of "
+                                                     + std::to_string(k.ss().size()));
+        }
+        k.key() = piranha::packed_monomial<T, W>(tmp);
+    }
+}
+
+template <typename Archive, typename T, unsigned W>
+inline void serialize(Archive &ar, piranha::boost_s11n_key_wrapper<piranha::packed_monomial<T, W>> &k,
+                      unsigned version)
+{
+    split_free(ar, k, version);
+}
+}
+}
+
+namespace piranha
+{
+
+/// Packed monomial class.
+/**
+ * This class represents a multivariate monomial with non-negative integral exponents. The exponents are packed in an
+ * unsigned integer of type \p T, each exponent occupying a bit field of fixed width \p W whose most significant bit is
+ * kept as a guard bit. The exponent of the first variable is stored in the least significant field, and each exponent
+ * must be in the \f$ \left[0, 2^{W-1}-1\right] \f$ range. The maximum number of variables is the number of fields
+ * fitting in \p T.
+ *
+ * As in piranha::kronecker_monomial, the multiplication of two monomials is a single integral addition. Thanks to the
+ * guard bits, the addition of two valid packed monomials never carries over into the neighbouring fields, and an
+ * overflow in any exponent is detected by testing the guard bits of the result. This allows the polynomial multiplier
+ * to skip the bounds checking pre-pass required by piranha::kronecker_monomial, at the price of a lower range for the
+ * exponents.
+ *
+ * This class satisfies the piranha::is_key, piranha::key_has_degree, piranha::key_has_ldegree and
+ * piranha::key_is_differentiable type traits.
+ *
+ * ## Type requirements ##
+ *
+ * \p T must be an unsigned C++ integral type with at most 64 bits, and \p W must be in the range from 2 to the bit
+ * width of \p T. The default type for \p T is \p std::uint_least64_t, the default value for \p W is 8.
+ *
+ * ## Exception safety guarantee ##
+ *
+ * Unless otherwise specified, this class provides the strong exception safety guarantee for all operations.
+ *
+ * ## Move semantics ##
+ *
+ * The move semantics of this class are equivalent to the move semantics of C++ unsigned integral types.
+ */
+template <typename T = std::uint_least64_t, unsigned W = 8u>
+class packed_monomial
+{
+    static_assert(std::is_integral<T>::value && std::is_unsigned<T>::value && !std::is_same<T, bool>::value,
+                  "The value type of a packed monomial must be an unsigned C++ integral type.");
+    static_assert(std::numeric_limits<T>::digits <= 64, "Invalid bit width for the value type of a packed monomial.");
+    static_assert(W >= 2u && W <= static_cast<unsigned>(std::numeric_limits<T>::digits),
+                  "Invalid field width for a packed monomial.");
+
+public:
+    /// Alias for \p T.
+    typedef T value_type;
+    /// Width of the bit fields.
+    static const unsigned field_width = W;
+    /// Maximum number of variables.
+    static const std::size_t max_size = static_cast<std::size_t>(std::numeric_limits<T>::digits / W);
+    /// Vector type used for temporary packing/unpacking.
+    using v_type = static_vector<value_type, max_size>;
+    /// Size type.
+    /**
+     * Used to represent the number of variables in the monomial. Equivalent to the size type of
+     * piranha::packed_monomial::v_type.
+     */
+    using size_type = typename v_type::size_type;
+
+private:
+#if !defined(PIRANHA_DOXYGEN_INVOKED)
+    static const unsigned nbits = static_cast<unsigned>(std::numeric_limits<T>::digits);
+    // Bits used by the fields.
+    static const unsigned used_bits = static_cast<unsigned>(max_size) * W;
+    // Shift between the terms summed in the computation of the hash: the largest multiple of W
+    // not greater than 16 (or W itself, if larger than 16).
+    static const unsigned hash_shift = W >= 16u ? W : (16u / W) * W;
+    static const unsigned n_hash_terms = (used_bits + hash_shift - 1u) / hash_shift;
+    // Masks and constants:
+    // - the mask of a single field,
+    // - the mask of all the guard bits,
+    // - the masks used in the SWAR computation of the degree, one for each pairwise reduction step,
+    // - the number of reduction steps,
+    // - the multipliers used in the computation of the hash.
+    struct masks_type {
+        T m_field_mask;
+        T m_guard_mask;
+        std::array<T, 6u> m_degree_masks;
+        unsigned m_degree_steps;
+        std::array<std::size_t, n_hash_terms> m_hash_mults;
+    };
+    static const masks_type s_masks;
+    // Mask with the lowest w bits set, for w <= nbits.
+    static T low_mask(unsigned w)
+    {
+        return w >= nbits ? T(~T(0)) : static_cast<T>((T(1) << w) - T(1));
+    }
+    static masks_type determine_masks()
+    {
+        masks_type retval;
+        retval.m_field_mask = low_mask(W);
+        retval.m_guard_mask = T(0);
+        for (unsigned i = 0u; i < max_size; ++i) {
+            retval.m_guard_mask = static_cast<T>(retval.m_guard_mask | (T(1) << (i * W + W - 1u)));
+        }
+        // Pairwise reduction steps: at each step, the fields of width w are summed in pairs into
+        // fields of width 2w, until a single field spans all the bits in use.
+        retval.m_degree_masks.fill(T(0));
+        unsigned steps = 0u;
+        for (unsigned w = W; w < used_bits; w *= 2u, ++steps) {
+            piranha_assert(steps < retval.m_degree_masks.size());
+            T mask(0);
+            for (unsigned k = 0u; 2u * k * w < nbits; ++k) {
+                mask = static_cast<T>(mask | (low_mask(w) << (2u * k * w)));
+            }
+            retval.m_degree_masks[steps] = mask;
+        }
+        retval.m_degree_steps = steps;
+        // The first multiplier is 1, so that monomials differing by one in the first exponent
+        // land in neighbouring buckets. The others are odd multiples of the golden ratio constant.
+        const auto golden = static_cast<std::size_t>(0x9E3779B97F4A7C15ull);
+        retval.m_hash_mults[0u] = 1u;
+        for (unsigned i = 1u; i < n_hash_terms; ++i) {
+            retval.m_hash_mults[i] = static_cast<std::size_t>(golden * (2u * i + 1u));
+        }
+        return retval;
+    }
+    // Codec used in the km_commons routines.
+    struct codec {
+        template <typename Vector>
+        static T encode(const Vector &v)
+        {
+            const auto n = v.size();
+            if (unlikely(n > max_size)) {
+                piranha_throw(std::invalid_argument, "the number of exponents exceeds the maximum size of a packed "
+                                                     "monomial");
+            }
+            const T max_expo = static_cast<T>(s_masks.m_field_mask >> 1u);
+            T retval(0);
+            for (decltype(v.size()) i = 0u; i < n; ++i) {
+                if (unlikely(v[i] > max_expo)) {
+                    piranha_throw(std::invalid_argument, "an exponent is outside the range allowed by the "
+                                                         "packed monomial representation");
+                }
+                retval = static_cast<T>(retval | (static_cast<T>(v[i]) << (i * W)));
+            }
+            return retval;
+        }
+        template <typename Vector>
+        static void decode(Vector &v, const T &value)
+        {
+            for (decltype(v.size()) i = 0u; i < v.size(); ++i) {
+                v[i] = static_cast<T>((value >> (i * W)) & s_masks.m_field_mask);
+            }
+        }
+    };
+    // Eval and sub typedef.
+    template <typename U, typename = void>
+    struct eval_type_ {
+    };
+    template <typename U>
+    using e_type = decltype(math::pow(std::declval<U const &>(), std::declval<value_type const &>()));
+    template <typename U>
+    struct eval_type_<U, typename std::enable_if<is_multipliable_in_place<e_type<U>>::value
+                                                 && std::is_constructible<e_type<U>, int>::value
+                                                 && detail::is_pmappable<U>::value>::type> {
+        using type = e_type<U>;
+    };
+    // The final typedef.
+    template <typename U>
+    using eval_type = typename eval_type_<U>::type;
+    // Enabler for pow.
+    template <typename U>
+    using pow_enabler = typename std::
+        enable_if<has_safe_cast<T, decltype(std::declval<integer &&>() * std::declval<const U &>())>::value, int>::type;
+    // Enabler for multiply().
+    template <typename Cf>
+    using multiply_enabler = typename std::enable_if<detail::true_tt<detail::cf_mult_enabler<Cf>>::value, int>::type;
+    // Subs utilities.
+    template <typename U>
+    using subs_type__ = decltype(math::pow(std::declval<const U &>(), std::declval<const value_type &>()));
+    template <typename U, typename = void>
+    struct subs_type_ {
+    };
+    template <typename U>
+    struct subs_type_<U,
+                      typename std::enable_if<std::is_constructible<subs_type__<U>, int>::value
+                                              && std::is_assignable<subs_type__<U> &, subs_type__<U>>::value>::type> {
+        using type = subs_type__<U>;
+    };
+    template <typename U>
+    using subs_type = typename subs_type_<U>::type;
+    // ipow subs utilities.
+    template <typename U>
+    using ipow_subs_type__ = decltype(math::pow(std::declval<const U &>(), std::declval<const integer &>()));
+    template <typename U, typename = void>
+    struct ipow_subs_type_ {
+    };
+    template <typename U>
+    struct ipow_subs_type_<U, typename std::enable_if<std::is_constructible<ipow_subs_type__<U>, int>::value
+                                                      && std::is_assignable<ipow_subs_type__<U> &,
+                                                                            ipow_subs_type__<U>>::value>::type> {
+        using type = ipow_subs_type__<U>;
+    };
+    template <typename U>
+    using ipow_subs_type = typename ipow_subs_type_<U>::type;
+    // Enablers for the ctors from container, init list and iterator.
+    template <typename U>
+    using container_ctor_enabler =
+        typename std::enable_if<has_begin_end<const U>::value
+                                    && has_safe_cast<T, typename std::iterator_traits<decltype(
+                                                            std::begin(std::declval<const U &>()))>::value_type>::value,
+                                int>::type;
+    template <typename U>
+    using init_list_ctor_enabler = container_ctor_enabler<std::initializer_list<U>>;
+    template <typename Iterator>
+    using it_ctor_enabler = typename std::
+        enable_if<is_input_iterator<Iterator>::value
+                      && has_safe_cast<value_type, typename std::iterator_traits<Iterator>::value_type>::value,
+                  int>::type;
+    // Implementation of the ctor from range.
+    template <typename Iterator>
+    typename v_type::size_type construct_from_range(Iterator begin, Iterator end)
+    {
+        v_type tmp;
+        for (; begin != end; ++begin) {
+            tmp.push_back(safe_cast<value_type>(*begin));
+        }
+        m_value = codec::encode(tmp);
+        return tmp.size();
+    }
+    // Degree utils.
+    using degree_type = decltype(std::declval<const T &>() + std::declval<const T &>());
+#endif
+public:
+    /// Arity of the multiply() method.
+    static const std::size_t multiply_arity = 1u;
+    /// Default constructor.
+    /**
+     * After construction all exponents in the monomial will be zero.
+     */
+    packed_monomial() : m_value(0)
+    {
+    }
+    /// Defaulted copy constructor.
+    packed_monomial(const packed_monomial &) = default;
+    /// Defaulted move constructor.
+    packed_monomial(packed_monomial &&) = default;
+    /// Constructor from container.
+    /**
+     * \note
+     * This constructor is enabled only if \p U satisfies piranha::has_begin_end, and the value type
+     * of the iterator type of \p U can be safely cast to \p T.
+     *
+     * This constructor will build internally a vector of values from the input container \p c, encode it and assign the
+     * result
+     * to the internal integer instance. The value type of the container is converted to \p T using
+     * piranha::safe_cast().
+     *
+     * @param[in] c the input container.
+     *
+     * @throws std::bad_alloc if the container has a size greater than piranha::packed_monomial::max_size.
+     * @throws unspecified any exception thrown by:
+     * - piranha::packed_monomial::encode(),
+     * - piranha::safe_cast(),
+     * - piranha::static_vector::push_back().
+     */
+    template <typename U, container_ctor_enabler<U> = 0>
+    explicit packed_monomial(const U &c) : m_value(0)
+    {
+        construct_from_range(std::begin(c), std::end(c));
+    }
+    /// Constructor from initializer list.
+    /**
+     * \note
+     * This constructor is enabled only if the corresponding constructor from container is enabled.
+     *
+     * This constructor is identical to the constructor from container. It is provided for convenience.
+     *
+     * @param[in] list the input initializer list.
+     *
+     * @throws unspecified any exception thrown by the constructor from container.
+     */
+    template <typename U, init_list_ctor_enabler<U> = 0>
+    explicit packed_monomial(std::initializer_list<U> list) : m_value(0)
+    {
+        construct_from_range(list.begin(), list.end());
+    }
+    /// Constructor from range.
+    /**
+     * \note
+     * This constructor is enabled only if \p Iterator is an input iterator whose value type
+     * is safely convertible to \p T.
+     *
+     * This constructor will build internally a vector of values from the input iterators, encode it and assign the
+     * result
+     * to the internal integer instance. The value type of the iterator is converted to \p T using
+     * piranha::safe_cast().
+     *
+     * @param[in] begin beginning of the range.
+     * @param[in] end end of the range.
+     *
+     * @throws std::bad_alloc if the distance between \p begin and \p end is greater than
+     * piranha::packed_monomial::max_size.
+     * @throws unspecified any exception thrown by:
+     * - piranha::packed_monomial::encode(),
+     * - piranha::safe_cast(),
+     * - piranha::static_vector::push_back(),
+     * - increment and dereference of the input iterators.
+     */
+    template <typename Iterator, it_ctor_enabler<Iterator> = 0>
+    explicit packed_monomial(Iterator begin, Iterator end) : m_value(0)
+    {
+        construct_from_range(begin, end);
+    }
+    /// Constructor from range and symbol set.
+    /**
+     * \note
+     * This constructor is enabled only if the corresponding range constructor is enabled.
+     *
+     * This constructor is identical to the constructor from range. In addition, after construction
+     * it will also check that the distance between \p begin and \p end is equal to the size of \p s.
+     * This constructor is used by piranha::polynomial::find_cf().
+     *
+     * @param[in] begin beginning of the range.
+     * @param[in] end end of the range.
+     * @param[in] s reference symbol set.
+     *
+     * @throws std::invalid_argument if the distance between \p begin and \p end is different from
+     * the size of \p s.
+     * @throws unspecified any exception thrown by the constructor from range.
+     */
+    template <typename Iterator, it_ctor_enabler<Iterator> = 0>
+    explicit packed_monomial(Iterator begin, Iterator end, const symbol_set &s) : m_value(0)
+    {
+        if (unlikely(construct_from_range(begin, end) != s.size())) {
+            piranha_throw(std::invalid_argument, "invalid packed monomial");
+        }
+    }
+    /// Constructor from set of symbols.
+    /**
+     * After construction all exponents in the monomial will be zero.
+     *
+     * @param[in] args reference set of piranha::symbol.
+     *
+     * @throws unspecified any exception thrown by:
+     * - piranha::packed_monomial::encode(),
+     * - piranha::static_vector::push_back().
+     */
+    explicit packed_monomial(const symbol_set &args)
+    {
+        // NOTE: this does incur in some overhead, but on the other hand it runs all sorts of
+        // checks on the size of args, the size of tmp, the encoding limits, etc. Probably it is
+        // better to leave it like this at the moment, unless it becomes a serious bottleneck.
+        v_type tmp;
+        for (auto it = args.begin(); it != args.end(); ++it) {
+            tmp.push_back(value_type(0));
+        }
+        m_value = codec::encode(tmp);
+    }
+    /// Converting constructor.
+    /**
+     * This constructor is for use when converting from one term type to another in piranha::series. It will
+     * set the internal integer instance to the same value of \p other, after having checked that
+     * \p other is compatible with \p args.
+     *
+     * @param[in] other construction argument.
+     * @param[in] args reference set of piranha::symbol.
+     *
+     * @throws std::invalid_argument if \p other is not compatible with \p args.
+     */
+    explicit packed_monomial(const packed_monomial &other, const symbol_set &args) : m_value(other.m_value)
+    {
+        if (unlikely(!other.is_compatible(args))) {
+            piranha_throw(std::invalid_argument, "incompatible arguments");
+        }
+    }
+    /// Constructor from \p value_type.
+    /**
+     * This constructor will initialise the internal integer instance
+     * to \p n.
+     *
+     * @param[in] n initializer for the internal integer instance.
+     */
+    explicit packed_monomial(const value_type &n) : m_value(n)
+    {
+    }
+    /// Trivial destructor.
+    ~packed_monomial()
+    {
+        PIRANHA_TT_CHECK(is_key, packed_monomial);
+        PIRANHA_TT_CHECK(key_has_degree, packed_monomial);
+        PIRANHA_TT_CHECK(key_has_ldegree, packed_monomial);
+        PIRANHA_TT_CHECK(key_is_differentiable, packed_monomial);
+    }
+    /// Defaulted copy assignment operator.
+    packed_monomial &operator=(const packed_monomial &) = default;
+    /// Defaulted move assignment operator.
+    packed_monomial &operator=(packed_monomial &&) = default;
+    /// Set the internal integer instance.
+    /**
+     * @param[in] n value to which the internal integer instance will be set.
+     */
+    void set_int(const value_type &n)
+    {
+        m_value = n;
+    }
+    /// Get internal instance.
+    /**
+     * @return value of the internal integer instance.
+     */
+    value_type get_int() const
+    {
+        return m_value;
+    }
+    /// Compatibility check.
+    /**
+     * Monomial is considered incompatible if any of these conditions holds:
+     *
+     * - the size of \p args is greater than piranha::packed_monomial::max_size,
+     * - the internal integer has bits set outside the fields used by the exponents of \p args,
+     * - any of the guard bits is set.
+     *
+     * Otherwise, the monomial is considered to be compatible for insertion.
+     *
+     * @param[in] args reference set of piranha::symbol.
+     *
+     * @return compatibility flag for the monomial.
+     */
+    bool is_compatible(const symbol_set &args) const noexcept
+    {
+        const auto s = args.size();
+        if (s > max_size) {
+            return false;
+        }
+        // NOTE: s * W <= used_bits <= nbits.
+        const auto s_bits = static_cast<unsigned>(s) * W;
+        return !(m_value & static_cast<T>(~low_mask(s_bits))) && !(m_value & s_masks.m_guard_mask);
+    }
+    /// Ignorability check.
+    /**
+     * A monomial is never considered ignorable.
+     *
+     * @return \p false.
+     */
+    bool is_ignorable(const symbol_set &) const noexcept
+    {
+        return false;
+    }
+    /// Merge arguments.
+    /**
+     * Merge the new arguments set \p new_args into \p this, given the current reference arguments set
+     * \p orig_args.
+     *
+     * @param[in] orig_args original arguments set.
+     * @param[in] new_args new arguments set.
+     *
+     * @return monomial with merged arguments.
+     *
+     * @throws std::invalid_argument if at least one of these conditions is true:
+     * - the size of \p new_args is not greater than the size of \p orig_args,
+     * - not all elements of \p orig_args are included in \p new_args.
+     * @throws unspecified any exception thrown by:
+     * - piranha::packed_monomial::encode(),
+     * - piranha::static_vector::push_back(),
+     * - unpack().
+     */
+    packed_monomial merge_args(const symbol_set &orig_args, const symbol_set &new_args) const
+    {
+        return packed_monomial(detail::km_merge_args<v_type, codec>(orig_args, new_args, m_value));
+    }
+    /// Check if monomial is unitary.
+    /**
+     * @param[in] args reference set of piranha::symbol.
+     *
+     * @return \p true if all the exponents are zero, \p false otherwise.
+     *
+     * @throws std::invalid_argument if \p this is not compatible with \p args.
+     */
+    bool is_unitary(const symbol_set &args) const
+    {
+        if (unlikely(!is_compatible(args))) {
+            piranha_throw(std::invalid_argument, "invalid symbol set");
+        }
+        // The packed value will be zero if all components are zero.
+        return !m_value;
+    }
+    /// Degree.
+    /**
+     * The type returned by this method is the type resulting from the addition of two instances
+     * of \p T.
+     *
+     * @param[in] args reference set of symbols.
+     *
+     * @return degree of the monomial.
+     *
+     * @throws std::invalid_argument if \p this is not compatible with \p args.
+     */
+    degree_type degree(const symbol_set &args) const
+    {
+        if (unlikely(!is_compatible(args))) {
+            piranha_throw(std::invalid_argument, "invalid symbol set");
+        }
+        // Sum the exponents in a SIMD-within-a-register fashion: at each step neighbouring fields
+        // are summed pairwise into fields of double width. The sum of n exponents each smaller than
+        // 2**(W-1) always fits in n*W bits, hence the reduction never overflows the fields.
+        T x(m_value);
+        unsigned w = W;
+        for (unsigned i = 0u; i < s_masks.m_degree_steps; ++i, w *= 2u) {
+            const T &m = s_masks.m_degree_masks[i];
+            x = static_cast<T>((x & m) + ((x >> w) & m));
+        }
+        return static_cast<degree_type>(x);
+    }
+    /// Low degree (equivalent to the degree).
+    degree_type ldegree(const symbol_set &args) const
+    {
+        return degree(args);
+    }
+    /// Partial degree.
+    /**
+     * Partial degree of the monomial: only the symbols at the positions specified by \p p are considered.
+     * The type returned by this method is the type resulting from the addition of two instances
+     * of \p T.
+     *
+     * @param[in] p positions of the symbols to be considered in the calculation of the degree.
+     * @param[in] args reference set of piranha::symbol.
+     *
+     * @return the summation of the exponents of the monomial at the positions specified by \p p.
+     *
+     * @throws std::invalid_argument if \p p is not compatible with \p args.
+     * @throws std::overflow_error if the computation of the degree overflows.
+     * @throws unspecified any exception thrown by unpack().
+     */
+    degree_type degree(const symbol_set::positions &p, const symbol_set &args) const
+    {
+        const auto tmp = unpack(args);
+        piranha_assert(tmp.size() == args.size());
+        if (unlikely(p.size() && p.back() >= tmp.size())) {
+            piranha_throw(std::invalid_argument, "invalid positions");
+        }
+        auto cit = tmp.begin();
+        degree_type retval(0);
+        for (const auto &i : p) {
+            detail::safe_integral_adder(retval, static_cast<degree_type>(cit[i]));
+        }
+        return retval;
+    }
+    /// Partial low degree (equivalent to the partial degree).
+    degree_type ldegree(const symbol_set::positions &p, const symbol_set &args) const
+    {
+        return degree(p, args);
+    }
+    /// Multiply terms with a packed monomial key.
+    /**
+     * \note
+     * This method is enabled only if \p Cf satisfies piranha::is_cf and piranha::has_mul3.
+     *
+     * Multiply \p t1 by \p t2, storing the result in the only element of \p res. This method
+     * offers the basic exception safety guarantee. If \p Cf is an instance of piranha::mp_rational, then
+     * only the numerators of the coefficients will be multiplied.
+     *
+     * The key of the return value is generated directly from the addition of the values of the input keys.
+     * If the addition sets any of the guard bits, an error will be raised.
+     *
+     * @param[out] res return value.
+     * @param[in] t1 first argument.
+     * @param[in] t2 second argument.
+     * @param[in] args reference set of piranha::symbol.
+     *
+     * @throws std::overflow_error if the multiplication overflows any of the exponents.
+     * @throws unspecified any exception thrown by piranha::math::mul3().
+     */
+    template <typename Cf, multiply_enabler<Cf> = 0>
+    static void multiply(std::array<term<Cf, packed_monomial>, multiply_arity> &res,
+                         const term<Cf, packed_monomial> &t1, const term<Cf, packed_monomial> &t2,
+                         const symbol_set &args)
+    {
+        auto &t = res[0u];
+        // Coefficient first.
+        detail::cf_mult_impl(t.m_cf, t1.m_cf, t2.m_cf);
+        // Now the key.
+        multiply(t.m_key, t1.m_key, t2.m_key, args);
+    }
+    /// Multiply packed monomials.
+    /**
+     * Multiply \p a by \p b, storing the result in \p res. The multiplication is performed
+     * as an integral addition of the packed values.
+     *
+     * @param[out] res return value.
+     * @param[in] a first argument.
+     * @param[in] b second argument.
+     *
+     * @throws std::overflow_error if the multiplication overflows any of the exponents.
+     */
+    static void multiply(packed_monomial &res, const packed_monomial &a, const packed_monomial &b,
+                         const symbol_set &)
+    {
+        // NOTE: the sum of two compatible values cannot overflow T, as the top field
+        // has its guard bit clear in both operands.
+        const T tmp = static_cast<T>(a.m_value + b.m_value);
+        if (unlikely(tmp & s_masks.m_guard_mask)) {
+            piranha_throw(std::overflow_error, "overflow in the multiplication of two packed monomials");
+        }
+        res.m_value = tmp;
+    }
+    /// Divide packed monomials.
+    /**
+     * Divide \p a by \p b, storing the result in \p res. The division is performed as a subtraction
+     * of the packed values, with the guard bits preventing borrows across fields.
+     *
+     * @param[out] res return value.
+     * @param[in] a first argument.
+     * @param[in] b second argument.
+     *
+     * @throws std::invalid_argument if any of the exponents of the result would be negative.
+     */
+    static void divide(packed_monomial &res, const packed_monomial &a, const packed_monomial &b,
+                       const symbol_set &)
+    {
+        const T &g_mask = s_masks.m_guard_mask;
+        // Set the guard bits in the dividend before subtracting: a field of the result will
+        // have its guard bit cleared only if the corresponding exponent of b is larger than the one in a.
+        const T tmp = static_cast<T>((a.m_value | g_mask) - b.m_value);
+        if (unlikely((tmp & g_mask) != g_mask)) {
+            piranha_throw(std::invalid_argument, "negative exponent in the division of two packed monomials");
+        }
+        res.m_value = static_cast<T>(tmp & static_cast<T>(~g_mask));
+    }
+    /// Guard mask.
+    /**
+     * @return an integral value in which only the guard bits of all the fields are set.
+     */
+    static T get_guard_mask()
+    {
+        return s_masks.m_guard_mask;
+    }
+    /// Hash value.
+    /**
+     * The hash value is computed as a linear combination of the internal integral value shifted by multiples of the
+     * field width, so that the low bits of the hash depend on all the exponents. The hash is additive, that is, the
+     * hash of the product of two monomials is the sum (modulo \f$ 2^n \f$, where \f$ n \f$ is the bit width of
+     * \p std::size_t) of the hashes of the factors.
+     *
+     * @return a hash value for \p this.
+     */
+    std::size_t hash() const
+    {
+        // NOTE: the shifts are multiples of the field width, hence they are linear on values whose
+        // fields do not carry over into each other.
+        std::size_t retval = 0u;
+        for (unsigned i = 0u; i < n_hash_terms; ++i) {
+            retval = static_cast<std::size_t>(
+                retval + static_cast<std::size_t>(m_value >> (i * hash_shift)) * s_masks.m_hash_mults[i]);
+        }
+        return retval;
+    }
+    /// Equality operator.
+    /**
+     * @param[in] other comparison argument.
+     *
+     * @return \p true if the internal integral instance of \p this is equal to the integral instance of \p other,
+     * \p false otherwise.
+     */
+    bool operator==(const packed_monomial &other) const
+    {
+        return m_value == other.m_value;
+    }
+    /// Inequality operator.
+    /**
+     * @param[in] other comparison argument.
+     *
+     * @return the opposite of operator==().
+     */
+    bool operator!=(const packed_monomial &other) const
+    {
+        return m_value != other.m_value;
+    }
+    /// Name of the linear argument.
+    /**
+     * If the monomial is linear in a variable (i.e., all exponents are zero apart from a single unitary
+     * exponent), the name of the variable will be returned. Otherwise, an error will be raised.
+     *
+     * @param[in] args reference set of piranha::symbol.
+     *
+     * @return name of the linear variable.
+     *
+     * @throws std::invalid_argument if the monomial is not linear.
+     * @throws unspecified any exception thrown by unpack().
+     */
+    std::string linear_argument(const symbol_set &args) const
+    {
+        const auto v = unpack(args);
+        const auto size = args.size();
+        decltype(args.size()) n_linear = 0u, candidate = 0u;
+        for (typename v_type::size_type i = 0u; i < size; ++i) {
+            integer tmp = safe_cast<integer>(v[i]);
+            if (tmp.sign() == 0) {
+                continue;
+            }
+            if (tmp != 1) {
+                piranha_throw(std::invalid_argument, "exponent is not unitary");
+            }
+            candidate = i;
+            ++n_linear;
+        }
+        if (n_linear != 1u) {
+            piranha_throw(std::invalid_argument, "monomial is not linear");
+        }
+        return args[static_cast<decltype(args.size())>(candidate)].get_name();
+    }
+    /// Exponentiation.
+    /**
+     * \note
+     * This method is enabled only if \p U is multipliable by piranha::integer and the result type can be
+     * safely cast back to \p T.
+     *
+     * Will return a monomial corresponding to \p this raised to the <tt>x</tt>-th power. The exponentiation
+     * is computed via the multiplication of the exponents promoted to piranha::integer by \p x. The result will
+     * be cast back to \p T via piranha::safe_cast().
+     *
+     * @param[in] x exponent.
+     * @param[in] args reference set of piranha::symbol.
+     *
+     * @return \p this to the power of \p x.
+     *
+     * @throws unspecified any exception thrown by:
+     * - unpack(),
+     * - piranha::safe_cast(),
+     * - the constructor and multiplication operator of piranha::integer,
+     * - piranha::packed_monomial::encode().
+     */
+    template <typename U, pow_enabler<U> = 0>
+    packed_monomial pow(const U &x, const symbol_set &args) const
+    {
+        auto v = unpack(args);
+        for (auto &n : v) {
+            n = safe_cast<value_type>(integer(n) * x);
+        }
+        packed_monomial retval;
+        retval.m_value = codec::encode(v);
+        return retval;
+    }
+    /// Unpack internal integer instance.
+    /**
+     * Will decode the internal integral instance into a piranha::static_vector of size equal to the size of \p args.
+     *
+     * @param[in] args reference set of piranha::symbol.
+     *
+     * @return piranha::static_vector containing the exponents stored in the bit fields of the internal
+     * integral instance.
+     *
+     * @throws std::invalid_argument if the size of \p args is larger than piranha::packed_monomial::max_size.
+     */
+    v_type unpack(const symbol_set &args) const
+    {
+        return detail::km_unpack<v_type, codec>(args, m_value);
+    }
+    /// Print.
+    /**
+     * Will print to stream a human-readable representation of the monomial.
+     *
+     * @param[in] os target stream.
+     * @param[in] args reference set of piranha::symbol.
+     *
+     * @throws unspecified any exception thrown by unpack() or by streaming instances of \p value_type.
+     */
+    void print(std::ostream &os, const symbol_set &args) const
+    {
+        const auto tmp = unpack(args);
+        piranha_assert(tmp.size() == args.size());
+        const value_type zero(0), one(1);
+        bool empty_output = true;
+        for (decltype(tmp.size()) i = 0u; i < tmp.size(); ++i) {
+            if (tmp[i] != zero) {
+                if (!empty_output) {
+                    os << '*';
+                }
+                os << args[i].get_name();
+                empty_output = false;
+                if (tmp[i] != one) {
+                    os << "**" << detail::prepare_for_print(tmp[i]);
+                }
+            }
+        }
+    }
+    /// Print in TeX mode.
+    /**
+     * Will print to stream a TeX representation of the monomial. As the exponents of a packed monomial are
+     * never negative, no fraction is ever produced.
+     *
+     * @param[in] os target stream.
+     * @param[in] args reference set of piranha::symbol.
+     *
+     * @throws unspecified any exception thrown by unpack() or by streaming instances of \p value_type.
+     */
+    void print_tex(std::ostream &os, const symbol_set &args) const
+    {
+        const auto tmp = unpack(args);
+        const value_type zero(0), one(1);
+        for (decltype(tmp.size()) i = 0u; i < tmp.size(); ++i) {
+            if (tmp[i] != zero) {
+                os << "{" << args[i].get_name() << "}";
+                if (tmp[i] != one) {
+                    os << "^{" << static_cast<unsigned long long>(tmp[i]) << "}";
+                }
+            }
+        }
+    }
+    /// Partial derivative.
+    /**
+     * This method will return the partial derivative of \p this with respect to the symbol at the position indicated by
+     * \p p.
+     * The result is a pair consisting of the exponent associated to \p p before differentiation and the monomial itself
+     * after differentiation. If \p p is empty or if the exponent associated to it is zero,
+     * the returned pair will be <tt>(0,packed_monomial{args})</tt>.
+     *
+     * @param[in] p position of the symbol with respect to which the differentiation will be calculated.
+     * @param[in] args reference set of piranha::symbol.
+     *
+     * @return result of the differentiation.
+     *
+     * @throws std::invalid_argument if \p p is incompatible with \p args or it has a size greater than one.
+     * @throws unspecified any exception thrown by:
+     * - unpack(),
+     * - piranha::math::is_zero(),
+     * - piranha::packed_monomial::encode().
+     */
+    std::pair<T, packed_monomial> partial(const symbol_set::positions &p, const symbol_set &args) const
+    {
+        auto v = unpack(args);
+        // Cannot take derivative wrt more than one variable, and the position of that variable
+        // must be compatible with the monomial.
+        if (p.size() > 1u || (p.size() == 1u && p.back() >= args.size())) {
+            piranha_throw(std::invalid_argument, "invalid size of symbol_set::positions");
+        }
+        // Derivative wrt a variable not in the monomial: position is empty, or refers to a
+        // variable with zero exponent.
+        // NOTE: safe to take v.begin() here, as the checks on the positions above ensure
+        // there is a valid position and hence the size must be not zero.
+        if (!p.size() || math::is_zero(v.begin()[*p.begin()])) {
+            return std::make_pair(T(0), packed_monomial(args));
+        }
+        auto v_b = v.begin();
+        // Original exponent.
+        T n(v_b[*p.begin()]);
+        // Decrement the exponent in the monomial. This cannot overflow, as n is not zero.
+        v_b[*p.begin()] = static_cast<T>(n - T(1));
+        packed_monomial tmp_km;
+        tmp_km.m_value = codec::encode(v);
+        return std::make_pair(n, std::move(tmp_km));
+    }
+    /// Integration.
+    /**
+     * Will return the antiderivative of \p this with respect to symbol \p s. The result is a pair
+     * consisting of the exponent associated to \p s increased by one and the monomial itself
+     * after integration. If \p s is not in \p args, the returned monomial will have an extra exponent
+     * set to 1 in the same position \p s would have if it were added to \p args.
+     *
+     * @param[in] s symbol with respect to which the integration will be calculated.
+     * @param[in] args reference set of piranha::symbol.
+     *
+     * @return result of the integration.
+     *
+     * @throws std::invalid_argument if the integration would require more than piranha::packed_monomial::max_size
+     * exponents, or if the new exponent is outside the range allowed by the packed representation.
+     * @throws unspecified any exception thrown by:
+     * - unpack(),
+     * - piranha::math::is_zero(),
+     * - piranha::static_vector::push_back(),
+     * - piranha::packed_monomial::encode().
+     */
+    std::pair<T, packed_monomial> integrate(const symbol &s, const symbol_set &args) const
+    {
+        v_type v = unpack(args), retval;
+        value_type expo(0), one(1);
+        if (unlikely(args.size() == max_size && std::find(args.begin(), args.end(), s) == args.end())) {
+            piranha_throw(std::invalid_argument, "unable to perform monomial integration: the maximum number of "
+                                                 "exponents would be exceeded");
+        }
+        for (min_int<typename v_type::size_type, decltype(args.size())> i = 0u; i < args.size(); ++i) {
+            if (math::is_zero(expo) && s < args[i]) {
+                // If we went past the position of s in args and still we
+                // have not performed the integration, it means that we need to add
+                // a new exponent.
+                retval.push_back(one);
+                expo = one;
+            }
+            retval.push_back(v[i]);
+            if (args[i] == s) {
+                // NOTE: here using i is safe: if retval gained an extra exponent in the condition above,
+                // we are never going to land here as args[i] is at this point never going to be s.
+                // NOTE: the exponent is at most 2**(w-1)-1, so the increment cannot overflow value_type; the range
+                // of the new exponent is checked in encode().
+                retval[i] = static_cast<value_type>(retval[i] + value_type(1));
+                expo = retval[i];
+            }
+        }
+        // If expo is still zero, it means we need to add a new exponent at the end.
+        if (math::is_zero(expo)) {
+            retval.push_back(one);
+            expo = one;
+        }
+        return std::make_pair(expo, packed_monomial(codec::encode(retval)));
+    }
+    /// Evaluation.
+    /**
+     * \note
+     * This method is available only if \p U satisfies the following requirements:
+     * - it can be used in piranha::symbol_set::positions_map,
+     * - it can be used in piranha::math::pow() with the monomial exponents as powers, yielding a type \p eval_type,
+     * - \p eval_type is constructible from \p int,
+     * - \p eval_type is multipliable in place.
+     *
+     * The return value will be built by iteratively applying piranha::math::pow() using the values provided
+     * by \p pmap as bases and the values in the monomial as exponents. If the size of the monomial is zero, 1 will be
+     * returned. If the positions in \p pmap do not reference
+     * only and all the exponents in the monomial, an error will be thrown.
+     *
+     * @param[in] pmap piranha::symbol_set::positions_map that will be used for substitution.
+     * @param[in] args reference set of piranha::symbol.
+     *
+     * @return the result of evaluating \p this with the values provided in \p pmap.
+     *
+     * @throws std::invalid_argument if \p pmap is not compatible with \p args.
+     * @throws unspecified any exception thrown by:
+     * - unpack(),
+     * - construction of the return type,
+     * - piranha::math::pow() or the in-place multiplication operator of the return type.
+     */
+    template <typename U>
+    eval_type<U> evaluate(const symbol_set::positions_map<U> &pmap, const symbol_set &args) const
+    {
+        using return_type = eval_type<U>;
+        using size_type = typename v_type::size_type;
+        // NOTE: here we can check the pmap size only against args.
+        if (unlikely(pmap.size() != args.size() || (pmap.size() && pmap.back().first != pmap.size() - 1u))) {
+            piranha_throw(std::invalid_argument, "invalid positions map for evaluation");
+        }
+        auto v = unpack(args);
+        return_type retval(1);
+        auto it = pmap.begin();
+        for (min_int<size_type, decltype(args.size())> i = 0u; i < args.size(); ++i, ++it) {
+            piranha_assert(it != pmap.end() && it->first == i);
+            retval *= math::pow(it->second, v[i]);
+        }
+        piranha_assert(it == pmap.end());
+        return retval;
+    }
+    /// Substitution.
+    /**
+     * \note
+     * This method is enabled only if:
+     * - \p U can be raised to the value type, yielding a type \p subs_type,
+     * - \p subs_type can be constructed from \p int and it is assignable.
+     *
+     * The algorithm is equivalent to the one implemented in piranha::monomial::subs().
+     *
+     * @param[in] s name of the symbol that will be substituted.
+     * @param[in] x quantity that will be substituted in place of \p s.
+     * @param[in] args reference set of piranha::symbol.
+     *
+     * @return the result of substituting \p x for \p s.
+     *
+     * @throws unspecified any exception thrown by:
+     * - unpack(),
+     * - construction and assignment of the return value,
+     * - piranha::math::pow(),
+     * - piranha::static_vector::push_back(),
+     * - piranha::packed_monomial::encode().
+     */
+    template <typename U>
+    std::vector<std::pair<subs_type<U>, packed_monomial>> subs(const std::string &s, const U &x,
+                                                                  const symbol_set &args) const
+    {
+        using s_type = subs_type<U>;
+        std::vector<std::pair<s_type, packed_monomial>> retval;
+        const auto v = unpack(args);
+        v_type new_v;
+        s_type retval_s(1);
+        for (min_int<typename v_type::size_type, decltype(args.size())> i = 0u; i < args.size(); ++i) {
+            if (args[i].get_name() == s) {
+                retval_s = math::pow(x, v[i]);
+                new_v.push_back(value_type(0));
+            } else {
+                new_v.push_back(v[i]);
+            }
+        }
+        piranha_assert(new_v.size() == v.size());
+        retval.push_back(std::make_pair(std::move(retval_s), packed_monomial(codec::encode(new_v))));
+        return retval;
+    }
+    /// Substitution of integral power.
+    /**
+     * \note
+     * This method is enabled only if:
+     * - \p U can be raised to a piranha::integer power, yielding a type \p subs_type,
+     * - \p subs_type is constructible from \p int and assignable.
+     *
+     * This method works in the same way as piranha::monomial::ipow_subs().
+     *
+     * @param[in] s name of the symbol that will be substituted.
+     * @param[in] n power of \p s that will be substituted.
+     * @param[in] x quantity that will be substituted in place of \p s to the power of \p n.
+     * @param[in] args reference set of piranha::symbol.
+     *
+     * @return the result of substituting \p x for \p s to the power of \p n.
+     *
+     * @throws unspecified any exception thrown by:
+     * - unpack(),
+     * - construction and assignment of the return value,
+     * - construction of piranha::rational,
+     * - piranha::safe_cast(),
+     * - piranha::math::pow(),
+     * - piranha::static_vector::push_back(),
+     * - the in-place subtraction operator of the exponent type,
+     * - piranha::packed_monomial::encode().
+     */
+    template <typename U>
+    std::vector<std::pair<ipow_subs_type<U>, packed_monomial>> ipow_subs(const std::string &s, const integer &n,
+                                                                            const U &x, const symbol_set &args) const
+    {
+        using s_type = ipow_subs_type<U>;
+        const auto v = unpack(args);
+        v_type new_v;
+        s_type retval_s(1);
+        for (min_int<typename v_type::size_type, decltype(args.size())> i = 0u; i < args.size(); ++i) {
+            new_v.push_back(v[i]);
+            if (args[i].get_name() == s) {
+                const rational tmp(safe_cast<integer>(v[i]), n);
+                if (tmp >= 1) {
+                    const auto tmp_t = static_cast<integer>(tmp);
+                    retval_s = math::pow(x, tmp_t);
+                    new_v[i] -= tmp_t * n;
+                }
+            }
+        }
+        std::vector<std::pair<s_type, packed_monomial>> retval;
+        retval.push_back(std::make_pair(std::move(retval_s), packed_monomial(codec::encode(new_v))));
+        return retval;
+    }
+    /// Identify symbols that can be trimmed.
+    /**
+     * This method is used in piranha::series::trim(). The input parameter \p candidates
+     * contains a set of symbols that are candidates for elimination. The method will remove
+     * from \p candidates those symbols whose exponent in \p this is not zero.
+     *
+     * @param[in] candidates set of candidates for elimination.
+     * @param[in] args reference arguments set.
+     *
+     * @throws unspecified any exception thrown by:
+     * - unpack(),
+     * - piranha::math::is_zero(),
+     * - piranha::symbol_set::remove().
+     */
+    void trim_identify(symbol_set &candidates, const symbol_set &args) const
+    {
+        return detail::km_trim_identify<v_type, codec>(candidates, args, m_value);
+    }
+    /// Trim.
+    /**
+     * This method will return a copy of \p this with the exponents associated to the symbols
+     * in \p trim_args removed.
+     *
+     * @param[in] trim_args arguments whose exponents will be removed.
+     * @param[in] orig_args original arguments set.
+     *
+     * @return trimmed copy of \p this.
+     *
+     * @throws unspecified any exception thrown by:
+     * - unpack(),
+     * - piranha::static_vector::push_back().
+     */
+    packed_monomial trim(const symbol_set &trim_args, const symbol_set &orig_args) const
+    {
+        return packed_monomial(detail::km_trim<v_type, codec>(trim_args, orig_args, m_value));
+    }
+    /// Comparison operator.
+    /**
+     * @param[in] other comparison argument.
+     *
+     * @return \p true if the internal integral value of \p this is less than the internal
+     * integral value of \p other, \p false otherwise.
+     */
+    bool operator<(const packed_monomial &other) const
+    {
+        return m_value < other.m_value;
+    }
+    /// Extract the vector of exponents.
+    /**
+     * This method will write into \p out the content of \p this. If necessary, \p out will
+     * be resized to match the size of \p args.
+     *
+     * @param[out] out vector into which the exponents will be copied.
+     * @param[in] args reference set of arguments.
+     *
+     * @throws unspecified any exception thrown by:
+     * - piranha::safe_cast(),
+     * - the resizing of \p out,
+     * - unpack().
+     */
+    void extract_exponents(std::vector<value_type> &out, const symbol_set &args) const
+    {
+        using v_size_type = decltype(out.size());
+        auto tmp = unpack(args);
+        if (unlikely(out.size() != args.size())) {
+            out.resize(safe_cast<v_size_type>(args.size()));
+        }
+        std::copy(tmp.begin(), tmp.end(), out.begin());
+    }
+    /// Split.
+    /**
+     * This method will split \p this into two monomials: the second monomial will contain the exponent
+     * of the first variable in \p args, the first monomial will contain all the other exponents.
+     *
+     * @param[in] args reference arguments set.
+     *
+     * @return a pair of monomials, the second one containing the first exponent, the first one containing all the
+     * other exponents.
+     *
+     * @throws std::invalid_argument if the size of \p args is less than 2.
+     * @throws unspecified any exception thrown by unpack() or by the constructor from a range.
+     */
+    std::pair<packed_monomial, packed_monomial> split(const symbol_set &args) const
+    {
+        if (unlikely(args.size() < 2u)) {
+            piranha_throw(std::invalid_argument, "only monomials with 2 or more variables can be split");
+        }
+        auto tmp = unpack(args);
+        return std::make_pair(packed_monomial(tmp.begin() + 1, tmp.end()), packed_monomial(tmp[0u]));
+    }
+    /// Detect negative exponents.
+    /**
+     * The exponents of a packed monomial are unsigned, hence this method always returns \p false.
+     *
+     * @return \p false.
+     */
+    bool has_negative_exponent(const symbol_set &) const noexcept
+    {
+        return false;
+    }
+
+#if defined(PIRANHA_WITH_MSGPACK)
+private:
+    // Enablers for msgpack serialization.
+    template <typename Stream>
+    using msgpack_pack_enabler = enable_if_t<conjunction<is_msgpack_stream<Stream>, has_msgpack_pack<Stream, T>,
+                                                         has_msgpack_pack<Stream, v_type>>::value,
+                                             int>;
+    template <typename U>
+    using msgpack_convert_enabler = enable_if_t<conjunction<has_msgpack_convert<typename U::value_type>,
+                                                            has_msgpack_convert<typename U::v_type>>::value,
+                                                int>;
+
+public:
+    /// Serialize in msgpack format.
+    /**
+     * \note
+     * This method is activated only if \p Stream satisfies piranha::is_msgpack_stream and both \p T and
+     * piranha::packed_monomial::v_type satisfy piranha::has_msgpack_pack.
+     *
+     * This method will pack \p this into \p packer. The packed object is the internal integral instance in binary
+     * format, an array of exponents in portable format.
+     *
+     * @param[in] packer the target packer.
+     * @param[in] f the serialization format.
+     * @param[in] s reference arguments set.
+     *
+     * @throws unspecified any exception thrown by unpack() or piranha::msgpack_pack().
+     */
+    template <typename Stream, msgpack_pack_enabler<Stream> = 0>
+    void msgpack_pack(msgpack::packer<Stream> &packer, msgpack_format f, const symbol_set &s) const
+    {
+        if (f == msgpack_format::binary) {
+            piranha::msgpack_pack(packer, m_value, f);
+        } else {
+            auto tmp = unpack(s);
+            piranha::msgpack_pack(packer, tmp, f);
+        }
+    }
+    /// Deserialize from msgpack object.
+    /**
+     * \note
+     * This method is activated only if both \p T and piranha::packed_monomial::v_type satisfy
+     * piranha::has_msgpack_convert.
+     *
+     * This method will deserialize \p o into \p this. In binary mode, no check is performed on the content of \p o,
+     * and calling this method will result in undefined behaviour if \p o does not contain a monomial serialized via
+     * msgpack_pack().
+     *
+     * @param[in] o msgpack object that will be deserialized.
+     * @param[in] f serialization format.
+     * @param[in] s reference arguments set.
+     *
+     * @throws std::invalid_argument if the size of the deserialized array differs from the size of \p s.
+     * @throws unspecified any exception thrown by:
+     * - the constructor of piranha::packed_monomial from a container,
+     * - piranha::msgpack_convert().
+     */
+    template <typename U = packed_monomial, msgpack_convert_enabler<U> = 0>
+    void msgpack_convert(const msgpack::object &o, msgpack_format f, const symbol_set &s)
+    {
+        if (f == msgpack_format::binary) {
+            piranha::msgpack_convert(m_value, o, f);
+        } else {
+            v_type tmp;
+            piranha::msgpack_convert(tmp, o, f);
+            if (unlikely(tmp.size() != s.size())) {
+                piranha_throw(std::invalid_argument, "incompatible symbol set in monomial serialization: the reference "
+                                                     "symbol set has a size of "
+                                                         + std::to_string(s.size())
+                                                         + ", while the monomial being deserialized has a size of "
+                                                         + std::to_string(tmp.size()));
+            }
+            *this = packed_monomial(tmp);
+        }
+    }
+
+#endif
+
+private:
+    value_type m_value;
+};
+
+// Static initialisation.
+template <typename T, unsigned W>
+const typename packed_monomial<T, W>::masks_type packed_monomial<T, W>::s_masks
+    = packed_monomial<T, W>::determine_masks();
+
+inline namespace impl
+{
+
+template <typename Archive, typename T, unsigned W>
+using p_monomial_boost_save_enabler
+    = enable_if_t<conjunction<has_boost_save<Archive, T>,
+                              has_boost_save<Archive, typename packed_monomial<T, W>::v_type>>::value>;
+
+template <typename Archive, typename T, unsigned W>
+using p_monomial_boost_load_enabler
+    = enable_if_t<conjunction<has_boost_load<Archive, T>,
+                              has_boost_load<Archive, typename packed_monomial<T, W>::v_type>>::value>;
+}
+
+/// Specialisation of piranha::boost_save() for piranha::packed_monomial.
+/**
+ * \note
+ * This specialisation is enabled only if \p T and piranha::packed_monomial::v_type satisfy
+ * piranha::has_boost_save.
+ *
+ * If \p Archive is \p boost::archive::binary_oarchive, the internal integral instance is saved.
+ * Otherwise, the monomial is unpacked and the vector of exponents is saved.
+ *
+ * @throws unspecified any exception thrown by piranha::boost_save() or piranha::packed_monomial::unpack().
+ */
+template <typename Archive, typename T, unsigned W>
+struct boost_save_impl<Archive, boost_s11n_key_wrapper<packed_monomial<T, W>>,
+                       p_monomial_boost_save_enabler<Archive, T, W>>
+    : boost_save_via_boost_api<Archive, boost_s11n_key_wrapper<packed_monomial<T, W>>> {
+};
+
+/// Specialisation of piranha::boost_load() for piranha::packed_monomial.
+/**
+ * \note
+ * This specialisation is enabled only if \p T and piranha::packed_monomial::v_type satisfy
+ * piranha::has_boost_load.
+ *
+ * @throws std::invalid_argument if the size of the serialized monomial is different from the size of the symbol set.
+ * @throws unspecified any exception thrown by:
+ * - piranha::boost_load(),
+ * - the constructor of piranha::packed_monomial from a container.
+ */
+template <typename Archive, typename T, unsigned W>
+struct boost_load_impl<Archive, boost_s11n_key_wrapper<packed_monomial<T, W>>,
+                       p_monomial_boost_load_enabler<Archive, T, W>>
+    : boost_load_via_boost_api<Archive, boost_s11n_key_wrapper<packed_monomial<T, W>>> {
+};
+}
+
+namespace std
+{
+
+/// Specialisation of \p std::hash for piranha::packed_monomial.
+template <typename T, unsigned W>
+struct hash<piranha::packed_monomial<T, W>> {
+    /// Result type.
+    using result_type = size_t;
+    /// Argument type.
+    using argument_type = piranha::packed_monomial<T, W>;
+    /// Hash operator.
+    /**
+     * @param[in] a argument whose hash value will be computed.
+     *
+     * @return hash value of \p a computed via piranha::packed_monomial::hash().
+     */
+    result_type operator()(const argument_type &a) const
+    {
+        return a.hash();
+    }
+};
+}
+
+#endif
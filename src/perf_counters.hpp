@@ -0,0 +1,366 @@
+/* Copyright 2009-2016 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#ifndef PIRANHA_PERF_COUNTERS_HPP
+#define PIRANHA_PERF_COUNTERS_HPP
+
+#if defined(__linux__)
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#endif
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include "config.hpp"
+#include "exceptions.hpp"
+
+namespace piranha
+{
+
+/// Hardware performance counters.
+/**
+ * The hardware events that can be counted via piranha::perf_counters.
+ */
+enum class perf_counter {
+    /// CPU cycles.
+    cycles,
+    /// Retired instructions.
+    instructions,
+    /// Last-level cache misses.
+    llc_misses,
+    /// Data TLB misses (read accesses).
+    dtlb_misses,
+    /// Mispredicted branches.
+    branch_misses
+};
+
+/// Values of the hardware performance counters.
+/**
+ * This structure stores the values of the hardware performance counters collected by piranha::perf_counters
+ * over a region of code, together with the wall time of the region. The counters which could not be collected
+ * are flagged as unavailable and their value is zero.
+ */
+struct perf_counter_values {
+    /// Number of counters.
+    static constexpr std::size_t n_counters = 5u;
+    /// Check the availability of a counter.
+    /**
+     * @param c the counter.
+     *
+     * @return \p true if the value of \p c was collected, \p false otherwise.
+     */
+    bool is_available(perf_counter c) const
+    {
+        return available[static_cast<std::size_t>(c)];
+    }
+    /// Get the value of a counter.
+    /**
+     * @param c the counter.
+     *
+     * @return the value of \p c (zero if \p c is not available).
+     */
+    unsigned long long get(perf_counter c) const
+    {
+        return values[static_cast<std::size_t>(c)];
+    }
+    /// Instructions per cycle.
+    /**
+     * @return the number of instructions per cycle, or zero if the counters of cycles and instructions are not
+     * available (or no cycle was counted).
+     */
+    double ipc() const
+    {
+        if (!is_available(perf_counter::cycles) || !is_available(perf_counter::instructions)
+            || !get(perf_counter::cycles)) {
+            return 0.;
+        }
+        return static_cast<double>(get(perf_counter::instructions)) / static_cast<double>(get(perf_counter::cycles));
+    }
+    /// Misses per thousand instructions.
+    /**
+     * @param c the counter (one of perf_counter::llc_misses, perf_counter::dtlb_misses and
+     * perf_counter::branch_misses).
+     *
+     * @return the number of events counted by \p c per thousand instructions, or zero if \p c or the counter of
+     * instructions are not available (or no instruction was counted).
+     *
+     * @throws std::invalid_argument if \p c does not count misses.
+     */
+    double mpki(perf_counter c) const
+    {
+        if (unlikely(c == perf_counter::cycles || c == perf_counter::instructions)) {
+            piranha_throw(std::invalid_argument, "the counter does not count misses");
+        }
+        if (!is_available(c) || !is_available(perf_counter::instructions) || !get(perf_counter::instructions)) {
+            return 0.;
+        }
+        return static_cast<double>(get(c)) * 1000. / static_cast<double>(get(perf_counter::instructions));
+    }
+    /// Availability flags of the counters, indexed by piranha::perf_counter.
+    std::array<bool, n_counters> available;
+    /// Values of the counters, indexed by piranha::perf_counter.
+    std::array<unsigned long long, n_counters> values;
+    /// Wall time of the region, in seconds.
+    double wall_time;
+};
+
+/// Hardware performance counters.
+/**
+ * This class collects the hardware performance counters listed in piranha::perf_counter over a region of code
+ * delimited by the calls to start() and stop(). The counters are collected via the \p perf_event_open() system
+ * call on Linux, for all the threads of the process existing when start() is called (e.g., the threads of
+ * piranha::thread_pool), and they are restricted to user-space code. Threads created after the call to start()
+ * are not accounted for. If the hardware is shared among several counters, the values are scaled by the fraction
+ * of time each counter was active.
+ *
+ * The counters may not be available (e.g., on platforms other than Linux, in virtual machines without access
+ * to the performance monitoring unit, or if the access is restricted by the \p perf_event_paranoid setting).
+ * In such case, the wall time is still measured and the counters are flagged as unavailable in
+ * piranha::perf_counter_values.
+ */
+class perf_counters
+{
+#if defined(__linux__)
+    // Open a counter for the thread tid, returning -1 on failure.
+    static int open_counter(perf_counter c, ::pid_t tid)
+    {
+        ::perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        switch (c) {
+            case perf_counter::cycles:
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_CPU_CYCLES;
+                break;
+            case perf_counter::instructions:
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+                break;
+            case perf_counter::llc_misses:
+                // NOTE: the generic cache misses event is mapped to the last-level cache misses on most CPUs.
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_CACHE_MISSES;
+                break;
+            case perf_counter::dtlb_misses:
+                attr.type = PERF_TYPE_HW_CACHE;
+                attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8u)
+                              | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16u);
+                break;
+            case perf_counter::branch_misses:
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+        }
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        return static_cast<int>(::syscall(__NR_perf_event_open, &attr, tid, -1, -1, 0));
+    }
+    // The ids of the threads of the process. The calling thread is always the first one.
+    static std::vector<::pid_t> thread_ids()
+    {
+        const auto self = static_cast<::pid_t>(::syscall(SYS_gettid));
+        std::vector<::pid_t> retval{self};
+        ::DIR *dir = ::opendir("/proc/self/task");
+        if (dir == nullptr) {
+            return retval;
+        }
+        while (const auto ent = ::readdir(dir)) {
+            const auto tid = static_cast<::pid_t>(std::atoi(ent->d_name));
+            if (tid > 0 && tid != self) {
+                retval.push_back(tid);
+            }
+        }
+        ::closedir(dir);
+        return retval;
+    }
+    void close_all()
+    {
+        for (auto &v : m_fds) {
+            for (const auto fd : v) {
+                ::close(fd);
+            }
+            v.clear();
+        }
+    }
+#endif
+
+public:
+    /// Default constructor.
+    /**
+     * The counters will not be started.
+     */
+    perf_counters() : m_started(false)
+    {
+    }
+    /// Deleted copy constructor.
+    perf_counters(const perf_counters &) = delete;
+    /// Deleted copy assignment operator.
+    perf_counters &operator=(const perf_counters &) = delete;
+    /// Destructor.
+    /**
+     * Any open counter will be released.
+     */
+    ~perf_counters()
+    {
+#if defined(__linux__)
+        close_all();
+#endif
+    }
+    /// Check the availability of the counters.
+    /**
+     * @return \p true if at least one of the counters can be collected, \p false otherwise.
+     */
+    static bool available()
+    {
+#if defined(__linux__)
+        const auto self = static_cast<::pid_t>(::syscall(SYS_gettid));
+        for (std::size_t i = 0u; i < perf_counter_values::n_counters; ++i) {
+            const int fd = open_counter(static_cast<perf_counter>(i), self);
+            if (fd != -1) {
+                ::close(fd);
+                return true;
+            }
+        }
+#endif
+        return false;
+    }
+    /// Start the counters.
+    /**
+     * If the counters were already started, they will be restarted.
+     *
+     * @throws unspecified any exception thrown by memory allocation errors in standard containers.
+     */
+    void start()
+    {
+#if defined(__linux__)
+        close_all();
+        const auto tids = thread_ids();
+        for (std::size_t i = 0u; i < perf_counter_values::n_counters; ++i) {
+            auto &v = m_fds[i];
+            for (decltype(tids.size()) j = 0u; j < tids.size(); ++j) {
+                const int fd = open_counter(static_cast<perf_counter>(i), tids[j]);
+                if (fd == -1) {
+                    if (j == 0u) {
+                        // The counter is not available for the calling thread: give up on it.
+                        break;
+                    }
+                    // Another thread might have exited in the meantime, just skip it.
+                    continue;
+                }
+                try {
+                    v.push_back(fd);
+                } catch (...) {
+                    ::close(fd);
+                    throw;
+                }
+            }
+        }
+        for (const auto &v : m_fds) {
+            for (const auto fd : v) {
+                ::ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+                ::ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+#endif
+        m_started = true;
+        m_start = std::chrono::steady_clock::now();
+    }
+    /// Stop the counters.
+    /**
+     * @return the values of the counters and the wall time since the last call to start().
+     *
+     * @throws std::invalid_argument if the counters were not started.
+     */
+    perf_counter_values stop()
+    {
+        const auto end = std::chrono::steady_clock::now();
+        if (unlikely(!m_started)) {
+            piranha_throw(std::invalid_argument, "the performance counters were not started");
+        }
+        m_started = false;
+        perf_counter_values retval = perf_counter_values();
+        retval.wall_time = std::chrono::duration<double>(end - m_start).count();
+#if defined(__linux__)
+        for (const auto &v : m_fds) {
+            for (const auto fd : v) {
+                ::ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+            }
+        }
+        for (std::size_t i = 0u; i < perf_counter_values::n_counters; ++i) {
+            if (m_fds[i].empty()) {
+                continue;
+            }
+            double value = 0.;
+            bool ok = true;
+            for (const auto fd : m_fds[i]) {
+                // Value, time enabled and time running.
+                std::uint64_t buffer[3];
+                if (::read(fd, buffer, sizeof(buffer)) != static_cast<::ssize_t>(sizeof(buffer))) {
+                    ok = false;
+                    break;
+                }
+                if (buffer[2] != 0u) {
+                    value += static_cast<double>(buffer[0]) * static_cast<double>(buffer[1])
+                             / static_cast<double>(buffer[2]);
+                }
+            }
+            if (ok) {
+                retval.available[i] = true;
+                retval.values[i] = static_cast<unsigned long long>(value);
+            }
+        }
+        close_all();
+#endif
+        return retval;
+    }
+
+private:
+    bool m_started;
+    std::chrono::steady_clock::time_point m_start;
+#if defined(__linux__)
+    std::array<std::vector<int>, perf_counter_values::n_counters> m_fds;
+#endif
+};
+}
+
+#endif
@@ -311,11 +311,15 @@ inline namespace literals
 }
 
 #include "array_key.hpp"
+#include "auto_tuner.hpp"
 #include "base_series_multiplier.hpp"
 #include "binomial.hpp"
 #include "cache_aligning_allocator.hpp"
+#include "cd_polynomial.hpp"
 #include "config.hpp"
 #include "convert_to.hpp"
+#include "cost_model.hpp"
+#include "dd_real.hpp"
 #include "debug_access.hpp"
 #include "divisor.hpp"
 #include "divisor_series.hpp"
@@ -330,13 +334,18 @@ inline namespace literals
 #include "key_is_convertible.hpp"
 #include "key_is_multipliable.hpp"
 #include "kronecker_array.hpp"
+#include "kronecker_divisor.hpp"
 #include "kronecker_monomial.hpp"
 #include "lambdify.hpp"
 #include "math.hpp"
 #include "memory.hpp"
+#include "mod_int.hpp"
 #include "monomial.hpp"
 #include "mp_integer.hpp"
 #include "mp_rational.hpp"
+#include "multiplication_statistics.hpp"
+#include "packed_monomial.hpp"
+#include "perf_counters.hpp"
 #include "poisson_series.hpp"
 #include "polynomial.hpp"
 #include "pow.hpp"
@@ -353,6 +362,7 @@ inline namespace literals
 #include "series_multiplier.hpp"
 #include "settings.hpp"
 #include "small_vector.hpp"
+#include "static_monomial.hpp"
 #include "static_vector.hpp"
 #include "substitutable_series.hpp"
 #include "symbol.hpp"
@@ -362,6 +372,7 @@ inline namespace literals
 #include "thread_barrier.hpp"
 #include "thread_management.hpp"
 #include "thread_pool.hpp"
+#include "tracer.hpp"
 #include "trigonometric_series.hpp"
 #include "tuning.hpp"
 #include "type_traits.hpp"
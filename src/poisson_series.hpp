@@ -31,6 +31,7 @@ see https://www.gnu.org/licenses/. */
 
 #include <algorithm>
 #include <atomic>
+#include <cstddef>
 #include <iterator>
 #include <stdexcept>
 #include <string>
@@ -877,21 +878,19 @@ class series_multiplier<Series, detail::ps_series_multiplier_enabler<Series>> :
             // Buckets per thread.
             const auto bpt = static_cast<bucket_size_type>(container.bucket_count() / this->m_n_threads);
             // Go with the threads.
-            future_list<decltype(divider(0u, 0u))> ff_list;
             try {
-                for (unsigned i = 0u; i < this->m_n_threads; ++i) {
-                    const auto start_idx = static_cast<bucket_size_type>(bpt * i);
-                    // Special casing for the last thread.
-                    const auto end_idx = (i == this->m_n_threads - 1u) ? container.bucket_count()
-                                                                       : static_cast<bucket_size_type>(bpt * (i + 1u));
-                    ff_list.push_back(thread_pool::enqueue(i, divider, start_idx, end_idx));
-                }
-                // First let's wait for everything to finish.
-                ff_list.wait_all();
-                // Then, let's handle the exceptions.
-                ff_list.get_all();
+                thread_pool::parallel_for(0u, this->m_n_threads, 1u, [&](std::size_t i_start, std::size_t i_end) {
+                    for (auto j = i_start; j != i_end; ++j) {
+                        const auto i = static_cast<unsigned>(j);
+                        const auto start_idx = static_cast<bucket_size_type>(bpt * i);
+                        // Special casing for the last thread.
+                        const auto end_idx = (i == this->m_n_threads - 1u)
+                                                 ? container.bucket_count()
+                                                 : static_cast<bucket_size_type>(bpt * (i + 1u));
+                        divider(start_idx, end_idx);
+                    }
+                });
             } catch (...) {
-                ff_list.wait_all();
                 // Clear out the container as it might be in an inconsistent state.
                 container.clear();
                 throw;
@@ -30,6 +30,8 @@ see https://www.gnu.org/licenses/. */
 #define PIRANHA_POLYNOMIAL_HPP
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <boost/numeric/conversion/cast.hpp>
 #include <cmath> // For std::ceil.
 #include <cstddef>
@@ -49,15 +51,18 @@ see https://www.gnu.org/licenses/. */
 
 #include "base_series_multiplier.hpp"
 #include "config.hpp"
+#include "cost_model.hpp"
 #include "debug_access.hpp"
 #include "detail/atomic_flag_array.hpp"
 #include "detail/cf_mult_impl.hpp"
 #include "detail/divisor_series_fwd.hpp"
+#include "detail/parallel_bucket_ranges.hpp"
 #include "detail/parallel_vector_transform.hpp"
 #include "detail/poisson_series_fwd.hpp"
 #include "detail/polynomial_fwd.hpp"
 #include "detail/safe_integral_adder.hpp"
 #include "detail/sfinae_types.hpp"
+#include "detail/vector_kernels.hpp"
 #include "exceptions.hpp"
 #include "forwarding.hpp"
 #include "ipow_substitutable_series.hpp"
@@ -66,19 +71,24 @@ see https://www.gnu.org/licenses/. */
 #include "kronecker_array.hpp"
 #include "kronecker_monomial.hpp"
 #include "math.hpp"
+#include "mod_int.hpp"
 #include "monomial.hpp"
 #include "mp_integer.hpp"
+#include "packed_monomial.hpp"
 #include "pow.hpp"
 #include "power_series.hpp"
+#include "runtime_info.hpp"
 #include "safe_cast.hpp"
 #include "series.hpp"
 #include "series_multiplier.hpp"
 #include "settings.hpp"
+#include "static_monomial.hpp"
 #include "substitutable_series.hpp"
 #include "symbol.hpp"
 #include "symbol_set.hpp"
 #include "t_substitutable_series.hpp"
 #include "thread_pool.hpp"
+#include "tracer.hpp"
 #include "trigonometric_series.hpp"
 #include "tuning.hpp"
 #include "type_traits.hpp"
@@ -109,6 +119,16 @@ struct is_polynomial_key<monomial<T, U>> {
     static const bool value = true;
 };
 
+template <typename T, std::size_t N>
+struct is_polynomial_key<static_monomial<T, N>> {
+    static const bool value = true;
+};
+
+template <typename T, unsigned W>
+struct is_polynomial_key<packed_monomial<T, W>> {
+    static const bool value = true;
+};
+
 // Implementation detail to check if the monomial key supports the linear_argument() method.
 template <typename Key>
 struct key_has_linarg : detail::sfinae_types {
@@ -148,6 +168,137 @@ inline void poly_expo_checker(const PType &p)
     }
 }
 
+// Number of threads to be used in the parallel traversal of the terms of a polynomial.
+template <typename PType>
+inline unsigned poly_n_threads(const PType &p)
+{
+    if (p.empty()) {
+        return 1u;
+    }
+    return cost_model::use_threads<PType>(cost_operation::traversal, integer(p.size()));
+}
+
+// Content utilities.
+// Check if the running GCD of the coefficients is 1, in which case the computation of the content can stop.
+template <typename T, typename std::enable_if<has_is_unitary<T>::value, int>::type = 0>
+inline bool poly_content_is_one(const T &x)
+{
+    return math::is_unitary(x);
+}
+
+template <typename T, typename std::enable_if<!has_is_unitary<T>::value, int>::type = 0>
+inline bool poly_content_is_one(const T &)
+{
+    return false;
+}
+
+// Sign of the content. For coefficients with a sign (C++ integral types and mp_integer), the content is defined to be
+// negative if all the coefficients are negative, and non-negative otherwise. For the other coefficient types, the
+// content is the plain result of the GCD computations.
+template <typename T>
+using poly_content_has_sign = std::integral_constant<bool, std::is_integral<T>::value || is_mp_integer<T>::value>;
+
+template <typename T, typename std::enable_if<is_mp_integer<T>::value, int>::type = 0>
+inline bool poly_content_is_positive(const T &x)
+{
+    return x.sign() > 0;
+}
+
+template <typename T, typename std::enable_if<std::is_integral<T>::value, int>::type = 0>
+inline bool poly_content_is_positive(const T &x)
+{
+    return x > T(0);
+}
+
+template <typename T, typename std::enable_if<!poly_content_has_sign<T>::value, int>::type = 0>
+inline bool poly_content_is_positive(const T &)
+{
+    return true;
+}
+
+// Give to the GCD g of the coefficients the sign of the content (positive is true if at least one of the coefficients
+// is positive).
+template <typename T, typename std::enable_if<poly_content_has_sign<T>::value, int>::type = 0>
+inline void poly_content_set_sign(T &g, bool positive)
+{
+    if ((g < T(0)) == positive) {
+        g = static_cast<T>(-g);
+    }
+}
+
+template <typename T, typename std::enable_if<!poly_content_has_sign<T>::value, int>::type = 0>
+inline void poly_content_set_sign(T &, bool)
+{
+}
+
+// Accumulate into retval the GCD of the coefficients in the bucket range [start_idx, end_idx) of the
+// container c, and set positive if a positive coefficient is found. The accumulation of the GCD stops early
+// if stop is set, and it sets stop if retval becomes 1. The range is traversed until both stop and positive are set.
+template <typename Cf, typename Container, typename std::enable_if<!is_mp_integer<Cf>::value, int>::type = 0>
+inline void poly_content_range(Cf &retval, const Container &c, typename Container::size_type start_idx,
+                               typename Container::size_type end_idx, std::atomic<bool> &stop,
+                               std::atomic<bool> &positive)
+{
+    for (; start_idx != end_idx; ++start_idx) {
+        const bool g_done = stop.load(std::memory_order_relaxed);
+        bool p_done = positive.load(std::memory_order_relaxed);
+        if (g_done && p_done) {
+            break;
+        }
+        for (const auto &t : c._get_bucket_list(start_idx)) {
+            if (!g_done) {
+                math::gcd3(retval, retval, t.m_cf);
+            }
+            if (!p_done && poly_content_is_positive(t.m_cf)) {
+                positive.store(true, std::memory_order_relaxed);
+                p_done = true;
+            }
+        }
+        if (!g_done && poly_content_is_one(retval)) {
+            stop.store(true, std::memory_order_relaxed);
+        }
+    }
+}
+
+// For mp_integer, the coefficients are collected in batches and processed via mp_integer::gcd_n().
+template <typename Cf, typename Container, typename std::enable_if<is_mp_integer<Cf>::value, int>::type = 0>
+inline void poly_content_range(Cf &retval, const Container &c, typename Container::size_type start_idx,
+                               typename Container::size_type end_idx, std::atomic<bool> &stop,
+                               std::atomic<bool> &positive)
+{
+    std::array<const Cf *, 256u> batch;
+    std::size_t n = 0u;
+    auto flush = [&retval, &batch, &n, &stop]() {
+        Cf::gcd_n(retval, batch.data(), n);
+        n = 0u;
+        if (retval.is_unitary()) {
+            stop.store(true, std::memory_order_relaxed);
+        }
+    };
+    for (; start_idx != end_idx; ++start_idx) {
+        bool g_done = stop.load(std::memory_order_relaxed), p_done = positive.load(std::memory_order_relaxed);
+        if (g_done && p_done) {
+            break;
+        }
+        for (const auto &t : c._get_bucket_list(start_idx)) {
+            if (!p_done && t.m_cf.sign() > 0) {
+                positive.store(true, std::memory_order_relaxed);
+                p_done = true;
+            }
+            if (!g_done) {
+                batch[n++] = &t.m_cf;
+                if (n == batch.size()) {
+                    flush();
+                    g_done = stop.load(std::memory_order_relaxed);
+                }
+            }
+        }
+    }
+    if (n != 0u && !stop.load(std::memory_order_relaxed)) {
+        flush();
+    }
+}
+
 // Multiply polynomial by non-zero cf in place. Preconditions:
 // - a is not zero.
 // Type requirements:
@@ -172,12 +323,19 @@ inline void poly_cf_mult(const typename PType::term_type::cf_type &a, PType &p)
 template <typename PType>
 inline void poly_exact_cf_div(PType &p, const typename PType::term_type::cf_type &a)
 {
+    using bucket_size_type = typename PType::size_type;
     piranha_assert(!math::is_zero(a));
-    const auto it_f = p._container().end();
-    for (auto it = p._container().begin(); it != it_f; ++it) {
-        math::divexact(it->m_cf, it->m_cf, a);
-        piranha_assert(!math::is_zero(it->m_cf));
-    }
+    const auto &container = p._container();
+    // NOTE: the division never produces zero coefficients, so the structure of the table is not altered.
+    parallel_bucket_ranges(poly_n_threads(p), container,
+                           [&container, &a](unsigned, bucket_size_type start_idx, bucket_size_type end_idx) {
+                               for (; start_idx != end_idx; ++start_idx) {
+                                   for (const auto &t : container._get_bucket_list(start_idx)) {
+                                       math::divexact(t.m_cf, t.m_cf, a);
+                                       piranha_assert(!math::is_zero(t.m_cf));
+                                   }
+                               }
+                           });
 }
 
 // Univariate polynomial GCD via PRS-SR.
@@ -654,7 +812,8 @@ enum class polynomial_gcd_algorithm {
  * ## Type requirements ##
  *
  * \p Cf must be suitable for use in piranha::series as first template argument,
- * \p Key must be an instance of either piranha::monomial or piranha::kronecker_monomial.
+ * \p Key must be an instance of piranha::monomial, piranha::static_monomial, piranha::kronecker_monomial or
+ * piranha::packed_monomial.
  *
  * ## Exception safety guarantee ##
  *
@@ -1677,18 +1836,49 @@ public:
      * This method will return the GCD of the polynomial's coefficients. If the polynomial
      * is empty, zero will be returned.
      *
+     * If the coefficient type is a C++ integral type or an instance of piranha::mp_integer, the content
+     * is negative if all the coefficients are negative, and positive otherwise. The primitive part of a polynomial
+     * whose coefficients are all negative has thus positive coefficients. For other coefficient types, the content
+     * is the result of the GCD computations via piranha::math::gcd3(), whose order is unspecified.
+     *
+     * The computation is split across multiple threads according to cost_model::use_threads()
+     * with piranha::cost_operation::traversal, and it stops as soon as the running GCD becomes 1.
+     * For piranha::mp_integer coefficients, the coefficients are processed in batches via
+     * piranha::mp_integer::gcd_n().
+     *
      * @return the content of \p this.
      *
-     * @throws unspecified any exception thrown by the polynomial constructor from \p int
-     * or by piranha::math::gcd3().
+     * @throws unspecified any exception thrown by:
+     * - the polynomial constructor from \p int,
+     * - piranha::math::gcd3(),
+     * - thread_pool::parallel_for(),
+     * - memory allocation errors in standard containers.
      */
     template <typename T = polynomial, content_enabler<T> = 0>
     Cf content() const
     {
+        using bucket_size_type = typename base::size_type;
+        const auto &container = this->_container();
+        const unsigned n_threads = detail::poly_n_threads(*this);
+        // The GCDs of the bucket ranges processed by each thread.
+        std::vector<Cf> partials(n_threads, Cf(0));
+        std::atomic<bool> stop(false), positive(false);
+        detail::parallel_bucket_ranges(n_threads, container, [&partials, &container, &stop, &positive](
+                                                                 unsigned i, bucket_size_type start_idx,
+                                                                 bucket_size_type end_idx) {
+            detail::poly_content_range(partials[i], container, start_idx, end_idx, stop, positive);
+        });
         Cf retval(0);
-        for (const auto &t : this->_container()) {
-            math::gcd3(retval, retval, t.m_cf);
+        if (stop.load()) {
+            // One of the partial GCDs is 1.
+            retval = Cf(1);
+        } else {
+            for (const auto &p : partials) {
+                math::gcd3(retval, retval, p);
+            }
         }
+        // NOTE: an empty polynomial has no positive coefficients, and its content is zero anyway.
+        detail::poly_content_set_sign(retval, positive.load());
         return retval;
     }
     /// Primitive part.
@@ -1698,12 +1888,14 @@ public:
      * - the method piranha::polynomial::content() is enabled,
      * - the polynomial coefficient supports math::divexact().
      *
-     * This method will return \p this divided by its content.
+     * This method will return \p this divided by its content. Like the computation of the content, the division
+     * of the coefficients is split across multiple threads.
      *
      * @return the primitive part of \p this.
      *
      * @throws piranha::zero_division_error if the content is zero.
-     * @throws unspecified any exception thrown by the division operation or by piranha::polynomial::content().
+     * @throws unspecified any exception thrown by the division operation, by piranha::polynomial::content(),
+     * or by thread_pool::parallel_for().
      */
     template <typename T = polynomial, pp_enabler<T> = 0>
     polynomial primitive_part() const
@@ -2024,20 +2216,45 @@ public:
      * polynomial
      * is empty, zero will be returned.
      *
+     * The computation is split across multiple threads according to cost_model::use_threads()
+     * with piranha::cost_operation::traversal.
+     *
      * @return the height of \p this.
      *
-     * @throws unspecified any exception thrown by the construction, assignment, comparison, and absolute value
-     * calculation
-     * of <tt>height_type<T></tt>.
+     * @throws unspecified any exception thrown by:
+     * - the construction, assignment, comparison, and absolute value calculation of <tt>height_type<T></tt>,
+     * - thread_pool::parallel_for(),
+     * - memory allocation errors in standard containers.
      */
     template <typename T = polynomial>
     height_type<T> height() const
     {
+        using bucket_size_type = typename base::size_type;
+        const auto &container = this->_container();
+        const unsigned n_threads = detail::poly_n_threads(*this);
+        // The heights of the bucket ranges processed by each thread.
+        std::vector<height_type<T>> partials;
+        partials.reserve(n_threads);
+        for (unsigned i = 0u; i < n_threads; ++i) {
+            partials.emplace_back(0);
+        }
+        detail::parallel_bucket_ranges(
+            n_threads, container,
+            [&partials, &container](unsigned i, bucket_size_type start_idx, bucket_size_type end_idx) {
+                auto &retval = partials[i];
+                for (; start_idx != end_idx; ++start_idx) {
+                    for (const auto &t : container._get_bucket_list(start_idx)) {
+                        auto tmp(math::abs(t.m_cf));
+                        if (!(tmp < retval)) {
+                            retval = std::move(tmp);
+                        }
+                    }
+                }
+            });
         height_type<T> retval(0);
-        for (const auto &t : this->_container()) {
-            auto tmp(math::abs(t.m_cf));
-            if (!(tmp < retval)) {
-                retval = std::move(tmp);
+        for (auto &p : partials) {
+            if (!(p < retval)) {
+                retval = std::move(p);
             }
         }
         return retval;
@@ -2237,6 +2454,41 @@ struct is_monomial<monomial<T, S>> {
     static const bool value = true;
 };
 
+// NOTE: static monomials have integral exponents and they expose the same begin()/end()
+// interface as monomial, hence they can share the bounds checking logic in the multiplier.
+template <typename T, std::size_t N>
+struct is_monomial<static_monomial<T, N>> {
+    static const bool value = true;
+};
+
+template <typename T>
+struct is_packed_monomial {
+    static const bool value = false;
+};
+
+template <typename T, unsigned W>
+struct is_packed_monomial<packed_monomial<T, W>> {
+    static const bool value = true;
+};
+
+// Keys represented by a single integer, whose multiplication is an integral addition. These keys
+// can use the sparse Kronecker multiplication algorithm in the multiplier.
+template <typename T>
+struct is_int_packed_key {
+    static const bool value = is_kronecker_monomial<T>::value || is_packed_monomial<T>::value;
+};
+
+// Minimum number of buckets in the output table for the use of the batched consumer of multiplication
+// tasks with double-precision coefficients in the sparse Kronecker multiplication. This is not part of
+// the public API, it can be modified for testing purposes.
+template <typename = void>
+struct base_batched_mult {
+    static std::atomic<std::size_t> s_min_bucket_count;
+};
+
+template <typename T>
+std::atomic<std::size_t> base_batched_mult<T>::s_min_bucket_count(std::size_t(1) << 20u);
+
 // Identify the presence of auto-truncation methods in the poly multiplier.
 template <typename S, typename T>
 class has_set_auto_truncate_degree : sfinae_types
@@ -2395,6 +2647,20 @@ class series_multiplier<Series, detail::poly_multiplier_enabler<Series>> : publi
             return std::make_pair(v < p.first ? v : p.first, v > p.second ? v : p.second);
         }
     };
+    // Update element-wise the vectors of minimum and maximum exponents with the exponents in v.
+    template <typename T, typename std::enable_if<detail::vk_enabled<T>::value, int>::type = 0>
+    static void minmax_update(T *mins, T *maxs, const T *v, std::size_t size)
+    {
+        detail::vk_minmax(mins, maxs, v, size);
+    }
+    template <typename T, typename std::enable_if<!detail::vk_enabled<T>::value, int>::type = 0>
+    static void minmax_update(T *mins, T *maxs, const T *v, std::size_t size)
+    {
+        for (std::size_t i = 0u; i < size; ++i) {
+            mins[i] = v[i] < mins[i] ? v[i] : mins[i];
+            maxs[i] = v[i] > maxs[i] ? v[i] : maxs[i];
+        }
+    }
     // No bounds checking if key is a monomial with non-integral exponents.
     template <typename T = Series,
               typename std::enable_if<detail::is_monomial<key_t<T>>::value
@@ -2420,8 +2686,8 @@ class series_multiplier<Series, detail::poly_multiplier_enabler<Series>> : publi
         piranha_assert(this->m_v1.size() != 0u && this->m_v2.size() != 0u);
         // Sync mutex, actually used only in mt mode.
         std::mutex mut;
-        // Checker for monomial sizes in debug mode.
-        auto monomial_checker = [this](const term_type &t) { return t.m_key.size() == this->m_ss.size(); };
+        // Checker for monomial compatibility in debug mode.
+        auto monomial_checker = [this](const term_type &t) { return t.m_key.is_compatible(this->m_ss); };
         (void)monomial_checker;
         // The function used to determine minmaxs for the two series. This is used both in
         // single-thread and multi-thread mode.
@@ -2439,23 +2705,19 @@ class series_multiplier<Series, detail::poly_multiplier_enabler<Series>> : publi
                 return;
             }
             piranha_assert(monomial_checker(**start));
-            // Local vector that will hold the minmax values for this thread.
-            mm_vec minmax_values;
-            // Init the mimnax.
+            // Local vectors that will hold the min and max values for this thread. They are kept separate
+            // so that the update can be done with the vector kernels.
             // NOTE: we can use this as we are sure the series has at least one element (start != end).
-            std::transform((*start)->m_key.begin(), (*start)->m_key.end(), std::back_inserter(minmax_values),
-                           [](const expo_type &v) { return std::make_pair(v, v); });
+            std::vector<expo_type> mins((*start)->m_key.begin(), (*start)->m_key.end()), maxs(mins);
             // Move to the next element and go with the loop.
             ++start;
             for (; start != end; ++start) {
                 piranha_assert(monomial_checker(**start));
-                // NOTE: std::transform is allowed to do transformations in-place - i.e., here the output range is
-                // the same as the first or second input range:
-                // http://stackoverflow.com/questions/19200528/is-it-safe-for-the-input-iterator-and-output-iterator-in-stdtransform-to-be-fr
-                // The important part is that the functor *itself* must not mutate the elements.
-                std::transform(minmax_values.begin(), minmax_values.end(), (*start)->m_key.begin(),
-                               minmax_values.begin(), update_minmax{});
+                minmax_update(mins.data(), maxs.data(), (*start)->m_key.begin(), mins.size());
             }
+            mm_vec minmax_values;
+            std::transform(mins.begin(), mins.end(), maxs.begin(), std::back_inserter(minmax_values),
+                           [](const expo_type &a, const expo_type &b) { return std::make_pair(a, b); });
             if (this->m_n_threads == 1u) {
                 // In single thread the output mmv should be written only once, after being def-inited.
                 piranha_assert(mmv->empty());
@@ -2501,6 +2763,13 @@ class series_multiplier<Series, detail::poly_multiplier_enabler<Series>> : publi
             }
         }
     }
+    // No bounds checking for packed monomials: overflows are detected via the guard bits
+    // during the multiplication.
+    template <typename T = Series,
+              typename std::enable_if<detail::is_packed_monomial<key_t<T>>::value, int>::type = 0>
+    void check_bounds() const
+    {
+    }
     template <typename T = Series,
               typename std::enable_if<detail::is_kronecker_monomial<key_t<T>>::value, int>::type = 0>
     void check_bounds() const
@@ -2588,35 +2857,19 @@ class series_multiplier<Series, detail::poly_multiplier_enabler<Series>> : publi
         } else {
             // Series 1.
             {
-                future_list<void> ff_list;
-                try {
-                    for (unsigned i = 0u; i < this->m_n_threads; ++i) {
-                        ff_list.push_back(thread_pool::enqueue(i, thread_func, i, &(this->m_v1), &minmax_values1));
+                thread_pool::parallel_for(0u, this->m_n_threads, 1u, [&](std::size_t i_start, std::size_t i_end) {
+                    for (auto i = i_start; i != i_end; ++i) {
+                        thread_func(static_cast<unsigned>(i), &(this->m_v1), &minmax_values1);
                     }
-                    // First let's wait for everything to finish.
-                    ff_list.wait_all();
-                    // Then, let's handle the exceptions.
-                    ff_list.get_all();
-                } catch (...) {
-                    ff_list.wait_all();
-                    throw;
-                }
+                });
             }
             // Series 2.
             {
-                future_list<void> ff_list;
-                try {
-                    for (unsigned i = 0u; i < this->m_n_threads; ++i) {
-                        ff_list.push_back(thread_pool::enqueue(i, thread_func, i, &(this->m_v2), &minmax_values2));
+                thread_pool::parallel_for(0u, this->m_n_threads, 1u, [&](std::size_t i_start, std::size_t i_end) {
+                    for (auto i = i_start; i != i_end; ++i) {
+                        thread_func(static_cast<unsigned>(i), &(this->m_v2), &minmax_values2);
                     }
-                    // First let's wait for everything to finish.
-                    ff_list.wait_all();
-                    // Then, let's handle the exceptions.
-                    ff_list.get_all();
-                } catch (...) {
-                    ff_list.wait_all();
-                    throw;
-                }
+                });
             }
         }
     }
@@ -2640,16 +2893,30 @@ class series_multiplier<Series, detail::poly_multiplier_enabler<Series>> : publi
         detail::safe_integral_subber(retval, b);
         return retval;
     }
+    // Mask to be applied to the result of the addition of two keys in the sparse Kronecker multiplication:
+    // the guard bits for packed monomials, zero for Kronecker monomials (whose bounds are checked in advance).
+    template <typename T = Series,
+              typename std::enable_if<detail::is_kronecker_monomial<key_t<T>>::value, int>::type = 0>
+    typename key_t<T>::value_type key_guard_mask() const
+    {
+        return 0;
+    }
+    template <typename T = Series,
+              typename std::enable_if<detail::is_packed_monomial<key_t<T>>::value, int>::type = 0>
+    typename key_t<T>::value_type key_guard_mask() const
+    {
+        return key_t<T>::get_guard_mask();
+    }
     // Dispatch of untruncated multiplication.
     template <typename T = Series,
-              typename std::enable_if<detail::is_kronecker_monomial<typename T::term_type::key_type>::value, int>::type
+              typename std::enable_if<detail::is_int_packed_key<typename T::term_type::key_type>::value, int>::type
               = 0>
     Series um_impl() const
     {
         return untruncated_kronecker_mult();
     }
     template <typename T = Series,
-              typename std::enable_if<!detail::is_kronecker_monomial<typename T::term_type::key_type>::value, int>::type
+              typename std::enable_if<!detail::is_int_packed_key<typename T::term_type::key_type>::value, int>::type
               = 0>
     Series um_impl() const
     {
@@ -2662,10 +2929,12 @@ public:
      * The constructor will call the base constructor and run these additional checks:
      * - if the key is a piranha::kronecker_monomial, it will be checked that the result of the multiplication does
      *   not overflow the representation limits of piranha::kronecker_monomial;
-     * - if the key is a piranha::monomial of a C++ integral type, it will be checked that the result of the
-     *   multiplication does not overflow the limits of the integral type.
+     * - if the key is a piranha::monomial of a C++ integral type or a piranha::static_monomial, it will be checked
+     *   that the result of the multiplication does not overflow the limits of the integral type.
      *
-     * If any check fails, a runtime error will be produced.
+     * If any check fails, a runtime error will be produced. If the key is a piranha::packed_monomial, no check is
+     * performed here: overflows are instead detected during the multiplication via the guard bits of the
+     * packed representation.
      *
      * @param[in] s1 first series operand.
      * @param[in] s2 second series operand.
@@ -2675,8 +2944,7 @@ public:
      * - the base constructor,
      * - standard threading primitives,
      * - memory errors in standard containers,
-     * - thread_pool::enqueue(),
-     * - future_list::push_back().
+     * - thread_pool::parallel_for().
      */
     explicit series_multiplier(const Series &s1, const Series &s2) : base(s1, s2)
     {
@@ -2684,6 +2952,29 @@ public:
         if (unlikely(this->m_v1.empty() || this->m_v2.empty() || this->m_ss.size() == 0u)) {
             return;
         }
+        trace_scope ts("check_bounds", "multiplication");
+        check_bounds();
+    }
+    /// Mixed-type constructor.
+    /**
+     * \note
+     * This constructor is enabled only if the corresponding mixed-type constructor of
+     * piranha::base_series_multiplier is enabled.
+     *
+     * The constructor will call the mixed-type base constructor and run the same checks as the other constructor.
+     *
+     * @param[in] s1 first series operand.
+     * @param[in] s2 second series operand.
+     *
+     * @throws unspecified any exception thrown by the other constructor.
+     */
+    template <typename T, detail::base_series_multiplier_mixed_enabler<Series, T> = 0>
+    explicit series_multiplier(const Series &s1, const T &s2) : base(s1, s2)
+    {
+        if (unlikely(this->m_v1.empty() || this->m_v2.empty() || this->m_ss.size() == 0u)) {
+            return;
+        }
+        trace_scope ts("check_bounds", "multiplication");
         check_bounds();
     }
     /// Perform multiplication.
@@ -2695,7 +2986,10 @@ public:
      *
      * This method will perform the multiplication of the series operands passed to the constructor. Depending on
      * the key type of \p Series, the implementation will use either base_series_multiplier::plain_multiplication()
-     * with base_series_multiplier::plain_multiplier or a different algorithm.
+     * with base_series_multiplier::plain_multiplier or a different algorithm. If the coefficient type is an instance
+     * of piranha::mp_integer, the key type is Kronecker-packed and piranha::tuning::get_crt_multiplication() returns
+     * \p true, the multiplication will be performed modulo a set of word-size primes using piranha::mod_int
+     * coefficients, and the result will be reconstructed via the Chinese remainder theorem.
      *
      * If a polynomial truncation threshold is defined and the degree type of the polynomial is a C++ integral type,
      * the integral arithmetic operations involved in the truncation logic will be checked for overflow.
@@ -2714,10 +3008,10 @@ public:
      * - memory errors in standard containers,
      * - piranha::math::mul3(),
      * - piranha::math::multiply_accumulate(),
-     * - thread_pool::enqueue(),
-     * - future_list::push_back(),
+     * - thread_pool::parallel_for(),
      * - _truncated_multiplication(),
-     * - polynomial::get_auto_truncate_degree().
+     * - polynomial::get_auto_truncate_degree(),
+     * - the arithmetic operations on piranha::mod_int and piranha::mp_integer.
      */
     template <typename T = Series, call_enabler<T> = 0>
     Series operator()() const
@@ -2750,8 +3044,7 @@ public:
      * - memory errors in standard containers,
      * - piranha::math::mul3(),
      * - piranha::math::multiply_accumulate(),
-     * - thread_pool::enqueue(),
-     * - future_list::push_back().
+     * - thread_pool::parallel_for().
      */
     Series _untruncated_multiplication() const
     {
@@ -2980,9 +3273,9 @@ private:
         }
     };
     // execute() is the top level dispatch for the actual multiplication.
-    // Case 1: not a Kronecker monomial, do the plain mult.
+    // Case 1: not a Kronecker or packed monomial, do the plain mult.
     template <typename T = Series,
-              typename std::enable_if<!detail::is_kronecker_monomial<typename T::term_type::key_type>::value, int>::type
+              typename std::enable_if<!detail::is_int_packed_key<typename T::term_type::key_type>::value, int>::type
               = 0>
     Series execute() const
     {
@@ -3002,20 +3295,139 @@ private:
     {
         return false;
     }
-    // Case 2: Kronecker mult, do the special multiplication unless a truncation is active. In that case, run the
-    // plain mult.
+    // Case 2: Kronecker or packed monomial, do the special multiplication unless a truncation is active. In that
+    // case, run the plain mult.
     template <typename T = Series,
-              typename std::enable_if<detail::is_kronecker_monomial<typename T::term_type::key_type>::value, int>::type
+              typename std::enable_if<detail::is_int_packed_key<typename T::term_type::key_type>::value, int>::type
               = 0>
     Series execute() const
     {
         if (check_truncation()) {
             return plain_multiplication_wrapper();
         }
+        return kronecker_mult_dispatch();
+    }
+    // Integral coefficients: try the multi-modular multiplication, if requested.
+    template <typename T = Series,
+              typename std::enable_if<detail::is_mp_integer<typename T::term_type::cf_type>::value, int>::type = 0>
+    Series kronecker_mult_dispatch() const
+    {
+        if (tuning::get_crt_multiplication()) {
+            Series retval;
+            if (crt_multiplication(retval)) {
+                return retval;
+            }
+        }
+        return untruncated_kronecker_mult();
+    }
+    template <typename T = Series,
+              typename std::enable_if<!detail::is_mp_integer<typename T::term_type::cf_type>::value, int>::type = 0>
+    Series kronecker_mult_dispatch() const
+    {
         return untruncated_kronecker_mult();
     }
+    // Multi-modular multiplication. The operands are reduced modulo a set of word-size primes, multiplied with
+    // mod_int coefficients and the result is reconstructed via the Chinese remainder theorem. Returns false if the
+    // available primes are not enough to represent the coefficients of the result.
+    template <typename T = Series>
+    bool crt_multiplication(Series &retval) const
+    {
+        using cf_type = typename T::term_type::cf_type;
+        using primes = detail::mod_int_primes<>;
+        retval.set_symbol_set(this->m_ss);
+        const auto rt = this->track_rehashes(retval);
+        const auto size1 = this->m_v1.size(), size2 = this->m_v2.size();
+        if (unlikely(!size1 || !size2)) {
+            return true;
+        }
+        // The heights of the operands.
+        auto height = [](const typename base::v_ptr &v) {
+            cf_type retval(0);
+            for (const auto &p : v) {
+                auto tmp(math::abs(p->m_cf));
+                if (retval < tmp) {
+                    retval = std::move(tmp);
+                }
+            }
+            return retval;
+        };
+        // Each coefficient of the result is the sum of at most min(size1, size2) products of coefficients
+        // of the operands. The product of the primes must be larger than twice this bound, in order to be
+        // able to reconstruct negative values.
+        const cf_type bound = height(this->m_v1) * height(this->m_v2) * cf_type(std::min(size1, size2)) * 2;
+        cf_type prod(1);
+        std::size_t n_primes = 0u;
+        for (; prod <= bound; ++n_primes) {
+            if (n_primes == primes::size) {
+                return false;
+            }
+            prod *= primes::value[n_primes];
+        }
+        cf_type cur_mod(1);
+        crt_step<0u>(retval, n_primes, cur_mod);
+        piranha_assert(cur_mod == prod);
+        // Map the coefficients from [0, prod) to the symmetric range.
+        const cf_type half = prod / 2;
+        for (const auto &t : retval._container()) {
+            piranha_assert(!math::is_zero(t.m_cf));
+            if (t.m_cf > half) {
+                t.m_cf -= prod;
+            }
+        }
+        return true;
+    }
+    // Garner's algorithm, one prime at a time: after the step with index I, the coefficients in retval are the
+    // residues of the exact coefficients modulo the product of the first I + 1 primes, stored in cur_mod.
+    template <std::size_t I, typename T = Series,
+              typename std::enable_if<(I < detail::mod_int_primes<>::size), int>::type = 0>
+    void crt_step(Series &retval, const std::size_t &n_primes, typename T::term_type::cf_type &cur_mod) const
+    {
+        if (I == n_primes) {
+            return;
+        }
+        using cf_type = typename T::term_type::cf_type;
+        using key_type = typename T::term_type::key_type;
+        using m_cf_type = mod_int<detail::mod_int_primes<>::value[I]>;
+        using m_poly_type = polynomial<m_cf_type, key_type>;
+        using m_term_type = typename m_poly_type::term_type;
+        auto reduce = [this](const typename base::v_ptr &v) {
+            m_poly_type retval;
+            retval.set_symbol_set(this->m_ss);
+            for (const auto &p : v) {
+                retval.insert(m_term_type(m_cf_type(p->m_cf), p->m_key));
+            }
+            return retval;
+        };
+        // NOTE: this will go through the Kronecker multiplication with word-size coefficients.
+        const auto res = reduce(this->m_v1) * reduce(this->m_v2);
+        auto &container = retval._container();
+        // Make sure all the monomials of the residue are present in retval.
+        for (const auto &t : res._container()) {
+            typename T::term_type tmp(cf_type(0), t.m_key);
+            if (container.find(tmp) == container.end()) {
+                container.insert(std::move(tmp));
+            }
+        }
+        // Update the coefficients. A monomial missing from the residue has a zero residue.
+        const m_cf_type inv = m_cf_type(cur_mod).inverse();
+        const auto r_end = res._container().end();
+        for (const auto &t : container) {
+            const auto it = res._container().find(m_term_type(m_cf_type(0), t.m_key));
+            const m_cf_type delta = ((it == r_end ? m_cf_type(0) : it->m_cf) - m_cf_type(t.m_cf)) * inv;
+            if (!delta.is_zero()) {
+                math::multiply_accumulate(t.m_cf, cur_mod, cf_type(delta.get_value()));
+            }
+        }
+        cur_mod *= detail::mod_int_primes<>::value[I];
+        crt_step<I + 1u>(retval, n_primes, cur_mod);
+    }
+    template <std::size_t I, typename T = Series,
+              typename std::enable_if<(I == detail::mod_int_primes<>::size), int>::type = 0>
+    void crt_step(Series &, const std::size_t &, typename T::term_type::cf_type &) const
+    {
+    }
     template <typename T = Series,
-              typename std::enable_if<detail::is_kronecker_monomial<typename T::term_type::key_type>::value, int>::type
+              typename std::enable_if<detail::is_int_packed_key<typename T::term_type::key_type>::value, int>::type
               = 0>
     Series untruncated_kronecker_mult() const
     {
@@ -3038,10 +3450,17 @@ private:
         // Setup the return value.
         Series retval;
         retval.set_symbol_set(this->m_ss);
+        const auto rt = this->track_rehashes(retval);
         // Do not do anything if one of the two series is empty, just return an empty series.
         if (unlikely(!size1 || !size2)) {
             return retval;
         }
+        // The partitioning of the output in the multithreaded sparse Kronecker multiplication requires
+        // the bucket of the product of two terms to be the sum of the buckets of the factors. If the hash
+        // mixing strategy does not preserve this property, use the plain multiplication instead.
+        if (this->m_n_threads != 1u && !retval._container().hash_function().is_additive()) {
+            return this->plain_multiplication();
+        }
         // Rehash the retun value's container accordingly. Check the tuning flag to see if we want to use
         // multiple threads for initing the return value.
         // NOTE: it is important here that we use the same n_threads for multiplication and memset as
@@ -3055,9 +3474,208 @@ private:
                                        std::ceil(static_cast<double>(est) / retval._container().max_load_factor())),
                                    n_threads_rehash);
         piranha_assert(retval._container().bucket_count());
+        this->record_estimate(est, retval);
         sparse_kronecker_multiplication(retval);
         return retval;
     }
+    // Consumption of the multiplication tasks in the sparse Kronecker multiplication.
+    // NOTE: these will have to be adapted for kd_monomial.
+    using kronecker_term_type = typename Series::term_type;
+    template <typename T>
+    using kronecker_key_int_type = typename T::term_type::key_type::value_type;
+    template <typename T>
+    using kronecker_container_type = typename std::remove_reference<decltype(std::declval<T &>()._container())>::type;
+    // Per-thread buffers used by the batched consumers. They stay empty when no batched consumer is in use.
+    template <typename T = Series>
+    struct task_buffers {
+        using cf_type = typename T::term_type::cf_type;
+        explicit task_buffers(std::size_t size)
+            : m_cf2(size), m_acc(size), m_dest(size), m_src(size), m_keys(size), m_buckets(size)
+        {
+        }
+        std::vector<double> m_cf2;
+        std::vector<double> m_acc;
+        std::vector<cf_type *> m_dest;
+        std::vector<const cf_type *> m_src;
+        std::vector<kronecker_key_int_type<T>> m_keys;
+        std::vector<typename T::size_type> m_buckets;
+    };
+    // The batched consumers are available for double-precision and mp_integer coefficients.
+    template <typename T = Series>
+    using batched_consume_double = std::is_same<typename T::term_type::cf_type, double>;
+    template <typename T = Series>
+    using batched_consume_integer = detail::is_mp_integer<typename T::term_type::cf_type>;
+    // Size of the task buffers: zero if the batched consumer is not to be used.
+    template <typename T = Series, typename std::enable_if<!batched_consume_double<T>::value
+                                                               && !batched_consume_integer<T>::value,
+                                                           int>::type = 0>
+    static std::size_t task_buffers_size(std::size_t, std::size_t)
+    {
+        return 0u;
+    }
+    template <typename T = Series, typename std::enable_if<batched_consume_double<T>::value, int>::type = 0>
+    static std::size_t task_buffers_size(std::size_t block_size, std::size_t bucket_count)
+    {
+        // NOTE: the batched consumer pays off when the output table is too large to stay in the cache, as the
+        // latency of the bucket accesses is then overlapped across the block. For smaller tables the additional
+        // passes over the block make it slower than the plain consumer.
+        return bucket_count >= detail::base_batched_mult<>::s_min_bucket_count.load() ? block_size : 0u;
+    }
+    template <typename T = Series, typename std::enable_if<batched_consume_integer<T>::value, int>::type = 0>
+    static std::size_t task_buffers_size(std::size_t block_size, std::size_t)
+    {
+        return block_size;
+    }
+    // Plain consumer: multiply the term t1 by the terms in [start2, end2) and accumulate in the container
+    // one product at a time.
+    template <typename T = Series>
+    static void kronecker_task_consume_plain(kronecker_container_type<T> &container,
+                                             const kronecker_key_int_type<T> &g_mask, kronecker_term_type const *t1,
+                                             kronecker_term_type const *const *start2,
+                                             kronecker_term_type const *const *end2, kronecker_term_type &tmp_term)
+    {
+        // End of the container, always the same value.
+        const auto it_end = container.end();
+        // Get shortcuts to cf and key in t1.
+        const auto &cf1 = t1->m_cf;
+        const kronecker_key_int_type<T> key1 = t1->m_key.get_int();
+        // Iterate over the task.
+        for (; start2 != end2; ++start2) {
+            // Const ref to the current term in the second series.
+            const auto &cur = **start2;
+            // Add the keys.
+            const auto key_sum = static_cast<kronecker_key_int_type<T>>(key1 + cur.m_key.get_int());
+            if (unlikely(key_sum & g_mask)) {
+                piranha_throw(std::overflow_error, "monomial components are out of bounds");
+            }
+            tmp_term.m_key.set_int(key_sum);
+            // Try to locate the term into retval.
+            auto bucket_idx = container._bucket(tmp_term);
+            const auto it = container._find(tmp_term, bucket_idx);
+            if (it == it_end) {
+                // NOTE: for coefficient series, we might want to insert with move() below,
+                // as we are not going to re-use the allocated resources in tmp.m_cf.
+                // Take care of multiplying the coefficient.
+                detail::cf_mult_impl(tmp_term.m_cf, cf1, cur.m_cf);
+                container._unique_insert(tmp_term, bucket_idx);
+            } else {
+                // NOTE: here we need to decide if we want to give the same treatment to fmp as we did with
+                // cf_mult_impl.
+                // For the moment it is an implementation detail of this class.
+                fma_wrap(it->m_cf, cf1, cur.m_cf);
+            }
+        }
+    }
+    template <typename T = Series, typename std::enable_if<!batched_consume_double<T>::value
+                                                               && !batched_consume_integer<T>::value,
+                                                           int>::type = 0>
+    static void kronecker_task_consume(kronecker_container_type<T> &container, const kronecker_key_int_type<T> &g_mask,
+                                       kronecker_term_type const *t1, kronecker_term_type const *const *start2,
+                                       kronecker_term_type const *const *end2, kronecker_term_type &tmp_term,
+                                       task_buffers<T> &)
+    {
+        kronecker_task_consume_plain(container, g_mask, t1, start2, end2, tmp_term);
+    }
+    // Batched consumer for double-precision coefficients. The task is processed in passes:
+    // - the destination keys and buckets are computed, and the buckets are prefetched,
+    // - the destination slots are located in the container, and the current values of the destination
+    //   coefficients (or zero, for missing terms) are gathered into a contiguous accumulator,
+    // - the accumulator is updated with the vectorised multiply-accumulate kernel,
+    // - the results are scattered back into the container, inserting the missing terms.
+    // Within a task the term of the first series is fixed, so all the destination keys are distinct and
+    // no slot is written twice. The results are identical to those of the plain consumer.
+    template <typename T = Series, typename std::enable_if<batched_consume_double<T>::value, int>::type = 0>
+    static void kronecker_task_consume(kronecker_container_type<T> &container, const kronecker_key_int_type<T> &g_mask,
+                                       kronecker_term_type const *t1, kronecker_term_type const *const *start2,
+                                       kronecker_term_type const *const *end2, kronecker_term_type &tmp_term,
+                                       task_buffers<T> &buf)
+    {
+        if (buf.m_acc.empty()) {
+            kronecker_task_consume_plain(container, g_mask, t1, start2, end2, tmp_term);
+            return;
+        }
+        const auto it_end = container.end();
+        const auto n = static_cast<std::size_t>(end2 - start2);
+        piranha_assert(n <= buf.m_acc.size());
+        const double cf1 = t1->m_cf;
+        const kronecker_key_int_type<T> key1 = t1->m_key.get_int();
+        // Keys and buckets.
+        for (std::size_t i = 0u; i < n; ++i) {
+            const auto &cur = *start2[i];
+            const auto key_sum = static_cast<kronecker_key_int_type<T>>(key1 + cur.m_key.get_int());
+            if (unlikely(key_sum & g_mask)) {
+                piranha_throw(std::overflow_error, "monomial components are out of bounds");
+            }
+            tmp_term.m_key.set_int(key_sum);
+            buf.m_keys[i] = key_sum;
+            buf.m_buckets[i] = container._bucket(tmp_term);
+            buf.m_cf2[i] = cur.m_cf;
+            container._prefetch(buf.m_buckets[i]);
+        }
+        // Gather.
+        for (std::size_t i = 0u; i < n; ++i) {
+            tmp_term.m_key.set_int(buf.m_keys[i]);
+            const auto it = container._find(tmp_term, buf.m_buckets[i]);
+            if (it == it_end) {
+                buf.m_dest[i] = nullptr;
+                buf.m_acc[i] = 0.;
+            } else {
+                buf.m_dest[i] = &it->m_cf;
+                buf.m_acc[i] = it->m_cf;
+            }
+        }
+        // Accumulate.
+        detail::vk_fma(buf.m_acc.data(), cf1, buf.m_cf2.data(), n);
+        // Scatter.
+        // NOTE: the insertion of new terms does not move the existing ones in the container,
+        // hence the pointers in m_dest remain valid.
+        for (std::size_t i = 0u; i < n; ++i) {
+            if (buf.m_dest[i]) {
+                *buf.m_dest[i] = buf.m_acc[i];
+            } else {
+                tmp_term.m_key.set_int(buf.m_keys[i]);
+                tmp_term.m_cf = buf.m_acc[i];
+                container._unique_insert(tmp_term, buf.m_buckets[i]);
+            }
+        }
+    }
+    // Batched consumer for mp_integer coefficients. The missing terms are inserted as they are located, while
+    // the products to be accumulated into existing terms are collected and then handed over to mp_integer::mac_n(),
+    // which processes static integers without going through the generic multiply-accumulate machinery.
+    // NOTE: the destination coefficients belong to retval, so they cannot alias the coefficients of the factors.
+    template <typename T = Series, typename std::enable_if<batched_consume_integer<T>::value, int>::type = 0>
+    static void kronecker_task_consume(kronecker_container_type<T> &container, const kronecker_key_int_type<T> &g_mask,
+                                       kronecker_term_type const *t1, kronecker_term_type const *const *start2,
+                                       kronecker_term_type const *const *end2, kronecker_term_type &tmp_term,
+                                       task_buffers<T> &buf)
+    {
+        using cf_type = typename T::term_type::cf_type;
+        const auto it_end = container.end();
+        const auto n = static_cast<std::size_t>(end2 - start2);
+        piranha_assert(n <= buf.m_dest.size());
+        const auto &cf1 = t1->m_cf;
+        const kronecker_key_int_type<T> key1 = t1->m_key.get_int();
+        std::size_t n_acc = 0u;
+        for (std::size_t i = 0u; i < n; ++i) {
+            const auto &cur = *start2[i];
+            const auto key_sum = static_cast<kronecker_key_int_type<T>>(key1 + cur.m_key.get_int());
+            if (unlikely(key_sum & g_mask)) {
+                piranha_throw(std::overflow_error, "monomial components are out of bounds");
+            }
+            tmp_term.m_key.set_int(key_sum);
+            const auto bucket_idx = container._bucket(tmp_term);
+            const auto it = container._find(tmp_term, bucket_idx);
+            if (it == it_end) {
+                detail::cf_mult_impl(tmp_term.m_cf, cf1, cur.m_cf);
+                container._unique_insert(tmp_term, bucket_idx);
+            } else {
+                buf.m_dest[n_acc] = &it->m_cf;
+                buf.m_src[n_acc] = &cur.m_cf;
+                ++n_acc;
+            }
+        }
+        cf_type::mac_n(buf.m_dest.data(), cf1, buf.m_src.data(), n_acc);
+    }
     void sparse_kronecker_multiplication(Series &retval) const
     {
         using bucket_size_type = typename base::bucket_size_type;
@@ -3076,7 +3694,8 @@ private:
         auto &container = retval._container();
         // A convenience functor to compute the destination bucket
         // of a term into retval.
-        auto r_bucket = [&container](term_type const *p) { return container._bucket_from_hash(p->hash()); };
+        // NOTE: go through the container's hasher, which might mix the hash value of the term.
+        auto r_bucket = [&container](term_type const *p) { return container._bucket(*p); };
         // Sort input terms according to bucket positions in retval.
         auto term_cmp = [&r_bucket](term_type const *p1, term_type const *p2) { return r_bucket(p1) < r_bucket(p2); };
         std::stable_sort(v1.begin(), v1.end(), term_cmp);
@@ -3104,44 +3723,18 @@ private:
                 out.emplace_back(std::get<0u>(t), start, end);
             }
         };
-        // End of the container, always the same value.
-        const auto it_end = container.end();
+        // Guard mask for the detection of overflows in the keys.
+        const auto g_mask = key_guard_mask();
         // Function to perform all the term-by-term multiplications in a task, using tmp_term
-        // as a temporary value for the computation of the result.
-        auto task_consume = [&v1, &v2, &container, it_end, this](const task_type &task, term_type &tmp_term) {
-            // Get the term in the first series.
-            term_type const *t1 = v1[std::get<0u>(task)];
-            // Get pointers to the second series.
-            term_type const **start2 = &(v2[std::get<1u>(task)]), **end2 = &(v2[std::get<2u>(task)]);
-            // NOTE: these will have to be adapted for kd_monomial.
-            using int_type = decltype(t1->m_key.get_int());
-            // Get shortcuts to cf and key in t1.
-            const auto &cf1 = t1->m_cf;
-            const int_type key1 = t1->m_key.get_int();
-            // Iterate over the task.
-            for (; start2 != end2; ++start2) {
-                // Const ref to the current term in the second series.
-                const auto &cur = **start2;
-                // Add the keys.
-                // NOTE: this will have to be adapted for kd_monomial.
-                tmp_term.m_key.set_int(static_cast<int_type>(key1 + cur.m_key.get_int()));
-                // Try to locate the term into retval.
-                auto bucket_idx = container._bucket(tmp_term);
-                const auto it = container._find(tmp_term, bucket_idx);
-                if (it == it_end) {
-                    // NOTE: for coefficient series, we might want to insert with move() below,
-                    // as we are not going to re-use the allocated resources in tmp.m_cf.
-                    // Take care of multiplying the coefficient.
-                    detail::cf_mult_impl(tmp_term.m_cf, cf1, cur.m_cf);
-                    container._unique_insert(tmp_term, bucket_idx);
-                } else {
-                    // NOTE: here we need to decide if we want to give the same treatment to fmp as we did with
-                    // cf_mult_impl.
-                    // For the moment it is an implementation detail of this class.
-                    this->fma_wrap(it->m_cf, cf1, cur.m_cf);
-                }
-            }
+        // and buf as temporary storage for the computation of the result.
+        auto task_consume = [&v1, &v2, &container, g_mask](const task_type &task, term_type &tmp_term,
+                                                           task_buffers<> &buf) {
+            kronecker_task_consume(container, g_mask, v1[std::get<0u>(task)], v2.data() + std::get<1u>(task),
+                                   v2.data() + std::get<2u>(task), tmp_term, buf);
         };
+        // Size of the per-thread task buffers.
+        const auto buf_size = task_buffers_size(safe_cast<std::size_t>(block_size),
+                                                safe_cast<std::size_t>(container.bucket_count()));
         if (this->m_n_threads == 1u) {
             try {
                 // Single threaded case.
@@ -3153,11 +3746,17 @@ private:
                 // Sort the tasks.
                 std::stable_sort(tasks.begin(), tasks.end(), task_cmp);
                 // Iterate over the tasks and run the multiplication.
-                term_type tmp_term;
-                for (const auto &t : tasks) {
-                    task_consume(t, tmp_term);
+                {
+                    detail::thread_work_recorder rec(this->m_stats.get(), 0u);
+                    trace_scope ts("table_fill", "multiplication");
+                    rec.add_tasks(static_cast<unsigned long long>(tasks.size()));
+                    term_type tmp_term;
+                    task_buffers<> buf(buf_size);
+                    for (const auto &t : tasks) {
+                        task_consume(t, tmp_term, buf);
+                    }
                 }
-                this->sanitise_series(retval, this->m_n_threads);
+                this->sanitise_series(retval, this->m_n_threads, this->stats_n_cancellations());
                 this->finalise_series(retval);
             } catch (...) {
                 retval._container().clear();
@@ -3169,8 +3768,16 @@ private:
         const bucket_size_type bucket_count = container.bucket_count();
         // Compute the number of zones in which the output container will be subdivided,
         // a multiple of the number of threads.
-        // NOTE: zm is a tuning parameter.
-        const unsigned zm = 10u;
+        // NOTE: zm is a tuning parameter. We use at least 10 zones per thread for load balancing and,
+        // if the table is large, enough zones for the buckets of a zone (each storing a term inline) to fit in the
+        // L2 cache. The number of zones is capped, as the cost of the setup below grows linearly with it.
+        static const unsigned long l2_size = runtime_info::get_cache_size(2u);
+        unsigned zm = 10u;
+        if (l2_size) {
+            const auto table_size = integer(bucket_count) * (sizeof(term_type) + sizeof(void *));
+            const auto cache_zm = (table_size / (integer(this->m_n_threads) * l2_size)) + 1;
+            zm = static_cast<unsigned>(std::max(integer(zm), std::min(cache_zm, integer(40))));
+        }
         const bucket_size_type n_zones = static_cast<bucket_size_type>(integer(this->m_n_threads) * zm);
         // Number of buckets per zone (can be zero).
         const bucket_size_type bpz = static_cast<bucket_size_type>(bucket_count / n_zones);
@@ -3251,19 +3858,11 @@ private:
             }
         };
         // Go with the threads to fill the task table.
-        future_list<decltype(table_filler(0u))> ff_list;
-        try {
-            for (unsigned i = 0u; i < this->m_n_threads; ++i) {
-                ff_list.push_back(thread_pool::enqueue(i, table_filler, i));
+        thread_pool::parallel_for(0u, this->m_n_threads, 1u, [&table_filler](std::size_t i_start, std::size_t i_end) {
+            for (auto i = i_start; i != i_end; ++i) {
+                table_filler(static_cast<unsigned>(i));
             }
-            // First let's wait for everything to finish.
-            ff_list.wait_all();
-            // Then, let's handle the exceptions.
-            ff_list.get_all();
-        } catch (...) {
-            ff_list.wait_all();
-            throw;
-        }
+        });
         // Check the consistency of the table for debug purposes.
         auto table_checker = [&task_table, size1, size2, &r_bucket, bpz, bucket_count, &v1, &v2]() -> bool {
             // Total number of term-by-term multiplications. Needs to be equal
@@ -3300,13 +3899,26 @@ private:
         };
         (void)table_checker;
         piranha_assert(table_checker());
+        // Record the number of term-by-term multiplications in each zone.
+        if (this->m_stats) {
+            for (const auto &v : task_table) {
+                unsigned long long n = 0u;
+                for (const auto &t : v) {
+                    n += static_cast<unsigned long long>(std::get<2u>(t) - std::get<1u>(t));
+                }
+                this->m_stats->zone_sizes.push_back(n);
+            }
+        }
         // Init the vector of atomic flags.
         detail::atomic_flag_array af(safe_cast<std::size_t>(task_table.size()));
         // Thread functor.
-        auto thread_functor = [zm, &task_table, &af, &v1, &v2, &container, &task_consume](const unsigned &thread_idx) {
+        auto thread_functor = [this, zm, &task_table, &af, &task_consume, buf_size](const unsigned &thread_idx) {
             using t_size_type = decltype(task_table.size());
-            // Temporary term_type for caching.
+            detail::thread_work_recorder rec(this->m_stats.get(), thread_idx);
+            trace_scope ts("table_fill", "multiplication");
+            // Temporary term_type and buffers for caching.
             term_type tmp_term;
+            task_buffers<> buf(buf_size);
             // The starting index in the task table.
             auto t_idx = static_cast<t_size_type>(t_size_type(thread_idx) * zm);
             const auto start_t_idx = t_idx;
@@ -3316,8 +3928,9 @@ private:
                     // Current vector of tasks.
                     const auto &cur_tasks = task_table[t_idx];
                     for (const auto &t : cur_tasks) {
-                        task_consume(t, tmp_term);
+                        task_consume(t, tmp_term, buf);
                     }
+                    rec.add_tasks(1u);
                 }
                 // Update the index, wrapping around if necessary.
                 t_idx = static_cast<t_size_type>(t_idx + 1u);
@@ -3331,20 +3944,17 @@ private:
             }
         };
         // Go with the multiplication threads.
-        future_list<decltype(thread_functor(0u))> ft_list;
         try {
-            for (unsigned i = 0u; i < this->m_n_threads; ++i) {
-                ft_list.push_back(thread_pool::enqueue(i, thread_functor, i));
-            }
-            // First let's wait for everything to finish.
-            ft_list.wait_all();
-            // Then, let's handle the exceptions.
-            ft_list.get_all();
+            thread_pool::parallel_for(0u, this->m_n_threads, 1u,
+                                      [&thread_functor](std::size_t i_start, std::size_t i_end) {
+                                          for (auto i = i_start; i != i_end; ++i) {
+                                              thread_functor(static_cast<unsigned>(i));
+                                          }
+                                      });
             // Finally, fix and finalise the series.
-            this->sanitise_series(retval, this->m_n_threads);
+            this->sanitise_series(retval, this->m_n_threads, this->stats_n_cancellations());
             this->finalise_series(retval);
         } catch (...) {
-            ft_list.wait_all();
             // Clean up and re-throw.
             retval._container().clear();
             throw;
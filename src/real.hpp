@@ -74,6 +74,18 @@ struct real_base {
     // The precision is the number of bits used to represent the significand of a floating-point number.
     // This default value is equivalent to the IEEE 754 quadruple-precision binary floating-point format.
     static const ::mpfr_prec_t default_prec = 113;
+    // Inline significand precision.
+    // Significands with a precision up to this value are stored in a buffer inside the real object, rather than
+    // in memory allocated dynamically by MPFR. The default value covers the default precision. It can be changed
+    // by defining the PIRANHA_REAL_INLINE_PREC macro before including Piranha's headers.
+#if defined(PIRANHA_REAL_INLINE_PREC)
+    static const ::mpfr_prec_t inline_prec = PIRANHA_REAL_INLINE_PREC;
+#else
+    static const ::mpfr_prec_t inline_prec = 128;
+#endif
+    // Number of limbs in the inline buffer.
+    static const std::size_t inline_size
+        = static_cast<std::size_t>(inline_prec / GMP_NUMB_BITS + (inline_prec % GMP_NUMB_BITS != 0));
 };
 
 template <typename T>
@@ -82,6 +94,12 @@ const ::mpfr_rnd_t real_base<T>::default_rnd;
 template <typename T>
 const ::mpfr_prec_t real_base<T>::default_prec;
 
+template <typename T>
+const ::mpfr_prec_t real_base<T>::inline_prec;
+
+template <typename T>
+const std::size_t real_base<T>::inline_size;
+
 // Types interoperable with real.
 template <typename T>
 struct is_real_interoperable_type {
@@ -118,6 +136,14 @@ struct is_real_interoperable_type {
  * Move construction and move assignment will leave the moved-from object in a state that is destructible and
  * assignable.
  *
+ * ## Inline storage ##
+ *
+ * Significands whose precision does not exceed real::inline_prec bits (128 by default, which covers
+ * real::default_prec) are stored in a small buffer inside the object, via the custom interface of the MPFR library.
+ * Such values require no dynamic memory allocation, and moving them amounts to copying a few limbs. Significands with
+ * higher precision are allocated on the heap by MPFR as usual. The value of real::inline_prec can be changed at
+ * compile time by defining the \p PIRANHA_REAL_INLINE_PREC macro before including Piranha's headers.
+ *
  * @see http://www.mpfr.org
  */
 // NOTES:
@@ -152,14 +178,49 @@ class real : public detail::real_base<>
             piranha_throw(std::invalid_argument, "invalid significand precision requested");
         }
     }
+    // Check if the significand is stored in the inline buffer.
+    bool is_inline() const
+    {
+        return m_value->_mpfr_d == m_limbs;
+    }
+    // Initialise m_value to NaN with precision prec, which is assumed to be valid. The inline
+    // buffer will be used if prec is small enough.
+    void init_impl(const ::mpfr_prec_t &prec)
+    {
+        if (prec <= inline_prec) {
+            mpfr_custom_init(m_limbs, prec);
+            mpfr_custom_init_set(m_value, MPFR_NAN_KIND, 0, prec, m_limbs);
+        } else {
+            ::mpfr_init2(m_value, prec);
+        }
+    }
+    // Release the storage of m_value, if allocated by MPFR.
+    void clear_impl()
+    {
+        if (m_value->_mpfr_d && !is_inline()) {
+            ::mpfr_clear(m_value);
+        }
+    }
+    // Change the precision of m_value, which is reset to NaN. prec is assumed to be valid.
+    // NOTE: MPFR must never see an inline significand in mpfr_set_prec() or mpfr_clear(), as it would try to
+    // reallocate/free it.
+    void set_prec_impl(const ::mpfr_prec_t &prec)
+    {
+        if (prec > inline_prec && m_value->_mpfr_d && !is_inline()) {
+            ::mpfr_set_prec(m_value, prec);
+        } else {
+            clear_impl();
+            init_impl(prec);
+        }
+    }
     // Construction.
     void construct_from_string(const char *str, const ::mpfr_prec_t &prec)
     {
         prec_check(prec);
-        ::mpfr_init2(m_value, prec);
+        init_impl(prec);
         const int retval = ::mpfr_set_str(m_value, str, 10, default_rnd);
         if (retval != 0) {
-            ::mpfr_clear(m_value);
+            clear_impl();
             piranha_throw(std::invalid_argument, "invalid string input for real");
         }
     }
@@ -735,7 +796,7 @@ public:
      */
     real()
     {
-        ::mpfr_init2(m_value, default_prec);
+        init_impl(default_prec);
         ::mpfr_set_zero(m_value, 0);
     }
     /// Copy constructor.
@@ -747,7 +808,7 @@ public:
     real(const real &other)
     {
         // Init with the same precision as other, and then set.
-        ::mpfr_init2(m_value, other.get_prec());
+        init_impl(other.get_prec());
         ::mpfr_set(m_value, other.m_value, default_rnd);
     }
     /// Move constructor.
@@ -759,7 +820,13 @@ public:
         m_value->_mpfr_prec = other.m_value->_mpfr_prec;
         m_value->_mpfr_sign = other.m_value->_mpfr_sign;
         m_value->_mpfr_exp = other.m_value->_mpfr_exp;
-        m_value->_mpfr_d = other.m_value->_mpfr_d;
+        if (other.is_inline()) {
+            // Inline significands cannot be stolen, copy the limbs.
+            std::copy(other.m_limbs, other.m_limbs + size_from_prec(other.m_value->_mpfr_prec), m_limbs);
+            m_value->_mpfr_d = m_limbs;
+        } else {
+            m_value->_mpfr_d = other.m_value->_mpfr_d;
+        }
         // Erase other.
         other.m_value->_mpfr_prec = 0;
         other.m_value->_mpfr_sign = 0;
@@ -807,7 +874,7 @@ public:
     explicit real(const real &other, const ::mpfr_prec_t &prec)
     {
         prec_check(prec);
-        ::mpfr_init2(m_value, prec);
+        init_impl(prec);
         ::mpfr_set(m_value, other.m_value, default_rnd);
     }
     /// Generic constructor.
@@ -825,7 +892,7 @@ public:
     explicit real(const T &x, const ::mpfr_prec_t &prec = default_prec)
     {
         prec_check(prec);
-        ::mpfr_init2(m_value, prec);
+        init_impl(prec);
         construct_from_generic(x);
     }
     /// Destructor.
@@ -851,7 +918,7 @@ public:
             } else {
                 piranha_assert(!m_value->_mpfr_prec && !m_value->_mpfr_sign && !m_value->_mpfr_exp);
                 // Reinit before setting.
-                ::mpfr_init2(m_value, other.get_prec());
+                init_impl(other.get_prec());
             }
             ::mpfr_set(m_value, other.m_value, default_rnd);
         }
@@ -929,7 +996,7 @@ public:
         if (!m_value->_mpfr_d) {
             piranha_assert(!m_value->_mpfr_prec && !m_value->_mpfr_sign && !m_value->_mpfr_exp);
             // Re-init with default prec if it was moved-from.
-            ::mpfr_init2(m_value, default_prec);
+            init_impl(default_prec);
         }
         // NOTE: all construct_from_generic() methods here are really assignments.
         construct_from_generic(x);
@@ -974,7 +1041,29 @@ public:
         if (this == &other) {
             return;
         }
-        ::mpfr_swap(m_value, other.m_value);
+        const bool i1 = is_inline(), i2 = other.is_inline();
+        if (!i1 && !i2) {
+            ::mpfr_swap(m_value, other.m_value);
+            return;
+        }
+        // At least one significand is inline: swap the non-limb members and the limbs in use of the
+        // inline buffers (the rest of the buffers is uninitialised), then fix the significand pointers.
+        const ::mpfr_prec_t n1 = i1 ? size_from_prec(m_value->_mpfr_prec) : 0,
+                            n2 = i2 ? size_from_prec(other.m_value->_mpfr_prec) : 0;
+        ::mp_limb_t tmp[inline_size];
+        std::copy(m_limbs, m_limbs + n1, tmp);
+        std::copy(other.m_limbs, other.m_limbs + n2, m_limbs);
+        std::copy(tmp, tmp + n1, other.m_limbs);
+        std::swap(m_value->_mpfr_prec, other.m_value->_mpfr_prec);
+        std::swap(m_value->_mpfr_sign, other.m_value->_mpfr_sign);
+        std::swap(m_value->_mpfr_exp, other.m_value->_mpfr_exp);
+        std::swap(m_value->_mpfr_d, other.m_value->_mpfr_d);
+        if (i2) {
+            m_value->_mpfr_d = m_limbs;
+        }
+        if (i1) {
+            other.m_value->_mpfr_d = other.m_limbs;
+        }
     }
     /// Sign.
     /**
@@ -1033,7 +1122,7 @@ public:
     void set_prec(const ::mpfr_prec_t &prec)
     {
         prec_check(prec);
-        ::mpfr_set_prec(m_value, prec);
+        set_prec_impl(prec);
     }
     /// Negate in-place.
     /**
@@ -1409,9 +1498,13 @@ public:
 #if defined(PIRANHA_HAVE_THREAD_LOCAL)
         static thread_local real tmp;
         // NOTE: set the same precision as this, which is now the max precision of the 3 operands.
-        // If we do not do this, then tmp has an undeterminate precision. Use the raw MPFR function
-        // in order to avoid the checks in get_prec(), as we know the precision has a sane value.
-        ::mpfr_set_prec(tmp.m_value, mpfr_get_prec(m_value));
+        // If we do not do this, then tmp has an undeterminate precision. Use the unchecked implementation
+        // in order to avoid the checks in set_prec(), as we know the precision has a sane value.
+        // NOTE: if the precision does not change, skip the call altogether: the value of tmp
+        // is going to be overwritten anyway.
+        if (mpfr_get_prec(tmp.m_value) != mpfr_get_prec(m_value)) {
+            tmp.set_prec_impl(mpfr_get_prec(m_value));
+        }
         ::mpfr_mul(tmp.m_value, r1.m_value, r2.m_value, MPFR_RNDN);
         ::mpfr_add(m_value, m_value, tmp.m_value, MPFR_RNDN);
 #else
@@ -1886,6 +1979,8 @@ public:
 
 private:
     ::mpfr_t m_value;
+    // Inline storage for small significands.
+    ::mp_limb_t m_limbs[inline_size];
 };
 
 namespace math
@@ -2141,8 +2236,10 @@ inline real::~real()
     PIRANHA_TT_CHECK(is_cf, real);
     static_assert(default_prec >= MPFR_PREC_MIN && default_prec <= MPFR_PREC_MAX,
                   "Invalid value for default precision.");
+    static_assert(inline_prec >= MPFR_PREC_MIN && inline_prec <= MPFR_PREC_MAX,
+                  "Invalid value for inline precision.");
     if (m_value->_mpfr_d) {
-        ::mpfr_clear(m_value);
+        clear_impl();
     } else {
 // NOTE: the story here is that ICC has a weird behaviour when the thread_local
 // storage. Essentially, the thread-local static variable in the fma() function
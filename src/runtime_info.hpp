@@ -32,6 +32,7 @@ see https://www.gnu.org/licenses/. */
 #if defined(__linux__)
 
 #include <boost/lexical_cast.hpp>
+#include <cstddef>
 #include <fstream>
 #include <iostream>
 #include <string>
@@ -69,8 +70,12 @@ extern "C" {
 
 #endif
 
+#include <algorithm>
 #include <memory>
 #include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
 
 #include "config.hpp"
 #include "exceptions.hpp"
@@ -80,12 +85,111 @@ extern "C" {
 namespace piranha
 {
 
+/// CPU cache types.
+enum class cache_type {
+    /// Data cache.
+    data,
+    /// Instruction cache.
+    instruction,
+    /// Unified (data and instructions) cache.
+    unified
+};
+
+/// Description of a CPU cache.
+/**
+ * This structure is returned by piranha::runtime_info::get_cache_hierarchy().
+ */
+struct cache_info {
+    /// Cache level (1 for L1, 2 for L2, etc.).
+    unsigned level;
+    /// Cache type.
+    cache_type type;
+    /// Size of the cache (in bytes).
+    unsigned long size;
+    /// Size of the cache line (in bytes), or 0 if unknown.
+    unsigned line_size;
+    /// Number of ways of associativity, or 0 if unknown.
+    unsigned associativity;
+    /// Logical CPUs sharing the cache, in ascending order.
+    std::vector<unsigned> shared_cpus;
+};
+
 /// Runtime information.
 /**
  * This class allows to query information about the runtime environment.
  */
 class runtime_info
 {
+#if defined(__linux__)
+    // Read the first line of a sysfs file. Returns false on failure.
+    static bool read_sys_line(const std::string &path, std::string &out)
+    {
+        std::ifstream sys_file(path);
+        if (!sys_file.is_open() || !sys_file.good()) {
+            return false;
+        }
+        std::getline(sys_file, out);
+        return !sys_file.fail();
+    }
+    // Parse a sysfs CPU list (e.g., "0-3,8,10-11"). An empty vector is returned on failure.
+    static std::vector<unsigned> parse_cpu_list(const std::string &str)
+    {
+        std::vector<unsigned> retval;
+        try {
+            std::string::size_type pos = 0u;
+            while (pos < str.size()) {
+                auto next = str.find(',', pos);
+                if (next == std::string::npos) {
+                    next = str.size();
+                }
+                const auto item = str.substr(pos, next - pos);
+                const auto dash = item.find('-');
+                if (dash == std::string::npos) {
+                    retval.push_back(boost::lexical_cast<unsigned>(item));
+                } else {
+                    const auto a = boost::lexical_cast<unsigned>(item.substr(0u, dash)),
+                               b = boost::lexical_cast<unsigned>(item.substr(dash + 1u));
+                    for (auto i = a; i <= b && i >= a; ++i) {
+                        retval.push_back(i);
+                    }
+                }
+                pos = next + 1u;
+            }
+        } catch (...) {
+            return std::vector<unsigned>{};
+        }
+        std::sort(retval.begin(), retval.end());
+        return retval;
+    }
+    // Parse a sysfs cache size (e.g., "32K"). Zero is returned on failure.
+    static unsigned long parse_cache_size(const std::string &str)
+    {
+        if (str.empty()) {
+            return 0u;
+        }
+        unsigned long mult = 1u;
+        auto digits = str;
+        switch (str.back()) {
+            case 'K':
+                mult = 1024ul;
+                digits.pop_back();
+                break;
+            case 'M':
+                mult = 1024ul * 1024ul;
+                digits.pop_back();
+                break;
+            case 'G':
+                mult = 1024ul * 1024ul * 1024ul;
+                digits.pop_back();
+                break;
+        }
+        try {
+            return safe_cast<unsigned long>(boost::lexical_cast<unsigned long long>(digits) * mult);
+        } catch (...) {
+            return 0u;
+        }
+    }
+#endif
 
 public:
     /// Hardware concurrency.
@@ -204,6 +308,178 @@ public:
         return 0u;
 #endif
     }
+    /// Cache hierarchy.
+    /**
+     * The information is currently available only on Linux, where it is read from the
+     * <tt>/sys/devices/system/cpu/cpu*</tt><tt>/cache</tt> directories.
+     *
+     * @param cpu the index of the logical CPU whose caches will be described.
+     *
+     * @return the caches visible from the logical CPU \p cpu, in the order reported by the operating system
+     * (typically, from the lowest to the highest level), or an empty vector if the information cannot be determined.
+     *
+     * @throws unspecified any exception thrown by memory allocation errors in standard containers.
+     */
+    static std::vector<cache_info> get_cache_hierarchy(unsigned cpu = 0u)
+    {
+        std::vector<cache_info> retval;
+#if defined(__linux__)
+        const std::string base = "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/cache/index";
+        for (unsigned i = 0u;; ++i) {
+            const std::string dir = base + std::to_string(i) + "/";
+            std::string line;
+            if (!read_sys_line(dir + "level", line)) {
+                break;
+            }
+            cache_info ci;
+            try {
+                ci.level = boost::lexical_cast<unsigned>(line);
+            } catch (...) {
+                continue;
+            }
+            if (!read_sys_line(dir + "type", line)) {
+                continue;
+            }
+            if (line == "Data") {
+                ci.type = cache_type::data;
+            } else if (line == "Instruction") {
+                ci.type = cache_type::instruction;
+            } else if (line == "Unified") {
+                ci.type = cache_type::unified;
+            } else {
+                continue;
+            }
+            if (!read_sys_line(dir + "size", line) || (ci.size = parse_cache_size(line)) == 0u) {
+                continue;
+            }
+            ci.line_size = 0u;
+            ci.associativity = 0u;
+            try {
+                if (read_sys_line(dir + "coherency_line_size", line)) {
+                    ci.line_size = boost::lexical_cast<unsigned>(line);
+                }
+            } catch (...) {
+            }
+            try {
+                if (read_sys_line(dir + "ways_of_associativity", line)) {
+                    ci.associativity = boost::lexical_cast<unsigned>(line);
+                }
+            } catch (...) {
+            }
+            if (read_sys_line(dir + "shared_cpu_list", line)) {
+                ci.shared_cpus = parse_cpu_list(line);
+            }
+            retval.push_back(std::move(ci));
+        }
+#else
+        (void)cpu;
+#endif
+        return retval;
+    }
+    /// Cache size.
+    /**
+     * @param level the cache level.
+     *
+     * @return the size (in bytes) of the data or unified cache of level \p level of the first logical CPU,
+     * or 0 if the value cannot be determined.
+     *
+     * @throws unspecified any exception thrown by get_cache_hierarchy().
+     */
+    static unsigned long get_cache_size(unsigned level)
+    {
+        for (const auto &ci : get_cache_hierarchy()) {
+            if (ci.level == level && ci.type != cache_type::instruction) {
+                return ci.size;
+            }
+        }
+        return 0u;
+    }
+    /// NUMA nodes.
+    /**
+     * The information is currently available only on Linux, where it is read from the
+     * <tt>/sys/devices/system/node</tt> directory.
+     *
+     * @return a vector whose element at index \p i contains the logical CPUs belonging to the NUMA node \p i,
+     * in ascending order, or an empty vector if the information cannot be determined. On non-NUMA systems,
+     * a single node containing all the logical CPUs is typically reported.
+     *
+     * @throws unspecified any exception thrown by memory allocation errors in standard containers.
+     */
+    static std::vector<std::vector<unsigned>> get_numa_nodes()
+    {
+        std::vector<std::vector<unsigned>> retval;
+#if defined(__linux__)
+        std::string line;
+        if (!read_sys_line("/sys/devices/system/node/online", line)) {
+            return retval;
+        }
+        for (const auto &node : parse_cpu_list(line)) {
+            if (node >= retval.size()) {
+                retval.resize(node + 1u);
+            }
+            if (read_sys_line("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist", line)) {
+                retval[node] = parse_cpu_list(line);
+            }
+        }
+#endif
+        return retval;
+    }
+    /// CPU binding order.
+    /**
+     * This method computes the order in which the threads of piranha::thread_pool are bound to the logical CPUs
+     * when thread binding is active. The logical CPUs are sorted so that:
+     * - all the physical cores are used before their hardware threads are (two logical CPUs are considered to
+     *   belong to the same physical core if they share the L1 data cache),
+     * - consecutive threads are bound to CPUs in the same NUMA node and, within a node, to CPUs sharing the
+     *   same last-level cache.
+     *
+     * If the cache hierarchy or the NUMA nodes cannot be determined, the natural order of the logical CPUs is used.
+     *
+     * @return the sequence of logical CPU indices, of size get_hardware_concurrency().
+     *
+     * @throws unspecified any exception thrown by memory allocation errors in standard containers.
+     */
+    static std::vector<unsigned> get_cpu_binding_order()
+    {
+        const unsigned hc = get_hardware_concurrency();
+        // Sort key: rank within the physical core, NUMA node, last-level cache group, CPU index.
+        std::vector<std::tuple<unsigned, unsigned, unsigned, unsigned>> keys;
+        const auto nodes = get_numa_nodes();
+        for (unsigned cpu = 0u; cpu < hc; ++cpu) {
+            unsigned rank = 0u, node = 0u, llc = 0u;
+            for (decltype(nodes.size()) i = 0u; i < nodes.size(); ++i) {
+                if (std::binary_search(nodes[i].begin(), nodes[i].end(), cpu)) {
+                    node = static_cast<unsigned>(i);
+                    break;
+                }
+            }
+            const auto caches = get_cache_hierarchy(cpu);
+            unsigned max_level = 0u;
+            for (const auto &ci : caches) {
+                if (ci.type == cache_type::instruction) {
+                    continue;
+                }
+                const auto it = std::lower_bound(ci.shared_cpus.begin(), ci.shared_cpus.end(), cpu);
+                if (it == ci.shared_cpus.end() || *it != cpu) {
+                    continue;
+                }
+                if (ci.level == 1u) {
+                    rank = static_cast<unsigned>(it - ci.shared_cpus.begin());
+                }
+                if (ci.level > max_level) {
+                    max_level = ci.level;
+                    llc = ci.shared_cpus.front();
+                }
+            }
+            keys.emplace_back(rank, node, llc, cpu);
+        }
+        std::sort(keys.begin(), keys.end());
+        std::vector<unsigned> retval;
+        for (const auto &k : keys) {
+            retval.push_back(std::get<3u>(k));
+        }
+        return retval;
+    }
 };
 }
 
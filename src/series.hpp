@@ -31,6 +31,7 @@ see https://www.gnu.org/licenses/. */
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <boost/iostreams/copy.hpp>
 #include <boost/iostreams/filter/bzip2.hpp>
 #include <boost/iostreams/filtering_streambuf.hpp>
@@ -69,6 +70,7 @@ see https://www.gnu.org/licenses/. */
 #include "key_is_convertible.hpp"
 #include "math.hpp"
 #include "mp_integer.hpp"
+#include "mp_rational.hpp"
 #include "pow.hpp"
 #include "print_coefficient.hpp"
 #include "print_tex_coefficient.hpp"
@@ -79,6 +81,8 @@ see https://www.gnu.org/licenses/. */
 #include "symbol.hpp"
 #include "symbol_set.hpp"
 #include "term.hpp"
+#include "tracer.hpp"
+#include "tuning.hpp"
 #include "type_traits.hpp"
 
 namespace piranha
@@ -87,13 +91,56 @@ namespace piranha
 namespace detail
 {
 
-// Hash functor for term type in series.
+// Counter used to seed the randomised hash mixing.
+template <typename = void>
+struct term_hasher_base {
+    static std::atomic<std::uint_least64_t> s_seed_counter;
+};
+
+template <typename T>
+std::atomic<std::uint_least64_t> term_hasher_base<T>::s_seed_counter(0u);
+
+// Hash functor for term type in series. The hash value of the term is mixed according
+// to the strategy returned by tuning::get_hash_mixing() when the functor is created.
+// NOTE: the identity and randomised strategies are linear modulo 2**n (multiplication by
+// an odd constant), so that for keys with additive hashes (e.g., Kronecker monomials) the bucket of the
+// product of two terms is the sum of the buckets of the factors. The sparse Kronecker multiplication
+// relies on this property in multithreaded mode, and it checks is_additive() before partitioning the output.
 template <typename Term>
-struct term_hasher {
+struct term_hasher : term_hasher_base<> {
+    term_hasher() : m_mult(1u), m_fold(false)
+    {
+        switch (tuning::get_hash_mixing()) {
+            case hash_mixing::identity:
+                break;
+            case hash_mixing::multiply_shift:
+                m_mult = static_cast<std::size_t>(0x9E3779B97F4A7C15ull);
+                m_fold = true;
+                break;
+            case hash_mixing::randomised: {
+                // SplitMix64 applied to a global counter. The multiplier must be odd.
+                std::uint_least64_t z = s_seed_counter.fetch_add(1u) * 0x9E3779B97F4A7C15ull;
+                z = (z ^ (z >> 30u)) * 0xBF58476D1CE4E5B9ull;
+                z = (z ^ (z >> 27u)) * 0x94D049BB133111EBull;
+                z ^= z >> 31u;
+                m_mult = static_cast<std::size_t>(z) | std::size_t(1u);
+            }
+        }
+    }
     std::size_t operator()(const Term &term) const
     {
-        return term.hash();
+        const auto h = static_cast<std::size_t>(term.hash() * m_mult);
+        if (m_fold) {
+            return static_cast<std::size_t>(h ^ (h >> (std::numeric_limits<std::size_t>::digits / 2)));
+        }
+        return h;
     }
+    bool is_additive() const
+    {
+        return !m_fold;
+    }
+    std::size_t m_mult;
+    bool m_fold;
 };
 
 // NOTE: this needs to go here, instead of in the series class as private method,
@@ -153,6 +200,23 @@ public:
 template <typename T>
 const bool is_series<T>::value;
 
+namespace detail
+{
+
+// Canonicalisation of the rationals contained in the coefficients of a series, used by the multiplications in lazy
+// mode (see mp_rational_lazy_scope).
+// NOTE: the coefficients are mutable and they do not contribute to the hash value of the terms.
+template <typename T>
+struct lazy_canonicaliser<T, typename std::enable_if<is_series<T>::value>::type> {
+    void operator()(T &s) const
+    {
+        for (const auto &t : s._container()) {
+            lazy_canonicaliser<typename T::term_type::cf_type>{}(t.m_cf);
+        }
+    }
+};
+}
+
 // Implementation of the series_is_rebindable tt.
 inline namespace impl
 {
@@ -475,6 +539,23 @@ struct binary_series_op_return_type<S1, S2, N,
     using type = series_rebind<S2, bsom_cf_op_t<S2, S1, N>>;
     static const unsigned value = 7u;
 };
+
+// Check if, in a binary operation between two series with the same recursion index in which S2 must be promoted
+// (cases 1 and 3), the terms of S2 can be converted one by one to the terms of the common type.
+template <typename S1, typename S2, int N, typename = void>
+struct bso_term_convertible {
+    static const bool value = false;
+};
+
+template <typename S1, typename S2, int N>
+struct bso_term_convertible<S1, S2, N,
+                            typename std::enable_if<binary_series_op_return_type<S1, S2, N>::value == 1u
+                                                    || binary_series_op_return_type<S1, S2, N>::value == 3u>::type> {
+    using ret_type = typename binary_series_op_return_type<S1, S2, N>::type;
+    static const bool value
+        = has_convert_to<typename ret_type::term_type::cf_type, typename S2::term_type::cf_type>::value
+          && key_is_convertible<typename ret_type::term_type::key_type, typename S2::term_type::key_type>::value;
+};
 }
 
 /// Series operators.
@@ -523,6 +604,9 @@ struct binary_series_op_return_type<S1, S2, N,
  * - in case two series arguments have different symbol sets, either one or both series will be copied in a new series
  * in which the symbols
  *   have been merged, and the operation will be performed on those series instead;
+ * - in additions and subtractions between series with the same recursion index, the terms of an operand which needs
+ *   promotion are converted one at a time while being merged into the result, instead of being first copied into a
+ *   series of the common type;
  * - in-place arithmetic operators are implemented as binary operators plus move-assignment (and they are thus disabled
  * if either the corresponding
  *   binary operation or the assignment are invalid);
@@ -549,6 +633,10 @@ class series_operators
         = detail::binary_series_op_return_type<typename std::decay<T>::type, typename std::decay<U>::type, N>;
     template <typename T, typename U, int N>
     using series_common_type = typename bso_type<T, U, N>::type;
+    // Check if add/sub falls in a case in which the second operand can be converted term by term to the
+    // common type (same recursion, cases 1 and 3).
+    template <typename T, typename U, int N>
+    using mixed_op = detail::bso_term_convertible<typename std::decay<T>::type, typename std::decay<U>::type, N>;
     // Main implementation function for add/sub: all the possible cases end up here eventually, after
     // any necessary conversion.
     template <bool Sign, typename T, typename U>
@@ -588,6 +676,29 @@ class series_operators
         }
         return retval;
     }
+    // Add/sub for series with the same recursion index and different types. x is converted to the return type
+    // (if needed), while the terms of y are converted one at a time as they are merged into the return value.
+    // This way we avoid building a full converted copy of y.
+    template <bool Sign, typename RetType, typename T, typename U>
+    static RetType binary_add_mixed_impl(T &&x, const U &y)
+    {
+        static_assert(!std::is_same<RetType, U>::value, "Invalid type.");
+        RetType retval(std::forward<T>(x));
+        if (likely(retval.m_symbol_set == y.m_symbol_set)) {
+            retval.template merge_converted_terms<Sign>(y);
+        } else {
+            auto merge = retval.m_symbol_set.merge(y.m_symbol_set);
+            if (merge != retval.m_symbol_set) {
+                retval = retval.merge_arguments(merge);
+            }
+            if (merge != y.m_symbol_set) {
+                retval.template merge_converted_terms<Sign>(y.merge_arguments(merge));
+            } else {
+                retval.template merge_converted_terms<Sign>(y);
+            }
+        }
+        return retval;
+    }
     // NOTE: this case has no special algorithmic requirements, the base requirements for cf and series types
     // already cover everything (including the needeed series constructors and cf arithmetic operators).
     template <typename T, typename U, typename std::enable_if<bso_type<T, U, 0>::value == 0u, int>::type = 0>
@@ -595,13 +706,24 @@ class series_operators
     {
         return binary_add_impl<true>(std::forward<T>(x), std::forward<U>(y));
     }
-    // NOTE: this covers two cases:
-    // - equal recursion, first series wins,
-    // - first higher recursion, coefficient of first series wins,
-    // In both cases we need to construct a T from y.
+    // Equal recursion, first series wins. The terms of y are converted while being merged into the result.
     template <
         typename T, typename U,
-        typename std::enable_if<(bso_type<T, U, 0>::value == 1u || bso_type<T, U, 0>::value == 4u) &&
+        typename std::enable_if<mixed_op<T, U, 0>::value && bso_type<T, U, 0>::value == 1u &&
+                                    // In order for the implementation to work, we need to be able to build T from U.
+                                    std::is_constructible<typename std::decay<T>::type,
+                                                          const typename std::decay<U>::type &>::value,
+                                int>::type
+        = 0>
+    static series_common_type<T, U, 0> dispatch_binary_add(T &&x, U &&y)
+    {
+        return binary_add_mixed_impl<true, series_common_type<T, U, 0>>(std::forward<T>(x), y);
+    }
+    // First higher recursion, coefficient of first series wins: we need to construct a T from y.
+    template <
+        typename T, typename U,
+        typename std::enable_if<(bso_type<T, U, 0>::value == 4u
+                                 || (bso_type<T, U, 0>::value == 1u && !mixed_op<T, U, 0>::value)) &&
                                     // In order for the implementation to work, we need to be able to build T from U.
                                     std::is_constructible<typename std::decay<T>::type,
                                                           const typename std::decay<U>::type &>::value,
@@ -622,9 +744,23 @@ class series_operators
     // Two cases:
     // - equal series recursion, 3rd coefficient type generated,
     // - first higher recursion, coefficient result is different from first series.
-    // In both cases we need to promote both operands to a 3rd type.
+    // In both cases we need to promote both operands to a 3rd type. In the first case, y is promoted
+    // term by term while merging.
     template <typename T, typename U,
-              typename std::enable_if<(bso_type<T, U, 0>::value == 3u || bso_type<T, U, 0>::value == 5u) &&
+              typename std::enable_if<mixed_op<T, U, 0>::value && bso_type<T, U, 0>::value == 3u &&
+                                          std::is_constructible<series_common_type<T, U, 0>,
+                                                                const typename std::decay<T>::type &>::value
+                                          && std::is_constructible<series_common_type<T, U, 0>,
+                                                                   const typename std::decay<U>::type &>::value,
+                                      int>::type
+              = 0>
+    static series_common_type<T, U, 0> dispatch_binary_add(T &&x, U &&y)
+    {
+        return binary_add_mixed_impl<true, series_common_type<T, U, 0>>(std::forward<T>(x), y);
+    }
+    template <typename T, typename U,
+              typename std::enable_if<(bso_type<T, U, 0>::value == 5u
+                                       || (bso_type<T, U, 0>::value == 3u && !mixed_op<T, U, 0>::value)) &&
                                           // In order for the implementation to work, we need to be able to build the
                                           // common type from T and U.
                                           std::is_constructible<series_common_type<T, U, 0>,
@@ -681,7 +817,18 @@ class series_operators
         return binary_add_impl<false>(std::forward<T>(x), std::forward<U>(y));
     }
     template <typename T, typename U,
-              typename std::enable_if<(bso_type<T, U, 1>::value == 1u || bso_type<T, U, 1>::value == 4u)
+              typename std::enable_if<mixed_op<T, U, 1>::value && bso_type<T, U, 1>::value == 1u
+                                          && std::is_constructible<typename std::decay<T>::type,
+                                                                   const typename std::decay<U>::type &>::value,
+                                      int>::type
+              = 0>
+    static series_common_type<T, U, 1> dispatch_binary_sub(T &&x, U &&y)
+    {
+        return binary_add_mixed_impl<false, series_common_type<T, U, 1>>(std::forward<T>(x), y);
+    }
+    template <typename T, typename U,
+              typename std::enable_if<(bso_type<T, U, 1>::value == 4u
+                                       || (bso_type<T, U, 1>::value == 1u && !mixed_op<T, U, 1>::value))
                                           && std::is_constructible<typename std::decay<T>::type,
                                                                    const typename std::decay<U>::type &>::value,
                                       int>::type
@@ -700,7 +847,20 @@ class series_operators
         return retval;
     }
     template <typename T, typename U,
-              typename std::enable_if<(bso_type<T, U, 1>::value == 3u || bso_type<T, U, 1>::value == 5u)
+              typename std::enable_if<mixed_op<T, U, 1>::value && bso_type<T, U, 1>::value == 3u
+                                          && std::is_constructible<series_common_type<T, U, 1>,
+                                                                   const typename std::decay<T>::type &>::value
+                                          && std::is_constructible<series_common_type<T, U, 1>,
+                                                                   const typename std::decay<U>::type &>::value,
+                                      int>::type
+              = 0>
+    static series_common_type<T, U, 1> dispatch_binary_sub(T &&x, U &&y)
+    {
+        return binary_add_mixed_impl<false, series_common_type<T, U, 1>>(std::forward<T>(x), y);
+    }
+    template <typename T, typename U,
+              typename std::enable_if<(bso_type<T, U, 1>::value == 5u
+                                       || (bso_type<T, U, 1>::value == 3u && !mixed_op<T, U, 1>::value))
                                           && std::is_constructible<series_common_type<T, U, 1>,
                                                                    const typename std::decay<T>::type &>::value
                                           && std::is_constructible<series_common_type<T, U, 1>,
@@ -741,8 +901,23 @@ class series_operators
     template <typename T, typename U>
     static series_common_type<T, U, 2> binary_mul_impl(T &&x, U &&y)
     {
+        trace_scope ts("multiplication", "series");
         return series_multiplier<series_common_type<T, U, 2>>(std::forward<T>(x), std::forward<U>(y))();
     }
+    // Multiplication of series with the same recursion index and different types, in which the series multiplier
+    // of the return type (the type of x) can consume y directly, without building a converted copy of it.
+    template <typename T, typename U>
+    static T binary_mul_mixed_impl(const T &x, const U &y)
+    {
+        trace_scope ts("multiplication", "series");
+        return series_multiplier<T>(x, y)();
+    }
+    template <typename T, typename U>
+    using mixed_mul_enabled
+        = std::integral_constant<bool, bso_type<T, U, 2>::value == 1u
+                                           && std::is_constructible<series_multiplier<typename std::decay<T>::type>,
+                                                                    const typename std::decay<T>::type &,
+                                                                    const typename std::decay<U>::type &>::value>;
     template <typename T, typename U, typename std::enable_if<bso_type<T, U, 2>::value == 0u, int>::type = 0>
     static series_common_type<T, U, 2> dispatch_binary_mul(T &&x, U &&y)
     {
@@ -774,6 +949,7 @@ class series_operators
     }
     template <typename T, typename U,
               typename std::enable_if<(bso_type<T, U, 2>::value == 1u || bso_type<T, U, 2>::value == 4u)
+                                          && !mixed_mul_enabled<T, U>::value
                                           && std::is_constructible<typename std::decay<T>::type,
                                                                    const typename std::decay<U>::type &>::value,
                                       int>::type
@@ -783,6 +959,25 @@ class series_operators
         typename std::decay<T>::type y1(std::forward<U>(y));
         return dispatch_binary_mul(std::forward<T>(x), std::move(y1));
     }
+    // Equal recursion, first series wins, and the multiplier can consume y directly: only the symbol sets
+    // are harmonised, if needed, and the terms of y are converted by the multiplier.
+    template <typename T, typename U, typename std::enable_if<mixed_mul_enabled<T, U>::value, int>::type = 0>
+    static series_common_type<T, U, 2> dispatch_binary_mul(T &&x, U &&y)
+    {
+        if (likely(x.m_symbol_set == y.m_symbol_set)) {
+            return binary_mul_mixed_impl(x, y);
+        }
+        auto merge = x.m_symbol_set.merge(y.m_symbol_set);
+        if (merge != x.m_symbol_set) {
+            const auto x_copy(x.merge_arguments(merge));
+            if (merge != y.m_symbol_set) {
+                return binary_mul_mixed_impl(x_copy, y.merge_arguments(merge));
+            }
+            return binary_mul_mixed_impl(x_copy, y);
+        }
+        piranha_assert(merge != y.m_symbol_set);
+        return binary_mul_mixed_impl(x, y.merge_arguments(merge));
+    }
     template <typename T, typename U, typename std::enable_if<bso_type<T, U, 2>::value == 2u, int>::type = 0>
     static auto dispatch_binary_mul(T &&x, U &&y)
         -> decltype(dispatch_binary_mul(std::forward<U>(y), std::forward<T>(x)))
@@ -1332,23 +1527,17 @@ private:
         insertion_impl<Sign>(std::forward<T>(term));
     }
     // Cf arithmetics when inserting, normal and move variants.
+    // NOTE: rational cfs are not canonicalised while the result of a multiplication is being
+    // filled in lazy mode (see mp_rational_lazy_scope).
     template <bool Sign, typename Iterator>
     static void insertion_cf_arithmetics(Iterator &it, const term_type &term)
     {
-        if (Sign) {
-            it->m_cf += term.m_cf;
-        } else {
-            it->m_cf -= term.m_cf;
-        }
+        detail::merge_accumulator<typename term_type::cf_type>::template apply<Sign>(it->m_cf, term.m_cf);
     }
     template <bool Sign, typename Iterator>
     static void insertion_cf_arithmetics(Iterator &it, term_type &&term)
     {
-        if (Sign) {
-            it->m_cf += std::move(term.m_cf);
-        } else {
-            it->m_cf -= std::move(term.m_cf);
-        }
+        detail::merge_accumulator<typename term_type::cf_type>::template apply<Sign>(it->m_cf, std::move(term.m_cf));
     }
     // Insert compatible, non-ignorable term.
     template <bool Sign, typename T>
@@ -1517,6 +1706,26 @@ private:
         // The other series must alway be cleared, since we moved out the terms.
         s.m_container.clear();
     }
+    // Merge all terms from a series of a different type with the same recursion index and symbol set, converting
+    // them one at a time. This avoids building a converted copy of s before merging. Basic exception safety guarantee.
+    template <bool Sign, typename T>
+    void merge_converted_terms(const T &s)
+    {
+        static_assert(!std::is_base_of<series<Cf, Key, Derived>, T>::value, "Type error.");
+        typedef typename term_type::cf_type cf_type;
+        typedef typename term_type::key_type key_type;
+        piranha_assert(m_symbol_set == s.m_symbol_set);
+        const auto it_f = s.m_container.end();
+        try {
+            for (auto it = s.m_container.begin(); it != it_f; ++it) {
+                insert<Sign>(term_type(convert_to<cf_type>(it->m_cf), key_type(it->m_key, m_symbol_set)));
+            }
+        } catch (...) {
+            // In case of any insertion error, zero out this series.
+            m_container.clear();
+            throw;
+        }
+    }
     // Merge all terms from another series. Works if s is this (in which case a copy is made). Basic exception safety
     // guarantee.
     template <bool Sign, typename T>
@@ -1558,10 +1767,19 @@ private:
                                       int>::type
               = 0>
     void dispatch_generic_constructor(const T &s)
+    {
+        m_symbol_set = s.m_symbol_set;
+        convert_terms(s);
+    }
+    // Copy into this the terms of a series with the same recursion index, converting coefficients and keys.
+    template <typename T,
+              typename std::enable_if<!std::is_same<typename term_type::key_type, typename T::term_type::key_type>::value,
+                                      int>::type
+              = 0>
+    void convert_terms(const T &s)
     {
         typedef typename term_type::cf_type cf_type;
         typedef typename term_type::key_type key_type;
-        m_symbol_set = s.m_symbol_set;
         const auto it_f = s.m_container.end();
         try {
             for (auto it = s.m_container.begin(); it != it_f; ++it) {
@@ -1573,6 +1791,46 @@ private:
             throw;
         }
     }
+    // If the key type is the same, the hash of a converted term is the same as the hash of the original one. We can
+    // then build a table with the same size and hash mixing as the table of s, and place each converted term
+    // directly in the bucket of the original one, without any lookup or rehashing.
+    template <typename T,
+              typename std::enable_if<std::is_same<typename term_type::key_type, typename T::term_type::key_type>::value,
+                                      int>::type
+              = 0>
+    void convert_terms(const T &s)
+    {
+        typedef typename term_type::cf_type cf_type;
+        typedef typename term_type::key_type key_type;
+        piranha_assert(empty());
+        const auto s_h = s.m_container.hash_function();
+        typename container_type::hasher h;
+        h.m_mult = s_h.m_mult;
+        h.m_fold = s_h.m_fold;
+        m_container = container_type(s.m_container.bucket_count(), h);
+        piranha_assert(m_container.bucket_count() == s.m_container.bucket_count());
+        size_type count = 0u;
+        try {
+            for (size_type i = 0u; i < s.m_container.bucket_count(); ++i) {
+                for (const auto &t : s.m_container._get_bucket_list(i)) {
+                    term_type tmp(convert_to<cf_type>(t.m_cf), key_type(t.m_key, m_symbol_set));
+                    // NOTE: the conversion might produce ignorable terms (e.g., when converting
+                    // to a coefficient type with less precision).
+                    if (unlikely(tmp.is_ignorable(m_symbol_set))) {
+                        continue;
+                    }
+                    m_container._unique_insert(std::move(tmp), i);
+                    // NOTE: this cannot overflow, as count is bounded by the size of s.
+                    ++count;
+                }
+            }
+        } catch (...) {
+            m_container._update_size(count);
+            m_container.clear();
+            throw;
+        }
+        m_container._update_size(count);
+    }
     // NOTE: here we need to make sure that the generic ctor cannot be preferred over the copy constructor,
     // otherwise we pay a performance penalty. We need to make sure of the following things:
     // - this must *not* be a copy constructor for series - this will prevent automatically-generated copy constructors
@@ -2279,6 +2537,43 @@ public:
     {
         return m_container.evaluate_sparsity();
     }
+    /// Table zone occupancy.
+    /**
+     * Will call piranha::hash_set::evaluate_zone_occupancy() on the internal terms container
+     * and return the result.
+     *
+     * @param[in] n_zones number of zones.
+     *
+     * @return the output of piranha::hash_set::evaluate_zone_occupancy().
+     *
+     * @throws unspecified any exception thrown by piranha::hash_set::evaluate_zone_occupancy().
+     */
+    std::vector<size_type> table_zone_occupancy(const size_type &n_zones) const
+    {
+        return m_container.evaluate_zone_occupancy(n_zones);
+    }
+    /// Table zone imbalance.
+    /**
+     * The imbalance is the ratio between the number of terms in the most populated zone and the average
+     * number of terms per zone, as computed from table_zone_occupancy(). A perfectly balanced table has an imbalance
+     * of 1, a table whose terms all lie in a single zone has an imbalance equal to \p n_zones. An empty series has an
+     * imbalance of 0.
+     *
+     * @param[in] n_zones number of zones.
+     *
+     * @return the zone imbalance of the internal container.
+     *
+     * @throws unspecified any exception thrown by table_zone_occupancy().
+     */
+    double table_zone_imbalance(const size_type &n_zones) const
+    {
+        const auto occ = table_zone_occupancy(n_zones);
+        if (!size()) {
+            return 0.;
+        }
+        const auto max_occ = *std::max_element(occ.begin(), occ.end());
+        return static_cast<double>(max_occ) * static_cast<double>(n_zones) / static_cast<double>(size());
+    }
     /// Table load factor.
     /**
      * Will call piranha::hash_set::load_factor() on the internal terms container
@@ -154,6 +154,39 @@ public:
     {
         return thread_pool::get_binding();
     }
+    /// Set the nested parallelism policy.
+    /**
+     * This method is an alias for piranha::thread_pool::set_nested_parallelism(). It determines whether the
+     * parallel operations invoked from within the threads of the pool (e.g., the multiplications of series
+     * coefficients during the multiplication of series with series coefficients) run serially or split their work
+     * among the idle threads.
+     *
+     * The default policy is piranha::nested_parallelism::outer.
+     *
+     * @param p the desired nested parallelism policy.
+     */
+    static void set_nested_parallelism(nested_parallelism p)
+    {
+        thread_pool::set_nested_parallelism(p);
+    }
+    /// Get the nested parallelism policy.
+    /**
+     * This method is an alias for piranha::thread_pool::get_nested_parallelism().
+     *
+     * @return the active nested parallelism policy.
+     */
+    static nested_parallelism get_nested_parallelism()
+    {
+        return thread_pool::get_nested_parallelism();
+    }
+    /// Reset the nested parallelism policy.
+    /**
+     * The policy will be reset to piranha::nested_parallelism::outer.
+     */
+    static void reset_nested_parallelism()
+    {
+        thread_pool::set_nested_parallelism(nested_parallelism::outer);
+    }
     /// Get the cache line size.
     /**
      * The initial value is set to the output of piranha::runtime_info::get_cache_line_size(). The value
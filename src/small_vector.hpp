@@ -45,6 +45,7 @@ see https://www.gnu.org/licenses/. */
 #include "config.hpp"
 #include "detail/small_vector_fwd.hpp"
 #include "detail/vector_hasher.hpp"
+#include "detail/vector_kernels.hpp"
 #include "exceptions.hpp"
 #include "math.hpp"
 #include "memory.hpp"
@@ -839,21 +840,11 @@ public:
         // when using the new algorithm signature:
         // http://en.cppreference.com/w/cpp/algorithm/equal
         // Just keep it in mind for the future.
-        const unsigned mask
-            = static_cast<unsigned>(m_union.is_static()) + (static_cast<unsigned>(other.m_union.is_static()) << 1u);
-        switch (mask) {
-            case 0u:
-                return m_union.g_dy().size() == other.m_union.g_dy().size()
-                       && std::equal(m_union.g_dy().begin(), m_union.g_dy().end(), other.m_union.g_dy().begin());
-            case 1u:
-                return m_union.g_st().size() == other.m_union.g_dy().size()
-                       && std::equal(m_union.g_st().begin(), m_union.g_st().end(), other.m_union.g_dy().begin());
-            case 2u:
-                return m_union.g_dy().size() == other.m_union.g_st().size()
-                       && std::equal(m_union.g_dy().begin(), m_union.g_dy().end(), other.m_union.g_st().begin());
-        }
-        return m_union.g_st().size() == other.m_union.g_st().size()
-               && std::equal(m_union.g_st().begin(), m_union.g_st().end(), other.m_union.g_st().begin());
+        // NOTE: detail::vk_equal() falls back to std::equal() for types which are not supported by the
+        // vector kernels.
+        const auto sbe1 = size_begin_end(), sbe2 = other.size_begin_end();
+        return std::get<0u>(sbe1) == std::get<0u>(sbe2)
+               && detail::vk_equal(std::get<1u>(sbe1), std::get<1u>(sbe2), std::get<0u>(sbe1));
     }
     /// Inequality operator.
     /**
@@ -974,10 +965,7 @@ public:
         // the resize methods don't do anything if the new size is the same as the old one.
         // Thus, we are not risking of invalidating sbe1/sbe2 with this resize.
         retval.resize(std::get<0u>(sbe1));
-        auto sbe_out = retval.size_begin_end();
-        for (size_type i = 0u; i < std::get<0u>(sbe1); ++i) {
-            math::add3(*(std::get<1u>(sbe_out) + i), *(std::get<1u>(sbe1) + i), *(std::get<1u>(sbe2) + i));
-        }
+        add_impl(std::get<1u>(retval.size_begin_end()), std::get<1u>(sbe1), std::get<1u>(sbe2), std::get<0u>(sbe1));
     }
     /// Vector subtraction.
     /**
@@ -1009,10 +997,7 @@ public:
             piranha_throw(std::invalid_argument, "vector size mismatch");
         }
         retval.resize(std::get<0u>(sbe1));
-        auto sbe_out = retval.size_begin_end();
-        for (size_type i = 0u; i < std::get<0u>(sbe1); ++i) {
-            math::sub3(*(std::get<1u>(sbe_out) + i), *(std::get<1u>(sbe1) + i), *(std::get<1u>(sbe2) + i));
-        }
+        sub_impl(std::get<1u>(retval.size_begin_end()), std::get<1u>(sbe1), std::get<1u>(sbe2), std::get<0u>(sbe1));
     }
     /// Erase element.
     /**
@@ -1060,6 +1045,32 @@ public:
     }
 
 private:
+    // Element-wise addition/subtraction. Integral types are dispatched to the SIMD kernels, which
+    // produce the same results as math::add3()/math::sub3() (i.e., wrapping around on overflow).
+    template <typename U, typename std::enable_if<detail::vk_enabled<U>::value, int>::type = 0>
+    static void add_impl(U *out, const U *a, const U *b, size_type n)
+    {
+        detail::vk_add(out, a, b, n);
+    }
+    template <typename U, typename std::enable_if<!detail::vk_enabled<U>::value, int>::type = 0>
+    static void add_impl(U *out, const U *a, const U *b, size_type n)
+    {
+        for (size_type i = 0u; i < n; ++i) {
+            math::add3(out[i], a[i], b[i]);
+        }
+    }
+    template <typename U, typename std::enable_if<detail::vk_enabled<U>::value, int>::type = 0>
+    static void sub_impl(U *out, const U *a, const U *b, size_type n)
+    {
+        detail::vk_sub(out, a, b, n);
+    }
+    template <typename U, typename std::enable_if<!detail::vk_enabled<U>::value, int>::type = 0>
+    static void sub_impl(U *out, const U *a, const U *b, size_type n)
+    {
+        for (size_type i = 0u; i < n; ++i) {
+            math::sub3(out[i], a[i], b[i]);
+        }
+    }
     template <typename U>
     void push_back_impl(U &&x)
     {
@@ -0,0 +1,1329 @@
+/* Copyright 2009-2016 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#ifndef PIRANHA_STATIC_MONOMIAL_HPP
+#define PIRANHA_STATIC_MONOMIAL_HPP
+
+#include <algorithm>
+#include <array>
+#include <boost/functional/hash.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "config.hpp"
+#include "detail/cf_mult_impl.hpp"
+#include "detail/prepare_for_print.hpp"
+#include "detail/safe_integral_adder.hpp"
+#include "exceptions.hpp"
+#include "is_cf.hpp"
+#include "is_key.hpp"
+#include "math.hpp"
+#include "mp_integer.hpp"
+#include "mp_rational.hpp"
+#include "pow.hpp"
+#include "s11n.hpp"
+#include "safe_cast.hpp"
+#include "static_vector.hpp"
+#include "symbol.hpp"
+#include "symbol_set.hpp"
+#include "term.hpp"
+#include "type_traits.hpp"
+
+namespace piranha
+{
+
+// Fwd declaration.
+template <typename, std::size_t>
+class static_monomial;
+}
+
+// Implementation of the Boost s11n api.
+namespace boost
+{
+namespace serialization
+{
+
+template <typename Archive, typename T, std::size_t N>
+inline void save(Archive &ar, const piranha::boost_s11n_key_wrapper<piranha::static_monomial<T, N>> &k, unsigned)
+{
+    // NOTE: the exponents past the size of the symbol set are always zero, hence there is no
+    // point in distinguishing between binary and portable archives here.
+    auto tmp = k.key().unpack(k.ss());
+    piranha::boost_save(ar, tmp);
+}
+
+template <typename Archive, typename T, std::size_t N>
+inline void load(Archive &ar, piranha::boost_s11n_key_wrapper<piranha::static_monomial<T, N>> &k, unsigned)
+{
+    typename piranha::static_monomial<T, N>::v_type tmp;
+    piranha::boost_load(ar, tmp);
+    if (unlikely(tmp.size() != k.ss().size())) {
+        piranha_throw(std::invalid_argument, "invalid size detected in the deserialization of a static "
+                                             "monomial: the deserialized size is "
+                                                 + std::to_string(tmp.size())
+                                                 + " but the reference symbol set has a size of "
+                                                 + std::to_string(k.ss().size()));
+    }
+    k.key() = piranha::static_monomial<T, N>(tmp);
+}
+
+template <typename Archive, typename T, std::size_t N>
+inline void serialize(Archive &ar, piranha::boost_s11n_key_wrapper<piranha::static_monomial<T, N>> &k,
+                      unsigned version)
+{
+    split_free(ar, k, version);
+}
+}
+}
+
+namespace piranha
+{
+
+/// Static monomial class.
+/**
+ * This class represents a multivariate monomial with integral exponents and a compile-time maximum number of
+ * variables \p N. The exponents are stored in an \p std::array of size \p N, and the exponents beyond the size of the
+ * reference piranha::symbol_set are always zero. Thanks to the fixed size of the storage, the performance-critical
+ * operations (multiplication, division, hashing, comparison, degree and unitarity checks) are fully unrolled at
+ * compile time and they never need to inspect the size of the monomial. This makes piranha::static_monomial a
+ * good compromise between piranha::monomial, which has no limits on the values of the exponents but needs to store
+ * and check a runtime size, and piranha::kronecker_monomial, which is very fast but has tight limits on the
+ * exponents.
+ *
+ * This class satisfies the piranha::is_key, piranha::key_has_degree, piranha::key_has_ldegree and
+ * piranha::key_is_differentiable type traits.
+ *
+ * ## Type requirements ##
+ *
+ * \p T must be a C++ integral type different from \p bool, and \p N must be nonzero.
+ *
+ * ## Exception safety guarantee ##
+ *
+ * Unless otherwise specified, this class provides the strong exception safety guarantee for all operations.
+ *
+ * ## Move semantics ##
+ *
+ * The move semantics of this class are equivalent to the move semantics of \p std::array.
+ */
+template <typename T, std::size_t N>
+class static_monomial
+{
+    static_assert(std::is_integral<T>::value && !std::is_same<T, bool>::value,
+                  "The value type of a static monomial must be a C++ integral type.");
+    static_assert(N > 0u, "The maximum number of variables in a static monomial must be nonzero.");
+
+public:
+    /// Alias for \p T.
+    typedef T value_type;
+    /// Vector type used for temporary packing/unpacking.
+    using v_type = static_vector<value_type, N>;
+    /// Size type.
+    using size_type = typename v_type::size_type;
+    /// Maximum number of variables.
+    static const std::size_t max_size = N;
+
+private:
+#if !defined(PIRANHA_DOXYGEN_INVOKED)
+    using container_type = std::array<T, N>;
+    using idx_seq = make_index_sequence<N>;
+    // Eval and sub typedef.
+    template <typename U, typename = void>
+    struct eval_type_ {
+    };
+    template <typename U>
+    using e_type = decltype(math::pow(std::declval<U const &>(), std::declval<value_type const &>()));
+    template <typename U>
+    struct eval_type_<U, typename std::enable_if<is_multipliable_in_place<e_type<U>>::value
+                                                 && std::is_constructible<e_type<U>, int>::value
+                                                 && detail::is_pmappable<U>::value>::type> {
+        using type = e_type<U>;
+    };
+    // The final typedef.
+    template <typename U>
+    using eval_type = typename eval_type_<U>::type;
+    // Enabler for pow.
+    template <typename U>
+    using pow_enabler = typename std::
+        enable_if<has_safe_cast<T, decltype(std::declval<integer &&>() * std::declval<const U &>())>::value, int>::type;
+    // Enabler for multiply().
+    template <typename Cf>
+    using multiply_enabler = typename std::enable_if<detail::true_tt<detail::cf_mult_enabler<Cf>>::value, int>::type;
+    // Subs utilities.
+    template <typename U>
+    using subs_type__ = decltype(math::pow(std::declval<const U &>(), std::declval<const value_type &>()));
+    template <typename U, typename = void>
+    struct subs_type_ {
+    };
+    template <typename U>
+    struct subs_type_<U,
+                      typename std::enable_if<std::is_constructible<subs_type__<U>, int>::value
+                                              && std::is_assignable<subs_type__<U> &, subs_type__<U>>::value>::type> {
+        using type = subs_type__<U>;
+    };
+    template <typename U>
+    using subs_type = typename subs_type_<U>::type;
+    // ipow subs utilities.
+    template <typename U>
+    using ipow_subs_type__ = decltype(math::pow(std::declval<const U &>(), std::declval<const integer &>()));
+    template <typename U, typename = void>
+    struct ipow_subs_type_ {
+    };
+    template <typename U>
+    struct ipow_subs_type_<U, typename std::enable_if<std::is_constructible<ipow_subs_type__<U>, int>::value
+                                                      && std::is_assignable<ipow_subs_type__<U> &,
+                                                                            ipow_subs_type__<U>>::value>::type> {
+        using type = ipow_subs_type__<U>;
+    };
+    template <typename U>
+    using ipow_subs_type = typename ipow_subs_type_<U>::type;
+    // Enablers for the ctors from container, init list and iterator.
+    template <typename U>
+    using container_ctor_enabler =
+        typename std::enable_if<has_begin_end<const U>::value
+                                    && has_safe_cast<T, typename std::iterator_traits<decltype(
+                                                            std::begin(std::declval<const U &>()))>::value_type>::value,
+                                int>::type;
+    template <typename U>
+    using init_list_ctor_enabler = container_ctor_enabler<std::initializer_list<U>>;
+    template <typename Iterator>
+    using it_ctor_enabler = typename std::
+        enable_if<is_input_iterator<Iterator>::value
+                      && has_safe_cast<value_type, typename std::iterator_traits<Iterator>::value_type>::value,
+                  int>::type;
+    // Implementation of the ctor from range.
+    template <typename Iterator>
+    std::size_t construct_from_range(Iterator begin, Iterator end)
+    {
+        std::size_t i = 0u;
+        for (; begin != end; ++begin, ++i) {
+            if (unlikely(i == N)) {
+                piranha_throw(std::invalid_argument, "the number of exponents exceeds the maximum size of the "
+                                                     "static monomial ("
+                                                         + std::to_string(N) + ")");
+            }
+            m_array[i] = safe_cast<value_type>(*begin);
+        }
+        return i;
+    }
+    // Degree utils.
+    using degree_type = decltype(std::declval<const T &>() + std::declval<const T &>());
+    // Unrolled implementations of the basic operations. They always act on all the N
+    // exponents, relying on the fact that the exponents past the size of the symbol set are zero.
+    template <std::size_t... Is>
+    static void add_impl(container_type &res, const container_type &a, const container_type &b, index_sequence<Is...>)
+    {
+        (void)std::initializer_list<int>{0, (void(res[Is] = static_cast<T>(a[Is] + b[Is])), 0)...};
+    }
+    template <std::size_t... Is>
+    static void sub_impl(container_type &res, const container_type &a, const container_type &b, index_sequence<Is...>)
+    {
+        (void)std::initializer_list<int>{0, (void(res[Is] = static_cast<T>(a[Is] - b[Is])), 0)...};
+    }
+    template <std::size_t... Is>
+    static bool equal_impl(const container_type &a, const container_type &b, index_sequence<Is...>)
+    {
+        // NOTE: accumulate the differences in a branchless fashion.
+        using u_type = typename std::make_unsigned<T>::type;
+        u_type acc(0);
+        (void)std::initializer_list<int>{
+            0, (void(acc = static_cast<u_type>(acc | (static_cast<u_type>(a[Is]) ^ static_cast<u_type>(b[Is])))),
+                0)...};
+        return acc == u_type(0);
+    }
+    template <std::size_t... Is>
+    static bool is_zero_impl(const container_type &a, index_sequence<Is...>)
+    {
+        using u_type = typename std::make_unsigned<T>::type;
+        u_type acc(0);
+        (void)std::initializer_list<int>{0, (void(acc = static_cast<u_type>(acc | static_cast<u_type>(a[Is]))), 0)...};
+        return acc == u_type(0);
+    }
+    template <std::size_t... Is>
+    static std::size_t hash_impl(const container_type &a, index_sequence<Is...>)
+    {
+        std::hash<T> hasher;
+        std::size_t retval = hasher(a[0u]);
+        (void)std::initializer_list<int>{0, (Is == 0u ? 0 : (boost::hash_combine(retval, hasher(a[Is])), 0))...};
+        return retval;
+    }
+    // Degree computation. For exponent types up to 32 bits, the sum is computed in 64-bit arithmetic
+    // (which cannot overflow for any sensible value of N) and checked at the end. Otherwise, we fall
+    // back to the checked addition.
+    template <typename U = T, std::size_t... Is,
+              typename std::enable_if<(sizeof(U) <= 4u && N < (std::size_t(1) << 30u)), int>::type = 0>
+    static degree_type degree_impl(const container_type &a, index_sequence<Is...>)
+    {
+        std::int_least64_t acc(0);
+        (void)std::initializer_list<int>{0, (void(acc += static_cast<std::int_least64_t>(a[Is])), 0)...};
+        if (unlikely(acc < static_cast<std::int_least64_t>(std::numeric_limits<degree_type>::min())
+                     || acc > static_cast<std::int_least64_t>(std::numeric_limits<degree_type>::max()))) {
+            piranha_throw(std::overflow_error, "overflow in the computation of the degree of a static monomial");
+        }
+        return static_cast<degree_type>(acc);
+    }
+    template <typename U = T, std::size_t... Is,
+              typename std::enable_if<!(sizeof(U) <= 4u && N < (std::size_t(1) << 30u)), int>::type = 0>
+    static degree_type degree_impl(const container_type &a, index_sequence<Is...>)
+    {
+        degree_type retval(0);
+        (void)std::initializer_list<int>{
+            0, (detail::safe_integral_adder(retval, static_cast<degree_type>(a[Is])), 0)...};
+        return retval;
+    }
+    // Check that the size of a symbol set is compatible with the maximum size.
+    static void check_args(const symbol_set &args)
+    {
+        if (unlikely(args.size() > N)) {
+            piranha_throw(std::invalid_argument, "the size of the symbol set (" + std::to_string(args.size())
+                                                     + ") exceeds the maximum size of the static monomial ("
+                                                     + std::to_string(N) + ")");
+        }
+    }
+    // Build a monomial from an unpacked vector.
+    static static_monomial pack(const v_type &v)
+    {
+        static_monomial retval;
+        std::copy(v.begin(), v.end(), retval.m_array.begin());
+        return retval;
+    }
+#endif
+public:
+    /// Arity of the multiply() method.
+    static const std::size_t multiply_arity = 1u;
+    /// Default constructor.
+    /**
+     * After construction all exponents in the monomial will be zero.
+     */
+    static_monomial() : m_array()
+    {
+    }
+    /// Defaulted copy constructor.
+    static_monomial(const static_monomial &) = default;
+    /// Defaulted move constructor.
+    static_monomial(static_monomial &&) = default;
+    /// Constructor from container.
+    /**
+     * \note
+     * This constructor is enabled only if \p U satisfies piranha::has_begin_end, and the value type
+     * of the iterator type of \p U can be safely cast to \p T.
+     *
+     * The values in \p c are converted to \p T using piranha::safe_cast() and copied into the monomial. The
+     * remaining exponents are set to zero.
+     *
+     * @param[in] c the input container.
+     *
+     * @throws std::invalid_argument if the size of \p c is greater than \p N.
+     * @throws unspecified any exception thrown by piranha::safe_cast().
+     */
+    template <typename U, container_ctor_enabler<U> = 0>
+    explicit static_monomial(const U &c) : m_array()
+    {
+        construct_from_range(std::begin(c), std::end(c));
+    }
+    /// Constructor from initializer list.
+    /**
+     * \note
+     * This constructor is enabled only if the corresponding constructor from container is enabled.
+     *
+     * This constructor is identical to the constructor from container. It is provided for convenience.
+     *
+     * @param[in] list the input initializer list.
+     *
+     * @throws unspecified any exception thrown by the constructor from container.
+     */
+    template <typename U, init_list_ctor_enabler<U> = 0>
+    explicit static_monomial(std::initializer_list<U> list) : m_array()
+    {
+        construct_from_range(list.begin(), list.end());
+    }
+    /// Constructor from range.
+    /**
+     * \note
+     * This constructor is enabled only if \p Iterator is an input iterator whose value type
+     * is safely convertible to \p T.
+     *
+     * The values in the range are converted to \p T using piranha::safe_cast() and copied into the monomial. The
+     * remaining exponents are set to zero.
+     *
+     * @param[in] begin beginning of the range.
+     * @param[in] end end of the range.
+     *
+     * @throws std::invalid_argument if the distance between \p begin and \p end is greater than \p N.
+     * @throws unspecified any exception thrown by:
+     * - piranha::safe_cast(),
+     * - increment and dereference of the input iterators.
+     */
+    template <typename Iterator, it_ctor_enabler<Iterator> = 0>
+    explicit static_monomial(Iterator begin, Iterator end) : m_array()
+    {
+        construct_from_range(begin, end);
+    }
+    /// Constructor from range and symbol set.
+    /**
+     * \note
+     * This constructor is enabled only if the corresponding range constructor is enabled.
+     *
+     * This constructor is identical to the constructor from range. In addition, after construction
+     * it will also check that the distance between \p begin and \p end is equal to the size of \p s.
+     * This constructor is used by piranha::polynomial::find_cf().
+     *
+     * @param[in] begin beginning of the range.
+     * @param[in] end end of the range.
+     * @param[in] s reference symbol set.
+     *
+     * @throws std::invalid_argument if the distance between \p begin and \p end is different from
+     * the size of \p s.
+     * @throws unspecified any exception thrown by the constructor from range.
+     */
+    template <typename Iterator, it_ctor_enabler<Iterator> = 0>
+    explicit static_monomial(Iterator begin, Iterator end, const symbol_set &s) : m_array()
+    {
+        if (unlikely(construct_from_range(begin, end) != s.size())) {
+            piranha_throw(std::invalid_argument, "invalid static monomial");
+        }
+    }
+    /// Constructor from set of symbols.
+    /**
+     * After construction all exponents in the monomial will be zero.
+     *
+     * @param[in] args reference set of piranha::symbol.
+     *
+     * @throws std::invalid_argument if the size of \p args is greater than \p N.
+     */
+    explicit static_monomial(const symbol_set &args) : m_array()
+    {
+        check_args(args);
+    }
+    /// Converting constructor.
+    /**
+     * This constructor is for use when converting from one term type to another in piranha::series. It will
+     * copy the exponents of \p other, after having checked that \p other is compatible with \p args.
+     *
+     * @param[in] other construction argument.
+     * @param[in] args reference set of piranha::symbol.
+     *
+     * @throws std::invalid_argument if \p other is not compatible with \p args.
+     */
+    explicit static_monomial(const static_monomial &other, const symbol_set &args) : m_array(other.m_array)
+    {
+        if (unlikely(!other.is_compatible(args))) {
+            piranha_throw(std::invalid_argument, "incompatible arguments");
+        }
+    }
+    /// Trivial destructor.
+    ~static_monomial()
+    {
+        PIRANHA_TT_CHECK(is_key, static_monomial);
+        PIRANHA_TT_CHECK(key_has_degree, static_monomial);
+        PIRANHA_TT_CHECK(key_has_ldegree, static_monomial);
+        PIRANHA_TT_CHECK(key_is_differentiable, static_monomial);
+    }
+    /// Defaulted copy assignment operator.
+    static_monomial &operator=(const static_monomial &) = default;
+    /// Defaulted move assignment operator.
+    static_monomial &operator=(static_monomial &&) = default;
+    /// Begin iterator.
+    /**
+     * The range [begin(), end()) spans all the \p N exponents of the monomial, including
+     * the trailing zero exponents beyond the size of the reference symbol set.
+     *
+     * @return a pointer to the first exponent.
+     */
+    const value_type *begin() const
+    {
+        return m_array.data();
+    }
+    /// End iterator.
+    /**
+     * @return a pointer past the last exponent.
+     */
+    const value_type *end() const
+    {
+        return m_array.data() + N;
+    }
+    /// Compatibility check.
+    /**
+     * The monomial is compatible with \p args if the size of \p args is not greater than \p N
+     * and all the exponents past the size of \p args are zero.
+     *
+     * @param[in] args reference set of piranha::symbol.
+     *
+     * @return compatibility flag for the monomial.
+     */
+    bool is_compatible(const symbol_set &args) const noexcept
+    {
+        const auto s = args.size();
+        if (s > N) {
+            return false;
+        }
+        return std::all_of(m_array.begin() + static_cast<std::ptrdiff_t>(s), m_array.end(),
+                           [](const value_type &n) { return n == value_type(0); });
+    }
+    /// Ignorability check.
+    /**
+     * A monomial is never considered ignorable.
+     *
+     * @return \p false.
+     */
+    bool is_ignorable(const symbol_set &) const noexcept
+    {
+        return false;
+    }
+    /// Merge arguments.
+    /**
+     * Merge the new arguments set \p new_args into \p this, given the current reference arguments set
+     * \p orig_args.
+     *
+     * @param[in] orig_args original arguments set.
+     * @param[in] new_args new arguments set.
+     *
+     * @return monomial with merged arguments.
+     *
+     * @throws std::invalid_argument if at least one of these conditions is true:
+     * - the size of \p new_args is not greater than the size of \p orig_args,
+     * - not all elements of \p orig_args are included in \p new_args,
+     * - the size of \p new_args is greater than \p N.
+     * @throws unspecified any exception thrown by unpack().
+     */
+    static_monomial merge_args(const symbol_set &orig_args, const symbol_set &new_args) const
+    {
+        if (unlikely(new_args.size() <= orig_args.size()
+                     || !std::includes(new_args.begin(), new_args.end(), orig_args.begin(), orig_args.end()))) {
+            piranha_throw(std::invalid_argument, "invalid argument(s) for symbol set merging");
+        }
+        check_args(new_args);
+        piranha_assert(std::is_sorted(orig_args.begin(), orig_args.end()));
+        piranha_assert(std::is_sorted(new_args.begin(), new_args.end()));
+        const auto old_vector = unpack(orig_args);
+        static_monomial retval;
+        auto it_new = new_args.begin();
+        std::size_t j = 0u;
+        for (min_int<size_type, decltype(orig_args.size())> i = 0u; i < old_vector.size(); ++i, ++it_new, ++j) {
+            while (*it_new != orig_args[i]) {
+                // New argument, leave the exponent to zero.
+                piranha_assert(it_new != new_args.end());
+                ++it_new;
+                ++j;
+                piranha_assert(it_new != new_args.end());
+            }
+            retval.m_array[j] = old_vector[i];
+        }
+        return retval;
+    }
+    /// Check if monomial is unitary.
+    /**
+     * @param[in] args reference set of piranha::symbol.
+     *
+     * @return \p true if all the exponents are zero, \p false otherwise.
+     *
+     * @throws std::invalid_argument if \p this is not compatible with \p args.
+     */
+    bool is_unitary(const symbol_set &args) const
+    {
+        if (unlikely(!is_compatible(args))) {
+            piranha_throw(std::invalid_argument, "invalid symbol set");
+        }
+        return is_zero_impl(m_array, idx_seq{});
+    }
+    /// Degree.
+    /**
+     * The type returned by this method is the type resulting from the addition of two instances
+     * of \p T.
+     *
+     * @param[in] args reference set of symbols.
+     *
+     * @return degree of the monomial.
+     *
+     * @throws std::invalid_argument if \p this is not compatible with \p args.
+     * @throws std::overflow_error if the computation of the degree overflows.
+     */
+    degree_type degree(const symbol_set &args) const
+    {
+        if (unlikely(!is_compatible(args))) {
+            piranha_throw(std::invalid_argument, "invalid symbol set");
+        }
+        return degree_impl(m_array, idx_seq{});
+    }
+    /// Low degree (equivalent to the degree).
+    degree_type ldegree(const symbol_set &args) const
+    {
+        return degree(args);
+    }
+    /// Partial degree.
+    /**
+     * Partial degree of the monomial: only the symbols at the positions specified by \p p are considered.
+     * The type returned by this method is the type resulting from the addition of two instances
+     * of \p T.
+     *
+     * @param[in] p positions of the symbols to be considered in the calculation of the degree.
+     * @param[in] args reference set of piranha::symbol.
+     *
+     * @return the summation of the exponents of the monomial at the positions specified by \p p.
+     *
+     * @throws std::invalid_argument if \p p is not compatible with \p args.
+     * @throws std::overflow_error if the computation of the degree overflows.
+     * @throws unspecified any exception thrown by unpack().
+     */
+    degree_type degree(const symbol_set::positions &p, const symbol_set &args) const
+    {
+        const auto tmp = unpack(args);
+        piranha_assert(tmp.size() == args.size());
+        if (unlikely(p.size() && p.back() >= tmp.size())) {
+            piranha_throw(std::invalid_argument, "invalid positions");
+        }
+        auto cit = tmp.begin();
+        degree_type retval(0);
+        for (const auto &i : p) {
+            detail::safe_integral_adder(retval, static_cast<degree_type>(cit[i]));
+        }
+        return retval;
+    }
+    /// Partial low degree (equivalent to the partial degree).
+    degree_type ldegree(const symbol_set::positions &p, const symbol_set &args) const
+    {
+        return degree(p, args);
+    }
+    /// Multiply terms with a static monomial key.
+    /**
+     * \note
+     * This method is enabled only if \p Cf satisfies piranha::is_cf and piranha::has_mul3.
+     *
+     * Multiply \p t1 by \p t2, storing the result in the only element of \p res. This method
+     * offers the basic exception safety guarantee. If \p Cf is an instance of piranha::mp_rational, then
+     * only the numerators of the coefficients will be multiplied.
+     *
+     * The exponents of the key of the return value are computed via an unrolled addition of the exponents of the
+     * input keys. No check is performed for overflow.
+     *
+     * @param[out] res return value.
+     * @param[in] t1 first argument.
+     * @param[in] t2 second argument.
+     *
+     * @throws unspecified any exception thrown by piranha::math::mul3().
+     */
+    template <typename Cf, multiply_enabler<Cf> = 0>
+    static void multiply(std::array<term<Cf, static_monomial>, multiply_arity> &res,
+                         const term<Cf, static_monomial> &t1, const term<Cf, static_monomial> &t2,
+                         const symbol_set &)
+    {
+        auto &t = res[0u];
+        // Coefficient first.
+        detail::cf_mult_impl(t.m_cf, t1.m_cf, t2.m_cf);
+        // Now the key.
+        add_impl(t.m_key.m_array, t1.m_key.m_array, t2.m_key.m_array, idx_seq{});
+    }
+    /// Multiply static monomials.
+    /**
+     * Multiply \p a by \p b, storing the result in \p res.
+     * No check is performed for overflow.
+     *
+     * @param[out] res return value.
+     * @param[in] a first argument.
+     * @param[in] b second argument.
+     */
+    static void multiply(static_monomial &res, const static_monomial &a, const static_monomial &b,
+                         const symbol_set &)
+    {
+        add_impl(res.m_array, a.m_array, b.m_array, idx_seq{});
+    }
+    /// Divide static monomials.
+    /**
+     * Divide \p a by \p b, storing the result in \p res.
+     * No check is performed for overflow.
+     *
+     * @param[out] res return value.
+     * @param[in] a first argument.
+     * @param[in] b second argument.
+     */
+    static void divide(static_monomial &res, const static_monomial &a, const static_monomial &b, const symbol_set &)
+    {
+        sub_impl(res.m_array, a.m_array, b.m_array, idx_seq{});
+    }
+    /// Hash value.
+    /**
+     * @return the hash of the exponents, computed by mixing the hashes of all the \p N exponents
+     * via \p boost::hash_combine.
+     */
+    std::size_t hash() const
+    {
+        return hash_impl(m_array, idx_seq{});
+    }
+    /// Equality operator.
+    /**
+     * @param[in] other comparison argument.
+     *
+     * @return \p true if all the exponents of \p this are equal to the exponents of \p other,
+     * \p false otherwise.
+     */
+    bool operator==(const static_monomial &other) const
+    {
+        return equal_impl(m_array, other.m_array, idx_seq{});
+    }
+    /// Inequality operator.
+    /**
+     * @param[in] other comparison argument.
+     *
+     * @return the opposite of operator==().
+     */
+    bool operator!=(const static_monomial &other) const
+    {
+        return !(*this == other);
+    }
+    /// Name of the linear argument.
+    /**
+     * If the monomial is linear in a variable (i.e., all exponents are zero apart from a single unitary
+     * exponent), the name of the variable will be returned. Otherwise, an error will be raised.
+     *
+     * @param[in] args reference set of piranha::symbol.
+     *
+     * @return name of the linear variable.
+     *
+     * @throws std::invalid_argument if the monomial is not linear.
+     * @throws unspecified any exception thrown by unpack().
+     */
+    std::string linear_argument(const symbol_set &args) const
+    {
+        const auto v = unpack(args);
+        const auto size = args.size();
+        decltype(args.size()) n_linear = 0u, candidate = 0u;
+        for (typename v_type::size_type i = 0u; i < size; ++i) {
+            integer tmp = safe_cast<integer>(v[i]);
+            if (tmp.sign() == 0) {
+                continue;
+            }
+            if (tmp != 1) {
+                piranha_throw(std::invalid_argument, "exponent is not unitary");
+            }
+            candidate = i;
+            ++n_linear;
+        }
+        if (n_linear != 1u) {
+            piranha_throw(std::invalid_argument, "monomial is not linear");
+        }
+        return args[static_cast<decltype(args.size())>(candidate)].get_name();
+    }
+    /// Exponentiation.
+    /**
+     * \note
+     * This method is enabled only if \p U is multipliable by piranha::integer and the result type can be
+     * safely cast back to \p T.
+     *
+     * Will return a monomial corresponding to \p this raised to the <tt>x</tt>-th power. The exponentiation
+     * is computed via the multiplication of the exponents promoted to piranha::integer by \p x. The result will
+     * be cast back to \p T via piranha::safe_cast().
+     *
+     * @param[in] x exponent.
+     * @param[in] args reference set of piranha::symbol.
+     *
+     * @return \p this to the power of \p x.
+     *
+     * @throws unspecified any exception thrown by:
+     * - unpack(),
+     * - piranha::safe_cast(),
+     * - the constructor and multiplication operator of piranha::integer.
+     */
+    template <typename U, pow_enabler<U> = 0>
+    static_monomial pow(const U &x, const symbol_set &args) const
+    {
+        auto v = unpack(args);
+        for (auto &n : v) {
+            n = safe_cast<value_type>(integer(n) * x);
+        }
+        return pack(v);
+    }
+    /// Unpack exponents.
+    /**
+     * Will copy the exponents of the monomial into a piranha::static_vector of size equal to the size of \p args.
+     *
+     * @param[in] args reference set of piranha::symbol.
+     *
+     * @return piranha::static_vector containing the first <tt>args.size()</tt> exponents of the monomial.
+     *
+     * @throws std::invalid_argument if the size of \p args is larger than \p N.
+     */
+    v_type unpack(const symbol_set &args) const
+    {
+        check_args(args);
+        piranha_assert(is_compatible(args));
+        v_type retval(static_cast<size_type>(args.size()), value_type(0));
+        std::copy(m_array.begin(), m_array.begin() + static_cast<std::ptrdiff_t>(args.size()), retval.begin());
+        return retval;
+    }
+    /// Print.
+    /**
+     * Will print to stream a human-readable representation of the monomial.
+     *
+     * @param[in] os target stream.
+     * @param[in] args reference set of piranha::symbol.
+     *
+     * @throws unspecified any exception thrown by unpack() or by streaming instances of \p value_type.
+     */
+    void print(std::ostream &os, const symbol_set &args) const
+    {
+        const auto tmp = unpack(args);
+        piranha_assert(tmp.size() == args.size());
+        const value_type zero(0), one(1);
+        bool empty_output = true;
+        for (decltype(tmp.size()) i = 0u; i < tmp.size(); ++i) {
+            if (tmp[i] != zero) {
+                if (!empty_output) {
+                    os << '*';
+                }
+                os << args[i].get_name();
+                empty_output = false;
+                if (tmp[i] != one) {
+                    os << "**" << detail::prepare_for_print(tmp[i]);
+                }
+            }
+        }
+    }
+    /// Print in TeX mode.
+    /**
+     * Will print to stream a TeX representation of the monomial.
+     *
+     * @param[in] os target stream.
+     * @param[in] args reference set of piranha::symbol.
+     *
+     * @throws unspecified any exception thrown by unpack() or by streaming instances of \p value_type.
+     */
+    void print_tex(std::ostream &os, const symbol_set &args) const
+    {
+        const auto tmp = unpack(args);
+        std::ostringstream oss_num, oss_den, *cur_oss;
+        for (decltype(tmp.size()) i = 0u; i < tmp.size(); ++i) {
+            // NOTE: go through integer in order to avoid overflow when negating.
+            integer cur_value(tmp[i]);
+            if (cur_value.sign() != 0) {
+                cur_oss = (cur_value.sign() > 0) ? std::addressof(oss_num)
+                                                 : (cur_value.negate(), std::addressof(oss_den));
+                (*cur_oss) << "{" << args[i].get_name() << "}";
+                if (cur_value != 1) {
+                    (*cur_oss) << "^{" << cur_value << "}";
+                }
+            }
+        }
+        const std::string num_str = oss_num.str(), den_str = oss_den.str();
+        if (!num_str.empty() && !den_str.empty()) {
+            os << "\\frac{" << num_str << "}{" << den_str << "}";
+        } else if (!num_str.empty() && den_str.empty()) {
+            os << num_str;
+        } else if (num_str.empty() && !den_str.empty()) {
+            os << "\\frac{1}{" << den_str << "}";
+        }
+    }
+    /// Partial derivative.
+    /**
+     * This method will return the partial derivative of \p this with respect to the symbol at the position indicated by
+     * \p p.
+     * The result is a pair consisting of the exponent associated to \p p before differentiation and the monomial itself
+     * after differentiation. If \p p is empty or if the exponent associated to it is zero,
+     * the returned pair will be <tt>(0,static_monomial{args})</tt>.
+     *
+     * @param[in] p position of the symbol with respect to which the differentiation will be calculated.
+     * @param[in] args reference set of piranha::symbol.
+     *
+     * @return result of the differentiation.
+     *
+     * @throws std::invalid_argument if the computation of the derivative causes a negative overflow,
+     * or if \p p is incompatible with \p args or it has a size greater than one.
+     * @throws unspecified any exception thrown by unpack().
+     */
+    std::pair<T, static_monomial> partial(const symbol_set::positions &p, const symbol_set &args) const
+    {
+        check_args(args);
+        // Cannot take derivative wrt more than one variable, and the position of that variable
+        // must be compatible with the monomial.
+        if (p.size() > 1u || (p.size() == 1u && p.back() >= args.size())) {
+            piranha_throw(std::invalid_argument, "invalid size of symbol_set::positions");
+        }
+        // Derivative wrt a variable not in the monomial: position is empty, or refers to a
+        // variable with zero exponent.
+        if (!p.size() || math::is_zero(m_array[*p.begin()])) {
+            return std::make_pair(T(0), static_monomial(args));
+        }
+        // Original exponent.
+        T n(m_array[*p.begin()]);
+        // Decrement the exponent in the monomial.
+        if (unlikely(n == std::numeric_limits<T>::min())) {
+            piranha_throw(std::invalid_argument, "negative overflow error in the calculation of the "
+                                                 "partial derivative of a monomial");
+        }
+        static_monomial retval(*this);
+        retval.m_array[*p.begin()] = static_cast<T>(n - T(1));
+        return std::make_pair(n, std::move(retval));
+    }
+    /// Integration.
+    /**
+     * Will return the antiderivative of \p this with respect to symbol \p s. The result is a pair
+     * consisting of the exponent associated to \p s increased by one and the monomial itself
+     * after integration. If \p s is not in \p args, the returned monomial will have an extra exponent
+     * set to 1 in the same position \p s would have if it were added to \p args.
+     *
+     * If the exponent corresponding to \p s is -1, an error will be produced.
+     *
+     * @param[in] s symbol with respect to which the integration will be calculated.
+     * @param[in] args reference set of piranha::symbol.
+     *
+     * @return result of the integration.
+     *
+     * @throws std::invalid_argument if the exponent associated to \p s is -1, if the value of an exponent overflows,
+     * or if the integration adds a new exponent beyond the maximum size \p N.
+     * @throws unspecified any exception thrown by:
+     * - unpack(),
+     * - piranha::math::is_zero().
+     */
+    std::pair<T, static_monomial> integrate(const symbol &s, const symbol_set &args) const
+    {
+        v_type v = unpack(args), retval;
+        if (unlikely(args.size() == N && !std::binary_search(args.begin(), args.end(), s))) {
+            piranha_throw(std::invalid_argument, "unable to perform monomial integration: the integration would "
+                                                 "exceed the maximum size of the static monomial ("
+                                                     + std::to_string(N) + ")");
+        }
+        value_type expo(0), one(1);
+        for (min_int<typename v_type::size_type, decltype(args.size())> i = 0u; i < args.size(); ++i) {
+            if (math::is_zero(expo) && s < args[i]) {
+                // If we went past the position of s in args and still we
+                // have not performed the integration, it means that we need to add
+                // a new exponent.
+                retval.push_back(one);
+                expo = one;
+            }
+            retval.push_back(v[i]);
+            if (args[i] == s) {
+                // NOTE: here using i is safe: if retval gained an extra exponent in the condition above,
+                // we are never going to land here as args[i] is at this point never going to be s.
+                if (unlikely(retval[i] == std::numeric_limits<value_type>::max())) {
+                    piranha_throw(std::invalid_argument,
+                                  "positive overflow error in the calculation of the integral of a monomial");
+                }
+                retval[i] = static_cast<value_type>(retval[i] + value_type(1));
+                if (math::is_zero(retval[i])) {
+                    piranha_throw(std::invalid_argument,
+                                  "unable to perform monomial integration: negative unitary exponent");
+                }
+                expo = retval[i];
+            }
+        }
+        // If expo is still zero, it means we need to add a new exponent at the end.
+        if (math::is_zero(expo)) {
+            retval.push_back(one);
+            expo = one;
+        }
+        return std::make_pair(expo, pack(retval));
+    }
+    /// Evaluation.
+    /**
+     * \note
+     * This method is available only if \p U satisfies the following requirements:
+     * - it can be used in piranha::symbol_set::positions_map,
+     * - it can be used in piranha::math::pow() with the monomial exponents as powers, yielding a type \p eval_type,
+     * - \p eval_type is constructible from \p int,
+     * - \p eval_type is multipliable in place.
+     *
+     * The return value will be built by iteratively applying piranha::math::pow() using the values provided
+     * by \p pmap as bases and the values in the monomial as exponents. If the size of the monomial is zero, 1 will be
+     * returned. If the positions in \p pmap do not reference
+     * only and all the exponents in the monomial, an error will be thrown.
+     *
+     * @param[in] pmap piranha::symbol_set::positions_map that will be used for substitution.
+     * @param[in] args reference set of piranha::symbol.
+     *
+     * @return the result of evaluating \p this with the values provided in \p pmap.
+     *
+     * @throws std::invalid_argument if \p pmap is not compatible with \p args.
+     * @throws unspecified any exception thrown by:
+     * - unpack(),
+     * - construction of the return type,
+     * - piranha::math::pow() or the in-place multiplication operator of the return type.
+     */
+    template <typename U>
+    eval_type<U> evaluate(const symbol_set::positions_map<U> &pmap, const symbol_set &args) const
+    {
+        using return_type = eval_type<U>;
+        if (unlikely(pmap.size() != args.size() || (pmap.size() && pmap.back().first != pmap.size() - 1u))) {
+            piranha_throw(std::invalid_argument, "invalid positions map for evaluation");
+        }
+        auto v = unpack(args);
+        return_type retval(1);
+        auto it = pmap.begin();
+        for (min_int<size_type, decltype(args.size())> i = 0u; i < args.size(); ++i, ++it) {
+            piranha_assert(it != pmap.end() && it->first == i);
+            retval *= math::pow(it->second, v[i]);
+        }
+        piranha_assert(it == pmap.end());
+        return retval;
+    }
+    /// Substitution.
+    /**
+     * \note
+     * This method is enabled only if:
+     * - \p U can be raised to the value type, yielding a type \p subs_type,
+     * - \p subs_type can be constructed from \p int and it is assignable.
+     *
+     * The algorithm is equivalent to the one implemented in piranha::monomial::subs().
+     *
+     * @param[in] s name of the symbol that will be substituted.
+     * @param[in] x quantity that will be substituted in place of \p s.
+     * @param[in] args reference set of piranha::symbol.
+     *
+     * @return the result of substituting \p x for \p s.
+     *
+     * @throws unspecified any exception thrown by:
+     * - unpack(),
+     * - construction and assignment of the return value,
+     * - piranha::math::pow().
+     */
+    template <typename U>
+    std::vector<std::pair<subs_type<U>, static_monomial>> subs(const std::string &s, const U &x,
+                                                               const symbol_set &args) const
+    {
+        using s_type = subs_type<U>;
+        std::vector<std::pair<s_type, static_monomial>> retval;
+        auto v = unpack(args);
+        s_type retval_s(1);
+        for (min_int<typename v_type::size_type, decltype(args.size())> i = 0u; i < args.size(); ++i) {
+            if (args[i].get_name() == s) {
+                retval_s = math::pow(x, v[i]);
+                v[i] = value_type(0);
+            }
+        }
+        retval.push_back(std::make_pair(std::move(retval_s), pack(v)));
+        return retval;
+    }
+    /// Substitution of integral power.
+    /**
+     * \note
+     * This method is enabled only if:
+     * - \p U can be raised to a piranha::integer power, yielding a type \p subs_type,
+     * - \p subs_type is constructible from \p int and assignable.
+     *
+     * This method works in the same way as piranha::monomial::ipow_subs().
+     *
+     * @param[in] s name of the symbol that will be substituted.
+     * @param[in] n power of \p s that will be substituted.
+     * @param[in] x quantity that will be substituted in place of \p s to the power of \p n.
+     * @param[in] args reference set of piranha::symbol.
+     *
+     * @return the result of substituting \p x for \p s to the power of \p n.
+     *
+     * @throws unspecified any exception thrown by:
+     * - unpack(),
+     * - construction and assignment of the return value,
+     * - construction of piranha::rational,
+     * - piranha::safe_cast(),
+     * - piranha::math::pow(),
+     * - the in-place subtraction operator of the exponent type.
+     */
+    template <typename U>
+    std::vector<std::pair<ipow_subs_type<U>, static_monomial>> ipow_subs(const std::string &s, const integer &n,
+                                                                         const U &x, const symbol_set &args) const
+    {
+        using s_type = ipow_subs_type<U>;
+        auto v = unpack(args);
+        s_type retval_s(1);
+        for (min_int<typename v_type::size_type, decltype(args.size())> i = 0u; i < args.size(); ++i) {
+            if (args[i].get_name() == s) {
+                const rational tmp(safe_cast<integer>(v[i]), n);
+                if (tmp >= 1) {
+                    const auto tmp_t = static_cast<integer>(tmp);
+                    retval_s = math::pow(x, tmp_t);
+                    v[i] -= tmp_t * n;
+                }
+            }
+        }
+        std::vector<std::pair<s_type, static_monomial>> retval;
+        retval.push_back(std::make_pair(std::move(retval_s), pack(v)));
+        return retval;
+    }
+    /// Identify symbols that can be trimmed.
+    /**
+     * This method is used in piranha::series::trim(). The input parameter \p candidates
+     * contains a set of symbols that are candidates for elimination. The method will remove
+     * from \p candidates those symbols whose exponent in \p this is not zero.
+     *
+     * @param[in] candidates set of candidates for elimination.
+     * @param[in] args reference arguments set.
+     *
+     * @throws unspecified any exception thrown by:
+     * - unpack(),
+     * - piranha::symbol_set::remove().
+     */
+    void trim_identify(symbol_set &candidates, const symbol_set &args) const
+    {
+        const auto tmp = unpack(args);
+        for (min_int<decltype(tmp.size()), decltype(args.size())> i = 0u; i < tmp.size(); ++i) {
+            if (!math::is_zero(tmp[i]) && std::binary_search(candidates.begin(), candidates.end(), args[i])) {
+                candidates.remove(args[i]);
+            }
+        }
+    }
+    /// Trim.
+    /**
+     * This method will return a copy of \p this with the exponents associated to the symbols
+     * in \p trim_args removed.
+     *
+     * @param[in] trim_args arguments whose exponents will be removed.
+     * @param[in] orig_args original arguments set.
+     *
+     * @return trimmed copy of \p this.
+     *
+     * @throws unspecified any exception thrown by unpack().
+     */
+    static_monomial trim(const symbol_set &trim_args, const symbol_set &orig_args) const
+    {
+        const auto tmp = unpack(orig_args);
+        static_monomial retval;
+        std::size_t j = 0u;
+        for (min_int<size_type, decltype(orig_args.size())> i = 0u; i < tmp.size(); ++i) {
+            if (!std::binary_search(trim_args.begin(), trim_args.end(), orig_args[i])) {
+                retval.m_array[j++] = tmp[i];
+            }
+        }
+        return retval;
+    }
+    /// Comparison operator.
+    /**
+     * @param[in] other comparison argument.
+     *
+     * @return \p true if the exponents of \p this lexicographically precede the exponents
+     * of \p other, \p false otherwise.
+     */
+    bool operator<(const static_monomial &other) const
+    {
+        return std::lexicographical_compare(m_array.begin(), m_array.end(), other.m_array.begin(),
+                                            other.m_array.end());
+    }
+    /// Extract the vector of exponents.
+    /**
+     * This method will write into \p out the content of \p this. If necessary, \p out will
+     * be resized to match the size of \p args.
+     *
+     * @param[out] out vector into which the exponents will be copied.
+     * @param[in] args reference set of arguments.
+     *
+     * @throws unspecified any exception thrown by:
+     * - piranha::safe_cast(),
+     * - the resizing of \p out,
+     * - unpack().
+     */
+    void extract_exponents(std::vector<value_type> &out, const symbol_set &args) const
+    {
+        using v_size_type = decltype(out.size());
+        auto tmp = unpack(args);
+        if (unlikely(out.size() != args.size())) {
+            out.resize(safe_cast<v_size_type>(args.size()));
+        }
+        std::copy(tmp.begin(), tmp.end(), out.begin());
+    }
+    /// Split.
+    /**
+     * This method will split \p this into two monomials: the second monomial will contain the exponent
+     * of the first variable in \p args, the first monomial will contain all the other exponents.
+     *
+     * @param[in] args reference arguments set.
+     *
+     * @return a pair of monomials, the second one containing the first exponent, the first one containing all the
+     * other exponents.
+     *
+     * @throws std::invalid_argument if the size of \p args is less than 2.
+     * @throws unspecified any exception thrown by unpack() or by the constructor from a range.
+     */
+    std::pair<static_monomial, static_monomial> split(const symbol_set &args) const
+    {
+        if (unlikely(args.size() < 2u)) {
+            piranha_throw(std::invalid_argument, "only monomials with 2 or more variables can be split");
+        }
+        auto tmp = unpack(args);
+        return std::make_pair(static_monomial(tmp.begin() + 1, tmp.end()),
+                              static_monomial(tmp.begin(), tmp.begin() + 1));
+    }
+    /// Detect negative exponents.
+    /**
+     * This method will return \p true if at least one exponent is less than zero, \p false otherwise.
+     *
+     * @param[in] args reference arguments set.
+     *
+     * @return \p true if at least one exponent is less than zero, \p false otherwise.
+     *
+     * @throws unspecified any exception thrown by unpack().
+     */
+    bool has_negative_exponent(const symbol_set &args) const
+    {
+        auto tmp = unpack(args);
+        return std::any_of(tmp.begin(), tmp.end(), [](const value_type &e) { return e < value_type(0); });
+    }
+
+#if defined(PIRANHA_WITH_MSGPACK)
+private:
+    // Enablers for msgpack serialization.
+    template <typename Stream>
+    using msgpack_pack_enabler
+        = enable_if_t<conjunction<is_msgpack_stream<Stream>, has_msgpack_pack<Stream, v_type>>::value, int>;
+    template <typename U>
+    using msgpack_convert_enabler = enable_if_t<has_msgpack_convert<typename U::v_type>::value, int>;
+
+public:
+    /// Serialize in msgpack format.
+    /**
+     * \note
+     * This method is activated only if \p Stream satisfies piranha::is_msgpack_stream and
+     * piranha::static_monomial::v_type satisfies piranha::has_msgpack_pack.
+     *
+     * This method will pack \p this into \p packer. The packed object is the array of the exponents
+     * corresponding to the symbols in \p s, in both the binary and the portable formats.
+     *
+     * @param[in] packer the target packer.
+     * @param[in] f the serialization format.
+     * @param[in] s reference arguments set.
+     *
+     * @throws unspecified any exception thrown by unpack() or piranha::msgpack_pack().
+     */
+    template <typename Stream, msgpack_pack_enabler<Stream> = 0>
+    void msgpack_pack(msgpack::packer<Stream> &packer, msgpack_format f, const symbol_set &s) const
+    {
+        auto tmp = unpack(s);
+        piranha::msgpack_pack(packer, tmp, f);
+    }
+    /// Deserialize from msgpack object.
+    /**
+     * \note
+     * This method is activated only if piranha::static_monomial::v_type satisfies piranha::has_msgpack_convert.
+     *
+     * This method will deserialize \p o into \p this.
+     *
+     * @param[in] o msgpack object that will be deserialized.
+     * @param[in] f serialization format.
+     * @param[in] s reference arguments set.
+     *
+     * @throws std::invalid_argument if the size of the deserialized array differs from the size of \p s.
+     * @throws unspecified any exception thrown by:
+     * - the constructor of piranha::static_monomial from a container,
+     * - piranha::msgpack_convert().
+     */
+    template <typename U = static_monomial, msgpack_convert_enabler<U> = 0>
+    void msgpack_convert(const msgpack::object &o, msgpack_format f, const symbol_set &s)
+    {
+        v_type tmp;
+        piranha::msgpack_convert(tmp, o, f);
+        if (unlikely(tmp.size() != s.size())) {
+            piranha_throw(std::invalid_argument, "incompatible symbol set in monomial serialization: the reference "
+                                                 "symbol set has a size of "
+                                                     + std::to_string(s.size())
+                                                     + ", while the monomial being deserialized has a size of "
+                                                     + std::to_string(tmp.size()));
+        }
+        *this = static_monomial(tmp);
+    }
+
+#endif
+
+private:
+    container_type m_array;
+};
+
+inline namespace impl
+{
+
+template <typename Archive, typename T, std::size_t N>
+using static_monomial_boost_save_enabler
+    = enable_if_t<has_boost_save<Archive, typename static_monomial<T, N>::v_type>::value>;
+
+template <typename Archive, typename T, std::size_t N>
+using static_monomial_boost_load_enabler
+    = enable_if_t<has_boost_load<Archive, typename static_monomial<T, N>::v_type>::value>;
+}
+
+/// Specialisation of piranha::boost_save() for piranha::static_monomial.
+/**
+ * \note
+ * This specialisation is enabled only if piranha::static_monomial::v_type satisfies piranha::has_boost_save.
+ *
+ * The monomial is unpacked and the vector of exponents is saved.
+ *
+ * @throws unspecified any exception thrown by piranha::boost_save() or piranha::static_monomial::unpack().
+ */
+template <typename Archive, typename T, std::size_t N>
+struct boost_save_impl<Archive, boost_s11n_key_wrapper<static_monomial<T, N>>,
+                       static_monomial_boost_save_enabler<Archive, T, N>>
+    : boost_save_via_boost_api<Archive, boost_s11n_key_wrapper<static_monomial<T, N>>> {
+};
+
+/// Specialisation of piranha::boost_load() for piranha::static_monomial.
+/**
+ * \note
+ * This specialisation is enabled only if piranha::static_monomial::v_type satisfies piranha::has_boost_load.
+ *
+ * @throws std::invalid_argument if the size of the serialized monomial is different from the size of the symbol set.
+ * @throws unspecified any exception thrown by:
+ * - piranha::boost_load(),
+ * - the constructor of piranha::static_monomial from a container.
+ */
+template <typename Archive, typename T, std::size_t N>
+struct boost_load_impl<Archive, boost_s11n_key_wrapper<static_monomial<T, N>>,
+                       static_monomial_boost_load_enabler<Archive, T, N>>
+    : boost_load_via_boost_api<Archive, boost_s11n_key_wrapper<static_monomial<T, N>>> {
+};
+}
+
+namespace std
+{
+
+/// Specialisation of \p std::hash for piranha::static_monomial.
+template <typename T, std::size_t N>
+struct hash<piranha::static_monomial<T, N>> {
+    /// Result type.
+    using result_type = size_t;
+    /// Argument type.
+    using argument_type = piranha::static_monomial<T, N>;
+    /// Hash operator.
+    /**
+     * @param[in] a argument whose hash value will be computed.
+     *
+     * @return hash value of \p a computed via piranha::static_monomial::hash().
+     */
+    result_type operator()(const argument_type &a) const
+    {
+        return a.hash();
+    }
+};
+}
+
+#endif
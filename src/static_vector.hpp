@@ -42,6 +42,7 @@ see https://www.gnu.org/licenses/. */
 #include "config.hpp"
 #include "detail/small_vector_fwd.hpp"
 #include "detail/vector_hasher.hpp"
+#include "detail/vector_kernels.hpp"
 #include "exceptions.hpp"
 #include "s11n.hpp"
 #include "safe_cast.hpp"
@@ -383,7 +384,7 @@ public:
      */
     bool operator==(const static_vector &other) const
     {
-        return (m_size == other.m_size && std::equal(begin(), end(), other.begin()));
+        return (m_size == other.m_size && detail::vk_equal(ptr(), other.ptr(), m_size));
     }
     /// Inequality operator.
     /**
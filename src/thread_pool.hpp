@@ -33,7 +33,10 @@ see https://www.gnu.org/licenses/. */
 #include <atomic>
 #include <boost/lexical_cast.hpp>
 #include <condition_variable>
+#include <cstddef>
 #include <cstdlib>
+#include <deque>
+#include <exception>
 #include <functional>
 #include <future>
 // See old usage of cout below.
@@ -57,19 +60,158 @@ see https://www.gnu.org/licenses/. */
 #include "mp_integer.hpp"
 #include "runtime_info.hpp"
 #include "thread_management.hpp"
+#include "tracer.hpp"
 #include "type_traits.hpp"
 
 namespace piranha
 {
 
+/// Nested parallelism policies.
+/**
+ * The policy determines how parallel operations invoked from within a task being run by piranha::thread_pool
+ * (e.g., the coefficient multiplications of a series whose coefficients are themselves series) make use of the
+ * threads in the pool.
+ *
+ * @see piranha::thread_pool::set_nested_parallelism().
+ */
+enum class nested_parallelism {
+    /// Only the outermost parallel operation is split among the threads, the nested ones run serially.
+    outer,
+    /// The nested parallel operations also split their work, via the lightweight tasks of the pool.
+    cooperative
+};
+
+class task_group;
+
 inline namespace impl
 {
 
+// Lightweight task. This is a trivial structure storing a function pointer which will be invoked with the task
+// itself as argument, plus an opaque pointer to the callable and the index range to be processed. Contrary to the
+// tasks submitted via task_queue::enqueue(), no type erasure via std::function and no memory allocation are
+// involved.
+struct light_task {
+    void (*m_func)(const light_task &);
+    void *m_data;
+    task_group *m_group;
+    std::size_t m_begin;
+    std::size_t m_end;
+};
+
+#if defined(PIRANHA_HAVE_THREAD_LOCAL)
+
+// Number of pool tasks being run by the current thread. This is nonzero in the threads of the pool while they run a
+// task, and in any other thread while it runs a lightweight task as part of task_group::wait().
+template <typename = void>
+struct thread_pool_task_depth {
+    static thread_local unsigned value;
+};
+
+template <typename T>
+thread_local unsigned thread_pool_task_depth<T>::value = 0u;
+
+#endif
+
+inline unsigned current_task_depth()
+{
+#if defined(PIRANHA_HAVE_THREAD_LOCAL)
+    return thread_pool_task_depth<>::value;
+#else
+    // NOTE: without thread-local storage, only the threads of the pool are recognised as running tasks
+    // (see thread_pool_::use_threads()).
+    return 0u;
+#endif
+}
+
+// Mark the current thread as running a pool task for the lifetime of the object.
+struct task_depth_guard {
+#if defined(PIRANHA_HAVE_THREAD_LOCAL)
+    task_depth_guard()
+    {
+        ++thread_pool_task_depth<>::value;
+    }
+    ~task_depth_guard()
+    {
+        --thread_pool_task_depth<>::value;
+    }
+#endif
+    task_depth_guard(const task_depth_guard &) = delete;
+    task_depth_guard(task_depth_guard &&) = delete;
+    task_depth_guard &operator=(const task_depth_guard &) = delete;
+    task_depth_guard &operator=(task_depth_guard &&) = delete;
+};
+
+// A slot in a work-stealing context, one per thread.
+struct ws_slot {
+    ws_slot() : m_stop(false)
+    {
+    }
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    bool m_stop;
+    // Regular tasks, consumed only by the thread owning the slot.
+    std::queue<std::function<void()>> m_tasks;
+    // Lightweight tasks. The owner pops from the back, the other threads steal from the front.
+    std::deque<light_task> m_light;
+};
+
+// Work-stealing context, shared by the threads of a pool. The context is held via shared pointer
+// by the task queues, by their threads and by the task groups, so that it outlives any thread which
+// might try to steal work from one of its slots.
+struct ws_context {
+    explicit ws_context(unsigned n) : m_slots(n), m_pending(0u), m_next(0u)
+    {
+        piranha_assert(n > 0u);
+    }
+    // Try to pop a lightweight task, starting from the slot with index idx and then
+    // moving on to the other slots. If g is not null, only the tasks belonging to the
+    // group g will be considered.
+    bool try_pop(unsigned idx, light_task &out, const task_group *g = nullptr)
+    {
+        const auto size = static_cast<unsigned>(m_slots.size());
+        for (unsigned i = 0u; i < size; ++i) {
+            auto &slot = m_slots[(idx + i) % size];
+            std::lock_guard<std::mutex> lock(slot.m_mutex);
+            auto &d = slot.m_light;
+            if (d.empty()) {
+                continue;
+            }
+            if (g == nullptr) {
+                if (i == 0u) {
+                    out = d.back();
+                    d.pop_back();
+                } else {
+                    out = d.front();
+                    d.pop_front();
+                }
+            } else {
+                const auto it = std::find_if(d.begin(), d.end(), [g](const light_task &t) { return t.m_group == g; });
+                if (it == d.end()) {
+                    continue;
+                }
+                out = *it;
+                d.erase(it);
+            }
+            --m_pending;
+            return true;
+        }
+        return false;
+    }
+    std::vector<ws_slot> m_slots;
+    // Total number of lightweight tasks sitting in the slots.
+    std::atomic<std::size_t> m_pending;
+    // Counter used to rotate the first slot receiving lightweight tasks.
+    std::atomic<unsigned> m_next;
+};
+
 // Task queue class. Inspired by:
 // https://github.com/progschj/ThreadPool
+// The thread of a task queue consumes the regular tasks enqueued in its own slot of a work-stealing
+// context and, when there are none, the lightweight tasks in any slot of the context.
 struct task_queue {
     struct runner {
-        runner(task_queue *ptr, unsigned n, bool bind) : m_ptr(ptr), m_n(n), m_bind(bind)
+        runner(const std::shared_ptr<ws_context> &ctx, unsigned idx, unsigned n, bool bind)
+            : m_ctx(ctx), m_idx(idx), m_n(n), m_bind(bind)
         {
         }
         void operator()() const
@@ -82,25 +224,44 @@ struct task_queue {
                     // NOTE: logging candidate.
                 }
             }
+            detail::trace_set_pool_thread(m_idx);
+            auto &slot = m_ctx->m_slots[m_idx];
             try {
                 while (true) {
-                    std::unique_lock<std::mutex> lock(m_ptr->m_mutex);
-                    while (!m_ptr->m_stop && m_ptr->m_tasks.empty()) {
-                        // Need to wait for something to happen only if the task
-                        // list is empty and we are not stopping.
-                        // NOTE: wait will be noexcept in C++14.
-                        m_ptr->m_cond.wait(lock);
+                    std::function<void()> task;
+                    {
+                        std::unique_lock<std::mutex> lock(slot.m_mutex);
+                        while (!slot.m_stop && slot.m_tasks.empty() && m_ctx->m_pending.load() == 0u) {
+                            // Need to wait for something to happen only if there are no tasks
+                            // and we are not stopping.
+                            // NOTE: wait will be noexcept in C++14.
+                            slot.m_cond.wait(lock);
+                        }
+                        if (!slot.m_tasks.empty()) {
+                            // NOTE: move constructor of std::function could throw, unfortunately.
+                            task = std::move(slot.m_tasks.front());
+                            slot.m_tasks.pop();
+                        } else if (slot.m_stop && m_ctx->m_pending.load() == 0u) {
+                            // If the stop flag was set, and we do not have more tasks,
+                            // just exit.
+                            break;
+                        }
+                    }
+                    if (task) {
+                        task_depth_guard tdg;
+                        trace_scope ts("task", "thread_pool");
+                        task();
+                        continue;
                     }
-                    if (m_ptr->m_stop && m_ptr->m_tasks.empty()) {
-                        // If the stop flag was set, and we do not have more tasks,
-                        // just exit.
-                        break;
+                    // No regular tasks, try to run a lightweight task. If another thread got there
+                    // first, just yield and try again.
+                    light_task lt;
+                    if (m_ctx->try_pop(m_idx, lt)) {
+                        trace_scope ts("light_task", "thread_pool");
+                        lt.m_func(lt);
+                    } else {
+                        std::this_thread::yield();
                     }
-                    // NOTE: move constructor of std::function could throw, unfortunately.
-                    std::function<void()> task(std::move(m_ptr->m_tasks.front()));
-                    m_ptr->m_tasks.pop();
-                    lock.unlock();
-                    task();
                 }
             } catch (...) {
                 // The errors we could get here are:
@@ -115,20 +276,27 @@ struct task_queue {
             // Free the MPFR caches.
             ::mpfr_free_cache();
         }
-        task_queue *m_ptr;
+        const std::shared_ptr<ws_context> m_ctx;
+        const unsigned m_idx;
         const unsigned m_n;
         const bool m_bind;
     };
 
-    task_queue(unsigned n, bool bind) : m_stop(false)
+    // Standalone task queue, with its own single-slot work-stealing context.
+    task_queue(unsigned n, bool bind) : task_queue(std::make_shared<ws_context>(1u), 0u, n, bind)
     {
+    }
+    // Task queue using the slot idx of the context ctx.
+    task_queue(const std::shared_ptr<ws_context> &ctx, unsigned idx, unsigned n, bool bind) : m_ctx(ctx), m_idx(idx)
+    {
+        piranha_assert(idx < ctx->m_slots.size());
         // NOTE: this seems to be ok wrt order of evaluation, since the ctor of runner cannot throw.
         // In general, it could happen that:
         // - new allocates,
         // - runner is constructed and throws,
         // - the memory allocated by new is not freed.
         // See the classic: http://gotw.ca/gotw/056.htm
-        m_thread.reset(new std::thread(runner{this, n, bind}));
+        m_thread.reset(new std::thread(runner{m_ctx, idx, n, bind}));
     }
     ~task_queue()
     {
@@ -186,40 +354,45 @@ struct task_queue {
         // - std::function (in m_tasks) gives the uniform type interface via type erasure.
         auto task = std::make_shared<p_task_type>(std::bind(std::forward<F>(f), std::forward<Args>(args)...));
         std::future<ret_type> res = task->get_future();
+        // The task will use the mp_integer arena active in the enqueueing thread, if any.
+        auto arena = detail::mpz_arena_current();
+        auto &slot = m_ctx->m_slots[m_idx];
         {
-            std::unique_lock<std::mutex> lock(m_mutex);
-            if (unlikely(m_stop)) {
+            std::unique_lock<std::mutex> lock(slot.m_mutex);
+            if (unlikely(slot.m_stop)) {
                 // Enqueueing is not allowed if the queue is stopped.
                 piranha_throw(std::runtime_error, "cannot enqueue task while the task queue is stopping");
             }
-            m_tasks.push([task]() { (*task)(); });
+            slot.m_tasks.push([task, arena]() {
+                detail::mpz_arena_scope scope(arena);
+                (*task)();
+            });
         }
         // NOTE: notify_one is noexcept.
-        m_cond.notify_one();
+        slot.m_cond.notify_one();
         return res;
     }
     // NOTE: we call this only from dtor, it is here in order to be able to test it.
     // So the exception handling in dtor will suffice, keep it in mind if things change.
     void stop()
     {
+        auto &slot = m_ctx->m_slots[m_idx];
         {
-            std::unique_lock<std::mutex> lock(m_mutex);
-            if (m_stop) {
+            std::unique_lock<std::mutex> lock(slot.m_mutex);
+            if (slot.m_stop) {
                 // Already stopped.
                 return;
             }
-            m_stop = true;
+            slot.m_stop = true;
         }
         // Notify the thread that queue has been stopped, wait for it
         // to consume the remaining tasks and exit.
-        m_cond.notify_one();
+        slot.m_cond.notify_one();
         m_thread->join();
     }
 
-    bool m_stop;
-    std::condition_variable m_cond;
-    std::mutex m_mutex;
-    std::queue<std::function<void()>> m_tasks;
+    const std::shared_ptr<ws_context> m_ctx;
+    const unsigned m_idx;
     std::unique_ptr<std::thread> m_thread;
 };
 
@@ -239,9 +412,11 @@ inline thread_queues_t get_initial_thread_queues()
     // Create the vector of queues.
     const unsigned candidate = runtime_info::get_hardware_concurrency(), hc = (candidate > 0u) ? candidate : 1u;
     retval.first.reserve(static_cast<decltype(retval.first.size())>(hc));
+    // The work-stealing context shared by all the queues.
+    const auto ctx = std::make_shared<ws_context>(hc);
     for (unsigned i = 0u; i < hc; ++i) {
         // NOTE: thread binding is disabled on startup.
-        retval.first.emplace_back(::new task_queue(i, false));
+        retval.first.emplace_back(::new task_queue(ctx, i, i, false));
     }
     // Generate the set of thread IDs.
     for (const auto &ptr : retval.first) {
@@ -257,6 +432,7 @@ struct thread_pool_base {
     static thread_queues_t s_queues;
     static bool s_bind;
     static std::atomic_flag s_atf;
+    static std::atomic<nested_parallelism> s_nested;
 };
 
 template <typename T>
@@ -268,10 +444,247 @@ std::atomic_flag thread_pool_base<T>::s_atf = ATOMIC_FLAG_INIT;
 template <typename T>
 bool thread_pool_base<T>::s_bind = false;
 
+template <typename T>
+std::atomic<nested_parallelism> thread_pool_base<T>::s_nested(nested_parallelism::outer);
+
 template <typename>
 void thread_pool_shutdown();
+
+// Fetch the work-stealing context of the thread pool. The returned pointer is null if the
+// pool has been shut down.
+inline std::shared_ptr<ws_context> thread_pool_ws_context()
+{
+    detail::atomic_lock_guard lock(thread_pool_base<>::s_atf);
+    const auto &queues = thread_pool_base<>::s_queues.first;
+    return queues.empty() ? std::shared_ptr<ws_context>{} : queues[0]->m_ctx;
+}
 }
 
+/// Group of lightweight tasks.
+/**
+ * This class allows to submit to piranha::thread_pool lightweight tasks operating on ranges of indices, and to wait
+ * for their completion.
+ *
+ * Contrary to piranha::thread_pool::enqueue(), the tasks are not assigned to a specific thread: they are distributed
+ * among the threads of the pool, which will steal them from each other when they run out of work. A task is
+ * represented by a trivial handle referring to a callable owned by the caller, so that no memory allocation is
+ * performed on a per-task basis. The threads calling wait() participate in the execution of the pending tasks of the
+ * group.
+ *
+ * The tasks submitted to a group will use the piranha::mp_integer_arena active in the thread that created the group,
+ * if any.
+ */
+class task_group
+{
+    // Enabler for run().
+    template <typename F>
+    using range_call_t = decltype(std::declval<F &>()(std::declval<std::size_t>(), std::declval<std::size_t>()));
+    template <typename F>
+    using run_enabler = enable_if_t<is_detected<range_call_t, F>::value, int>;
+    template <typename F>
+    static void trampoline(const light_task &t) noexcept
+    {
+        const auto g = t.m_group;
+        // Don't run anything else after the first failure.
+        if (!g->m_failed.load()) {
+            task_depth_guard tdg;
+            detail::mpz_arena_scope scope(g->m_arena);
+            try {
+                (*static_cast<F *>(t.m_data))(t.m_begin, t.m_end);
+            } catch (...) {
+                g->set_exception(std::current_exception());
+            }
+        }
+        g->task_done();
+    }
+    void set_exception(std::exception_ptr e)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_exc) {
+            m_exc = e;
+        }
+        m_failed.store(true);
+    }
+    // NOTE: the decrement and the notification are done while holding the lock, so that the waiting thread
+    // cannot destroy the group before we are done with it.
+    void task_done()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        piranha_assert(m_pending > 0u);
+        if (--m_pending == 0u) {
+            m_cond.notify_all();
+        }
+    }
+    bool done()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_pending == 0u;
+    }
+    // Wait for the completion of all tasks, helping out with the execution of the pending ones.
+    // NOTE: only the tasks of this group are picked up, so that a nested wait is never held up
+    // by an unrelated (and possibly long) task.
+    void wait_impl()
+    {
+        if (m_ctx) {
+            light_task t;
+            while (!done() && m_ctx->try_pop(0u, t, this)) {
+                trace_scope ts("light_task", "thread_pool");
+                t.m_func(t);
+            }
+        }
+        // All the tasks of the group have been picked up, wait for them to finish.
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (m_pending != 0u) {
+            m_cond.wait(lock);
+        }
+    }
+
+public:
+    /// Default constructor.
+    /**
+     * The group will submit tasks to the threads in piranha::thread_pool.
+     *
+     * @throws unspecified any exception thrown by threading primitives.
+     */
+    task_group() : m_ctx(thread_pool_ws_context()), m_arena(detail::mpz_arena_current()), m_pending(0u), m_failed(false)
+    {
+    }
+    /// Deleted copy constructor.
+    task_group(const task_group &) = delete;
+    /// Deleted move constructor.
+    task_group(task_group &&) = delete;
+    /// Deleted copy assignment.
+    task_group &operator=(const task_group &) = delete;
+    /// Deleted move assignment.
+    task_group &operator=(task_group &&) = delete;
+    /// Destructor.
+    /**
+     * The destructor will wait for the completion of all the tasks submitted to the group. Any exception stored
+     * by the tasks will be discarded.
+     */
+    ~task_group()
+    {
+        // NOTE: logging candidate.
+        try {
+            wait_impl();
+        } catch (...) {
+            std::abort();
+        }
+    }
+    /// Submit tasks.
+    /**
+     * \note
+     * This method is enabled only if <tt>f(b, e)</tt> is a valid expression, where \p b and \p e are
+     * of type \p std::size_t.
+     *
+     * This method will split the range <tt>[begin, end)</tt> into contiguous subranges of size \p grain (the
+     * last subrange might be smaller), and it will submit a task calling <tt>f(b, e)</tt> for each subrange
+     * <tt>[b, e)</tt>. The tasks refer to \p f, which hence must stay alive until wait() returns. If one of the tasks
+     * throws, the subranges whose processing has not started yet will be skipped.
+     *
+     * If the thread pool has been shut down, the tasks are run in the calling thread.
+     *
+     * @param begin start of the range.
+     * @param end end of the range.
+     * @param grain size of the subranges.
+     * @param f callable object which will be invoked on each subrange.
+     *
+     * @throws std::invalid_argument if \p grain is zero or \p begin is greater than \p end.
+     * @throws unspecified any exception thrown by threading primitives or by memory allocation errors.
+     */
+    template <typename F, run_enabler<F> = 0>
+    void run(std::size_t begin, std::size_t end, std::size_t grain, F &f)
+    {
+        if (unlikely(grain == 0u)) {
+            piranha_throw(std::invalid_argument, "the grain size must be strictly positive");
+        }
+        if (unlikely(begin > end)) {
+            piranha_throw(std::invalid_argument, "invalid range: the beginning of the range is greater than its end");
+        }
+        const std::size_t n_chunks = (end - begin) / grain + static_cast<std::size_t>((end - begin) % grain != 0u);
+        if (n_chunks == 0u) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_pending += n_chunks;
+        }
+        light_task t{&trampoline<F>, const_cast<void *>(static_cast<const void *>(std::addressof(f))), this, begin,
+                     begin};
+        // Set the range of t to the next chunk.
+        auto next_chunk = [&t, end, grain]() {
+            t.m_begin = t.m_end;
+            t.m_end = (end - t.m_begin > grain) ? t.m_begin + grain : end;
+        };
+        if (!m_ctx) {
+            for (std::size_t i = 0u; i < n_chunks; ++i) {
+                next_chunk();
+                trampoline<F>(t);
+            }
+            return;
+        }
+        std::size_t pushed = 0u;
+        try {
+            // Split the chunks among the slots of the context, as evenly as possible.
+            const auto n_slots = static_cast<std::size_t>(m_ctx->m_slots.size());
+            const auto first = static_cast<std::size_t>(m_ctx->m_next.fetch_add(1u));
+            for (std::size_t i = 0u; i < n_slots && pushed < n_chunks; ++i) {
+                const std::size_t count
+                    = n_chunks / n_slots + static_cast<std::size_t>(i < n_chunks % n_slots);
+                auto &slot = m_ctx->m_slots[(first + i) % n_slots];
+                {
+                    std::lock_guard<std::mutex> lock(slot.m_mutex);
+                    for (std::size_t j = 0u; j < count; ++j) {
+                        next_chunk();
+                        slot.m_light.push_back(t);
+                        // NOTE: the counter is updated while holding the lock, so that
+                        // it can never underflow in try_pop().
+                        ++m_ctx->m_pending;
+                        ++pushed;
+                    }
+                }
+                slot.m_cond.notify_one();
+            }
+        } catch (...) {
+            // The chunks that were not pushed will never run.
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_pending -= n_chunks - pushed;
+            if (m_pending == 0u) {
+                m_cond.notify_all();
+            }
+            throw;
+        }
+        piranha_assert(pushed == n_chunks);
+    }
+    /// Wait for the completion of the tasks.
+    /**
+     * This method will block until all the tasks submitted to the group have been completed. While waiting,
+     * the calling thread will participate in the execution of the pending lightweight tasks. If any task threw an
+     * exception, the first exception thrown will be re-thrown by this method.
+     *
+     * @throws unspecified the first exception thrown by the tasks, or any exception thrown by threading primitives.
+     */
+    void wait()
+    {
+        wait_impl();
+        if (m_exc) {
+            auto e = m_exc;
+            m_exc = nullptr;
+            m_failed.store(false);
+            std::rethrow_exception(e);
+        }
+    }
+
+private:
+    const std::shared_ptr<ws_context> m_ctx;
+    detail::mpz_arena_impl *const m_arena;
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    std::size_t m_pending;
+    std::atomic<bool> m_failed;
+    std::exception_ptr m_exc;
+};
+
 /// Static thread pool.
 /**
  * \note
@@ -283,8 +696,8 @@ void thread_pool_shutdown();
  * The number of threads created initially is equal to piranha::runtime_info::get_hardware_concurrency().
  * If the hardware concurrency cannot be determined, the size of the thread pool will be one.
  *
- * This class provides methods to enqueue arbitray tasks to the threads in the pool, query the size of the pool,
- * resize the pool and configure the thread binding policy. All methods, unless otherwise specified, are thread-safe,
+ * This class provides methods to enqueue arbitray tasks to the threads in the pool, run parallel loops, query the size
+ * of the pool, resize the pool and configure the thread binding policy. All methods, unless otherwise specified, are thread-safe,
  * and they provide the strong exception safety guarantee.
  */
 // \todo work around MSVC bug in destruction of statically allocated threads (if needed once we support MSVC), as per:
@@ -305,6 +718,11 @@ class thread_pool_ : private thread_pool_base<>
     // The return type for enqueue().
     template <typename F, typename... Args>
     using enqueue_t = decltype(std::declval<task_queue &>().enqueue(std::declval<F>(), std::declval<Args>()...));
+    // Enabler for parallel_for().
+    template <typename F>
+    using range_call_t = decltype(std::declval<F &>()(std::declval<std::size_t>(), std::declval<std::size_t>()));
+    template <typename F>
+    using parallel_for_enabler = enable_if_t<is_detected<range_call_t, F>::value, int>;
 
 public:
     /// Enqueue task.
@@ -346,6 +764,35 @@ public:
         return base::s_queues.first[static_cast<decltype(base::s_queues.first.size())>(n)]->enqueue(
             std::forward<F>(f), std::forward<Args>(args)...);
     }
+    /// Parallel for loop.
+    /**
+     * \note
+     * This method is enabled only if <tt>f(b, e)</tt> is a valid expression, where \p b and \p e are
+     * of type \p std::size_t.
+     *
+     * This method will split the range <tt>[begin, end)</tt> into contiguous subranges of size \p grain (the last
+     * subrange might be smaller), and it will call <tt>f(b, e)</tt> on each subrange <tt>[b, e)</tt>. The calls are
+     * performed concurrently by the threads in the pool and by the calling thread, via the lightweight tasks of
+     * piranha::task_group. The method returns when all the subranges have been processed.
+     *
+     * Contrary to enqueue(), this method can be safely called from a thread in the pool.
+     *
+     * @param begin start of the range.
+     * @param end end of the range.
+     * @param grain size of the subranges.
+     * @param f callable object which will be invoked on each subrange.
+     *
+     * @throws std::invalid_argument if \p grain is zero or \p begin is greater than \p end.
+     * @throws unspecified the first exception thrown by \p f, or any exception thrown by
+     * piranha::task_group::run() and piranha::task_group::wait().
+     */
+    template <typename F, parallel_for_enabler<F> = 0>
+    static void parallel_for(std::size_t begin, std::size_t end, std::size_t grain, F &&f)
+    {
+        task_group tg;
+        tg.run(begin, end, grain, f);
+        tg.wait();
+    }
     /// Size
     /**
      * @return the number of threads in the pool.
@@ -363,8 +810,11 @@ private:
         thread_queues_t new_queues;
         // Create the task queues.
         new_queues.first.reserve(static_cast<decltype(new_queues.first.size())>(new_size));
+        const auto ctx = std::make_shared<ws_context>(new_size);
+        // The processors to which the threads will be bound.
+        const auto order = bind ? runtime_info::get_cpu_binding_order() : std::vector<unsigned>{};
         for (auto i = 0u; i < new_size; ++i) {
-            new_queues.first.emplace_back(::new task_queue(i, bind));
+            new_queues.first.emplace_back(::new task_queue(ctx, i, i < order.size() ? order[i] : i, bind));
         }
         // Fill in the thread ids set.
         for (const auto &ptr : new_queues.first) {
@@ -416,7 +866,9 @@ public:
     /// Set the thread binding policy.
     /**
      * If \p flag is \p true, this method will bind each thread in the pool to a different processor/core via
-     * piranha::bind_to_proc(). If \p flag is \p false, then this method will unbind the threads in the pool from any
+     * piranha::bind_to_proc(), following the order returned by piranha::runtime_info::get_cpu_binding_order()
+     * (so that, e.g., the hardware threads of a core are used only after all the physical cores are busy).
+     * If \p flag is \p false, then this method will unbind the threads in the pool from any
      * processor/core to which they might be bound.
      *
      * The threads created at program startup are not bound to any specific processor/core. Any error raised by
@@ -452,6 +904,32 @@ public:
         detail::atomic_lock_guard lock(s_atf);
         return base::s_bind;
     }
+    /// Set the nested parallelism policy.
+    /**
+     * This method sets the policy that use_threads() applies when it is invoked from within a task run by the
+     * pool. With piranha::nested_parallelism::outer (the default), nested parallel operations run serially in the
+     * thread executing the enclosing task. With piranha::nested_parallelism::cooperative, nested parallel operations
+     * split their work as if they were invoked from outside the pool: the resulting lightweight tasks are picked up by
+     * the idle threads via work stealing, while the thread executing the enclosing task waits for them.
+     *
+     * The cooperative policy is safe only for parallel operations implemented via parallel_for() or
+     * piranha::task_group (as is the case for all the parallel algorithms in piranha): a task which
+     * enqueues another task via enqueue() and waits for its completion might deadlock.
+     *
+     * @param p the desired nested parallelism policy.
+     */
+    static void set_nested_parallelism(nested_parallelism p)
+    {
+        base::s_nested.store(p);
+    }
+    /// Get the nested parallelism policy.
+    /**
+     * @return the nested parallelism policy set by set_nested_parallelism().
+     */
+    static nested_parallelism get_nested_parallelism()
+    {
+        return base::s_nested.load();
+    }
     /// Compute number of threads to use.
     /**
      * \note
@@ -460,9 +938,10 @@ public:
      * This function computes the suggested number of threads to use, given an amount of total \p work_size units of
      * work and a minimum amount of work units per thread \p min_work_per_thread.
      *
-     * The returned value will always be 1 if the calling thread belongs to the thread pool; otherwise, a number of
-     * threads such that each thread has at least \p min_work_per_thread units of work to consume will be returned.
-     * In any case, the return value is always greater than zero.
+     * If the nested parallelism policy is piranha::nested_parallelism::outer (the default), the returned value will
+     * always be 1 if the calling thread belongs to the thread pool or if it is running a lightweight task of the pool.
+     * Otherwise, a number of threads such that each thread has at least \p min_work_per_thread units of work to consume
+     * will be returned. In any case, the return value is always greater than zero.
      *
      * @param work_size total number of work units.
      * @param min_work_per_thread minimum number of work units to be consumed by a thread in the pool.
@@ -486,8 +965,11 @@ public:
                                                      + " for minimum work per thread (it must be strictly positive)");
         }
         detail::atomic_lock_guard lock(s_atf);
-        // Don't use threads if the calling thread belongs to the pool.
-        if (base::s_queues.second.find(std::this_thread::get_id()) != base::s_queues.second.end()) {
+        // Don't use threads if the calling thread belongs to the pool or is running a task of the pool,
+        // unless the nested parallel operations are allowed to split their work.
+        if (base::s_nested.load() == nested_parallelism::outer
+            && (current_task_depth() != 0u
+                || base::s_queues.second.find(std::this_thread::get_id()) != base::s_queues.second.end())) {
             return 1u;
         }
         const auto n_threads = static_cast<unsigned>(base::s_queues.first.size());
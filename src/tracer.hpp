@@ -0,0 +1,425 @@
+/* Copyright 2009-2016 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#ifndef PIRANHA_TRACER_HPP
+#define PIRANHA_TRACER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <ios>
+#include <locale>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "config.hpp"
+#include "exceptions.hpp"
+
+namespace piranha
+{
+
+namespace detail
+{
+
+// A complete event in a trace: a named region of code, with its start time and duration in nanoseconds.
+struct trace_event {
+    const char *m_name;
+    const char *m_cat;
+    std::uint64_t m_start;
+    std::uint64_t m_dur;
+};
+
+// Maximum number of events stored in the buffer of a thread. Events recorded when the buffer is full are dropped.
+constexpr std::size_t trace_buffer_capacity()
+{
+    return std::size_t(1) << 16u;
+}
+
+// Per-thread event buffer. The events are written only by the owning thread and they can be read concurrently by
+// any other thread: the writer stores the event and then publishes it by incrementing m_size with release
+// semantics, so no locking is needed. The increment is a compare-exchange because m_size can also be reset
+// concurrently by tracer::clear().
+struct trace_buffer {
+    explicit trace_buffer(unsigned tid, const std::string &name)
+        : m_events(new trace_event[trace_buffer_capacity()]), m_size(0u), m_n_dropped(0u), m_tid(tid), m_name(name)
+    {
+    }
+    void push(const trace_event &ev)
+    {
+        auto size = m_size.load(std::memory_order_relaxed);
+        while (true) {
+            if (unlikely(size == trace_buffer_capacity())) {
+                m_n_dropped.fetch_add(1u, std::memory_order_relaxed);
+                return;
+            }
+            m_events[size] = ev;
+            // NOTE: a failure here means that the buffer was cleared after the load of the size. In such case,
+            // size now contains the new value and the event is written again at the new position. The slot
+            // written in the failed attempt is beyond the published size, so it is never read concurrently.
+            if (likely(m_size.compare_exchange_strong(size, size + 1u, std::memory_order_release,
+                                                      std::memory_order_relaxed))) {
+                return;
+            }
+        }
+    }
+    const std::unique_ptr<trace_event[]> m_events;
+    std::atomic<std::size_t> m_size;
+    std::atomic<unsigned long long> m_n_dropped;
+    const unsigned m_tid;
+    const std::string m_name;
+};
+
+template <typename = void>
+struct base_tracer {
+    static std::atomic<bool> s_enabled;
+    static std::mutex s_mutex;
+    // NOTE: the buffers are never destroyed before program exit, as the threads keep pointers to them.
+    static std::vector<std::unique_ptr<trace_buffer>> s_buffers;
+    static const std::chrono::steady_clock::time_point s_epoch;
+};
+
+template <typename T>
+std::atomic<bool> base_tracer<T>::s_enabled(false);
+
+template <typename T>
+std::mutex base_tracer<T>::s_mutex;
+
+template <typename T>
+std::vector<std::unique_ptr<trace_buffer>> base_tracer<T>::s_buffers;
+
+template <typename T>
+const std::chrono::steady_clock::time_point base_tracer<T>::s_epoch = std::chrono::steady_clock::now();
+
+#if defined(PIRANHA_HAVE_THREAD_LOCAL)
+
+// Tracing state of the current thread: the event buffer (created on first use) and the index of the thread
+// in the thread pool (-1 if the thread does not belong to the pool).
+template <typename = void>
+struct trace_thread_state {
+    static thread_local trace_buffer *s_buffer;
+    static thread_local int s_pool_idx;
+};
+
+template <typename T>
+thread_local trace_buffer *trace_thread_state<T>::s_buffer = nullptr;
+
+template <typename T>
+thread_local int trace_thread_state<T>::s_pool_idx = -1;
+
+#endif
+
+// Mark the current thread as the thread with index idx in the thread pool.
+inline void trace_set_pool_thread(unsigned idx)
+{
+#if defined(PIRANHA_HAVE_THREAD_LOCAL)
+    trace_thread_state<>::s_pool_idx = static_cast<int>(idx);
+#else
+    (void)idx;
+#endif
+}
+
+inline std::uint64_t trace_now()
+{
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - base_tracer<>::s_epoch)
+            .count());
+}
+
+// Record an event in the buffer of the current thread.
+// NOTE: without thread-local storage, the events are not recorded.
+inline void trace_record(const trace_event &ev)
+{
+#if defined(PIRANHA_HAVE_THREAD_LOCAL)
+    auto &buffer = trace_thread_state<>::s_buffer;
+    if (unlikely(buffer == nullptr)) {
+        // First event in this thread, create and register the buffer.
+        std::lock_guard<std::mutex> lock(base_tracer<>::s_mutex);
+        auto &buffers = base_tracer<>::s_buffers;
+        const auto tid = static_cast<unsigned>(buffers.size());
+        const auto pidx = trace_thread_state<>::s_pool_idx;
+        const std::string name = (pidx >= 0) ? "pool thread " + std::to_string(pidx) : "thread " + std::to_string(tid);
+        buffers.emplace_back(new trace_buffer(tid, name));
+        buffer = buffers.back().get();
+    }
+    buffer->push(ev);
+#else
+    (void)ev;
+#endif
+}
+
+// Write str as a JSON string literal.
+inline void trace_write_json_string(std::ostream &os, const char *str)
+{
+    static const char hex_digits[] = "0123456789abcdef";
+    os << '"';
+    for (; *str != '\0'; ++str) {
+        const auto c = static_cast<unsigned char>(*str);
+        if (c == '"' || c == '\\') {
+            os << '\\' << *str;
+        } else if (c < 0x20u) {
+            os << "\\u00" << hex_digits[c >> 4u] << hex_digits[c & 0xfu];
+        } else {
+            os << *str;
+        }
+    }
+    os << '"';
+}
+
+// Write a time in nanoseconds as microseconds, the unit of the Chrome trace format.
+inline void trace_write_us(std::ostream &os, std::uint64_t ns)
+{
+    const auto frac = ns % 1000u;
+    os << ns / 1000u << '.' << (frac < 100u ? (frac < 10u ? "00" : "0") : "") << frac;
+}
+}
+
+/// Timeline tracer.
+/**
+ * \note
+ * The template parameter in this class is unused: its only purpose is to prevent the instantiation
+ * of the class' methods if they are not explicitly used. Client code should always employ the
+ * piranha::tracer alias.
+ *
+ * This class allows to record a timeline of the activity of the threads in the program, and to export it in the
+ * Chrome trace event format (which can be visualised, e.g., via the <tt>chrome://tracing</tt> page of the Chrome
+ * browser or via the Perfetto UI). The timeline is made of regions of code marked via piranha::trace_scope: the
+ * tasks run by piranha::thread_pool and the main phases of series multiplication (bounds checking, estimation of
+ * the result size, rehashing, filling of the result, sanitisation and finalisation) are marked in this way.
+ *
+ * Tracing is disabled by default. When disabled, the only overhead of a marked region is the check of a flag.
+ * When enabled, each thread records events in its own buffer, without locking. Each buffer can hold up to
+ * \f$ 2^{16} \f$ events: further events are dropped (see get_n_dropped_events()). Tracing requires support for
+ * thread-local storage: if not available, no event is recorded.
+ *
+ * All the methods in this class are thread-safe. An event recorded while clear() is running is either cleared or
+ * kept, in which case it will be the first event in the buffer of its thread.
+ */
+template <typename = void>
+class tracer_ : private detail::base_tracer<>
+{
+public:
+    /// Enable or disable tracing.
+    /**
+     * @param flag \p true to enable tracing, \p false to disable it.
+     */
+    static void set_enabled(bool flag)
+    {
+        s_enabled.store(flag);
+    }
+    /// Check if tracing is enabled.
+    /**
+     * @return \p true if tracing is enabled, \p false otherwise. The default value is \p false.
+     */
+    static bool get_enabled()
+    {
+        return s_enabled.load(std::memory_order_relaxed);
+    }
+    /// Disable tracing.
+    static void reset_enabled()
+    {
+        s_enabled.store(false);
+    }
+    /// Number of recorded events.
+    /**
+     * @return the total number of events stored in the buffers of the threads.
+     */
+    static unsigned long long get_n_events()
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        unsigned long long retval = 0u;
+        for (const auto &b : s_buffers) {
+            retval += b->m_size.load(std::memory_order_acquire);
+        }
+        return retval;
+    }
+    /// Number of dropped events.
+    /**
+     * @return the total number of events that were not recorded because the buffer of the thread was full.
+     */
+    static unsigned long long get_n_dropped_events()
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        unsigned long long retval = 0u;
+        for (const auto &b : s_buffers) {
+            retval += b->m_n_dropped.load(std::memory_order_relaxed);
+        }
+        return retval;
+    }
+    /// Clear the recorded events.
+    /**
+     * This method can be called while other threads are recording events (see the class documentation).
+     */
+    static void clear()
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        for (const auto &b : s_buffers) {
+            b->m_size.store(0u, std::memory_order_release);
+            b->m_n_dropped.store(0u, std::memory_order_relaxed);
+        }
+    }
+    /// Dump the recorded events.
+    /**
+     * The events will be written to \p os as a JSON document in the Chrome trace event format. Each thread
+     * which recorded events is identified by its own \p tid, and it is named after its index in piranha::thread_pool
+     * (if it belongs to the pool).
+     *
+     * @param os the output stream.
+     *
+     * @throws unspecified any exception thrown by memory allocation errors in standard containers or by
+     * the public interface of \p std::ostream.
+     */
+    static void dump(std::ostream &os)
+    {
+        std::ostringstream oss;
+        oss.imbue(std::locale::classic());
+        oss << "{\"traceEvents\":[";
+        bool first = true;
+        auto sep = [&oss, &first]() {
+            if (!first) {
+                oss << ',';
+            }
+            oss << '\n';
+            first = false;
+        };
+        {
+            std::lock_guard<std::mutex> lock(s_mutex);
+            for (const auto &b : s_buffers) {
+                const auto size = b->m_size.load(std::memory_order_acquire);
+                if (!size) {
+                    continue;
+                }
+                sep();
+                oss << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << b->m_tid
+                    << ",\"args\":{\"name\":";
+                detail::trace_write_json_string(oss, b->m_name.c_str());
+                oss << "}}";
+                for (std::size_t i = 0u; i < size; ++i) {
+                    const auto &ev = b->m_events[i];
+                    sep();
+                    oss << "{\"name\":";
+                    detail::trace_write_json_string(oss, ev.m_name);
+                    oss << ",\"cat\":";
+                    detail::trace_write_json_string(oss, ev.m_cat);
+                    oss << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << b->m_tid << ",\"ts\":";
+                    detail::trace_write_us(oss, ev.m_start);
+                    oss << ",\"dur\":";
+                    detail::trace_write_us(oss, ev.m_dur);
+                    oss << '}';
+                }
+            }
+        }
+        oss << "\n],\"displayTimeUnit\":\"ns\"}\n";
+        os << oss.str();
+    }
+    /// Save the recorded events to file.
+    /**
+     * The events will be saved in the format described in dump().
+     *
+     * @param filename the name of the output file.
+     *
+     * @throws std::runtime_error if the file cannot be opened or written.
+     * @throws unspecified any exception thrown by dump().
+     */
+    static void save(const std::string &filename)
+    {
+        std::ofstream ofile(filename, std::ios::out | std::ios::trunc);
+        if (unlikely(!ofile.good())) {
+            piranha_throw(std::runtime_error, "file '" + filename + "' could not be opened for saving");
+        }
+        dump(ofile);
+        if (unlikely(!ofile.good())) {
+            piranha_throw(std::runtime_error, "error while writing to file '" + filename + "'");
+        }
+    }
+};
+
+/// Alias for piranha::tracer_.
+/**
+ * This is the alias through which the methods in piranha::tracer_ should be called.
+ */
+using tracer = tracer_<>;
+
+/// Traced region of code.
+/**
+ * An object of this class marks the region of code spanning its lifetime: if tracing is enabled
+ * (see piranha::tracer_) at construction time, an event will be recorded on destruction.
+ */
+class trace_scope
+{
+public:
+    /// Constructor.
+    /**
+     * @param name the name of the region.
+     * @param cat the category of the region.
+     *
+     * \note
+     * \p name and \p cat must point to null-terminated strings with static storage duration (e.g., string literals).
+     */
+    explicit trace_scope(const char *name, const char *cat) : m_name(name), m_cat(cat), m_active(tracer::get_enabled())
+    {
+        if (unlikely(m_active)) {
+            m_start = detail::trace_now();
+        }
+    }
+    /// Deleted copy constructor.
+    trace_scope(const trace_scope &) = delete;
+    /// Deleted copy assignment operator.
+    trace_scope &operator=(const trace_scope &) = delete;
+    /// Destructor.
+    /**
+     * If tracing was enabled at construction time, an event will be recorded in the buffer of the current thread.
+     * Errors are ignored.
+     */
+    ~trace_scope()
+    {
+        if (unlikely(m_active)) {
+            try {
+                const auto end = detail::trace_now();
+                detail::trace_record(detail::trace_event{m_name, m_cat, m_start, end - m_start});
+            } catch (...) {
+                // NOTE: the only possible error here is a memory allocation failure when creating the buffer.
+            }
+        }
+    }
+
+private:
+    const char *m_name;
+    const char *m_cat;
+    const bool m_active;
+    std::uint64_t m_start = 0u;
+};
+}
+
+#endif
@@ -30,7 +30,11 @@ see https://www.gnu.org/licenses/. */
 #define PIRANHA_TUNING_HPP
 
 #include <atomic>
+#include <fstream>
+#include <locale>
+#include <sstream>
 #include <stdexcept>
+#include <string>
 
 #include "config.hpp"
 #include "exceptions.hpp"
@@ -39,24 +43,67 @@ see https://www.gnu.org/licenses/. */
 namespace piranha
 {
 
+/// Hash mixing strategies.
+/**
+ * Strategies that can be used to mix the hash values of the terms stored in a series before
+ * mapping them to buckets. See piranha::tuning::get_hash_mixing().
+ */
+enum class hash_mixing {
+    /// The hash value of the term is used unchanged.
+    identity,
+    /// The hash value is multiplied by a fixed odd constant, and the high half of the product is folded onto
+    /// the low half.
+    multiply_shift,
+    /// The hash value is multiplied by an odd constant chosen at random for each series.
+    randomised
+};
+
 namespace detail
 {
 
+// Default multiplication block size. The value is chosen so that a pair of blocks of terms of the
+// operands (roughly 64 bytes per term, including the term pointers) takes about half of the L1 data cache.
+// With the common 32 KB L1 caches this gives 256, which is also the value used if the size of the cache
+// cannot be determined.
+inline unsigned long default_mult_block_size()
+{
+    static const unsigned long value = []() {
+        const auto l1 = runtime_info::get_cache_size(1u);
+        if (!l1) {
+            return 256ul;
+        }
+        unsigned long retval = 16u;
+        while (retval * 2u <= l1 / 128u && retval * 2u <= 4096u) {
+            retval *= 2u;
+        }
+        return retval;
+    }();
+    return value;
+}
+
 template <typename = int>
 struct base_tuning {
     static std::atomic<bool> s_parallel_memory_set;
     static std::atomic<unsigned long> s_mult_block_size;
     static std::atomic<unsigned long> s_estimate_threshold;
+    static std::atomic<hash_mixing> s_hash_mixing;
+    static std::atomic<bool> s_crt_multiplication;
 };
 
 template <typename T>
 std::atomic<bool> base_tuning<T>::s_parallel_memory_set(true);
 
 template <typename T>
-std::atomic<unsigned long> base_tuning<T>::s_mult_block_size(256u);
+std::atomic<unsigned long> base_tuning<T>::s_mult_block_size(0u);
 
 template <typename T>
 std::atomic<unsigned long> base_tuning<T>::s_estimate_threshold(200u);
+
+template <typename T>
+std::atomic<hash_mixing> base_tuning<T>::s_hash_mixing(hash_mixing::identity);
+
+template <typename T>
+std::atomic<bool> base_tuning<T>::s_crt_multiplication(false);
 }
 
 /// Performance tuning.
@@ -66,6 +113,20 @@ std::atomic<unsigned long> base_tuning<T>::s_estimate_threshold(200u);
  */
 class tuning : private detail::base_tuning<>
 {
+    static const char *hash_mixing_name(hash_mixing m)
+    {
+        switch (m) {
+            case hash_mixing::identity:
+                return "identity";
+            case hash_mixing::multiply_shift:
+                return "multiply_shift";
+            case hash_mixing::randomised:
+                return "randomised";
+        }
+        piranha_assert(false);
+        return "";
+    }
+
 public:
     /// Get the \p parallel_memory_set flag.
     /**
@@ -110,13 +171,25 @@ public:
      * Larger block have less overhead, but can degrade the performance of memory access. Smaller blocks can promote
      * faster memory access but can also incur in larger overhead.
      *
-     * The default value of this flag is 256.
+     * The default value of this flag is derived from the size of the L1 data cache reported by
+     * piranha::runtime_info::get_cache_size(). It is 256 for a 32 KB cache, or if the size of the cache
+     * cannot be determined.
      *
      * @return the block size used in some series multiplication routines.
      */
     static unsigned long get_multiplication_block_size()
     {
-        return s_mult_block_size.load();
+        // NOTE: the block size is constant-initialised to zero, meaning "use the default". The default is
+        // resolved here rather than during static initialisation because it requires querying the cache size
+        // from the system. The compare-exchange ensures a concurrent setter is not overwritten.
+        auto retval = s_mult_block_size.load();
+        if (unlikely(!retval)) {
+            const auto def = detail::default_mult_block_size();
+            if (s_mult_block_size.compare_exchange_strong(retval, def)) {
+                retval = def;
+            }
+        }
+        return retval;
     }
     /// Set the multiplication block size.
     /**
@@ -141,7 +214,7 @@ public:
      */
     static void reset_multiplication_block_size()
     {
-        s_mult_block_size.store(256u);
+        s_mult_block_size.store(0u);
     }
     /// Get the series estimation threshold.
     /**
@@ -180,6 +253,196 @@ public:
     {
         s_estimate_threshold.store(200u);
     }
+    /// Get the hash mixing strategy.
+    /**
+     * The terms of a series are stored in a piranha::hash_set whose bucket index is given by the low bits of the
+     * hash value of the term. For keys whose hash value is the raw packed integer (e.g., piranha::kronecker_monomial),
+     * structured inputs can cluster in a few regions of the table. This flag selects how the hash values are mixed
+     * before being mapped to buckets:
+     * - hash_mixing::identity leaves the hash values unchanged;
+     * - hash_mixing::randomised multiplies the hash values by an odd constant drawn at random for each series.
+     *   As with the identity, the low bits of the product depend only on the low bits of the hash value,
+     *   so the lengths of the bucket chains do not change. Buckets that are adjacent under the identity mapping
+     *   are however spread over the whole table, which evens out the amount of work in the zones used by the
+     *   multithreaded Kronecker multiplication;
+     * - hash_mixing::multiply_shift multiplies the hash values by a fixed odd constant and folds the high half of the
+     *   product onto the low half. All the bits of the hash value then contribute to the bucket index, which can
+     *   shorten long chains. This strategy is not additive, so the zoned multithreaded Kronecker multiplication
+     *   cannot be used and polynomial multiplication falls back to the generic multithreaded algorithm.
+     *
+     * The strategy is read when the container of a series is created, and it stays fixed for that container:
+     * changing it does not affect existing series. The default value is hash_mixing::identity.
+     *
+     * @return the current hash mixing strategy.
+     */
+    static hash_mixing get_hash_mixing()
+    {
+        return s_hash_mixing.load();
+    }
+    /// Set the hash mixing strategy.
+    /**
+     * @see piranha::tuning::get_hash_mixing() for an explanation of the meaning of this value.
+     *
+     * @param[in] m desired hash mixing strategy.
+     *
+     * @throws std::invalid_argument if \p m is not a valid piranha::hash_mixing enumerator.
+     */
+    static void set_hash_mixing(hash_mixing m)
+    {
+        if (unlikely(m != hash_mixing::identity && m != hash_mixing::multiply_shift && m != hash_mixing::randomised)) {
+            piranha_throw(std::invalid_argument, "invalid hash mixing strategy");
+        }
+        s_hash_mixing.store(m);
+    }
+    /// Reset the hash mixing strategy.
+    /**
+     * This method will reset the hash mixing strategy to hash_mixing::identity.
+     *
+     * @see piranha::tuning::get_hash_mixing() for an explanation of the meaning of this value.
+     */
+    static void reset_hash_mixing()
+    {
+        s_hash_mixing.store(hash_mixing::identity);
+    }
+    /// Get the \p crt_multiplication flag.
+    /**
+     * When this flag is \p true, the multiplication of polynomials with piranha::mp_integer coefficients and
+     * Kronecker-packed keys is performed modulo a set of word-size primes using piranha::mod_int coefficients.
+     * The exact result is then reconstructed via the Chinese remainder theorem. The number of primes is selected
+     * from an upper bound on the coefficients of the result, computed from the heights of the operands. If more
+     * primes would be needed than the available ones, the standard multiplication algorithm is used instead.
+     *
+     * This strategy is beneficial when the coefficients of the result are a few machine words wide, as the
+     * arithmetic in the inner loop of the multiplication does not involve multiprecision operations.
+     *
+     * The default value of this flag is \p false.
+     *
+     * @return current value of the \p crt_multiplication flag.
+     */
+    static bool get_crt_multiplication()
+    {
+        return s_crt_multiplication.load();
+    }
+    /// Set the \p crt_multiplication flag.
+    /**
+     * @see piranha::tuning::get_crt_multiplication() for an explanation of the meaning of this flag.
+     *
+     * @param[in] flag desired value for the \p crt_multiplication flag.
+     */
+    static void set_crt_multiplication(bool flag)
+    {
+        s_crt_multiplication.store(flag);
+    }
+    /// Reset the \p crt_multiplication flag.
+    /**
+     * This method will reset the \p crt_multiplication flag to its default value.
+     *
+     * @see piranha::tuning::get_crt_multiplication() for an explanation of the meaning of this flag.
+     */
+    static void reset_crt_multiplication()
+    {
+        s_crt_multiplication.store(false);
+    }
+    /// Save the tuning profile to file.
+    /**
+     * This method will write the current values of all the tuning parameters to the file \p filename,
+     * in a line-oriented text format in which each line contains the name of a parameter and its value.
+     * The profile can be loaded with load_profile() (e.g., automatically at startup, see piranha::init()).
+     *
+     * @param filename the name of the output file.
+     *
+     * @throws std::runtime_error if the file cannot be opened or written.
+     * @throws unspecified any exception thrown by memory allocation errors in standard containers.
+     */
+    static void save_profile(const std::string &filename)
+    {
+        std::ostringstream oss;
+        oss.imbue(std::locale::classic());
+        oss << "parallel_memory_set " << get_parallel_memory_set() << '\n';
+        oss << "multiplication_block_size " << get_multiplication_block_size() << '\n';
+        oss << "estimate_threshold " << get_estimate_threshold() << '\n';
+        oss << "hash_mixing " << hash_mixing_name(get_hash_mixing()) << '\n';
+        oss << "crt_multiplication " << get_crt_multiplication() << '\n';
+        std::ofstream ofile(filename, std::ios::out | std::ios::trunc);
+        if (unlikely(!ofile.good())) {
+            piranha_throw(std::runtime_error, "file '" + filename + "' could not be opened for saving");
+        }
+        ofile << oss.str();
+        if (unlikely(!ofile.good())) {
+            piranha_throw(std::runtime_error, "error while writing to file '" + filename + "'");
+        }
+    }
+    /// Load a tuning profile from file.
+    /**
+     * This method will set the tuning parameters listed in the file \p filename, which must have the
+     * format produced by save_profile(). The parameters not listed in the file are left unchanged.
+     * In case of errors, no parameter is modified.
+     *
+     * @param filename the name of the input file.
+     *
+     * @throws std::runtime_error if the file cannot be opened.
+     * @throws std::invalid_argument if the content of the file is not valid.
+     * @throws unspecified any exception thrown by memory allocation errors in standard containers.
+     */
+    static void load_profile(const std::string &filename)
+    {
+        std::ifstream ifile(filename);
+        if (unlikely(!ifile.good())) {
+            piranha_throw(std::runtime_error, "file '" + filename + "' could not be opened for loading");
+        }
+        auto error = [&filename](unsigned long n) {
+            piranha_throw(std::invalid_argument, "invalid content at line " + std::to_string(n)
+                                                     + " of the tuning profile '" + filename + "'");
+        };
+        // Start from the current values.
+        bool pms = get_parallel_memory_set(), crt = get_crt_multiplication();
+        unsigned long bsize = get_multiplication_block_size(), e_thr = get_estimate_threshold();
+        hash_mixing hm = get_hash_mixing();
+        std::string line;
+        unsigned long n = 0u;
+        while (std::getline(ifile, line)) {
+            ++n;
+            std::istringstream iss(line);
+            iss.imbue(std::locale::classic());
+            std::string name;
+            if (!(iss >> name)) {
+                // Skip empty lines.
+                continue;
+            }
+            bool ok;
+            if (name == "parallel_memory_set") {
+                ok = static_cast<bool>(iss >> pms);
+            } else if (name == "crt_multiplication") {
+                ok = static_cast<bool>(iss >> crt);
+            } else if (name == "multiplication_block_size") {
+                ok = (iss >> bsize) && bsize >= 16u && bsize <= 4096u;
+            } else if (name == "estimate_threshold") {
+                ok = static_cast<bool>(iss >> e_thr);
+            } else if (name == "hash_mixing") {
+                std::string value;
+                ok = static_cast<bool>(iss >> value);
+                if (value == hash_mixing_name(hash_mixing::identity)) {
+                    hm = hash_mixing::identity;
+                } else if (value == hash_mixing_name(hash_mixing::multiply_shift)) {
+                    hm = hash_mixing::multiply_shift;
+                } else if (value == hash_mixing_name(hash_mixing::randomised)) {
+                    hm = hash_mixing::randomised;
+                } else {
+                    ok = false;
+                }
+            } else {
+                ok = false;
+            }
+            if (!ok || !(iss >> std::ws).eof()) {
+                error(n);
+            }
+        }
+        set_parallel_memory_set(pms);
+        set_multiplication_block_size(bsize);
+        set_estimate_threshold(e_thr);
+        set_hash_mixing(hm);
+        set_crt_multiplication(crt);
+    }
 };
 }
 
@@ -0,0 +1,74 @@
+/* Copyright 2009-2016 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#include "../src/auto_tuner.hpp"
+
+#define BOOST_TEST_MODULE auto_tuner_test
+#include <boost/test/included/unit_test.hpp>
+
+#include <stdexcept>
+
+#include "../src/init.hpp"
+#include "../src/kronecker_monomial.hpp"
+#include "../src/math.hpp"
+#include "../src/mp_integer.hpp"
+#include "../src/polynomial.hpp"
+#include "../src/settings.hpp"
+#include "../src/tuning.hpp"
+
+using namespace piranha;
+
+BOOST_AUTO_TEST_CASE(auto_tuner_tune_test)
+{
+    init();
+    BOOST_CHECK_THROW(auto_tuner::tune(0u), std::invalid_argument);
+    BOOST_CHECK_EQUAL(tuning::get_multiplication_block_size(), detail::default_mult_block_size());
+    BOOST_CHECK_EQUAL(tuning::get_estimate_threshold(), 200u);
+    for (unsigned n = 1u; n <= 2u; ++n) {
+        settings::set_n_threads(n);
+        tuning::set_parallel_memory_set(false);
+        auto_tuner::tune(1u);
+        const auto bsize = tuning::get_multiplication_block_size();
+        BOOST_CHECK(bsize >= 16u && bsize <= 4096u);
+        BOOST_CHECK(bsize >= detail::default_mult_block_size() / 4u && bsize <= detail::default_mult_block_size() * 8u);
+        BOOST_CHECK((bsize & (bsize - 1u)) == 0u);
+        BOOST_CHECK(tuning::get_estimate_threshold() >= 5u && tuning::get_estimate_threshold() <= 1820u);
+        if (n == 1u) {
+            // The flag is not touched with a single thread.
+            BOOST_CHECK(!tuning::get_parallel_memory_set());
+        }
+        // The tuned parameters do not alter the results.
+        using p_type = polynomial<integer, k_monomial>;
+        p_type x{"x"}, y{"y"}, z{"z"};
+        BOOST_CHECK_EQUAL(math::pow(x + y + z + 1, 8) * math::pow(x + y + z + 1, 7), math::pow(x + y + z + 1, 15));
+    }
+    settings::reset_n_threads();
+    tuning::reset_parallel_memory_set();
+    tuning::reset_multiplication_block_size();
+    tuning::reset_estimate_threshold();
+}
@@ -0,0 +1,289 @@
+/* Copyright 2009-2016 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#include "benchmark.hpp"
+
+#define BOOST_TEST_MODULE benchmark_test
+#include <boost/test/included/unit_test.hpp>
+
+#include <boost/filesystem.hpp>
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include <chrono>
+#include <cstddef>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../src/init.hpp"
+#include "../src/settings.hpp"
+#include "simple_timer.hpp"
+
+using namespace piranha;
+namespace bfs = boost::filesystem;
+
+// Small raii class for creating a tmp file.
+// NOTE: this will not actually create the file, it will just create
+// a tmp file name - so on destruction we can attempt to delete the file.
+// If a name is provided, the file will have such name and it will be placed
+// in a new directory, removed on destruction.
+struct tmp_file {
+    explicit tmp_file(const std::string &name = "")
+    {
+        m_dir = bfs::temp_directory_path();
+        // Concatenate with a unique filename.
+        m_dir /= bfs::unique_path();
+        if (name.empty()) {
+            m_path = m_dir;
+        } else {
+            bfs::create_directory(m_dir);
+            m_path = m_dir / name;
+        }
+    }
+    ~tmp_file()
+    {
+        bfs::remove_all(m_dir);
+    }
+    std::string name() const
+    {
+        return m_path.string();
+    }
+    bfs::path m_dir;
+    bfs::path m_path;
+};
+
+BOOST_AUTO_TEST_CASE(benchmark_statistics_test)
+{
+    init();
+    BOOST_CHECK_THROW(benchmark_statistics("a", 1u, {}), std::invalid_argument);
+    auto r = benchmark_statistics("a", 2u, {3., 1., 2.});
+    BOOST_CHECK_EQUAL(r.m_name, "a");
+    BOOST_CHECK_EQUAL(r.m_n_threads, 2u);
+    BOOST_CHECK_EQUAL(r.m_times.size(), 3u);
+    BOOST_CHECK_EQUAL(r.m_median, 2.);
+    BOOST_CHECK_EQUAL(r.m_min, 1.);
+    BOOST_CHECK_EQUAL(r.m_mean, 2.);
+    BOOST_CHECK_EQUAL(r.m_stddev, 1.);
+    r = benchmark_statistics("b", 1u, {4., 1., 2., 3.});
+    BOOST_CHECK_EQUAL(r.m_median, 2.5);
+    BOOST_CHECK_EQUAL(r.m_min, 1.);
+    r = benchmark_statistics("c", 1u, {4.});
+    BOOST_CHECK_EQUAL(r.m_median, 4.);
+    BOOST_CHECK_EQUAL(r.m_stddev, 0.);
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_suite_test)
+{
+    benchmark_suite suite;
+    BOOST_CHECK_THROW(suite.add("a", benchmark_suite::func_type{}), std::invalid_argument);
+    unsigned n_setup = 0u, n_run = 0u;
+    suite.add("wall", [&n_run]() { ++n_run; }, [&n_setup]() { ++n_setup; });
+    BOOST_CHECK_THROW(suite.add("wall", []() {}), std::invalid_argument);
+    // A benchmark with two timed regions, each taking at least 1 ms.
+    suite.add("regions", []() {
+        for (int i = 0; i < 2; ++i) {
+            simple_timer t;
+            const auto start = std::chrono::steady_clock::now();
+            while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(1)) {
+            }
+        }
+    });
+    BOOST_CHECK((suite.names() == std::vector<std::string>{"wall", "regions"}));
+    BOOST_CHECK(benchmark_suite::matches("pearce1", ""));
+    BOOST_CHECK(benchmark_suite::matches("pearce1", "arce"));
+    BOOST_CHECK(benchmark_suite::matches("pearce1", "fateman,pearce"));
+    BOOST_CHECK(!benchmark_suite::matches("pearce1", "fateman"));
+    benchmark_options opts;
+    opts.m_repetitions = 0u;
+    BOOST_CHECK_THROW(suite.run(opts), std::invalid_argument);
+    opts.m_repetitions = 3u;
+    opts.m_warmup = 2u;
+    opts.m_threads = {1u, 2u};
+    const auto n_threads = settings::get_n_threads();
+    std::ostringstream log;
+    auto res = suite.run(opts, &log);
+    // The number of threads is restored.
+    BOOST_CHECK_EQUAL(settings::get_n_threads(), n_threads);
+    BOOST_CHECK_EQUAL(res.size(), 4u);
+    BOOST_CHECK_EQUAL(n_setup, 2u);
+    BOOST_CHECK_EQUAL(n_run, 10u);
+    BOOST_CHECK(log.str().find("regions, 2 thread(s): median") != std::string::npos);
+    for (const auto &r : res) {
+        BOOST_CHECK_EQUAL(r.m_times.size(), 3u);
+        BOOST_CHECK(r.m_min <= r.m_median);
+        if (r.m_name == "regions") {
+            BOOST_CHECK(r.m_min >= 2e-3);
+        }
+    }
+    BOOST_CHECK_EQUAL(res[0u].m_name, "wall");
+    BOOST_CHECK_EQUAL(res[0u].m_n_threads, 1u);
+    BOOST_CHECK_EQUAL(res[1u].m_n_threads, 2u);
+    BOOST_CHECK_EQUAL(res[2u].m_name, "regions");
+    // The timers are back to normal operation.
+    BOOST_CHECK(!get_simple_timer_state().m_capture);
+    BOOST_CHECK(get_simple_timer_state().m_regions.empty());
+    // Filtering.
+    opts.m_filter = "reg";
+    opts.m_threads.clear();
+    res = suite.run(opts);
+    BOOST_CHECK_EQUAL(res.size(), 1u);
+    BOOST_CHECK_EQUAL(res[0u].m_name, "regions");
+    BOOST_CHECK_EQUAL(res[0u].m_n_threads, n_threads);
+    BOOST_CHECK_EQUAL(res[0u].m_n_ops, 0u);
+    // Number of operations per run.
+    suite.add("ops", []() {}, benchmark_suite::func_type{}, 1000u);
+    opts.m_filter = "ops";
+    log.str("");
+    res = suite.run(opts, &log);
+    BOOST_CHECK_EQUAL(res.size(), 1u);
+    BOOST_CHECK_EQUAL(res[0u].m_n_ops, 1000u);
+    BOOST_CHECK(log.str().find("ns/op") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_test)
+{
+    benchmark_options opts;
+    std::vector<benchmark_result> res{benchmark_statistics("a\"b", 1u, {1., 2., 3.}),
+                                      benchmark_statistics("c", 4u, {.5})};
+    res[1u].m_counters.available[static_cast<std::size_t>(perf_counter::cycles)] = true;
+    res[1u].m_counters.values[static_cast<std::size_t>(perf_counter::cycles)] = 123u;
+    res[1u].m_n_ops = 1000u;
+    std::stringstream ss;
+    benchmark_write_json(ss, res, opts);
+    boost::property_tree::ptree pt;
+    boost::property_tree::read_json(ss, pt);
+    BOOST_CHECK_EQUAL(pt.get<unsigned>("options.repetitions"), 5u);
+    BOOST_CHECK_EQUAL(pt.get<unsigned long>("tuning.estimate_threshold"), tuning::get_estimate_threshold());
+    BOOST_CHECK_EQUAL(pt.get<bool>("settings.thread_binding"), settings::get_thread_binding());
+    BOOST_CHECK_EQUAL(pt.get_child("benchmarks").size(), 2u);
+    auto it = pt.get_child("benchmarks").begin();
+    BOOST_CHECK_EQUAL(it->second.get<std::string>("name"), "a\"b");
+    BOOST_CHECK_EQUAL(it->second.get<double>("median"), 2.);
+    BOOST_CHECK_EQUAL(it->second.get_child("times").size(), 3u);
+    BOOST_CHECK(it->second.get_child("perf_counters").empty());
+    BOOST_CHECK(!it->second.get_optional<unsigned>("n_ops"));
+    ++it;
+    BOOST_CHECK_EQUAL(it->second.get<unsigned>("n_threads"), 4u);
+    BOOST_CHECK_EQUAL(it->second.get<unsigned>("perf_counters.cycles"), 123u);
+    BOOST_CHECK_EQUAL(it->second.get<unsigned>("n_ops"), 1000u);
+    BOOST_CHECK_EQUAL(it->second.get<double>("median_ns_per_op"), 500000.);
+    // Round trip via the baseline.
+    {
+        tmp_file file;
+        {
+            std::ofstream ofile(file.name());
+            benchmark_write_json(ofile, res, opts);
+        }
+        const auto bl = benchmark_load_baseline(file.name(), {});
+        BOOST_CHECK_EQUAL(bl.size(), 2u);
+        BOOST_CHECK_EQUAL(bl[0u].m_name, "a\"b");
+        BOOST_CHECK_EQUAL(bl[0u].m_n_threads, 1u);
+        BOOST_CHECK_EQUAL(bl[0u].m_time, 2.);
+        BOOST_CHECK_EQUAL(bl[1u].m_time, .5);
+    }
+    {
+        tmp_file file;
+        {
+            std::ofstream ofile(file.name());
+            ofile << "{\"foo\": 1}";
+        }
+        BOOST_CHECK_THROW(benchmark_load_baseline(file.name(), {}), std::invalid_argument);
+    }
+    BOOST_CHECK_THROW(benchmark_load_baseline("/nonexistent_piranha_dir/foo.json", {}), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_baseline_test)
+{
+    // Legacy baseline, as produced by tools/benchmark.py.
+    {
+        tmp_file file("emma_pearce1_unpacked_perf_20150823171832.txt");
+        {
+            std::ofstream ofile(file.name());
+            ofile << "8.0e+00 4.0e+00 2.5e+00\n9.7e-02 1.9e-02 1.4e-02\n";
+        }
+        BOOST_CHECK_THROW(benchmark_load_baseline(file.name(), {"fateman1"}), std::invalid_argument);
+        const auto bl = benchmark_load_baseline(file.name(), {"pearce1", "pearce1_unpacked", "unpacked"});
+        BOOST_CHECK_EQUAL(bl.size(), 3u);
+        BOOST_CHECK_EQUAL(bl[0u].m_name, "pearce1_unpacked");
+        BOOST_CHECK_EQUAL(bl[0u].m_n_threads, 1u);
+        BOOST_CHECK_EQUAL(bl[0u].m_time, 8.);
+        BOOST_CHECK_EQUAL(bl[2u].m_n_threads, 3u);
+        BOOST_CHECK_EQUAL(bl[2u].m_time, 2.5);
+        // Comparison.
+        std::vector<benchmark_result> res{benchmark_statistics("pearce1_unpacked", 1u, {8.5}),
+                                          benchmark_statistics("pearce1_unpacked", 2u, {4.5}),
+                                          benchmark_statistics("pearce1_unpacked", 4u, {1.}),
+                                          benchmark_statistics("fateman1", 1u, {1.})};
+        BOOST_CHECK_THROW(benchmark_compare(res, bl, -1.), std::invalid_argument);
+        const auto cmp = benchmark_compare(res, bl, .1);
+        BOOST_CHECK_EQUAL(cmp.size(), 2u);
+        BOOST_CHECK(!cmp[0u].m_regression);
+        BOOST_CHECK_EQUAL(cmp[0u].m_baseline, 8.);
+        BOOST_CHECK_EQUAL(cmp[0u].m_current, 8.5);
+        BOOST_CHECK(cmp[1u].m_regression);
+        BOOST_CHECK_EQUAL(cmp[1u].m_n_threads, 2u);
+        BOOST_CHECK(!benchmark_compare(res, bl, .2)[1u].m_regression);
+    }
+    {
+        tmp_file file("foo.txt");
+        {
+            std::ofstream ofile(file.name());
+            ofile << "1.\n";
+        }
+        BOOST_CHECK_THROW(benchmark_load_baseline(file.name(), {"foo"}), std::invalid_argument);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_main_test)
+{
+    benchmark_suite suite;
+    suite.add("ok", []() {});
+    suite.add("throwing", []() { throw std::runtime_error("failure"); });
+    auto call_main = [&suite](std::vector<std::string> args) {
+        args.insert(args.begin(), {"benchmark", "--no-binding", "--warmup", "0", "--repetitions", "1"});
+        std::vector<char *> argv;
+        for (auto &arg : args) {
+            argv.push_back(&arg[0]);
+        }
+        return benchmark_main(static_cast<int>(argv.size()), argv.data(), suite);
+    };
+    BOOST_CHECK_EQUAL(call_main({"--filter", "ok"}), 0);
+    BOOST_CHECK_EQUAL(call_main({"--bogus"}), 2);
+    // Errors while running the benchmarks or loading the baseline are reported via the return value.
+    BOOST_CHECK_EQUAL(call_main({"--filter", "throwing"}), 2);
+    tmp_file file;
+    BOOST_CHECK_EQUAL(call_main({"--filter", "ok", "--baseline", file.name()}), 2);
+    {
+        std::ofstream ofile(file.name());
+        ofile << "1.\n";
+    }
+    BOOST_CHECK_EQUAL(call_main({"--filter", "ok", "--baseline", file.name()}), 2);
+    settings::set_thread_binding(false);
+}
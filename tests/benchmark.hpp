@@ -0,0 +1,681 @@
+/* Copyright 2009-2016 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#ifndef PIRANHA_BENCHMARK_HPP
+#define PIRANHA_BENCHMARK_HPP
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include <sys/resource.h>
+
+#endif
+
+#include <algorithm>
+#include <boost/lexical_cast.hpp>
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <ios>
+#include <iostream>
+#include <limits>
+#include <locale>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../src/config.hpp"
+#include "../src/exceptions.hpp"
+#include "../src/perf_counters.hpp"
+#include "../src/runtime_info.hpp"
+#include "../src/settings.hpp"
+#include "../src/tuning.hpp"
+#include "simple_timer.hpp"
+
+#define PIRANHA_BENCHMARK_STR_(x) #x
+#define PIRANHA_BENCHMARK_STR(x) PIRANHA_BENCHMARK_STR_(x)
+
+namespace piranha
+{
+
+// Options for the execution of a benchmark suite.
+struct benchmark_options {
+    benchmark_options() : m_warmup(1u), m_repetitions(5u)
+    {
+    }
+    // Only the benchmarks whose name contains one of these (comma-separated) strings will be run.
+    // An empty filter selects all the benchmarks.
+    std::string m_filter;
+    // Numbers of threads. If empty, the current number of threads in piranha::settings is used.
+    std::vector<unsigned> m_threads;
+    // Number of untimed runs before the timed ones.
+    unsigned m_warmup;
+    // Number of timed runs.
+    unsigned m_repetitions;
+};
+
+// Result of a benchmark with a specific number of threads. The times are in seconds, the peak RSS is in bytes.
+struct benchmark_result {
+    std::string m_name;
+    unsigned m_n_threads;
+    std::vector<double> m_times;
+    double m_median;
+    double m_min;
+    double m_mean;
+    double m_stddev;
+    // Peak resident set size (zero if not available). If m_peak_rss_reset is false, the peak could not be reset
+    // before running the benchmark and it refers to the whole process up to the end of the benchmark.
+    unsigned long long m_peak_rss;
+    bool m_peak_rss_reset;
+    // Hardware performance counters, averaged over the timed runs.
+    perf_counter_values m_counters;
+    // Number of operations performed in each run (zero if not applicable, e.g., for the macro benchmarks).
+    unsigned long long m_n_ops;
+};
+
+// Comparison of a result with its baseline.
+struct benchmark_comparison {
+    std::string m_name;
+    unsigned m_n_threads;
+    double m_baseline;
+    double m_current;
+    bool m_regression;
+};
+
+// Baseline timing of a benchmark.
+struct benchmark_baseline {
+    std::string m_name;
+    unsigned m_n_threads;
+    double m_time;
+};
+
+namespace detail
+{
+
+// Reset the peak RSS of the process (supported on Linux >= 4.0).
+inline bool benchmark_reset_peak_rss()
+{
+#if defined(__linux__)
+    std::ofstream f("/proc/self/clear_refs");
+    if (f.good()) {
+        f << "5";
+        f.flush();
+        return f.good();
+    }
+#endif
+    return false;
+}
+
+// Peak RSS of the process, in bytes (zero if not available).
+inline unsigned long long benchmark_get_peak_rss()
+{
+#if defined(__linux__)
+    // NOTE: VmHWM is affected by benchmark_reset_peak_rss(), contrary to getrusage().
+    std::ifstream f("/proc/self/status");
+    std::string line;
+    while (std::getline(f, line)) {
+        if (line.compare(0u, 6u, "VmHWM:") == 0) {
+            std::istringstream iss(line.substr(6u));
+            unsigned long long kb;
+            if (iss >> kb) {
+                return kb * 1024u;
+            }
+        }
+    }
+#endif
+#if defined(__unix__) || defined(__APPLE__)
+    ::rusage ru;
+    if (::getrusage(RUSAGE_SELF, &ru) == 0) {
+#if defined(__APPLE__)
+        return static_cast<unsigned long long>(ru.ru_maxrss);
+#else
+        return static_cast<unsigned long long>(ru.ru_maxrss) * 1024u;
+#endif
+    }
+#endif
+    return 0u;
+}
+
+inline void benchmark_accumulate_counters(perf_counter_values &acc, const perf_counter_values &v, bool first)
+{
+    for (std::size_t i = 0u; i < perf_counter_values::n_counters; ++i) {
+        acc.available[i] = (first || acc.available[i]) && v.available[i];
+        acc.values[i] = acc.available[i] ? acc.values[i] + v.values[i] : 0u;
+    }
+    acc.wall_time += v.wall_time;
+}
+
+inline void benchmark_write_string(std::ostream &os, const std::string &str)
+{
+    static const char hex_digits[] = "0123456789abcdef";
+    os << '"';
+    for (const char ch : str) {
+        const auto c = static_cast<unsigned char>(ch);
+        if (c == '"' || c == '\\') {
+            os << '\\' << ch;
+        } else if (c < 0x20u) {
+            os << "\\u00" << hex_digits[c >> 4u] << hex_digits[c & 0xfu];
+        } else {
+            os << ch;
+        }
+    }
+    os << '"';
+}
+
+inline const char *benchmark_counter_name(std::size_t i)
+{
+    static const char *names[] = {"cycles", "instructions", "llc_misses", "dtlb_misses", "branch_misses"};
+    return names[i];
+}
+
+inline const char *benchmark_hash_mixing_name(hash_mixing m)
+{
+    switch (m) {
+        case hash_mixing::identity:
+            return "identity";
+        case hash_mixing::multiply_shift:
+            return "multiply_shift";
+        case hash_mixing::randomised:
+            return "randomised";
+    }
+    return "";
+}
+
+// Enable the capture of the simple_timer regions for the lifetime of the object.
+struct benchmark_capture_guard {
+    benchmark_capture_guard()
+    {
+        get_simple_timer_state().m_capture = true;
+        get_simple_timer_state().m_regions.clear();
+    }
+    ~benchmark_capture_guard()
+    {
+        get_simple_timer_state().m_capture = false;
+        get_simple_timer_state().m_regions.clear();
+    }
+};
+
+// Restore the number of threads on destruction.
+struct benchmark_threads_guard {
+    benchmark_threads_guard() : m_n_threads(settings::get_n_threads())
+    {
+    }
+    ~benchmark_threads_guard()
+    {
+        try {
+            settings::set_n_threads(m_n_threads);
+        } catch (...) {
+        }
+    }
+    const unsigned m_n_threads;
+};
+}
+
+// Compute the statistics of a set of timings.
+inline benchmark_result benchmark_statistics(const std::string &name, unsigned n_threads,
+                                             const std::vector<double> &times)
+{
+    if (unlikely(times.empty())) {
+        piranha_throw(std::invalid_argument, "cannot compute the statistics of an empty set of timings");
+    }
+    benchmark_result retval = benchmark_result();
+    retval.m_name = name;
+    retval.m_n_threads = n_threads;
+    retval.m_times = times;
+    auto sorted = times;
+    std::sort(sorted.begin(), sorted.end());
+    const auto size = sorted.size();
+    retval.m_median = (size % 2u) ? sorted[size / 2u] : (sorted[size / 2u - 1u] + sorted[size / 2u]) / 2.;
+    retval.m_min = sorted[0u];
+    double sum = 0.;
+    for (const auto &t : sorted) {
+        sum += t;
+    }
+    retval.m_mean = sum / static_cast<double>(size);
+    if (size > 1u) {
+        double acc = 0.;
+        for (const auto &t : sorted) {
+            acc += (t - retval.m_mean) * (t - retval.m_mean);
+        }
+        retval.m_stddev = std::sqrt(acc / static_cast<double>(size - 1u));
+    }
+    return retval;
+}
+
+// A suite of benchmarks.
+//
+// Each benchmark is a function, optionally preceded by an (untimed) setup function invoked once for each number of
+// threads. The time of a run is the total time of the regions timed via simple_timer during the run (so that,
+// e.g., the functions in pearce1.hpp and similar headers measure only the multiplication), or the wall time of the
+// whole run if no region was timed.
+class benchmark_suite
+{
+public:
+    using func_type = std::function<void()>;
+    // If n_ops is not zero, it is the number of operations performed by each run of the benchmark (this is used
+    // by the microbenchmarks to report the time per operation).
+    void add(const std::string &name, const func_type &run, const func_type &setup = func_type{},
+             unsigned long long n_ops = 0u)
+    {
+        if (unlikely(!run)) {
+            piranha_throw(std::invalid_argument, "invalid benchmark function for the benchmark '" + name + "'");
+        }
+        if (unlikely(std::any_of(m_benchmarks.begin(), m_benchmarks.end(),
+                                 [&name](const entry &e) { return e.m_name == name; }))) {
+            piranha_throw(std::invalid_argument, "a benchmark named '" + name + "' already exists");
+        }
+        m_benchmarks.push_back(entry{name, run, setup, n_ops});
+    }
+    std::vector<std::string> names() const
+    {
+        std::vector<std::string> retval;
+        for (const auto &e : m_benchmarks) {
+            retval.push_back(e.m_name);
+        }
+        return retval;
+    }
+    // Check if the benchmark name is selected by the filter.
+    static bool matches(const std::string &name, const std::string &filter)
+    {
+        if (filter.empty()) {
+            return true;
+        }
+        std::istringstream iss(filter);
+        std::string item;
+        while (std::getline(iss, item, ',')) {
+            if (!item.empty() && name.find(item) != std::string::npos) {
+                return true;
+            }
+        }
+        return false;
+    }
+    // Run the selected benchmarks, logging progress to log (if not null).
+    std::vector<benchmark_result> run(const benchmark_options &opts, std::ostream *log = nullptr) const
+    {
+        if (unlikely(!opts.m_repetitions)) {
+            piranha_throw(std::invalid_argument, "the number of repetitions must be strictly positive");
+        }
+        detail::benchmark_threads_guard tg;
+        const auto threads = opts.m_threads.empty() ? std::vector<unsigned>{tg.m_n_threads} : opts.m_threads;
+        std::vector<benchmark_result> retval;
+        for (const auto &e : m_benchmarks) {
+            if (!matches(e.m_name, opts.m_filter)) {
+                continue;
+            }
+            for (const auto n : threads) {
+                settings::set_n_threads(n);
+                if (log) {
+                    *log << e.m_name << ", " << n << " thread(s): " << std::flush;
+                }
+                retval.push_back(run_one(e, n, opts));
+                if (log) {
+                    const auto &r = retval.back();
+                    *log << "median " << r.m_median << "s, min " << r.m_min << "s, stddev " << r.m_stddev << "s";
+                    if (r.m_n_ops) {
+                        *log << ", " << r.m_median * 1E9 / static_cast<double>(r.m_n_ops) << "ns/op";
+                    }
+                    if (r.m_peak_rss) {
+                        *log << ", peak RSS " << r.m_peak_rss / (1024u * 1024u) << "MB";
+                    }
+                    *log << '\n';
+                }
+            }
+        }
+        return retval;
+    }
+
+private:
+    struct entry {
+        std::string m_name;
+        func_type m_run;
+        func_type m_setup;
+        unsigned long long m_n_ops;
+    };
+    static benchmark_result run_one(const entry &e, unsigned n, const benchmark_options &opts)
+    {
+        detail::benchmark_capture_guard cg;
+        if (e.m_setup) {
+            e.m_setup();
+        }
+        for (unsigned i = 0u; i < opts.m_warmup; ++i) {
+            e.m_run();
+        }
+        const bool reset = detail::benchmark_reset_peak_rss();
+        auto &regions = get_simple_timer_state().m_regions;
+        std::vector<double> times;
+        perf_counter_values counters = perf_counter_values();
+        for (unsigned i = 0u; i < opts.m_repetitions; ++i) {
+            regions.clear();
+            perf_counters pc;
+            pc.start();
+            const auto start = std::chrono::steady_clock::now();
+            e.m_run();
+            const auto wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            const auto wall_counters = pc.stop();
+            if (regions.empty()) {
+                times.push_back(wall);
+                detail::benchmark_accumulate_counters(counters, wall_counters, i == 0u);
+            } else {
+                double t = 0.;
+                perf_counter_values rc = perf_counter_values();
+                for (decltype(regions.size()) j = 0u; j < regions.size(); ++j) {
+                    t += regions[j].m_time;
+                    detail::benchmark_accumulate_counters(rc, regions[j].m_counters, j == 0u);
+                }
+                times.push_back(t);
+                detail::benchmark_accumulate_counters(counters, rc, i == 0u);
+            }
+        }
+        auto retval = benchmark_statistics(e.m_name, n, times);
+        retval.m_peak_rss = detail::benchmark_get_peak_rss();
+        retval.m_peak_rss_reset = reset;
+        for (auto &v : counters.values) {
+            v /= opts.m_repetitions;
+        }
+        counters.wall_time /= opts.m_repetitions;
+        retval.m_counters = counters;
+        retval.m_n_ops = e.m_n_ops;
+        return retval;
+    }
+    std::vector<entry> m_benchmarks;
+};
+
+// Write the results as a JSON document, together with the environment, settings and tuning parameters.
+inline void benchmark_write_json(std::ostream &os, const std::vector<benchmark_result> &results,
+                                 const benchmark_options &opts)
+{
+    std::ostringstream oss;
+    oss.imbue(std::locale::classic());
+    oss << std::setprecision(std::numeric_limits<double>::max_digits10) << std::boolalpha;
+    oss << "{\n  \"environment\": {\"piranha_version\": \"" PIRANHA_BENCHMARK_STR(PIRANHA_VERSION)
+           "\", \"git_revision\": \"" PIRANHA_BENCHMARK_STR(PIRANHA_GIT_REVISION) "\", \"hardware_concurrency\": "
+        << runtime_info::get_hardware_concurrency() << "},\n";
+    oss << "  \"settings\": {\"thread_binding\": " << settings::get_thread_binding()
+        << ", \"nested_parallelism\": \""
+        << (settings::get_nested_parallelism() == nested_parallelism::outer ? "outer" : "cooperative")
+        << "\", \"min_work_per_thread\": " << settings::get_min_work_per_thread()
+        << ", \"cache_line_size\": " << settings::get_cache_line_size() << "},\n";
+    oss << "  \"tuning\": {\"parallel_memory_set\": " << tuning::get_parallel_memory_set()
+        << ", \"multiplication_block_size\": " << tuning::get_multiplication_block_size()
+        << ", \"estimate_threshold\": " << tuning::get_estimate_threshold() << ", \"hash_mixing\": \""
+        << detail::benchmark_hash_mixing_name(tuning::get_hash_mixing())
+        << "\", \"crt_multiplication\": " << tuning::get_crt_multiplication() << "},\n";
+    oss << "  \"options\": {\"warmup\": " << opts.m_warmup << ", \"repetitions\": " << opts.m_repetitions
+        << "},\n";
+    oss << "  \"benchmarks\": [";
+    for (decltype(results.size()) i = 0u; i < results.size(); ++i) {
+        const auto &r = results[i];
+        oss << (i ? ",\n" : "\n") << "    {\"name\": ";
+        detail::benchmark_write_string(oss, r.m_name);
+        oss << ", \"n_threads\": " << r.m_n_threads << ", \"times\": [";
+        for (decltype(r.m_times.size()) j = 0u; j < r.m_times.size(); ++j) {
+            oss << (j ? ", " : "") << r.m_times[j];
+        }
+        oss << "], \"median\": " << r.m_median << ", \"min\": " << r.m_min << ", \"mean\": " << r.m_mean
+            << ", \"stddev\": " << r.m_stddev << ", \"peak_rss\": " << r.m_peak_rss
+            << ", \"peak_rss_reset\": " << r.m_peak_rss_reset;
+        if (r.m_n_ops) {
+            oss << ", \"n_ops\": " << r.m_n_ops
+                << ", \"median_ns_per_op\": " << r.m_median * 1E9 / static_cast<double>(r.m_n_ops);
+        }
+        oss << ", \"perf_counters\": {";
+        bool first = true;
+        for (std::size_t j = 0u; j < perf_counter_values::n_counters; ++j) {
+            if (r.m_counters.available[j]) {
+                oss << (first ? "" : ", ") << '"' << detail::benchmark_counter_name(j)
+                    << "\": " << r.m_counters.values[j];
+                first = false;
+            }
+        }
+        oss << "}}";
+    }
+    oss << "\n  ]\n}\n";
+    os << oss.str();
+}
+
+// Load a baseline. The file can be either a JSON document produced by benchmark_write_json(), or a legacy text
+// file produced by tools/benchmark.py (such as those in the benchmark_results directory). In the latter case,
+// the name of the benchmark is deduced from the file name (which has the form <host>_<name>_perf_<date>.txt)
+// by looking for the longest name in known_names which matches, and the first row of the file contains
+// the mean timings for 1, 2, ... threads.
+inline std::vector<benchmark_baseline> benchmark_load_baseline(const std::string &filename,
+                                                               const std::vector<std::string> &known_names)
+{
+    std::ifstream ifile(filename);
+    if (unlikely(!ifile.good())) {
+        piranha_throw(std::runtime_error, "file '" + filename + "' could not be opened for loading");
+    }
+    std::vector<benchmark_baseline> retval;
+    const auto ext_pos = filename.rfind(".txt");
+    if (ext_pos != std::string::npos && ext_pos + 4u == filename.size()) {
+        const auto base = filename.substr(filename.find_last_of("/\\") + 1u);
+        const auto perf_pos = base.rfind("_perf_");
+        if (unlikely(perf_pos == std::string::npos)) {
+            piranha_throw(std::invalid_argument, "the name of the legacy baseline file '" + filename
+                                                     + "' does not contain the '_perf_' suffix");
+        }
+        const auto prefix = base.substr(0u, perf_pos);
+        std::string name;
+        for (const auto &n : known_names) {
+            // The prefix must be either the name itself, or the name preceded by the host and an underscore.
+            const bool match = prefix == n
+                               || (prefix.size() > n.size() && prefix[prefix.size() - n.size() - 1u] == '_'
+                                   && prefix.compare(prefix.size() - n.size(), n.size(), n) == 0);
+            if (match && n.size() > name.size()) {
+                name = n;
+            }
+        }
+        if (unlikely(name.empty())) {
+            piranha_throw(std::invalid_argument,
+                          "the legacy baseline file '" + filename + "' does not refer to any known benchmark");
+        }
+        std::string line;
+        std::getline(ifile, line);
+        std::istringstream iss(line);
+        iss.imbue(std::locale::classic());
+        double t;
+        unsigned n = 1u;
+        while (iss >> t) {
+            retval.push_back(benchmark_baseline{name, n++, t});
+        }
+        if (unlikely(retval.empty())) {
+            piranha_throw(std::invalid_argument, "the legacy baseline file '" + filename + "' contains no timings");
+        }
+        return retval;
+    }
+    boost::property_tree::ptree pt;
+    try {
+        boost::property_tree::read_json(ifile, pt);
+        for (const auto &p : pt.get_child("benchmarks")) {
+            retval.push_back(benchmark_baseline{p.second.get<std::string>("name"), p.second.get<unsigned>("n_threads"),
+                                                p.second.get<double>("median")});
+        }
+    } catch (const boost::property_tree::ptree_error &e) {
+        piranha_throw(std::invalid_argument,
+                      "invalid baseline file '" + filename + "', the error message is: " + std::string(e.what()));
+    }
+    return retval;
+}
+
+// Compare the results with a baseline: a result is flagged as a regression if its median time exceeds the baseline
+// time by more than the relative tolerance. Results without a baseline are skipped.
+inline std::vector<benchmark_comparison> benchmark_compare(const std::vector<benchmark_result> &results,
+                                                           const std::vector<benchmark_baseline> &baseline,
+                                                           double tolerance)
+{
+    if (unlikely(!(tolerance >= 0.))) {
+        piranha_throw(std::invalid_argument, "the tolerance must be non-negative");
+    }
+    std::vector<benchmark_comparison> retval;
+    for (const auto &r : results) {
+        const auto it = std::find_if(baseline.begin(), baseline.end(), [&r](const benchmark_baseline &b) {
+            return b.m_name == r.m_name && b.m_n_threads == r.m_n_threads;
+        });
+        if (it == baseline.end()) {
+            continue;
+        }
+        retval.push_back(benchmark_comparison{r.m_name, r.m_n_threads, it->m_time, r.m_median,
+                                              r.m_median > it->m_time * (1. + tolerance)});
+    }
+    return retval;
+}
+
+namespace detail
+{
+
+inline void benchmark_print_usage(const char *name)
+{
+    std::cout << "Usage: " << name << " [options]\n\n"
+              << "Options:\n"
+                 "  --list                  list the available benchmarks and exit\n"
+                 "  --filter F1,F2,...      run only the benchmarks whose name contains one of the strings\n"
+                 "  --threads N1,N2,...     numbers of threads (or 'all' for 1, 2, ..., hardware concurrency)\n"
+                 "  --warmup N              number of untimed runs (default: 1)\n"
+                 "  --repetitions N         number of timed runs (default: 5)\n"
+                 "  --output FILE           save the results in JSON format to FILE\n"
+                 "  --baseline FILE         compare the results with the baseline in FILE (JSON or legacy text)\n"
+                 "  --tolerance X           relative slowdown flagged as regression (default: 0.1)\n"
+                 "  --no-binding            do not bind the threads to the processors\n"
+                 "  --help                  print this message and exit\n\n"
+                 "The exit status is 1 if any regression with respect to the baseline is detected.\n";
+}
+
+inline std::vector<unsigned> benchmark_parse_threads(const std::string &str)
+{
+    std::vector<unsigned> retval;
+    if (str == "all") {
+        const auto hc = runtime_info::get_hardware_concurrency();
+        for (unsigned i = 1u; i <= (hc ? hc : 1u); ++i) {
+            retval.push_back(i);
+        }
+        return retval;
+    }
+    std::istringstream iss(str);
+    std::string item;
+    while (std::getline(iss, item, ',')) {
+        retval.push_back(boost::lexical_cast<unsigned>(item));
+    }
+    return retval;
+}
+}
+
+// Entry point of the benchmark programs (benchmark_driver.cpp and microbenchmark_driver.cpp): parse the command line,
+// run the suite and save/compare the results. Run with --help for the list of options. The return value is 0 on
+// success, 1 if any regression with respect to the baseline is detected and 2 on errors.
+inline int benchmark_main(int argc, char **argv, const benchmark_suite &suite)
+{
+    benchmark_options opts;
+    std::string output, baseline;
+    double tolerance = .1;
+    bool binding = true;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg(argv[i]);
+            // Fetch the value of an option.
+            auto value = [&i, argc, argv, &arg]() -> std::string {
+                if (i + 1 == argc) {
+                    throw std::invalid_argument("missing value for the option '" + arg + "'");
+                }
+                return argv[++i];
+            };
+            if (arg == "--help") {
+                detail::benchmark_print_usage(argv[0]);
+                return 0;
+            } else if (arg == "--list") {
+                for (const auto &name : suite.names()) {
+                    std::cout << name << '\n';
+                }
+                return 0;
+            } else if (arg == "--filter") {
+                opts.m_filter = value();
+            } else if (arg == "--threads") {
+                opts.m_threads = detail::benchmark_parse_threads(value());
+            } else if (arg == "--warmup") {
+                opts.m_warmup = boost::lexical_cast<unsigned>(value());
+            } else if (arg == "--repetitions") {
+                opts.m_repetitions = boost::lexical_cast<unsigned>(value());
+            } else if (arg == "--output") {
+                output = value();
+            } else if (arg == "--baseline") {
+                baseline = value();
+            } else if (arg == "--tolerance") {
+                tolerance = boost::lexical_cast<double>(value());
+            } else if (arg == "--no-binding") {
+                binding = false;
+            } else {
+                throw std::invalid_argument("unknown option '" + arg + "'");
+            }
+        }
+    } catch (const std::exception &e) {
+        std::cerr << "Invalid command line: " << e.what() << "\n\n";
+        detail::benchmark_print_usage(argv[0]);
+        return 2;
+    }
+    try {
+        settings::set_thread_binding(binding);
+        // NOTE: load the baseline before running the benchmarks, so that an invalid baseline is reported early.
+        std::vector<benchmark_baseline> baseline_results;
+        if (!baseline.empty()) {
+            baseline_results = benchmark_load_baseline(baseline, suite.names());
+        }
+        const auto results = suite.run(opts, &std::cout);
+        if (!output.empty()) {
+            std::ofstream ofile(output, std::ios::out | std::ios::trunc);
+            if (!ofile.good()) {
+                std::cerr << "File '" << output << "' could not be opened for saving\n";
+                return 2;
+            }
+            benchmark_write_json(ofile, results, opts);
+        }
+        if (baseline.empty()) {
+            return 0;
+        }
+        bool regression = false;
+        for (const auto &c : benchmark_compare(results, baseline_results, tolerance)) {
+            std::cout << (c.m_regression ? "REGRESSION " : "ok         ") << c.m_name << ", " << c.m_n_threads
+                      << " thread(s): " << c.m_current << "s vs " << c.m_baseline << "s ("
+                      << c.m_current / c.m_baseline << "x)\n";
+            regression = regression || c.m_regression;
+        }
+        return regression ? 1 : 0;
+    } catch (const std::exception &e) {
+        std::cerr << "Error: " << e.what() << '\n';
+        return 2;
+    }
+}
+}
+
+#endif
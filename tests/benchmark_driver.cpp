@@ -0,0 +1,249 @@
+/* Copyright 2009-2016 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+// Benchmark driver. This program runs the workloads of the performance tests (pearce1_perf, fateman1_perf, etc.)
+// via the harness in benchmark.hpp, optionally sweeping over the number of threads, prints a summary, saves the
+// results in JSON format and compares them with a baseline (see benchmark_main()). Run with --help for the list of
+// options.
+
+#include "benchmark.hpp"
+
+#include <boost/filesystem.hpp>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include "../src/config.hpp"
+#include "../src/divisor.hpp"
+#include "../src/divisor_series.hpp"
+#include "../src/init.hpp"
+#include "../src/kronecker_monomial.hpp"
+#include "../src/math.hpp"
+#include "../src/memory.hpp"
+#include "../src/monomial.hpp"
+#include "../src/mp_integer.hpp"
+#include "../src/mp_rational.hpp"
+#include "../src/packed_monomial.hpp"
+#include "../src/poisson_series.hpp"
+#include "../src/polynomial.hpp"
+#include "../src/pow.hpp"
+#include "../src/s11n.hpp"
+#include "../src/settings.hpp"
+#include "fateman1.hpp"
+#include "fateman2.hpp"
+#include "gastineau1.hpp"
+#include "gastineau2.hpp"
+#include "gastineau3.hpp"
+#include "gastineau4.hpp"
+#include "monagan.hpp"
+#include "pearce1.hpp"
+#include "pearce2.hpp"
+
+using namespace piranha;
+
+// Register the workloads. Each workload corresponds to the performance test with the same name
+// (e.g., "pearce1" corresponds to pearce1_perf).
+static void register_workloads(benchmark_suite &suite)
+{
+    using limb_t = detail::integer_union<0>::s_storage::limb_t;
+    const auto big_factor = static_cast<unsigned long long>(std::numeric_limits<limb_t>::max());
+    suite.add("pearce1", []() { pearce1<integer, kronecker_monomial<>>(); });
+    suite.add("pearce1_dynamic", [big_factor]() { pearce1<integer, kronecker_monomial<>>(big_factor); });
+    suite.add("pearce1_packed", []() { pearce1<integer, packed_monomial<>>(); });
+    suite.add("pearce1_rational", []() { pearce1<rational, kronecker_monomial<>>(); });
+    suite.add("pearce1_unpacked", []() { pearce1<integer, monomial<signed char>>(); });
+    suite.add("pearce2", []() { pearce2<integer, kronecker_monomial<>>(); });
+    suite.add("pearce2_unpacked", []() { pearce2<integer, monomial<char>>(); });
+    suite.add("fateman1", []() { fateman1<integer, kronecker_monomial<>>(); });
+    suite.add("fateman1_dynamic", [big_factor]() { fateman1<integer, kronecker_monomial<>>(big_factor); });
+    suite.add("fateman1_packed", []() { fateman1<integer, packed_monomial<>>(); });
+    suite.add("fateman1_rational", []() { fateman1<rational, kronecker_monomial<>>(); });
+    suite.add("fateman1_unpacked", []() { fateman1<integer, monomial<signed char>>(); });
+    suite.add("fateman1_unpacked_truncation", []() {
+        using p_type = polynomial<integer, monomial<signed char>>;
+        p_type::set_auto_truncate_degree(30);
+        try {
+            fateman1<integer, monomial<signed char>>();
+        } catch (...) {
+            p_type::unset_auto_truncate_degree();
+            throw;
+        }
+        p_type::unset_auto_truncate_degree();
+    });
+    suite.add("fateman2", []() { fateman2<integer, kronecker_monomial<>>(); });
+    suite.add("gastineau1", []() { gastineau1<integer, kronecker_monomial<>>(); });
+    suite.add("gastineau2", []() { gastineau2<integer, kronecker_monomial<>>(); });
+    suite.add("gastineau3", []() { gastineau3<integer, kronecker_monomial<>>(); });
+    suite.add("gastineau4", []() { gastineau4<integer, kronecker_monomial<>>(); });
+    suite.add("monagan1", []() { monagan1<integer, kronecker_monomial<>>(); });
+    suite.add("monagan1_packed", []() { monagan1<integer, packed_monomial<>>(); });
+    suite.add("monagan2", []() { monagan2<integer, kronecker_monomial<>>(); });
+    suite.add("monagan2_packed", []() { monagan2<integer, packed_monomial<>>(); });
+    suite.add("monagan3", []() { monagan3<integer, kronecker_monomial<>>(); });
+    suite.add("monagan3_packed", []() { monagan3<integer, packed_monomial<>>(); });
+    suite.add("monagan4", []() { monagan4<integer, kronecker_monomial<>>(); });
+    suite.add("monagan4_packed", []() { monagan4<integer, packed_monomial<>>(); });
+    suite.add("monagan5", []() { monagan5<integer, kronecker_monomial<>>(); });
+    suite.add("monagan5_packed", []() { monagan5<integer, packed_monomial<>>(); });
+    // Truncated multiplication with many variables.
+    {
+        using p_type = polynomial<double, k_monomial>;
+        auto fg = std::make_shared<std::pair<p_type, p_type>>();
+        suite.add("audi",
+                  [fg]() {
+                      p_type::set_auto_truncate_degree(10);
+                      try {
+                          p_type res;
+                          simple_timer t;
+                          res = fg->first * fg->second;
+                      } catch (...) {
+                          p_type::unset_auto_truncate_degree();
+                          throw;
+                      }
+                      p_type::unset_auto_truncate_degree();
+                  },
+                  [fg]() {
+                      if (fg->first.size()) {
+                          return;
+                      }
+                      p_type x1{"x1"}, x2{"x2"}, x3{"x3"}, x4{"x4"}, x5{"x5"}, x6{"x6"}, x7{"x7"}, x8{"x8"}, x9{"x9"},
+                          x10{"x10"};
+                      fg->first = math::pow(1 + x1 + x2 + x3 + x4 + x5 + x6 + x7 + x8 + x9 + x10, 10);
+                      fg->second = math::pow(1 - x1 - x2 - x3 - x4 - x5 - x6 - x7 - x8 - x9 - x10, 10);
+                  });
+    }
+    // Repeated multiplication by a polynomial with many terms.
+    suite.add("rectangular", []() {
+        using p_type = polynomial<double, kronecker_monomial<>>;
+        p_type x("x"), y("y"), z("z");
+        auto f = x * y * y * y * z * z + x * x * y * y * z + x * y * y * y * z + x * y * y * z * z + y * y * y * z * z
+                 + y * y * y * z + 2 * y * y * z * z + 2 * x * y * z + y * y * z + y * z * z + y * y + 2 * y * z + z;
+        p_type curr(1);
+        for (auto i = 1; i <= 70; ++i) {
+            curr *= f;
+        }
+    });
+    {
+        using p_type = polynomial<integer, k_monomial>;
+        auto fg = std::make_shared<std::pair<p_type, p_type>>();
+        suite.add("symengine_expand2b",
+                  [fg]() {
+                      p_type res;
+                      {
+                          simple_timer t;
+                          res = fg->first * fg->second;
+                      }
+                  },
+                  [fg]() {
+                      if (fg->first.size()) {
+                          return;
+                      }
+                      auto x = p_type{"x"}, y = p_type{"y"}, z = p_type{"z"}, w = p_type{"w"};
+                      fg->first = math::pow(x + y + z + w, 15);
+                      fg->second = fg->first + w;
+                  });
+    }
+    // Workloads operating on the result of pearce1.
+    {
+        using p_type = polynomial<integer, kronecker_monomial<>>;
+        auto res = std::make_shared<p_type>();
+        auto setup = [res]() {
+            if (res->empty()) {
+                *res = pearce1<integer, kronecker_monomial<>>();
+            }
+        };
+        suite.add("evaluate",
+                  [res]() {
+                      math::evaluate<integer>(*res, {{"x", 1_z}, {"y", 1_z}, {"z", 1_z}, {"t", 1_z}, {"u", 1_z}});
+                  },
+                  setup);
+        suite.add("power_series", [res]() { res->truncate_degree(30); }, setup);
+    }
+    {
+        using p_type = polynomial<integer, monomial<signed char>>;
+        auto res = std::make_shared<p_type>();
+        suite.add("s11n",
+                  [res]() {
+                      std::stringstream ss;
+                      {
+                          boost::archive::binary_oarchive oa(ss);
+                          boost_save(oa, *res);
+                      }
+                      p_type tmp;
+                      {
+                          boost::archive::binary_iarchive ia(ss);
+                          boost_load(ia, tmp);
+                      }
+                  },
+                  [res]() {
+                      if (res->empty()) {
+                          *res = pearce1<integer, monomial<signed char>>();
+                      }
+                  });
+    }
+    suite.add("memory", []() { make_parallel_array<integer>(20000000ull, settings::get_n_threads()); });
+#if defined(PIRANHA_WITH_MSGPACK) && defined(PIRANHA_WITH_BZIP2)
+    {
+        using pt = polynomial<rational, monomial<rational>>;
+        using epst = poisson_series<divisor_series<pt, divisor<short>>>;
+        auto fg = std::make_shared<std::pair<epst, epst>>();
+        suite.add("perminov1",
+                  [fg]() {
+                      pt::set_auto_truncate_degree(
+                          2, {"x1", "x2", "x3", "y1", "y2", "y3", "u1", "u2", "u3", "v1", "v2", "v3"});
+                      try {
+                          epst res;
+                          simple_timer t;
+                          res = fg->first * fg->second;
+                      } catch (...) {
+                          pt::unset_auto_truncate_degree();
+                          throw;
+                      }
+                      pt::unset_auto_truncate_degree();
+                  },
+                  [fg]() {
+                      if (fg->first.size()) {
+                          return;
+                      }
+                      const boost::filesystem::path root_path(PIRANHA_TESTS_DIRECTORY);
+                      load_file(fg->first, (root_path / "data" / "s2l1.mpackp.bz2").string());
+                      load_file(fg->second, (root_path / "data" / "sl1l3.mpackp.bz2").string());
+                  });
+    }
+#endif
+}
+
+int main(int argc, char **argv)
+{
+    init();
+    benchmark_suite suite;
+    register_workloads(suite);
+    return benchmark_main(argc, argv, suite);
+}
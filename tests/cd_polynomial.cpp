@@ -0,0 +1,155 @@
+/* Copyright 2009-2016 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#include "../src/cd_polynomial.hpp"
+
+#define BOOST_TEST_MODULE cd_polynomial_test
+#include <boost/test/included/unit_test.hpp>
+
+#include <sstream>
+#include <string>
+#include <type_traits>
+
+#include "../src/exceptions.hpp"
+#include "../src/init.hpp"
+#include "../src/kronecker_monomial.hpp"
+#include "../src/monomial.hpp"
+#include "../src/mp_integer.hpp"
+#include "../src/mp_rational.hpp"
+#include "../src/polynomial.hpp"
+
+using namespace piranha;
+
+using cd_type = cd_polynomial<k_monomial>;
+using p_type = cd_type::p_type;
+using q_type = cd_type::q_type;
+
+BOOST_AUTO_TEST_CASE(cd_polynomial_ctor_test)
+{
+    init();
+    cd_type c0;
+    BOOST_CHECK(c0.is_canonical());
+    BOOST_CHECK(math::is_zero(c0.num()));
+    BOOST_CHECK_EQUAL(c0.den(), 1);
+    BOOST_CHECK((std::is_constructible<cd_type, int>::value));
+    BOOST_CHECK((std::is_constructible<cd_type, integer>::value));
+    BOOST_CHECK((std::is_constructible<cd_type, rational>::value));
+    BOOST_CHECK((std::is_constructible<cd_type, std::string>::value));
+    BOOST_CHECK((std::is_constructible<cd_type, p_type>::value));
+    BOOST_CHECK((std::is_convertible<q_type, cd_type>::value));
+    BOOST_CHECK((!std::is_constructible<cd_type, double>::value));
+    BOOST_CHECK_EQUAL(cd_type{3}.num(), 3);
+    BOOST_CHECK_EQUAL(cd_type{3}.den(), 1);
+    BOOST_CHECK_EQUAL((cd_type{rational{-6, 4}}.num()), -3);
+    BOOST_CHECK_EQUAL((cd_type{rational{-6, 4}}.den()), 2);
+    BOOST_CHECK_EQUAL(cd_type{"x"}.num(), p_type{"x"});
+    // From q_type.
+    q_type x{"x"}, y{"y"};
+    cd_type c1 = x / 6 - y * rational(3, 4) + rational(1, 3);
+    BOOST_CHECK(c1.is_canonical());
+    BOOST_CHECK_EQUAL(c1.den(), 12);
+    BOOST_CHECK_EQUAL(c1.num(), 2 * p_type{"x"} - 9 * p_type{"y"} + 4);
+    BOOST_CHECK_EQUAL(c1.to_q(), x / 6 - y * rational(3, 4) + rational(1, 3));
+    BOOST_CHECK_EQUAL(cd_type{q_type{}}.den(), 1);
+    BOOST_CHECK(cd_type{q_type{}}.to_q().empty());
+    // From numerator and denominator.
+    cd_type c2{p_type{"x"} * 4 + 6, integer{-8}};
+    BOOST_CHECK(c2.is_canonical());
+    BOOST_CHECK_EQUAL(c2.num(), -2 * p_type{"x"} - 3);
+    BOOST_CHECK_EQUAL(c2.den(), 4);
+    BOOST_CHECK_EQUAL((cd_type{p_type{}, integer{-8}}.den()), 1);
+    BOOST_CHECK_THROW((cd_type{p_type{"x"}, integer{}}), zero_division_error);
+    // Printing.
+    std::ostringstream oss;
+    oss << cd_type{rational{1, 2}};
+    BOOST_CHECK_EQUAL(oss.str(), "1/2");
+    oss.str("");
+    oss << cd_type{p_type{"x"} + 1, integer{3}};
+    BOOST_CHECK(oss.str() == "(x+1)/3" || oss.str() == "(1+x)/3");
+    oss.str("");
+    oss << cd_type{p_type{"x"}};
+    BOOST_CHECK_EQUAL(oss.str(), "x");
+}
+
+BOOST_AUTO_TEST_CASE(cd_polynomial_arith_test)
+{
+    q_type x{"x"}, y{"y"}, z{"z"};
+    cd_type a = x / 2 + y / 3, b = x / 4 - z / 6;
+    BOOST_CHECK_EQUAL((a + b).to_q(), a.to_q() + b.to_q());
+    BOOST_CHECK_EQUAL((a - b).to_q(), a.to_q() - b.to_q());
+    BOOST_CHECK_EQUAL((a * b).to_q(), a.to_q() * b.to_q());
+    BOOST_CHECK_EQUAL((-a).to_q(), -a.to_q());
+    BOOST_CHECK_EQUAL((+a).to_q(), a.to_q());
+    BOOST_CHECK((a + b).is_canonical());
+    BOOST_CHECK((a * b).is_canonical());
+    BOOST_CHECK((a - a).is_canonical());
+    BOOST_CHECK((a - a) == 0);
+    BOOST_CHECK_EQUAL((a * 6).den(), 1);
+    BOOST_CHECK(a * 6 == 3 * x + 2 * y);
+    BOOST_CHECK(rational(1, 2) * a == a / 2);
+    BOOST_CHECK(a + rational(1, 2) != a);
+    BOOST_CHECK(a + 1 == 1 + a.to_q());
+    BOOST_CHECK(a / rational(2, 3) == a.to_q() * rational(3, 2));
+    BOOST_CHECK_THROW(a / 0, zero_division_error);
+    auto a_copy(a);
+    a_copy /= integer(-4);
+    BOOST_CHECK(a_copy == a.to_q() / -4);
+    BOOST_CHECK(a_copy.is_canonical());
+    a += b;
+    BOOST_CHECK_EQUAL(a.to_q(), x * rational(3, 4) + y / 3 - z / 6);
+    a -= b;
+    BOOST_CHECK(a == x / 2 + y / 3);
+    a *= a;
+    BOOST_CHECK(a == (x / 2 + y / 3) * (x / 2 + y / 3));
+    BOOST_CHECK(a.is_canonical());
+}
+
+BOOST_AUTO_TEST_CASE(cd_polynomial_fateman_test)
+{
+    // Check against the multiplication with rational coefficients.
+    q_type x{"x"}, y{"y"}, z{"z"}, t{"t"};
+    auto f = x / 2 + y * rational(2, 3) + z / 5 + t + 1, g = f + rational(1, 7);
+    auto tmp_f = f, tmp_g = g;
+    for (int i = 1; i < 8; ++i) {
+        f *= tmp_f;
+        g *= tmp_g;
+    }
+    const auto ref = f * g;
+    const cd_type f_cd = f, g_cd = g;
+    const auto res = f_cd * g_cd;
+    BOOST_CHECK(res.is_canonical());
+    BOOST_CHECK_EQUAL(res.to_q(), ref);
+    BOOST_CHECK_EQUAL(res.num().size(), ref.size());
+    BOOST_CHECK(res == cd_type{ref});
+    // Also with a different key type.
+    using cd_type2 = cd_polynomial<monomial<int>>;
+    using q_type2 = cd_type2::q_type;
+    q_type2 a{"a"}, b{"b"};
+    const cd_type2 c = a / 3 + b / 5;
+    BOOST_CHECK_EQUAL((c * c * c).to_q(), (a / 3 + b / 5) * (a / 3 + b / 5) * (a / 3 + b / 5));
+}
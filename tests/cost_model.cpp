@@ -0,0 +1,247 @@
+/* Copyright 2009-2016 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#include "../src/cost_model.hpp"
+
+#define BOOST_TEST_MODULE cost_model_test
+#include <boost/test/included/unit_test.hpp>
+
+#include <boost/filesystem.hpp>
+#include <chrono>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "../src/init.hpp"
+#include "../src/kronecker_monomial.hpp"
+#include "../src/mp_integer.hpp"
+#include "../src/mp_rational.hpp"
+#include "../src/polynomial.hpp"
+#include "../src/settings.hpp"
+#include "../src/thread_pool.hpp"
+
+using namespace piranha;
+namespace bfs = boost::filesystem;
+
+// Helper class to create and remove a temporary file.
+struct tmp_file {
+    tmp_file()
+    {
+        m_path = bfs::temp_directory_path();
+        // Concatenate with a unique filename.
+        m_path /= bfs::unique_path();
+    }
+    ~tmp_file()
+    {
+        bfs::remove(m_path);
+    }
+    std::string name() const
+    {
+        return m_path.string();
+    }
+    bfs::path m_path;
+};
+
+using p_type = polynomial<integer, k_monomial>;
+using q_type = polynomial<rational, k_monomial>;
+
+BOOST_AUTO_TEST_CASE(cost_model_costs_test)
+{
+    init();
+    // Default state.
+    BOOST_CHECK_EQUAL(cost_model::get_cost<p_type>(cost_operation::multiplication), 0.);
+    BOOST_CHECK_EQUAL(cost_model::get_cost<p_type>(cost_operation::traversal), 0.);
+    BOOST_CHECK_EQUAL(cost_model::get_min_work_per_thread<p_type>(cost_operation::multiplication),
+                      settings::get_min_work_per_thread());
+    BOOST_CHECK(cost_model::get_thread_overhead() > 0.);
+    // Invalid values.
+    BOOST_CHECK_THROW(cost_model::set_cost<p_type>(cost_operation::multiplication, 0.), std::invalid_argument);
+    BOOST_CHECK_THROW(cost_model::set_cost<p_type>(cost_operation::multiplication, -1.), std::invalid_argument);
+    BOOST_CHECK_THROW(
+        cost_model::set_cost<p_type>(cost_operation::multiplication, std::numeric_limits<double>::infinity()),
+        std::invalid_argument);
+    BOOST_CHECK_THROW(cost_model::set_thread_overhead(0.), std::invalid_argument);
+    BOOST_CHECK_THROW(cost_model::set_thread_overhead(std::numeric_limits<double>::quiet_NaN()),
+                      std::invalid_argument);
+    BOOST_CHECK_EQUAL(cost_model::get_cost<p_type>(cost_operation::multiplication), 0.);
+    // Costs are per operation and per type.
+    cost_model::set_thread_overhead(10000.);
+    cost_model::set_cost<p_type>(cost_operation::multiplication, 5.);
+    BOOST_CHECK_EQUAL(cost_model::get_cost<p_type>(cost_operation::multiplication), 5.);
+    BOOST_CHECK_EQUAL(cost_model::get_cost<p_type>(cost_operation::traversal), 0.);
+    BOOST_CHECK_EQUAL(cost_model::get_cost<q_type>(cost_operation::multiplication), 0.);
+    // 10000 / (5 * 0.02).
+    BOOST_CHECK_EQUAL(cost_model::get_min_work_per_thread<p_type>(cost_operation::multiplication), 100000u);
+    BOOST_CHECK_EQUAL(cost_model::get_min_work_per_thread<p_type>(cost_operation::traversal),
+                      settings::get_min_work_per_thread());
+    BOOST_CHECK_EQUAL(cost_model::get_min_work_per_thread<q_type>(cost_operation::multiplication),
+                      settings::get_min_work_per_thread());
+    // Modifications of the model are seen by all threads.
+    cost_model::set_thread_overhead(20000.);
+    BOOST_CHECK_EQUAL(cost_model::get_min_work_per_thread<p_type>(cost_operation::multiplication), 200000u);
+    BOOST_CHECK_EQUAL(thread_pool::enqueue(0u,
+                                           []() {
+                                               return cost_model::get_min_work_per_thread<p_type>(
+                                                   cost_operation::multiplication);
+                                           })
+                          .get(),
+                      200000u);
+    cost_model::set_thread_overhead(10000.);
+    BOOST_CHECK_EQUAL(cost_model::get_min_work_per_thread<p_type>(cost_operation::multiplication), 100000u);
+    BOOST_CHECK_EQUAL(thread_pool::enqueue(0u,
+                                           []() {
+                                               return cost_model::get_min_work_per_thread<p_type>(
+                                                   cost_operation::multiplication);
+                                           })
+                          .get(),
+                      100000u);
+    // Very expensive and very cheap operations.
+    cost_model::set_cost<q_type>(cost_operation::multiplication, 1E9);
+    BOOST_CHECK_EQUAL(cost_model::get_min_work_per_thread<q_type>(cost_operation::multiplication), 1u);
+    cost_model::set_cost<q_type>(cost_operation::multiplication, std::numeric_limits<double>::denorm_min());
+    BOOST_CHECK_EQUAL(cost_model::get_min_work_per_thread<q_type>(cost_operation::multiplication),
+                      std::numeric_limits<unsigned long long>::max());
+    // Overwrite a cost.
+    cost_model::set_cost<q_type>(cost_operation::multiplication, 2.5);
+    BOOST_CHECK_EQUAL(cost_model::get_cost<q_type>(cost_operation::multiplication), 2.5);
+    // Thread counts.
+    settings::set_n_threads(4u);
+    BOOST_CHECK_EQUAL(cost_model::use_threads<p_type>(cost_operation::multiplication, integer(100000)), 1u);
+    BOOST_CHECK_EQUAL(cost_model::use_threads<p_type>(cost_operation::multiplication, integer(200000)), 2u);
+    BOOST_CHECK_EQUAL(cost_model::use_threads<p_type>(cost_operation::multiplication, integer(1000000)), 4u);
+    BOOST_CHECK_EQUAL(cost_model::use_threads<p_type>(cost_operation::traversal, integer(1000000)),
+                      thread_pool::use_threads(integer(1000000), integer(settings::get_min_work_per_thread())));
+    // The model is consulted by the series multiplier.
+    {
+        p_type x{"x"}, y{"y"};
+        auto f = (x + y + 1) * (x - y + 1);
+        BOOST_CHECK_EQUAL(f, x * x + 2 * x - y * y + 1);
+    }
+    // Reset.
+    cost_model::reset();
+    BOOST_CHECK_EQUAL(cost_model::get_cost<p_type>(cost_operation::multiplication), 0.);
+    BOOST_CHECK_EQUAL(cost_model::get_cost<q_type>(cost_operation::multiplication), 0.);
+    BOOST_CHECK_EQUAL(cost_model::get_min_work_per_thread<p_type>(cost_operation::multiplication),
+                      settings::get_min_work_per_thread());
+    settings::reset_n_threads();
+}
+
+BOOST_AUTO_TEST_CASE(cost_model_s11n_test)
+{
+    cost_model::set_thread_overhead(12345.678);
+    cost_model::set_cost<p_type>(cost_operation::multiplication, 1. / 3.);
+    cost_model::set_cost<p_type>(cost_operation::traversal, 42.);
+    cost_model::set_cost<q_type>(cost_operation::multiplication, 1E-3);
+    {
+        tmp_file file;
+        cost_model::save(file.name());
+        cost_model::reset();
+        cost_model::set_cost<q_type>(cost_operation::traversal, 7.);
+        // 20000 / (7 * 0.02), rounded up.
+        BOOST_CHECK_EQUAL(cost_model::get_min_work_per_thread<q_type>(cost_operation::traversal), 142858u);
+        cost_model::load(file.name());
+        BOOST_CHECK_EQUAL(cost_model::get_thread_overhead(), 12345.678);
+        BOOST_CHECK_EQUAL(cost_model::get_cost<p_type>(cost_operation::multiplication), 1. / 3.);
+        BOOST_CHECK_EQUAL(cost_model::get_cost<p_type>(cost_operation::traversal), 42.);
+        BOOST_CHECK_EQUAL(cost_model::get_cost<q_type>(cost_operation::multiplication), 1E-3);
+        // Loading replaces the whole model.
+        BOOST_CHECK_EQUAL(cost_model::get_cost<q_type>(cost_operation::traversal), 0.);
+        BOOST_CHECK_EQUAL(cost_model::get_min_work_per_thread<q_type>(cost_operation::traversal),
+                          settings::get_min_work_per_thread());
+        // 12345.678 / (42 * 0.02), rounded up.
+        BOOST_CHECK_EQUAL(cost_model::get_min_work_per_thread<p_type>(cost_operation::traversal), 14698u);
+    }
+    // Invalid files.
+    auto check_invalid = [](const std::string &content) {
+        tmp_file file;
+        {
+            std::ofstream ofile(file.name());
+            ofile << content;
+        }
+        BOOST_CHECK_THROW(cost_model::load(file.name()), std::invalid_argument);
+        // The model was not modified.
+        BOOST_CHECK_EQUAL(cost_model::get_cost<p_type>(cost_operation::traversal), 42.);
+    };
+    check_invalid("");
+    check_invalid("foo 1\n");
+    check_invalid("thread_overhead\n");
+    check_invalid("thread_overhead -1\n");
+    check_invalid("thread_overhead 1 2\n");
+    check_invalid("thread_overhead 1\nmultiplication 1\n");
+    check_invalid("thread_overhead 1\nmultiplication 0 foo\n");
+    check_invalid("thread_overhead 1\ndivision 1 foo\n");
+    BOOST_CHECK_THROW(cost_model::load((bfs::temp_directory_path() / bfs::unique_path()).string()),
+                      std::runtime_error);
+    // Empty model.
+    cost_model::reset();
+    {
+        tmp_file file;
+        cost_model::save(file.name());
+        cost_model::set_cost<p_type>(cost_operation::traversal, 42.);
+        cost_model::load(file.name());
+        BOOST_CHECK_EQUAL(cost_model::get_cost<p_type>(cost_operation::traversal), 0.);
+        BOOST_CHECK_EQUAL(cost_model::get_min_work_per_thread<p_type>(cost_operation::traversal),
+                          settings::get_min_work_per_thread());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(cost_model_calibration_test)
+{
+    BOOST_CHECK_THROW(cost_model::calibrate_thread_overhead(0u), std::invalid_argument);
+    BOOST_CHECK(cost_model::calibrate_thread_overhead(10u) > 0.);
+    BOOST_CHECK_EQUAL(cost_model::get_thread_overhead() > 0., true);
+    auto sleeper = []() { std::this_thread::sleep_for(std::chrono::milliseconds(1)); };
+    BOOST_CHECK_THROW(cost_model::calibrate<p_type>(cost_operation::traversal, sleeper, integer(0)),
+                      std::invalid_argument);
+    BOOST_CHECK_THROW(cost_model::calibrate<p_type>(cost_operation::traversal, sleeper, integer(1), 0u),
+                      std::invalid_argument);
+    // 1 ms over 1000 units of work: at least 1 us per unit.
+    const auto c = cost_model::calibrate<p_type>(cost_operation::traversal, sleeper, integer(1000), 2u);
+    BOOST_CHECK(c >= 1000.);
+    BOOST_CHECK_EQUAL(cost_model::get_cost<p_type>(cost_operation::traversal), c);
+    // Exceptions are propagated.
+    BOOST_CHECK_THROW(cost_model::calibrate<q_type>(cost_operation::traversal,
+                                                    []() { throw std::runtime_error("error"); }, integer(1)),
+                      std::runtime_error);
+    BOOST_CHECK_EQUAL(cost_model::get_cost<q_type>(cost_operation::traversal), 0.);
+    // Multiplication.
+    p_type x{"x"}, y{"y"}, z{"z"};
+    const auto f = math::pow(x + y + z + 1, 10);
+    BOOST_CHECK(cost_model::calibrate_multiplication(f, f, 1u) > 0.);
+    BOOST_CHECK(cost_model::get_cost<p_type>(cost_operation::multiplication) > 0.);
+    BOOST_CHECK(cost_model::get_min_work_per_thread<p_type>(cost_operation::multiplication) >= 1u);
+    // The calibrated model does not alter the results.
+    for (unsigned n = 1u; n <= 4u; ++n) {
+        settings::set_n_threads(n);
+        BOOST_CHECK_EQUAL(f * f, math::pow(x + y + z + 1, 20));
+    }
+    settings::reset_n_threads();
+    cost_model::reset();
+}
@@ -0,0 +1,81 @@
+/* Copyright 2009-2016 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#include "../src/cost_model.hpp"
+
+#define BOOST_TEST_MODULE cost_model_test
+#include <boost/test/included/unit_test.hpp>
+
+#include <boost/lexical_cast.hpp>
+#include <iostream>
+#include <string>
+
+#include "../src/init.hpp"
+#include "../src/kronecker_monomial.hpp"
+#include "../src/mp_integer.hpp"
+#include "../src/mp_rational.hpp"
+#include "../src/polynomial.hpp"
+#include "../src/settings.hpp"
+
+using namespace piranha;
+
+// Offline calibration of the cost model. The first optional argument is the number of threads,
+// the second optional argument is the name of the file in which the calibrated model will be saved.
+
+template <typename PType>
+static void calibrate_poly(const std::string &name)
+{
+    PType x{"x"}, y{"y"}, z{"z"}, t{"t"};
+    const auto f = math::pow(x + y + z + t + 1, 15);
+    std::cout << name << ", multiplication: " << cost_model::calibrate_multiplication(f, f) << " ns\n";
+    const auto g = f * f;
+    std::cout << name << ", traversal: "
+              << cost_model::calibrate<PType>(cost_operation::traversal, [&g]() { (void)g.height(); },
+                                              integer(g.size()))
+              << " ns\n";
+    std::cout << name << ", min work per thread: "
+              << cost_model::get_min_work_per_thread<PType>(cost_operation::multiplication) << " (multiplication), "
+              << cost_model::get_min_work_per_thread<PType>(cost_operation::traversal) << " (traversal)\n";
+}
+
+BOOST_AUTO_TEST_CASE(cost_model_calibration_test)
+{
+    init();
+    settings::set_thread_binding(true);
+    if (boost::unit_test::framework::master_test_suite().argc > 1) {
+        settings::set_n_threads(
+            boost::lexical_cast<unsigned>(boost::unit_test::framework::master_test_suite().argv[1u]));
+    }
+    std::cout << "Thread overhead: " << cost_model::calibrate_thread_overhead() << " ns\n";
+    calibrate_poly<polynomial<integer, k_monomial>>("integer");
+    calibrate_poly<polynomial<rational, k_monomial>>("rational");
+    calibrate_poly<polynomial<double, k_monomial>>("double");
+    if (boost::unit_test::framework::master_test_suite().argc > 2) {
+        cost_model::save(boost::unit_test::framework::master_test_suite().argv[2u]);
+    }
+}
@@ -0,0 +1,354 @@
+/* Copyright 2009-2016 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#include "../src/dd_real.hpp"
+
+#define BOOST_TEST_MODULE dd_real_test
+#include <boost/test/included/unit_test.hpp>
+
+#include <boost/lexical_cast.hpp>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include "../src/init.hpp"
+#include "../src/is_cf.hpp"
+#include "../src/kronecker_monomial.hpp"
+#include "../src/math.hpp"
+#include "../src/mp_integer.hpp"
+#include "../src/mp_rational.hpp"
+#include "../src/poisson_series.hpp"
+#include "../src/polynomial.hpp"
+#include "../src/real.hpp"
+#include "../src/s11n.hpp"
+#include "../src/safe_cast.hpp"
+#include "../src/type_traits.hpp"
+
+using namespace piranha;
+
+static const int ntries = 1000;
+
+static std::mt19937 rng;
+
+// Exact value of a dd_real as a real.
+static real to_real(const dd_real &d)
+{
+    real retval{d.hi(), 256};
+    retval += real{d.lo(), 256};
+    return retval;
+}
+
+// Check that the relative error of d with respect to r is below 2**-n.
+static bool close_to(const dd_real &d, const real &r, int n = 100)
+{
+    const real err = math::abs(to_real(d) - r);
+    return err <= math::abs(r) * real{std::ldexp(1., -n), 256} || (r.sign() == 0 && d.is_zero());
+}
+
+// Random dd_real with a full-width significand.
+static dd_real random_dd(double min, double max)
+{
+    std::uniform_real_distribution<double> dist(min, max);
+    const double hi = dist(rng);
+    return dd_real{hi, hi * std::ldexp(std::uniform_real_distribution<double>(-.5, .5)(rng), -53)};
+}
+
+BOOST_AUTO_TEST_CASE(dd_real_constructors_test)
+{
+    init();
+    BOOST_CHECK(is_cf<dd_real>::value);
+    BOOST_CHECK(!zero_is_absorbing<dd_real>::value);
+    BOOST_CHECK(has_multiply_accumulate<dd_real>::value);
+    BOOST_CHECK((std::is_nothrow_move_constructible<dd_real>::value));
+    BOOST_CHECK((!std::is_constructible<dd_real, std::vector<int>>::value));
+    BOOST_CHECK(dd_real{}.is_zero());
+    BOOST_CHECK_EQUAL(dd_real{}.hi(), 0.);
+    BOOST_CHECK_EQUAL(dd_real{}.lo(), 0.);
+    // Components are normalised.
+    dd_real d{1., 1.};
+    BOOST_CHECK_EQUAL(d.hi(), 2.);
+    BOOST_CHECK_EQUAL(d.lo(), 0.);
+    d = dd_real{1., std::ldexp(1., -60)};
+    BOOST_CHECK_EQUAL(d.hi(), 1.);
+    BOOST_CHECK_EQUAL(d.lo(), std::ldexp(1., -60));
+    // Integral types up to 64 bits are represented exactly.
+    BOOST_CHECK_EQUAL(static_cast<integer>(dd_real{std::numeric_limits<long long>::max()}),
+                      integer{std::numeric_limits<long long>::max()});
+    BOOST_CHECK_EQUAL(static_cast<integer>(dd_real{std::numeric_limits<long long>::min()}),
+                      integer{std::numeric_limits<long long>::min()});
+    BOOST_CHECK_EQUAL(static_cast<integer>(dd_real{std::numeric_limits<unsigned long long>::max()}),
+                      integer{std::numeric_limits<unsigned long long>::max()});
+    BOOST_CHECK_EQUAL(dd_real{true}, 1);
+    BOOST_CHECK_EQUAL(dd_real{'a'}, 97);
+    BOOST_CHECK_EQUAL(dd_real{-3.5f}, -3.5);
+    // mp_integer and mp_rational.
+    const integer big{"123456789012345678901234567890"};
+    BOOST_CHECK(close_to(dd_real{big}, real{big, 256}, 104));
+    BOOST_CHECK(close_to(dd_real{-big}, real{-big, 256}, 104));
+    BOOST_CHECK(close_to(dd_real{rational{1, 3}}, real{rational{1, 3}, 256}));
+    BOOST_CHECK(close_to(dd_real{rational{-big, 7}}, real{rational{-big, 7}, 256}));
+    // Strings.
+    BOOST_CHECK(close_to(dd_real{"0.1"}, real{"0.1", 256}, 105));
+    BOOST_CHECK(close_to(dd_real{std::string("-3.14159265358979323846264338327950288")}, -real{0, 256}.pi(), 105));
+    BOOST_CHECK_THROW(dd_real{"foo"}, std::invalid_argument);
+    BOOST_CHECK(dd_real{"inf"}.is_inf());
+    BOOST_CHECK_EQUAL(dd_real{"inf"}.lo(), 0.);
+    BOOST_CHECK(dd_real{"nan"}.is_nan());
+    // Non-finite values.
+    BOOST_CHECK(dd_real{std::numeric_limits<double>::infinity()}.is_inf());
+    BOOST_CHECK_EQUAL(dd_real{std::numeric_limits<double>::infinity()}.lo(), 0.);
+    // Assignment.
+    d = 5;
+    BOOST_CHECK_EQUAL(d, 5);
+    d = rational{1, 2};
+    BOOST_CHECK_EQUAL(d, .5);
+    // Printing and parsing back is accurate to about 107 bits.
+    for (int i = 0; i < ntries; ++i) {
+        const auto r = random_dd(-100., 100.);
+        BOOST_CHECK(close_to(dd_real{boost::lexical_cast<std::string>(r)}, to_real(r), 104));
+    }
+    BOOST_CHECK_EQUAL(boost::lexical_cast<std::string>(dd_real{"1.5"}),
+                      boost::lexical_cast<std::string>(real{"1.5", 107}));
+}
+
+BOOST_AUTO_TEST_CASE(dd_real_conversion_test)
+{
+    BOOST_CHECK(static_cast<bool>(dd_real{1}));
+    BOOST_CHECK(!static_cast<bool>(dd_real{}));
+    BOOST_CHECK_EQUAL(static_cast<double>(dd_real{1., 1e-20}), 1.);
+    BOOST_CHECK_EQUAL(static_cast<int>(dd_real{"-7.9"}), -7);
+    BOOST_CHECK_EQUAL(static_cast<int>(dd_real{"7.9"}), 7);
+    // Truncation with the low component of opposite sign.
+    BOOST_CHECK_EQUAL(static_cast<integer>(dd_real{4., -.25}), 3);
+    BOOST_CHECK_EQUAL(static_cast<integer>(dd_real{-4., .25}), -3);
+    BOOST_CHECK_EQUAL(static_cast<integer>(dd_real{std::ldexp(1., 80), 3.}), integer{2}.pow(80u) + 3);
+    BOOST_CHECK_THROW(static_cast<int>(dd_real{1e30}), std::overflow_error);
+    BOOST_CHECK_THROW(static_cast<integer>(dd_real{"nan"}), std::overflow_error);
+    BOOST_CHECK_EQUAL((static_cast<rational>(dd_real{1., std::ldexp(1., -70)})),
+                      (rational{1} + rational{1, integer{2}.pow(70u)}));
+    BOOST_CHECK_THROW(static_cast<rational>(dd_real{"inf"}), std::overflow_error);
+    // Safe cast.
+    BOOST_CHECK_EQUAL(safe_cast<int>(dd_real{42}), 42);
+    const integer n_big{"-123456789012345678901"};
+    BOOST_CHECK_EQUAL(safe_cast<integer>(dd_real{n_big}), n_big);
+    BOOST_CHECK_THROW(safe_cast<int>(dd_real{"1.5"}), safe_cast_failure);
+    BOOST_CHECK_THROW(safe_cast<short>(dd_real{1e10}), safe_cast_failure);
+    BOOST_CHECK_THROW(safe_cast<integer>(dd_real{"nan"}), safe_cast_failure);
+    BOOST_CHECK_EQUAL(safe_cast<rational>(dd_real{"0.5"}), rational(1, 2));
+    // Interop in-place operations.
+    double x = 1.;
+    x += dd_real{2};
+    BOOST_CHECK_EQUAL(x, 3.);
+    int n = 10;
+    n /= dd_real{4};
+    BOOST_CHECK_EQUAL(n, 2);
+}
+
+BOOST_AUTO_TEST_CASE(dd_real_arithmetic_test)
+{
+    for (int i = 0; i < ntries; ++i) {
+        const auto a = random_dd(-1e6, 1e6), b = random_dd(-1e3, 1e3);
+        const auto ra = to_real(a), rb = to_real(b);
+        // The error bounds are relative to the operands for addition and subtraction, as
+        // cancellation might occur.
+        const real add_tol = math::abs(ra) * real{std::ldexp(1., -100), 256};
+        BOOST_CHECK(math::abs(to_real(a + b) - (ra + rb)) <= add_tol);
+        BOOST_CHECK(math::abs(to_real(a - b) - (ra - rb)) <= add_tol);
+        BOOST_CHECK(close_to(a * b, ra * rb));
+        BOOST_CHECK(close_to(a / b, ra / rb));
+        // Mixed-type operations.
+        BOOST_CHECK(close_to(a * b.hi(), ra * real{b.hi(), 256}));
+        BOOST_CHECK(close_to(b.hi() * a, ra * real{b.hi(), 256}));
+        BOOST_CHECK(close_to(a / 3, ra / 3));
+        BOOST_CHECK(close_to(3 / a, 3 / ra));
+        BOOST_CHECK(close_to(a * rational{1, 3}, ra * real{rational{1, 3}, 256}));
+        BOOST_CHECK(close_to(integer{7} - a, integer{7} - ra) || math::abs(ra - 7) < 1);
+        // In-place and multiply-accumulate.
+        auto c = a;
+        c *= b;
+        BOOST_CHECK_EQUAL(c, a * b);
+        c /= b;
+        BOOST_CHECK(close_to(c, ra, 98));
+        c = a;
+        c.multiply_accumulate(a, b);
+        BOOST_CHECK(close_to(c, ra + ra * rb, 98) || math::abs(rb + 1) < 1e-3);
+        c = a;
+        math::multiply_accumulate(c, a, b);
+        BOOST_CHECK(close_to(c, ra + ra * rb, 98) || math::abs(rb + 1) < 1e-3);
+    }
+    // Comparisons.
+    const dd_real one{1}, one_eps{1., std::ldexp(1., -80)};
+    BOOST_CHECK(one < one_eps);
+    BOOST_CHECK(one <= one_eps);
+    BOOST_CHECK(one_eps > one);
+    BOOST_CHECK(one_eps >= one);
+    BOOST_CHECK(one != one_eps);
+    BOOST_CHECK(one == 1);
+    BOOST_CHECK(1. == one);
+    BOOST_CHECK(one_eps > 1);
+    BOOST_CHECK(integer{1} < one_eps);
+    BOOST_CHECK(-one_eps < -one);
+    BOOST_CHECK(dd_real{"nan"} != dd_real{"nan"});
+    BOOST_CHECK(!(dd_real{"nan"} < one));
+    // Non-finite values propagate like in double arithmetic.
+    const dd_real inf{std::numeric_limits<double>::infinity()};
+    BOOST_CHECK_EQUAL(inf + one, inf);
+    BOOST_CHECK_EQUAL((inf + one).lo(), 0.);
+    BOOST_CHECK_EQUAL(one_eps * inf, inf);
+    BOOST_CHECK((inf - inf).is_nan());
+    BOOST_CHECK_EQUAL(one / dd_real{}, inf);
+    BOOST_CHECK((dd_real{} / dd_real{}).is_nan());
+    BOOST_CHECK_EQUAL(dd_real{std::numeric_limits<double>::max()} * 2, inf);
+    // Misc.
+    BOOST_CHECK_EQUAL(dd_real{-3}.abs(), 3);
+    BOOST_CHECK_EQUAL(math::abs(dd_real{-3}), 3);
+    BOOST_CHECK_EQUAL(dd_real{-3}.sign(), -1);
+    BOOST_CHECK_EQUAL(dd_real{}.sign(), 0);
+    BOOST_CHECK(math::is_zero(dd_real{}));
+    BOOST_CHECK(math::is_zero(math::partial(dd_real{3}, "x")));
+    auto e = one_eps;
+    math::negate(e);
+    BOOST_CHECK_EQUAL(e, -one_eps);
+    BOOST_CHECK_EQUAL(+e, e);
+}
+
+BOOST_AUTO_TEST_CASE(dd_real_pow_sin_cos_test)
+{
+    BOOST_CHECK((is_exponentiable<dd_real, int>::value));
+    BOOST_CHECK((is_exponentiable<dd_real, integer>::value));
+    BOOST_CHECK((!is_exponentiable<dd_real, double>::value));
+    BOOST_CHECK_EQUAL(dd_real{2}.pow(0), 1);
+    BOOST_CHECK_EQUAL(dd_real{}.pow(0), 1);
+    BOOST_CHECK_EQUAL(math::pow(dd_real{2}, 100), dd_real{integer{2}.pow(100u)});
+    BOOST_CHECK_EQUAL(math::pow(dd_real{2}, -2), .25);
+    BOOST_CHECK_EQUAL(math::pow(dd_real{-2}, integer{3}), -8);
+    BOOST_CHECK_EQUAL(math::pow(dd_real{2}, integer{-3}), .125);
+    BOOST_CHECK_EQUAL(math::pow(dd_real{}, -1), dd_real{std::numeric_limits<double>::infinity()});
+    for (int i = 0; i < ntries; ++i) {
+        const auto a = random_dd(.5, 2.);
+        const int n = std::uniform_int_distribution<int>(-30, 30)(rng);
+        BOOST_CHECK(close_to(a.pow(n), to_real(a).pow(real{n, 256}), 98));
+    }
+    // Trigonometric functions.
+    BOOST_CHECK_EQUAL(math::sin(dd_real{}), 0);
+    BOOST_CHECK_EQUAL(math::cos(dd_real{}), 1);
+    BOOST_CHECK(math::sin(dd_real{"inf"}).is_nan());
+    BOOST_CHECK(math::cos(dd_real{"nan"}).is_nan());
+    BOOST_CHECK(close_to(dd_real::pi(), real{0, 256}.pi(), 105));
+    const real eps{std::ldexp(1., -102), 256};
+    for (int i = 0; i < ntries; ++i) {
+        const auto a = random_dd(-20., 20.);
+        const auto ra = to_real(a);
+        BOOST_CHECK(math::abs(to_real(math::sin(a)) - math::sin(ra)) <= eps);
+        BOOST_CHECK(math::abs(to_real(math::cos(a)) - math::cos(ra)) <= eps);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(dd_real_s11n_test)
+{
+    BOOST_CHECK((has_boost_save<boost::archive::text_oarchive, dd_real>::value));
+    BOOST_CHECK((has_boost_load<boost::archive::binary_iarchive, dd_real>::value));
+    for (int i = 0; i < ntries; ++i) {
+        const auto a = random_dd(-1e10, 1e10);
+        {
+            std::stringstream ss;
+            {
+                boost::archive::text_oarchive oa(ss);
+                boost_save(oa, a);
+            }
+            dd_real retval;
+            {
+                boost::archive::text_iarchive ia(ss);
+                boost_load(ia, retval);
+            }
+            BOOST_CHECK_EQUAL(retval.hi(), a.hi());
+            BOOST_CHECK_EQUAL(retval.lo(), a.lo());
+        }
+        {
+            std::stringstream ss;
+            {
+                boost::archive::binary_oarchive oa(ss);
+                boost_save(oa, a);
+            }
+            dd_real retval;
+            {
+                boost::archive::binary_iarchive ia(ss);
+                boost_load(ia, retval);
+            }
+            BOOST_CHECK_EQUAL(retval.hi(), a.hi());
+            BOOST_CHECK_EQUAL(retval.lo(), a.lo());
+        }
+#if defined(PIRANHA_WITH_MSGPACK)
+        for (auto f : {msgpack_format::portable, msgpack_format::binary}) {
+            msgpack::sbuffer sbuf;
+            msgpack::packer<msgpack::sbuffer> p(sbuf);
+            msgpack_pack(p, a, f);
+            auto oh = msgpack::unpack(sbuf.data(), sbuf.size());
+            dd_real retval;
+            msgpack_convert(retval, oh.get(), f);
+            BOOST_CHECK_EQUAL(retval.hi(), a.hi());
+            BOOST_CHECK_EQUAL(retval.lo(), a.lo());
+        }
+#endif
+    }
+}
+
+BOOST_AUTO_TEST_CASE(dd_real_series_test)
+{
+    using p_type = polynomial<dd_real, k_monomial>;
+    using pr_type = polynomial<real, k_monomial>;
+    p_type x{"x"}, y{"y"}, z{"z"};
+    pr_type xr{"x"}, yr{"y"}, zr{"z"};
+    auto f = math::pow(x + y + z + dd_real{rational{1, 3}}, 6), g = math::pow(x - y - z - dd_real{"0.1"}, 6);
+    auto fr = math::pow(xr + yr + zr + real{rational{1, 3}, 256}, 6),
+         gr = math::pow(xr - yr - zr - real{"0.1", 256}, 6);
+    const auto prod = f * g;
+    const auto prod_r = fr * gr;
+    BOOST_CHECK_EQUAL(prod.size(), prod_r.size());
+    const real tol{"1e-25", 256};
+    for (const auto &t : prod._container()) {
+        const auto it = prod_r._container().find(pr_type::term_type{real{}, t.m_key});
+        BOOST_CHECK(it != prod_r._container().end());
+        BOOST_CHECK(math::abs(to_real(t.m_cf) - it->m_cf) <= tol);
+    }
+    // Evaluation, on a series with positive coefficients in order to avoid cancellation.
+    const auto ev = math::evaluate<dd_real>(f * f, {{"x", dd_real{"0.3"}}, {"y", dd_real{"1.1"}}, {"z", dd_real{2}}});
+    const auto ev_r = math::evaluate<real>(
+        fr * fr, {{"x", to_real(dd_real{"0.3"})}, {"y", to_real(dd_real{"1.1"})}, {"z", real{2, 256}}});
+    BOOST_CHECK(close_to(ev, ev_r, 96));
+    // Poisson series.
+    using ps_type = poisson_series<p_type>;
+    const auto ps = math::cos(ps_type{"t"} * 2) * ps_type{"z"} * dd_real{"0.3"};
+    BOOST_CHECK_EQUAL(ps.size(), 1u);
+    const auto ev_ps = math::evaluate<dd_real>(ps, {{"z", dd_real{2}}, {"t", dd_real{"0.7"}}});
+    BOOST_CHECK(close_to(ev_ps, math::cos(real{"1.4", 256}) * 2 * real{"0.3", 256}, 100));
+}
@@ -44,12 +44,14 @@ see https://www.gnu.org/licenses/. */
 #include <limits>
 #include <map>
 #include <new>
+#include <numeric>
 #include <random>
 #include <sstream>
 #include <stdexcept>
 #include <string>
 #include <tuple>
 #include <type_traits>
+#include <vector>
 
 #include "../src/exceptions.hpp"
 #include "../src/init.hpp"
@@ -642,6 +644,37 @@ BOOST_AUTO_TEST_CASE(hash_set_evaluate_sparsity_test)
     boost::mpl::for_each<key_types>(evaluate_sparsity_tester());
 }
 
+struct evaluate_zone_occupancy_tester {
+    template <typename T>
+    void operator()(const T &)
+    {
+        hash_set<T> h;
+        using size_type = typename hash_set<T>::size_type;
+        BOOST_CHECK_THROW(h.evaluate_zone_occupancy(0u), std::invalid_argument);
+        BOOST_CHECK((h.evaluate_zone_occupancy(3u) == std::vector<size_type>{0u, 0u, 0u}));
+        for (int i = 0; i < 100; ++i) {
+            h.insert(boost::lexical_cast<T>(i));
+        }
+        for (size_type n_zones : {size_type(1u), size_type(7u), size_type(64u), h.bucket_count() * 2u}) {
+            const auto occ = h.evaluate_zone_occupancy(n_zones);
+            BOOST_CHECK_EQUAL(occ.size(), n_zones);
+            BOOST_CHECK_EQUAL(std::accumulate(occ.begin(), occ.end(), size_type(0u)), 100u);
+        }
+        // Check the zone of each element.
+        const size_type n_zones = 4u, bpz = h.bucket_count() / n_zones;
+        std::vector<size_type> cmp(n_zones, 0u);
+        for (const auto &x : h) {
+            ++cmp[std::min(h.bucket(x) / bpz, n_zones - 1u)];
+        }
+        BOOST_CHECK(h.evaluate_zone_occupancy(n_zones) == cmp);
+    }
+};
+
+BOOST_AUTO_TEST_CASE(hash_set_evaluate_zone_occupancy_test)
+{
+    boost::mpl::for_each<key_types>(evaluate_zone_occupancy_tester());
+}
+
 struct type_traits_tester {
     template <typename T>
     void operator()(const T &)
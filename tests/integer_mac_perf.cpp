@@ -0,0 +1,90 @@
+/* Copyright 2009-2016 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#include "../src/mp_integer.hpp"
+
+#define BOOST_TEST_MODULE integer_mac_test
+#include <boost/test/included/unit_test.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "../src/init.hpp"
+
+using namespace piranha;
+
+// Per-product timing of the multiply-accumulate of static integers, one element at a time via
+// math::multiply_accumulate() versus the array form mp_integer::mac_n().
+
+static const std::size_t size = 1000000u;
+static const unsigned n_rounds = 20u;
+
+template <typename F>
+static double ns_per_product(F &&f)
+{
+    const auto start = std::chrono::high_resolution_clock::now();
+    for (unsigned r = 0u; r < n_rounds; ++r) {
+        f();
+    }
+    const auto stop = std::chrono::high_resolution_clock::now();
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count())
+           / (double(size) * n_rounds);
+}
+
+BOOST_AUTO_TEST_CASE(integer_mac_test)
+{
+    init();
+    std::mt19937 rng;
+    std::uniform_int_distribution<long long> dist(-(1ll << 40), 1ll << 40);
+    std::vector<integer> acc1, acc2, b;
+    for (std::size_t i = 0u; i < size; ++i) {
+        acc1.emplace_back(dist(rng));
+        b.emplace_back(dist(rng));
+    }
+    acc2 = acc1;
+    const integer a(dist(rng));
+    // Scattered pointers, as in the polynomial multiplier.
+    std::vector<integer *> acc_ptr;
+    std::vector<const integer *> b_ptr;
+    for (std::size_t i = 0u; i < size; ++i) {
+        acc_ptr.push_back(&acc2[i]);
+        b_ptr.push_back(&b[i]);
+    }
+    const auto t_scalar = ns_per_product([&]() {
+        for (std::size_t i = 0u; i < size; ++i) {
+            math::multiply_accumulate(acc1[i], a, b[i]);
+        }
+    });
+    const auto t_mac_n = ns_per_product([&]() { integer::mac_n(acc_ptr.data(), a, b_ptr.data(), size); });
+    std::cout << "multiply_accumulate(): " << t_scalar << " ns per product\n";
+    std::cout << "mac_n(): " << t_mac_n << " ns per product\n";
+    BOOST_CHECK(acc1 == acc2);
+}
@@ -0,0 +1,286 @@
+/* Copyright 2009-2016 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#include "../src/kronecker_divisor.hpp"
+
+#define BOOST_TEST_MODULE kronecker_divisor_test
+#include <boost/test/included/unit_test.hpp>
+
+#include <array>
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/archive/text_iarchive.hpp>
+#include <boost/archive/text_oarchive.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/mpl/for_each.hpp>
+#include <boost/mpl/vector.hpp>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../src/divisor.hpp"
+#include "../src/divisor_series.hpp"
+#include "../src/init.hpp"
+#include "../src/invert.hpp"
+#include "../src/is_key.hpp"
+#include "../src/key_is_multipliable.hpp"
+#include "../src/math.hpp"
+#include "../src/monomial.hpp"
+#include "../src/mp_integer.hpp"
+#include "../src/mp_rational.hpp"
+#include "../src/poisson_series.hpp"
+#include "../src/polynomial.hpp"
+#include "../src/s11n.hpp"
+#include "../src/symbol_set.hpp"
+#include "../src/term.hpp"
+
+using namespace piranha;
+
+using value_types = boost::mpl::vector<signed char, short, int, long, long long>;
+
+struct basic_tester {
+    template <typename T>
+    void operator()(const T &)
+    {
+        using d_type = kronecker_divisor<T>;
+        BOOST_CHECK(is_key<d_type>::value);
+        BOOST_CHECK((key_is_multipliable<rational, d_type>::value));
+        d_type d0;
+        BOOST_CHECK_EQUAL(d0.size(), 0u);
+        symbol_set s{symbol{"x"}, symbol{"y"}};
+        BOOST_CHECK(d0.is_compatible(s));
+        BOOST_CHECK(d0.is_unitary(s));
+        BOOST_CHECK_EQUAL(d0.hash(), 0u);
+        std::vector<int> tmp{1, -2};
+        d0.insert(tmp.begin(), tmp.end(), 1);
+        BOOST_CHECK_EQUAL(d0.size(), 1u);
+        BOOST_CHECK(d0.is_compatible(s));
+        BOOST_CHECK(!d0.is_compatible(symbol_set{}));
+        BOOST_CHECK(!d0.is_unitary(s));
+        BOOST_CHECK_THROW(d0.is_unitary(symbol_set{}), std::invalid_argument);
+        // Existing term, the exponent is updated.
+        d0.insert(tmp.begin(), tmp.end(), 2);
+        BOOST_CHECK_EQUAL(d0.size(), 1u);
+        std::ostringstream oss;
+        d0.print(oss, s);
+        BOOST_CHECK_EQUAL(oss.str(), "1/[(x-2*y)**3]");
+        // Non-canonical terms.
+        tmp = {-1, 2};
+        BOOST_CHECK_THROW(d0.insert(tmp.begin(), tmp.end(), 1), std::invalid_argument);
+        tmp = {2, 4};
+        BOOST_CHECK_THROW(d0.insert(tmp.begin(), tmp.end(), 1), std::invalid_argument);
+        tmp = {0, 0};
+        BOOST_CHECK_THROW(d0.insert(tmp.begin(), tmp.end(), 1), std::invalid_argument);
+        tmp = {0, 1};
+        BOOST_CHECK_THROW(d0.insert(tmp.begin(), tmp.end(), 0), std::invalid_argument);
+        // Size mismatch.
+        tmp = {0, 1, 1};
+        BOOST_CHECK_THROW(d0.insert(tmp.begin(), tmp.end(), 1), std::invalid_argument);
+        BOOST_CHECK_EQUAL(d0.size(), 1u);
+        // Out of the Kronecker limits.
+        const auto &limits = kronecker_array<T>::get_limits();
+        if (limits.size() > 2u) {
+            tmp = {1, static_cast<int>(std::get<0u>(limits[2u])[1u]) + 1};
+            if (tmp[1u] <= std::numeric_limits<T>::max()) {
+                BOOST_CHECK_THROW(d0.insert(tmp.begin(), tmp.end(), 1), std::invalid_argument);
+            }
+        }
+        // Equality and hashing do not depend on the insertion order.
+        d_type d1, d2;
+        std::vector<std::vector<int>> terms{{1, 0}, {0, 1}, {1, -1}, {2, 1}};
+        for (const auto &t : terms) {
+            d1.insert(t.begin(), t.end(), 1);
+        }
+        for (auto it = terms.rbegin(); it != terms.rend(); ++it) {
+            d2.insert(it->begin(), it->end(), 1);
+        }
+        BOOST_CHECK(d1 == d2);
+        BOOST_CHECK_EQUAL(d1.hash(), d2.hash());
+        BOOST_CHECK_EQUAL(d1.hash(), std::hash<d_type>()(d2));
+        d2.insert(terms[0u].begin(), terms[0u].end(), 1);
+        BOOST_CHECK(d1 != d2);
+        // Copy, move, clear.
+        d_type d3(d1);
+        BOOST_CHECK(d3 == d1);
+        d_type d4(std::move(d3));
+        BOOST_CHECK(d4 == d1);
+        d4.clear();
+        BOOST_CHECK_EQUAL(d4.size(), 0u);
+        BOOST_CHECK(d4.is_compatible(symbol_set{}));
+        BOOST_CHECK_THROW((d_type{d1, symbol_set{}}), std::invalid_argument);
+        BOOST_CHECK((d_type{d1, s}) == d1);
+    }
+};
+
+BOOST_AUTO_TEST_CASE(kronecker_divisor_basic_test)
+{
+    init();
+    boost::mpl::for_each<value_types>(basic_tester());
+}
+
+struct arith_tester {
+    template <typename T>
+    void operator()(const T &)
+    {
+        using d_type = kronecker_divisor<T>;
+        using term_type = term<integer, d_type>;
+        symbol_set s{symbol{"x"}, symbol{"y"}};
+        std::vector<int> a{1, 0}, b{1, 1}, c{0, 1};
+        term_type t1, t2;
+        t1.m_cf = 2;
+        t2.m_cf = 3;
+        t1.m_key.insert(a.begin(), a.end(), 1);
+        t1.m_key.insert(b.begin(), b.end(), 2);
+        t2.m_key.insert(b.begin(), b.end(), 1);
+        t2.m_key.insert(c.begin(), c.end(), 3);
+        std::array<term_type, 1u> res;
+        d_type::multiply(res, t1, t2, s);
+        BOOST_CHECK_EQUAL(res[0u].m_cf, 6);
+        BOOST_CHECK_EQUAL(res[0u].m_key.size(), 3u);
+        d_type cmp;
+        cmp.insert(c.begin(), c.end(), 3);
+        cmp.insert(b.begin(), b.end(), 3);
+        cmp.insert(a.begin(), a.end(), 1);
+        BOOST_CHECK(res[0u].m_key == cmp);
+        // Multiplication by the empty divisor.
+        d_type::multiply(res, t1, term_type{}, s);
+        BOOST_CHECK(res[0u].m_key == t1.m_key);
+        BOOST_CHECK_THROW(d_type::multiply(res, t1, t2, symbol_set{}), std::invalid_argument);
+        // Evaluation.
+        using pmap_type = symbol_set::positions_map<rational>;
+        BOOST_CHECK_EQUAL(cmp.evaluate(pmap_type(s, {{symbol("x"), 1_q}, {symbol("y"), 2_q}}), s),
+                          1 / (math::pow(2_q, 3) * math::pow(3_q, 3)));
+        BOOST_CHECK_THROW(cmp.evaluate(pmap_type(s, {{symbol("x"), 1_q}}), s), std::invalid_argument);
+        // Merge args: the result must be the same as building the divisor from the merged vectors.
+        symbol_set s2{symbol{"a"}, symbol{"x"}, symbol{"y"}, symbol{"z"}};
+        auto merged = cmp.merge_args(s, s2);
+        d_type cmp2;
+        std::vector<int> a2{0, 1, 0, 0}, b2{0, 1, 1, 0}, c2{0, 0, 1, 0};
+        cmp2.insert(a2.begin(), a2.end(), 1);
+        cmp2.insert(b2.begin(), b2.end(), 3);
+        cmp2.insert(c2.begin(), c2.end(), 3);
+        BOOST_CHECK(merged == cmp2);
+        BOOST_CHECK(merged.is_compatible(s2));
+        BOOST_CHECK_THROW(cmp.merge_args(s2, s), std::invalid_argument);
+        // Trim.
+        symbol_set cands(s2);
+        merged.trim_identify(cands, s2);
+        BOOST_CHECK(cands == (symbol_set{symbol{"a"}, symbol{"z"}}));
+        BOOST_CHECK(merged.trim(cands, s2) == cmp);
+        // Split.
+        auto sp = cmp.split(symbol_set::positions(s, symbol_set{symbol{"x"}}), s);
+        BOOST_CHECK_EQUAL(sp.first.size(), 2u);
+        BOOST_CHECK_EQUAL(sp.second.size(), 1u);
+        std::ostringstream oss;
+        sp.second.print(oss, s);
+        BOOST_CHECK_EQUAL(oss.str(), "1/[(y)**3]");
+        oss.str("");
+        sp.second.print_tex(oss, s);
+        BOOST_CHECK_EQUAL(oss.str(), "\\frac{1}{\\left(y\\right)^{3}}");
+        BOOST_CHECK_THROW(cmp.split(symbol_set::positions(s, symbol_set{}), s), std::invalid_argument);
+    }
+};
+
+BOOST_AUTO_TEST_CASE(kronecker_divisor_arith_test)
+{
+    boost::mpl::for_each<value_types>(arith_tester());
+}
+
+template <typename OArchive, typename IArchive, typename T>
+static inline void boost_roundtrip(const T &x, const symbol_set &s)
+{
+    std::stringstream ss;
+    {
+        OArchive oa(ss);
+        boost_save(oa, boost_s11n_key_wrapper<T>{x, s});
+    }
+    T retval;
+    {
+        IArchive ia(ss);
+        boost_s11n_key_wrapper<T> w{retval, s};
+        boost_load(ia, w);
+    }
+    BOOST_CHECK(x == retval);
+}
+
+BOOST_AUTO_TEST_CASE(kronecker_divisor_s11n_test)
+{
+    using d_type = kronecker_divisor<long long>;
+    symbol_set s{symbol{"x"}, symbol{"y"}, symbol{"z"}};
+    d_type d;
+    boost_roundtrip<boost::archive::binary_oarchive, boost::archive::binary_iarchive>(d, s);
+    boost_roundtrip<boost::archive::text_oarchive, boost::archive::text_iarchive>(d, s);
+    std::vector<int> a{1, -3, 0}, b{0, 2, 5};
+    d.insert(a.begin(), a.end(), 2);
+    d.insert(b.begin(), b.end(), 1);
+    boost_roundtrip<boost::archive::binary_oarchive, boost::archive::binary_iarchive>(d, s);
+    boost_roundtrip<boost::archive::text_oarchive, boost::archive::text_iarchive>(d, s);
+    BOOST_CHECK((!has_boost_save<boost::archive::binary_oarchive, d_type>::value));
+    BOOST_CHECK((has_boost_save<boost::archive::binary_oarchive, boost_s11n_key_wrapper<d_type>>::value));
+    BOOST_CHECK((has_boost_load<boost::archive::binary_iarchive, boost_s11n_key_wrapper<d_type>>::value));
+    // Incompatible symbol set.
+    std::stringstream ss;
+    boost::archive::text_oarchive oa(ss);
+    BOOST_CHECK_THROW(boost_save(oa, boost_s11n_key_wrapper<d_type>{d, symbol_set{}}), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(kronecker_divisor_series_test)
+{
+    // Check that the series-level operations agree with the ones using piranha::divisor.
+    using p_type = polynomial<rational, monomial<short>>;
+    using s_type = divisor_series<p_type, divisor<short>>;
+    using ks_type = divisor_series<p_type, kronecker_divisor<long long>>;
+    s_type x{"x"}, y{"y"}, z{"z"};
+    ks_type kx{"x"}, ky{"y"}, kz{"z"};
+    auto s0 = math::invert(x + 2 * y) * math::invert(y - z).pow(2) * x + z * math::invert(x);
+    auto ks0 = math::invert(kx + 2 * ky) * math::invert(ky - kz).pow(2) * kx + kz * math::invert(kx);
+    BOOST_CHECK_EQUAL(s0.size(), ks0.size());
+    for (const auto &v : std::vector<std::string>{"x", "y", "z"}) {
+        const auto d = s0.partial(v);
+        const auto kd = ks0.partial(v);
+        BOOST_CHECK_EQUAL(d.size(), kd.size());
+        BOOST_CHECK_EQUAL(math::evaluate<rational>(d, {{"x", 3_q}, {"y", -5_q}, {"z", 7_q}}),
+                          math::evaluate<rational>(kd, {{"x", 3_q}, {"y", -5_q}, {"z", 7_q}}));
+    }
+    BOOST_CHECK_EQUAL(math::evaluate<rational>(s0 * s0, {{"x", 3_q}, {"y", -5_q}, {"z", 7_q}}),
+                      math::evaluate<rational>(ks0 * ks0, {{"x", 3_q}, {"y", -5_q}, {"z", 7_q}}));
+    BOOST_CHECK_EQUAL(boost::lexical_cast<std::string>(math::invert(kx - ky)), "1/[(x-y)]");
+    // Integration.
+    BOOST_CHECK_EQUAL(math::integrate(kx + ky.invert(), "x"), kx * kx / 2 + kx * ky.invert());
+    BOOST_CHECK_THROW(math::integrate(kx + ky.invert() + kx.invert(), "x"), std::invalid_argument);
+    // Time integration of a Poisson series.
+    using ps_type = poisson_series<ks_type>;
+    ps_type a{"a"}, b{"b"}, c{"c"};
+    auto p1 = 3 * a * b * math::cos(3 * c);
+    BOOST_CHECK_EQUAL(boost::lexical_cast<std::string>(p1.t_integrate()), "a*b*1/[(\\nu_{c})]*sin(3*c)");
+    BOOST_CHECK_EQUAL(boost::lexical_cast<std::string>(p1.t_integrate().partial("\\nu_{c}")),
+                      "-a*b*1/[(\\nu_{c})**2]*sin(3*c)");
+}
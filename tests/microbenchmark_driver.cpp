@@ -0,0 +1,501 @@
+/* Copyright 2009-2016 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+// Microbenchmark driver. This program measures the core primitives on which the series arithmetic is built (hash_set,
+// kronecker_array, small_vector/static_vector, mp_integer/mp_rational, symbol_set, thread_pool and
+// atomic_flag_array), so that a regression detected by benchmark_driver can be traced back to the primitive
+// responsible for it. The command line options and the JSON output are the same as in benchmark_driver (see
+// benchmark_main()), and each result also reports the number of operations per run and the median time per
+// operation. The benchmarks involving threads use the number of threads in piranha::settings (i.e., the values
+// passed via --threads), the others are single-threaded.
+
+#include "benchmark.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../src/config.hpp"
+#include "../src/detail/atomic_flag_array.hpp"
+#include "../src/hash_set.hpp"
+#include "../src/init.hpp"
+#include "../src/kronecker_array.hpp"
+#include "../src/mp_integer.hpp"
+#include "../src/mp_rational.hpp"
+#include "../src/settings.hpp"
+#include "../src/small_vector.hpp"
+#include "../src/static_vector.hpp"
+#include "../src/symbol.hpp"
+#include "../src/symbol_set.hpp"
+#include "../src/thread_pool.hpp"
+
+using namespace piranha;
+
+static std::mt19937_64 rng;
+
+// Sink for the results of the operations, so that they are not optimised away.
+static volatile std::size_t sink = 0u;
+
+// Number of elements on which the operations are performed in each run, and number of passes over them.
+static const std::size_t n_elements = 1024u;
+static const std::size_t n_rounds = 1024u;
+
+// Number of buckets of the hash sets.
+static const std::size_t hs_n_buckets = 1u << 20;
+
+// Insertion, lookup, removal and rehashing in hash_set, with different load factors. Half of the lookups are
+// unsuccessful.
+static void register_hash_set(benchmark_suite &suite)
+{
+    using hs_type = hash_set<std::size_t>;
+    const std::vector<std::pair<std::string, std::size_t>> configs
+        = {{"0.25", hs_n_buckets / 4u}, {"0.5", hs_n_buckets / 2u}, {"1", hs_n_buckets}};
+    for (const auto &c : configs) {
+        const auto n = c.second;
+        // The first n keys are inserted in the set, the others are used for the unsuccessful lookups.
+        auto keys = std::make_shared<std::vector<std::size_t>>();
+        auto hs = std::make_shared<hs_type>();
+        auto setup = [keys, hs, n]() {
+            if (keys->size()) {
+                return;
+            }
+            std::uniform_int_distribution<std::size_t> dist;
+            std::generate_n(std::back_inserter(*keys), 2u * n, [&dist]() { return dist(rng); });
+            *hs = hs_type(hs_n_buckets);
+            for (std::size_t i = 0u; i < n; ++i) {
+                hs->insert((*keys)[i]);
+            }
+        };
+        const auto suffix = "_lf" + c.first;
+        suite.add("hash_set_insert" + suffix,
+                  [keys, n]() {
+                      hs_type h(hs_n_buckets);
+                      simple_timer t;
+                      for (std::size_t i = 0u; i < n; ++i) {
+                          h.insert((*keys)[i]);
+                      }
+                  },
+                  setup, n);
+        suite.add("hash_set_find" + suffix,
+                  [keys, hs]() {
+                      std::size_t s = 0u;
+                      for (const auto &k : *keys) {
+                          s += static_cast<std::size_t>(hs->find(k) != hs->end());
+                      }
+                      sink = s;
+                  },
+                  setup, 2u * n);
+        suite.add("hash_set_erase" + suffix,
+                  [keys, hs, n]() {
+                      hs_type h(*hs);
+                      simple_timer t;
+                      for (std::size_t i = 0u; i < n; ++i) {
+                          const auto it = h.find((*keys)[i]);
+                          if (it != h.end()) {
+                              h.erase(it);
+                          }
+                      }
+                  },
+                  setup, n);
+        // Each run doubles the number of buckets and then restores it.
+        suite.add("hash_set_rehash" + suffix,
+                  [hs]() {
+                      hs->rehash(2u * hs_n_buckets, settings::get_n_threads());
+                      hs->rehash(hs_n_buckets, settings::get_n_threads());
+                  },
+                  setup, 2u * n);
+    }
+}
+
+// Kronecker encoding and decoding of vectors of different dimensions.
+static void register_kronecker_array(benchmark_suite &suite)
+{
+    using ka = kronecker_array<std::int_least64_t>;
+    using v_type = std::vector<std::int_least64_t>;
+    for (const std::size_t dim : {1u, 2u, 4u, 8u, 16u}) {
+        if (dim >= ka::get_limits().size()) {
+            break;
+        }
+        auto vc = std::make_shared<std::pair<std::vector<v_type>, std::vector<std::int_least64_t>>>();
+        auto setup = [vc, dim]() {
+            if (vc->first.size()) {
+                return;
+            }
+            const auto &minmax = std::get<0u>(ka::get_limits()[dim]);
+            for (std::size_t i = 0u; i < n_elements; ++i) {
+                v_type v(dim);
+                for (std::size_t j = 0u; j < dim; ++j) {
+                    v[j] = std::uniform_int_distribution<std::int_least64_t>(-minmax[j], minmax[j])(rng);
+                }
+                vc->second.push_back(ka::encode(v));
+                vc->first.push_back(std::move(v));
+            }
+        };
+        const auto suffix = "_dim" + std::to_string(dim);
+        suite.add("kronecker_array_encode" + suffix,
+                  [vc]() {
+                      std::size_t s = 0u;
+                      for (std::size_t r = 0u; r < n_rounds; ++r) {
+                          for (const auto &v : vc->first) {
+                              s += static_cast<std::size_t>(ka::encode(v));
+                          }
+                      }
+                      sink = s;
+                  },
+                  setup, n_elements * n_rounds);
+        suite.add("kronecker_array_decode" + suffix,
+                  [vc, dim]() {
+                      v_type tmp(dim);
+                      std::size_t s = 0u;
+                      for (std::size_t r = 0u; r < n_rounds; ++r) {
+                          for (const auto &c : vc->second) {
+                              ka::decode(tmp, c);
+                              s += static_cast<std::size_t>(tmp[0u]);
+                          }
+                      }
+                      sink = s;
+                  },
+                  setup, n_elements * n_rounds);
+    }
+}
+
+// Element-wise addition and hashing of small_vector (in static and dynamic storage), push_back and hashing
+// of static_vector.
+static void register_vectors(benchmark_suite &suite)
+{
+    using sv_type = small_vector<int>;
+    const std::vector<std::pair<std::string, std::size_t>> configs
+        = {{"static", sv_type::max_static_size}, {"dynamic", sv_type::max_static_size * 4u}};
+    for (const auto &c : configs) {
+        const auto size = c.second;
+        auto vs = std::make_shared<std::pair<std::vector<sv_type>, std::vector<sv_type>>>();
+        auto setup = [vs, size]() {
+            if (vs->first.size()) {
+                return;
+            }
+            std::uniform_int_distribution<int> dist(-100, 100);
+            for (std::size_t i = 0u; i < n_elements; ++i) {
+                sv_type a, b;
+                for (std::size_t j = 0u; j < size; ++j) {
+                    a.push_back(dist(rng));
+                    b.push_back(dist(rng));
+                }
+                vs->first.push_back(std::move(a));
+                vs->second.push_back(std::move(b));
+            }
+        };
+        suite.add("small_vector_add_" + c.first,
+                  [vs]() {
+                      sv_type res;
+                      std::size_t s = 0u;
+                      for (std::size_t r = 0u; r < n_rounds; ++r) {
+                          for (std::size_t i = 0u; i < n_elements; ++i) {
+                              vs->first[i].add(res, vs->second[i]);
+                              s += static_cast<std::size_t>(res[0u]);
+                          }
+                      }
+                      sink = s;
+                  },
+                  setup, n_elements * n_rounds);
+        suite.add("small_vector_hash_" + c.first,
+                  [vs]() {
+                      std::size_t s = 0u;
+                      for (std::size_t r = 0u; r < n_rounds; ++r) {
+                          for (const auto &v : vs->first) {
+                              s += v.hash();
+                          }
+                      }
+                      sink = s;
+                  },
+                  setup, n_elements * n_rounds);
+    }
+    using stv_type = static_vector<int, 16u>;
+    auto vs = std::make_shared<std::vector<stv_type>>();
+    auto setup = [vs]() {
+        if (vs->size()) {
+            return;
+        }
+        std::uniform_int_distribution<int> dist(-100, 100);
+        for (std::size_t i = 0u; i < n_elements; ++i) {
+            stv_type v;
+            for (std::size_t j = 0u; j < 16u; ++j) {
+                v.push_back(dist(rng));
+            }
+            vs->push_back(std::move(v));
+        }
+    };
+    // Each operation fills up a vector and then clears it.
+    suite.add("static_vector_push_back",
+              [vs]() {
+                  stv_type tmp;
+                  std::size_t s = 0u;
+                  for (std::size_t r = 0u; r < n_rounds; ++r) {
+                      for (const auto &v : *vs) {
+                          tmp.clear();
+                          for (const auto &x : v) {
+                              tmp.push_back(x);
+                          }
+                          s += static_cast<std::size_t>(tmp[15u]);
+                      }
+                  }
+                  sink = s;
+              },
+              setup, n_elements * n_rounds);
+    suite.add("static_vector_hash",
+              [vs]() {
+                  std::size_t s = 0u;
+                  for (std::size_t r = 0u; r < n_rounds; ++r) {
+                      for (const auto &v : *vs) {
+                          s += v.hash();
+                      }
+                  }
+                  sink = s;
+              },
+              setup, n_elements * n_rounds);
+}
+
+// A random positive integer with (approximately) the given number of bits, built from 16-bit chunks.
+static integer random_integer(unsigned bits)
+{
+    std::uniform_int_distribution<unsigned> dist(1u, 65535u);
+    integer retval(dist(rng));
+    for (unsigned i = 16u; i < bits; i += 16u) {
+        retval *= 65536;
+        retval += dist(rng);
+    }
+    return retval;
+}
+
+// Addition, multiplication and multiply-accumulate of integers with static storage (with the results fitting in one
+// and two limbs respectively) and with dynamic storage.
+static void register_mp_integer(benchmark_suite &suite)
+{
+    const std::vector<std::pair<std::string, unsigned>> configs
+        = {{"static16", 16u}, {"static48", 48u}, {"dynamic256", 256u}};
+    for (const auto &c : configs) {
+        const auto bits = c.second;
+        auto ops = std::make_shared<std::pair<std::vector<integer>, std::vector<integer>>>();
+        auto res = std::make_shared<std::vector<integer>>(n_elements);
+        auto setup = [ops, bits]() {
+            if (ops->first.size()) {
+                return;
+            }
+            std::generate_n(std::back_inserter(ops->first), n_elements, [bits]() { return random_integer(bits); });
+            std::generate_n(std::back_inserter(ops->second), n_elements, [bits]() { return random_integer(bits); });
+        };
+        suite.add("mp_integer_add_" + c.first,
+                  [ops, res]() {
+                      for (std::size_t r = 0u; r < n_rounds; ++r) {
+                          for (std::size_t i = 0u; i < n_elements; ++i) {
+                              (*res)[i].add(ops->first[i], ops->second[i]);
+                          }
+                      }
+                  },
+                  setup, n_elements * n_rounds);
+        suite.add("mp_integer_mul_" + c.first,
+                  [ops, res]() {
+                      for (std::size_t r = 0u; r < n_rounds; ++r) {
+                          for (std::size_t i = 0u; i < n_elements; ++i) {
+                              (*res)[i].mul(ops->first[i], ops->second[i]);
+                          }
+                      }
+                  },
+                  setup, n_elements * n_rounds);
+        suite.add("mp_integer_multiply_accumulate_" + c.first,
+                  [ops, res]() {
+                      for (std::size_t r = 0u; r < n_rounds; ++r) {
+                          for (std::size_t i = 0u; i < n_elements; ++i) {
+                              (*res)[i].multiply_accumulate(ops->first[i], ops->second[i]);
+                          }
+                      }
+                  },
+                  setup, n_elements * n_rounds);
+    }
+}
+
+// Canonicalisation of rationals whose numerator and denominator have a random common factor.
+static void register_mp_rational(benchmark_suite &suite)
+{
+    const std::vector<std::pair<std::string, unsigned>> configs = {{"static", 16u}, {"dynamic", 128u}};
+    for (const auto &c : configs) {
+        const auto bits = c.second;
+        auto qs = std::make_shared<std::vector<rational>>();
+        suite.add("mp_rational_canonicalise_" + c.first,
+                  [qs]() {
+                      auto tmp(*qs);
+                      simple_timer t;
+                      for (auto &q : tmp) {
+                          q.canonicalise();
+                      }
+                  },
+                  [qs, bits]() {
+                      if (qs->size()) {
+                          return;
+                      }
+                      for (std::size_t i = 0u; i < n_elements * 16u; ++i) {
+                          const auto g = random_integer(bits);
+                          rational q;
+                          q._num() = random_integer(bits) * g;
+                          q._set_den(random_integer(bits) * g);
+                          qs->push_back(std::move(q));
+                      }
+                  },
+                  n_elements * 16u);
+    }
+}
+
+// Merging of symbol sets and computation of the positions of the symbols of a set in another one. The sets
+// share half of their symbols.
+static void register_symbol_set(benchmark_suite &suite)
+{
+    for (const std::size_t size : {8u, 64u}) {
+        auto ss = std::make_shared<std::pair<symbol_set, symbol_set>>();
+        auto setup = [ss, size]() {
+            if (ss->first.size()) {
+                return;
+            }
+            for (std::size_t i = 0u; i < size; ++i) {
+                ss->first.add(symbol("x" + std::to_string(2u * i)));
+                ss->second.add(symbol("x" + std::to_string(i)));
+            }
+        };
+        const auto suffix = "_" + std::to_string(size);
+        suite.add("symbol_set_merge" + suffix,
+                  [ss]() {
+                      std::size_t s = 0u;
+                      for (std::size_t r = 0u; r < n_elements * 16u; ++r) {
+                          s += ss->first.merge(ss->second).size();
+                      }
+                      sink = s;
+                  },
+                  setup, n_elements * 16u);
+        suite.add("symbol_set_positions" + suffix,
+                  [ss]() {
+                      std::size_t s = 0u;
+                      for (std::size_t r = 0u; r < n_elements * 16u; ++r) {
+                          s += symbol_set::positions(ss->first, ss->second).size();
+                      }
+                      sink = s;
+                  },
+                  setup, n_elements * 16u);
+    }
+}
+
+// Round-trip latency of a trivial task enqueued in the thread pool (the tasks are distributed among all the threads
+// in the pool), throughput of batches of trivial tasks via enqueue() and parallel_for(), fork-join latency of
+// parallel_for() loops with one iteration per thread, and contention on an atomic_flag_array used as an array of
+// spinlocks (as in the multi-threaded series multiplication), with different numbers of flags. In the latter case,
+// the operations are split among the threads.
+static void register_threading(benchmark_suite &suite)
+{
+    suite.add("thread_pool_enqueue",
+              []() {
+                  const auto n = thread_pool::size();
+                  for (std::size_t i = 0u; i < n_elements; ++i) {
+                      thread_pool::enqueue(static_cast<unsigned>(i % n), []() {}).get();
+                  }
+              },
+              benchmark_suite::func_type{}, n_elements);
+    suite.add("thread_pool_enqueue_batch",
+              []() {
+                  const auto n = thread_pool::size();
+                  auto empty_task = []() {};
+                  future_list<decltype(empty_task())> f_list;
+                  for (std::size_t i = 0u; i < n_elements; ++i) {
+                      f_list.push_back(thread_pool::enqueue(static_cast<unsigned>(i % n), empty_task));
+                  }
+                  f_list.wait_all();
+                  f_list.get_all();
+              },
+              benchmark_suite::func_type{}, n_elements);
+    suite.add("thread_pool_parallel_for",
+              []() {
+                  std::atomic<std::size_t> c(0u);
+                  thread_pool::parallel_for(0u, n_elements, 1u, [&c](std::size_t b, std::size_t e) { c += e - b; });
+                  sink = c.load();
+              },
+              benchmark_suite::func_type{}, n_elements);
+    suite.add("thread_pool_fork_join",
+              []() {
+                  const auto n = thread_pool::size();
+                  std::atomic<std::size_t> c(0u);
+                  for (std::size_t i = 0u; i < n_rounds; ++i) {
+                      thread_pool::parallel_for(0u, n, 1u, [&c](std::size_t b, std::size_t e) { c += e - b; });
+                  }
+                  sink = c.load();
+              },
+              benchmark_suite::func_type{}, n_rounds);
+    const std::size_t n_locks = n_elements * n_rounds;
+    for (const std::size_t size : {1u, 64u, 65536u}) {
+        suite.add("atomic_flag_array_contention_" + std::to_string(size),
+                  [size, n_locks]() {
+                      detail::atomic_flag_array af(size);
+                      const auto n_threads = settings::get_n_threads();
+                      std::atomic<std::size_t> total(0u);
+                      simple_timer t;
+                      thread_pool::parallel_for(0u, n_threads, 1u, [&](std::size_t i_start, std::size_t i_end) {
+                          for (auto idx_t = i_start; idx_t < i_end; ++idx_t) {
+                              const auto n = n_locks / n_threads + (idx_t ? 0u : n_locks % n_threads);
+                              std::size_t s = 0u;
+                              for (std::size_t i = 0u; i < n; ++i) {
+                                  const auto idx = (i * 2654435761u + idx_t) % size;
+                                  while (af[idx].test_and_set(std::memory_order_acquire)) {
+                                  }
+                                  s += idx;
+                                  af[idx].clear(std::memory_order_release);
+                              }
+                              total += s;
+                          }
+                      });
+                      sink = total.load();
+                  },
+                  benchmark_suite::func_type{}, n_locks);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    init();
+    benchmark_suite suite;
+    register_hash_set(suite);
+    register_kronecker_array(suite);
+    register_vectors(suite);
+    register_mp_integer(suite);
+    register_mp_rational(suite);
+    register_symbol_set(suite);
+    register_threading(suite);
+    return benchmark_main(argc, argv, suite);
+}
@@ -0,0 +1,173 @@
+/* Copyright 2009-2016 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#include "../src/mod_int.hpp"
+
+#define BOOST_TEST_MODULE mod_int_test
+#include <boost/test/included/unit_test.hpp>
+
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+
+#include "../src/exceptions.hpp"
+#include "../src/init.hpp"
+#include "../src/is_cf.hpp"
+#include "../src/kronecker_monomial.hpp"
+#include "../src/math.hpp"
+#include "../src/mp_integer.hpp"
+#include "../src/polynomial.hpp"
+#include "../src/settings.hpp"
+#include "../src/tuning.hpp"
+
+using namespace piranha;
+
+static const std::uint_least64_t p0 = 9223372036854775783ull;
+
+using m0 = mod_int<p0>;
+using m7 = mod_int<7u>;
+
+static std::mt19937 rng;
+
+BOOST_AUTO_TEST_CASE(mod_int_basic_test)
+{
+    init();
+    BOOST_CHECK(is_cf<m0>::value);
+    BOOST_CHECK(is_cf<m7>::value);
+    BOOST_CHECK((has_multiply_accumulate<m0>::value));
+    BOOST_CHECK((!std::is_constructible<m0, double>::value));
+    BOOST_CHECK((!std::is_constructible<m0, bool>::value));
+    BOOST_CHECK_EQUAL(m7::modulus(), 7u);
+    BOOST_CHECK_EQUAL(m7{}.get_value(), 0u);
+    BOOST_CHECK(m7{}.is_zero());
+    BOOST_CHECK(math::is_zero(m7{}));
+    BOOST_CHECK(!math::is_zero(m7{1}));
+    BOOST_CHECK_EQUAL(m7{10}.get_value(), 3u);
+    BOOST_CHECK_EQUAL(m7{-1}.get_value(), 6u);
+    BOOST_CHECK_EQUAL(m7{-14}.get_value(), 0u);
+    BOOST_CHECK_EQUAL(m7{std::numeric_limits<long long>::min()}.get_value(),
+                      (7u - (9223372036854775808ull % 7u)) % 7u);
+    BOOST_CHECK_EQUAL(m7{std::numeric_limits<unsigned long long>::max()}.get_value(),
+                      std::numeric_limits<unsigned long long>::max() % 7u);
+    BOOST_CHECK_EQUAL(m7{integer(-22)}.get_value(), 6u);
+    BOOST_CHECK_EQUAL(m0{integer(p0) * 3 + 5}.get_value(), 5u);
+    BOOST_CHECK_EQUAL(m0{-integer(p0) * 3 - 5}.get_value(), p0 - 5u);
+    BOOST_CHECK_EQUAL(m0{p0 - 1u}.get_value(), p0 - 1u);
+    // Arithmetics.
+    BOOST_CHECK_EQUAL((m7{3} + m7{5}).get_value(), 1u);
+    BOOST_CHECK_EQUAL((m7{3} - m7{5}).get_value(), 5u);
+    BOOST_CHECK_EQUAL((m7{3} * m7{5}).get_value(), 1u);
+    BOOST_CHECK_EQUAL((-m7{3}).get_value(), 4u);
+    BOOST_CHECK_EQUAL((-m7{}).get_value(), 0u);
+    BOOST_CHECK_EQUAL((+m7{3}).get_value(), 3u);
+    BOOST_CHECK_EQUAL((m7{3} + 5).get_value(), 1u);
+    BOOST_CHECK_EQUAL((5 - m7{3}).get_value(), 2u);
+    BOOST_CHECK_EQUAL((m7{3} * -1).get_value(), 4u);
+    BOOST_CHECK(m7{3} == 10);
+    BOOST_CHECK(-4 == m7{3});
+    BOOST_CHECK(m7{3} != 4u);
+    BOOST_CHECK(m7{3} != m7{4});
+    m7 a{2};
+    a += m7{6};
+    BOOST_CHECK(a == 1);
+    a -= m7{2};
+    BOOST_CHECK(a == 6);
+    a *= m7{6};
+    BOOST_CHECK(a == 1);
+    math::multiply_accumulate(a, m7{3}, m7{4});
+    BOOST_CHECK(a == 6);
+    math::negate(a);
+    BOOST_CHECK(a == 1);
+    BOOST_CHECK(m7{3}.pow(0u) == 1);
+    BOOST_CHECK(m7{3}.pow(6u) == 1);
+    BOOST_CHECK(m7{3}.pow(5u) == 5);
+    BOOST_CHECK(m7{3}.inverse() == 5);
+    BOOST_CHECK_THROW(m7{}.inverse(), zero_division_error);
+    std::ostringstream oss;
+    oss << m0{-1};
+    BOOST_CHECK_EQUAL(oss.str(), "9223372036854775782");
+}
+
+BOOST_AUTO_TEST_CASE(mod_int_random_test)
+{
+    // Check the Montgomery arithmetic against mp_integer.
+    std::uniform_int_distribution<long long> dist(std::numeric_limits<long long>::min());
+    const integer p(p0);
+    auto canon = [&p](const integer &n) {
+        auto r = n % p;
+        if (r.sign() < 0) {
+            r += p;
+        }
+        return static_cast<std::uint_least64_t>(r);
+    };
+    for (int i = 0; i < 10000; ++i) {
+        const long long x = dist(rng), y = dist(rng);
+        const integer ix(x), iy(y);
+        const m0 mx(x), my(y);
+        BOOST_CHECK_EQUAL(mx.get_value(), canon(ix));
+        BOOST_CHECK_EQUAL((mx + my).get_value(), canon(ix + iy));
+        BOOST_CHECK_EQUAL((mx - my).get_value(), canon(ix - iy));
+        BOOST_CHECK_EQUAL((mx * my).get_value(), canon(ix * iy));
+        if (!mx.is_zero()) {
+            BOOST_CHECK((mx * mx.inverse()) == 1);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(mod_int_crt_multiplication_test)
+{
+    using p_type = polynomial<integer, k_monomial>;
+    p_type x{"x"}, y{"y"}, z{"z"}, t{"t"};
+    auto f = 1 + x + y + z + t;
+    auto tmp = f;
+    for (int i = 1; i < 10; ++i) {
+        f *= tmp;
+    }
+    auto g = f + 1;
+    // Large coefficients, to need more than one prime.
+    const auto big = integer(1) << 150;
+    auto f_big = f * big - x * big * 3, g_big = -g * big + y;
+    const auto ref1 = f * g, ref2 = f_big * g_big, ref3 = f_big * (g_big * big * big);
+    BOOST_CHECK(ref1.height() < (integer(1) << 60));
+    tuning::set_crt_multiplication(true);
+    for (unsigned nt = 1u; nt <= 3u; ++nt) {
+        settings::set_n_threads(nt);
+        BOOST_CHECK_EQUAL(f * g, ref1);
+        BOOST_CHECK_EQUAL(f_big * g_big, ref2);
+        // More than 8 primes needed, this will go through the standard multiplication.
+        BOOST_CHECK_EQUAL(f_big * (g_big * big * big), ref3);
+        BOOST_CHECK_EQUAL(p_type{} * g, p_type{});
+        BOOST_CHECK_EQUAL(-f * 0, p_type{});
+        // Cancellations.
+        BOOST_CHECK_EQUAL((x * big - y) * (x * big + y), x * x * big * big - y * y);
+    }
+    settings::reset_n_threads();
+    tuning::reset_crt_multiplication();
+}
@@ -32,9 +32,13 @@ see https://www.gnu.org/licenses/. */
 #include <boost/test/included/unit_test.hpp>
 
 #include <boost/algorithm/string/predicate.hpp>
+#include <boost/lexical_cast.hpp>
 #include <limits>
+#include <random>
+#include <string>
 #include <tuple>
 #include <type_traits>
+#include <vector>
 
 #include "../src/config.hpp"
 #include "../src/init.hpp"
@@ -159,3 +163,136 @@ BOOST_AUTO_TEST_CASE(mp_integer_safe_cast_int_test)
 {
     tuple_for_each(size_types{}, safe_cast_int_tester());
 }
+
+struct mac_n_tester {
+    template <typename S>
+    void operator()(const S &) const
+    {
+        using int_type = mp_integer<S::value>;
+        std::mt19937 rng;
+        // Number of bits in a limb of static storage.
+        const unsigned lb = static_cast<unsigned>(detail::si_limb_types<S::value>::limb_bits);
+        // Random values with up to nbits bits and random sign.
+        auto rand_value = [&rng](unsigned nbits) {
+            std::uniform_int_distribution<unsigned> bdist(0u, 1u);
+            int_type retval;
+            for (unsigned i = 0u; i < nbits; ++i) {
+                retval *= 2;
+                retval += bdist(rng);
+            }
+            return bdist(rng) ? retval : -retval;
+        };
+        // Bit sizes of the accumulators and of the multiplicands: a single limb, two limbs (close to
+        // overflowing the static storage) and more than two limbs.
+        const std::vector<unsigned> acc_bits = {0u, 1u, lb / 2u, lb, 2u * lb - 1u, 2u * lb, 3u * lb};
+        const std::vector<unsigned> mul_bits = {0u, 1u, lb / 2u, lb, lb + 1u, 2u * lb};
+        for (auto na : mul_bits) {
+            for (int trial = 0; trial < 20; ++trial) {
+                const int_type a = rand_value(na);
+                std::vector<int_type> acc, b, cmp;
+                for (auto nacc : acc_bits) {
+                    for (auto nb : mul_bits) {
+                        acc.push_back(rand_value(nacc));
+                        b.push_back(rand_value(nb));
+                    }
+                }
+                // Cancellations.
+                acc.push_back(a * b[0u]);
+                b.push_back(-b[0u]);
+                cmp = acc;
+                for (decltype(cmp.size()) i = 0u; i < cmp.size(); ++i) {
+                    cmp[i].multiply_accumulate(a, b[i]);
+                }
+                std::vector<int_type *> acc_ptr;
+                std::vector<const int_type *> b_ptr;
+                for (decltype(acc.size()) i = 0u; i < acc.size(); ++i) {
+                    acc_ptr.push_back(&acc[i]);
+                    b_ptr.push_back(&b[i]);
+                }
+                int_type::mac_n(acc_ptr.data(), a, b_ptr.data(), acc.size());
+                BOOST_CHECK(acc == cmp);
+                // Check that the static/dynamic storage is consistent with the values.
+                for (const auto &n : acc) {
+                    BOOST_CHECK_EQUAL(n, int_type(boost::lexical_cast<std::string>(n)));
+                }
+            }
+        }
+        // Empty arrays.
+        int_type::mac_n(nullptr, int_type(1), nullptr, 0u);
+    }
+};
+
+BOOST_AUTO_TEST_CASE(mp_integer_mac_n_test)
+{
+    tuple_for_each(size_types{}, mac_n_tester());
+}
+
+struct gcd_n_tester {
+    template <typename S>
+    void operator()(const S &) const
+    {
+        using int_type = mp_integer<S::value>;
+        std::mt19937 rng;
+        const unsigned lb = static_cast<unsigned>(detail::si_limb_types<S::value>::limb_bits);
+        auto rand_value = [&rng](unsigned nbits) {
+            std::uniform_int_distribution<unsigned> bdist(0u, 1u);
+            int_type retval;
+            for (unsigned i = 0u; i < nbits; ++i) {
+                retval *= 2;
+                retval += bdist(rng);
+            }
+            return bdist(rng) ? retval : -retval;
+        };
+        const std::vector<unsigned> bits = {0u, 1u, lb / 2u, lb, lb + 1u, 2u * lb, 3u * lb};
+        for (auto nf : bits) {
+            for (int trial = 0; trial < 50; ++trial) {
+                // A common factor, so that the GCD is not trivially 1.
+                const int_type f = rand_value(nf);
+                std::vector<int_type> v;
+                for (auto nv : bits) {
+                    v.push_back(f * rand_value(nv));
+                }
+                int_type cmp, out;
+                std::vector<const int_type *> v_ptr;
+                for (const auto &n : v) {
+                    int_type::gcd(cmp, cmp, n);
+                    v_ptr.push_back(&n);
+                }
+                int_type::gcd_n(out, v_ptr.data(), v.size());
+                // The result is non-negative, regardless of the signs of the arguments.
+                BOOST_CHECK_EQUAL(out, cmp.abs());
+                BOOST_CHECK(out.sign() >= 0);
+                BOOST_CHECK_EQUAL(out, int_type(boost::lexical_cast<std::string>(out)));
+            }
+        }
+        // Early exit.
+        const int_type one(1), huge = int_type(1) << 1000;
+        std::vector<const int_type *> v_ptr = {&one, &huge};
+        int_type out(3);
+        int_type::gcd_n(out, v_ptr.data(), v_ptr.size());
+        BOOST_CHECK_EQUAL(out, 1);
+        BOOST_CHECK(out.is_static());
+        // Negative values.
+        const int_type m6(-6), m4(-4);
+        v_ptr = {&m6, &m4};
+        out = int_type(0);
+        int_type::gcd_n(out, v_ptr.data(), v_ptr.size());
+        BOOST_CHECK_EQUAL(out, 2);
+        v_ptr = {&m6};
+        out = int_type(-9);
+        int_type::gcd_n(out, v_ptr.data(), v_ptr.size());
+        BOOST_CHECK_EQUAL(out, 3);
+        // Empty arrays: out is left unchanged.
+        out = int_type(-7);
+        int_type::gcd_n(out, nullptr, 0u);
+        BOOST_CHECK_EQUAL(out, -7);
+        out = int_type(0);
+        int_type::gcd_n(out, v_ptr.data(), 0u);
+        BOOST_CHECK_EQUAL(out, 0);
+    }
+};
+
+BOOST_AUTO_TEST_CASE(mp_integer_gcd_n_test)
+{
+    tuple_for_each(size_types{}, gcd_n_tester());
+}
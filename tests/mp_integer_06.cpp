@@ -0,0 +1,159 @@
+/* Copyright 2009-2016 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#include "../src/mp_integer.hpp"
+
+#define BOOST_TEST_MODULE mp_integer_06_test
+#include <boost/test/included/unit_test.hpp>
+
+#include <atomic>
+#include <vector>
+
+#include "../src/init.hpp"
+#include "../src/kronecker_monomial.hpp"
+#include "../src/polynomial.hpp"
+#include "../src/settings.hpp"
+#include "../src/thread_pool.hpp"
+
+using namespace piranha;
+
+BOOST_AUTO_TEST_CASE(mp_integer_arena_test)
+{
+    init();
+    // An integer allocated before any arena, to be freed within a scope.
+    auto old = integer(1) << 1000;
+    const auto old_copy = old;
+    const auto big = integer(3) << 500;
+    integer cmp = big;
+    for (int i = 0; i < 100; ++i) {
+        cmp = cmp * big + i;
+    }
+    {
+        mp_integer_arena arena;
+        BOOST_CHECK_EQUAL(arena.size(), 0u);
+        BOOST_CHECK(!mp_integer_arena_scope::is_active());
+        {
+            std::vector<integer> v;
+            {
+                mp_integer_arena_scope scope(arena);
+                BOOST_CHECK(mp_integer_arena_scope::is_active());
+                BOOST_CHECK_EQUAL(old, old_copy);
+                old = integer(0);
+                integer tmp = big;
+                for (int i = 0; i < 100; ++i) {
+                    tmp = tmp * big + i;
+                    v.push_back(tmp);
+                }
+                BOOST_CHECK_EQUAL(tmp, cmp);
+                BOOST_CHECK(arena.size() > 0u);
+                // Nested scopes.
+                mp_integer_arena arena2;
+                {
+                    mp_integer_arena_scope scope2(arena2);
+                    BOOST_CHECK_EQUAL(big * big * big, (integer(27) << 1500));
+                }
+                BOOST_CHECK(arena2.size() > 0u);
+                // Temporaries do not accumulate in the arena.
+                const auto size = arena.size();
+                for (int i = 0; i < 100000; ++i) {
+                    BOOST_CHECK_EQUAL((big * big) >> 1000, 9);
+                }
+                BOOST_CHECK_EQUAL(size, arena.size());
+            }
+            BOOST_CHECK(!mp_integer_arena_scope::is_active());
+            // Values allocated in the arena can be used and modified outside the scope.
+            BOOST_CHECK_EQUAL(v.back(), cmp);
+            v.back() *= v.back();
+            BOOST_CHECK_EQUAL(v.back(), cmp * cmp);
+            v.front() += 1;
+            BOOST_CHECK_EQUAL(v.front(), big * big + 1);
+            // Copies made outside the scope survive the arena.
+            old = v.back();
+        }
+    }
+    BOOST_CHECK_EQUAL(old, cmp * cmp);
+    BOOST_CHECK_EQUAL(big * big * big, (integer(27) << 1500));
+    // The current chunk of an arena is kept across scopes, also after the use of other arenas in the meantime.
+    {
+        mp_integer_arena arena, arena2;
+        std::vector<integer> v;
+        for (int i = 0; i < 1000; ++i) {
+            {
+                mp_integer_arena_scope scope(arena);
+                v.push_back(big * big);
+            }
+            mp_integer_arena_scope scope2(arena2);
+            v.push_back(big * big);
+        }
+        BOOST_CHECK_EQUAL(arena.size(), 1u << 20);
+        BOOST_CHECK_EQUAL(arena2.size(), 1u << 20);
+        v.clear();
+        // Tasks in the thread pool too.
+        mp_integer_arena_scope scope(arena);
+        for (int i = 0; i < 1000; ++i) {
+            BOOST_CHECK_EQUAL(thread_pool::enqueue(0u, [&big]() { return big * big; }).get(), big * big);
+        }
+        BOOST_CHECK(arena.size() <= 2u * (1u << 20));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(mp_integer_arena_series_test)
+{
+    using pt = polynomial<integer, k_monomial>;
+    pt x("x"), y("y"), z("z"), t("t");
+    const integer big = integer(1) << 200;
+    auto f = big * x + y + z * big + t + 1;
+    const auto tmp = f;
+    for (int i = 1; i < 10; ++i) {
+        f *= tmp;
+    }
+    const auto g = f + 1;
+    settings::set_n_threads(1u);
+    const auto cmp = f * g;
+    for (unsigned nt = 1u; nt <= 4u; nt += 3u) {
+        settings::set_n_threads(nt);
+        mp_integer_arena arena;
+        {
+            pt res;
+            {
+                mp_integer_arena_scope scope(arena);
+                res = f * g;
+            }
+            BOOST_CHECK(arena.size() > 0u);
+            BOOST_CHECK_EQUAL(res, cmp);
+        }
+    }
+    // The tasks enqueued in the thread pool inherit the arena of the enqueueing thread.
+    {
+        mp_integer_arena arena;
+        mp_integer_arena_scope scope(arena);
+        BOOST_CHECK(thread_pool::enqueue(0u, []() { return mp_integer_arena_scope::is_active(); }).get());
+    }
+    BOOST_CHECK(!thread_pool::enqueue(0u, []() { return mp_integer_arena_scope::is_active(); }).get());
+    settings::reset_n_threads();
+}
@@ -44,6 +44,7 @@ see https://www.gnu.org/licenses/. */
 #include "../src/config.hpp"
 #include "../src/exceptions.hpp"
 #include "../src/init.hpp"
+#include "../src/math.hpp"
 #include "../src/s11n.hpp"
 
 using namespace piranha;
@@ -228,3 +229,80 @@ BOOST_AUTO_TEST_CASE(mp_rational_msgpack_s11n_test)
 }
 
 #endif
+
+BOOST_AUTO_TEST_CASE(mp_rational_lazy_test)
+{
+    using q_type = mp_rational<>;
+    // Lazy addition and subtraction.
+    q_type q{1, 2};
+    // The denominators do not divide each other.
+    q._lazy_add(q_type{1, 4});
+    BOOST_CHECK_EQUAL(q.num(), 6);
+    BOOST_CHECK_EQUAL(q.den(), 8);
+    BOOST_CHECK(!q.is_canonical());
+    // The denominator of the other operand divides the denominator of q.
+    q._lazy_add(q_type{1, 8});
+    BOOST_CHECK_EQUAL(q.num(), 7);
+    BOOST_CHECK_EQUAL(q.den(), 8);
+    q._lazy_sub(q_type{1, 2});
+    BOOST_CHECK_EQUAL(q.num(), 3);
+    BOOST_CHECK_EQUAL(q.den(), 8);
+    q._lazy_sub(q_type{-1});
+    BOOST_CHECK_EQUAL(q.num(), 11);
+    BOOST_CHECK_EQUAL(q.den(), 8);
+    // Same denominators.
+    q_type r{1, 6};
+    r._lazy_add(q_type{1, 6});
+    BOOST_CHECK_EQUAL(r.num(), 2);
+    BOOST_CHECK_EQUAL(r.den(), 6);
+    r._lazy_add(r);
+    BOOST_CHECK_EQUAL(r.num(), 4);
+    BOOST_CHECK_EQUAL(r.den(), 6);
+    r._lazy_sub(r);
+    BOOST_CHECK(math::is_zero(r));
+    r.canonicalise();
+    BOOST_CHECK_EQUAL(r, 0);
+    BOOST_CHECK_EQUAL(r.den(), 1);
+    // Random accumulations.
+    std::uniform_int_distribution<int> dist(-100, 100);
+    q_type acc, ref;
+    for (int i = 0; i < ntrials; ++i) {
+        const q_type a{dist(rng), (i % 3 == 0) ? 1 : 8}, b{dist(rng), 1 + (i % 7)};
+        ref += a * b;
+        ref -= b;
+        acc._lazy_add(a * b);
+        acc._lazy_sub(b);
+    }
+    acc.canonicalise();
+    BOOST_CHECK_EQUAL(acc, ref);
+    // The lazy mode does not affect the arithmetic operators.
+    BOOST_CHECK(!mp_rational_lazy_scope::is_active());
+    {
+        mp_rational_lazy_scope scope;
+#if defined(PIRANHA_HAVE_THREAD_LOCAL)
+        BOOST_CHECK(mp_rational_lazy_scope::is_active());
+#endif
+        {
+            mp_rational_lazy_scope inner;
+        }
+#if defined(PIRANHA_HAVE_THREAD_LOCAL)
+        BOOST_CHECK(mp_rational_lazy_scope::is_active());
+#endif
+        q = q_type{1, 6} + q_type{1, 3};
+        BOOST_CHECK(q.is_canonical());
+        BOOST_CHECK_EQUAL(q, (q_type{1, 2}));
+        q += q_type{1, 4};
+        BOOST_CHECK(q.is_canonical());
+        BOOST_CHECK_EQUAL(q, (q_type{3, 4}));
+        q -= q_type{1, 12};
+        BOOST_CHECK(q.is_canonical());
+        BOOST_CHECK_EQUAL(q, (q_type{2, 3}));
+        q *= q_type{3, 4};
+        BOOST_CHECK(q.is_canonical());
+        BOOST_CHECK_EQUAL(q, (q_type{1, 2}));
+        math::multiply_accumulate(q, q_type{1, 6}, q_type{3});
+        BOOST_CHECK(q.is_canonical());
+        BOOST_CHECK_EQUAL(q, 1);
+    }
+    BOOST_CHECK(!mp_rational_lazy_scope::is_active());
+}
@@ -0,0 +1,210 @@
+/* Copyright 2009-2016 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#include "../src/multiplication_statistics.hpp"
+
+#define BOOST_TEST_MODULE multiplication_statistics_test
+#include <boost/test/included/unit_test.hpp>
+
+#include <numeric>
+
+#include "../src/config.hpp"
+#include "../src/init.hpp"
+#include "../src/kronecker_monomial.hpp"
+#include "../src/math.hpp"
+#include "../src/monomial.hpp"
+#include "../src/mp_integer.hpp"
+#include "../src/mp_rational.hpp"
+#include "../src/polynomial.hpp"
+#include "../src/settings.hpp"
+#include "../src/tuning.hpp"
+
+using namespace piranha;
+
+using p_type = polynomial<integer, k_monomial>;
+using pm_type = polynomial<integer, monomial<int>>;
+
+// Checks valid for any multiplication.
+static inline void check_common(const multiplication_statistics &st, unsigned n_threads)
+{
+    BOOST_CHECK_EQUAL(st.n_threads, n_threads);
+    BOOST_CHECK_EQUAL(st.thread_busy_times.size(), n_threads);
+    BOOST_CHECK_EQUAL(st.thread_task_counts.size(), n_threads);
+    BOOST_CHECK(st.size1 >= st.size2);
+    BOOST_CHECK(st.n_term_products <= st.size1 * st.size2);
+    BOOST_CHECK(st.bucket_count >= st.initial_bucket_count);
+    BOOST_CHECK(st.total_time >= 0.);
+    for (const auto &t : st.thread_busy_times) {
+        BOOST_CHECK(t >= 0.);
+        BOOST_CHECK(t <= st.total_time);
+    }
+    if (st.bucket_count) {
+        BOOST_CHECK_EQUAL(st.load_factor, static_cast<double>(st.actual_size) / static_cast<double>(st.bucket_count));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(multiplication_statistics_disabled_test)
+{
+    init();
+    BOOST_CHECK(!multiplication_instrumentation::get_enabled());
+    const auto st0 = multiplication_statistics();
+    BOOST_CHECK_EQUAL(st0.n_threads, 0u);
+    BOOST_CHECK_EQUAL(st0.size1, 0u);
+    BOOST_CHECK(!st0.estimated);
+    BOOST_CHECK_EQUAL(st0.total_time, 0.);
+    BOOST_CHECK(st0.zone_sizes.empty());
+    p_type x{"x"}, y{"y"};
+    BOOST_CHECK_EQUAL((x + y) * (x - y), x * x - y * y);
+    BOOST_CHECK_EQUAL(multiplication_instrumentation::get_last_statistics().n_threads, 0u);
+    multiplication_instrumentation::set_enabled(true);
+    BOOST_CHECK(multiplication_instrumentation::get_enabled());
+    multiplication_instrumentation::reset_enabled();
+    BOOST_CHECK(!multiplication_instrumentation::get_enabled());
+}
+
+BOOST_AUTO_TEST_CASE(multiplication_statistics_serial_test)
+{
+    multiplication_instrumentation::set_enabled(true);
+    settings::set_n_threads(1u);
+    p_type x{"x"}, y{"y"}, z{"z"};
+    // Small multiplication, without estimation.
+    auto res = (x + y + 1) * (x - y + 1);
+    auto st = multiplication_instrumentation::get_last_statistics();
+    check_common(st, 1u);
+    BOOST_CHECK_EQUAL(st.size1, 3u);
+    BOOST_CHECK_EQUAL(st.size2, 3u);
+    BOOST_CHECK_EQUAL(st.n_term_products, 9u);
+    BOOST_CHECK(!st.estimated);
+    BOOST_CHECK_EQUAL(st.estimated_size, 0u);
+    BOOST_CHECK_EQUAL(st.actual_size, res.size());
+    BOOST_CHECK_EQUAL(st.initial_bucket_count, 0u);
+#if defined(PIRANHA_HAVE_THREAD_LOCAL)
+    // The table grows from zero buckets by doubling its size.
+    unsigned long long n_doublings = 1u;
+    for (unsigned long long b = 1u; b < st.bucket_count; b *= 2u) {
+        ++n_doublings;
+    }
+    BOOST_CHECK_EQUAL(st.n_rehashes, n_doublings);
+#endif
+    BOOST_CHECK_EQUAL(st.n_cancellations, 0u);
+    BOOST_CHECK_EQUAL(st.thread_task_counts[0], 1u);
+    BOOST_CHECK(st.zone_sizes.empty());
+    BOOST_CHECK_EQUAL(st.n_dynamic_cfs_operands, 0u);
+    BOOST_CHECK_EQUAL(st.n_dynamic_cfs, 0u);
+    // Force the estimation: the Kronecker multiplication is used, and the cancellations
+    // are removed by the sanitisation.
+    tuning::set_estimate_threshold(0u);
+    res = (x + y) * (x - y);
+    st = multiplication_instrumentation::get_last_statistics();
+    BOOST_CHECK_EQUAL(res, x * x - y * y);
+    check_common(st, 1u);
+    BOOST_CHECK(st.estimated);
+    BOOST_CHECK(st.estimated_size > 0u);
+    BOOST_CHECK_EQUAL(st.actual_size, 2u);
+    BOOST_CHECK_EQUAL(st.n_cancellations, 1u);
+    BOOST_CHECK(st.initial_bucket_count > 0u);
+#if defined(PIRANHA_HAVE_THREAD_LOCAL)
+    BOOST_CHECK_EQUAL(st.n_rehashes, 1u);
+#endif
+    BOOST_CHECK(st.thread_task_counts[0] > 0u);
+    tuning::reset_estimate_threshold();
+    // Dynamic coefficients.
+    const integer big = integer(1) << 200;
+    res = (x * big + 1) * (y * big + 1);
+    st = multiplication_instrumentation::get_last_statistics();
+    BOOST_CHECK_EQUAL(st.n_dynamic_cfs_operands, 2u);
+    BOOST_CHECK_EQUAL(st.n_dynamic_cfs, 3u);
+    // Plain multiplication with a truncation limit.
+    p_type::set_auto_truncate_degree(2);
+    res = math::pow(x + y + z + 1, 2) * math::pow(x + y + z + 1, 2);
+    st = multiplication_instrumentation::get_last_statistics();
+    check_common(st, 1u);
+    BOOST_CHECK(st.n_term_products < st.size1 * st.size2);
+    p_type::unset_auto_truncate_degree();
+    // Series with series coefficients: the statistics of the outer multiplication are the last ones.
+    using pp_type = polynomial<p_type, k_monomial>;
+    pp_type a{"a"}, b{"b"};
+    auto res2 = (a * x + b * y + 1) * (a * y + 1);
+    st = multiplication_instrumentation::get_last_statistics();
+    BOOST_CHECK_EQUAL(st.size1, 3u);
+    BOOST_CHECK_EQUAL(st.size2, 2u);
+    BOOST_CHECK_EQUAL(st.actual_size, res2.size());
+    // Clearing and disabling.
+    multiplication_instrumentation::clear_last_statistics();
+    BOOST_CHECK_EQUAL(multiplication_instrumentation::get_last_statistics().n_threads, 0u);
+    multiplication_instrumentation::reset_enabled();
+    res = (x + 1) * (y + 1);
+    BOOST_CHECK_EQUAL(multiplication_instrumentation::get_last_statistics().n_threads, 0u);
+    settings::reset_n_threads();
+}
+
+BOOST_AUTO_TEST_CASE(multiplication_statistics_parallel_test)
+{
+    multiplication_instrumentation::set_enabled(true);
+    settings::set_min_work_per_thread(1000u);
+    for (unsigned n = 2u; n <= 4u; ++n) {
+        settings::set_n_threads(n);
+        // Kronecker multiplication.
+        {
+            p_type x{"x"}, y{"y"}, z{"z"};
+            const auto f = math::pow(x + y + z + 1, 10);
+            const auto res = f * (f - 1);
+            const auto st = multiplication_instrumentation::get_last_statistics();
+            check_common(st, n);
+            BOOST_CHECK(st.estimated);
+            BOOST_CHECK_EQUAL(st.actual_size, res.size());
+            BOOST_CHECK_EQUAL(st.n_term_products, st.size1 * st.size2);
+            BOOST_CHECK_EQUAL(st.size1, f.size());
+            BOOST_CHECK(!st.zone_sizes.empty());
+            BOOST_CHECK_EQUAL(st.zone_sizes.size() % n, 0u);
+            BOOST_CHECK_EQUAL(std::accumulate(st.zone_sizes.begin(), st.zone_sizes.end(), 0ull), st.n_term_products);
+            // Each zone is consumed by exactly one thread (but a thread might consume no zones).
+            BOOST_CHECK_EQUAL(std::accumulate(st.thread_task_counts.begin(), st.thread_task_counts.end(), 0ull),
+                              st.zone_sizes.size());
+        }
+        // Plain multiplication.
+        {
+            pm_type x{"x"}, y{"y"}, z{"z"};
+            const auto f = math::pow(x + y + z + 1, 10);
+            const auto res = f * (1 - f);
+            const auto st = multiplication_instrumentation::get_last_statistics();
+            check_common(st, n);
+            BOOST_CHECK(st.estimated);
+            BOOST_CHECK_EQUAL(st.actual_size, res.size());
+            BOOST_CHECK_EQUAL(st.n_term_products, st.size1 * st.size2);
+            BOOST_CHECK_EQUAL(st.size1, f.size());
+            BOOST_CHECK(st.zone_sizes.empty());
+            for (const auto &c : st.thread_task_counts) {
+                BOOST_CHECK_EQUAL(c, 1u);
+            }
+        }
+    }
+    settings::reset_min_work_per_thread();
+    settings::reset_n_threads();
+    multiplication_instrumentation::reset_enabled();
+}
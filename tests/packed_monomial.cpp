@@ -0,0 +1,352 @@
+/* Copyright 2009-2016 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#include "../src/packed_monomial.hpp"
+
+#define BOOST_TEST_MODULE packed_monomial_test
+#include <boost/test/included/unit_test.hpp>
+
+#include <array>
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/archive/text_iarchive.hpp>
+#include <boost/archive/text_oarchive.hpp>
+#include <boost/lexical_cast.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <unordered_set>
+#include <vector>
+
+#include "../src/config.hpp"
+#include "../src/init.hpp"
+#include "../src/is_key.hpp"
+#include "../src/key_is_multipliable.hpp"
+#include "../src/kronecker_monomial.hpp"
+#include "../src/math.hpp"
+#include "../src/mp_integer.hpp"
+#include "../src/mp_rational.hpp"
+#include "../src/polynomial.hpp"
+#include "../src/s11n.hpp"
+#include "../src/safe_cast.hpp"
+#include "../src/settings.hpp"
+#include "../src/symbol.hpp"
+#include "../src/symbol_set.hpp"
+#include "../src/term.hpp"
+#include "../src/type_traits.hpp"
+
+using namespace piranha;
+
+using key_types = std::tuple<packed_monomial<unsigned short, 4u>, packed_monomial<unsigned, 7u>, packed_monomial<>,
+                             packed_monomial<unsigned long long, 16u>, packed_monomial<unsigned long long, 12u>>;
+
+static std::mt19937 rng;
+
+struct basic_tester {
+    template <typename P>
+    void operator()(const P &) const
+    {
+        using p_type = P;
+        using T = typename p_type::value_type;
+        const unsigned W = p_type::field_width;
+        BOOST_CHECK(is_key<p_type>::value);
+        BOOST_CHECK(key_has_degree<p_type>::value);
+        BOOST_CHECK(key_has_ldegree<p_type>::value);
+        BOOST_CHECK(key_is_differentiable<p_type>::value);
+        BOOST_CHECK((key_is_multipliable<integer, p_type>::value));
+        BOOST_CHECK((key_is_multipliable<double, p_type>::value));
+        BOOST_CHECK(is_hashable<p_type>::value);
+        BOOST_CHECK(p_type::max_size == std::numeric_limits<T>::digits / W);
+        symbol_set ss0, ss2({symbol("x"), symbol("y")}), ss3({symbol("w"), symbol("x"), symbol("y")}),
+            ss4({symbol("a"), symbol("b"), symbol("c"), symbol("d")});
+        // Construction.
+        p_type m0;
+        BOOST_CHECK(m0.is_compatible(ss0));
+        BOOST_CHECK(m0.is_compatible(ss4));
+        BOOST_CHECK(m0.is_unitary(ss4));
+        BOOST_CHECK(p_type(ss4) == m0);
+        p_type m1{1, 2};
+        BOOST_CHECK(m1.is_compatible(ss2));
+        BOOST_CHECK(!m1.is_compatible(ss0));
+        BOOST_CHECK(!m1.is_unitary(ss2));
+        BOOST_CHECK_THROW(m1.is_unitary(ss0), std::invalid_argument);
+        std::vector<int> v{1, 2};
+        BOOST_CHECK(p_type(v.begin(), v.end(), ss2) == m1);
+        BOOST_CHECK_THROW(p_type(v.begin(), v.end(), ss4), std::invalid_argument);
+        BOOST_CHECK(p_type(m1, ss2) == m1);
+        BOOST_CHECK_THROW(p_type(m1, ss0), std::invalid_argument);
+        // Exponents out of range and negative exponents.
+        const T max2 = static_cast<T>((T(1) << (W - 1u)) - 1u);
+        BOOST_CHECK_NO_THROW((p_type{max2, max2}));
+        BOOST_CHECK_THROW((p_type{max2, static_cast<T>(max2 + 1u)}), std::invalid_argument);
+        BOOST_CHECK_THROW((p_type{-1, 2}), safe_cast_failure);
+        std::vector<int> too_many(p_type::max_size + 1u, 0);
+        BOOST_CHECK_THROW(p_type(too_many.begin(), too_many.end()), std::bad_alloc);
+        // A set guard bit makes the value incompatible.
+        BOOST_CHECK(!p_type(static_cast<T>(max2 + 1u)).is_compatible(ss2));
+        // Unpacking.
+        auto u = m1.unpack(ss2);
+        BOOST_CHECK(u.size() == 2u && u[0u] == T(1) && u[1u] == T(2));
+        // Equality, hashing and ordering.
+        BOOST_CHECK(m1 == (p_type{1, 2}));
+        BOOST_CHECK(m1 != (p_type{1, 3}));
+        BOOST_CHECK(m1.hash() == (p_type{1, 2}).hash());
+        BOOST_CHECK(m1.hash() == std::hash<p_type>{}(m1));
+        std::unordered_set<p_type> us{p_type{1, 2}, p_type{2, 1}, p_type{1, 2}};
+        BOOST_CHECK(us.size() == 2u);
+        // The ordering is lexicographic starting from the last exponent.
+        BOOST_CHECK(m1 < (p_type{0, 3}));
+        BOOST_CHECK(m1 < (p_type{2, 2}));
+        BOOST_CHECK(!(m1 < (p_type{2, 1})));
+        BOOST_CHECK(!(m1 < m1));
+        // Degree.
+        BOOST_CHECK(m1.degree(ss2) == 3);
+        BOOST_CHECK(m1.ldegree(ss2) == 3);
+        BOOST_CHECK(m0.degree(ss0) == 0);
+        BOOST_CHECK_THROW(m1.degree(ss0), std::invalid_argument);
+        BOOST_CHECK(m1.degree(symbol_set::positions(ss2, symbol_set{symbol("y")}), ss2) == 2);
+        BOOST_CHECK(m1.ldegree(symbol_set::positions(ss2, symbol_set{symbol("x")}), ss2) == 1);
+        // Multiplication and division.
+        p_type res;
+        p_type::multiply(res, m1, p_type{3, 4}, ss2);
+        BOOST_CHECK(res == (p_type{4, 6}));
+        p_type::divide(res, res, p_type{3, 4}, ss2);
+        BOOST_CHECK(res == m1);
+        BOOST_CHECK_THROW(p_type::divide(res, m1, p_type{0, 3}, ss2), std::invalid_argument);
+        BOOST_CHECK_THROW(p_type::divide(res, m1, p_type{2, 0}, ss2), std::invalid_argument);
+        BOOST_CHECK(res == m1);
+        BOOST_CHECK_THROW(p_type::multiply(res, p_type{max2, T(0)}, p_type{T(1), T(0)}, ss2), std::overflow_error);
+        BOOST_CHECK_THROW(p_type::multiply(res, p_type{T(0), max2}, p_type{T(0), T(1)}, ss2), std::overflow_error);
+        p_type::multiply(res, p_type{static_cast<T>(max2 - 1u), T(0)}, p_type{T(1), max2}, ss2);
+        BOOST_CHECK(res == (p_type{max2, max2}));
+        T g_mask(0);
+        for (unsigned j = 0u; j < p_type::max_size; ++j) {
+            g_mask = static_cast<T>(g_mask | (T(1) << (j * W + W - 1u)));
+        }
+        BOOST_CHECK(p_type::get_guard_mask() == g_mask);
+        // Additivity of the hash.
+        BOOST_CHECK(res.hash() == static_cast<std::size_t>((p_type{max2, max2}).hash()));
+        BOOST_CHECK(res.hash() == static_cast<std::size_t>((p_type{static_cast<T>(max2 - 1u), T(0)}).hash()
+                                                           + (p_type{T(1), max2}).hash()));
+        using term_type = term<integer, p_type>;
+        std::array<term_type, 1u> tres;
+        p_type::multiply(tres, term_type{integer(2), m1}, term_type{integer(3), p_type{1, 1}}, ss2);
+        BOOST_CHECK(tres[0u].m_cf == 6);
+        BOOST_CHECK(tres[0u].m_key == (p_type{2, 3}));
+        // Merge args and trim.
+        auto m2 = m1.merge_args(ss2, ss3);
+        BOOST_CHECK(m2 == (p_type{0, 1, 2}));
+        BOOST_CHECK_THROW(m1.merge_args(ss2, ss2), std::invalid_argument);
+        symbol_set cands({symbol("w"), symbol("x")});
+        m2.trim_identify(cands, ss3);
+        BOOST_CHECK(cands == symbol_set({symbol("w")}));
+        BOOST_CHECK(m2.trim(cands, ss3) == m1);
+        // Printing.
+        std::ostringstream oss;
+        m1.print(oss, ss2);
+        BOOST_CHECK_EQUAL(oss.str(), "x*y**2");
+        oss.str("");
+        m1.print_tex(oss, ss2);
+        BOOST_CHECK_EQUAL(oss.str(), "{x}{y}^{2}");
+        // Linear argument, pow, partial, integrate.
+        BOOST_CHECK_EQUAL((p_type{0, 1}.linear_argument(ss2)), "y");
+        BOOST_CHECK_THROW(m1.linear_argument(ss2), std::invalid_argument);
+        BOOST_CHECK(m1.pow(2, ss2) == (p_type{2, 4}));
+        BOOST_CHECK_THROW(m1.pow(max2, ss2), std::invalid_argument);
+        auto p = m1.partial(symbol_set::positions(ss2, symbol_set{symbol("y")}), ss2);
+        BOOST_CHECK(p.first == T(2) && p.second == (p_type{1, 1}));
+        auto i = m1.integrate(symbol("z"), ss2);
+        BOOST_CHECK(i.first == T(1) && i.second == (p_type{1, 2, 1}));
+        i = m1.integrate(symbol("x"), ss2);
+        BOOST_CHECK(i.first == T(2) && i.second == (p_type{2, 2}));
+        BOOST_CHECK_THROW((p_type{max2, T(0)}.integrate(symbol("x"), ss2)), std::invalid_argument);
+        // Evaluation and substitution.
+        BOOST_CHECK_EQUAL(m1.evaluate(symbol_set::positions_map<integer>(ss2, {{symbol("x"), integer(2)},
+                                                                              {symbol("y"), integer(3)}}),
+                                      ss2),
+                          18);
+        auto s = m1.subs("y", integer(2), ss2);
+        BOOST_CHECK(s.size() == 1u && s[0u].first == 4 && s[0u].second == (p_type{T(1), T(0)}));
+        // Split and extraction.
+        auto sp = m1.split(ss2);
+        BOOST_CHECK(sp.first == p_type{2} && sp.second == p_type{1});
+        std::vector<T> out;
+        m1.extract_exponents(out, ss2);
+        BOOST_CHECK((out == std::vector<T>{T(1), T(2)}));
+        BOOST_CHECK(!m1.has_negative_exponent(ss2));
+    }
+};
+
+BOOST_AUTO_TEST_CASE(packed_monomial_basic_test)
+{
+    init();
+    tuple_for_each(key_types{}, basic_tester());
+    // Integration when all the fields are in use.
+    using p_type = packed_monomial<unsigned char, 2u>;
+    symbol_set ss4({symbol("a"), symbol("b"), symbol("c"), symbol("d")});
+    BOOST_CHECK_THROW((p_type{1, 1, 1, 1}.integrate(symbol("e"), ss4)), std::invalid_argument);
+    BOOST_CHECK((p_type{0, 1, 1, 1}.integrate(symbol("a"), ss4).second == p_type{1, 1, 1, 1}));
+}
+
+struct degree_tester {
+    template <typename P>
+    void operator()(const P &) const
+    {
+        using p_type = P;
+        using T = typename p_type::value_type;
+        const unsigned w = p_type::field_width;
+        symbol_set ss;
+        for (std::size_t n = 1u; n <= p_type::max_size; ++n) {
+            ss.add(symbol(std::string("x") + boost::lexical_cast<std::string>(n)));
+            std::uniform_int_distribution<unsigned long long> dist(0u, (1ull << (w - 1u)) - 1u);
+            for (int k = 0; k < 100; ++k) {
+                std::vector<T> v;
+                unsigned long long deg = 0u;
+                for (std::size_t j = 0u; j < n; ++j) {
+                    v.push_back(static_cast<T>(dist(rng)));
+                    deg += v.back();
+                }
+                // Include the maximum values at least once.
+                if (k == 0) {
+                    deg = 0u;
+                    for (auto &x : v) {
+                        x = static_cast<T>((1ull << (w - 1u)) - 1u);
+                        deg += x;
+                    }
+                }
+                p_type m(v.begin(), v.end(), ss);
+                BOOST_CHECK(m.is_compatible(ss));
+                BOOST_CHECK_EQUAL(static_cast<unsigned long long>(m.degree(ss)), deg);
+                auto u = m.unpack(ss);
+                BOOST_CHECK(std::equal(u.begin(), u.end(), v.begin()));
+            }
+        }
+    }
+};
+
+BOOST_AUTO_TEST_CASE(packed_monomial_degree_test)
+{
+    tuple_for_each(key_types{}, degree_tester());
+    tuple_for_each(std::tuple<packed_monomial<unsigned char, 2u>, packed_monomial<unsigned char, 3u>,
+                              packed_monomial<unsigned long long, 2u>, packed_monomial<unsigned long long, 64u>>{},
+                   degree_tester());
+}
+
+BOOST_AUTO_TEST_CASE(packed_monomial_polynomial_test)
+{
+    using p_type = polynomial<integer, packed_monomial<std::uint_least64_t, 16u>>;
+    using pk_type = polynomial<integer, kronecker_monomial<>>;
+    // Compare against Kronecker monomials.
+    p_type x{"x"}, y{"y"}, z{"z"};
+    pk_type xk{"x"}, yk{"y"}, zk{"z"};
+    auto f = math::pow(1 + x + y + z, 10), g = math::pow(1 - x - y + z, 10);
+    auto fk = math::pow(1 + xk + yk + zk, 10), gk = math::pow(1 - xk - yk + zk, 10);
+    auto h = f * g;
+    auto hk = fk * gk;
+    BOOST_CHECK_EQUAL(h.size(), hk.size());
+    BOOST_CHECK_EQUAL(h.degree(), hk.degree());
+    const auto h_val = h.subs("x", integer(2)).subs("y", integer(3)).subs("z", integer(5));
+    const auto hk_val = hk.subs("x", integer(2)).subs("y", integer(3)).subs("z", integer(5));
+    BOOST_CHECK_EQUAL(boost::lexical_cast<std::string>(h_val), boost::lexical_cast<std::string>(hk_val));
+    // Exact division.
+    BOOST_CHECK(h / f == g);
+    auto ux = math::pow(1 + x, 10), uy = math::pow(1 - 2 * x, 5);
+    BOOST_CHECK(p_type::udivrem(ux * uy, uy).first == ux);
+    BOOST_CHECK(math::is_zero(p_type::udivrem(ux * uy, uy).second));
+    // Overflow detection in the multiplier, both in the single-threaded and in the multi-threaded case.
+    // Each exponent has 16 bits, one of which is the guard bit.
+    const auto max_expo = (1ll << 15) - 1;
+    auto big = math::pow(x, max_expo) * y * z;
+    BOOST_CHECK_THROW(big * x, std::overflow_error);
+    BOOST_CHECK_THROW(big * (x + y + z), std::overflow_error);
+    BOOST_CHECK_NO_THROW(big * (y + z));
+    for (unsigned nt = 1u; nt <= 4u; ++nt) {
+        settings::set_n_threads(nt);
+        p_type tmp1, tmp2;
+        for (int i = 0; i < 200; ++i) {
+            tmp1 += math::pow(x, max_expo - i) * math::pow(y, i);
+            tmp2 += math::pow(y, i) * math::pow(z, i);
+        }
+        BOOST_CHECK_NO_THROW(tmp1 * tmp2);
+        BOOST_CHECK_EQUAL((tmp1 * tmp2).size(), 200u * 200u);
+        tmp2 += math::pow(x, 200);
+        BOOST_CHECK_THROW(tmp1 * tmp2, std::overflow_error);
+    }
+    settings::reset_n_threads();
+}
+
+template <typename OArchive, typename IArchive, typename T>
+static inline void boost_roundtrip(const T &x, const symbol_set &args)
+{
+    using w_type = boost_s11n_key_wrapper<T>;
+    std::stringstream ss;
+    {
+        OArchive oa(ss);
+        boost_save(oa, w_type{x, args});
+    }
+    T retval;
+    {
+        IArchive ia(ss);
+        w_type w{retval, args};
+        boost_load(ia, w);
+    }
+    BOOST_CHECK(x == retval);
+}
+
+BOOST_AUTO_TEST_CASE(packed_monomial_s11n_test)
+{
+    using p_type = packed_monomial<>;
+    BOOST_CHECK((has_boost_save<boost::archive::binary_oarchive, boost_s11n_key_wrapper<p_type>>::value));
+    BOOST_CHECK((has_boost_load<boost::archive::binary_iarchive, boost_s11n_key_wrapper<p_type>>::value));
+    symbol_set ss3({symbol("x"), symbol("y"), symbol("z")});
+    boost_roundtrip<boost::archive::binary_oarchive, boost::archive::binary_iarchive>(p_type{1, 2, 3}, ss3);
+    boost_roundtrip<boost::archive::text_oarchive, boost::archive::text_iarchive>(p_type{1, 2, 3}, ss3);
+    boost_roundtrip<boost::archive::text_oarchive, boost::archive::text_iarchive>(p_type{}, symbol_set{});
+#if defined(PIRANHA_WITH_MSGPACK)
+    BOOST_CHECK((key_has_msgpack_pack<msgpack::sbuffer, p_type>::value));
+    BOOST_CHECK((key_has_msgpack_convert<p_type>::value));
+    for (auto f : {msgpack_format::portable, msgpack_format::binary}) {
+        msgpack::sbuffer sbuf;
+        msgpack::packer<msgpack::sbuffer> p(sbuf);
+        p_type m{4, 5, 6};
+        m.msgpack_pack(p, f, ss3);
+        p_type retval;
+        auto oh = msgpack::unpack(sbuf.data(), sbuf.size());
+        retval.msgpack_convert(oh.get(), f, ss3);
+        BOOST_CHECK(retval == m);
+    }
+#endif
+}
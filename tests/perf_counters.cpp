@@ -0,0 +1,143 @@
+/* Copyright 2009-2016 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#include "../src/perf_counters.hpp"
+
+#define BOOST_TEST_MODULE perf_counters_test
+#include <boost/test/included/unit_test.hpp>
+
+#include <cstddef>
+#include <stdexcept>
+
+#include "../src/init.hpp"
+#include "../src/kronecker_monomial.hpp"
+#include "../src/mp_integer.hpp"
+#include "../src/multiplication_statistics.hpp"
+#include "../src/polynomial.hpp"
+
+using namespace piranha;
+
+using p_type = polynomial<integer, k_monomial>;
+
+static const perf_counter all_counters[] = {perf_counter::cycles, perf_counter::instructions, perf_counter::llc_misses,
+                                            perf_counter::dtlb_misses, perf_counter::branch_misses};
+
+BOOST_AUTO_TEST_CASE(perf_counters_values_test)
+{
+    init();
+    perf_counter_values v = perf_counter_values();
+    for (const auto c : all_counters) {
+        BOOST_CHECK(!v.is_available(c));
+        BOOST_CHECK_EQUAL(v.get(c), 0u);
+    }
+    BOOST_CHECK_EQUAL(v.wall_time, 0.);
+    BOOST_CHECK_EQUAL(v.ipc(), 0.);
+    BOOST_CHECK_EQUAL(v.mpki(perf_counter::llc_misses), 0.);
+    BOOST_CHECK_THROW(v.mpki(perf_counter::cycles), std::invalid_argument);
+    BOOST_CHECK_THROW(v.mpki(perf_counter::instructions), std::invalid_argument);
+    v.available[static_cast<std::size_t>(perf_counter::cycles)] = true;
+    v.values[static_cast<std::size_t>(perf_counter::cycles)] = 1000u;
+    // Instructions not available yet.
+    BOOST_CHECK_EQUAL(v.ipc(), 0.);
+    v.available[static_cast<std::size_t>(perf_counter::instructions)] = true;
+    v.values[static_cast<std::size_t>(perf_counter::instructions)] = 2000u;
+    BOOST_CHECK_EQUAL(v.ipc(), 2.);
+    BOOST_CHECK_EQUAL(v.mpki(perf_counter::branch_misses), 0.);
+    v.available[static_cast<std::size_t>(perf_counter::branch_misses)] = true;
+    v.values[static_cast<std::size_t>(perf_counter::branch_misses)] = 10u;
+    BOOST_CHECK_EQUAL(v.mpki(perf_counter::branch_misses), 5.);
+    BOOST_CHECK_EQUAL(v.get(perf_counter::branch_misses), 10u);
+}
+
+BOOST_AUTO_TEST_CASE(perf_counters_start_stop_test)
+{
+    perf_counters pc;
+    BOOST_CHECK_THROW(pc.stop(), std::invalid_argument);
+    const bool avail = perf_counters::available();
+    BOOST_TEST_MESSAGE("Hardware performance counters available: " << avail);
+    for (int i = 0; i < 2; ++i) {
+        pc.start();
+        p_type x{"x"}, y{"y"};
+        auto f = x + y + 1, tmp = f;
+        for (int j = 0; j < 10; ++j) {
+            tmp *= f;
+        }
+        const auto v = pc.stop();
+        BOOST_CHECK(v.wall_time >= 0.);
+        bool any = false;
+        for (const auto c : all_counters) {
+            if (v.is_available(c)) {
+                any = true;
+            } else {
+                BOOST_CHECK_EQUAL(v.get(c), 0u);
+            }
+        }
+        BOOST_CHECK_EQUAL(any, avail);
+        if (v.is_available(perf_counter::instructions)) {
+            BOOST_CHECK(v.get(perf_counter::instructions) > 0u);
+        }
+        // The counters must be restarted after stop().
+        BOOST_CHECK_THROW(pc.stop(), std::invalid_argument);
+    }
+    // Restarting is allowed.
+    pc.start();
+    pc.start();
+    BOOST_CHECK(pc.stop().wall_time >= 0.);
+}
+
+BOOST_AUTO_TEST_CASE(perf_counters_instrumentation_test)
+{
+    BOOST_CHECK(!multiplication_instrumentation::get_perf_counters_enabled());
+    multiplication_instrumentation::set_perf_counters_enabled(true);
+    BOOST_CHECK(multiplication_instrumentation::get_perf_counters_enabled());
+    multiplication_instrumentation::reset_perf_counters_enabled();
+    BOOST_CHECK(!multiplication_instrumentation::get_perf_counters_enabled());
+    p_type x{"x"}, y{"y"}, z{"z"};
+    auto f = x + y + z + 1;
+    multiplication_instrumentation::set_enabled(true);
+    // Counters disabled.
+    auto p = f * f;
+    auto st = multiplication_instrumentation::get_last_statistics();
+    BOOST_CHECK_EQUAL(st.perf_counters.wall_time, 0.);
+    for (const auto c : all_counters) {
+        BOOST_CHECK(!st.perf_counters.is_available(c));
+    }
+    // Counters enabled.
+    multiplication_instrumentation::set_perf_counters_enabled(true);
+    p = p * f;
+    st = multiplication_instrumentation::get_last_statistics();
+    BOOST_CHECK(st.perf_counters.wall_time >= 0.);
+    BOOST_CHECK(st.perf_counters.wall_time <= st.total_time);
+    bool any = false;
+    for (const auto c : all_counters) {
+        any = any || st.perf_counters.is_available(c);
+    }
+    BOOST_CHECK_EQUAL(any, perf_counters::available());
+    multiplication_instrumentation::reset_perf_counters_enabled();
+    multiplication_instrumentation::reset_enabled();
+}
@@ -33,6 +33,7 @@ see https://www.gnu.org/licenses/. */
 #include <boost/lexical_cast.hpp>
 #include <cstddef>
 #include <fstream>
+#include <string>
 #include <tuple>
 #include <type_traits>
 #include <vector>
@@ -68,6 +69,11 @@ BOOST_AUTO_TEST_CASE(perminov1_test)
         settings::set_n_threads(
             boost::lexical_cast<unsigned>(boost::unit_test::framework::master_test_suite().argv[1u]));
     }
+    // The optional second argument enables the cooperative splitting of the coefficient multiplications.
+    if (boost::unit_test::framework::master_test_suite().argc > 2
+        && std::string(boost::unit_test::framework::master_test_suite().argv[2u]) == "cooperative") {
+        settings::set_nested_parallelism(nested_parallelism::cooperative);
+    }
 
     using pt = polynomial<rational, monomial<rational>>;
     using epst = poisson_series<divisor_series<pt, divisor<short>>>;
@@ -47,6 +47,7 @@ see https://www.gnu.org/licenses/. */
 #include "../src/init.hpp"
 #include "../src/invert.hpp"
 #include "../src/key_is_multipliable.hpp"
+#include "../src/kronecker_monomial.hpp"
 #include "../src/math.hpp"
 #include "../src/monomial.hpp"
 #include "../src/mp_integer.hpp"
@@ -529,3 +530,32 @@ BOOST_AUTO_TEST_CASE(polynomial_find_cf_test)
         BOOST_CHECK_THROW(pt2{"x"}.find_cf(std::list<long>{std::numeric_limits<long>::max()}), std::invalid_argument);
     }
 }
+
+BOOST_AUTO_TEST_CASE(polynomial_nested_parallelism_test)
+{
+    // Polynomials with polynomial coefficients: the coefficient multiplications are nested inside
+    // the tasks of the outer multiplication.
+    using pt_in = polynomial<integer, k_monomial>;
+    using pt_out = polynomial<pt_in, monomial<int>>;
+    pt_in x{"x"}, y{"y"};
+    pt_out z{"z"}, t{"t"};
+    pt_out f, g;
+    for (int i = 0; i < 12; ++i) {
+        f += math::pow(z, i) * math::pow(x + y + i, 6) + math::pow(t, i) * math::pow(x - y, i);
+        g += math::pow(t, i) * math::pow(x - y + 1, 6) + math::pow(z * t, i) * (x + i);
+    }
+    settings::set_n_threads(1u);
+    const auto res = f * g;
+    settings::set_min_work_per_thread(1u);
+    for (auto p : {nested_parallelism::outer, nested_parallelism::cooperative}) {
+        settings::set_nested_parallelism(p);
+        for (auto i = 1u; i <= 4u; ++i) {
+            settings::set_n_threads(i);
+            BOOST_CHECK_EQUAL(f * g, res);
+            BOOST_CHECK_EQUAL(f * g * f, res * f);
+        }
+    }
+    settings::reset_nested_parallelism();
+    settings::reset_min_work_per_thread();
+    settings::reset_n_threads();
+}
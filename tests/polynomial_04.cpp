@@ -45,6 +45,7 @@ see https://www.gnu.org/licenses/. */
 #include "../src/monomial.hpp"
 #include "../src/mp_integer.hpp"
 #include "../src/mp_rational.hpp"
+#include "../src/settings.hpp"
 #include "../src/symbol.hpp"
 #include "../src/symbol_set.hpp"
 #include "../src/type_traits.hpp"
@@ -729,6 +730,48 @@ BOOST_AUTO_TEST_CASE(polynomial_height_test)
     }
 }
 
+BOOST_AUTO_TEST_CASE(polynomial_parallel_content_test)
+{
+    using p_type = polynomial<integer, k_monomial>;
+    p_type x{"x"}, y{"y"}, z{"z"};
+    const auto big = integer(1) << 200;
+    // Polynomials with a few thousand terms, static and dynamic coefficients, and known content.
+    const auto f = math::pow(x + 2 * y - 3 * z + 1, 20), g = math::pow(x - big * y + z - 1, 15);
+    // A polynomial with only negative coefficients, both static and dynamic.
+    const auto h = -math::pow(x + y + z + 1, 20) - big * math::pow(x + y, 5);
+    // The content is negative only if all the coefficients are negative.
+    const std::vector<std::pair<p_type, integer>> polys
+        = {{f, integer(1)},   {6 * f, integer(6)},   {-6 * f, integer(6)},   {g, integer(1)},
+           {big * g, big},    {-big * g, big},       {3 * big * f, 3 * big}, {h, integer(-1)},
+           {4 * h, integer(-4)}, {-big * h, big},     {-3 * x, integer(-3)},  {-3 * x + 6 * y, integer(3)},
+           {-big * x, -big},  {-big * x - y, integer(-1)}};
+    settings::set_min_work_per_thread(1u);
+    for (unsigned nt = 1u; nt <= 4u; ++nt) {
+        settings::set_n_threads(nt);
+        for (const auto &p : polys) {
+            BOOST_CHECK_EQUAL(p.first.content(), p.second);
+            const auto pp = p.first.primitive_part();
+            BOOST_CHECK_EQUAL(pp * p.second, p.first);
+            BOOST_CHECK_EQUAL(pp.content(), 1);
+            BOOST_CHECK_EQUAL(p.first.height(), math::abs(p.second) * pp.height());
+        }
+        BOOST_CHECK_EQUAL((-3 * x).primitive_part(), x);
+        BOOST_CHECK_EQUAL((-3 * x + 6 * y).primitive_part(), -x + 2 * y);
+        BOOST_CHECK_EQUAL(p_type{}.content(), 0);
+        BOOST_CHECK_EQUAL(p_type{}.height(), 0);
+    }
+    // Integral coefficients.
+    {
+        using p_type2 = polynomial<long, k_monomial>;
+        p_type2 a{"a"}, b{"b"};
+        BOOST_CHECK_EQUAL((-4 * a - 6 * b).content(), -2);
+        BOOST_CHECK_EQUAL((-4 * a + 6 * b).content(), 2);
+        BOOST_CHECK_EQUAL((4 * a - 6 * b).content(), 2);
+    }
+    settings::reset_n_threads();
+    settings::reset_min_work_per_thread();
+}
+
 // This was a specific GCD computation that was very slow before changing the heuristic GCD algorithm.
 BOOST_AUTO_TEST_CASE(polynomial_gcd_bug_00_test)
 {
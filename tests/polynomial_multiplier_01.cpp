@@ -35,9 +35,11 @@ see https://www.gnu.org/licenses/. */
 #include <boost/mpl/vector.hpp>
 #include <cstdint>
 #include <limits>
+#include <numeric>
 #include <stdexcept>
 #include <tuple>
 #include <type_traits>
+#include <utility>
 
 #include "../src/init.hpp"
 #include "../src/kronecker_array.hpp"
@@ -49,6 +51,7 @@ see https://www.gnu.org/licenses/. */
 #include "../src/settings.hpp"
 #include "../src/symbol.hpp"
 #include "../src/symbol_set.hpp"
+#include "../src/tuning.hpp"
 
 using namespace piranha;
 
@@ -249,3 +252,41 @@ BOOST_AUTO_TEST_CASE(polynomial_multiplier_multiplication_test)
     }
     settings::reset_n_threads();
 }
+
+BOOST_AUTO_TEST_CASE(polynomial_multiplier_hash_mixing_test)
+{
+    using pt = polynomial<rational, kronecker_monomial<>>;
+    // Reference result with the default strategy.
+    auto build = []() {
+        pt x{"x"}, y{"y"}, z{"z"}, t{"t"};
+        // Only even powers of x, to exercise structured inputs.
+        auto f = 1 + x * x + y + z + t, g = 1 - x * x + y + z + t;
+        auto tmp_f = f, tmp_g = g;
+        for (int i = 1; i < 8; ++i) {
+            f *= tmp_f;
+            g *= tmp_g;
+        }
+        return std::make_pair(f, g);
+    };
+    const auto ref_pair = build();
+    const auto ref = ref_pair.first * ref_pair.second;
+    BOOST_CHECK((pt{}._container().hash_function().is_additive()));
+    for (auto m : {hash_mixing::identity, hash_mixing::multiply_shift, hash_mixing::randomised}) {
+        tuning::set_hash_mixing(m);
+        BOOST_CHECK(pt{}._container().hash_function().is_additive() == (m != hash_mixing::multiply_shift));
+        for (unsigned i = 1u; i <= 4u; ++i) {
+            settings::set_n_threads(i);
+            const auto p = build();
+            const auto res = p.first * p.second;
+            BOOST_CHECK_EQUAL(res.size(), ref.size());
+            BOOST_CHECK_EQUAL(res, ref);
+            // The diagnostics are consistent with the size of the result.
+            const auto occ = res.table_zone_occupancy(i * 10u);
+            BOOST_CHECK_EQUAL(occ.size(), i * 10u);
+            BOOST_CHECK_EQUAL(std::accumulate(occ.begin(), occ.end(), pt::size_type(0u)), res.size());
+            BOOST_CHECK(res.table_zone_imbalance(i * 10u) >= 1.);
+        }
+    }
+    tuning::reset_hash_mixing();
+    settings::reset_n_threads();
+}
@@ -44,6 +44,7 @@ see https://www.gnu.org/licenses/. */
 #include "../src/mp_integer.hpp"
 #include "../src/mp_rational.hpp"
 #include "../src/settings.hpp"
+#include "../src/tuning.hpp"
 
 using namespace piranha;
 
@@ -154,3 +155,93 @@ BOOST_AUTO_TEST_CASE(polynomial_multiplier_multiplier_finalise_test)
     }
     settings::reset_n_threads();
 }
+
+BOOST_AUTO_TEST_CASE(polynomial_multiplier_double_batched_test)
+{
+    // The batched consumer of multiplication tasks for double coefficients. The coefficients are small integers,
+    // so the results must match exactly those computed with integer coefficients, for any block size and number
+    // of threads.
+    using pt1 = polynomial<double, k_monomial>;
+    using pt2 = polynomial<integer, k_monomial>;
+    pt2 cmp;
+    {
+        pt2 x("x"), y("y"), z("z"), t("t");
+        auto f = 1 + x - 2 * y + z + 3 * t;
+        auto tmp2 = f;
+        for (int i = 1; i < 8; ++i) {
+            f *= tmp2;
+        }
+        cmp = f * (f - 1) - f * f;
+        BOOST_CHECK_EQUAL(cmp, -f);
+        cmp = f * (f - 2 * x.pow(3));
+    }
+    pt1 x("x"), y("y"), z("z"), t("t");
+    auto f = 1 + x - 2 * y + z + 3 * t;
+    auto tmp2 = f;
+    for (int i = 1; i < 8; ++i) {
+        f *= tmp2;
+    }
+    // Force the use of the batched consumer, then restore the default threshold.
+    const auto old_min = detail::base_batched_mult<>::s_min_bucket_count.load();
+    for (std::size_t min_bc : {std::size_t(0u), old_min}) {
+        detail::base_batched_mult<>::s_min_bucket_count.store(min_bc);
+        for (unsigned long bs : {16ul, 100ul, 256ul, 4096ul}) {
+            tuning::set_multiplication_block_size(bs);
+            for (unsigned nt = 1u; nt <= 4; nt += 3) {
+                settings::set_n_threads(nt);
+                BOOST_CHECK(pt2(f * (f - 2 * x.pow(3))) == cmp);
+                // Cancellations yield zero coefficients which must be removed.
+                BOOST_CHECK_EQUAL(f * (f - 1) - f * f, -f);
+            }
+        }
+    }
+    // With non-integral coefficients, the batched and the plain consumers must give bit-for-bit identical
+    // results, as the order of the accumulations is the same.
+    auto g = f * 0.1 + y / 3. - 1.7;
+    for (unsigned nt = 1u; nt <= 4; nt += 3) {
+        settings::set_n_threads(nt);
+        detail::base_batched_mult<>::s_min_bucket_count.store(0u);
+        const auto res_batched = f * g;
+        detail::base_batched_mult<>::s_min_bucket_count.store(old_min);
+        const auto res_plain = f * g;
+        BOOST_CHECK_EQUAL(res_batched.size(), res_plain.size());
+        for (const auto &t : res_plain._container()) {
+            const auto it = res_batched._container().find(t);
+            BOOST_CHECK(it != res_batched._container().end());
+            if (it != res_batched._container().end()) {
+                BOOST_CHECK_EQUAL(it->m_cf, t.m_cf);
+            }
+        }
+    }
+    tuning::reset_multiplication_block_size();
+    settings::reset_n_threads();
+}
+
+BOOST_AUTO_TEST_CASE(polynomial_multiplier_integer_batched_test)
+{
+    // The batched consumer for integer coefficients, with coefficients crossing the limits of the static storage.
+    // The reference result is computed with the plain multiplication, forced by a high estimation threshold.
+    using pt = polynomial<integer, k_monomial>;
+    pt x("x"), y("y"), z("z"), t("t");
+    const integer big = integer(1) << 62;
+    auto f = 1 + x * big - 2 * y + z * (big * big) - 3 * t;
+    auto tmp2 = f;
+    for (int i = 1; i < 6; ++i) {
+        f *= tmp2;
+    }
+    auto g = f - big * x.pow(2) + 7;
+    settings::set_n_threads(1u);
+    tuning::set_estimate_threshold(10000u);
+    const auto cmp = f * g;
+    tuning::reset_estimate_threshold();
+    for (unsigned long bs : {16ul, 256ul}) {
+        tuning::set_multiplication_block_size(bs);
+        for (unsigned nt = 1u; nt <= 4; nt += 3) {
+            settings::set_n_threads(nt);
+            BOOST_CHECK_EQUAL(f * g, cmp);
+            BOOST_CHECK_EQUAL(f * (f - 1) - f * f, -f);
+        }
+    }
+    tuning::reset_multiplication_block_size();
+    settings::reset_n_threads();
+}
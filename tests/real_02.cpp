@@ -31,7 +31,10 @@ see https://www.gnu.org/licenses/. */
 #define BOOST_TEST_MODULE real_02_test
 #include <boost/test/included/unit_test.hpp>
 
+#include <algorithm>
 #include <boost/algorithm/string/predicate.hpp>
+#include <climits>
+#include <cstddef>
 #include <cstdint>
 #include <initializer_list>
 #include <limits>
@@ -43,6 +46,7 @@ see https://www.gnu.org/licenses/. */
 #include <thread>
 #include <type_traits>
 #include <typeinfo>
+#include <utility>
 #include <vector>
 
 #include "../src/config.hpp"
@@ -339,3 +343,61 @@ BOOST_AUTO_TEST_CASE(real_zero_is_absorbing_test)
     BOOST_CHECK((!zero_is_absorbing<const real &>::value));
     BOOST_CHECK((!zero_is_absorbing<const real>::value));
 }
+
+BOOST_AUTO_TEST_CASE(real_inline_storage_test)
+{
+    BOOST_CHECK(real::inline_prec >= real::default_prec);
+    BOOST_CHECK(real::inline_size * sizeof(::mp_limb_t) * CHAR_BIT >= std::size_t(real::inline_prec));
+    const ::mpfr_prec_t small = real::inline_prec, big = real::inline_prec + 100;
+    // Move construction/assignment and swap between all combinations of inline and dynamic storage.
+    for (auto p1 : {::mpfr_prec_t(8), ::mpfr_prec_t(real::default_prec), small, big}) {
+        for (auto p2 : {::mpfr_prec_t(8), ::mpfr_prec_t(real::default_prec), small, big}) {
+            const real a{"1.5", p1}, b{"-3.25", p2};
+            real x{a}, y{b};
+            x.swap(y);
+            BOOST_CHECK_EQUAL(x, b);
+            BOOST_CHECK_EQUAL(x.get_prec(), p2);
+            BOOST_CHECK_EQUAL(y, a);
+            BOOST_CHECK_EQUAL(y.get_prec(), p1);
+            x.swap(y);
+            real z{std::move(x)};
+            BOOST_CHECK_EQUAL(z, a);
+            BOOST_CHECK_EQUAL(z.get_prec(), p1);
+            z = std::move(y);
+            BOOST_CHECK_EQUAL(z, b);
+            BOOST_CHECK_EQUAL(z.get_prec(), p2);
+            BOOST_CHECK_EQUAL(y, a);
+            // Revive the moved-from object with both kinds of storage.
+            x = real{"2", p2};
+            BOOST_CHECK_EQUAL(x, 2);
+            BOOST_CHECK_EQUAL(x.get_prec(), p2);
+            // Precision changes across the inline threshold.
+            x.set_prec(p1);
+            BOOST_CHECK(x.is_nan());
+            BOOST_CHECK_EQUAL(x.get_prec(), p1);
+            x = 7;
+            x.set_prec(p2);
+            x = 8;
+            BOOST_CHECK_EQUAL(x, 8);
+            BOOST_CHECK_EQUAL(x.get_prec(), p2);
+            // Arithmetic promoting the precision.
+            real w{1, p1};
+            w += real{"0.5", p2};
+            BOOST_CHECK_EQUAL(w, real{"1.5"});
+            BOOST_CHECK_EQUAL(w.get_prec(), std::max(p1, p2));
+            w.multiply_accumulate(real{2, p2}, real{3, p1});
+            BOOST_CHECK_EQUAL(w, real{"7.5"});
+        }
+    }
+    // Values stored inline must survive being moved around in containers.
+    std::vector<real> v;
+    for (int i = 0; i < 100; ++i) {
+        v.emplace_back(i, i % 2 ? small : big);
+    }
+    for (int i = 0; i < 100; ++i) {
+        BOOST_CHECK_EQUAL(v[static_cast<std::size_t>(i)], i);
+    }
+    // Boost serialization roundtrip of inline values.
+    boost_roundtrip<boost::archive::binary_oarchive, boost::archive::binary_iarchive>(real{"1.1", small});
+    boost_roundtrip<boost::archive::binary_oarchive, boost::archive::binary_iarchive>(real{"1.1", big});
+}
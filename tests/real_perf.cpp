@@ -0,0 +1,100 @@
+/* Copyright 2009-2016 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+#define BOOST_TEST_MODULE real_test
+#include <boost/test/included/unit_test.hpp>
+
+#include <boost/lexical_cast.hpp>
+#include <iostream>
+
+#include "../src/init.hpp"
+#include "../src/kronecker_monomial.hpp"
+#include "../src/math.hpp"
+#include "../src/poisson_series.hpp"
+#include "../src/polynomial.hpp"
+#include "../src/real.hpp"
+#include "../src/settings.hpp"
+#include "simple_timer.hpp"
+
+using namespace piranha;
+
+// Multiplication and evaluation of polynomials and Poisson series with piranha::real coefficients
+// at the default precision, using the same series types exposed in pyranha.
+
+using p_type = polynomial<real, kronecker_monomial<>>;
+using ps_type = poisson_series<p_type>;
+
+static inline void init_threads()
+{
+    init();
+    settings::set_thread_binding(true);
+    if (boost::unit_test::framework::master_test_suite().argc > 1) {
+        settings::set_n_threads(
+            boost::lexical_cast<unsigned>(boost::unit_test::framework::master_test_suite().argv[1u]));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(real_polynomial_test)
+{
+    init_threads();
+    p_type x{"x"}, y{"y"}, z{"z"}, t{"t"};
+    const auto f = math::pow(1 + x + y + z + t, 15);
+    p_type ret;
+    {
+        std::cout << "Timing multiplication: ";
+        simple_timer st;
+        ret = f * (f + 1);
+    }
+    BOOST_CHECK_EQUAL(ret.size(), 46376u);
+    {
+        std::cout << "Timing evaluation: ";
+        simple_timer st;
+        const auto v = math::evaluate<real>(
+            ret, {{"x", real{"0.1"}}, {"y", real{"0.2"}}, {"z", real{"0.3"}}, {"t", real{"0.4"}}});
+        BOOST_CHECK(v > 0);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(real_poisson_series_test)
+{
+    ps_type x{"x"}, y{"y"}, a{"a"}, b{"b"}, c{"c"};
+    const auto f = math::pow(1 + x + y + math::cos(a) + math::sin(a + b) + math::cos(b - c), 8);
+    ps_type ret;
+    {
+        std::cout << "Timing multiplication: ";
+        simple_timer st;
+        ret = f * (f + 1);
+    }
+    BOOST_CHECK_EQUAL(ret.size(), 3009u);
+    {
+        std::cout << "Timing evaluation: ";
+        simple_timer st;
+        const auto v = math::evaluate<real>(
+            ret, {{"x", real{"0.1"}}, {"y", real{"0.2"}}, {"a", real{"0.3"}}, {"b", real{"0.4"}}, {"c", real{"0.5"}}});
+        BOOST_CHECK(v > 0);
+    }
+}
@@ -31,7 +31,9 @@ see https://www.gnu.org/licenses/. */
 #define BOOST_TEST_MODULE runtime_info_test
 #include <boost/test/included/unit_test.hpp>
 
+#include <algorithm>
 #include <iostream>
+#include <vector>
 
 #include "../src/init.hpp"
 #include "../src/memory.hpp"
@@ -44,6 +46,19 @@ BOOST_AUTO_TEST_CASE(runtime_info_print_test)
     init();
     std::cout << "Concurrency: " << runtime_info::get_hardware_concurrency() << '\n';
     std::cout << "Cache line size: " << runtime_info::get_cache_line_size() << '\n';
+    for (const auto &ci : runtime_info::get_cache_hierarchy()) {
+        std::cout << "L" << ci.level << " "
+                  << (ci.type == cache_type::data ? "data" : (ci.type == cache_type::instruction ? "instruction"
+                                                                                                  : "unified"))
+                  << " cache: " << ci.size << " bytes, line size " << ci.line_size << ", associativity "
+                  << ci.associativity << ", shared by " << ci.shared_cpus.size() << " CPU(s)\n";
+    }
+    std::cout << "NUMA nodes: " << runtime_info::get_numa_nodes().size() << '\n';
+    std::cout << "CPU binding order:";
+    for (const auto &cpu : runtime_info::get_cpu_binding_order()) {
+        std::cout << ' ' << cpu;
+    }
+    std::cout << '\n';
     std::cout << "Memory alignment primitives: "
               <<
 #if defined(PIRANHA_HAVE_MEMORY_ALIGNMENT_PRIMITIVES)
@@ -59,3 +74,41 @@ BOOST_AUTO_TEST_CASE(runtime_info_settings_test)
                 || runtime_info::get_hardware_concurrency() == 0u);
     BOOST_CHECK_EQUAL(runtime_info::get_cache_line_size(), settings::get_cache_line_size());
 }
+
+BOOST_AUTO_TEST_CASE(runtime_info_cache_hierarchy_test)
+{
+    const auto hc = runtime_info::get_hardware_concurrency();
+    const auto caches = runtime_info::get_cache_hierarchy();
+    for (const auto &ci : caches) {
+        BOOST_CHECK(ci.level > 0u);
+        BOOST_CHECK(ci.size > 0u);
+        BOOST_CHECK(std::is_sorted(ci.shared_cpus.begin(), ci.shared_cpus.end()));
+        // The cache of the first CPU is shared with the first CPU.
+        if (!ci.shared_cpus.empty()) {
+            BOOST_CHECK(std::binary_search(ci.shared_cpus.begin(), ci.shared_cpus.end(), 0u));
+        }
+    }
+    if (runtime_info::get_cache_size(1u)) {
+        BOOST_CHECK(std::any_of(caches.begin(), caches.end(), [](const cache_info &ci) {
+            return ci.level == 1u && ci.type != cache_type::instruction;
+        }));
+    }
+    BOOST_CHECK_EQUAL(runtime_info::get_cache_size(0u), 0u);
+    // Caches of a non-existing CPU.
+    BOOST_CHECK(runtime_info::get_cache_hierarchy(1000000u).empty());
+    // NUMA nodes contain valid CPUs, each appearing at most once.
+    std::vector<unsigned> all_cpus;
+    for (const auto &node : runtime_info::get_numa_nodes()) {
+        BOOST_CHECK(std::is_sorted(node.begin(), node.end()));
+        all_cpus.insert(all_cpus.end(), node.begin(), node.end());
+    }
+    std::sort(all_cpus.begin(), all_cpus.end());
+    BOOST_CHECK(std::adjacent_find(all_cpus.begin(), all_cpus.end()) == all_cpus.end());
+    // The binding order is a permutation of the logical CPUs.
+    auto order = runtime_info::get_cpu_binding_order();
+    BOOST_CHECK_EQUAL(order.size(), hc);
+    std::sort(order.begin(), order.end());
+    for (decltype(order.size()) i = 0u; i < order.size(); ++i) {
+        BOOST_CHECK_EQUAL(order[i], i);
+    }
+}
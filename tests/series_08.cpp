@@ -40,22 +40,26 @@ see https://www.gnu.org/licenses/. */
 #include <thread>
 #include <tuple>
 #include <type_traits>
+#include <vector>
 
 #include "../src/base_series_multiplier.hpp"
 #include "../src/exceptions.hpp"
 #include "../src/forwarding.hpp"
 #include "../src/init.hpp"
 #include "../src/key_is_multipliable.hpp"
+#include "../src/kronecker_monomial.hpp"
 #include "../src/math.hpp"
 #include "../src/monomial.hpp"
 #include "../src/mp_integer.hpp"
 #include "../src/mp_rational.hpp"
+#include "../src/poisson_series.hpp"
 #include "../src/polynomial.hpp"
 #include "../src/pow.hpp"
 #include "../src/real.hpp"
 #include "../src/safe_cast.hpp"
 #include "../src/series_multiplier.hpp"
 #include "../src/settings.hpp"
+#include "../src/tuning.hpp"
 #include "../src/type_traits.hpp"
 
 using namespace piranha;
@@ -327,6 +331,10 @@ struct table_info_tester {
             BOOST_CHECK((q.table_sparsity() == s_type{{1u, 1u}}));
             BOOST_CHECK(q.table_load_factor() != 0.);
             BOOST_CHECK(q.table_bucket_count() != 0u);
+            BOOST_CHECK(p.table_zone_imbalance(4u) == 0.);
+            BOOST_CHECK((p.table_zone_occupancy(2u) == std::vector<typename p_type1::size_type>{0u, 0u}));
+            BOOST_CHECK(q.table_zone_imbalance(4u) == 4.);
+            BOOST_CHECK_THROW(q.table_zone_occupancy(0u), std::invalid_argument);
         }
     };
     template <typename Cf>
@@ -514,3 +522,140 @@ BOOST_AUTO_TEST_CASE(series_pow_test)
     p_type2::clear_pow_cache();
     p_type3::clear_pow_cache();
 }
+
+// Check that all the rationals in the coefficients of a series with polynomial coefficients are canonical.
+template <typename S>
+static bool lazy_all_canonical(const S &s)
+{
+    for (const auto &t : s._container()) {
+        for (const auto &u : t.m_cf._container()) {
+            if (!u.m_cf.is_canonical()) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+BOOST_AUTO_TEST_CASE(series_rational_lazy_scope_test)
+{
+    using p_type = polynomial<rational, k_monomial>;
+    using gs_type = g_series_type<p_type, int>;
+    using ps_type = poisson_series<p_type>;
+    const p_type x{"x"}, y{"y"};
+    const gs_type a{"a"};
+    const ps_type b{"b"};
+    gs_type f1, g1;
+    ps_type f2, g2;
+    for (int i = 1; i < 20; ++i) {
+        const auto c1 = x * rational{1, i} - y * rational{i, 3}, c2 = x / (i + 1) + rational{2, i};
+        f1 += c1 * math::pow(a, i);
+        g1 += c2 * math::pow(a, i);
+        f2 += c1 * math::cos(i * b);
+        g2 += c2 * math::cos(i * b);
+    }
+    const auto prod1_ref = f1 * g1;
+    const auto prod2_ref = f2 * g2;
+    // Single-threaded without and with estimation, multithreaded.
+    settings::set_min_work_per_thread(1u);
+    for (auto mode : {0, 1, 2}) {
+        settings::set_n_threads(mode == 2 ? 4u : 1u);
+        tuning::set_estimate_threshold(mode == 0 ? 1000u : 1u);
+        {
+            mp_rational_lazy_scope scope;
+            const auto prod1 = f1 * g1;
+            BOOST_CHECK(lazy_all_canonical(prod1));
+            BOOST_CHECK_EQUAL(prod1, prod1_ref);
+            const auto prod2 = f2 * g2;
+            BOOST_CHECK(lazy_all_canonical(prod2));
+            BOOST_CHECK_EQUAL(prod2, prod2_ref);
+            // Additions are not affected by the lazy mode.
+            const auto sum = f1 + g1 - f1;
+            BOOST_CHECK(lazy_all_canonical(sum));
+            BOOST_CHECK_EQUAL(sum, g1);
+        }
+    }
+    settings::reset_n_threads();
+    settings::reset_min_work_per_thread();
+    tuning::reset_estimate_threshold();
+    // Monomials with rational exponents: the key arithmetics is never lazy.
+    using pq_type = polynomial<rational, monomial<rational>>;
+    const pq_type z{"z"}, w{"w"};
+    const auto p1 = math::pow(z, rational{1, 6}) * (w + rational{1, 6}), p2 = math::pow(z, rational{1, 3}) * (w - 2);
+    const auto pq_prod_ref = p1 * p2;
+    {
+        mp_rational_lazy_scope scope;
+        const auto prod = math::pow(z, rational{1, 6}) * math::pow(z, rational{1, 3});
+        BOOST_CHECK_EQUAL(prod, math::pow(z, rational{1, 2}));
+        BOOST_CHECK(prod._container().begin()->m_key.begin()->is_canonical());
+        BOOST_CHECK_EQUAL(p1 * p2, pq_prod_ref);
+        BOOST_CHECK_EQUAL(p1 * p2 - math::pow(z, rational{1, 2}) * (w * w + rational{-11, 6} * w - rational{1, 3}),
+                          0);
+    }
+    const auto prod = math::pow(z, rational{1, 6}) * math::pow(z, rational{1, 3});
+    BOOST_CHECK_EQUAL(prod, math::pow(z, rational{1, 2}));
+}
+
+BOOST_AUTO_TEST_CASE(series_mixed_arithmetics_test)
+{
+    using pi_type = polynomial<integer, k_monomial>;
+    using pq_type = polynomial<rational, k_monomial>;
+    for (auto hm : {hash_mixing::identity, hash_mixing::multiply_shift, hash_mixing::randomised}) {
+        tuning::set_hash_mixing(hm);
+        pi_type x{"x"}, y{"y"};
+        pq_type xq{"x"}, z{"z"};
+        const auto a = math::pow(x + 2 * y - 3, 10);
+        const auto b = math::pow(xq / 2 + z + 1, 8);
+        // Conversion with the same key type keeps the layout of the table.
+        const pq_type aq(a);
+        BOOST_CHECK_EQUAL(aq.size(), a.size());
+        BOOST_CHECK_EQUAL(aq.table_bucket_count(), a.table_bucket_count());
+        BOOST_CHECK_EQUAL(aq - a, 0);
+        BOOST_CHECK_EQUAL(a - aq, 0);
+        // The converted series can be modified further.
+        auto aq2 = aq;
+        aq2 += b;
+        BOOST_CHECK_EQUAL(aq2, aq + b);
+        // Mixed operations, with and without merging of the symbol sets.
+        BOOST_CHECK_EQUAL(b + a, b + aq);
+        BOOST_CHECK_EQUAL(a + b, aq + b);
+        BOOST_CHECK_EQUAL(b - a, b - aq);
+        BOOST_CHECK_EQUAL(a - b, aq - b);
+        BOOST_CHECK_EQUAL(aq + a, 2 * aq);
+        BOOST_CHECK_EQUAL(a * b, aq * b);
+        BOOST_CHECK_EQUAL(b * a, b * aq);
+        // Mixed multiplications are performed without converting the integral operand.
+        BOOST_CHECK((std::is_constructible<series_multiplier<pq_type>, const pq_type &, const pi_type &>::value));
+        BOOST_CHECK_EQUAL(aq * a, aq * aq);
+        BOOST_CHECK_EQUAL(a * aq, aq * aq);
+        auto b2 = b;
+        b2 *= a;
+        BOOST_CHECK_EQUAL(b2, b * aq);
+        BOOST_CHECK_EQUAL(b * pi_type{}, 0);
+        BOOST_CHECK_EQUAL(pi_type{} * b, 0);
+        BOOST_CHECK_EQUAL(a * pq_type{}, 0);
+        BOOST_CHECK_EQUAL(b * pi_type{2}, 2 * b);
+        for (unsigned nt = 1u; nt <= 3u; ++nt) {
+            settings::set_n_threads(nt);
+            BOOST_CHECK_EQUAL(a * b * a, aq * b * aq);
+        }
+        settings::reset_n_threads();
+        // Non-rational coefficients.
+        using pd_type = polynomial<double, k_monomial>;
+        const pd_type c = math::pow(pd_type{"x"} * 1.5 - pd_type{"t"}, 6);
+        BOOST_CHECK_EQUAL(c * a, c * pd_type(a));
+        BOOST_CHECK_EQUAL(a * c, pd_type(a) * c);
+    }
+    tuning::reset_hash_mixing();
+    // Promotion of both operands to a third coefficient type.
+    using s1_type = g_series_type<short, int>;
+    using s2_type = g_series_type<signed char, int>;
+    using s3_type = g_series_type<int, int>;
+    s1_type a{"x"};
+    s2_type b{"y"};
+    BOOST_CHECK((std::is_same<s3_type, decltype(a + b)>::value));
+    BOOST_CHECK_EQUAL(a + b, s3_type{"x"} + s3_type{"y"});
+    BOOST_CHECK_EQUAL(a - b, s3_type{"x"} - s3_type{"y"});
+    BOOST_CHECK_EQUAL(b - a, s3_type{"y"} - s3_type{"x"});
+    BOOST_CHECK_EQUAL(a - s2_type{"x"}, 0);
+}
@@ -61,6 +61,17 @@ BOOST_AUTO_TEST_CASE(settings_thread_number_test)
     BOOST_CHECK(!settings::get_thread_binding());
 }
 
+BOOST_AUTO_TEST_CASE(settings_nested_parallelism_test)
+{
+    BOOST_CHECK(settings::get_nested_parallelism() == nested_parallelism::outer);
+    settings::set_nested_parallelism(nested_parallelism::cooperative);
+    BOOST_CHECK(settings::get_nested_parallelism() == nested_parallelism::cooperative);
+    BOOST_CHECK(thread_pool::get_nested_parallelism() == nested_parallelism::cooperative);
+    settings::reset_nested_parallelism();
+    BOOST_CHECK(settings::get_nested_parallelism() == nested_parallelism::outer);
+    BOOST_CHECK(thread_pool::get_nested_parallelism() == nested_parallelism::outer);
+}
+
 BOOST_AUTO_TEST_CASE(settings_cache_line_size_test)
 {
     const auto original = settings::get_cache_line_size();
@@ -30,30 +30,90 @@ see https://www.gnu.org/licenses/. */
 #define PIRANHA_SIMPLE_TIMER_HPP
 
 #include <chrono>
+#include <cstddef>
 #include <iostream>
+#include <vector>
+
+#include "../src/perf_counters.hpp"
 
 namespace piranha
 {
 
+// A region of code timed by simple_timer: elapsed time (in seconds) and hardware performance counters.
+struct simple_timer_region {
+    double m_time;
+    perf_counter_values m_counters;
+};
+
+// Global state of simple_timer. When capturing is enabled (e.g., by the benchmark harness in benchmark.hpp),
+// the timers will not print anything and the timed regions will be appended to m_regions instead.
+struct simple_timer_state {
+    bool m_capture;
+    std::vector<simple_timer_region> m_regions;
+};
+
+inline simple_timer_state &get_simple_timer_state()
+{
+    static simple_timer_state state{false, {}};
+    return state;
+}
+
 // A simple RAII timer class, using std::chrono. It will print, upon destruction,
-// the time elapsed since construction (in ms).
+// the time elapsed since construction (in ms) and, if available, the hardware performance
+// counters collected in the meantime.
 class simple_timer
 {
 public:
-    simple_timer() : m_start(std::chrono::high_resolution_clock::now())
+    simple_timer()
     {
+        // NOTE: start the counters first, so that their setup is not timed.
+        m_counters.start();
+        m_start = std::chrono::high_resolution_clock::now();
     }
     ~simple_timer()
     {
-        std::cout << "Elapsed time: "
-                  << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now()
-                                                                           - m_start)
-                         .count()
+        const auto elapsed = std::chrono::high_resolution_clock::now() - m_start;
+        const auto values = m_counters.stop();
+        auto &state = get_simple_timer_state();
+        if (state.m_capture) {
+            try {
+                state.m_regions.push_back(
+                    simple_timer_region{std::chrono::duration<double>(elapsed).count(), values});
+            } catch (...) {
+                // NOTE: don't throw from the destructor.
+            }
+            return;
+        }
+        std::cout << "Elapsed time: " << std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count()
                   << "ms\n";
+        print_counters(values);
     }
 
 private:
-    const std::chrono::high_resolution_clock::time_point m_start;
+    static void print_counters(const perf_counter_values &values)
+    {
+        static const char *names[] = {"Cycles", "Instructions", "LLC misses", "dTLB misses", "Branch misses"};
+        bool first = true;
+        for (std::size_t i = 0u; i < perf_counter_values::n_counters; ++i) {
+            const auto c = static_cast<perf_counter>(i);
+            if (!values.is_available(c)) {
+                continue;
+            }
+            std::cout << (first ? "" : ", ") << names[i] << ": " << values.get(c);
+            if (c == perf_counter::instructions && values.is_available(perf_counter::cycles)) {
+                std::cout << " (IPC: " << values.ipc() << ")";
+            } else if (c != perf_counter::cycles && c != perf_counter::instructions
+                       && values.is_available(perf_counter::instructions)) {
+                std::cout << " (" << values.mpki(c) << " per 1000 instructions)";
+            }
+            first = false;
+        }
+        if (!first) {
+            std::cout << '\n';
+        }
+    }
+    perf_counters m_counters;
+    std::chrono::high_resolution_clock::time_point m_start;
 };
 }
 
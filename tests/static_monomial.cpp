@@ -0,0 +1,280 @@
+/* Copyright 2009-2016 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+#include "../src/static_monomial.hpp"
+
+#define BOOST_TEST_MODULE static_monomial_test
+#include <boost/test/included/unit_test.hpp>
+
+#include <array>
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/archive/text_iarchive.hpp>
+#include <boost/archive/text_oarchive.hpp>
+#include <boost/lexical_cast.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <unordered_set>
+#include <vector>
+
+#include "../src/config.hpp"
+#include "../src/init.hpp"
+#include "../src/is_key.hpp"
+#include "../src/key_is_multipliable.hpp"
+#include "../src/math.hpp"
+#include "../src/monomial.hpp"
+#include "../src/mp_integer.hpp"
+#include "../src/mp_rational.hpp"
+#include "../src/polynomial.hpp"
+#include "../src/s11n.hpp"
+#include "../src/symbol.hpp"
+#include "../src/symbol_set.hpp"
+#include "../src/term.hpp"
+#include "../src/type_traits.hpp"
+
+using namespace piranha;
+
+using int_types = std::tuple<signed char, short, int, long long, unsigned>;
+
+struct basic_tester {
+    template <typename T>
+    void operator()(const T &) const
+    {
+        using s_type = static_monomial<T, 4u>;
+        BOOST_CHECK(is_key<s_type>::value);
+        BOOST_CHECK(key_has_degree<s_type>::value);
+        BOOST_CHECK(key_has_ldegree<s_type>::value);
+        BOOST_CHECK(key_is_differentiable<s_type>::value);
+        BOOST_CHECK((key_is_multipliable<integer, s_type>::value));
+        BOOST_CHECK((key_is_multipliable<double, s_type>::value));
+        BOOST_CHECK(is_hashable<s_type>::value);
+        BOOST_CHECK(s_type::max_size == 4u);
+        symbol_set ss0, ss2({symbol("x"), symbol("y")}), ss4({symbol("a"), symbol("b"), symbol("c"), symbol("d")}),
+            ss5({symbol("a"), symbol("b"), symbol("c"), symbol("d"), symbol("e")});
+        // Construction.
+        s_type m0;
+        BOOST_CHECK(m0.is_compatible(ss0));
+        BOOST_CHECK(m0.is_compatible(ss4));
+        BOOST_CHECK(!m0.is_compatible(ss5));
+        BOOST_CHECK(m0.is_unitary(ss4));
+        BOOST_CHECK(s_type(ss4) == m0);
+        BOOST_CHECK_THROW(s_type{ss5}, std::invalid_argument);
+        s_type m1{1, 2};
+        BOOST_CHECK(m1.is_compatible(ss2));
+        BOOST_CHECK(!m1.is_compatible(ss0));
+        BOOST_CHECK(!m1.is_unitary(ss2));
+        BOOST_CHECK_THROW(m1.is_unitary(ss0), std::invalid_argument);
+        BOOST_CHECK_THROW((s_type{1, 2, 3, 4, 5}), std::invalid_argument);
+        std::vector<int> v{1, 2};
+        BOOST_CHECK(s_type(v.begin(), v.end(), ss2) == m1);
+        BOOST_CHECK_THROW(s_type(v.begin(), v.end(), ss4), std::invalid_argument);
+        BOOST_CHECK(s_type(m1, ss2) == m1);
+        BOOST_CHECK_THROW(s_type(m1, ss0), std::invalid_argument);
+        BOOST_CHECK(std::distance(m1.begin(), m1.end()) == 4);
+        // Unpacking.
+        auto u = m1.unpack(ss2);
+        BOOST_CHECK(u.size() == 2u && u[0u] == T(1) && u[1u] == T(2));
+        BOOST_CHECK(m1.unpack(ss4).size() == 4u);
+        BOOST_CHECK_THROW(m1.unpack(ss5), std::invalid_argument);
+        // Equality and hashing.
+        BOOST_CHECK(m1 == (s_type{1, 2}));
+        BOOST_CHECK(m1 != (s_type{1, 3}));
+        BOOST_CHECK(m1 != (s_type{1, 2, 1}));
+        BOOST_CHECK(m1.hash() == (s_type{1, 2}).hash());
+        BOOST_CHECK(m1.hash() == std::hash<s_type>{}(m1));
+        std::unordered_set<s_type> us{s_type{1, 2}, s_type{2, 1}, s_type{1, 2}};
+        BOOST_CHECK(us.size() == 2u);
+        BOOST_CHECK(s_type{1} < (s_type{1, 2}));
+        BOOST_CHECK(!(m1 < m1));
+        // Degree.
+        BOOST_CHECK(m1.degree(ss2) == 3);
+        BOOST_CHECK(m1.ldegree(ss4) == 3);
+        BOOST_CHECK_THROW(m1.degree(ss0), std::invalid_argument);
+        BOOST_CHECK(m1.degree(symbol_set::positions(ss2, symbol_set{symbol("y")}), ss2) == 2);
+        BOOST_CHECK(m1.ldegree(symbol_set::positions(ss2, symbol_set{symbol("x")}), ss2) == 1);
+        // Multiplication and division.
+        s_type res;
+        s_type::multiply(res, m1, s_type{3, 4}, ss2);
+        BOOST_CHECK(res == (s_type{4, 6}));
+        s_type::divide(res, res, s_type{3, 4}, ss2);
+        BOOST_CHECK(res == m1);
+        using term_type = term<integer, s_type>;
+        std::array<term_type, 1u> tres;
+        s_type::multiply(tres, term_type{integer(2), m1}, term_type{integer(3), s_type{1, 1}}, ss2);
+        BOOST_CHECK(tres[0u].m_cf == 6);
+        BOOST_CHECK(tres[0u].m_key == (s_type{2, 3}));
+        // Merge args and trim.
+        symbol_set ss3({symbol("w"), symbol("x"), symbol("y")});
+        auto m2 = m1.merge_args(ss2, ss3);
+        BOOST_CHECK(m2 == (s_type{0, 1, 2}));
+        BOOST_CHECK_THROW(m1.merge_args(ss2, ss2), std::invalid_argument);
+        BOOST_CHECK_THROW(m1.merge_args(ss2, ss5), std::invalid_argument);
+        symbol_set cands({symbol("w"), symbol("x")});
+        m2.trim_identify(cands, ss3);
+        BOOST_CHECK(cands == symbol_set({symbol("w")}));
+        BOOST_CHECK(m2.trim(cands, ss3) == m1);
+        // Printing.
+        std::ostringstream oss;
+        m1.print(oss, ss2);
+        BOOST_CHECK_EQUAL(oss.str(), "x*y**2");
+        oss.str("");
+        m1.print_tex(oss, ss2);
+        BOOST_CHECK_EQUAL(oss.str(), "{x}{y}^{2}");
+        // Linear argument, pow, partial, integrate.
+        BOOST_CHECK_EQUAL((s_type{0, 1}.linear_argument(ss2)), "y");
+        BOOST_CHECK_THROW(m1.linear_argument(ss2), std::invalid_argument);
+        BOOST_CHECK(m1.pow(2, ss2) == (s_type{2, 4}));
+        auto p = m1.partial(symbol_set::positions(ss2, symbol_set{symbol("y")}), ss2);
+        BOOST_CHECK(p.first == T(2) && p.second == (s_type{1, 1}));
+        auto i = m1.integrate(symbol("z"), ss2);
+        BOOST_CHECK(i.first == T(1) && i.second == (s_type{1, 2, 1}));
+        i = m1.integrate(symbol("x"), ss2);
+        BOOST_CHECK(i.first == T(2) && i.second == (s_type{2, 2}));
+        BOOST_CHECK_THROW((s_type{1, 2, 3, 4}.integrate(symbol("z"), ss4)), std::invalid_argument);
+        // Evaluation and substitution.
+        BOOST_CHECK_EQUAL(m1.evaluate(symbol_set::positions_map<integer>(ss2, {{symbol("x"), integer(2)},
+                                                                              {symbol("y"), integer(3)}}),
+                                      ss2),
+                          18);
+        auto s = m1.subs("y", integer(2), ss2);
+        BOOST_CHECK(s.size() == 1u && s[0u].first == 4 && s[0u].second == s_type{1});
+        auto is = s_type{1, 5}.ipow_subs("y", integer(2), integer(3), ss2);
+        BOOST_CHECK(is.size() == 1u && is[0u].first == 9 && is[0u].second == (s_type{1, 1}));
+        // Split and extraction.
+        auto sp = m1.split(ss2);
+        BOOST_CHECK(sp.first == s_type{2} && sp.second == s_type{1});
+        std::vector<T> out;
+        m1.extract_exponents(out, ss2);
+        BOOST_CHECK((out == std::vector<T>{T(1), T(2)}));
+        BOOST_CHECK(!m1.has_negative_exponent(ss2));
+    }
+};
+
+BOOST_AUTO_TEST_CASE(static_monomial_basic_test)
+{
+    init();
+    tuple_for_each(int_types{}, basic_tester());
+    // Negative exponents and degree overflow.
+    using s_type = static_monomial<signed char, 3u>;
+    symbol_set ss3({symbol("x"), symbol("y"), symbol("z")});
+    s_type m{-1, 2, -3};
+    BOOST_CHECK(m.has_negative_exponent(ss3));
+    BOOST_CHECK(m.degree(ss3) == -2);
+    std::ostringstream oss;
+    m.print_tex(oss, ss3);
+    BOOST_CHECK_EQUAL(oss.str(), "\\frac{{y}^{2}}{{x}{z}^{3}}");
+    BOOST_CHECK_THROW((s_type{-1}.integrate(symbol("x"), symbol_set{symbol("x")})), std::invalid_argument);
+    using ll_type = static_monomial<long long, 2u>;
+    const auto llmax = std::numeric_limits<long long>::max();
+    BOOST_CHECK_THROW((ll_type{llmax, 1ll}.degree(symbol_set{symbol("x"), symbol("y")})), std::overflow_error);
+    using i_type = static_monomial<int, 2u>;
+    const auto imax = std::numeric_limits<int>::max();
+    BOOST_CHECK_THROW((i_type{imax, 1}.degree(symbol_set{symbol("x"), symbol("y")})), std::overflow_error);
+}
+
+BOOST_AUTO_TEST_CASE(static_monomial_polynomial_test)
+{
+    using s_type = static_monomial<std::int_least16_t, 6u>;
+    using p_type = polynomial<integer, s_type>;
+    using pm_type = polynomial<integer, monomial<std::int_least16_t>>;
+    // Compare against the dynamic monomial.
+    p_type x{"x"}, y{"y"}, z{"z"};
+    pm_type xm{"x"}, ym{"y"}, zm{"z"};
+    auto f = math::pow(1 + x + y + z, 5), g = math::pow(1 - x - y + z, 5);
+    auto fm = math::pow(1 + xm + ym + zm, 5), gm = math::pow(1 - xm - ym + zm, 5);
+    auto h = f * g;
+    auto hm = fm * gm;
+    BOOST_CHECK_EQUAL(h.size(), hm.size());
+    BOOST_CHECK_EQUAL(boost::lexical_cast<std::string>(h.degree()), boost::lexical_cast<std::string>(hm.degree()));
+    const auto h_val = h.subs("x", integer(2)).subs("y", integer(3)).subs("z", integer(5));
+    const auto hm_val = hm.subs("x", integer(2)).subs("y", integer(3)).subs("z", integer(5));
+    BOOST_CHECK_EQUAL(boost::lexical_cast<std::string>(h_val), boost::lexical_cast<std::string>(hm_val));
+    BOOST_CHECK_EQUAL(math::partial(h, "x").size(), math::partial(hm, "x").size());
+    // Too many variables.
+    p_type a{"a"}, b{"b"}, c{"c"}, d{"d"};
+    auto abcdxy = a * b * c * d * x * y;
+    BOOST_CHECK_EQUAL(abcdxy.get_symbol_set().size(), 6u);
+    BOOST_CHECK_THROW(abcdxy * z, std::invalid_argument);
+    // Overflow detection in the multiplier.
+    auto big = math::pow(x, std::numeric_limits<std::int_least16_t>::max());
+    BOOST_CHECK_THROW(big * x, std::overflow_error);
+}
+
+template <typename OArchive, typename IArchive, typename T>
+static inline void boost_roundtrip(const T &x, const symbol_set &args)
+{
+    using w_type = boost_s11n_key_wrapper<T>;
+    std::stringstream ss;
+    {
+        OArchive oa(ss);
+        boost_save(oa, w_type{x, args});
+    }
+    T retval;
+    {
+        IArchive ia(ss);
+        w_type w{retval, args};
+        boost_load(ia, w);
+    }
+    BOOST_CHECK(x == retval);
+}
+
+BOOST_AUTO_TEST_CASE(static_monomial_s11n_test)
+{
+    using s_type = static_monomial<int, 5u>;
+    BOOST_CHECK((has_boost_save<boost::archive::binary_oarchive, boost_s11n_key_wrapper<s_type>>::value));
+    BOOST_CHECK((has_boost_load<boost::archive::binary_iarchive, boost_s11n_key_wrapper<s_type>>::value));
+    symbol_set ss3({symbol("x"), symbol("y"), symbol("z")});
+    boost_roundtrip<boost::archive::binary_oarchive, boost::archive::binary_iarchive>(s_type{1, -2, 3}, ss3);
+    boost_roundtrip<boost::archive::text_oarchive, boost::archive::text_iarchive>(s_type{1, -2, 3}, ss3);
+    boost_roundtrip<boost::archive::text_oarchive, boost::archive::text_iarchive>(s_type{}, symbol_set{});
+#if defined(PIRANHA_WITH_MSGPACK)
+    BOOST_CHECK((key_has_msgpack_pack<msgpack::sbuffer, s_type>::value));
+    BOOST_CHECK((key_has_msgpack_convert<s_type>::value));
+    for (auto f : {msgpack_format::portable, msgpack_format::binary}) {
+        msgpack::sbuffer sbuf;
+        msgpack::packer<msgpack::sbuffer> p(sbuf);
+        s_type m{4, 5, 6};
+        m.msgpack_pack(p, f, ss3);
+        s_type retval;
+        auto oh = msgpack::unpack(sbuf.data(), sbuf.size());
+        retval.msgpack_convert(oh.get(), f, ss3);
+        BOOST_CHECK(retval == m);
+        BOOST_CHECK_EXCEPTION(
+            retval.msgpack_convert(oh.get(), f, symbol_set{}), std::invalid_argument,
+            [](const std::invalid_argument &ia) {
+                return boost::contains(ia.what(), "incompatible symbol set in monomial serialization");
+            });
+    }
+#endif
+}
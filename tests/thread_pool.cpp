@@ -32,8 +32,10 @@ see https://www.gnu.org/licenses/. */
 #include <boost/test/included/unit_test.hpp>
 
 #include <algorithm>
+#include <atomic>
 #include <boost/algorithm/string/predicate.hpp>
 #include <chrono>
+#include <cstddef>
 #include <limits>
 #include <list>
 #include <stdexcept>
@@ -259,7 +261,8 @@ BOOST_AUTO_TEST_CASE(thread_pool_test)
 #if !defined(__APPLE_CC__)
     BOOST_CHECK(thread_pool::enqueue(0, []() { return bound_proc(); }).get().first == false);
     thread_pool::set_binding(true);
-    BOOST_CHECK(thread_pool::enqueue(0, []() { return bound_proc(); }).get() == std::make_pair(true, 0u));
+    BOOST_CHECK(thread_pool::enqueue(0, []() { return bound_proc(); }).get()
+                == std::make_pair(true, runtime_info::get_cpu_binding_order()[0]));
     BOOST_CHECK_EQUAL(thread_pool::get_binding(), true);
     thread_pool::set_binding(false);
     BOOST_CHECK_EQUAL(thread_pool::get_binding(), false);
@@ -413,3 +416,175 @@ BOOST_AUTO_TEST_CASE(thread_pool_use_threads_test)
     BOOST_CHECK_EQUAL(f8.get(), 1u);
     BOOST_CHECK_THROW(f9.get(), std::invalid_argument);
 }
+
+BOOST_AUTO_TEST_CASE(thread_pool_parallel_for_test)
+{
+    thread_pool::resize(4u);
+    // Empty range.
+    std::atomic<std::size_t> counter(0u);
+    thread_pool::parallel_for(10u, 10u, 3u, [&counter](std::size_t b, std::size_t e) { counter += e - b; });
+    BOOST_CHECK_EQUAL(counter.load(), 0u);
+    // Invalid arguments.
+    BOOST_CHECK_EXCEPTION(thread_pool::parallel_for(0u, 10u, 0u, [](std::size_t, std::size_t) {}),
+                          std::invalid_argument, [](const std::invalid_argument &e) {
+                              return boost::contains(e.what(), "the grain size must be strictly positive");
+                          });
+    BOOST_CHECK_EXCEPTION(thread_pool::parallel_for(10u, 0u, 1u, [](std::size_t, std::size_t) {}),
+                          std::invalid_argument, [](const std::invalid_argument &e) {
+                              return boost::contains(e.what(), "invalid range");
+                          });
+    // Check that all the indices are visited exactly once, for various grain and pool sizes.
+    for (unsigned n : {1u, 3u, 4u, 7u}) {
+        thread_pool::resize(n);
+        for (std::size_t grain : {1u, 2u, 7u, 100u, 1000u, 2000u}) {
+            std::vector<int> v(1000u, 0);
+            thread_pool::parallel_for(0u, v.size(), grain, [&v](std::size_t b, std::size_t e) {
+                for (; b != e; ++b) {
+                    ++v[b];
+                }
+            });
+            BOOST_CHECK(std::all_of(v.begin(), v.end(), [](int x) { return x == 1; }));
+            const auto &cv = v;
+            std::atomic<long> sum(0);
+            auto summer = [&cv, &sum](std::size_t b, std::size_t e) {
+                long tmp = 0;
+                for (; b != e; ++b) {
+                    tmp += cv[b];
+                }
+                sum += tmp;
+            };
+            // Try a const functor, with a subrange.
+            const auto &csummer = summer;
+            thread_pool::parallel_for(10u, 990u, grain, csummer);
+            BOOST_CHECK_EQUAL(sum.load(), 980);
+        }
+    }
+    // Exceptions.
+    BOOST_CHECK_THROW(thread_pool::parallel_for(0u, 1000u, 1u,
+                                                [](std::size_t b, std::size_t) {
+                                                    if (b == 500u) {
+                                                        throw std::runtime_error("");
+                                                    }
+                                                }),
+                      std::runtime_error);
+    // Nested parallel for, from the calling thread and from the threads in the pool.
+    auto nested = []() -> std::size_t {
+        std::atomic<std::size_t> c(0u);
+        thread_pool::parallel_for(0u, 100u, 1u, [&c](std::size_t, std::size_t) {
+            thread_pool::parallel_for(0u, 100u, 10u, [&c](std::size_t b, std::size_t e) { c += e - b; });
+        });
+        return c.load();
+    };
+    BOOST_CHECK_EQUAL(nested(), 10000u);
+    for (unsigned i = 0u; i < thread_pool::size(); ++i) {
+        BOOST_CHECK_EQUAL(thread_pool::enqueue(i, nested).get(), 10000u);
+    }
+    // Task group.
+    {
+        std::atomic<std::size_t> c(0u);
+        auto f = [&c](std::size_t b, std::size_t e) { c += e - b; };
+        auto thrower = [](std::size_t, std::size_t) { throw std::runtime_error(""); };
+        task_group tg;
+        tg.wait();
+        tg.run(0u, 100u, 3u, f);
+        tg.run(100u, 250u, 1u, f);
+        tg.wait();
+        BOOST_CHECK_EQUAL(c.load(), 250u);
+        // The group can be reused after a failure.
+        tg.run(0u, 10u, 1u, thrower);
+        BOOST_CHECK_THROW(tg.wait(), std::runtime_error);
+        tg.wait();
+        tg.run(0u, 10u, 1u, f);
+        tg.wait();
+        BOOST_CHECK_EQUAL(c.load(), 260u);
+        // Let the destructor do the waiting.
+        tg.run(0u, 10u, 1u, f);
+    }
+    // Concurrent parallel for loops while the pool is being resized.
+    {
+        std::atomic<std::size_t> c(0u);
+        auto loop = [&c]() {
+            for (int i = 0; i < 100; ++i) {
+                thread_pool::parallel_for(0u, 1000u, 10u, [&c](std::size_t b, std::size_t e) { c += e - b; });
+            }
+        };
+        std::thread t1(loop), t2(loop);
+        for (unsigned n = 1u; n < 10u; ++n) {
+            thread_pool::resize(n);
+        }
+        t1.join();
+        t2.join();
+        BOOST_CHECK_EQUAL(c.load(), 200000u);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(thread_pool_many_tasks_test)
+{
+    // Many small tasks via enqueue() and parallel_for(), and many small fork-join loops. The timings of these
+    // operations are measured in the microbenchmark driver.
+    const unsigned hc = runtime_info::get_hardware_concurrency();
+    thread_pool::resize(hc ? hc : 1u);
+    const unsigned size = thread_pool::size();
+    const std::size_t n_tasks = 100000u;
+    std::atomic<std::size_t> c(0u);
+    {
+        auto task = [&c]() { ++c; };
+        future_list<decltype(task())> f_list;
+        for (std::size_t i = 0u; i < n_tasks; ++i) {
+            f_list.push_back(thread_pool::enqueue(static_cast<unsigned>(i % size), task));
+        }
+        f_list.wait_all();
+        f_list.get_all();
+    }
+    BOOST_CHECK_EQUAL(c.load(), n_tasks);
+    thread_pool::parallel_for(0u, n_tasks, 1u, [&c](std::size_t b, std::size_t e) { c += e - b; });
+    BOOST_CHECK_EQUAL(c.load(), 2u * n_tasks);
+    const unsigned n_loops = 1000u;
+    for (unsigned i = 0u; i < n_loops; ++i) {
+        thread_pool::parallel_for(0u, size, 1u, [&c](std::size_t b, std::size_t e) { c += e - b; });
+    }
+    BOOST_CHECK_EQUAL(c.load(), 2u * n_tasks + n_loops * size);
+}
+
+BOOST_AUTO_TEST_CASE(thread_pool_nested_parallelism_test)
+{
+    thread_pool::resize(4u);
+    BOOST_CHECK(thread_pool::get_nested_parallelism() == nested_parallelism::outer);
+    std::atomic<unsigned> max_n(0u);
+    auto probe = [&max_n](std::size_t, std::size_t) {
+        const auto n = thread_pool::use_threads(100u, 1u);
+        auto cur = max_n.load();
+        while (n > cur && !max_n.compare_exchange_weak(cur, n)) {
+        }
+    };
+    // With the outer policy, use_threads() returns 1 from any task, including the ones
+    // run by the calling thread.
+    thread_pool::parallel_for(0u, 100u, 1u, probe);
+    BOOST_CHECK_EQUAL(max_n.load(), 1u);
+    BOOST_CHECK_EQUAL(thread_pool::use_threads(100u, 1u), 4u);
+    // Cooperative policy.
+    thread_pool::set_nested_parallelism(nested_parallelism::cooperative);
+    BOOST_CHECK(thread_pool::get_nested_parallelism() == nested_parallelism::cooperative);
+    thread_pool::parallel_for(0u, 100u, 1u, probe);
+    BOOST_CHECK_EQUAL(max_n.load(), 4u);
+    BOOST_CHECK_EQUAL(thread_pool::enqueue(0u, []() { return thread_pool::use_threads(100u, 1u); }).get(), 4u);
+    // Nested loops, from the calling thread and from the threads in the pool.
+    auto nested = []() -> std::size_t {
+        std::atomic<std::size_t> c(0u);
+        thread_pool::parallel_for(0u, 8u, 1u, [&c](std::size_t, std::size_t) {
+            const auto n = thread_pool::use_threads(1000u, 1u);
+            thread_pool::parallel_for(0u, 1000u, 1000u / n, [&c](std::size_t b, std::size_t e) { c += e - b; });
+        });
+        return c.load();
+    };
+    BOOST_CHECK_EQUAL(nested(), 8000u);
+    std::vector<decltype(thread_pool::enqueue(0u, nested))> list;
+    for (unsigned i = 0u; i < 4u; ++i) {
+        list.push_back(thread_pool::enqueue(i, nested));
+    }
+    for (auto &f : list) {
+        BOOST_CHECK_EQUAL(f.get(), 8000u);
+    }
+    thread_pool::set_nested_parallelism(nested_parallelism::outer);
+    BOOST_CHECK(thread_pool::get_nested_parallelism() == nested_parallelism::outer);
+}
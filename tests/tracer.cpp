@@ -0,0 +1,263 @@
+/* Copyright 2009-2016 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#include "../src/tracer.hpp"
+
+#define BOOST_TEST_MODULE tracer_test
+#include <boost/test/included/unit_test.hpp>
+
+#include <boost/filesystem.hpp>
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include <atomic>
+#include <cstddef>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../src/config.hpp"
+#include "../src/init.hpp"
+#include "../src/kronecker_monomial.hpp"
+#include "../src/mp_integer.hpp"
+#include "../src/polynomial.hpp"
+#include "../src/settings.hpp"
+#include "../src/thread_pool.hpp"
+
+using namespace piranha;
+namespace bfs = boost::filesystem;
+
+// Small raii class for creating a tmp file.
+// NOTE: this will not actually create the file, it will just create
+// a tmp file name - so on destruction we can attempt to delete the file.
+struct tmp_file {
+    tmp_file()
+    {
+        m_path = bfs::temp_directory_path();
+        // Concatenate with a unique filename.
+        m_path /= bfs::unique_path();
+    }
+    ~tmp_file()
+    {
+        bfs::remove(m_path);
+    }
+    std::string name() const
+    {
+        return m_path.string();
+    }
+    bfs::path m_path;
+};
+
+using p_type = polynomial<integer, k_monomial>;
+
+static inline std::string dump_trace()
+{
+    std::ostringstream oss;
+    tracer::dump(oss);
+    return oss.str();
+}
+
+static inline p_type make_product()
+{
+    p_type x{"x"}, y{"y"}, z{"z"};
+    auto f = x + y + 2 * z + 1;
+    auto tmp = f;
+    for (int i = 0; i < 7; ++i) {
+        tmp *= f;
+    }
+    return tmp * (tmp + 1);
+}
+
+BOOST_AUTO_TEST_CASE(tracer_disabled_test)
+{
+    init();
+    BOOST_CHECK(!tracer::get_enabled());
+    tracer::clear();
+    {
+        trace_scope ts("test", "test");
+    }
+    make_product();
+    thread_pool::enqueue(0u, []() {}).get();
+    BOOST_CHECK_EQUAL(tracer::get_n_events(), 0u);
+    BOOST_CHECK_EQUAL(tracer::get_n_dropped_events(), 0u);
+    tracer::set_enabled(true);
+    BOOST_CHECK(tracer::get_enabled());
+    tracer::reset_enabled();
+    BOOST_CHECK(!tracer::get_enabled());
+    // The dump of an empty trace is valid.
+    std::istringstream iss(dump_trace());
+    boost::property_tree::ptree pt;
+    boost::property_tree::read_json(iss, pt);
+    BOOST_CHECK(pt.get_child("traceEvents").empty());
+    BOOST_CHECK_EQUAL(pt.get<std::string>("displayTimeUnit"), "ns");
+}
+
+#if defined(PIRANHA_HAVE_THREAD_LOCAL)
+
+BOOST_AUTO_TEST_CASE(tracer_enabled_test)
+{
+    tracer::clear();
+    tracer::set_enabled(true);
+    for (unsigned nt = 1u; nt <= 2u; ++nt) {
+        settings::set_n_threads(nt);
+        settings::set_min_work_per_thread(1u);
+        {
+            trace_scope ts("outer \"scope\"\n", "test");
+            make_product();
+        }
+        thread_pool::enqueue(0u, []() {}).get();
+    }
+    settings::reset_n_threads();
+    settings::reset_min_work_per_thread();
+    tracer::reset_enabled();
+    const auto n_events = tracer::get_n_events();
+    BOOST_CHECK(n_events > 0u);
+    BOOST_CHECK_EQUAL(tracer::get_n_dropped_events(), 0u);
+    // Events recorded after disabling are ignored.
+    make_product();
+    BOOST_CHECK_EQUAL(tracer::get_n_events(), n_events);
+    const auto str = dump_trace();
+    for (const auto &name : {"\"multiplication\"", "\"check_bounds\"", "\"estimate\"", "\"rehash\"",
+                             "\"table_fill\"", "\"sanitise\"", "\"finalise\"", "\"task\"", "\"pool thread 0\""}) {
+        BOOST_CHECK(str.find(name) != std::string::npos);
+    }
+    // Check the escaping.
+    BOOST_CHECK(str.find("\"outer \\\"scope\\\"\\u000a\"") != std::string::npos);
+    // Parse the JSON and check the events.
+    std::istringstream iss(str);
+    boost::property_tree::ptree pt;
+    boost::property_tree::read_json(iss, pt);
+    unsigned long long n_complete = 0u, n_meta = 0u, n_outer = 0u;
+    for (const auto &p : pt.get_child("traceEvents")) {
+        const auto &ev = p.second;
+        const auto ph = ev.get<std::string>("ph");
+        BOOST_CHECK_EQUAL(ev.get<int>("pid"), 1);
+        ev.get<unsigned>("tid");
+        if (ph == "X") {
+            ++n_complete;
+            BOOST_CHECK(ev.get<double>("ts") >= 0.);
+            BOOST_CHECK(ev.get<double>("dur") >= 0.);
+            ev.get<std::string>("cat");
+            if (ev.get<std::string>("name") == "outer \"scope\"\n") {
+                ++n_outer;
+                BOOST_CHECK_EQUAL(ev.get<std::string>("cat"), "test");
+            }
+        } else {
+            BOOST_CHECK_EQUAL(ph, "M");
+            BOOST_CHECK_EQUAL(ev.get<std::string>("name"), "thread_name");
+            ++n_meta;
+        }
+    }
+    BOOST_CHECK_EQUAL(n_complete, n_events);
+    BOOST_CHECK_EQUAL(n_outer, 2u);
+    BOOST_CHECK(n_meta >= 2u);
+    // Save to file.
+    {
+        tmp_file file;
+        tracer::save(file.name());
+        std::ifstream ifile(file.name());
+        std::ostringstream oss;
+        oss << ifile.rdbuf();
+        BOOST_CHECK_EQUAL(oss.str(), str);
+    }
+    BOOST_CHECK_THROW(tracer::save("/nonexistent_piranha_dir/trace.json"), std::runtime_error);
+    // Clear.
+    tracer::clear();
+    BOOST_CHECK_EQUAL(tracer::get_n_events(), 0u);
+    std::istringstream iss2(dump_trace());
+    boost::property_tree::read_json(iss2, pt);
+    BOOST_CHECK(pt.get_child("traceEvents").empty());
+}
+
+BOOST_AUTO_TEST_CASE(tracer_dropped_test)
+{
+    tracer::clear();
+    tracer::set_enabled(true);
+    // Use a new thread, so that we start from an empty buffer.
+    std::thread t([]() {
+        for (std::size_t i = 0u; i < detail::trace_buffer_capacity() + 10u; ++i) {
+            trace_scope ts("test", "test");
+        }
+    });
+    t.join();
+    tracer::reset_enabled();
+    BOOST_CHECK_EQUAL(tracer::get_n_events(), detail::trace_buffer_capacity());
+    BOOST_CHECK_EQUAL(tracer::get_n_dropped_events(), 10u);
+    // The events are still there after the thread has exited.
+    BOOST_CHECK(dump_trace().find("\"test\"") != std::string::npos);
+    tracer::clear();
+    BOOST_CHECK_EQUAL(tracer::get_n_events(), 0u);
+    BOOST_CHECK_EQUAL(tracer::get_n_dropped_events(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(tracer_concurrent_clear_test)
+{
+    tracer::clear();
+    tracer::set_enabled(true);
+    // Record events in a few threads while clearing from the main thread.
+    const unsigned n_threads = 4u, n_events = 10000u;
+    std::atomic<unsigned> n_done(0u);
+    std::vector<std::thread> threads;
+    for (unsigned i = 0u; i < n_threads; ++i) {
+        threads.emplace_back([&n_done]() {
+            for (unsigned j = 0u; j < n_events; ++j) {
+                trace_scope ts("test", "test");
+            }
+            ++n_done;
+        });
+    }
+    while (n_done.load() != n_threads) {
+        tracer::clear();
+        BOOST_CHECK(tracer::get_n_events() <= n_threads * n_events);
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+    tracer::reset_enabled();
+    // The surviving events are all well-formed.
+    const auto n = tracer::get_n_events();
+    BOOST_CHECK(n <= n_threads * n_events);
+    std::istringstream iss(dump_trace());
+    boost::property_tree::ptree pt;
+    boost::property_tree::read_json(iss, pt);
+    unsigned long long count = 0u;
+    for (const auto &ev : pt.get_child("traceEvents")) {
+        if (ev.second.get<std::string>("ph") == "X") {
+            BOOST_CHECK_EQUAL(ev.second.get<std::string>("name"), "test");
+            ++count;
+        }
+    }
+    BOOST_CHECK_EQUAL(count, n);
+    // After clearing with no concurrent writers, nothing is left.
+    tracer::clear();
+    BOOST_CHECK_EQUAL(tracer::get_n_events(), 0u);
+}
+
+#endif
@@ -31,12 +31,36 @@ see https://www.gnu.org/licenses/. */
 #define BOOST_TEST_MODULE tuning_test
 #include <boost/test/included/unit_test.hpp>
 
+#include <boost/filesystem.hpp>
+#include <fstream>
 #include <stdexcept>
+#include <string>
 #include <thread>
 
 #include "../src/init.hpp"
+#include "../src/runtime_info.hpp"
 
 using namespace piranha;
+namespace bfs = boost::filesystem;
+
+// Helper class to create and remove a temporary file.
+struct tmp_file {
+    tmp_file()
+    {
+        m_path = bfs::temp_directory_path();
+        // Concatenate with a unique filename.
+        m_path /= bfs::unique_path();
+    }
+    ~tmp_file()
+    {
+        bfs::remove(m_path);
+    }
+    std::string name() const
+    {
+        return m_path.string();
+    }
+    bfs::path m_path;
+};
 
 BOOST_AUTO_TEST_CASE(tuning_parallel_memory_set_test)
 {
@@ -60,7 +84,12 @@ BOOST_AUTO_TEST_CASE(tuning_parallel_memory_set_test)
 
 BOOST_AUTO_TEST_CASE(tuning_block_size_test)
 {
-    BOOST_CHECK_EQUAL(tuning::get_multiplication_block_size(), 256u);
+    const auto def = detail::default_mult_block_size();
+    BOOST_CHECK(def >= 16u && def <= 4096u && (def & (def - 1u)) == 0u);
+    if (!runtime_info::get_cache_size(1u)) {
+        BOOST_CHECK_EQUAL(def, 256u);
+    }
+    BOOST_CHECK_EQUAL(tuning::get_multiplication_block_size(), detail::default_mult_block_size());
     tuning::set_multiplication_block_size(512u);
     BOOST_CHECK_EQUAL(tuning::get_multiplication_block_size(), 512u);
     std::thread t1([]() {
@@ -73,7 +102,7 @@ BOOST_AUTO_TEST_CASE(tuning_block_size_test)
     BOOST_CHECK_THROW(tuning::set_multiplication_block_size(8000u), std::invalid_argument);
     BOOST_CHECK_EQUAL(tuning::get_multiplication_block_size(), 1024u);
     tuning::reset_multiplication_block_size();
-    BOOST_CHECK_EQUAL(tuning::get_multiplication_block_size(), 256u);
+    BOOST_CHECK_EQUAL(tuning::get_multiplication_block_size(), detail::default_mult_block_size());
 }
 
 BOOST_AUTO_TEST_CASE(tuning_estimation_threshold_test)
@@ -92,3 +121,76 @@ BOOST_AUTO_TEST_CASE(tuning_estimation_threshold_test)
     tuning::reset_estimate_threshold();
     BOOST_CHECK_EQUAL(tuning::get_estimate_threshold(), 200u);
 }
+
+BOOST_AUTO_TEST_CASE(tuning_hash_mixing_test)
+{
+    BOOST_CHECK(tuning::get_hash_mixing() == hash_mixing::identity);
+    tuning::set_hash_mixing(hash_mixing::multiply_shift);
+    BOOST_CHECK(tuning::get_hash_mixing() == hash_mixing::multiply_shift);
+    tuning::set_hash_mixing(hash_mixing::randomised);
+    BOOST_CHECK(tuning::get_hash_mixing() == hash_mixing::randomised);
+    BOOST_CHECK_THROW(tuning::set_hash_mixing(static_cast<hash_mixing>(42)), std::invalid_argument);
+    BOOST_CHECK(tuning::get_hash_mixing() == hash_mixing::randomised);
+    tuning::reset_hash_mixing();
+    BOOST_CHECK(tuning::get_hash_mixing() == hash_mixing::identity);
+}
+
+BOOST_AUTO_TEST_CASE(tuning_crt_multiplication_test)
+{
+    BOOST_CHECK(!tuning::get_crt_multiplication());
+    tuning::set_crt_multiplication(true);
+    BOOST_CHECK(tuning::get_crt_multiplication());
+    tuning::reset_crt_multiplication();
+    BOOST_CHECK(!tuning::get_crt_multiplication());
+}
+
+BOOST_AUTO_TEST_CASE(tuning_profile_test)
+{
+    tuning::set_parallel_memory_set(false);
+    tuning::set_multiplication_block_size(512u);
+    tuning::set_estimate_threshold(1234u);
+    tuning::set_hash_mixing(hash_mixing::multiply_shift);
+    tuning::set_crt_multiplication(true);
+    tmp_file file;
+    tuning::save_profile(file.name());
+    tuning::reset_parallel_memory_set();
+    tuning::reset_multiplication_block_size();
+    tuning::reset_estimate_threshold();
+    tuning::reset_hash_mixing();
+    tuning::reset_crt_multiplication();
+    tuning::load_profile(file.name());
+    BOOST_CHECK(!tuning::get_parallel_memory_set());
+    BOOST_CHECK_EQUAL(tuning::get_multiplication_block_size(), 512u);
+    BOOST_CHECK_EQUAL(tuning::get_estimate_threshold(), 1234u);
+    BOOST_CHECK(tuning::get_hash_mixing() == hash_mixing::multiply_shift);
+    BOOST_CHECK(tuning::get_crt_multiplication());
+    // Partial profiles and empty lines.
+    auto write = [&file](const std::string &content) {
+        std::ofstream ofile(file.name(), std::ios::out | std::ios::trunc);
+        ofile << content;
+    };
+    write("\nmultiplication_block_size 64\n\nhash_mixing randomised\n");
+    tuning::load_profile(file.name());
+    BOOST_CHECK_EQUAL(tuning::get_multiplication_block_size(), 64u);
+    BOOST_CHECK(tuning::get_hash_mixing() == hash_mixing::randomised);
+    BOOST_CHECK_EQUAL(tuning::get_estimate_threshold(), 1234u);
+    // Invalid profiles do not modify the parameters.
+    for (const auto &content : {"foo 1\n", "multiplication_block_size\n", "multiplication_block_size 8\n",
+                                "multiplication_block_size 128 1\n", "estimate_threshold abc\n",
+                                "hash_mixing foo\n", "estimate_threshold 10\nparallel_memory_set 2\n"}) {
+        write(content);
+        BOOST_CHECK_THROW(tuning::load_profile(file.name()), std::invalid_argument);
+        BOOST_CHECK(!tuning::get_parallel_memory_set());
+        BOOST_CHECK_EQUAL(tuning::get_multiplication_block_size(), 64u);
+        BOOST_CHECK_EQUAL(tuning::get_estimate_threshold(), 1234u);
+        BOOST_CHECK(tuning::get_hash_mixing() == hash_mixing::randomised);
+        BOOST_CHECK(tuning::get_crt_multiplication());
+    }
+    BOOST_CHECK_THROW(tuning::load_profile((bfs::temp_directory_path() / bfs::unique_path()).string()),
+                      std::runtime_error);
+    tuning::reset_parallel_memory_set();
+    tuning::reset_multiplication_block_size();
+    tuning::reset_estimate_threshold();
+    tuning::reset_hash_mixing();
+    tuning::reset_crt_multiplication();
+}
@@ -0,0 +1,208 @@
+/* Copyright 2009-2016 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#include "../src/detail/vector_kernels.hpp"
+
+#define BOOST_TEST_MODULE vector_kernels_test
+#include <boost/test/included/unit_test.hpp>
+
+#include <boost/mpl/for_each.hpp>
+#include <boost/mpl/vector.hpp>
+#include <cstddef>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "../src/init.hpp"
+#include "../src/math.hpp"
+
+using namespace piranha;
+using namespace piranha::detail;
+
+using int_types = boost::mpl::vector<signed char, unsigned char, short, unsigned short, int, unsigned>;
+
+static std::mt19937 rng;
+
+static const std::vector<vk_isa> isas = {vk_isa::scalar, vk_isa::avx2, vk_isa::avx512};
+
+// Sizes to be tested: they cover the full-width loops and the remainders for all the instruction sets.
+static const std::vector<std::size_t> sizes = {0u, 1u, 3u, 7u, 8u, 15u, 16u, 17u, 31u, 32u, 33u, 63u, 64u, 65u, 100u};
+
+template <typename T>
+static std::vector<T> random_vector(std::size_t n)
+{
+    std::uniform_int_distribution<long long> dist(std::numeric_limits<T>::min(), std::numeric_limits<T>::max());
+    std::vector<T> retval;
+    for (std::size_t i = 0u; i < n; ++i) {
+        retval.push_back(static_cast<T>(dist(rng)));
+    }
+    return retval;
+}
+
+struct add_sub_tester {
+    template <typename T>
+    void operator()(const T &) const
+    {
+        for (auto isa : isas) {
+            for (auto n : sizes) {
+                const auto a = random_vector<T>(n), b = random_vector<T>(n);
+                std::vector<T> out(n), cmp(n);
+                vk_add(out.data(), a.data(), b.data(), n, isa);
+                vk_add_scalar(cmp.data(), a.data(), b.data(), n);
+                BOOST_CHECK(out == cmp);
+                vk_sub(out.data(), a.data(), b.data(), n, isa);
+                vk_sub_scalar(cmp.data(), a.data(), b.data(), n);
+                BOOST_CHECK(out == cmp);
+                // In-place operation.
+                auto a_copy(a);
+                vk_add(a_copy.data(), a_copy.data(), b.data(), n, isa);
+                vk_add_scalar(cmp.data(), a.data(), b.data(), n);
+                BOOST_CHECK(a_copy == cmp);
+                // Check that we do not write past the end.
+                std::vector<T> guard(n + 1u, T(1));
+                vk_add(guard.data(), a.data(), b.data(), n, isa);
+                BOOST_CHECK_EQUAL(guard.back(), T(1));
+            }
+        }
+    }
+};
+
+BOOST_AUTO_TEST_CASE(vector_kernels_add_sub_test)
+{
+    init();
+    BOOST_CHECK(static_cast<int>(vk_base<>::s_isa) >= static_cast<int>(vk_isa::scalar));
+    boost::mpl::for_each<int_types>(add_sub_tester());
+}
+
+struct equal_tester {
+    template <typename T>
+    void operator()(const T &) const
+    {
+        for (auto isa : isas) {
+            for (auto n : sizes) {
+                const auto a = random_vector<T>(n);
+                auto b(a);
+                BOOST_CHECK(vk_equal(a.data(), b.data(), n, isa));
+                for (std::size_t i = 0u; i < n; ++i) {
+                    b[i] = static_cast<T>(b[i] + T(1));
+                    BOOST_CHECK(!vk_equal(a.data(), b.data(), n, isa));
+                    b[i] = a[i];
+                }
+                std::vector<T> z(n);
+                BOOST_CHECK(vk_is_zero(z.data(), n, isa));
+                for (std::size_t i = 0u; i < n; ++i) {
+                    z[i] = T(1);
+                    BOOST_CHECK(!vk_is_zero(z.data(), n, isa));
+                    z[i] = T(0);
+                }
+            }
+        }
+    }
+};
+
+BOOST_AUTO_TEST_CASE(vector_kernels_equal_test)
+{
+    boost::mpl::for_each<int_types>(equal_tester());
+    // Types not supported by the kernels.
+    std::vector<long long> a{1, 2, 3}, b{1, 2, 3};
+    BOOST_CHECK(vk_equal(a.data(), b.data(), 3u));
+    b[2] = 4;
+    BOOST_CHECK(!vk_equal(a.data(), b.data(), 3u));
+}
+
+struct sum_minmax_tester {
+    template <typename T>
+    void operator()(const T &) const
+    {
+        for (auto isa : isas) {
+            for (auto n : sizes) {
+                const auto a = random_vector<T>(n), b = random_vector<T>(n);
+                std::vector<T> mins(a), maxs(a), cmp_mins(a), cmp_maxs(a);
+                vk_minmax(mins.data(), maxs.data(), b.data(), n, isa);
+                vk_minmax_scalar(cmp_mins.data(), cmp_maxs.data(), b.data(), n);
+                BOOST_CHECK(mins == cmp_mins);
+                BOOST_CHECK(maxs == cmp_maxs);
+                check_sum(a, isa, std::is_signed<T>{});
+            }
+        }
+    }
+    template <typename T>
+    static void check_sum(const std::vector<T> &a, vk_isa isa, const std::true_type &)
+    {
+        BOOST_CHECK_EQUAL(vk_checked_sum<long long>(a.data(), a.size(), isa), vk_sum_scalar(a.data(), a.size()));
+        // Sums of extremal values.
+        std::vector<T> v(a.size(), std::numeric_limits<T>::max());
+        BOOST_CHECK_EQUAL(vk_checked_sum<long long>(v.data(), v.size(), isa),
+                          static_cast<long long>(std::numeric_limits<T>::max()) * static_cast<long long>(v.size()));
+        std::fill(v.begin(), v.end(), std::numeric_limits<T>::min());
+        BOOST_CHECK_EQUAL(vk_checked_sum<long long>(v.data(), v.size(), isa),
+                          static_cast<long long>(std::numeric_limits<T>::min()) * static_cast<long long>(v.size()));
+    }
+    template <typename T>
+    static void check_sum(const std::vector<T> &, vk_isa, const std::false_type &)
+    {
+    }
+};
+
+BOOST_AUTO_TEST_CASE(vector_kernels_sum_minmax_test)
+{
+    boost::mpl::for_each<int_types>(sum_minmax_tester());
+    // Overflow checking in the sum.
+    std::vector<int> v{std::numeric_limits<int>::max(), 1};
+    BOOST_CHECK_THROW(vk_checked_sum<int>(v.data(), v.size()), std::overflow_error);
+    v = {std::numeric_limits<int>::max(), 1, -1};
+    BOOST_CHECK_EQUAL(vk_checked_sum<int>(v.data(), v.size()), std::numeric_limits<int>::max());
+    v = {std::numeric_limits<int>::min(), -1};
+    BOOST_CHECK_THROW(vk_checked_sum<int>(v.data(), v.size()), std::overflow_error);
+    v.assign(40u, std::numeric_limits<int>::max());
+    BOOST_CHECK_THROW(vk_checked_sum<int>(v.data(), v.size()), std::overflow_error);
+    BOOST_CHECK_EQUAL(vk_checked_sum<long long>(v.data(), v.size()), 40ll * std::numeric_limits<int>::max());
+}
+
+BOOST_AUTO_TEST_CASE(vector_kernels_fma_test)
+{
+    std::uniform_real_distribution<double> dist(-1., 1.);
+    for (auto isa : isas) {
+        for (auto n : sizes) {
+            std::vector<double> acc(n), cmp(n), b(n);
+            for (std::size_t i = 0u; i < n; ++i) {
+                acc[i] = dist(rng);
+                b[i] = dist(rng);
+            }
+            cmp = acc;
+            const double a = dist(rng);
+            vk_fma(acc.data(), a, b.data(), n, isa);
+            // The results must be bit-for-bit identical to those of math::multiply_accumulate().
+            for (std::size_t i = 0u; i < n; ++i) {
+                math::multiply_accumulate(cmp[i], a, b[i]);
+            }
+            BOOST_CHECK(acc == cmp);
+        }
+    }
+}